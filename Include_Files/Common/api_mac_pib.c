@@ -0,0 +1,317 @@
+/******************************************************************************
+
+ @file  api_mac_pib.c
+
+ @brief Batched MAC PIB requests and the cache of the MAC PIB attributes that
+        do not change after init, shared by the api_mac.c of the collector,
+        the sensor and the coprocessor.
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+
+#include <string.h>
+
+#include "api_mac_pib.h"
+
+/******************************************************************************
+ Constants and definitions
+ *****************************************************************************/
+
+/*! Largest attribute value kept in the PIB cache */
+#define PIB_CACHE_MAX_LEN APIMAC_SADDR_EXT_LEN
+
+/*! PIB cache entry for an attribute that does not change after init */
+typedef struct
+{
+    /*! MAC PIB attribute identifier */
+    uint8_t attribute;
+    /*! Attribute size in bytes */
+    uint8_t len;
+    /*! true once the value has been read or written */
+    bool valid;
+    /*! Cached attribute value */
+    uint8_t value[PIB_CACHE_MAX_LEN];
+} pibCacheEntry_t;
+
+/******************************************************************************
+ Local variables
+ *****************************************************************************/
+
+/*!
+ MAC PIB attributes that do not change once the MAC is initialized. They are
+ served from RAM after the first get, and updated by sets made through the
+ API. A MAC reset clears them.
+ */
+static pibCacheEntry_t pibCache[] =
+{
+    { ApiMac_attribute_extendedAddress, APIMAC_SADDR_EXT_LEN, false, {0} }
+};
+
+/******************************************************************************
+ Local Function Prototypes
+ *****************************************************************************/
+
+static ApiMac_status_t multiTypeReq(uint8_t eventId, ICall_MsgMatchFn matchFn,
+                                    ApiMac_mlmePibEntry_t *pEntries,
+                                    uint8_t count);
+static bool matchGetReqMulti(ICall_ServiceEnum src, ICall_EntityID dest,
+                             const void *msg);
+static bool matchSetReqMulti(ICall_ServiceEnum src, ICall_EntityID dest,
+                             const void *msg);
+static pibCacheEntry_t *pibCacheFind(uint8_t pibAttribute);
+
+/******************************************************************************
+ Public Functions
+ *****************************************************************************/
+
+/*!
+ This direct execute function retrieves a list of attribute values from
+ the MAC PIB in one request.
+
+ Public function defined in api_mac.h
+ */
+ApiMac_status_t ApiMac_mlmeGetReqMulti(ApiMac_mlmePibEntry_t *pEntries,
+                                       uint8_t count)
+{
+    uint8_t i;
+
+    /* No request when every attribute is cached */
+    for(i = 0; i < count; i++)
+    {
+        pibCacheEntry_t *pCache = pibCacheFind(pEntries[i].attribute);
+
+        if((pCache == NULL) || (pCache->valid == false)
+           || (pEntries[i].len < pCache->len))
+        {
+            break;
+        }
+    }
+
+    if((count > 0) && (i == count))
+    {
+        for(i = 0; i < count; i++)
+        {
+            pibCacheEntry_t *pCache = pibCacheFind(pEntries[i].attribute);
+
+            memcpy(pEntries[i].pValue, pCache->value, pCache->len);
+            pEntries[i].len = pCache->len;
+            pEntries[i].status = ApiMac_status_success;
+        }
+        return (ApiMac_status_success);
+    }
+
+    return (multiTypeReq(MAC_GET_REQ_MULTI, matchGetReqMulti, pEntries,
+                         count));
+}
+
+/*!
+ This direct execute function sets a list of attribute values in the MAC PIB
+ in one request.
+
+ Public function defined in api_mac.h
+ */
+ApiMac_status_t ApiMac_mlmeSetReqMulti(ApiMac_mlmePibEntry_t *pEntries,
+                                       uint8_t count)
+{
+    return (multiTypeReq(MAC_SET_REQ_MULTI, matchSetReqMulti, pEntries,
+                         count));
+}
+
+/*!
+ Read an attribute from the cache
+
+ Public function defined in api_mac_pib.h
+ */
+bool ApiMacPib_cacheRead(uint8_t pibAttribute, void *pValue, uint16_t *pLen)
+{
+    pibCacheEntry_t *pCache = pibCacheFind(pibAttribute);
+
+    if((pCache == NULL) || (pCache->valid == false))
+    {
+        return (false);
+    }
+
+    memcpy(pValue, pCache->value, pCache->len);
+    if(pLen)
+    {
+        *pLen = pCache->len;
+    }
+    return (true);
+}
+
+/*!
+ Store a value read from or written to the MAC PIB
+
+ Public function defined in api_mac_pib.h
+ */
+void ApiMacPib_cacheUpdate(uint8_t pibAttribute, const void *pValue)
+{
+    pibCacheEntry_t *pCache = pibCacheFind(pibAttribute);
+
+    if(pCache != NULL)
+    {
+        memcpy(pCache->value, pValue, pCache->len);
+        pCache->valid = true;
+    }
+}
+
+/*!
+ Forget the cached values
+
+ Public function defined in api_mac_pib.h
+ */
+void ApiMacPib_cacheClear(void)
+{
+    uint8_t i;
+
+    for(i = 0; i < (sizeof(pibCache) / sizeof(pibCache[0])); i++)
+    {
+        pibCache[i].valid = false;
+    }
+}
+
+/******************************************************************************
+ Local Functions
+ *****************************************************************************/
+
+/*!
+ * @brief       Generic function for both batched Get and Set Requests.
+ *
+ * @param       eventId - ICall Message Event
+ * @param       matchFn - function pointer to function to wait for right
+ *                        response message
+ * @param       pEntries - list of attributes, the status of each one and
+ *                         the length of each read value are filled in
+ * @param       count - number of entries in pEntries
+ *
+ * @return      ApiMac_status_t - first failing status, if any
+ */
+static ApiMac_status_t multiTypeReq(uint8_t eventId, ICall_MsgMatchFn matchFn,
+                                    ApiMac_mlmePibEntry_t *pEntries,
+                                    uint8_t count)
+{
+    ApiMac_status_t status = ApiMac_status_noResources;
+    macPibMultiParam_t *pMsg;
+    uint8_t i;
+
+    if((count == 0) || (count > APIMAC_PIB_MULTI_MAX_ENTRIES))
+    {
+        return (ApiMac_status_invalidParameter);
+    }
+
+    /* Entries keep this status if the request can't be sent */
+    for(i = 0; i < count; i++)
+    {
+        pEntries[i].status = ApiMac_status_noResources;
+    }
+
+    /* Allocate message buffer space */
+    pMsg = (macPibMultiParam_t *)ICall_allocMsg(sizeof(macPibMultiParam_t));
+
+    if(pMsg != NULL)
+    {
+        ICall_Errno errno;
+
+        /* Fill in the message content */
+        pMsg->event = eventId;
+        pMsg->status = 0;
+        pMsg->count = count;
+        pMsg->pEntries = pEntries;
+
+        /* Send the message */
+        errno = ICall_sendServiceMsg(ApiMac_appEntity,
+                                     (ICALL_SERVICE_CLASS_TIMAC),
+                                     (ICALL_MSG_FORMAT_KEEP),
+                                     pMsg);
+
+        if(errno == ICALL_ERRNO_SUCCESS)
+        {
+            macPibMultiParam_t *pCmdStatus = NULL;
+
+            errno = ICall_waitMatch(ICALL_TIMEOUT_FOREVER, matchFn, (NULL),
+                                    (NULL),
+                                    (void **)&pCmdStatus);
+
+            if(errno == ICALL_ERRNO_SUCCESS)
+            {
+                status = (ApiMac_status_t)pCmdStatus->status;
+
+                for(i = 0; i < count; i++)
+                {
+                    if(pEntries[i].status == ApiMac_status_success)
+                    {
+                        ApiMacPib_cacheUpdate(pEntries[i].attribute,
+                                              pEntries[i].pValue);
+                    }
+                }
+            }
+        }
+
+        /* pCmdStatus is the same as msg */
+        ICall_freeMsg(pMsg);
+    }
+    return (status);
+}
+
+/*!
+ * @brief       Compare a received TIMAC Batched Get Request Status message
+ *              for a match.
+ *
+ * @param       src - originator of the message as a service enumeration
+ * @param       dest - destination entity id of the message
+ * @param       msg - pointer to the message body
+ *
+ * @return      TRUE when the message matches. FALSE, otherwise.
+ */
+static bool matchGetReqMulti(ICall_ServiceEnum src, ICall_EntityID dest,
+                             const void *msg)
+{
+    macPibMultiParam_t *pMsg = (macPibMultiParam_t *)msg;
+
+    return ((pMsg->event == MAC_GET_REQ_MULTI) ? true : false);
+}
+
+/*!
+ * @brief       Compare a received TIMAC Batched Set Request Status message
+ *              for a match.
+ *
+ * @param       src - originator of the message as a service enumeration
+ * @param       dest - destination entity id of the message
+ * @param       msg - pointer to the message body
+ *
+ * @return      TRUE when the message matches. FALSE, otherwise.
+ */
+static bool matchSetReqMulti(ICall_ServiceEnum src, ICall_EntityID dest,
+                             const void *msg)
+{
+    macPibMultiParam_t *pMsg = (macPibMultiParam_t *)msg;
+
+    return ((pMsg->event == MAC_SET_REQ_MULTI) ? true : false);
+}
+
+/*!
+ * @brief       Find the PIB cache entry of an attribute.
+ *
+ * @param       pibAttribute - attribute Id
+ *
+ * @return      pointer to the cache entry, NULL if the attribute isn't cached
+ */
+static pibCacheEntry_t *pibCacheFind(uint8_t pibAttribute)
+{
+    uint8_t i;
+
+    for(i = 0; i < (sizeof(pibCache) / sizeof(pibCache[0])); i++)
+    {
+        if(pibCache[i].attribute == pibAttribute)
+        {
+            return (&pibCache[i]);
+        }
+    }
+    return (NULL);
+}
@@ -0,0 +1,92 @@
+/******************************************************************************
+
+ @file  api_mac_pib.h
+
+ @brief Batched MAC PIB requests and the cache of the MAC PIB attributes that
+        do not change after init, shared by the api_mac.c of the collector,
+        the sensor and the coprocessor.
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+#ifndef API_MAC_PIB_H
+#define API_MAC_PIB_H
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "icall.h"
+#include "api_mac.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*!
+ \defgroup ApiMacPib API MAC PIB Cache
+ <BR>
+ ApiMac_mlmeGetReqMulti() and ApiMac_mlmeSetReqMulti() of api_mac.h are
+ built here, they send one MAC_GET_REQ_MULTI or MAC_SET_REQ_MULTI message
+ to the MAC stack for the whole list.
+ <BR>
+ The single get and set requests of api_mac.c read and update the cache
+ with the functions below, and ApiMac_mlmeResetReq() clears it. A get of
+ a cached attribute is answered without a message to the MAC stack.
+ <BR>
+ */
+
+/*!
+ * \ingroup ApiMacPib
+ * @{
+ */
+
+/******************************************************************************
+ Global variables
+ *****************************************************************************/
+
+/*! ICall thread entity of api_mac.c, the batched requests are sent from it */
+extern ICall_EntityID ApiMac_appEntity;
+
+/******************************************************************************
+ Function Prototypes
+ *****************************************************************************/
+
+/*!
+ * @brief       Read an attribute from the cache.
+ *
+ * @param       pibAttribute - attribute Id
+ * @param       pValue - place to put the value
+ * @param       pLen - place to put the length, can be NULL
+ *
+ * @return      true if the attribute is cached and was read
+ */
+extern bool ApiMacPib_cacheRead(uint8_t pibAttribute, void *pValue,
+                                uint16_t *pLen);
+
+/*!
+ * @brief       Store a value read from or written to the MAC PIB, if the
+ *              attribute is cached.
+ *
+ * @param       pibAttribute - attribute Id
+ * @param       pValue - attribute value
+ */
+extern void ApiMacPib_cacheUpdate(uint8_t pibAttribute, const void *pValue);
+
+/*!
+ * @brief       Forget the cached values, for a MAC reset.
+ */
+extern void ApiMacPib_cacheClear(void);
+
+/*! @} end group ApiMacPib */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* API_MAC_PIB_H */
@@ -0,0 +1,422 @@
+/******************************************************************************
+
+ @file  blist.c
+
+ @brief RAM copy of a black list of device addresses, shared by the sensor
+        and the collector.
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+
+#include <stddef.h>
+#include <string.h>
+
+#include "blist.h"
+
+/******************************************************************************
+ Local function prototypes
+ *****************************************************************************/
+static bool buildKey(ApiMac_sAddr_t *pAddr, uint8_t *pKey);
+static bool searchKey(Blist_t *pList, uint8_t *pKey, uint8_t *pIndex);
+static uint16_t readNumItems(const Blist_nv_t *pNv);
+static void writeNumItems(const Blist_nv_t *pNv, uint16_t numItems);
+
+/******************************************************************************
+ Public Functions
+ *****************************************************************************/
+
+/*!
+ Initialize an empty list.
+
+ Public function defined in blist.h
+ */
+void Blist_init(Blist_t *pList, Blist_entry_t *pEntries, uint8_t maxEntries)
+{
+    pList->pEntries = pEntries;
+    pList->maxEntries = maxEntries;
+    pList->numEntries = 0;
+}
+
+/*!
+ Empty the list.
+
+ Public function defined in blist.h
+ */
+void Blist_clear(Blist_t *pList)
+{
+    pList->numEntries = 0;
+}
+
+/*!
+ Add an address.
+
+ Public function defined in blist.h
+ */
+bool Blist_add(Blist_t *pList, ApiMac_sAddr_t *pAddr, uint16_t subId)
+{
+    uint8_t key[BLIST_KEY_LEN];
+    uint8_t index;
+
+    if((pList->numEntries >= pList->maxEntries)
+       || (buildKey(pAddr, key) == false)
+       || (searchKey(pList, key, &index) == true))
+    {
+        return (false);
+    }
+
+    /* Open a slot at the insertion point */
+    memmove(&pList->pEntries[index + 1], &pList->pEntries[index],
+            (pList->numEntries - index) * sizeof(Blist_entry_t));
+
+    memcpy(pList->pEntries[index].key, key, BLIST_KEY_LEN);
+    pList->pEntries[index].subId = subId;
+    pList->numEntries++;
+
+    return (true);
+}
+
+/*!
+ Look up an address.
+
+ Public function defined in blist.h
+ */
+int Blist_find(Blist_t *pList, ApiMac_sAddr_t *pAddr)
+{
+    uint8_t key[BLIST_KEY_LEN];
+    uint8_t index;
+
+    if((pList->numEntries == 0) || (buildKey(pAddr, key) == false)
+       || (searchKey(pList, key, &index) == false))
+    {
+        return (BLIST_NOT_FOUND);
+    }
+
+    return ((int)pList->pEntries[index].subId);
+}
+
+/*!
+ Remove an address.
+
+ Public function defined in blist.h
+ */
+int Blist_remove(Blist_t *pList, ApiMac_sAddr_t *pAddr)
+{
+    uint8_t key[BLIST_KEY_LEN];
+    uint8_t index;
+    int subId;
+
+    if((pList->numEntries == 0) || (buildKey(pAddr, key) == false)
+       || (searchKey(pList, key, &index) == false))
+    {
+        return (BLIST_NOT_FOUND);
+    }
+
+    subId = (int)pList->pEntries[index].subId;
+
+    pList->numEntries--;
+    memmove(&pList->pEntries[index], &pList->pEntries[index + 1],
+            (pList->numEntries - index) * sizeof(Blist_entry_t));
+
+    return (subId);
+}
+
+/*!
+ Find the lowest NV sub ID not used by an entry.
+
+ Public function defined in blist.h
+ */
+uint16_t Blist_unusedSubId(Blist_t *pList)
+{
+    uint16_t subId;
+
+    /* With n entries, one of the sub IDs 0 to n is free */
+    for(subId = 0; subId < pList->numEntries; subId++)
+    {
+        uint8_t i;
+
+        for(i = 0; i < pList->numEntries; i++)
+        {
+            if(pList->pEntries[i].subId == subId)
+            {
+                break;
+            }
+        }
+
+        if(i == pList->numEntries)
+        {
+            break;
+        }
+    }
+
+    return (subId);
+}
+
+/*!
+ Read the list from NV.
+
+ Public function defined in blist.h
+ */
+void Blist_load(Blist_t *pList, const Blist_nv_t *pNv)
+{
+    Blist_clear(pList);
+
+    if((pNv->pNV != NULL) && (pNv->pNV->readItem != NULL))
+    {
+        uint16_t numItems = readNumItems(pNv);
+        uint16_t readItems = 0;
+        NVINTF_itemID_t id;
+
+        /* Setup NV ID for the address records */
+        id.systemID = NVINTF_SYSID_APP;
+        id.itemID = pNv->itemId;
+
+        for(id.subID = 0; (readItems < numItems)
+            && (id.subID < pNv->maxSubIds)
+            && (pList->numEntries < pList->maxEntries); id.subID++)
+        {
+            ApiMac_sAddr_t item;
+
+            if(pNv->pNV->readItem(id, 0, sizeof(ApiMac_sAddr_t), &item)
+               == NVINTF_SUCCESS)
+            {
+                Blist_add(pList, &item, id.subID);
+                readItems++;
+            }
+        }
+    }
+}
+
+/*!
+ Write an address to NV, then add it to the list.
+
+ Public function defined in blist.h
+ */
+bool Blist_store(Blist_t *pList, const Blist_nv_t *pNv, ApiMac_sAddr_t *pAddr)
+{
+    NVINTF_itemID_t id;
+
+    if((pNv->pNV == NULL) || (pNv->pNV->writeItem == NULL)
+       || (pAddr == NULL) || (pAddr->addrMode == ApiMac_addrType_none))
+    {
+        return (false);
+    }
+
+    if(Blist_find(pList, pAddr) != BLIST_NOT_FOUND)
+    {
+        return (true);
+    }
+
+    /* Setup NV ID for the address record */
+    id.systemID = NVINTF_SYSID_APP;
+    id.itemID = pNv->itemId;
+    id.subID = Blist_unusedSubId(pList);
+
+    if((pList->numEntries >= pList->maxEntries)
+       || (id.subID >= pNv->maxSubIds))
+    {
+        return (false);
+    }
+
+    /* Write the record, then the RAM copy */
+    if(pNv->pNV->writeItem(id, sizeof(ApiMac_sAddr_t), pAddr)
+       != NVINTF_SUCCESS)
+    {
+        return (false);
+    }
+
+    Blist_add(pList, pAddr, id.subID);
+    writeNumItems(pNv, pList->numEntries);
+
+    return (true);
+}
+
+/*!
+ Delete an address from NV, then remove it from the list.
+
+ Public function defined in blist.h
+ */
+void Blist_erase(Blist_t *pList, const Blist_nv_t *pNv, ApiMac_sAddr_t *pAddr)
+{
+    int subId;
+
+    if((pNv->pNV == NULL) || (pNv->pNV->deleteItem == NULL))
+    {
+        return;
+    }
+
+    subId = Blist_find(pList, pAddr);
+    if(subId != BLIST_NOT_FOUND)
+    {
+        NVINTF_itemID_t id;
+
+        /* Setup NV ID for the address record */
+        id.systemID = NVINTF_SYSID_APP;
+        id.itemID = pNv->itemId;
+        id.subID = (uint16_t)subId;
+
+        /* Delete the record, then the RAM copy */
+        if(pNv->pNV->deleteItem(id) == NVINTF_SUCCESS)
+        {
+            Blist_remove(pList, pAddr);
+            writeNumItems(pNv, pList->numEntries);
+        }
+    }
+}
+
+/*!
+ Empty the list and delete every NV item of it.
+
+ Public function defined in blist.h
+ */
+void Blist_eraseAll(Blist_t *pList, const Blist_nv_t *pNv)
+{
+    Blist_clear(pList);
+
+    if((pNv->pNV != NULL) && (pNv->pNV->deleteItem != NULL))
+    {
+        NVINTF_itemID_t id;
+
+        /* Clear the number of records */
+        id.systemID = NVINTF_SYSID_APP;
+        id.itemID = pNv->numItemId;
+        id.subID = 0;
+        pNv->pNV->deleteItem(id);
+
+        /*
+         Clear the records.  Brute force through every possible subID, if
+         it doesn't exist that's fine, it will fail in deleteItem.
+         */
+        id.itemID = pNv->itemId;
+        for(id.subID = 0; id.subID < pNv->maxSubIds; id.subID++)
+        {
+            pNv->pNV->deleteItem(id);
+        }
+    }
+}
+
+/******************************************************************************
+ Local Functions
+ *****************************************************************************/
+
+/*!
+ * @brief       Build the key of an address.
+ *
+ * @param       pAddr - short or extended address
+ * @param       pKey - buffer of BLIST_KEY_LEN bytes
+ *
+ * @return      true if built, false if the address mode is none
+ */
+static bool buildKey(ApiMac_sAddr_t *pAddr, uint8_t *pKey)
+{
+    if(pAddr == NULL)
+    {
+        return (false);
+    }
+
+    memset(pKey, 0, BLIST_KEY_LEN);
+    pKey[0] = (uint8_t)pAddr->addrMode;
+
+    if(pAddr->addrMode == ApiMac_addrType_short)
+    {
+        pKey[1] = (uint8_t)(pAddr->addr.shortAddr & 0xFF);
+        pKey[2] = (uint8_t)(pAddr->addr.shortAddr >> 8);
+    }
+    else if(pAddr->addrMode == ApiMac_addrType_extended)
+    {
+        memcpy(&pKey[1], pAddr->addr.extAddr, APIMAC_SADDR_EXT_LEN);
+    }
+    else
+    {
+        return (false);
+    }
+
+    return (true);
+}
+
+/*!
+ * @brief       Binary search for a key.
+ *
+ * @param       pList - list
+ * @param       pKey - key
+ * @param       pIndex - set to the index of the key, or to where it would
+ *                       be inserted if not found
+ *
+ * @return      true if found
+ */
+static bool searchKey(Blist_t *pList, uint8_t *pKey, uint8_t *pIndex)
+{
+    uint8_t low = 0;
+    uint8_t high = pList->numEntries;
+
+    while(low < high)
+    {
+        uint8_t mid = (uint8_t)((low + high) / 2);
+        int cmp = memcmp(pKey, pList->pEntries[mid].key, BLIST_KEY_LEN);
+
+        if(cmp == 0)
+        {
+            *pIndex = mid;
+            return (true);
+        }
+        else if(cmp < 0)
+        {
+            high = mid;
+        }
+        else
+        {
+            low = (uint8_t)(mid + 1);
+        }
+    }
+
+    *pIndex = low;
+    return (false);
+}
+
+/*!
+ * @brief       Read the number of address records stored.
+ *
+ * @param       pNv - NV items of the list
+ *
+ * @return      number of records, 0 if not stored
+ */
+static uint16_t readNumItems(const Blist_nv_t *pNv)
+{
+    uint16_t numItems = 0;
+    NVINTF_itemID_t id;
+
+    /* Setup NV ID for the number of records */
+    id.systemID = NVINTF_SYSID_APP;
+    id.itemID = pNv->numItemId;
+    id.subID = 0;
+
+    if(pNv->pNV->readItem(id, 0, sizeof(uint16_t), &numItems)
+       != NVINTF_SUCCESS)
+    {
+        numItems = 0;
+    }
+    return (numItems);
+}
+
+/*!
+ * @brief       Write the number of address records stored.
+ *
+ * @param       pNv - NV items of the list
+ * @param       numItems - number of records
+ */
+static void writeNumItems(const Blist_nv_t *pNv, uint16_t numItems)
+{
+    NVINTF_itemID_t id;
+
+    /* Setup NV ID for the number of records */
+    id.systemID = NVINTF_SYSID_APP;
+    id.itemID = pNv->numItemId;
+    id.subID = 0;
+
+    pNv->pNV->writeItem(id, sizeof(uint16_t), &numItems);
+}
@@ -0,0 +1,206 @@
+/******************************************************************************
+
+ @file  blist.h
+
+ @brief RAM copy of a black list of device addresses, shared by the sensor
+        and the collector.
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+#ifndef BLIST_H
+#define BLIST_H
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "api_mac.h"
+#include "nvintf.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*!
+ \defgroup Blist Black List Copy
+ <BR>
+ The black list is stored in NV, one item per address, and was read back
+ item by item for every beacon the sensor heard and every join request the
+ collector received. The application now loads it into a Blist_t once at
+ init with Blist_load() and changes it with Blist_store(), Blist_erase() and
+ Blist_eraseAll(), which write NV first and then update the copy, so a
+ lookup never reads flash.
+ <BR>
+ Entries are kept sorted by address mode and address, and a lookup is a
+ binary search over them. Each entry remembers the NV sub ID it was stored
+ under, so the NV item can be deleted without searching for it.
+ <BR>
+ */
+
+/*!
+ * \ingroup Blist
+ * @{
+ */
+
+/******************************************************************************
+ Constants and definitions
+ *****************************************************************************/
+
+/*! Length of an entry key: address mode then 8 address bytes */
+#define BLIST_KEY_LEN           (1 + APIMAC_SADDR_EXT_LEN)
+
+/*! Returned by Blist_find() when the address isn't in the list */
+#define BLIST_NOT_FOUND         (-1)
+
+/*! Black list entry */
+typedef struct _blist_entry_t
+{
+    /*!
+     Address mode, then the address: the extended address, or the short
+     address in the first 2 bytes followed by zeros
+     */
+    uint8_t key[BLIST_KEY_LEN];
+    /*! NV sub ID of the entry */
+    uint16_t subId;
+} Blist_entry_t;
+
+/*! NV items of a black list */
+typedef struct _blist_nv_t
+{
+    /*! NV functions, NULL when the list isn't kept in NV */
+    NVINTF_nvFuncts_t *pNV;
+    /*! Item ID of the addresses, one sub ID each */
+    uint16_t itemId;
+    /*! Item ID of the number of addresses */
+    uint16_t numItemId;
+    /*! Sub IDs of the addresses are below this */
+    uint16_t maxSubIds;
+} Blist_nv_t;
+
+/*! Black list copy */
+typedef struct _blist_t
+{
+    /*! Entries, sorted by key */
+    Blist_entry_t *pEntries;
+    /*! Size of pEntries */
+    uint8_t maxEntries;
+    /*! Entries in use */
+    uint8_t numEntries;
+} Blist_t;
+
+/******************************************************************************
+ Function Prototypes
+ *****************************************************************************/
+
+/*!
+ * @brief       Initialize an empty list.
+ *
+ * @param       pList - list
+ * @param       pEntries - entry storage
+ * @param       maxEntries - number of entries in pEntries
+ */
+extern void Blist_init(Blist_t *pList, Blist_entry_t *pEntries,
+                       uint8_t maxEntries);
+
+/*!
+ * @brief       Empty the list.
+ *
+ * @param       pList - list
+ */
+extern void Blist_clear(Blist_t *pList);
+
+/*!
+ * @brief       Add an address.
+ *
+ * @param       pList - list
+ * @param       pAddr - short or extended address
+ * @param       subId - NV sub ID it is stored under
+ *
+ * @return      true if added, false if the list is full, the address mode
+ *              is none or the address is already in the list
+ */
+extern bool Blist_add(Blist_t *pList, ApiMac_sAddr_t *pAddr, uint16_t subId);
+
+/*!
+ * @brief       Look up an address.
+ *
+ * @param       pList - list
+ * @param       pAddr - short or extended address
+ *
+ * @return      NV sub ID of the address, BLIST_NOT_FOUND if not in the list
+ */
+extern int Blist_find(Blist_t *pList, ApiMac_sAddr_t *pAddr);
+
+/*!
+ * @brief       Remove an address.
+ *
+ * @param       pList - list
+ * @param       pAddr - short or extended address
+ *
+ * @return      NV sub ID of the removed address, BLIST_NOT_FOUND if it
+ *              wasn't in the list
+ */
+extern int Blist_remove(Blist_t *pList, ApiMac_sAddr_t *pAddr);
+
+/*!
+ * @brief       Find the lowest NV sub ID not used by an entry.
+ *
+ * @param       pList - list
+ *
+ * @return      unused sub ID
+ */
+extern uint16_t Blist_unusedSubId(Blist_t *pList);
+
+/*!
+ * @brief       Read the list from NV, replacing the entries.
+ *
+ * @param       pList - list
+ * @param       pNv - NV items of the list
+ */
+extern void Blist_load(Blist_t *pList, const Blist_nv_t *pNv);
+
+/*!
+ * @brief       Write an address to NV, then add it to the list.
+ *
+ * @param       pList - list
+ * @param       pNv - NV items of the list
+ * @param       pAddr - short or extended address
+ *
+ * @return      true if stored or already in the list, false if the list is
+ *              full, the address mode is none or the NV write failed
+ */
+extern bool Blist_store(Blist_t *pList, const Blist_nv_t *pNv,
+                        ApiMac_sAddr_t *pAddr);
+
+/*!
+ * @brief       Delete an address from NV, then remove it from the list.
+ *              The list is unchanged if the NV delete fails.
+ *
+ * @param       pList - list
+ * @param       pNv - NV items of the list
+ * @param       pAddr - short or extended address
+ */
+extern void Blist_erase(Blist_t *pList, const Blist_nv_t *pNv,
+                        ApiMac_sAddr_t *pAddr);
+
+/*!
+ * @brief       Empty the list and delete every NV item of it.
+ *
+ * @param       pList - list
+ * @param       pNv - NV items of the list
+ */
+extern void Blist_eraseAll(Blist_t *pList, const Blist_nv_t *pNv);
+
+/*! @} end group Blist */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BLIST_H */
@@ -0,0 +1,282 @@
+/******************************************************************************
+
+ @file  board_status.c
+
+ @brief Status display service: LCD lines and LEDs kept in RAM and painted
+        at a fixed rate, shared by the collector and the co-processor.
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <xdc/std.h>
+#include <ti/sysbios/knl/Clock.h>
+#include <ti/sysbios/hal/Hwi.h>
+
+#include "timer.h"
+#include "board_status.h"
+
+#if BOARD_STATUS_ENABLED
+
+/******************************************************************************
+ Constants and definitions
+ *****************************************************************************/
+
+/*! No LED state recorded, a recorded state is stored plus one */
+#define LED_STATE_NONE          0
+
+/*! Recorded text of an LCD line */
+typedef struct
+{
+    /*! String, NULL if nothing was written */
+    char *str;
+    /*! Value */
+    uint16_t value;
+    /*! Value format, BOARD_STATUS_NO_VALUE for none */
+    uint8_t format;
+} statusLine_t;
+
+/******************************************************************************
+ Global variables
+ *****************************************************************************/
+
+/*! Status display statistics */
+Board_Status_statistics_t Board_Status_statistics;
+
+/******************************************************************************
+ Local variables
+ *****************************************************************************/
+
+/*! Recorded lines */
+static statusLine_t statusLines[BOARD_STATUS_MAX_LINES];
+
+/*! Dirty lines, one bit per line */
+static volatile uint16_t dirtyLines = 0;
+
+/*! Recorded LED states plus one, LED_STATE_NONE for none */
+static uint8_t ledStates[BOARD_STATUS_MAX_LEDS];
+
+/*! LEDs to toggle, one bit per LED */
+static volatile uint8_t ledToggles = 0;
+
+/*! Refresh clock */
+static Clock_Struct statusClkStruct;
+
+/*! Notify function */
+static Board_Status_notifyFp_t pStatusNotifyFp = NULL;
+
+/******************************************************************************
+ Local function prototypes
+ *****************************************************************************/
+static void processRefreshTimeoutCallback(UArg a0);
+static bool ledsDirty(void);
+
+/******************************************************************************
+ Public Functions
+ *****************************************************************************/
+
+/*!
+ Start the refresh clock.
+
+ Public function defined in board_status.h
+ */
+void Board_Status_init(Board_Status_notifyFp_t pNotifyFp)
+{
+    pStatusNotifyFp = pNotifyFp;
+
+    Timer_construct(&statusClkStruct, processRefreshTimeoutCallback,
+                    BOARD_STATUS_PERIOD, BOARD_STATUS_PERIOD, true, 0);
+}
+
+/*!
+ Record the text of an LCD line.
+
+ Public function defined in board_status.h
+ */
+void Board_Status_setLine(uint8_t line, char *str, uint16_t value,
+                          uint8_t format)
+{
+    UInt key;
+
+    if(line >= BOARD_STATUS_MAX_LINES)
+    {
+        return;
+    }
+
+    key = Hwi_disable();
+
+    statusLines[line].str = str;
+    statusLines[line].value = value;
+    statusLines[line].format = format;
+    dirtyLines |= (uint16_t)(1 << line);
+
+    Hwi_restore(key);
+
+    Board_Status_statistics.lineUpdates++;
+}
+
+/*!
+ Record an LED state.
+
+ Public function defined in board_status.h
+ */
+void Board_Status_setLed(board_led_type led, board_led_state state)
+{
+    UInt key;
+
+    if((uint8_t)led >= BOARD_STATUS_MAX_LEDS)
+    {
+        return;
+    }
+
+    key = Hwi_disable();
+
+    ledStates[led] = (uint8_t)state + 1;
+    ledToggles &= (uint8_t)~(1 << led);
+
+    Hwi_restore(key);
+
+    Board_Status_statistics.ledUpdates++;
+}
+
+/*!
+ Record an LED toggle.
+
+ Public function defined in board_status.h
+ */
+void Board_Status_toggleLed(board_led_type led)
+{
+    UInt key;
+
+    if((uint8_t)led >= BOARD_STATUS_MAX_LEDS)
+    {
+        return;
+    }
+
+    key = Hwi_disable();
+    ledToggles |= (uint8_t)(1 << led);
+    Hwi_restore(key);
+
+    Board_Status_statistics.ledUpdates++;
+}
+
+/*!
+ Paint the dirty lines and apply the recorded LED requests.
+
+ Public function defined in board_status.h
+ */
+void Board_Status_refresh(void)
+{
+    uint8_t i;
+
+    for(i = 0; i < BOARD_STATUS_MAX_LINES; i++)
+    {
+        statusLine_t line;
+        bool dirty = false;
+        UInt key;
+
+        /* Take a copy, the line may be written again while it's painted */
+        key = Hwi_disable();
+        if(dirtyLines & (1 << i))
+        {
+            line = statusLines[i];
+            dirtyLines &= (uint16_t)~(1 << i);
+            dirty = true;
+        }
+        Hwi_restore(key);
+
+        if((dirty == true) && (line.str != NULL))
+        {
+            if(line.format == BOARD_STATUS_NO_VALUE)
+            {
+                LCD_WRITE_STRING(line.str, i);
+            }
+            else
+            {
+                LCD_WRITE_STRING_VALUE(line.str, line.value, line.format, i);
+            }
+            Board_Status_statistics.lcdWrites++;
+        }
+    }
+
+    for(i = 0; i < BOARD_STATUS_MAX_LEDS; i++)
+    {
+        uint8_t state;
+        bool toggle;
+        UInt key;
+
+        key = Hwi_disable();
+        state = ledStates[i];
+        toggle = (ledToggles & (1 << i)) ? true : false;
+        ledStates[i] = LED_STATE_NONE;
+        ledToggles &= (uint8_t)~(1 << i);
+        Hwi_restore(key);
+
+        if(state != LED_STATE_NONE)
+        {
+            Board_Led_control((board_led_type)i,
+                              (board_led_state)(state - 1));
+            Board_Status_statistics.ledWrites++;
+        }
+        if(toggle == true)
+        {
+            Board_Led_toggle((board_led_type)i);
+            Board_Status_statistics.ledWrites++;
+        }
+    }
+}
+
+/******************************************************************************
+ Local Functions
+ *****************************************************************************/
+
+/*!
+ * @brief       Refresh clock callback, asks the application to refresh
+ *              when a line or LED is dirty.
+ *
+ * @param       a0 - ignored
+ */
+static void processRefreshTimeoutCallback(UArg a0)
+{
+    (void)a0;
+
+    if(((dirtyLines != 0) || (ledsDirty() == true))
+       && (pStatusNotifyFp != NULL))
+    {
+        pStatusNotifyFp();
+    }
+}
+
+/*!
+ * @brief       Check for recorded LED requests.
+ *
+ * @return      true if an LED request is waiting
+ */
+static bool ledsDirty(void)
+{
+    uint8_t i;
+
+    if(ledToggles != 0)
+    {
+        return (true);
+    }
+
+    for(i = 0; i < BOARD_STATUS_MAX_LEDS; i++)
+    {
+        if(ledStates[i] != LED_STATE_NONE)
+        {
+            return (true);
+        }
+    }
+
+    return (false);
+}
+
+#endif /* BOARD_STATUS_ENABLED */
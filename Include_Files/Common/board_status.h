@@ -0,0 +1,184 @@
+/******************************************************************************
+
+ @file  board_status.h
+
+ @brief Status display service: LCD lines and LEDs kept in RAM and painted
+        at a fixed rate, shared by the collector and the co-processor.
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+#ifndef BOARD_STATUS_H
+#define BOARD_STATUS_H
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+
+#include <stdint.h>
+
+#include "board_lcd.h"
+#include "board_led.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*!
+ \defgroup BoardStatus Status Display
+ <BR>
+ Every LCD write is a blocking SPI transfer, too slow to do for each frame
+ or MT message. STATUS_WRITE_STRING_VALUE() and the LED macros below only
+ record the newest text of a line, or the newest request of an LED, and
+ mark it dirty. A periodic clock calls the application's notify function
+ when something is dirty, and the application then calls
+ Board_Status_refresh() from a task to paint it. A line that changes many
+ times in one period is painted once, with its last text.
+ <BR>
+ Line text isn't copied: the string must be a literal or otherwise stay
+ valid, only the value is stored.
+ <BR>
+ Build with BOARD_STATUS_ENABLED set to 0 to paint every write directly, as
+ the LCD_WRITE_STRING macros do.
+ <BR>
+ */
+
+/*!
+ * \ingroup BoardStatus
+ * @{
+ */
+
+/******************************************************************************
+ Constants and definitions
+ *****************************************************************************/
+
+/*! Set to 0 to write the LCD and LEDs directly */
+#if !defined(BOARD_STATUS_ENABLED)
+#define BOARD_STATUS_ENABLED        1
+#endif
+
+/*! Refresh period in milliseconds */
+#if !defined(BOARD_STATUS_PERIOD)
+#define BOARD_STATUS_PERIOD         250
+#endif
+
+/*! Number of LCD lines, 0 to BOARD_STATUS_MAX_LINES - 1 */
+#if !defined(BOARD_STATUS_MAX_LINES)
+#define BOARD_STATUS_MAX_LINES      8
+#endif
+
+/*! Number of LEDs */
+#define BOARD_STATUS_MAX_LEDS       4
+
+/*! Format of a line without a value */
+#define BOARD_STATUS_NO_VALUE       0
+
+/*! Notify function type, called from the clock when something is dirty */
+typedef void (*Board_Status_notifyFp_t)(void);
+
+/*! Status display statistics */
+typedef struct _board_status_statistics_t
+{
+    /*! Line writes recorded */
+    uint32_t lineUpdates;
+    /*! LED requests recorded */
+    uint32_t ledUpdates;
+    /*! Lines painted on the LCD */
+    uint32_t lcdWrites;
+    /*! LED requests applied */
+    uint32_t ledWrites;
+} Board_Status_statistics_t;
+
+#if BOARD_STATUS_ENABLED
+/*! Record a string for an LCD line */
+#define STATUS_WRITE_STRING(str, line) \
+    Board_Status_setLine(line, str, 0, BOARD_STATUS_NO_VALUE)
+/*! Record a string with a value for an LCD line */
+#define STATUS_WRITE_STRING_VALUE(str, value, format, line) \
+    Board_Status_setLine(line, str, value, format)
+/*! Record an LED state */
+#define STATUS_LED_CONTROL(led, state) Board_Status_setLed(led, state)
+/*! Record an LED toggle */
+#define STATUS_LED_TOGGLE(led) Board_Status_toggleLed(led)
+#else
+/*! Write a string to an LCD line */
+#define STATUS_WRITE_STRING(str, line) LCD_WRITE_STRING(str, line)
+/*! Write a string with a value to an LCD line */
+#define STATUS_WRITE_STRING_VALUE(str, value, format, line) \
+    LCD_WRITE_STRING_VALUE(str, value, format, line)
+/*! Set an LED state */
+#define STATUS_LED_CONTROL(led, state) Board_Led_control(led, state)
+/*! Toggle an LED */
+#define STATUS_LED_TOGGLE(led) Board_Led_toggle(led)
+#endif
+
+/******************************************************************************
+ Global Variables
+ *****************************************************************************/
+
+#if BOARD_STATUS_ENABLED
+/*! Status display statistics */
+extern Board_Status_statistics_t Board_Status_statistics;
+#endif
+
+/******************************************************************************
+ Function Prototypes
+ *****************************************************************************/
+
+#if BOARD_STATUS_ENABLED
+/*!
+ * @brief       Start the refresh clock. Call after Board_LCD_open() and
+ *              Board_Led_initialize().
+ *
+ * @param       pNotifyFp - called from the clock, in Swi context, when a
+ *                          line or LED is dirty, or NULL
+ */
+extern void Board_Status_init(Board_Status_notifyFp_t pNotifyFp);
+
+/*!
+ * @brief       Record the text of an LCD line.
+ *
+ * @param       line - LCD line
+ * @param       str - string, not copied
+ * @param       value - value printed after the string
+ * @param       format - value format as for LCD_WRITE_STRING_VALUE(), or
+ *                       BOARD_STATUS_NO_VALUE for the string alone
+ */
+extern void Board_Status_setLine(uint8_t line, char *str, uint16_t value,
+                                 uint8_t format);
+
+/*!
+ * @brief       Record an LED state, replacing a recorded toggle.
+ *
+ * @param       led - LED
+ * @param       state - state
+ */
+extern void Board_Status_setLed(board_led_type led, board_led_state state);
+
+/*!
+ * @brief       Record an LED toggle. The toggles recorded in one period
+ *              are applied as one.
+ *
+ * @param       led - LED
+ */
+extern void Board_Status_toggleLed(board_led_type led);
+
+/*!
+ * @brief       Paint the dirty lines and apply the recorded LED requests.
+ *              Call from a task, not from the notify function.
+ */
+extern void Board_Status_refresh(void);
+#else
+#define Board_Status_init(pNotifyFp) ((void)(pNotifyFp))
+#define Board_Status_refresh()
+#endif
+
+/*! @} end group BoardStatus */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BOARD_STATUS_H */
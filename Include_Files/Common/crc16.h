@@ -0,0 +1,118 @@
+/******************************************************************************
+
+ @file  crc16.h
+
+ @brief CRC-16 (CCITT polynomial 0x1021) engine shared by the stack image
+        validation and the NPI/MT frame check.
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+#ifndef CRC16_H
+#define CRC16_H
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*!
+ \defgroup Crc16 CRC-16 Engine
+ <BR>
+ Table driven CRC-16 with the same output as the original bit-by-bit
+ slow_crc16() routine. The engine is selected at build time with
+ CRC16_ENGINE:
+ <BR>
+ - CRC16_ENGINE_BITWISE - one shift per bit, no tables (smallest).
+ - CRC16_ENGINE_TABLE   - one 256 entry table, one lookup per byte.
+ - CRC16_ENGINE_SLICE4  - four 256 entry tables, four bytes per step.
+ <BR>
+ */
+
+/*!
+ * \ingroup Crc16
+ * @{
+ */
+
+/******************************************************************************
+ Constants and definitions
+ *****************************************************************************/
+
+/*! CRC-16 CCITT polynomial */
+#define CRC16_POLYNOMIAL        0x1021
+
+/*! Bit-by-bit engine, no lookup tables */
+#define CRC16_ENGINE_BITWISE    0
+/*! Single 256 entry lookup table (512 bytes of flash) */
+#define CRC16_ENGINE_TABLE      1
+/*! Slice-by-4 lookup tables (2048 bytes of flash) */
+#define CRC16_ENGINE_SLICE4     2
+
+#if !defined(CRC16_ENGINE)
+/*! Default engine */
+#define CRC16_ENGINE            CRC16_ENGINE_TABLE
+#endif
+
+#if (CRC16_ENGINE != CRC16_ENGINE_BITWISE) && \
+    (CRC16_ENGINE != CRC16_ENGINE_TABLE) && \
+    (CRC16_ENGINE != CRC16_ENGINE_SLICE4)
+#error "CRC16 ERROR: CRC16_ENGINE must be BITWISE, TABLE or SLICE4"
+#endif
+
+/*! Number of zero bytes needed to rotate the answer out of the register */
+#define CRC16_FINAL_ZEROS       2
+
+/******************************************************************************
+ Function Prototypes
+ *****************************************************************************/
+
+/*!
+ * @brief       Run the CRC register over a buffer. This is the "augmented"
+ *              form: the message bits are shifted into the register, so
+ *              the result must be passed through CRC16_finalize() once all
+ *              of the data has been processed. The output is identical to
+ *              the original slow_crc16() for any starting value, so calls
+ *              may be chained over non-contiguous buffers.
+ *
+ * @param       crc - CRC value to start with (0 for a new calculation)
+ * @param       pBuf - pointer to the bytes to run the CRC over
+ * @param       len - number of bytes to process
+ *
+ * @return      updated CRC register
+ */
+extern uint16_t CRC16_update(uint16_t crc, const uint8_t *pBuf, uint32_t len);
+
+/*!
+ * @brief       Rotate the answer out of the CRC register, equivalent to
+ *              calling CRC16_update() with CRC16_FINAL_ZEROS zero bytes.
+ *
+ * @param       crc - CRC register returned by CRC16_update()
+ *
+ * @return      CRC-16 result
+ */
+extern uint16_t CRC16_finalize(uint16_t crc);
+
+/*!
+ * @brief       Calculate the CRC-16 of a single buffer, starting from 0.
+ *
+ * @param       pBuf - pointer to the bytes to run the CRC over
+ * @param       len - number of bytes to process
+ *
+ * @return      CRC-16 result
+ */
+extern uint16_t CRC16_calc(const uint8_t *pBuf, uint32_t len);
+
+/*! @} end group Crc16 */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CRC16_H */
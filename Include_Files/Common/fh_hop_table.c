@@ -0,0 +1,112 @@
+/******************************************************************************
+
+ @file  fh_hop_table.c
+
+ @brief Frequency hopping channel mask compiled into a hop sequence table,
+        shared by the sensor and collector FH configuration.
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+
+#include "fh_hop_table.h"
+
+/******************************************************************************
+ Public Functions
+ *****************************************************************************/
+
+/*!
+ Build the hop sequence of a channel mask.
+
+ Public function defined in fh_hop_table.h
+ */
+void FhHopTable_init(FhHopTable_t *pTable, const uint8_t *pMask,
+                     uint8_t maskLen, uint8_t maxChannels)
+{
+    uint16_t channel;
+    uint8_t idx;
+
+    if(maxChannels > FH_HOP_TABLE_MAX_CHANNELS)
+    {
+        maxChannels = FH_HOP_TABLE_MAX_CHANNELS;
+    }
+
+    pTable->count = 0;
+    pTable->next = 0;
+
+    for(idx = 0; idx < maskLen; idx++)
+    {
+        uint8_t bits = pMask[idx];
+
+        /* Only the set bits are visited, lowest first */
+        channel = (uint16_t)idx * 8;
+        while(bits != 0)
+        {
+            if((bits & 1) != 0)
+            {
+                if(channel >= maxChannels)
+                {
+                    return;
+                }
+                pTable->channels[pTable->count++] = (uint8_t)channel;
+            }
+            bits >>= 1;
+            channel++;
+        }
+    }
+}
+
+/*!
+ Get the next channel of the hop sequence.
+
+ Public function defined in fh_hop_table.h
+ */
+uint8_t FhHopTable_next(FhHopTable_t *pTable, uint8_t defaultChannel)
+{
+    uint8_t channel;
+
+    if(pTable->count == 0)
+    {
+        return (defaultChannel);
+    }
+
+    channel = pTable->channels[pTable->next];
+
+    pTable->next++;
+    if(pTable->next >= pTable->count)
+    {
+        pTable->next = 0;
+    }
+
+    return (channel);
+}
+
+/*!
+ Build the excluded channels bitmap of a channel mask.
+
+ Public function defined in fh_hop_table.h
+ */
+void FhHopTable_excludeChannels(const uint8_t *pMask, uint8_t maskLen,
+                                uint8_t *pExclude, uint8_t excludeLen)
+{
+    uint8_t idx;
+
+    if(maskLen > excludeLen)
+    {
+        maskLen = excludeLen;
+    }
+
+    memset(pExclude, 0, excludeLen);
+    for(idx = 0; idx < maskLen; idx++)
+    {
+        pExclude[idx] = (uint8_t)~pMask[idx];
+    }
+}
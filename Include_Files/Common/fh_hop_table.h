@@ -0,0 +1,113 @@
+/******************************************************************************
+
+ @file  fh_hop_table.h
+
+ @brief Frequency hopping channel mask compiled into a hop sequence table,
+        shared by the sensor and collector FH configuration.
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+#ifndef FH_HOP_TABLE_H
+#define FH_HOP_TABLE_H
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*!
+ \defgroup FhHopTable FH Hop Sequence Table
+ <BR>
+ The FH channel mask (CONFIG_FH_CHANNEL_MASK, one bit per channel, channel 0
+ in bit 0 of the first byte) is scanned once into a dense list of the
+ enabled channels in ascending order. A sleepy node then steps through the
+ list with an index, so picking the next channel doesn't depend on the
+ number of channels or on where they sit in the mask.
+ <BR>
+ */
+
+/*!
+ * \ingroup FhHopTable
+ * @{
+ */
+
+/******************************************************************************
+ Constants and definitions
+ *****************************************************************************/
+
+/*! Largest number of channels in a table, APIMAC_154G_MAX_NUM_CHANNEL */
+#if !defined(FH_HOP_TABLE_MAX_CHANNELS)
+#define FH_HOP_TABLE_MAX_CHANNELS   129
+#endif
+
+/******************************************************************************
+ Typedefs
+ *****************************************************************************/
+
+/*! Hop sequence table */
+typedef struct _fhhoptable_t
+{
+    /*! Number of channels in the list */
+    uint8_t count;
+    /*! Index in the list of the next channel */
+    uint8_t next;
+    /*! Enabled channels, ascending */
+    uint8_t channels[FH_HOP_TABLE_MAX_CHANNELS];
+} FhHopTable_t;
+
+/******************************************************************************
+ Function Prototypes
+ *****************************************************************************/
+
+/*!
+ * @brief       Build the hop sequence of a channel mask. The sequence starts
+ *              at the lowest enabled channel.
+ *
+ * @param       pTable - table to fill in
+ * @param       pMask - channel mask
+ * @param       maskLen - channel mask length in bytes
+ * @param       maxChannels - channels at or above this number are left out,
+ *                            FH_HOP_TABLE_MAX_CHANNELS at most
+ */
+extern void FhHopTable_init(FhHopTable_t *pTable, const uint8_t *pMask,
+                            uint8_t maskLen, uint8_t maxChannels);
+
+/*!
+ * @brief       Get the next channel of the hop sequence, wrapping to the
+ *              first channel after the last one.
+ *
+ * @param       pTable - hop sequence table
+ * @param       defaultChannel - channel returned when the mask is empty
+ *
+ * @return      channel number
+ */
+extern uint8_t FhHopTable_next(FhHopTable_t *pTable, uint8_t defaultChannel);
+
+/*!
+ * @brief       Build the excluded channels bitmap of a channel mask, the
+ *              complement of the mask. Bytes of pExclude past the end of the
+ *              mask are cleared.
+ *
+ * @param       pMask - channel mask
+ * @param       maskLen - channel mask length in bytes
+ * @param       pExclude - excluded channels bitmap to fill in
+ * @param       excludeLen - excluded channels bitmap length in bytes
+ */
+extern void FhHopTable_excludeChannels(const uint8_t *pMask, uint8_t maskLen,
+                                       uint8_t *pExclude, uint8_t excludeLen);
+
+/*! @} end group FhHopTable */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FH_HOP_TABLE_H */
@@ -0,0 +1,91 @@
+/******************************************************************************
+
+ @file  mac_pib_multi.h
+
+ @brief Batched MAC PIB get/set message shared by the application ApiMac
+        layer and the MAC stack ICall handler.
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+#ifndef MAC_PIB_MULTI_H
+#define MAC_PIB_MULTI_H
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*!
+ \defgroup MacPibMulti Batched MAC PIB Access
+ <BR>
+ One ICall message carries a list of MAC PIB attributes, which the MAC
+ stack reads or writes in a single pass. The application thread stays
+ blocked in ICall_waitMatch() until the reply, so the stack reads and
+ writes the caller's buffers directly.
+ <BR>
+ */
+
+/*!
+ * \ingroup MacPibMulti
+ * @{
+ */
+
+/******************************************************************************
+ Constants and definitions
+ *****************************************************************************/
+
+/*! Message event: get a list of MAC PIB attributes.
+    Kept clear of the MAC callback and MacStack.h command event ranges. */
+#define MAC_GET_REQ_MULTI           0xF0
+/*! Message event: set a list of MAC PIB attributes */
+#define MAC_SET_REQ_MULTI           0xF1
+
+/*! Largest number of attributes in one request */
+#define MAC_PIB_MULTI_MAX_ENTRIES   8
+
+/******************************************************************************
+ Typedefs
+ *****************************************************************************/
+
+/*! One attribute of a batched request */
+typedef struct _macpibmultientry_t
+{
+    /*! MAC PIB attribute identifier */
+    uint8_t attribute;
+    /*! Per attribute status, filled in by the MAC stack */
+    uint8_t status;
+    /*! Get: in, size of the pValue buffer; out, length read.
+        Set: not used. */
+    uint16_t len;
+    /*! Attribute value buffer owned by the caller */
+    void *pValue;
+} macPibMultiEntry_t;
+
+/*! Batched get/set request, also returned as the reply */
+typedef struct _macpibmultiparam_t
+{
+    /*! Same layout as macEventHdr_t: event, then status */
+    uint8_t event;
+    /*! First failing status, or 0 when every attribute succeeded */
+    uint8_t status;
+    /*! Number of entries in pEntries */
+    uint8_t count;
+    /*! List of attributes */
+    macPibMultiEntry_t *pEntries;
+} macPibMultiParam_t;
+
+/*! @} end group MacPibMulti */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MAC_PIB_MULTI_H */
@@ -0,0 +1,120 @@
+/******************************************************************************
+
+ @file  mac_sec_devices.h
+
+ @brief Bulk MAC security device add/delete message shared by the application
+        ApiMac layer and the MAC stack ICall handler.
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+#ifndef MAC_SEC_DEVICES_H
+#define MAC_SEC_DEVICES_H
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*!
+ \defgroup MacSecDevices Bulk MAC Security Device Provisioning
+ <BR>
+ One ICall message carries a list of devices that the MAC stack adds to,
+ or deletes from, the security device table in a single pass. The ApiMac
+ layer splits longer lists into messages of MAC_SEC_DEVICES_MAX_ENTRIES
+ devices, so the MAC task is never held for long.
+ <BR>
+ */
+
+/*!
+ * \ingroup MacSecDevices
+ * @{
+ */
+
+/******************************************************************************
+ Constants and definitions
+ *****************************************************************************/
+
+/*! Message event: add a list of security devices.
+    Follows the batched PIB events of mac_pib_multi.h. */
+#define MAC_SEC_ADD_DEVICES            0xF2
+/*! Message event: delete a list of security devices */
+#define MAC_SEC_DEL_DEVICES            0xF3
+
+/*! Largest number of devices in one message */
+#define MAC_SEC_DEVICES_MAX_ENTRIES    16
+
+/*! Length of an extended address */
+#define MAC_SEC_DEVICES_EXT_LEN        8
+/*! Length of the longest key ID lookup data */
+#define MAC_SEC_DEVICES_LOOKUP_LEN     9
+
+/******************************************************************************
+ Typedefs
+ *****************************************************************************/
+
+/*! One device of a bulk add, the arguments of macWrapperAddDevice() */
+typedef struct _macsecdevicesentry_t
+{
+    /*! Starting frame counter */
+    uint32_t frameCounter;
+    /*! PAN ID */
+    uint16_t panId;
+    /*! Short address */
+    uint16_t shortAddr;
+    /*! Extended address */
+    uint8_t extAddr[MAC_SEC_DEVICES_EXT_LEN];
+    /*! Device descriptor exempt field */
+    uint8_t exempt;
+    /*! Key ID lookup data size, 0 for 5 bytes, 1 for 9 bytes */
+    uint8_t keyIdLookupDataSize;
+    /*! Key ID lookup data */
+    uint8_t keyIdLookupData[MAC_SEC_DEVICES_LOOKUP_LEN];
+    /*! Key device descriptor uniqueDevice field */
+    uint8_t uniqueDevice;
+    /*! Also add the device to the keys that don't match the lookup data */
+    uint8_t duplicateDevFlag;
+    /*! Per device status, filled in by the MAC stack */
+    uint8_t status;
+} macSecDevicesEntry_t;
+
+/*! Bulk add request, also returned as the reply */
+typedef struct _macsecadddevicesparam_t
+{
+    /*! Same layout as macEventHdr_t: event, then status */
+    uint8_t event;
+    /*! First failing status, or 0 when every device was added */
+    uint8_t status;
+    /*! Number of entries */
+    uint8_t count;
+    /*! Devices, allocated with the message */
+    macSecDevicesEntry_t entries[];
+} macSecAddDevicesParam_t;
+
+/*! Bulk delete request, also returned as the reply */
+typedef struct _macsecdeldevicesparam_t
+{
+    /*! Same layout as macEventHdr_t: event, then status */
+    uint8_t event;
+    /*! First failing status, or 0 when every device was deleted */
+    uint8_t status;
+    /*! Number of entries */
+    uint8_t count;
+    /*! Extended addresses, allocated with the message */
+    uint8_t extAddr[][MAC_SEC_DEVICES_EXT_LEN];
+} macSecDelDevicesParam_t;
+
+/*! @} end group MacSecDevices */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MAC_SEC_DEVICES_H */
@@ -0,0 +1,116 @@
+/******************************************************************************
+
+ @file  mac_sec_index.h
+
+ @brief Lookups of the MAC security table indexes, kept by mac_security_pib.c
+        and used by macwrapper.c.
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+#ifndef MAC_SEC_INDEX_H
+#define MAC_SEC_INDEX_H
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+
+#include "mac_security_pib.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*!
+ \defgroup MacSecIndex MAC Security Table Indexes
+ <BR>
+ The security PIB keeps hashed indexes of the device table by extended
+ address and of the key table by key ID lookup data, updated by
+ MAC_MlmeSetSecurityReq(). These lookups read the indexes in place of a
+ walk over the tables. They are called with interrupts disabled, like
+ the rest of the security PIB access.
+ <BR>
+ */
+
+/*!
+ * \ingroup MacSecIndex
+ * @{
+ */
+
+/******************************************************************************
+ Constants and definitions
+ *****************************************************************************/
+
+/*! Returned when there is no matching or free entry */
+#define MAC_SEC_INDEX_NONE             0xFF
+
+/******************************************************************************
+ Function Prototypes
+ *****************************************************************************/
+
+/*!
+ * @brief       Find the device table entry of an extended address.
+ *
+ * @param       pExtAddr - extended address
+ *
+ * @return      device_index, or MAC_SEC_INDEX_NONE
+ */
+extern uint8 macSecurityPibFindDevice(const uint8 *pExtAddr);
+
+/*!
+ * @brief       Find the first device table entry that is not in use.
+ *
+ * @return      device_index, or MAC_SEC_INDEX_NONE if the table is full
+ */
+extern uint8 macSecurityPibFreeDevice(void);
+
+/*!
+ * @brief       Find the used key that has a matching key ID lookup entry.
+ *
+ * @param       lookupDataSize - 0 for 5 bytes, 1 for 9 bytes
+ * @param       pLookupData - key ID lookup data
+ *
+ * @return      key_index, or MAC_SEC_INDEX_NONE
+ */
+extern uint8 macSecurityPibFindKey(uint8 lookupDataSize,
+                                   const uint8 *pLookupData);
+
+/*!
+ * @brief       Check whether a key is in use.
+ *
+ * @param       keyIndex - key_index
+ *
+ * @return      TRUE if the key has lookup entries and none of them marks
+ *              it unused
+ */
+extern uint8 macSecurityPibKeyUsed(uint8 keyIndex);
+
+/*!
+ * @brief       Find the key device entry of a key that references a device.
+ *
+ * @param       keyIndex - key_index
+ * @param       device - device_index
+ *
+ * @return      key_device_index, or MAC_SEC_INDEX_NONE
+ */
+extern uint8 macSecurityPibFindKeyDevice(uint8 keyIndex, uint8 device);
+
+/*!
+ * @brief       Find the first key device entry of a key that does not
+ *              reference a device.
+ *
+ * @param       keyIndex - key_index
+ *
+ * @return      key_device_index, or MAC_SEC_INDEX_NONE if the list is full
+ */
+extern uint8 macSecurityPibFreeKeyDevice(uint8 keyIndex);
+
+/*! @} end group MacSecIndex */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MAC_SEC_INDEX_H */
@@ -0,0 +1,1951 @@
+/******************************************************************************
+
+ @file  mactrace.c
+
+ @brief MAC callback trace: records the ApiMac callbacks delivered to the
+        application and replays them on a host.
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+
+#include <stddef.h>
+#include <string.h>
+
+#include "mactrace.h"
+
+#if MACTRACE_ENABLED
+
+#if defined(MACTRACE_HOST)
+#include <stdlib.h>
+#include <time.h>
+#else
+#include <ti/sysbios/knl/Clock.h>
+#endif
+
+/******************************************************************************
+ Constants and definitions
+ *****************************************************************************/
+
+#if defined(MACTRACE_HOST)
+/*! Host builds read the virtual clock, in milliseconds */
+#define MACTRACE_TICKS_PER_MS   1
+#else
+/*! Clock ticks per millisecond, as in timer.c */
+#define MACTRACE_TICKS_PER_MS   (1000 / Clock_tickPeriod)
+#endif
+
+/*! Capability information bits of an association indication */
+#define CAP_PAN_COORD           0x01
+#define CAP_FFD                 0x02
+#define CAP_MAINS_POWER         0x04
+#define CAP_RX_ON_WHEN_IDLE     0x08
+#define CAP_SECURITY            0x10
+#define CAP_ALLOC_ADDR          0x20
+
+/*! Length of a lost record: header and count */
+#define LOST_RECORD_LEN         5
+
+#if defined(MACTRACE_HOST)
+/*! Parameters of any callback, as replayed */
+typedef union
+{
+    ApiMac_mlmeAssociateInd_t assocInd;
+    ApiMac_mlmeAssociateCnf_t assocCnf;
+    ApiMac_mlmeDisassociateInd_t disassocInd;
+    ApiMac_mlmeDisassociateCnf_t disassocCnf;
+    ApiMac_mlmeBeaconNotifyInd_t beaconNotifyInd;
+    ApiMac_mlmeOrphanInd_t orphanInd;
+    ApiMac_mlmeScanCnf_t scanCnf;
+    ApiMac_mlmeStartCnf_t startCnf;
+    ApiMac_mlmeSyncLossInd_t syncLossInd;
+    ApiMac_mlmePollCnf_t pollCnf;
+    ApiMac_mlmeCommStatusInd_t commStatusInd;
+    ApiMac_mlmePollInd_t pollInd;
+    ApiMac_mcpsDataCnf_t dataCnf;
+    ApiMac_mcpsDataInd_t dataInd;
+    ApiMac_mcpsPurgeCnf_t purgeCnf;
+    ApiMac_mlmeWsAsyncCnf_t wsAsyncCnf;
+} cbParams_t;
+#endif
+
+/******************************************************************************
+ Global variables
+ *****************************************************************************/
+
+#if defined(MACTRACE_HOST)
+/* File the records are written to */
+FILE *Mactrace_pFile = NULL;
+#endif
+
+/******************************************************************************
+ Local variables
+ *****************************************************************************/
+
+/*! Application callback table */
+static ApiMac_callbacks_t *pAppCallbacks;
+/*! Table of shims given to the MAC API */
+static ApiMac_callbacks_t shimCallbacks;
+
+/*! Parameters of the record being written */
+static uint8_t params[MACTRACE_RECORD_MAX];
+/*! Length of the parameters */
+static uint16_t paramsLen;
+/*! true if the parameters didn't fit */
+static bool paramsOverflow;
+
+/*! Time of the last record written, in clock ticks */
+static uint32_t lastTime;
+/*! Records dropped since the last record written */
+static uint16_t lostCount;
+
+#if defined(MACTRACE_HOST)
+/*! Virtual clock, in milliseconds */
+static uint32_t virtualTime;
+/*! Active timers */
+static Mactrace_timer_t *pTimers;
+
+/*! Heap in use */
+static uint32_t heapInUse;
+/*! Most heap in use */
+static uint32_t heapHighWater;
+
+/*! Parameters of the record being replayed */
+static const uint8_t *pIn;
+/*! Bytes left in the parameters */
+static uint16_t inLen;
+/*! true if the parameters were too short */
+static bool inError;
+#else
+/*!
+ Ring of records. Written and drained by the application task, nothing to
+ lock.
+ */
+static uint8_t ring[MACTRACE_RING_SIZE];
+/*! Index the next record is written at */
+static uint16_t ringHead;
+/*! Index of the oldest record */
+static uint16_t ringTail;
+#endif
+
+/******************************************************************************
+ Local function prototypes
+ *****************************************************************************/
+static uint32_t readClock(void);
+static void recordCallback(Mactrace_type_t type, void *pParams);
+static void encodeParams(Mactrace_type_t type, void *pParams);
+static void writeRecord(Mactrace_type_t type);
+static uint8_t putVarint(uint8_t *pBuf, uint32_t value);
+static void put8(uint8_t value);
+static void put16(uint16_t value);
+static void put32(uint32_t value);
+static void putBuf(const uint8_t *pBuf, uint16_t len);
+static void putAddr(ApiMac_sAddr_t *pAddr);
+static void putSec(ApiMac_sec_t *pSec);
+static void putPanDesc(ApiMac_panDesc_t *pPanDesc);
+static void putDataInd(ApiMac_mcpsDataInd_t *pInd);
+#if defined(MACTRACE_HOST)
+static uint64_t readWallClock(void);
+static bool readVarint(FILE *pFile, uint32_t *pValue);
+static bool decodeParams(Mactrace_type_t type, cbParams_t *pParams);
+static void deliverParams(Mactrace_type_t type, cbParams_t *pParams,
+                          ApiMac_callbacks_t *pCallbacks);
+static void freeParams(Mactrace_type_t type, cbParams_t *pParams);
+static uint8_t get8(void);
+static uint16_t get16(void);
+static uint32_t get32(void);
+static uint8_t *getBuf(uint16_t len);
+static void getAddr(ApiMac_sAddr_t *pAddr);
+static void getSec(ApiMac_sec_t *pSec);
+static void getPanDesc(ApiMac_panDesc_t *pPanDesc);
+static void getDataInd(ApiMac_mcpsDataInd_t *pInd);
+#else
+static uint16_t ringUsed(void);
+static void ringPut(const uint8_t *pBuf, uint16_t len);
+static uint16_t ringRecordLen(uint16_t index);
+#endif
+
+/* Callback shims */
+static void assocIndShim(ApiMac_mlmeAssociateInd_t *pInd);
+static void assocCnfShim(ApiMac_mlmeAssociateCnf_t *pCnf);
+static void disassocIndShim(ApiMac_mlmeDisassociateInd_t *pInd);
+static void disassocCnfShim(ApiMac_mlmeDisassociateCnf_t *pCnf);
+static void beaconNotifyIndShim(ApiMac_mlmeBeaconNotifyInd_t *pInd);
+static void orphanIndShim(ApiMac_mlmeOrphanInd_t *pInd);
+static void scanCnfShim(ApiMac_mlmeScanCnf_t *pCnf);
+static void startCnfShim(ApiMac_mlmeStartCnf_t *pCnf);
+static void syncLossIndShim(ApiMac_mlmeSyncLossInd_t *pInd);
+static void pollCnfShim(ApiMac_mlmePollCnf_t *pCnf);
+static void commStatusIndShim(ApiMac_mlmeCommStatusInd_t *pInd);
+static void pollIndShim(ApiMac_mlmePollInd_t *pInd);
+static void dataCnfShim(ApiMac_mcpsDataCnf_t *pCnf);
+static void dataIndShim(ApiMac_mcpsDataInd_t *pInd);
+static void purgeCnfShim(ApiMac_mcpsPurgeCnf_t *pCnf);
+static void wsAsyncIndShim(ApiMac_mlmeWsAsyncInd_t *pInd);
+static void wsAsyncCnfShim(ApiMac_mlmeWsAsyncCnf_t *pCnf);
+
+/******************************************************************************
+ Public Functions
+ *****************************************************************************/
+
+/*!
+ Wrap the application's callback table.
+
+ Public function defined in mactrace.h
+ */
+ApiMac_callbacks_t *Mactrace_wrapCallbacks(ApiMac_callbacks_t *pCallbacks)
+{
+    if(pCallbacks == NULL)
+    {
+        return (NULL);
+    }
+
+    pAppCallbacks = pCallbacks;
+
+    /* Callbacks the application doesn't have stay NULL */
+    memset(&shimCallbacks, 0, sizeof(ApiMac_callbacks_t));
+    if(pCallbacks->pAssocIndCb)
+    {
+        shimCallbacks.pAssocIndCb = assocIndShim;
+    }
+    if(pCallbacks->pAssocCnfCb)
+    {
+        shimCallbacks.pAssocCnfCb = assocCnfShim;
+    }
+    if(pCallbacks->pDisassociateIndCb)
+    {
+        shimCallbacks.pDisassociateIndCb = disassocIndShim;
+    }
+    if(pCallbacks->pDisassociateCnfCb)
+    {
+        shimCallbacks.pDisassociateCnfCb = disassocCnfShim;
+    }
+    if(pCallbacks->pBeaconNotifyIndCb)
+    {
+        shimCallbacks.pBeaconNotifyIndCb = beaconNotifyIndShim;
+    }
+    if(pCallbacks->pOrphanIndCb)
+    {
+        shimCallbacks.pOrphanIndCb = orphanIndShim;
+    }
+    if(pCallbacks->pScanCnfCb)
+    {
+        shimCallbacks.pScanCnfCb = scanCnfShim;
+    }
+    if(pCallbacks->pStartCnfCb)
+    {
+        shimCallbacks.pStartCnfCb = startCnfShim;
+    }
+    if(pCallbacks->pSyncLossIndCb)
+    {
+        shimCallbacks.pSyncLossIndCb = syncLossIndShim;
+    }
+    if(pCallbacks->pPollCnfCb)
+    {
+        shimCallbacks.pPollCnfCb = pollCnfShim;
+    }
+    if(pCallbacks->pCommStatusCb)
+    {
+        shimCallbacks.pCommStatusCb = commStatusIndShim;
+    }
+    if(pCallbacks->pPollIndCb)
+    {
+        shimCallbacks.pPollIndCb = pollIndShim;
+    }
+    if(pCallbacks->pDataCnfCb)
+    {
+        shimCallbacks.pDataCnfCb = dataCnfShim;
+    }
+    if(pCallbacks->pDataIndCb)
+    {
+        shimCallbacks.pDataIndCb = dataIndShim;
+    }
+    if(pCallbacks->pPurgeCnfCb)
+    {
+        shimCallbacks.pPurgeCnfCb = purgeCnfShim;
+    }
+    if(pCallbacks->pWsAsyncIndCb)
+    {
+        shimCallbacks.pWsAsyncIndCb = wsAsyncIndShim;
+    }
+    if(pCallbacks->pWsAsyncCnfCb)
+    {
+        shimCallbacks.pWsAsyncCnfCb = wsAsyncCnfShim;
+    }
+
+    /* Unprocessed messages aren't MAC callbacks, they aren't recorded */
+    shimCallbacks.pUnprocessedCb = pCallbacks->pUnprocessedCb;
+
+    return (&shimCallbacks);
+}
+
+/*!
+ Read whole records from the RAM ring.
+
+ Public function defined in mactrace.h
+ */
+uint16_t Mactrace_read(uint8_t *pBuf, uint16_t maxLen)
+{
+#if defined(MACTRACE_HOST)
+    (void)pBuf;
+    (void)maxLen;
+
+    return (0);
+#else
+    uint16_t len = 0;
+
+    while(ringTail != ringHead)
+    {
+        uint16_t recLen = ringRecordLen(ringTail);
+        uint16_t i;
+
+        if((len + recLen) > maxLen)
+        {
+            break;
+        }
+
+        for(i = 0; i < recLen; i++)
+        {
+            pBuf[len++] = ring[ringTail];
+            ringTail = (ringTail + 1) % MACTRACE_RING_SIZE;
+        }
+    }
+
+    return (len);
+#endif
+}
+
+#if defined(MACTRACE_HOST)
+/*!
+ Read the virtual clock.
+
+ Public function defined in mactrace.h
+ */
+uint32_t Mactrace_now(void)
+{
+    return (virtualTime);
+}
+
+/*!
+ Advance the virtual clock.
+
+ Public function defined in mactrace.h
+ */
+uint32_t Mactrace_advance(uint32_t time, void (*pProcessFp)(void))
+{
+    uint32_t expired = 0;
+
+    for(;;)
+    {
+        Mactrace_timer_t *pTimer;
+        Mactrace_timer_t *pNext = NULL;
+
+        /* The earliest timer due goes first */
+        for(pTimer = pTimers; pTimer != NULL; pTimer = pTimer->pNext)
+        {
+            if(((int32_t)(time - pTimer->expiry) >= 0)
+               && ((pNext == NULL)
+                   || ((int32_t)(pTimer->expiry - pNext->expiry) <= 0)))
+            {
+                pNext = pTimer;
+            }
+        }
+
+        if(pNext == NULL)
+        {
+            break;
+        }
+
+        virtualTime = pNext->expiry;
+        Mactrace_timerStop(pNext);
+        if(pNext->period != 0)
+        {
+            Mactrace_timerStart(pNext, pNext->period);
+        }
+
+        pNext->fxn(pNext->arg);
+        if(pProcessFp != NULL)
+        {
+            pProcessFp();
+        }
+        expired++;
+    }
+
+    virtualTime = time;
+
+    return (expired);
+}
+
+/*!
+ Start a timer on the virtual clock.
+
+ Public function defined in mactrace.h
+ */
+void Mactrace_timerStart(Mactrace_timer_t *pTimer, uint32_t timeout)
+{
+    /* A restart moves the expiry */
+    Mactrace_timerStop(pTimer);
+
+    pTimer->expiry = virtualTime + timeout;
+    pTimer->active = true;
+    pTimer->pNext = pTimers;
+    pTimers = pTimer;
+}
+
+/*!
+ Stop a timer.
+
+ Public function defined in mactrace.h
+ */
+void Mactrace_timerStop(Mactrace_timer_t *pTimer)
+{
+    Mactrace_timer_t **ppTimer;
+
+    for(ppTimer = &pTimers; *ppTimer != NULL; ppTimer = &(*ppTimer)->pNext)
+    {
+        if(*ppTimer == pTimer)
+        {
+            *ppTimer = pTimer->pNext;
+            break;
+        }
+    }
+
+    pTimer->active = false;
+}
+
+/*!
+ Allocate from the accounted heap.
+
+ Public function defined in mactrace.h
+ */
+void *Mactrace_malloc(uint32_t size)
+{
+    /* The size is kept in front of the block, 8 bytes to keep alignment */
+    uint64_t *pBlock = malloc(sizeof(uint64_t) + size);
+
+    if(pBlock == NULL)
+    {
+        return (NULL);
+    }
+
+    *pBlock = size;
+    heapInUse += size;
+    if(heapInUse > heapHighWater)
+    {
+        heapHighWater = heapInUse;
+    }
+
+    return (pBlock + 1);
+}
+
+/*!
+ Free memory from Mactrace_malloc().
+
+ Public function defined in mactrace.h
+ */
+void Mactrace_free(void *pMem)
+{
+    uint64_t *pBlock = (uint64_t *)pMem;
+
+    if(pBlock != NULL)
+    {
+        pBlock--;
+        heapInUse -= (uint32_t)*pBlock;
+        free(pBlock);
+    }
+}
+
+/*!
+ Replay a trace into an application.
+
+ Public function defined in mactrace.h
+ */
+bool Mactrace_replay(FILE *pFile, Mactrace_replayParams_t *pParams,
+                     Mactrace_replayStats_t *pStats)
+{
+    static uint8_t body[MACTRACE_RECORD_MAX];
+    uint64_t start;
+    bool ok = true;
+    int type;
+
+    memset(pStats, 0, sizeof(Mactrace_replayStats_t));
+    heapHighWater = heapInUse;
+    start = readWallClock();
+
+    while((type = fgetc(pFile)) != EOF)
+    {
+        cbParams_t cbParams;
+        Mactrace_cbStats_t *pCbStats;
+        uint32_t len;
+        uint32_t delta;
+        uint64_t begin;
+        uint32_t ns;
+
+        if((readVarint(pFile, &len) == false)
+           || (readVarint(pFile, &delta) == false)
+           || (len > MACTRACE_RECORD_MAX)
+           || (fread(body, 1, len, pFile) != len))
+        {
+            ok = false;
+            break;
+        }
+
+        /* Timers due before the record expire first */
+        pStats->timers += Mactrace_advance(virtualTime + delta,
+                                           pParams->pProcessFp);
+
+        pIn = body;
+        inLen = (uint16_t)len;
+        inError = false;
+
+        if(type == Mactrace_type_lost)
+        {
+            pStats->lost += get16();
+            continue;
+        }
+
+        if((type > Mactrace_type_lost)
+           || (decodeParams((Mactrace_type_t)type, &cbParams) == false))
+        {
+            ok = false;
+            break;
+        }
+
+        begin = readWallClock();
+        deliverParams((Mactrace_type_t)type, &cbParams, pParams->pCallbacks);
+        if(pParams->pProcessFp != NULL)
+        {
+            pParams->pProcessFp();
+        }
+        ns = (uint32_t)(readWallClock() - begin);
+
+        freeParams((Mactrace_type_t)type, &cbParams);
+
+        pCbStats = &pStats->cb[type];
+        pCbStats->count++;
+        pCbStats->sum += ns;
+        if(ns > pCbStats->max)
+        {
+            pCbStats->max = ns;
+        }
+        pStats->msgs++;
+    }
+
+    pStats->virtualTime = virtualTime;
+    pStats->elapsed = readWallClock() - start;
+    if(pStats->elapsed != 0)
+    {
+        pStats->msgsPerSec = (uint32_t)(((uint64_t)pStats->msgs * 1000000000)
+                                        / pStats->elapsed);
+    }
+    pStats->heapHighWater = heapHighWater;
+    pStats->heapInUse = heapInUse;
+
+    return (ok);
+}
+#endif /* MACTRACE_HOST */
+
+/******************************************************************************
+ Local Functions
+ *****************************************************************************/
+
+/*!
+ * @brief       Read the time.
+ *
+ * @return      time, in units of 1 / MACTRACE_TICKS_PER_MS milliseconds
+ */
+static uint32_t readClock(void)
+{
+#if defined(MACTRACE_HOST)
+    return (virtualTime);
+#else
+    return (Clock_getTicks());
+#endif
+}
+
+/*!
+ * @brief       Record a callback.
+ *
+ * @param       type - callback type
+ * @param       pParams - callback parameters
+ */
+static void recordCallback(Mactrace_type_t type, void *pParams)
+{
+    paramsLen = 0;
+    paramsOverflow = false;
+
+    encodeParams(type, pParams);
+    writeRecord(type);
+}
+
+/*!
+ * @brief       Write the parameters of a callback to the record.
+ *
+ * @param       type - callback type
+ * @param       pParams - callback parameters
+ */
+static void encodeParams(Mactrace_type_t type, void *pParams)
+{
+    switch(type)
+    {
+        case Mactrace_type_assocInd:
+            {
+                ApiMac_mlmeAssociateInd_t *pInd = pParams;
+                ApiMac_capabilityInfo_t *pCap = &pInd->capabilityInformation;
+
+                putBuf(pInd->deviceAddress, APIMAC_SADDR_EXT_LEN);
+                put8((pCap->panCoord ? CAP_PAN_COORD : 0)
+                     | (pCap->ffd ? CAP_FFD : 0)
+                     | (pCap->mainsPower ? CAP_MAINS_POWER : 0)
+                     | (pCap->rxOnWhenIdle ? CAP_RX_ON_WHEN_IDLE : 0)
+                     | (pCap->security ? CAP_SECURITY : 0)
+                     | (pCap->allocAddr ? CAP_ALLOC_ADDR : 0));
+                putSec(&pInd->sec);
+            }
+            break;
+
+        case Mactrace_type_assocCnf:
+            {
+                ApiMac_mlmeAssociateCnf_t *pCnf = pParams;
+
+                put8(pCnf->status);
+                put16(pCnf->assocShortAddress);
+                putSec(&pCnf->sec);
+            }
+            break;
+
+        case Mactrace_type_disassocInd:
+            {
+                ApiMac_mlmeDisassociateInd_t *pInd = pParams;
+
+                putBuf(pInd->deviceAddress, APIMAC_SADDR_EXT_LEN);
+                put8(pInd->disassociateReason);
+                putSec(&pInd->sec);
+            }
+            break;
+
+        case Mactrace_type_disassocCnf:
+            {
+                ApiMac_mlmeDisassociateCnf_t *pCnf = pParams;
+
+                put8(pCnf->status);
+                putAddr(&pCnf->deviceAddress);
+                put16(pCnf->panId);
+            }
+            break;
+
+        case Mactrace_type_beaconNotifyInd:
+            {
+                ApiMac_mlmeBeaconNotifyInd_t *pInd = pParams;
+
+                put8(pInd->beaconType);
+                put8(pInd->bsn);
+                putPanDesc(&pInd->panDesc);
+                if(pInd->beaconType == ApiMac_beaconType_normal)
+                {
+                    ApiMac_beaconData_t *pData = &pInd->beaconData.beacon;
+                    uint8_t i;
+
+                    put8(pData->numPendShortAddr);
+                    for(i = 0; i < pData->numPendShortAddr; i++)
+                    {
+                        put16(pData->pShortAddrList[i]);
+                    }
+                    put8(pData->numPendExtAddr);
+                    putBuf(pData->pExtAddrList,
+                           pData->numPendExtAddr * APIMAC_SADDR_EXT_LEN);
+                    put8(pData->sduLength);
+                    putBuf(pData->pSdu, pData->sduLength);
+                }
+                else
+                {
+                    ApiMac_coexist_t *pCoexist =
+                                    &pInd->beaconData.eBeacon.coexist;
+
+                    put8(pCoexist->beaconOrder);
+                    put8(pCoexist->superFrameOrder);
+                    put8(pCoexist->finalCapSlot);
+                    put8(pCoexist->eBeaconOrder);
+                    put8(pCoexist->offsetTimeSlot);
+                    put8(pCoexist->capBackOff);
+                    put16(pCoexist->eBeaconOrderNBPAN);
+                }
+            }
+            break;
+
+        case Mactrace_type_orphanInd:
+            {
+                ApiMac_mlmeOrphanInd_t *pInd = pParams;
+
+                putBuf(pInd->orphanAddress, APIMAC_SADDR_EXT_LEN);
+                putSec(&pInd->sec);
+            }
+            break;
+
+        case Mactrace_type_scanCnf:
+            {
+                ApiMac_mlmeScanCnf_t *pCnf = pParams;
+                uint8_t i;
+
+                put8(pCnf->status);
+                put8(pCnf->scanType);
+                put8(pCnf->channelPage);
+                put8(pCnf->phyId);
+                put8(APIMAC_154G_CHANNEL_BITMAP_SIZ);
+                putBuf(pCnf->unscannedChannels, APIMAC_154G_CHANNEL_BITMAP_SIZ);
+                put8(pCnf->resultListSize);
+                if(pCnf->scanType == ApiMac_scantype_energyDetect)
+                {
+                    putBuf(pCnf->result.pEnergyDetect, pCnf->resultListSize);
+                }
+                else if(pCnf->scanType != ApiMac_scantype_orphan)
+                {
+                    for(i = 0; i < pCnf->resultListSize; i++)
+                    {
+                        putPanDesc(&pCnf->result.pPanDescriptor[i]);
+                    }
+                }
+            }
+            break;
+
+        case Mactrace_type_startCnf:
+            {
+                ApiMac_mlmeStartCnf_t *pCnf = pParams;
+
+                put8(pCnf->status);
+            }
+            break;
+
+        case Mactrace_type_syncLossInd:
+            {
+                ApiMac_mlmeSyncLossInd_t *pInd = pParams;
+
+                put8(pInd->reason);
+                put16(pInd->panId);
+                put8(pInd->logicalChannel);
+                put8(pInd->channelPage);
+                put8(pInd->phyID);
+                putSec(&pInd->sec);
+            }
+            break;
+
+        case Mactrace_type_pollCnf:
+            {
+                ApiMac_mlmePollCnf_t *pCnf = pParams;
+
+                put8(pCnf->status);
+                put8(pCnf->framePending);
+            }
+            break;
+
+        case Mactrace_type_commStatusInd:
+            {
+                ApiMac_mlmeCommStatusInd_t *pInd = pParams;
+
+                put8(pInd->status);
+                putAddr(&pInd->srcAddr);
+                putAddr(&pInd->dstAddr);
+                put16(pInd->panId);
+                put8(pInd->reason);
+                putSec(&pInd->sec);
+            }
+            break;
+
+        case Mactrace_type_pollInd:
+            {
+                ApiMac_mlmePollInd_t *pInd = pParams;
+
+                putAddr(&pInd->srcAddr);
+                put16(pInd->srcPanId);
+                put8(pInd->noRsp);
+            }
+            break;
+
+        case Mactrace_type_dataCnf:
+            {
+                ApiMac_mcpsDataCnf_t *pCnf = pParams;
+
+                put8(pCnf->status);
+                put8(pCnf->msduHandle);
+                put32(pCnf->timestamp);
+                put16(pCnf->timestamp2);
+                put8(pCnf->retries);
+                put8(pCnf->mpduLinkQuality);
+                put8(pCnf->correlation);
+                put8((uint8_t)pCnf->rssi);
+                put32(pCnf->frameCntr);
+            }
+            break;
+
+        case Mactrace_type_dataInd:
+        case Mactrace_type_wsAsyncInd:
+            putDataInd(pParams);
+            break;
+
+        case Mactrace_type_purgeCnf:
+            {
+                ApiMac_mcpsPurgeCnf_t *pCnf = pParams;
+
+                put8(pCnf->status);
+                put8(pCnf->msduHandle);
+            }
+            break;
+
+        case Mactrace_type_wsAsyncCnf:
+            {
+                ApiMac_mlmeWsAsyncCnf_t *pCnf = pParams;
+
+                put8(pCnf->status);
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+/*!
+ * @brief       Write the record, or count it as lost if it doesn't fit.
+ *              A lost record goes in front of the first record written
+ *              after records were dropped.
+ *
+ * @param       type - callback type
+ */
+static void writeRecord(Mactrace_type_t type)
+{
+    uint8_t hdr[MACTRACE_HDR_MAX];
+    uint8_t lost[LOST_RECORD_LEN];
+    uint8_t lostLen = 0;
+    uint8_t hdrLen;
+    uint32_t now = readClock();
+    uint32_t delta = (now - lastTime) / MACTRACE_TICKS_PER_MS;
+
+    if(paramsOverflow == true)
+    {
+        if(lostCount < 0xFFFF)
+        {
+            lostCount++;
+        }
+        return;
+    }
+
+    hdr[0] = (uint8_t)type;
+    hdrLen = 1 + putVarint(&hdr[1], paramsLen);
+    hdrLen += putVarint(&hdr[hdrLen], delta);
+
+    if(lostCount != 0)
+    {
+        lost[0] = Mactrace_type_lost;
+        lost[1] = 2;
+        lost[2] = 0;
+        lost[3] = (uint8_t)lostCount;
+        lost[4] = (uint8_t)(lostCount >> 8);
+        lostLen = LOST_RECORD_LEN;
+    }
+
+#if defined(MACTRACE_HOST)
+    if(Mactrace_pFile == NULL)
+    {
+        return;
+    }
+
+    fwrite(lost, 1, lostLen, Mactrace_pFile);
+    fwrite(hdr, 1, hdrLen, Mactrace_pFile);
+    fwrite(params, 1, paramsLen, Mactrace_pFile);
+#else
+    /* One byte of the ring stays free to tell full from empty */
+    if((ringUsed() + lostLen + hdrLen + paramsLen) >= MACTRACE_RING_SIZE)
+    {
+        if(lostCount < 0xFFFF)
+        {
+            lostCount++;
+        }
+        return;
+    }
+
+    ringPut(lost, lostLen);
+    ringPut(hdr, hdrLen);
+    ringPut(params, paramsLen);
+#endif
+
+    /* Only whole milliseconds are taken, the rest goes to the next record */
+    lastTime += delta * MACTRACE_TICKS_PER_MS;
+    lostCount = 0;
+}
+
+/*!
+ * @brief       Write a 7 bit varint.
+ *
+ * @param       pBuf - buffer, 5 bytes long
+ * @param       value - value
+ *
+ * @return      number of bytes written
+ */
+static uint8_t putVarint(uint8_t *pBuf, uint32_t value)
+{
+    uint8_t len = 0;
+
+    while(value >= 0x80)
+    {
+        pBuf[len++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    pBuf[len++] = (uint8_t)value;
+
+    return (len);
+}
+
+/*!
+ * @brief       Write a byte to the parameters.
+ *
+ * @param       value - byte
+ */
+static void put8(uint8_t value)
+{
+    putBuf(&value, 1);
+}
+
+/*!
+ * @brief       Write a 16 bit value to the parameters, little endian.
+ *
+ * @param       value - value
+ */
+static void put16(uint16_t value)
+{
+    uint8_t buf[2];
+
+    buf[0] = (uint8_t)value;
+    buf[1] = (uint8_t)(value >> 8);
+    putBuf(buf, sizeof(buf));
+}
+
+/*!
+ * @brief       Write a 32 bit value to the parameters, little endian.
+ *
+ * @param       value - value
+ */
+static void put32(uint32_t value)
+{
+    uint8_t buf[4];
+
+    buf[0] = (uint8_t)value;
+    buf[1] = (uint8_t)(value >> 8);
+    buf[2] = (uint8_t)(value >> 16);
+    buf[3] = (uint8_t)(value >> 24);
+    putBuf(buf, sizeof(buf));
+}
+
+/*!
+ * @brief       Write bytes to the parameters.
+ *
+ * @param       pBuf - bytes, may be NULL if len is 0
+ * @param       len - number of bytes
+ */
+static void putBuf(const uint8_t *pBuf, uint16_t len)
+{
+    if((paramsOverflow == true) || (len > (MACTRACE_RECORD_MAX - paramsLen)))
+    {
+        paramsOverflow = true;
+        return;
+    }
+
+    if(len != 0)
+    {
+        memcpy(&params[paramsLen], pBuf, len);
+        paramsLen += len;
+    }
+}
+
+/*!
+ * @brief       Write an address to the parameters: the mode, then the short
+ *              or extended address.
+ *
+ * @param       pAddr - address
+ */
+static void putAddr(ApiMac_sAddr_t *pAddr)
+{
+    put8(pAddr->addrMode);
+    if(pAddr->addrMode == ApiMac_addrType_short)
+    {
+        put16(pAddr->addr.shortAddr);
+    }
+    else if(pAddr->addrMode == ApiMac_addrType_extended)
+    {
+        putBuf(pAddr->addr.extAddr, APIMAC_SADDR_EXT_LEN);
+    }
+}
+
+/*!
+ * @brief       Write security parameters to the parameters: the level, then
+ *              the key if the level isn't 0.
+ *
+ * @param       pSec - security parameters
+ */
+static void putSec(ApiMac_sec_t *pSec)
+{
+    put8(pSec->securityLevel);
+    if(pSec->securityLevel != 0)
+    {
+        put8(pSec->keyIdMode);
+        put8(pSec->keyIndex);
+        putBuf(pSec->keySource, APIMAC_KEY_SOURCE_MAX_LEN);
+    }
+}
+
+/*!
+ * @brief       Write a PAN descriptor to the parameters.
+ *
+ * @param       pPanDesc - PAN descriptor
+ */
+static void putPanDesc(ApiMac_panDesc_t *pPanDesc)
+{
+    putAddr(&pPanDesc->coordAddress);
+    put16(pPanDesc->coordPanId);
+    put16(pPanDesc->superframeSpec);
+    put8(pPanDesc->logicalChannel);
+    put8(pPanDesc->channelPage);
+    put8(pPanDesc->gtsPermit);
+    put8(pPanDesc->linkQuality);
+    put32(pPanDesc->timestamp);
+    put8(pPanDesc->securityFailure);
+    putSec(&pPanDesc->sec);
+}
+
+/*!
+ * @brief       Write a data indication to the parameters.
+ *
+ * @param       pInd - data indication
+ */
+static void putDataInd(ApiMac_mcpsDataInd_t *pInd)
+{
+    putAddr(&pInd->srcAddr);
+    putAddr(&pInd->dstAddr);
+    put32(pInd->timestamp);
+    put16(pInd->timestamp2);
+    put16(pInd->srcPanId);
+    put16(pInd->dstPanId);
+    put8(pInd->mpduLinkQuality);
+    put8(pInd->correlation);
+    put8((uint8_t)pInd->rssi);
+    put8(pInd->dsn);
+    put8(pInd->fhFrameType);
+    put8(pInd->fhProtoDispatch);
+    put32(pInd->frameCntr);
+    putSec(&pInd->sec);
+    put16(pInd->payloadIeLen);
+    putBuf(pInd->pPayloadIE, pInd->payloadIeLen);
+    put16(pInd->msdu.len);
+    putBuf(pInd->msdu.p, pInd->msdu.len);
+}
+
+#if defined(MACTRACE_HOST)
+/*!
+ * @brief       Read the wall clock.
+ *
+ * @return      time, in nanoseconds
+ */
+static uint64_t readWallClock(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec);
+}
+
+/*!
+ * @brief       Read a 7 bit varint from a trace.
+ *
+ * @param       pFile - trace
+ * @param       pValue - value
+ *
+ * @return      true if read
+ */
+static bool readVarint(FILE *pFile, uint32_t *pValue)
+{
+    uint8_t shift;
+    int c;
+
+    *pValue = 0;
+    for(shift = 0; shift < 35; shift += 7)
+    {
+        if((c = fgetc(pFile)) == EOF)
+        {
+            return (false);
+        }
+        *pValue |= (uint32_t)(c & 0x7F) << shift;
+        if((c & 0x80) == 0)
+        {
+            return (true);
+        }
+    }
+
+    return (false);
+}
+
+/*!
+ * @brief       Read the parameters of a callback from the record. Buffers
+ *              point into the record, lists that need their own alignment
+ *              are allocated.
+ *
+ * @param       type - callback type
+ * @param       pParams - callback parameters
+ *
+ * @return      true if the record held the parameters
+ */
+static bool decodeParams(Mactrace_type_t type, cbParams_t *pParams)
+{
+    memset(pParams, 0, sizeof(cbParams_t));
+
+    switch(type)
+    {
+        case Mactrace_type_assocInd:
+            {
+                ApiMac_mlmeAssociateInd_t *pInd = &pParams->assocInd;
+                ApiMac_capabilityInfo_t *pCap = &pInd->capabilityInformation;
+                uint8_t *pAddr = getBuf(APIMAC_SADDR_EXT_LEN);
+                uint8_t cap;
+
+                if(pAddr != NULL)
+                {
+                    memcpy(pInd->deviceAddress, pAddr, APIMAC_SADDR_EXT_LEN);
+                }
+                cap = get8();
+                pCap->panCoord = (cap & CAP_PAN_COORD) ? true : false;
+                pCap->ffd = (cap & CAP_FFD) ? true : false;
+                pCap->mainsPower = (cap & CAP_MAINS_POWER) ? true : false;
+                pCap->rxOnWhenIdle = (cap & CAP_RX_ON_WHEN_IDLE) ? true : false;
+                pCap->security = (cap & CAP_SECURITY) ? true : false;
+                pCap->allocAddr = (cap & CAP_ALLOC_ADDR) ? true : false;
+                getSec(&pInd->sec);
+            }
+            break;
+
+        case Mactrace_type_assocCnf:
+            {
+                ApiMac_mlmeAssociateCnf_t *pCnf = &pParams->assocCnf;
+
+                pCnf->status = (ApiMac_assocStatus_t)get8();
+                pCnf->assocShortAddress = get16();
+                getSec(&pCnf->sec);
+            }
+            break;
+
+        case Mactrace_type_disassocInd:
+            {
+                ApiMac_mlmeDisassociateInd_t *pInd = &pParams->disassocInd;
+                uint8_t *pAddr = getBuf(APIMAC_SADDR_EXT_LEN);
+
+                if(pAddr != NULL)
+                {
+                    memcpy(pInd->deviceAddress, pAddr, APIMAC_SADDR_EXT_LEN);
+                }
+                pInd->disassociateReason = (ApiMac_disassocateReason_t)get8();
+                getSec(&pInd->sec);
+            }
+            break;
+
+        case Mactrace_type_disassocCnf:
+            {
+                ApiMac_mlmeDisassociateCnf_t *pCnf = &pParams->disassocCnf;
+
+                pCnf->status = (ApiMac_status_t)get8();
+                getAddr(&pCnf->deviceAddress);
+                pCnf->panId = get16();
+            }
+            break;
+
+        case Mactrace_type_beaconNotifyInd:
+            {
+                ApiMac_mlmeBeaconNotifyInd_t *pInd = &pParams->beaconNotifyInd;
+
+                pInd->beaconType = (ApiMac_beaconType_t)get8();
+                pInd->bsn = get8();
+                getPanDesc(&pInd->panDesc);
+                if(pInd->beaconType == ApiMac_beaconType_normal)
+                {
+                    ApiMac_beaconData_t *pData = &pInd->beaconData.beacon;
+                    uint8_t i;
+
+                    pData->numPendShortAddr = get8();
+                    pData->pShortAddrList = malloc(
+                                    (pData->numPendShortAddr + 1)
+                                    * sizeof(uint16_t));
+                    for(i = 0; i < pData->numPendShortAddr; i++)
+                    {
+                        pData->pShortAddrList[i] = get16();
+                    }
+                    pData->numPendExtAddr = get8();
+                    pData->pExtAddrList = getBuf(pData->numPendExtAddr
+                                                 * APIMAC_SADDR_EXT_LEN);
+                    pData->sduLength = get8();
+                    pData->pSdu = getBuf(pData->sduLength);
+                }
+                else
+                {
+                    ApiMac_coexist_t *pCoexist =
+                                    &pInd->beaconData.eBeacon.coexist;
+
+                    pCoexist->beaconOrder = get8();
+                    pCoexist->superFrameOrder = get8();
+                    pCoexist->finalCapSlot = get8();
+                    pCoexist->eBeaconOrder = get8();
+                    pCoexist->offsetTimeSlot = get8();
+                    pCoexist->capBackOff = get8();
+                    pCoexist->eBeaconOrderNBPAN = get16();
+                }
+            }
+            break;
+
+        case Mactrace_type_orphanInd:
+            {
+                ApiMac_mlmeOrphanInd_t *pInd = &pParams->orphanInd;
+                uint8_t *pAddr = getBuf(APIMAC_SADDR_EXT_LEN);
+
+                if(pAddr != NULL)
+                {
+                    memcpy(pInd->orphanAddress, pAddr, APIMAC_SADDR_EXT_LEN);
+                }
+                getSec(&pInd->sec);
+            }
+            break;
+
+        case Mactrace_type_scanCnf:
+            {
+                ApiMac_mlmeScanCnf_t *pCnf = &pParams->scanCnf;
+                uint8_t *pBitmap;
+                uint8_t bitmapLen;
+                uint8_t i;
+
+                pCnf->status = (ApiMac_status_t)get8();
+                pCnf->scanType = (ApiMac_scantype_t)get8();
+                pCnf->channelPage = get8();
+                pCnf->phyId = get8();
+                bitmapLen = get8();
+                pBitmap = getBuf(bitmapLen);
+                if(pBitmap != NULL)
+                {
+                    memcpy(pCnf->unscannedChannels, pBitmap,
+                           (bitmapLen < APIMAC_154G_CHANNEL_BITMAP_SIZ) ?
+                           bitmapLen : APIMAC_154G_CHANNEL_BITMAP_SIZ);
+                }
+                pCnf->resultListSize = get8();
+                if(pCnf->scanType == ApiMac_scantype_energyDetect)
+                {
+                    pCnf->result.pEnergyDetect = getBuf(pCnf->resultListSize);
+                }
+                else if((pCnf->scanType != ApiMac_scantype_orphan)
+                        && (pCnf->resultListSize != 0))
+                {
+                    pCnf->result.pPanDescriptor = calloc(
+                                    pCnf->resultListSize,
+                                    sizeof(ApiMac_panDesc_t));
+                    for(i = 0; i < pCnf->resultListSize; i++)
+                    {
+                        getPanDesc(&pCnf->result.pPanDescriptor[i]);
+                    }
+                }
+            }
+            break;
+
+        case Mactrace_type_startCnf:
+            pParams->startCnf.status = (ApiMac_status_t)get8();
+            break;
+
+        case Mactrace_type_syncLossInd:
+            {
+                ApiMac_mlmeSyncLossInd_t *pInd = &pParams->syncLossInd;
+
+                pInd->reason = (ApiMac_status_t)get8();
+                pInd->panId = get16();
+                pInd->logicalChannel = get8();
+                pInd->channelPage = get8();
+                pInd->phyID = get8();
+                getSec(&pInd->sec);
+            }
+            break;
+
+        case Mactrace_type_pollCnf:
+            pParams->pollCnf.status = (ApiMac_status_t)get8();
+            pParams->pollCnf.framePending = get8();
+            break;
+
+        case Mactrace_type_commStatusInd:
+            {
+                ApiMac_mlmeCommStatusInd_t *pInd = &pParams->commStatusInd;
+
+                pInd->status = (ApiMac_status_t)get8();
+                getAddr(&pInd->srcAddr);
+                getAddr(&pInd->dstAddr);
+                pInd->panId = get16();
+                pInd->reason = (ApiMac_commStatusReason_t)get8();
+                getSec(&pInd->sec);
+            }
+            break;
+
+        case Mactrace_type_pollInd:
+            getAddr(&pParams->pollInd.srcAddr);
+            pParams->pollInd.srcPanId = get16();
+            pParams->pollInd.noRsp = get8() ? true : false;
+            break;
+
+        case Mactrace_type_dataCnf:
+            {
+                ApiMac_mcpsDataCnf_t *pCnf = &pParams->dataCnf;
+
+                pCnf->status = (ApiMac_status_t)get8();
+                pCnf->msduHandle = get8();
+                pCnf->timestamp = get32();
+                pCnf->timestamp2 = get16();
+                pCnf->retries = get8();
+                pCnf->mpduLinkQuality = get8();
+                pCnf->correlation = get8();
+                pCnf->rssi = (int8_t)get8();
+                pCnf->frameCntr = get32();
+            }
+            break;
+
+        case Mactrace_type_dataInd:
+        case Mactrace_type_wsAsyncInd:
+            getDataInd(&pParams->dataInd);
+            break;
+
+        case Mactrace_type_purgeCnf:
+            pParams->purgeCnf.status = (ApiMac_status_t)get8();
+            pParams->purgeCnf.msduHandle = get8();
+            break;
+
+        case Mactrace_type_wsAsyncCnf:
+            pParams->wsAsyncCnf.status = (ApiMac_status_t)get8();
+            break;
+
+        default:
+            inError = true;
+            break;
+    }
+
+    if((inError == true) || (inLen != 0))
+    {
+        freeParams(type, pParams);
+        return (false);
+    }
+
+    return (true);
+}
+
+/*!
+ * @brief       Call the application's callback.
+ *
+ * @param       type - callback type
+ * @param       pParams - callback parameters
+ * @param       pCallbacks - application callback table
+ */
+static void deliverParams(Mactrace_type_t type, cbParams_t *pParams,
+                          ApiMac_callbacks_t *pCallbacks)
+{
+    switch(type)
+    {
+        case Mactrace_type_assocInd:
+            if(pCallbacks->pAssocIndCb)
+            {
+                pCallbacks->pAssocIndCb(&pParams->assocInd);
+            }
+            break;
+
+        case Mactrace_type_assocCnf:
+            if(pCallbacks->pAssocCnfCb)
+            {
+                pCallbacks->pAssocCnfCb(&pParams->assocCnf);
+            }
+            break;
+
+        case Mactrace_type_disassocInd:
+            if(pCallbacks->pDisassociateIndCb)
+            {
+                pCallbacks->pDisassociateIndCb(&pParams->disassocInd);
+            }
+            break;
+
+        case Mactrace_type_disassocCnf:
+            if(pCallbacks->pDisassociateCnfCb)
+            {
+                pCallbacks->pDisassociateCnfCb(&pParams->disassocCnf);
+            }
+            break;
+
+        case Mactrace_type_beaconNotifyInd:
+            if(pCallbacks->pBeaconNotifyIndCb)
+            {
+                pCallbacks->pBeaconNotifyIndCb(&pParams->beaconNotifyInd);
+            }
+            break;
+
+        case Mactrace_type_orphanInd:
+            if(pCallbacks->pOrphanIndCb)
+            {
+                pCallbacks->pOrphanIndCb(&pParams->orphanInd);
+            }
+            break;
+
+        case Mactrace_type_scanCnf:
+            if(pCallbacks->pScanCnfCb)
+            {
+                pCallbacks->pScanCnfCb(&pParams->scanCnf);
+            }
+            break;
+
+        case Mactrace_type_startCnf:
+            if(pCallbacks->pStartCnfCb)
+            {
+                pCallbacks->pStartCnfCb(&pParams->startCnf);
+            }
+            break;
+
+        case Mactrace_type_syncLossInd:
+            if(pCallbacks->pSyncLossIndCb)
+            {
+                pCallbacks->pSyncLossIndCb(&pParams->syncLossInd);
+            }
+            break;
+
+        case Mactrace_type_pollCnf:
+            if(pCallbacks->pPollCnfCb)
+            {
+                pCallbacks->pPollCnfCb(&pParams->pollCnf);
+            }
+            break;
+
+        case Mactrace_type_commStatusInd:
+            if(pCallbacks->pCommStatusCb)
+            {
+                pCallbacks->pCommStatusCb(&pParams->commStatusInd);
+            }
+            break;
+
+        case Mactrace_type_pollInd:
+            if(pCallbacks->pPollIndCb)
+            {
+                pCallbacks->pPollIndCb(&pParams->pollInd);
+            }
+            break;
+
+        case Mactrace_type_dataCnf:
+            if(pCallbacks->pDataCnfCb)
+            {
+                pCallbacks->pDataCnfCb(&pParams->dataCnf);
+            }
+            break;
+
+        case Mactrace_type_dataInd:
+            if(pCallbacks->pDataIndCb)
+            {
+                pCallbacks->pDataIndCb(&pParams->dataInd);
+            }
+            break;
+
+        case Mactrace_type_purgeCnf:
+            if(pCallbacks->pPurgeCnfCb)
+            {
+                pCallbacks->pPurgeCnfCb(&pParams->purgeCnf);
+            }
+            break;
+
+        case Mactrace_type_wsAsyncInd:
+            if(pCallbacks->pWsAsyncIndCb)
+            {
+                pCallbacks->pWsAsyncIndCb(&pParams->dataInd);
+            }
+            break;
+
+        case Mactrace_type_wsAsyncCnf:
+            if(pCallbacks->pWsAsyncCnfCb)
+            {
+                pCallbacks->pWsAsyncCnfCb(&pParams->wsAsyncCnf);
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+/*!
+ * @brief       Free the lists decodeParams() allocated.
+ *
+ * @param       type - callback type
+ * @param       pParams - callback parameters
+ */
+static void freeParams(Mactrace_type_t type, cbParams_t *pParams)
+{
+    if((type == Mactrace_type_beaconNotifyInd)
+       && (pParams->beaconNotifyInd.beaconType == ApiMac_beaconType_normal))
+    {
+        free(pParams->beaconNotifyInd.beaconData.beacon.pShortAddrList);
+    }
+    else if((type == Mactrace_type_scanCnf)
+            && (pParams->scanCnf.scanType != ApiMac_scantype_energyDetect))
+    {
+        free(pParams->scanCnf.result.pPanDescriptor);
+    }
+}
+
+/*!
+ * @brief       Read a byte from the parameters.
+ *
+ * @return      byte, 0 past the end
+ */
+static uint8_t get8(void)
+{
+    uint8_t *pBuf = getBuf(1);
+
+    return ((pBuf != NULL) ? pBuf[0] : 0);
+}
+
+/*!
+ * @brief       Read a 16 bit value from the parameters, little endian.
+ *
+ * @return      value, 0 past the end
+ */
+static uint16_t get16(void)
+{
+    uint8_t *pBuf = getBuf(2);
+
+    return ((pBuf != NULL) ? (uint16_t)(pBuf[0] | (pBuf[1] << 8)) : 0);
+}
+
+/*!
+ * @brief       Read a 32 bit value from the parameters, little endian.
+ *
+ * @return      value, 0 past the end
+ */
+static uint32_t get32(void)
+{
+    uint8_t *pBuf = getBuf(4);
+
+    if(pBuf == NULL)
+    {
+        return (0);
+    }
+
+    return ((uint32_t)pBuf[0] | ((uint32_t)pBuf[1] << 8)
+            | ((uint32_t)pBuf[2] << 16) | ((uint32_t)pBuf[3] << 24));
+}
+
+/*!
+ * @brief       Take bytes from the parameters.
+ *
+ * @param       len - number of bytes
+ *
+ * @return      pointer to the bytes in the record, NULL past the end
+ */
+static uint8_t *getBuf(uint16_t len)
+{
+    uint8_t *pBuf = (uint8_t *)pIn;
+
+    if(len > inLen)
+    {
+        inError = true;
+        inLen = 0;
+        return (NULL);
+    }
+
+    pIn += len;
+    inLen -= len;
+
+    return (pBuf);
+}
+
+/*!
+ * @brief       Read an address from the parameters.
+ *
+ * @param       pAddr - address
+ */
+static void getAddr(ApiMac_sAddr_t *pAddr)
+{
+    pAddr->addrMode = (ApiMac_addrType_t)get8();
+    if(pAddr->addrMode == ApiMac_addrType_short)
+    {
+        pAddr->addr.shortAddr = get16();
+    }
+    else if(pAddr->addrMode == ApiMac_addrType_extended)
+    {
+        uint8_t *pExt = getBuf(APIMAC_SADDR_EXT_LEN);
+
+        if(pExt != NULL)
+        {
+            memcpy(pAddr->addr.extAddr, pExt, APIMAC_SADDR_EXT_LEN);
+        }
+    }
+}
+
+/*!
+ * @brief       Read security parameters from the parameters.
+ *
+ * @param       pSec - security parameters
+ */
+static void getSec(ApiMac_sec_t *pSec)
+{
+    pSec->securityLevel = get8();
+    if(pSec->securityLevel != 0)
+    {
+        uint8_t *pKeySource;
+
+        pSec->keyIdMode = get8();
+        pSec->keyIndex = get8();
+        pKeySource = getBuf(APIMAC_KEY_SOURCE_MAX_LEN);
+        if(pKeySource != NULL)
+        {
+            memcpy(pSec->keySource, pKeySource, APIMAC_KEY_SOURCE_MAX_LEN);
+        }
+    }
+}
+
+/*!
+ * @brief       Read a PAN descriptor from the parameters.
+ *
+ * @param       pPanDesc - PAN descriptor
+ */
+static void getPanDesc(ApiMac_panDesc_t *pPanDesc)
+{
+    getAddr(&pPanDesc->coordAddress);
+    pPanDesc->coordPanId = get16();
+    pPanDesc->superframeSpec = get16();
+    pPanDesc->logicalChannel = get8();
+    pPanDesc->channelPage = get8();
+    pPanDesc->gtsPermit = get8() ? true : false;
+    pPanDesc->linkQuality = get8();
+    pPanDesc->timestamp = get32();
+    pPanDesc->securityFailure = get8() ? true : false;
+    getSec(&pPanDesc->sec);
+}
+
+/*!
+ * @brief       Read a data indication from the parameters.
+ *
+ * @param       pInd - data indication
+ */
+static void getDataInd(ApiMac_mcpsDataInd_t *pInd)
+{
+    getAddr(&pInd->srcAddr);
+    getAddr(&pInd->dstAddr);
+    pInd->timestamp = get32();
+    pInd->timestamp2 = get16();
+    pInd->srcPanId = get16();
+    pInd->dstPanId = get16();
+    pInd->mpduLinkQuality = get8();
+    pInd->correlation = get8();
+    pInd->rssi = (int8_t)get8();
+    pInd->dsn = get8();
+    pInd->fhFrameType = (ApiMac_fhFrameType_t)get8();
+    pInd->fhProtoDispatch = (ApiMac_fhDispatchType_t)get8();
+    pInd->frameCntr = get32();
+    getSec(&pInd->sec);
+    pInd->payloadIeLen = get16();
+    pInd->pPayloadIE = getBuf(pInd->payloadIeLen);
+    pInd->msdu.len = get16();
+    pInd->msdu.p = getBuf(pInd->msdu.len);
+}
+#else
+/*!
+ * @brief       Find the number of bytes in the ring.
+ *
+ * @return      bytes in use
+ */
+static uint16_t ringUsed(void)
+{
+    return ((ringHead + MACTRACE_RING_SIZE - ringTail) % MACTRACE_RING_SIZE);
+}
+
+/*!
+ * @brief       Copy bytes into the ring, the caller checked they fit.
+ *
+ * @param       pBuf - bytes
+ * @param       len - number of bytes
+ */
+static void ringPut(const uint8_t *pBuf, uint16_t len)
+{
+    uint16_t i;
+
+    for(i = 0; i < len; i++)
+    {
+        ring[ringHead] = pBuf[i];
+        ringHead = (ringHead + 1) % MACTRACE_RING_SIZE;
+    }
+}
+
+/*!
+ * @brief       Find the length of a record in the ring.
+ *
+ * @param       index - index of the record
+ *
+ * @return      length of the record, header included
+ */
+static uint16_t ringRecordLen(uint16_t index)
+{
+    uint16_t len = 1;
+    uint16_t paramsLength = 0;
+    uint8_t shift = 0;
+    uint8_t c;
+
+    /* Parameter length */
+    do
+    {
+        c = ring[(index + len++) % MACTRACE_RING_SIZE];
+        paramsLength |= (uint16_t)(c & 0x7F) << shift;
+        shift += 7;
+    } while(c & 0x80);
+
+    /* Time */
+    do
+    {
+        c = ring[(index + len++) % MACTRACE_RING_SIZE];
+    } while(c & 0x80);
+
+    return (len + paramsLength);
+}
+#endif /* MACTRACE_HOST */
+
+/*!
+ * @brief       Record an association indication and pass it on.
+ *
+ * @param       pInd - association indication
+ */
+static void assocIndShim(ApiMac_mlmeAssociateInd_t *pInd)
+{
+    recordCallback(Mactrace_type_assocInd, pInd);
+    if(pAppCallbacks->pAssocIndCb)
+    {
+        pAppCallbacks->pAssocIndCb(pInd);
+    }
+}
+
+/*!
+ * @brief       Record an association confirm and pass it on.
+ *
+ * @param       pCnf - association confirm
+ */
+static void assocCnfShim(ApiMac_mlmeAssociateCnf_t *pCnf)
+{
+    recordCallback(Mactrace_type_assocCnf, pCnf);
+    if(pAppCallbacks->pAssocCnfCb)
+    {
+        pAppCallbacks->pAssocCnfCb(pCnf);
+    }
+}
+
+/*!
+ * @brief       Record a disassociation indication and pass it on.
+ *
+ * @param       pInd - disassociation indication
+ */
+static void disassocIndShim(ApiMac_mlmeDisassociateInd_t *pInd)
+{
+    recordCallback(Mactrace_type_disassocInd, pInd);
+    if(pAppCallbacks->pDisassociateIndCb)
+    {
+        pAppCallbacks->pDisassociateIndCb(pInd);
+    }
+}
+
+/*!
+ * @brief       Record a disassociation confirm and pass it on.
+ *
+ * @param       pCnf - disassociation confirm
+ */
+static void disassocCnfShim(ApiMac_mlmeDisassociateCnf_t *pCnf)
+{
+    recordCallback(Mactrace_type_disassocCnf, pCnf);
+    if(pAppCallbacks->pDisassociateCnfCb)
+    {
+        pAppCallbacks->pDisassociateCnfCb(pCnf);
+    }
+}
+
+/*!
+ * @brief       Record a beacon notify indication and pass it on.
+ *
+ * @param       pInd - beacon notify indication
+ */
+static void beaconNotifyIndShim(ApiMac_mlmeBeaconNotifyInd_t *pInd)
+{
+    recordCallback(Mactrace_type_beaconNotifyInd, pInd);
+    if(pAppCallbacks->pBeaconNotifyIndCb)
+    {
+        pAppCallbacks->pBeaconNotifyIndCb(pInd);
+    }
+}
+
+/*!
+ * @brief       Record an orphan indication and pass it on.
+ *
+ * @param       pInd - orphan indication
+ */
+static void orphanIndShim(ApiMac_mlmeOrphanInd_t *pInd)
+{
+    recordCallback(Mactrace_type_orphanInd, pInd);
+    if(pAppCallbacks->pOrphanIndCb)
+    {
+        pAppCallbacks->pOrphanIndCb(pInd);
+    }
+}
+
+/*!
+ * @brief       Record a scan confirm and pass it on.
+ *
+ * @param       pCnf - scan confirm
+ */
+static void scanCnfShim(ApiMac_mlmeScanCnf_t *pCnf)
+{
+    recordCallback(Mactrace_type_scanCnf, pCnf);
+    if(pAppCallbacks->pScanCnfCb)
+    {
+        pAppCallbacks->pScanCnfCb(pCnf);
+    }
+}
+
+/*!
+ * @brief       Record a start confirm and pass it on.
+ *
+ * @param       pCnf - start confirm
+ */
+static void startCnfShim(ApiMac_mlmeStartCnf_t *pCnf)
+{
+    recordCallback(Mactrace_type_startCnf, pCnf);
+    if(pAppCallbacks->pStartCnfCb)
+    {
+        pAppCallbacks->pStartCnfCb(pCnf);
+    }
+}
+
+/*!
+ * @brief       Record a sync loss indication and pass it on.
+ *
+ * @param       pInd - sync loss indication
+ */
+static void syncLossIndShim(ApiMac_mlmeSyncLossInd_t *pInd)
+{
+    recordCallback(Mactrace_type_syncLossInd, pInd);
+    if(pAppCallbacks->pSyncLossIndCb)
+    {
+        pAppCallbacks->pSyncLossIndCb(pInd);
+    }
+}
+
+/*!
+ * @brief       Record a poll confirm and pass it on.
+ *
+ * @param       pCnf - poll confirm
+ */
+static void pollCnfShim(ApiMac_mlmePollCnf_t *pCnf)
+{
+    recordCallback(Mactrace_type_pollCnf, pCnf);
+    if(pAppCallbacks->pPollCnfCb)
+    {
+        pAppCallbacks->pPollCnfCb(pCnf);
+    }
+}
+
+/*!
+ * @brief       Record a comm status indication and pass it on.
+ *
+ * @param       pInd - comm status indication
+ */
+static void commStatusIndShim(ApiMac_mlmeCommStatusInd_t *pInd)
+{
+    recordCallback(Mactrace_type_commStatusInd, pInd);
+    if(pAppCallbacks->pCommStatusCb)
+    {
+        pAppCallbacks->pCommStatusCb(pInd);
+    }
+}
+
+/*!
+ * @brief       Record a poll indication and pass it on.
+ *
+ * @param       pInd - poll indication
+ */
+static void pollIndShim(ApiMac_mlmePollInd_t *pInd)
+{
+    recordCallback(Mactrace_type_pollInd, pInd);
+    if(pAppCallbacks->pPollIndCb)
+    {
+        pAppCallbacks->pPollIndCb(pInd);
+    }
+}
+
+/*!
+ * @brief       Record a data confirm and pass it on.
+ *
+ * @param       pCnf - data confirm
+ */
+static void dataCnfShim(ApiMac_mcpsDataCnf_t *pCnf)
+{
+    recordCallback(Mactrace_type_dataCnf, pCnf);
+    if(pAppCallbacks->pDataCnfCb)
+    {
+        pAppCallbacks->pDataCnfCb(pCnf);
+    }
+}
+
+/*!
+ * @brief       Record a data indication and pass it on.
+ *
+ * @param       pInd - data indication
+ */
+static void dataIndShim(ApiMac_mcpsDataInd_t *pInd)
+{
+    recordCallback(Mactrace_type_dataInd, pInd);
+    if(pAppCallbacks->pDataIndCb)
+    {
+        pAppCallbacks->pDataIndCb(pInd);
+    }
+}
+
+/*!
+ * @brief       Record a purge confirm and pass it on.
+ *
+ * @param       pCnf - purge confirm
+ */
+static void purgeCnfShim(ApiMac_mcpsPurgeCnf_t *pCnf)
+{
+    recordCallback(Mactrace_type_purgeCnf, pCnf);
+    if(pAppCallbacks->pPurgeCnfCb)
+    {
+        pAppCallbacks->pPurgeCnfCb(pCnf);
+    }
+}
+
+/*!
+ * @brief       Record a WiSUN async indication and pass it on.
+ *
+ * @param       pInd - async indication
+ */
+static void wsAsyncIndShim(ApiMac_mlmeWsAsyncInd_t *pInd)
+{
+    recordCallback(Mactrace_type_wsAsyncInd, pInd);
+    if(pAppCallbacks->pWsAsyncIndCb)
+    {
+        pAppCallbacks->pWsAsyncIndCb(pInd);
+    }
+}
+
+/*!
+ * @brief       Record a WiSUN async confirm and pass it on.
+ *
+ * @param       pCnf - async confirm
+ */
+static void wsAsyncCnfShim(ApiMac_mlmeWsAsyncCnf_t *pCnf)
+{
+    recordCallback(Mactrace_type_wsAsyncCnf, pCnf);
+    if(pAppCallbacks->pWsAsyncCnfCb)
+    {
+        pAppCallbacks->pWsAsyncCnfCb(pCnf);
+    }
+}
+
+#endif /* MACTRACE_ENABLED */
@@ -0,0 +1,325 @@
+/******************************************************************************
+
+ @file  mactrace.h
+
+ @brief MAC callback trace: records the ApiMac callbacks delivered to the
+        application and replays them on a host.
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+#ifndef MACTRACE_H
+#define MACTRACE_H
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#if defined(MACTRACE_HOST)
+#include <stdio.h>
+#endif
+
+#include "api_mac.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*!
+ \defgroup Mactrace MAC Callback Trace
+ <BR>
+ ApiMac_registerCallbacks() hands the application's callback table to
+ Mactrace_wrapCallbacks(), which returns a table of shims. Each shim writes
+ a record of the callback and its parameters, then calls the application.
+ <BR>
+ A record is the callback type, the length of the parameters and the time
+ since the previous record in milliseconds, both as 7 bit varints (low
+ group first, the top bit set on all groups but the last), then the
+ parameters. Parameters are written field by field, little endian, enums
+ and booleans as one byte, addresses as the mode followed by 2 or 8 bytes.
+ Buffers the parameters point to follow their length field, so records
+ don't depend on the word size or structure layout of the image that wrote
+ them.
+ <BR>
+ On target the records are kept in a RAM ring, Mactrace_read() drains
+ whole records from it. The co-processor sends them to the host with the
+ MT UTIL MAC Trace command, the other images are read with the debugger.
+ Records that don't fit are dropped and a Mactrace_type_lost record with
+ the count is written once there is room again.
+ <BR>
+ A build with MACTRACE_HOST set writes the records to Mactrace_pFile and
+ runs on a virtual clock in milliseconds. Mactrace_replay() reads a trace
+ back into an application's callback table, advancing the virtual clock to
+ the time of each record first. The host branch of timer.c runs its timers
+ on that clock, so the Csf and Ssf timers expire in between the callbacks
+ as they did on target. Mactrace_malloc() and Mactrace_free() account the
+ heap the application uses, for Csf_malloc() and Ssf_malloc() to call.
+ <BR>
+ The trace is built with MACTRACE_ENABLED set to 1. Otherwise
+ Mactrace_wrapCallbacks() returns the application's table unchanged.
+ <BR>
+ */
+
+/*!
+ * \ingroup Mactrace
+ * @{
+ */
+
+/******************************************************************************
+ Constants and definitions
+ *****************************************************************************/
+
+/*! Set to 1 to build the trace */
+#if !defined(MACTRACE_ENABLED)
+#define MACTRACE_ENABLED        0
+#endif
+
+/*! Size of the RAM ring on target */
+#if !defined(MACTRACE_RING_SIZE)
+#define MACTRACE_RING_SIZE      1024
+#endif
+
+/*! Longest record parameters, longer records are dropped */
+#if !defined(MACTRACE_RECORD_MAX)
+#define MACTRACE_RECORD_MAX     320
+#endif
+
+/*! Longest record header: type, 2 byte length and 5 byte time varints */
+#define MACTRACE_HDR_MAX        8
+
+/*! Record types */
+typedef enum
+{
+    /*! pAssocIndCb */
+    Mactrace_type_assocInd = 0,
+    /*! pAssocCnfCb */
+    Mactrace_type_assocCnf = 1,
+    /*! pDisassociateIndCb */
+    Mactrace_type_disassocInd = 2,
+    /*! pDisassociateCnfCb */
+    Mactrace_type_disassocCnf = 3,
+    /*! pBeaconNotifyIndCb */
+    Mactrace_type_beaconNotifyInd = 4,
+    /*! pOrphanIndCb */
+    Mactrace_type_orphanInd = 5,
+    /*! pScanCnfCb */
+    Mactrace_type_scanCnf = 6,
+    /*! pStartCnfCb */
+    Mactrace_type_startCnf = 7,
+    /*! pSyncLossIndCb */
+    Mactrace_type_syncLossInd = 8,
+    /*! pPollCnfCb */
+    Mactrace_type_pollCnf = 9,
+    /*! pCommStatusCb */
+    Mactrace_type_commStatusInd = 10,
+    /*! pPollIndCb */
+    Mactrace_type_pollInd = 11,
+    /*! pDataCnfCb */
+    Mactrace_type_dataCnf = 12,
+    /*! pDataIndCb */
+    Mactrace_type_dataInd = 13,
+    /*! pPurgeCnfCb */
+    Mactrace_type_purgeCnf = 14,
+    /*! pWsAsyncIndCb */
+    Mactrace_type_wsAsyncInd = 15,
+    /*! pWsAsyncCnfCb */
+    Mactrace_type_wsAsyncCnf = 16,
+    /*! Records dropped before this one, a 2 byte count */
+    Mactrace_type_lost = 17,
+    /*! Number of record types */
+    Mactrace_type_max = 18
+} Mactrace_type_t;
+
+#if defined(MACTRACE_HOST)
+/*! Timer expiry function, see timer.h */
+typedef void (*Mactrace_timerFp_t)(uintptr_t arg);
+
+/*! Timer on the virtual clock, the host Clock_Struct of timer.h */
+typedef struct _mactrace_timer_t
+{
+    /*! Next active timer */
+    struct _mactrace_timer_t *pNext;
+    /*! Expiry function */
+    Mactrace_timerFp_t fxn;
+    /*! Argument of the expiry function */
+    uintptr_t arg;
+    /*! Timeout of the next start, in milliseconds */
+    uint32_t timeout;
+    /*! Period in milliseconds, 0 for a one-shot timer */
+    uint32_t period;
+    /*! Virtual time the timer expires */
+    uint32_t expiry;
+    /*! true while started */
+    bool active;
+} Mactrace_timer_t;
+
+/*! Replay parameters */
+typedef struct _mactrace_replayparams_t
+{
+    /*! Application callback table, as given to ApiMac_registerCallbacks() */
+    ApiMac_callbacks_t *pCallbacks;
+    /*!
+     Called after each callback and timer expiry to run the application's
+     events, as its task loop would. May be NULL.
+     */
+    void (*pProcessFp)(void);
+} Mactrace_replayParams_t;
+
+/*! Replay statistics of a callback type */
+typedef struct _mactrace_cbstats_t
+{
+    /*! Callbacks replayed */
+    uint32_t count;
+    /*! Sum of the times, in nanoseconds */
+    uint64_t sum;
+    /*! Longest time, in nanoseconds */
+    uint32_t max;
+} Mactrace_cbStats_t;
+
+/*! Replay statistics */
+typedef struct _mactrace_replaystats_t
+{
+    /*! Callbacks replayed */
+    uint32_t msgs;
+    /*! Records lost when the trace was written */
+    uint32_t lost;
+    /*! Timer expiries */
+    uint32_t timers;
+    /*! Virtual time covered by the trace, in milliseconds */
+    uint32_t virtualTime;
+    /*! Wall time of the replay, in nanoseconds */
+    uint64_t elapsed;
+    /*! Callbacks per second of wall time */
+    uint32_t msgsPerSec;
+    /*!
+     Time of each callback type, from the call to the return of the
+     processing that followed, indexed by Mactrace_type_t
+     */
+    Mactrace_cbStats_t cb[Mactrace_type_max];
+    /*! Most heap in use during the replay, in bytes */
+    uint32_t heapHighWater;
+    /*! Heap in use when the replay ended, in bytes */
+    uint32_t heapInUse;
+} Mactrace_replayStats_t;
+#endif /* MACTRACE_HOST */
+
+/******************************************************************************
+ Global Variables
+ *****************************************************************************/
+
+#if MACTRACE_ENABLED && defined(MACTRACE_HOST)
+/*! File the records are written to, NULL to not write them */
+extern FILE *Mactrace_pFile;
+#endif
+
+/******************************************************************************
+ Function Prototypes
+ *****************************************************************************/
+
+#if MACTRACE_ENABLED
+/*!
+ * @brief       Wrap the application's callback table. Callbacks the
+ *              application has are replaced by shims that record them and
+ *              call the application's, through its table.
+ *
+ * @param       pCallbacks - application callback table
+ *
+ * @return      table to dispatch the callbacks with
+ */
+extern ApiMac_callbacks_t *Mactrace_wrapCallbacks(
+                ApiMac_callbacks_t *pCallbacks);
+
+/*!
+ * @brief       Read whole records from the RAM ring. Always returns 0 in
+ *              host builds.
+ *
+ * @param       pBuf - buffer for the records
+ * @param       maxLen - size of the buffer
+ *
+ * @return      number of bytes read
+ */
+extern uint16_t Mactrace_read(uint8_t *pBuf, uint16_t maxLen);
+
+#if defined(MACTRACE_HOST)
+/*!
+ * @brief       Read the virtual clock.
+ *
+ * @return      virtual time, in milliseconds
+ */
+extern uint32_t Mactrace_now(void);
+
+/*!
+ * @brief       Advance the virtual clock, expiring the timers due in order
+ *              of their expiry. Host models of the MAC call it to move time
+ *              between the callbacks they make.
+ *
+ * @param       time - virtual time to advance to, in milliseconds
+ * @param       pProcessFp - called after each expiry to run the
+ *                           application's events, may be NULL
+ *
+ * @return      number of timers expired
+ */
+extern uint32_t Mactrace_advance(uint32_t time, void (*pProcessFp)(void));
+
+/*!
+ * @brief       Start a timer on the virtual clock.
+ *
+ * @param       pTimer - timer
+ * @param       timeout - time to expiry, in milliseconds
+ */
+extern void Mactrace_timerStart(Mactrace_timer_t *pTimer, uint32_t timeout);
+
+/*!
+ * @brief       Stop a timer.
+ *
+ * @param       pTimer - timer
+ */
+extern void Mactrace_timerStop(Mactrace_timer_t *pTimer);
+
+/*!
+ * @brief       Allocate from the accounted heap.
+ *
+ * @param       size - number of bytes
+ *
+ * @return      pointer to the memory, NULL if none
+ */
+extern void *Mactrace_malloc(uint32_t size);
+
+/*!
+ * @brief       Free memory from Mactrace_malloc().
+ *
+ * @param       pMem - memory, may be NULL
+ */
+extern void Mactrace_free(void *pMem);
+
+/*!
+ * @brief       Replay a trace into an application at full speed. Before
+ *              each record the virtual clock is advanced to its time,
+ *              expiring the timers due in order.
+ *
+ * @param       pFile - trace
+ * @param       pParams - replay parameters
+ * @param       pStats - replay statistics
+ *
+ * @return      true if the whole trace was replayed, false if a record
+ *              was malformed
+ */
+extern bool Mactrace_replay(FILE *pFile, Mactrace_replayParams_t *pParams,
+                            Mactrace_replayStats_t *pStats);
+#endif /* MACTRACE_HOST */
+#else
+#define Mactrace_wrapCallbacks(pCallbacks) (pCallbacks)
+#endif
+
+/*! @} end group Mactrace */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MACTRACE_H */
@@ -0,0 +1,217 @@
+/******************************************************************************
+
+ @file  probe.c
+
+ @brief Cycle count probes timing the hot paths of the application and
+        stack images.
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+
+#include <string.h>
+
+#include "probe.h"
+
+#if PROBE_ENABLED
+
+#if defined(PROBE_HOST)
+#include <time.h>
+#else
+#include <inc/hw_types.h>
+#include <inc/hw_memmap.h>
+#include <inc/hw_cpu_dwt.h>
+#include <inc/hw_cpu_scs.h>
+#include <driverlib/cpu.h>
+#endif
+
+/******************************************************************************
+ Constants and definitions
+ *****************************************************************************/
+
+#if defined(PROBE_HOST)
+/*! Host builds time one thread, nothing to lock */
+#define PROBE_LOCK(key)         ((void)(key))
+#define PROBE_UNLOCK(key)       ((void)(key))
+#else
+/*!
+ Probes run in tasks, Swis and Hwis of both images, lock with PRIMASK
+ rather than with a kernel call
+ */
+#define PROBE_LOCK(key)         ((key) = CPUcpsid())
+#define PROBE_UNLOCK(key)       do { if((key) == 0) { CPUcpsie(); } } while(0)
+#endif
+
+/******************************************************************************
+ Local variables
+ *****************************************************************************/
+
+/*! Probe statistics */
+static Probe_stats_t probeStats[Probe_id_max];
+
+/******************************************************************************
+ Local function prototypes
+ *****************************************************************************/
+static uint8_t findBin(uint32_t ticks);
+static void clearStats(Probe_stats_t *pStats);
+
+/******************************************************************************
+ Public Functions
+ *****************************************************************************/
+
+/*!
+ Start the cycle counter and clear the statistics.
+
+ Public function defined in probe.h
+ */
+void Probe_init(void)
+{
+    uint8_t i;
+
+#if !defined(PROBE_HOST)
+    /* The DWT is powered by the trace enable, then the counter is started */
+    HWREG(CPU_SCS_BASE + CPU_SCS_O_DEMCR) |= CPU_SCS_DEMCR_TRCENA;
+    HWREG(CPU_DWT_BASE + CPU_DWT_O_CYCCNT) = 0;
+    HWREG(CPU_DWT_BASE + CPU_DWT_O_CTRL) |= CPU_DWT_CTRL_CYCCNTENA;
+#endif
+
+    for(i = 0; i < Probe_id_max; i++)
+    {
+        clearStats(&probeStats[i]);
+    }
+}
+
+/*!
+ Read the time.
+
+ Public function defined in probe.h
+ */
+uint32_t Probe_now(void)
+{
+#if defined(PROBE_HOST)
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((uint32_t)((uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec));
+#else
+    return (HWREG(CPU_DWT_BASE + CPU_DWT_O_CYCCNT));
+#endif
+}
+
+/*!
+ Count a time.
+
+ Public function defined in probe.h
+ */
+void Probe_record(Probe_id_t id, uint32_t ticks)
+{
+    Probe_stats_t *pStats;
+    uint8_t bin;
+    uint32_t key;
+
+    if((uint8_t)id >= Probe_id_max)
+    {
+        return;
+    }
+
+    pStats = &probeStats[id];
+    bin = findBin(ticks);
+
+    PROBE_LOCK(key);
+
+    /* Zeroed statistics are valid, the stack image never calls init */
+    if((pStats->count == 0) || (ticks < pStats->min))
+    {
+        pStats->min = ticks;
+    }
+    pStats->count++;
+    pStats->sum += ticks;
+    if(ticks > pStats->max)
+    {
+        pStats->max = ticks;
+    }
+    if(pStats->hist[bin] < 0xFFFF)
+    {
+        pStats->hist[bin]++;
+    }
+
+    PROBE_UNLOCK(key);
+}
+
+/*!
+ Read the statistics of a probe.
+
+ Public function defined in probe.h
+ */
+void Probe_read(Probe_id_t id, Probe_stats_t *pStats, bool reset)
+{
+    uint32_t key;
+
+    if((uint8_t)id >= Probe_id_max)
+    {
+        clearStats(pStats);
+        return;
+    }
+
+    PROBE_LOCK(key);
+
+    memcpy(pStats, &probeStats[id], sizeof(Probe_stats_t));
+    if(reset == true)
+    {
+        clearStats(&probeStats[id]);
+    }
+
+    PROBE_UNLOCK(key);
+}
+
+/******************************************************************************
+ Local Functions
+ *****************************************************************************/
+
+/*!
+ * @brief       Find the histogram bin of a time.
+ *
+ * @param       ticks - time
+ *
+ * @return      bin, the log2 of the time
+ */
+static uint8_t findBin(uint32_t ticks)
+{
+    uint8_t bin;
+
+    if(ticks == 0)
+    {
+        return (0);
+    }
+
+#if defined(__TI_COMPILER_VERSION__)
+    bin = (uint8_t)(31 - __clz(ticks));
+#elif defined(__GNUC__)
+    bin = (uint8_t)(31 - __builtin_clz(ticks));
+#else
+    for(bin = 0; ticks > 1; bin++)
+    {
+        ticks >>= 1;
+    }
+#endif
+
+    return ((bin < PROBE_HIST_BINS) ? bin : (PROBE_HIST_BINS - 1));
+}
+
+/*!
+ * @brief       Clear probe statistics.
+ *
+ * @param       pStats - statistics
+ */
+static void clearStats(Probe_stats_t *pStats)
+{
+    memset(pStats, 0, sizeof(Probe_stats_t));
+}
+
+#endif /* PROBE_ENABLED */
@@ -0,0 +1,168 @@
+/******************************************************************************
+
+ @file  probe.h
+
+ @brief Cycle count probes timing the hot paths of the application and
+        stack images.
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+#ifndef PROBE_H
+#define PROBE_H
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*!
+ \defgroup Probe Cycle Count Probes
+ <BR>
+ A probe times a section of code between PROBE_BEGIN() and PROBE_END(),
+ and keeps the count, minimum, maximum and sum of the times and a log2
+ histogram of them in RAM. On target the time is read from the Cortex-M3
+ DWT cycle counter, which only counts while the CPU runs: time spent in
+ standby isn't counted. A build with PROBE_HOST set reads
+ clock_gettime() and counts nanoseconds.
+ <BR>
+ The start time is kept in a local variable, so a probe may be entered by
+ several tasks at once and probes may nest. PROBE_BEGIN() declares that
+ variable and goes last in a declaration list; PROBE_END() goes before
+ every return that is to be counted.
+ <BR>
+ Probes are built with PROBE_ENABLED set to 1. Otherwise the macros, and
+ Probe_init(), compile to nothing. Each image has its own statistics:
+ the co-processor reports its own with the MT UTIL Probe Statistics
+ command, the other images are read with the debugger.
+ <BR>
+ */
+
+/*!
+ * \ingroup Probe
+ * @{
+ */
+
+/******************************************************************************
+ Constants and definitions
+ *****************************************************************************/
+
+/*! Set to 1 to build the probes */
+#if !defined(PROBE_ENABLED)
+#define PROBE_ENABLED           0
+#endif
+
+/*! Time units per second: CPU cycles on target, nanoseconds on host */
+#if defined(PROBE_HOST)
+#define PROBE_TICK_HZ           1000000000
+#elif !defined(PROBE_TICK_HZ)
+#define PROBE_TICK_HZ           48000000
+#endif
+
+/*!
+ Number of histogram bins. Bin n counts times from 2^n to 2^(n+1) - 1, the
+ last bin counts everything longer.
+ */
+#define PROBE_HIST_BINS         24
+
+/*! Probes */
+typedef enum
+{
+    /*! ApiMac_processIncoming(), after the wait */
+    Probe_id_macIncoming = 0,
+    /*! Collector processSensorData() */
+    Probe_id_sensorData = 1,
+    /*! NPIFrame_collectFrameData() */
+    Probe_id_npiRxFrame = 2,
+    /*! NPITask_ProcessTXQ() */
+    Probe_id_npiTxQueue = 3,
+    /*! NVOCTP_findItem() */
+    Probe_id_nvFindItem = 4,
+    /*! NVOCTP_compactPage() */
+    Probe_id_nvCompactPage = 5,
+    /*! osalTimerUpdate(), in the stack image */
+    Probe_id_osalTimerUpdate = 6,
+    /*! ICall_primWaitMatch(), including the wait for the reply */
+    Probe_id_icallWaitMatch = 7,
+    /*! Number of probes */
+    Probe_id_max = 8
+} Probe_id_t;
+
+/*! Probe statistics */
+typedef struct _probe_stats_t
+{
+    /*! Times counted */
+    uint32_t count;
+    /*! Shortest time */
+    uint32_t min;
+    /*! Longest time */
+    uint32_t max;
+    /*! Sum of the times */
+    uint64_t sum;
+    /*! Log2 histogram of the times, each bin stops at 0xFFFF */
+    uint16_t hist[PROBE_HIST_BINS];
+} Probe_stats_t;
+
+#if PROBE_ENABLED
+/*! Declare the start time of a probe, last in a declaration list */
+#define PROBE_BEGIN(start) uint32_t start = Probe_now()
+/*! Count the time since PROBE_BEGIN(start) */
+#define PROBE_END(id, start) Probe_record((id), Probe_now() - (start))
+#else
+#define PROBE_BEGIN(start)
+#define PROBE_END(id, start)
+#endif
+
+/******************************************************************************
+ Function Prototypes
+ *****************************************************************************/
+
+#if PROBE_ENABLED
+/*!
+ * @brief       Start the cycle counter and clear the statistics. Called
+ *              once, by the application image.
+ */
+extern void Probe_init(void);
+
+/*!
+ * @brief       Read the time.
+ *
+ * @return      time, in units of 1 / PROBE_TICK_HZ seconds
+ */
+extern uint32_t Probe_now(void);
+
+/*!
+ * @brief       Count a time.
+ *
+ * @param       id - probe
+ * @param       ticks - time, in units of 1 / PROBE_TICK_HZ seconds
+ */
+extern void Probe_record(Probe_id_t id, uint32_t ticks);
+
+/*!
+ * @brief       Read the statistics of a probe.
+ *
+ * @param       id - probe
+ * @param       pStats - copy of the statistics
+ * @param       reset - true to clear the statistics once read
+ */
+extern void Probe_read(Probe_id_t id, Probe_stats_t *pStats, bool reset);
+#else
+#define Probe_init()
+#endif
+
+/*! @} end group Probe */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PROBE_H */
@@ -0,0 +1,352 @@
+/******************************************************************************
+
+ @file  pwracct.c
+
+ @brief Power accounting: time each task runs, time spent in each sleep mode
+        and what woke the device, for power profiling.
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+
+#include <stddef.h>
+#include <string.h>
+
+#include "pwracct.h"
+
+#if PWRACCT_ENABLED
+
+#if !defined(PWRACCT_HOST)
+#include <ti/drivers/Power.h>
+#include <ti/drivers/power/PowerCC26XX.h>
+#include <inc/hw_ints.h>
+#include <aon_rtc.h>
+#include <cpu.h>
+#include <interrupt.h>
+#endif
+
+/******************************************************************************
+ Constants and definitions
+ *****************************************************************************/
+
+/*! Number of tasks that can be tagged */
+#define PWRACCT_MAX_TAGS        6
+
+#if defined(PWRACCT_HOST)
+/*! Host builds run one thread, nothing to lock */
+#define PWRACCT_LOCK(key)       ((void)(key))
+#define PWRACCT_UNLOCK(key)     ((void)(key))
+#else
+/*! The switch hook runs in the kernel, lock with PRIMASK */
+#define PWRACCT_LOCK(key)       ((key) = CPUcpsid())
+#define PWRACCT_UNLOCK(key)     do { if((key) == 0) { CPUcpsie(); } } while(0)
+#endif
+
+/*! Task tag */
+typedef struct
+{
+    /*! Task handle, NULL if unused */
+    Pwracct_taskHandle_t task;
+    /*! Class of the task */
+    Pwracct_task_t taskClass;
+} tag_t;
+
+/******************************************************************************
+ Global variables
+ *****************************************************************************/
+
+#if defined(PWRACCT_HOST)
+/* Simulated clock of host builds */
+uint32_t Pwracct_simClock = 0;
+#endif
+
+/******************************************************************************
+ Local variables
+ *****************************************************************************/
+
+/*! Task tags */
+static tag_t tags[PWRACCT_MAX_TAGS];
+
+/*! Statistics, the idle time is found when read */
+static Pwracct_stats_t stats;
+
+/*! Time the statistics were cleared */
+static uint32_t resetTime;
+/*! Time of the last task switch */
+static uint32_t switchTime;
+/*! Class of the running task */
+static Pwracct_task_t runningClass = Pwracct_task_other;
+/*! Time standby started */
+static uint32_t standbyStart;
+
+#if !defined(PWRACCT_HOST)
+/*! Standby notification */
+static Power_NotifyObj standbyNotifyObj;
+#endif
+
+/******************************************************************************
+ Local function prototypes
+ *****************************************************************************/
+static uint32_t readClock(void);
+static Pwracct_task_t findClass(Pwracct_taskHandle_t task);
+static void clearStats(uint32_t now);
+#if !defined(PWRACCT_HOST)
+static int standbyNotify(unsigned int eventType, uintptr_t eventArg,
+                         uintptr_t clientArg);
+static Pwracct_wake_t findWakeCause(void);
+#endif
+
+/******************************************************************************
+ Public Functions
+ *****************************************************************************/
+
+/*!
+ Clear the statistics, tag the idle task and register for the standby
+ notifications.
+
+ Public function defined in pwracct.h
+ */
+void Pwracct_init(void)
+{
+    uint32_t now = readClock();
+
+    /* Tasks created before init keep their tags */
+    clearStats(now);
+    switchTime = now;
+    runningClass = Pwracct_task_other;
+
+#if !defined(PWRACCT_HOST)
+    Pwracct_setTask(Task_getIdleTask(), Pwracct_task_idle);
+
+    Power_registerNotify(&standbyNotifyObj,
+                         (PowerCC26XX_ENTERING_STANDBY
+                          | PowerCC26XX_AWAKE_STANDBY),
+                         standbyNotify, 0);
+#endif
+}
+
+/*!
+ Tag a task with its class.
+
+ Public function defined in pwracct.h
+ */
+void Pwracct_setTask(Pwracct_taskHandle_t task, Pwracct_task_t taskClass)
+{
+    uint8_t i;
+
+    for(i = 0; i < PWRACCT_MAX_TAGS; i++)
+    {
+        if((tags[i].task == NULL) || (tags[i].task == task))
+        {
+            tags[i].taskClass = taskClass;
+            tags[i].task = task;
+            break;
+        }
+    }
+}
+
+/*!
+ Task switch hook.
+
+ Public function defined in pwracct.h
+ */
+void Pwracct_taskSwitch(Pwracct_taskHandle_t prev, Pwracct_taskHandle_t next)
+{
+    Pwracct_task_t nextClass = findClass(next);
+    uint32_t now;
+    uint32_t key;
+
+    PWRACCT_LOCK(key);
+
+    now = readClock();
+
+    /* Time in main() before the first switch isn't charged */
+    if(prev != NULL)
+    {
+        stats.taskTime[runningClass] += now - switchTime;
+    }
+    switchTime = now;
+    runningClass = nextClass;
+
+    PWRACCT_UNLOCK(key);
+}
+
+/*!
+ Mark the start of standby.
+
+ Public function defined in pwracct.h
+ */
+void Pwracct_standbyEnter(void)
+{
+    standbyStart = readClock();
+}
+
+/*!
+ Mark the end of standby.
+
+ Public function defined in pwracct.h
+ */
+void Pwracct_standbyExit(Pwracct_wake_t cause)
+{
+    stats.standbyTime += readClock() - standbyStart;
+
+    if(((uint8_t)cause < Pwracct_wake_max) && (stats.wakeups[cause] < 0xFFFF))
+    {
+        stats.wakeups[cause]++;
+    }
+}
+
+/*!
+ Read the statistics.
+
+ Public function defined in pwracct.h
+ */
+void Pwracct_read(Pwracct_stats_t *pStats, bool reset)
+{
+    uint32_t now;
+    uint32_t key;
+
+    PWRACCT_LOCK(key);
+
+    now = readClock();
+
+    stats.taskTime[runningClass] += now - switchTime;
+    switchTime = now;
+    stats.elapsed = now - resetTime;
+
+    /* Standby is charged to the idle task when it switches out */
+    if(stats.taskTime[Pwracct_task_idle] > stats.standbyTime)
+    {
+        stats.idleTime = stats.taskTime[Pwracct_task_idle]
+                        - stats.standbyTime;
+    }
+    else
+    {
+        stats.idleTime = 0;
+    }
+
+    memcpy(pStats, &stats, sizeof(Pwracct_stats_t));
+
+    if(reset == true)
+    {
+        clearStats(now);
+    }
+
+    PWRACCT_UNLOCK(key);
+}
+
+/******************************************************************************
+ Local Functions
+ *****************************************************************************/
+
+/*!
+ * @brief       Read the time.
+ *
+ * @return      time, in units of 1 / PWRACCT_TICK_HZ seconds
+ */
+static uint32_t readClock(void)
+{
+#if defined(PWRACCT_HOST)
+    return (Pwracct_simClock);
+#else
+    return (AONRTCCurrentCompareValueGet());
+#endif
+}
+
+/*!
+ * @brief       Find the class of a task.
+ *
+ * @param       task - task handle
+ *
+ * @return      class of the task, Pwracct_task_other if not tagged
+ */
+static Pwracct_task_t findClass(Pwracct_taskHandle_t task)
+{
+    uint8_t i;
+
+    for(i = 0; (i < PWRACCT_MAX_TAGS) && (tags[i].task != NULL); i++)
+    {
+        if(tags[i].task == task)
+        {
+            return (tags[i].taskClass);
+        }
+    }
+
+    return (Pwracct_task_other);
+}
+
+/*!
+ * @brief       Clear the statistics.
+ *
+ * @param       now - time they are cleared
+ */
+static void clearStats(uint32_t now)
+{
+    memset(&stats, 0, sizeof(Pwracct_stats_t));
+    resetTime = now;
+}
+
+#if !defined(PWRACCT_HOST)
+/*!
+ * @brief       Power notification, called by the standby policy with
+ *              interrupts disabled.
+ *
+ * @param       eventType - PowerCC26XX_ENTERING_STANDBY or
+ *                          PowerCC26XX_AWAKE_STANDBY
+ * @param       eventArg - not used
+ * @param       clientArg - not used
+ *
+ * @return      Power_NOTIFYDONE
+ */
+static int standbyNotify(unsigned int eventType, uintptr_t eventArg,
+                         uintptr_t clientArg)
+{
+    if(eventType == PowerCC26XX_ENTERING_STANDBY)
+    {
+        Pwracct_standbyEnter();
+    }
+    else
+    {
+        Pwracct_standbyExit(findWakeCause());
+    }
+
+    return (Power_NOTIFYDONE);
+}
+
+/*!
+ * @brief       Find what woke the device. The interrupt that did is still
+ *              pending, the policy hasn't enabled interrupts yet. The RTC
+ *              is checked last, it may be pending with another source.
+ *
+ * @return      wakeup cause
+ */
+static Pwracct_wake_t findWakeCause(void)
+{
+    if(IntPendGet(INT_RFC_CPE_0) || IntPendGet(INT_RFC_CPE_1)
+       || IntPendGet(INT_RFC_HW_COMB) || IntPendGet(INT_RFC_CMD_ACK))
+    {
+        return (Pwracct_wake_radio);
+    }
+    if(IntPendGet(INT_UART0_COMB))
+    {
+        return (Pwracct_wake_uart);
+    }
+    if(IntPendGet(INT_AON_GPIO_EDGE))
+    {
+        return (Pwracct_wake_pin);
+    }
+    if(IntPendGet(INT_AON_RTC_COMB))
+    {
+        return (Pwracct_wake_timer);
+    }
+
+    return (Pwracct_wake_other);
+}
+#endif /* !PWRACCT_HOST */
+
+#endif /* PWRACCT_ENABLED */
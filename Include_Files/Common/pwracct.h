@@ -0,0 +1,205 @@
+/******************************************************************************
+
+ @file  pwracct.h
+
+ @brief Power accounting: time each task runs, time spent in each sleep mode
+        and what woke the device, for power profiling.
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+#ifndef PWRACCT_H
+#define PWRACCT_H
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#if !defined(PWRACCT_HOST)
+#include <ti/sysbios/knl/Task.h>
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*!
+ \defgroup Pwracct Power Accounting
+ <BR>
+ Every task switch charges the time since the previous switch to the task
+ that was running, Hwis and Swis included. Tasks are charged by class: the
+ application tags its task, the NPI task and the MAC stack task with
+ Pwracct_setTask(), the idle task is tagged by Pwracct_init() and any other
+ task is charged as Pwracct_task_other.
+ <BR>
+ The power policy runs in the idle task. Standby entry and exit are caught
+ with a Power notification, which counts the time in standby, the wakeups
+ and their cause, read from the interrupt pending when the device wakes.
+ The rest of the idle task time is the CPU idling, clock gated, between
+ interrupts.
+ <BR>
+ Time is read from the AON RTC, which keeps running in standby, in units of
+ 1 / PWRACCT_TICK_HZ seconds. The sums are 32 bits and wrap after 18 hours,
+ read them with a reset more often than that. A build with PWRACCT_HOST set
+ reads Pwracct_simClock instead, and has the tests call Pwracct_taskSwitch(),
+ Pwracct_standbyEnter() and Pwracct_standbyExit() in place of the kernel.
+ <BR>
+ Accounting is built with PWRACCT_ENABLED set to 1, with the configuration
+ built with PWR_ACCT=1 so that app.cfg adds the task switch hook. Otherwise
+ Pwracct_init() and Pwracct_setTask() compile to nothing.
+ <BR>
+ */
+
+/*!
+ * \ingroup Pwracct
+ * @{
+ */
+
+/******************************************************************************
+ Constants and definitions
+ *****************************************************************************/
+
+/*! Set to 1 to build the power accounting */
+#if !defined(PWRACCT_ENABLED)
+#define PWRACCT_ENABLED         0
+#endif
+
+/*! Time units per second: the RTC counts seconds in 16.16 fixed point */
+#define PWRACCT_TICK_HZ         65536
+
+/*! Task classes */
+typedef enum
+{
+    /*! MAC stack task */
+    Pwracct_task_stack = 0,
+    /*! Application task: collector, sensor or co-processor */
+    Pwracct_task_app = 1,
+    /*! NPI task */
+    Pwracct_task_npi = 2,
+    /*! Idle task, including sleep */
+    Pwracct_task_idle = 3,
+    /*! Any other task */
+    Pwracct_task_other = 4,
+    /*! Number of task classes */
+    Pwracct_task_max = 5
+} Pwracct_task_t;
+
+/*! Wakeup causes */
+typedef enum
+{
+    /*! RTC: a clock or a MAC timer */
+    Pwracct_wake_timer = 0,
+    /*! RF core */
+    Pwracct_wake_radio = 1,
+    /*! UART */
+    Pwracct_wake_uart = 2,
+    /*! Pin edge: a key, or the NPI handshake */
+    Pwracct_wake_pin = 3,
+    /*! No interrupt recognized */
+    Pwracct_wake_other = 4,
+    /*! Number of wakeup causes */
+    Pwracct_wake_max = 5
+} Pwracct_wake_t;
+
+/*! Power accounting statistics */
+typedef struct _pwracct_stats_t
+{
+    /*! Time since the statistics were cleared */
+    uint32_t elapsed;
+    /*! Time each task class ran, indexed by Pwracct_task_t */
+    uint32_t taskTime[Pwracct_task_max];
+    /*! Time in standby */
+    uint32_t standbyTime;
+    /*! Time in the idle task outside of standby */
+    uint32_t idleTime;
+    /*! Wakeups from standby, indexed by Pwracct_wake_t */
+    uint16_t wakeups[Pwracct_wake_max];
+} Pwracct_stats_t;
+
+#if defined(PWRACCT_HOST)
+/*! Task handle, any value identifies a task */
+typedef void *Pwracct_taskHandle_t;
+#else
+/*! Task handle */
+typedef Task_Handle Pwracct_taskHandle_t;
+#endif
+
+/******************************************************************************
+ Global Variables
+ *****************************************************************************/
+
+#if PWRACCT_ENABLED && defined(PWRACCT_HOST)
+/*! Simulated clock of host builds, set by the test */
+extern uint32_t Pwracct_simClock;
+#endif
+
+/******************************************************************************
+ Function Prototypes
+ *****************************************************************************/
+
+#if PWRACCT_ENABLED
+/*!
+ * @brief       Clear the statistics, tag the idle task and register for
+ *              the standby notifications. Call from main() before
+ *              BIOS_start(). Host builds tag the idle task with
+ *              Pwracct_setTask().
+ */
+extern void Pwracct_init(void);
+
+/*!
+ * @brief       Tag a task with its class.
+ *
+ * @param       task - task handle
+ * @param       taskClass - class the task's time is charged to
+ */
+extern void Pwracct_setTask(Pwracct_taskHandle_t task,
+                            Pwracct_task_t taskClass);
+
+/*!
+ * @brief       Task switch hook, added by app.cfg. Charges the time since
+ *              the last switch to the previous task.
+ *
+ * @param       prev - task switched out, NULL before the first switch
+ * @param       next - task switched in
+ */
+extern void Pwracct_taskSwitch(Pwracct_taskHandle_t prev,
+                               Pwracct_taskHandle_t next);
+
+/*!
+ * @brief       Mark the start of standby. Called from the Power
+ *              notification on target.
+ */
+extern void Pwracct_standbyEnter(void);
+
+/*!
+ * @brief       Mark the end of standby. Called from the Power notification
+ *              on target.
+ *
+ * @param       cause - what woke the device
+ */
+extern void Pwracct_standbyExit(Pwracct_wake_t cause);
+
+/*!
+ * @brief       Read the statistics, charging the running task up to now.
+ *
+ * @param       pStats - copy of the statistics
+ * @param       reset - true to clear the statistics once read
+ */
+extern void Pwracct_read(Pwracct_stats_t *pStats, bool reset);
+#else
+#define Pwracct_init()
+#define Pwracct_setTask(task, taskClass)
+#endif
+
+/*! @} end group Pwracct */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PWRACCT_H */
@@ -6,6 +6,7 @@
 //
 ////////////////////////////////////////// Include Files /////////////////////////////////////////////
 #include "uart_debug.h"
+#include <string.h>
 
 UART_Handle 	uart;
 
@@ -20,8 +21,177 @@ UART_Handle 	uart;
 ///////////////////////////////////// Function Prototypes ////////////////////////////////////////////
 
 ///////////////////////////////////// Variable Definitions ///////////////////////////////////////////
+#if (DEBUG_LOG_TOKENIZED > 0)
+// Single producer, single consumer ring without a lock: tasks write records
+// and publish them by moving the head, the UART write callback sends them and
+// moves the tail. Hwis and Swis are never held off by logging.
+static volatile uint8_t		logRing[DEBUG_LOG_RING_SIZE];
+static volatile uint16_t	logHead;		// free running, moved by the producer once a record is copied
+static volatile uint16_t	logTail;		// free running, moved by the UART write callback
+static volatile uint16_t	logSending;		// bytes given to UART_write, 0 when the UART is idle
+static uint32_t				logDropped;		// records lost since the last drop record
+static uint32_t				logDroppedTotal;
+static uint32_t				logDroppedIsr;	// records from Hwis and Swis, never written
+#endif
 
 ///////////////////////////////////// Function Implements ////////////////////////////////////////////
+#if defined(UART_DEBUG) && (DEBUG_LOG_TOKENIZED > 0)
+// ---------------------------------------------------------------------------------------------------
+//	Brief	: 	Store a 32 bit value little endian
+//
+// 	Param	: 	Destination, value
+//  Return	: 	void.
+// 	Note	:
+// ---------------------------------------------------------------------------------------------------
+static void logPut32(uint8_t *dst, uint32_t value)
+{
+	dst[0] = (uint8_t)value;
+	dst[1] = (uint8_t)(value >> 8);
+	dst[2] = (uint8_t)(value >> 16);
+	dst[3] = (uint8_t)(value >> 24);
+}
+
+// ---------------------------------------------------------------------------------------------------
+//	Brief	: 	Fill the header of a token record
+//
+// 	Param	: 	Record, format string (NULL for a drop record), record length
+//  Return	: 	void.
+// 	Note	:
+// ---------------------------------------------------------------------------------------------------
+static void logHeader(uint8_t *rec, const char *format, uint8_t len)
+{
+	rec[0] = DEBUG_LOG_SYNC;
+	rec[1] = len - 2;
+	logPut32(&rec[2], (uint32_t)format);
+	logPut32(&rec[6], Clock_getTicks());
+}
+
+// ---------------------------------------------------------------------------------------------------
+//	Brief	: 	Free bytes of the ring
+//
+// 	Param	: 	void.
+//  Return	: 	Bytes that can be written
+// 	Note	:	The tail only moves forward, a stale tail under estimates the free space
+// ---------------------------------------------------------------------------------------------------
+static uint16_t logFree(void)
+{
+	return (uint16_t)(DEBUG_LOG_RING_SIZE - (uint16_t)(logHead - logTail));
+}
+
+// ---------------------------------------------------------------------------------------------------
+//	Brief	: 	Copy bytes at the head of the ring and publish them
+//
+// 	Param	: 	Data, length
+//  Return	: 	void.
+// 	Note	:	Called by the producer, the caller has checked the free space. The ring is
+//				volatile so every byte is stored before the head is moved.
+// ---------------------------------------------------------------------------------------------------
+static void logCopy(const uint8_t *data, uint16_t len)
+{
+	uint16_t head = logHead;
+	uint16_t i;
+
+	for (i = 0; i < len; i++)
+		logRing[(uint16_t)(head + i) & (DEBUG_LOG_RING_SIZE - 1)] = data[i];
+
+	logHead = head + len;
+}
+
+// ---------------------------------------------------------------------------------------------------
+//	Brief	: 	Take the next contiguous block of the ring for the UART
+//
+// 	Param	: 	void.
+//  Return	: 	Bytes to write, 0 if the ring is empty
+// 	Note	:	Called by the write callback, or by the producer while the UART is idle
+// ---------------------------------------------------------------------------------------------------
+static uint16_t logNextBlock(void)
+{
+	uint16_t offset = logTail & (DEBUG_LOG_RING_SIZE - 1);
+	uint16_t len = logHead - logTail;
+
+	if (len > DEBUG_LOG_RING_SIZE - offset)
+		len = DEBUG_LOG_RING_SIZE - offset;
+
+	logSending = len;
+	return len;
+}
+
+// ---------------------------------------------------------------------------------------------------
+//	Brief	: 	UART write callback, release the written block and send the next one
+//
+// 	Param	: 	UART handle, written buffer, written count
+//  Return	: 	void.
+// 	Note	:	The only consumer. It runs to completion before the producer goes on, so the
+//				producer finds it either sent the new head or left the UART idle.
+// ---------------------------------------------------------------------------------------------------
+static void logWriteDone(UART_Handle handle, void *buf, size_t count)
+{
+	uint16_t len;
+
+	logTail += logSending;
+	len = logNextBlock();
+
+	if (len > 0)
+		UART_write(uart, (void *)&logRing[logTail & (DEBUG_LOG_RING_SIZE - 1)], len);
+}
+
+// ---------------------------------------------------------------------------------------------------
+//	Brief	: 	Add bytes to the ring and start the UART if it is idle
+//
+// 	Param	: 	Data, length
+//  Return	: 	void.
+// 	Note	:	Never blocks: when the ring is full the data is dropped and counted.
+//				Tasks are the producer, Task_disable() keeps two tasks from writing at once
+//				without holding off interrupts. Hwis and Swis could preempt a task in the
+//				middle of a record, their data is dropped and only counted.
+// ---------------------------------------------------------------------------------------------------
+static void logWrite(const uint8_t *data, uint16_t len)
+{
+	uint8_t dropRec[DEBUG_LOG_HEADER_LEN + 4];
+	uint16_t block = 0;
+	UInt key;
+
+	if (BIOS_getThreadType() != BIOS_ThreadType_Task)
+	{
+		key = Hwi_disable();
+		logDroppedIsr++;
+		Hwi_restore(key);
+		return;
+	}
+
+	key = Task_disable();
+
+	// Report lost records as soon as there is room again
+	if ((logDropped > 0) && (logFree() >= sizeof(dropRec) + len))
+	{
+		logHeader(dropRec, NULL, sizeof(dropRec));
+		logPut32(&dropRec[DEBUG_LOG_HEADER_LEN], logDropped);
+		logCopy(dropRec, sizeof(dropRec));
+		logDropped = 0;
+	}
+
+	if (logFree() < len)
+	{
+		logDropped++;
+		logDroppedTotal++;
+	}
+	else
+	{
+		logCopy(data, len);
+	}
+
+	// No write in flight, the callback can not run until this one is started
+	if (logSending == 0)
+		block = logNextBlock();
+
+	Task_restore(key);
+
+	// The tail can not move until this write completes
+	if (block > 0)
+		UART_write(uart, (void *)&logRing[logTail & (DEBUG_LOG_RING_SIZE - 1)], block);
+}
+#endif	// defined(UART_DEBUG) && (DEBUG_LOG_TOKENIZED > 0)
+
 
 // ---------------------------------------------------------------------------------------------------
 //	Brief	: 	Write a byte to UART port excluding RS485 controlling pins
@@ -32,7 +202,11 @@ UART_Handle 	uart;
 // ---------------------------------------------------------------------------------------------------
 inline void writechar(unsigned char c)
 {
+#if (DEBUG_LOG_TOKENIZED > 0)
+	logWrite(&c, 1);
+#else
 	UART_write(uart, &c, 1);
+#endif
 }
 
 // ---------------------------------------------------------------------------------------------------
@@ -267,22 +441,94 @@ int sprintf(char *out, const char *format, ...)
     return print( &out, format, args );
 }
 
-#endif	// (DEBUG_EN > 0)
+#endif	// defined(UART_DEBUG)
 
 /*
  * @function: LREP
- * @Brief   : Format the string then write it directly to UART port.
+ * @Brief   : Record the format string and its arguments, or format the string
+ *            then write it directly to UART port when DEBUG_LOG_TOKENIZED is 0.
  * @param   : written formated string
  * @return  : void
  */
 void debug_print (const char *format,...)
 {
     va_list args;
+#if defined(UART_DEBUG) && (DEBUG_LOG_TOKENIZED > 0)
+    uint8_t rec[DEBUG_LOG_MAX_RECORD];
+    uint8_t len = DEBUG_LOG_HEADER_LEN;
+    const char *fmt;
+    const char *s;
+    uint8_t n;
+
+    va_start( args, format );
+
+    // Only the conversions are looked at, the text is expanded on the host
+    for (fmt = format; *fmt != 0; ++fmt)
+    {
+        if (*fmt != '%')
+            continue;
+        ++fmt;
+        if (*fmt == '\0')
+            break;
+        if (*fmt == '%')
+            continue;
+        while ((*fmt == '-') || (*fmt >= '0' && *fmt <= '9'))
+            ++fmt;
+
+        if (*fmt == 's')
+        {
+            if (len + 1 > DEBUG_LOG_MAX_RECORD)
+                break;
+            s = va_arg( args, const char * );
+            for (n = 0; s && s[n] && (n < DEBUG_LOG_MAX_STRING) &&
+                        (len + 1 + n < DEBUG_LOG_MAX_RECORD); n++)
+            {
+                rec[len + 1 + n] = s[n];
+            }
+            rec[len] = n;
+            len += 1 + n;
+        }
+        else if ((*fmt == 'd') || (*fmt == 'u') || (*fmt == 'x') || (*fmt == 'X'))
+        {
+            if (len + 4 > DEBUG_LOG_MAX_RECORD)
+                break;
+            logPut32(&rec[len], va_arg( args, PRINT_NUMBER_TYPE ));
+            len += 4;
+        }
+        else if (*fmt == 'c')
+        {
+            if (len + 4 > DEBUG_LOG_MAX_RECORD)
+                break;
+            logPut32(&rec[len], va_arg( args, int ));
+            len += 4;
+        }
+    }
+    va_end( args );
 
+    logHeader(rec, format, len);
+    logWrite(rec, len);
+#else
     va_start( args, format );
 #if defined(UART_DEBUG)
     print( 0, format, args );
 #endif
+#endif
+}
+
+/*
+ * @function: debugLogDropped
+ * @Brief   : number of records lost because the token ring was full, or
+ *            because they were made by a Hwi or a Swi.
+ * @param   : none
+ * @return  : dropped record count since start
+ */
+uint32_t debugLogDropped(void)
+{
+#if defined(UART_DEBUG) && (DEBUG_LOG_TOKENIZED > 0)
+    return logDroppedTotal + logDroppedIsr;
+#else
+    return 0;
+#endif
 }
 
 /*
@@ -294,7 +540,7 @@ void debug_print (const char *format,...)
 void initDebugPort(void)
 {
     UART_Params uartParams;
-    const char echoPrompt[] = "\fInit debug port success\r\n";
+    static const char echoPrompt[] = "\fInit debug port success\r\n";
 
     /* Create a UART with data processing off. */
     UART_Params_init(&uartParams);
@@ -303,12 +549,21 @@ void initDebugPort(void)
     uartParams.readReturnMode = UART_RETURN_FULL;
     uartParams.readEcho = UART_ECHO_OFF;
     uartParams.baudRate = 9600;
+#if defined(UART_DEBUG) && (DEBUG_LOG_TOKENIZED > 0)
+    /* Writes complete in background, the ring is drained from the callback. */
+    uartParams.writeMode = UART_MODE_CALLBACK;
+    uartParams.writeCallback = logWriteDone;
+#endif
     uart = UART_open(Board_UART0, &uartParams);
 
     if (uart == NULL) {
         System_abort("Error opening the UART");
     }
 
+#if defined(UART_DEBUG) && (DEBUG_LOG_TOKENIZED > 0)
+    debug_print(echoPrompt);
+#else
     UART_write(uart, echoPrompt, sizeof(echoPrompt));
+#endif
 }
 
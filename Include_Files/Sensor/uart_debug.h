@@ -16,11 +16,14 @@
 /* BIOS Header files */
 #include <ti/sysbios/BIOS.h>
 #include <ti/sysbios/knl/Task.h>
+#include <ti/sysbios/knl/Clock.h>
+#include <ti/sysbios/hal/Hwi.h>
 
 /* TI-RTOS Header files */
 #include <ti/drivers/PIN.h>
 #include <ti/drivers/UART.h>
 #include <stdarg.h>
+#include <stdint.h>
 #include "board.h"
 
 ///////////////////////////////////// Constant Definitions ///////////////////////////////////////////
@@ -33,6 +36,26 @@
 
 #define		PRINT_IMMEDIATE_PRINT		1	// 1: Write chars to UART port right in print instruction
 											// 0: Don't write char to UART port, get the string only
+
+#define		DEBUG_LOG_TOKENIZED			1	// 1: debug_print records a binary token in RAM, drained in background
+											// 0: debug_print formats the text and writes it right away (blocking)
+
+#define		DEBUG_LOG_RING_SIZE			512	// Bytes of the token ring, must be a power of two
+#define		DEBUG_LOG_MAX_RECORD		48	// Largest record, arguments that do not fit are left out
+#define		DEBUG_LOG_MAX_STRING		16	// Largest %s argument copied in a record
+
+// Token record, all fields little endian:
+//	[0]		DEBUG_LOG_SYNC
+//	[1]		length of the rest of the record
+//	[2..5]	address of the format string in the image, 0 for a drop record
+//	[6..9]	Clock ticks when the record was made
+//	[10..]	arguments in format order: %d %u %x %X %c as 4 bytes,
+//			%s as a length byte followed by the characters
+// Bytes written with writechar() are sent as they are between records.
+// Decode with uart_log_decode.py and the .out file of the same build.
+// Records are made by tasks, a debug_print() from a Hwi or a Swi is dropped and counted.
+#define		DEBUG_LOG_SYNC				0xA5
+#define		DEBUG_LOG_HEADER_LEN		10
 /////////////////////////////////////// Type Definitions /////////////////////////////////////////////
 
 ///////////////////////////// Macros (Inline Functions) Definitions //////////////////////////////////
@@ -63,6 +86,9 @@ int 		     	print(char **out, const char *format, va_list args );
 
 void                debug_print(const char *format,...);
 void                initDebugPort(void);
+uint32_t            debugLogDropped(void);
+
+#define             SOS_DEBUG                   debug_print
 
 ///////////////////////////////////// Variable Definitions ///////////////////////////////////////////
 
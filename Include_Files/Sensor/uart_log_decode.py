@@ -0,0 +1,196 @@
+#!/usr/bin/env python3
+##############################################################################
+#   File name   :   uart_log_decode.py
+#   Brief       :   Expand the binary debug_print() tokens sent by uart_debug.c
+#   Author      :   OS team
+#   Note        :   Usage: uart_log_decode.py <image.out> [capture|-]
+#                   The format strings are read from the .out of the build
+#                   that produced the log, so both must match.
+#                   Live:  stty -F /dev/ttyACM0 9600 raw &&
+#                          uart_log_decode.py sensor.out /dev/ttyACM0
+##############################################################################
+
+import argparse
+import re
+import struct
+import sys
+
+# Must match uart_debug.h
+DEBUG_LOG_SYNC = 0xA5
+DEBUG_LOG_HEADER_LEN = 10
+DEBUG_LOG_MAX_RECORD = 48
+
+# Clock.tickPeriod in app.cfg
+DEFAULT_TICK_US = 10
+
+CONVERSION = re.compile(r'%(%|(-?)(0*)(\d*)([sdxXuc]))')
+
+
+class Image(object):
+    """Loaded sections of an ELF image, to read the format strings."""
+
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            data = f.read()
+        if data[:4] != b'\x7fELF':
+            raise ValueError('%s is not an ELF file' % path)
+        is64 = data[4] == 2
+        end = '<' if data[5] == 1 else '>'
+        if is64:
+            shoff, = struct.unpack_from(end + 'Q', data, 0x28)
+            shentsize, shnum = struct.unpack_from(end + 'HH', data, 0x3A)
+        else:
+            shoff, = struct.unpack_from(end + 'I', data, 0x20)
+            shentsize, shnum = struct.unpack_from(end + 'HH', data, 0x2E)
+        self.sections = []
+        for i in range(shnum):
+            base = shoff + i * shentsize
+            if is64:
+                _, sh_type, flags, addr, offset, size = struct.unpack_from(
+                    end + 'IIQQQQ', data, base)
+            else:
+                _, sh_type, flags, addr, offset, size = struct.unpack_from(
+                    end + 'IIIIII', data, base)
+            # SHT_PROGBITS with SHF_ALLOC
+            if sh_type == 1 and (flags & 0x2) and size > 0:
+                self.sections.append((addr, data[offset:offset + size]))
+        self.cache = {}
+
+    def string(self, addr):
+        if addr not in self.cache:
+            text = None
+            for start, body in self.sections:
+                if start <= addr < start + len(body):
+                    offset = addr - start
+                    stop = body.find(b'\0', offset)
+                    if stop < 0:
+                        stop = len(body)
+                    text = body[offset:stop].decode('latin-1')
+                    break
+            self.cache[addr] = text
+        return self.cache[addr]
+
+
+def expand(fmt, args):
+    """printf the subset of conversions handled by print() in uart_debug.c"""
+    args = list(args)
+
+    def convert(match):
+        if match.group(1) == '%':
+            return '%'
+        left, zero, width, conv = match.group(2, 3, 4, 5)
+        if not args:
+            return '<?>'
+        value = args.pop(0)
+        if conv == 's':
+            text = value
+        elif conv == 'c':
+            text = chr(value & 0xFF)
+        elif conv == 'd':
+            text = str(value - (1 << 32) if value & 0x80000000 else value)
+        elif conv == 'u':
+            text = str(value)
+        elif conv == 'x':
+            text = '%x' % value
+        else:
+            text = '%X' % value
+        width = int(width) if width else 0
+        if left:
+            return text.ljust(width)
+        if zero and conv != 's' and text.startswith('-'):
+            return '-' + text[1:].rjust(width - 1, '0')
+        return text.rjust(width, '0' if zero else ' ')
+
+    return CONVERSION.sub(convert, fmt)
+
+
+def arguments(fmt, payload):
+    """Split the argument bytes of a record following the format string."""
+    args = []
+    pos = 0
+    for match in CONVERSION.finditer(fmt):
+        conv = match.group(5)
+        if conv is None:
+            continue
+        if conv == 's':
+            if pos >= len(payload):
+                break
+            n = payload[pos]
+            args.append(payload[pos + 1:pos + 1 + n].decode('latin-1'))
+            pos += 1 + n
+        else:
+            if pos + 4 > len(payload):
+                break
+            args.append(struct.unpack_from('<I', payload, pos)[0])
+            pos += 4
+    return args
+
+
+def decode(image, stream, out, tick_us):
+    buf = bytearray()
+    text = bytearray()
+
+    def flush_text():
+        if text:
+            out.write(text.decode('latin-1'))
+            del text[:]
+
+    while True:
+        chunk = stream.read(1) if stream.isatty() else stream.read(4096)
+        if not chunk:
+            break
+        buf.extend(chunk)
+        while buf:
+            if buf[0] != DEBUG_LOG_SYNC:
+                text.append(buf.pop(0))
+                continue
+            if len(buf) < 2:
+                break
+            length = buf[1] + 2
+            if length < DEBUG_LOG_HEADER_LEN or length > DEBUG_LOG_MAX_RECORD:
+                # not a record, a raw byte that happens to match the sync
+                text.append(buf.pop(0))
+                continue
+            if len(buf) < length:
+                break
+            addr, ticks = struct.unpack_from('<II', buf, 2)
+            payload = bytes(buf[DEBUG_LOG_HEADER_LEN:length])
+            fmt = image.string(addr) if addr else None
+            if addr and fmt is None:
+                # unknown format address, resynchronize on the next byte
+                text.append(buf.pop(0))
+                continue
+            del buf[:length]
+            flush_text()
+            stamp = '[%10.4f] ' % (ticks * tick_us / 1e6)
+            if addr == 0:
+                dropped = struct.unpack_from('<I', payload)[0]
+                out.write('%s<%d records dropped>\n' % (stamp, dropped))
+            else:
+                line = expand(fmt, arguments(fmt, payload))
+                out.write(stamp + line.rstrip('\r\n') + '\n')
+        out.flush()
+    text.extend(buf)
+    flush_text()
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Expand binary debug_print() tokens')
+    parser.add_argument('image', help='.out file of the running firmware')
+    parser.add_argument('capture', nargs='?', default='-',
+                        help='captured UART bytes or serial device, - for stdin')
+    parser.add_argument('--tick-us', type=float, default=DEFAULT_TICK_US,
+                        help='Clock tick period in microseconds')
+    args = parser.parse_args()
+
+    image = Image(args.image)
+    if args.capture == '-':
+        stream = sys.stdin.buffer
+    else:
+        stream = open(args.capture, 'rb', buffering=0)
+    decode(image, stream, sys.stdout, args.tick_us)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,329 @@
+/**
+  ******************************************************************************
+  * @file        atEngine.c
+  * @author      OS Team
+  * @version     V0.0.1
+  * @date        19-October-2016
+  * @brief       this file is a table driven AT command engine for ESP8266:
+  *              each script step has an expected response, a timeout and a
+  *              retry count, unsolicited lines are dispatched to handlers,
+  *              and all waiting is done on a timer tick so the MCU can stay
+  *              in LPM3 between events
+  * @revision
+  ******************************************************************************
+  */
+
+
+/******************************************************************************
+**                      INCLUDE
+*******************************************************************************/
+#include <msp430.h>
+#include "atEngine.h"
+
+/******************************************************************************
+**                      DEFIINITIONS
+*******************************************************************************/
+
+//engine state
+typedef enum
+{
+	AT_STATE_IDLE = 0,
+	AT_STATE_WAIT_RESPONSE,
+	AT_STATE_BACKOFF
+}atState;
+
+/******************************************************************************
+**                      VARIABLE
+*******************************************************************************/
+
+static ringBuffer			*atRx;
+static void					(*atSend)(const char *str);
+static const atUrc			*atUrcs;
+static uint8_t				atUrcCount;
+
+static const atCommand		*atScript;
+static uint8_t				atScriptCount;
+static uint8_t				atStep;
+static uint8_t				atAttempt;
+static atScriptDone			atDone;
+static atState				atCurrentState = AT_STATE_IDLE;
+static uint16_t				atDeadline;
+
+static volatile uint16_t	atTicks = 0;
+static volatile uint8_t		atEvent = 0;
+
+/******************************************************************************
+**                      LOCAL FUNCTIONS
+*******************************************************************************/
+
+/*
+ *@functions: atExpired
+ *@brief    : check if the deadline has passed, wrap safe
+ *@param    : none
+ *@return   : 1 if expired
+ */
+
+static uint8_t atExpired(void)
+{
+    return (int16_t)(atTicks - atDeadline) >= 0;
+}
+
+/*
+ *@functions: atSendStep
+ *@brief    : send the command of the current step and arm its timeout
+ *@param    : none
+ *@return   : none
+ */
+
+static void atSendStep(void)
+{
+    const atCommand *cmd = &atScript[atStep];
+
+    if (cmd->command != NULL)
+        atSend(cmd->command);
+    else
+        cmd->sendCommand();
+
+    atCurrentState = AT_STATE_WAIT_RESPONSE;
+    atDeadline = atTicks + cmd->timeout;
+}
+
+/*
+ *@functions: atFinish
+ *@brief    : end the script and report the result
+ *@param    : AT_SCRIPT_DONE,AT_SCRIPT_FAILED
+ *@return   : none
+ */
+
+static void atFinish(uint8_t status)
+{
+    atScriptDone done = atDone;
+
+    atCurrentState = AT_STATE_IDLE;
+    atDone = NULL;
+
+    // may start the next script
+    if (done != NULL)
+        done(status);
+}
+
+/*
+ *@functions: atFailStep
+ *@brief    : the step timed out or was rejected, back off then retry
+ *@param    : none
+ *@return   : none
+ */
+
+static void atFailStep(void)
+{
+    uint8_t shift = atAttempt;
+
+    if (atAttempt >= atScript[atStep].retries)
+    {
+        atFinish(AT_SCRIPT_FAILED);
+        return;
+    }
+
+    if (shift > AT_BACKOFF_MAX_SHIFT)
+        shift = AT_BACKOFF_MAX_SHIFT;
+
+    atAttempt++;
+    atCurrentState = AT_STATE_BACKOFF;
+    atDeadline = atTicks + (AT_BACKOFF_BASE << shift);
+}
+
+/*
+ *@functions: atNextStep
+ *@brief    : the step got its response, move on
+ *@param    : none
+ *@return   : none
+ */
+
+static void atNextStep(void)
+{
+    atStep++;
+    atAttempt = 0;
+
+    if (atStep >= atScriptCount)
+        atFinish(AT_SCRIPT_DONE);
+    else
+        atSendStep();
+}
+
+/*
+ *@functions: atHandleLine
+ *@brief    : dispatch one complete line from ESP8266
+ *@param    : the line
+ *@return   : none
+ */
+
+static void atHandleLine(const ringBufferSpan *line)
+{
+    uint8_t i;
+
+    for (i = 0; i < atUrcCount; i++)
+    {
+        if (ringBufferSpanStartsWith(line, atUrcs[i].prefix))
+        {
+            atUrcs[i].handler(line);
+            break;
+        }
+    }
+
+    if (atCurrentState != AT_STATE_WAIT_RESPONSE)
+        return;
+
+    if (ringBufferSpanEquals(line, atScript[atStep].response) ||
+        ((atScript[atStep].altResponse != NULL) &&
+         ringBufferSpanEquals(line, atScript[atStep].altResponse)))
+    {
+        atNextStep();
+    }
+    else if (ringBufferSpanEquals(line, "ERROR") ||
+             ringBufferSpanEquals(line, "FAIL"))
+    {
+        atFailStep();
+    }
+}
+
+/******************************************************************************
+**                      FUNCTIONS
+*******************************************************************************/
+
+/*
+ *@functions: atEngineInit
+ *@brief    : set up the engine
+ *@param    : ring filled by the UART RX ISR, function to send a string,
+ *            unsolicited result code table and its size
+ *@return   : none
+ */
+
+void atEngineInit(ringBuffer *rx, void (*send)(const char *str),
+                  const atUrc *urcs, uint8_t urcCount)
+{
+    atRx = rx;
+    atSend = send;
+    atUrcs = urcs;
+    atUrcCount = urcCount;
+    atCurrentState = AT_STATE_IDLE;
+    atDone = NULL;
+}
+
+/*
+ *@functions: atEngineRun
+ *@brief    : start a command script, the first command is sent right away
+ *@param    : script, number of steps, callback for the result
+ *@return   : none
+ */
+
+void atEngineRun(const atCommand *script, uint8_t count, atScriptDone done)
+{
+    atScript = script;
+    atScriptCount = count;
+    atStep = 0;
+    atAttempt = 0;
+    atDone = done;
+
+    if (count == 0)
+        atFinish(AT_SCRIPT_DONE);
+    else
+        atSendStep();
+}
+
+/*
+ *@functions: atEngineBusy
+ *@brief    : check if a script is running
+ *@param    : none
+ *@return   : 1 if busy
+ */
+
+uint8_t atEngineBusy(void)
+{
+    return atCurrentState != AT_STATE_IDLE;
+}
+
+/*
+ *@functions: atEngineProcess
+ *@brief    : handle received lines and expired timers, call from main loop
+ *@param    : none
+ *@return   : none
+ */
+
+void atEngineProcess(void)
+{
+    ringBufferSpan line;
+    uint8_t status;
+
+    while ((status = ringBufferGetLine(atRx, &line)) != RINGBUFF_EMPTY)
+    {
+        // pieces of long lines (payloads) are not responses
+        if (status == RINGBUFF_OK)
+            atHandleLine(&line);
+        ringBufferRelease(atRx, &line);
+    }
+
+    if ((atCurrentState == AT_STATE_WAIT_RESPONSE) && atExpired())
+    {
+        atFailStep();
+    }
+    else if ((atCurrentState == AT_STATE_BACKOFF) && atExpired())
+    {
+        atSendStep();
+    }
+}
+
+/*
+ *@functions: atEngineTick
+ *@brief    : advance the engine clock, call from the timer ISR
+ *@param    : none
+ *@return   : none
+ */
+
+void atEngineTick(void)
+{
+    atTicks++;
+    atEvent = 1;
+}
+
+/*
+ *@functions: atEngineWake
+ *@brief    : flag that there is work for the main loop, call from ISRs
+ *@param    : none
+ *@return   : none
+ */
+
+void atEngineWake(void)
+{
+    atEvent = 1;
+}
+
+/*
+ *@functions: atEngineSleep
+ *@brief    : enter a low power mode until the next tick or received line.
+ *            The flag is checked with interrupts disabled so a wake up is
+ *            never lost.
+ *@param    : LPM3_bits, or LPM0_bits while SMCLK must keep running
+ *@return   : none
+ */
+
+void atEngineSleep(uint16_t lpmBits)
+{
+    __disable_interrupt();
+    if (atEvent == 0)
+        __bis_SR_register(lpmBits + GIE);
+    else
+        __enable_interrupt();
+    atEvent = 0;
+}
+
+/*
+ *@functions: atEngineTicks
+ *@brief    : get the engine clock
+ *@param    : none
+ *@return   : ticks of AT_TICK_MS since start
+ */
+
+uint16_t atEngineTicks(void)
+{
+    return atTicks;
+}
@@ -0,0 +1,80 @@
+/**
+  ******************************************************************************
+  * @file        atEngine.h
+  * @author      OS Team
+  * @version     V0.0.1
+  * @date        19-October-2016
+  * @brief       this file is header file of atEngine.c
+  * @revision
+  ******************************************************************************
+  */
+
+#ifndef		_ATENGINE_H_
+#define		_ATENGINE_H_
+
+
+/******************************************************************************
+**                      INCLUDE
+*******************************************************************************/
+#include "stdint.h"
+#include "ringBuffer.h"
+
+
+/******************************************************************************
+**                      DEFIINITIONS
+*******************************************************************************/
+
+// Period of the engine tick, driven by the hardware timer
+#define AT_TICK_MS                   100
+
+// Convert milliseconds to engine ticks
+#define AT_MS(ms)                    ((uint16_t)((ms) / AT_TICK_MS))
+
+// First retry waits AT_BACKOFF_BASE ticks, doubled for each further retry
+#define AT_BACKOFF_BASE              AT_MS(500)
+#define AT_BACKOFF_MAX_SHIFT         4
+
+//one step of a command script
+typedef struct
+{
+    const char *command;             // sent as is, NULL to use sendCommand
+    void (*sendCommand)(void);       // sends text built at run time
+    const char *response;            // final line that completes the step
+    const char *altResponse;         // also completes the step, may be NULL
+    uint16_t timeout;                // ticks to wait for the response
+    uint8_t retries;                 // resends before the script fails
+}atCommand;
+
+//unsolicited result code, checked against every received line
+typedef struct
+{
+    const char *prefix;
+    void (*handler)(const ringBufferSpan *line);
+}atUrc;
+
+//result of a command script
+typedef enum
+{
+	AT_SCRIPT_DONE = 0,
+	AT_SCRIPT_FAILED
+}atScriptStatus;
+
+typedef void (*atScriptDone)(uint8_t status);
+
+
+/******************************************************************************
+**                      FUNCTIONS
+*******************************************************************************/
+
+void     atEngineInit(ringBuffer *rx, void (*send)(const char *str),
+                      const atUrc *urcs, uint8_t urcCount);
+void     atEngineRun(const atCommand *script, uint8_t count,
+                     atScriptDone done);
+uint8_t  atEngineBusy(void);
+void     atEngineProcess(void);
+void     atEngineTick(void);
+void     atEngineWake(void);
+void     atEngineSleep(uint16_t lpmBits);
+uint16_t atEngineTicks(void);
+
+#endif
@@ -0,0 +1,114 @@
+/**
+  ******************************************************************************
+  * @file        collectorUart.c
+  * @author      OS Team
+  * @version     V0.0.1
+  * @date        19-October-2016
+  * @brief       this file is a receive only software UART for the collector
+  *              link. The start bit edge wakes the MCU from LPM3, SMCLK is
+  *              kept on (LPM0) only while a byte is being sampled by Timer1_A
+  * @revision
+  ******************************************************************************
+  */
+
+
+/******************************************************************************
+**                      INCLUDE
+*******************************************************************************/
+#include <msp430.h>
+#include "collectorUart.h"
+#include "atEngine.h"
+
+/******************************************************************************
+**                      VARIABLE
+*******************************************************************************/
+
+static ringBuffer			*cuRx;
+static volatile uint8_t		cuBusy = 0;
+static uint8_t				cuBitCount;
+static uint8_t				cuData;
+
+/******************************************************************************
+**                      FUNCTIONS
+*******************************************************************************/
+
+/*
+ *@functions: collectorUartInit
+ *@brief    : set up the receive pin and timer
+ *@param    : ring to fill with the received bytes
+ *@return   : none
+ */
+
+void collectorUartInit(ringBuffer *rx)
+{
+    cuRx = rx;
+
+    P2DIR &= ~COLLECTOR_UART_RX_PIN;          // Input
+    P2IES |= COLLECTOR_UART_RX_PIN;           // Falling edge = start bit
+    P2IFG &= ~COLLECTOR_UART_RX_PIN;
+    P2IE |= COLLECTOR_UART_RX_PIN;
+
+    TA1CTL = TASSEL_2 + MC_2 + TACLR;         // SMCLK, continuous mode
+}
+
+/*
+ *@functions: collectorUartBusy
+ *@brief    : check if a byte is being received, SMCLK must stay on
+ *@param    : none
+ *@return   : 1 if busy
+ */
+
+uint8_t collectorUartBusy(void)
+{
+    return cuBusy;
+}
+
+// Start bit: sample the data bits in their middle from now on
+#pragma vector=PORT2_VECTOR
+__interrupt void PORT2_ISR(void)
+{
+    P2IE &= ~COLLECTOR_UART_RX_PIN;
+    P2IFG &= ~COLLECTOR_UART_RX_PIN;
+
+    TA1CCR0 = TA1R + COLLECTOR_UART_BIT_TIME + COLLECTOR_UART_BIT_TIME / 2;
+    TA1CCTL0 = CCIE;
+    cuBitCount = 8;
+    cuData = 0;
+    cuBusy = 1;
+
+    // Keep SMCLK for Timer1_A, sleep in LPM0 until the byte is complete
+    atEngineWake();
+    __bic_SR_register_on_exit(SCG1 + SCG0);
+}
+
+// Data bit sample, LSB first
+#pragma vector=TIMER1_A0_VECTOR
+__interrupt void TIMER1_A0_ISR(void)
+{
+    TA1CCR0 += COLLECTOR_UART_BIT_TIME;
+
+    cuData >>= 1;
+    if (P2IN & COLLECTOR_UART_RX_PIN)
+        cuData |= 0x80;
+
+    if (--cuBitCount != 0)
+        return;
+
+    // Byte complete, wait for the next start bit
+    TA1CCTL0 = 0;
+    cuBusy = 0;
+    ringBufferPut(cuRx, cuData);
+    P2IFG &= ~COLLECTOR_UART_RX_PIN;
+    P2IE |= COLLECTOR_UART_RX_PIN;
+
+    if (cuData == '\n')
+    {
+        atEngineWake();
+        __bic_SR_register_on_exit(LPM3_bits);
+    }
+    else if (__get_SR_register_on_exit() & CPUOFF)
+    {
+        // Back to LPM3 if the main loop was asleep
+        __bis_SR_register_on_exit(SCG1 + SCG0);
+    }
+}
@@ -0,0 +1,43 @@
+/**
+  ******************************************************************************
+  * @file        collectorUart.h
+  * @author      OS Team
+  * @version     V0.0.1
+  * @date        19-October-2016
+  * @brief       this file is header file of collectorUart.c
+  * @revision
+  ******************************************************************************
+  */
+
+#ifndef		_COLLECTORUART_H_
+#define		_COLLECTORUART_H_
+
+
+/******************************************************************************
+**                      INCLUDE
+*******************************************************************************/
+#include "stdint.h"
+#include "ringBuffer.h"
+
+
+/******************************************************************************
+**                      DEFIINITIONS
+*******************************************************************************/
+
+// USCI_A0 talks to ESP8266, the collector is received in software on P2.0
+// (TA1.0) at 9600 8N1
+#define COLLECTOR_UART_SMCLK_HZ      16000000UL
+#define COLLECTOR_UART_BAUD          9600
+#define COLLECTOR_UART_RX_PIN        BIT0
+
+#define COLLECTOR_UART_BIT_TIME      (COLLECTOR_UART_SMCLK_HZ / COLLECTOR_UART_BAUD)
+
+
+/******************************************************************************
+**                      FUNCTIONS
+*******************************************************************************/
+
+void    collectorUartInit(ringBuffer *rx);
+uint8_t collectorUartBusy(void);
+
+#endif
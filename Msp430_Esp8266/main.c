@@ -23,213 +23,322 @@
 //******************************************************************************
 #include "main.h"
 
-uint8_t 			receiveArray[20];					// Array from uart
-uint8_t 			indexReceiveArray = 0;				// Index of receive array
-uint8_t 			getReceiveString = 0;
-uint8_t 			finishSend = 0;
-ringBuffer			ringBuff;
-uint8_t 			rBufferPop = 0;
-uint8_t 			String[20];
-//systemState  		sysState = STATE_SEND_RESET_COMMAND;
-systemState  		sysState = STATE_START_ESP8266;
-wifiState 			wifiStatus = WIFI_NOT_CONNECT;
+// Connect to the access point, the first "AT" also waits for ESP8266 boot
+static const atCommand connectScript[] =
+{
+	{"AT\r\n",					NULL, "OK", NULL, AT_MS(1000),  5},
+	{"ATE0\r\n",				NULL, "OK", NULL, AT_MS(1000),  3},
+	{"AT+CWMODE=1\r\n",			NULL, "OK", NULL, AT_MS(1000),  3},
+	{"AT+CWDHCP=1,1\r\n",		NULL, "OK", NULL, AT_MS(1000),  3},
+	{"AT+CWJAP=\"Vincom-NN\",\"vincom!@!@\"\r\n",
+								NULL, "OK", NULL, AT_MS(20000), 3},
+	{"AT+CIPMUX=1\r\n",			NULL, "OK", NULL, AT_MS(1000),  3}
+};
+
+// Reset ESP8266 when it does not answer any more
+static const atCommand resetScript[] =
+{
+	{"AT+RST\r\n",				NULL, "ready", NULL, AT_MS(10000), 2}
+};
+
+// Open the link to ThingSpeak, kept open until ESP8266 reports "3,CLOSED".
+// "ALREADY CONNECTED" is followed by "ERROR", so it only sets linkOpen and
+// the step fails: were it the response, that "ERROR" would fail the next
+// step. openDone() then uses the link anyway.
+static const atCommand openScript[] =
+{
+	{"AT+CIPSTART=3,\"TCP\",\"184.106.153.149\",80\r\n",
+								NULL, "OK", NULL, AT_MS(10000), 2}
+};
+
+// Send one batch of readings on the open link. "SEND OK" only means the
+// TCP send completed, the readings are kept until the HTTP status is 2xx
+static const atCommand uploadScript[] =
+{
+	{NULL,			sendCipsend,  ">", NULL, AT_MS(2000), 1},
+	{NULL,			sendRequest,  "SEND OK", NULL, AT_MS(10000), 0}
+};
 
-uint8_t Temp[3];
-uint8_t Hum[3];
-uint8_t	Cacbon[3];
-uint8_t thingspeakString[80];
-void SetupUart (void);
-void sendTxChar (uint8_t Character);
-void sendTxString (uint8_t* String);
-void faceData(void);
+// Unsolicited lines from ESP8266
+static const atUrc urcTable[] =
+{
+	{"WIFI CONNECTED",	urcWifiConnected},
+	{"WIFI GOT IP",		urcWifiGotIp},
+	{"WIFI DISCONNECT",	urcWifiDisconnect},
+	{"3,CONNECT",		urcConnect},
+	{"ALREADY CONNECTED",	urcConnect},
+	{"3,CLOSED",		urcClosed},
+	{"+IPD,3,",			urcIpd}
+};
+
+uint8_t				espRxBuffer[ESP_RX_BUFFER_SIZE];
+ringBuffer			ringBuff;							// Bytes from ESP8266
+uint8_t				collectorRxBuffer[COLLECTOR_RX_BUFFER_SIZE];
+ringBuffer			collectorRing;						// Bytes from collector
+appState  			sysState = APP_STATE_CONNECT;
+wifiState 			wifiStatus = WIFI_NOT_CONNECT;
+uint8_t				linkOpen = 0;						// TCP link 3 is up
+uint16_t			requestLength = 0;					// Bytes of the request
+int16_t				httpStatus = 0;						// Status of the response
+uint16_t			responseDeadline = 0;				// Tick to give up waiting
 
 int main(void)
 {
-	uint8_t length;
-	uint8_t getData = 0;
 	WDTCTL = WDTPW + WDTHOLD;                 // Stop WDT
 	if (CALBC1_1MHZ==0xFF)					// If calibration constant erased
 	{
 		while(1);                               // do not load, trap CPU!!
 	}
+	ringBufferInit(&ringBuff, espRxBuffer, sizeof(espRxBuffer));
+	ringBufferInit(&collectorRing, collectorRxBuffer, sizeof(collectorRxBuffer));
+	telemetryInit();
+	atEngineInit(&ringBuff, sendTxString, urcTable,
+				 sizeof(urcTable) / sizeof(urcTable[0]));
 	SetupUart();
-	// Delay 10s
-	__delay_cycles(160000000);
-//	configESP8266();
+	SetupTimer();
+	collectorUartInit(&collectorRing);
+
+	// ESP8266 may still be booting, "AT" is retried with backoff
+	atEngineRun(connectScript, sizeof(connectScript) / sizeof(connectScript[0]),
+				connectDone);
 
 	while (1)
 	{
-		// Get data from ringBuffer to String array
-		ringBufferPop(&ringBuff,String);
-		switch (sysState)
+		// Handle received lines, timeouts and retries
+		atEngineProcess();
+		// Queue the readings received from the collector
+		processCollector();
+
+		if ((sysState == APP_STATE_WAIT_RESPONSE) &&
+			((int16_t)(atEngineTicks() - responseDeadline) >= 0))
 		{
-		case STATE_SEND_RESET_COMMAND:
-			// Change to other state
-			sysState = STATE_START_ESP8266;
-			// Reset ESP8266
-			sendTxString("AT+RST\r\n");
-			break;
-		case STATE_START_ESP8266:
-			// Check ESP8266 ready to work or not
-			//if(strcmp((const char *)String,"ready") == 0)
-			//{
-				// Change to other state
-				sysState = STATE_CHECK_AT;
-				// Check AT
-				sendTxString("AT\r\n");
-			//}
-			break;
-		case STATE_CHECK_AT:
-			// If AT command can work
-			if(strcmp((const char *)String,"OK") == 0)
-			{
-				// Change to other state
-				sysState = STATE_PROCESS_ATE0;
-				// Disable echo functions
-				sendTxString("ATE0\r\n");
-			}
-			break;
-		case STATE_PROCESS_ATE0:
-			// If esp8266 can disable echo
-			if(strcmp((const char *)String,"OK") == 0)
-			{
-				// Change to other state
-				sysState = STATE_PROCESS_CWMODE1;
-				// Change to station Mode
-				sendTxString("AT+CWMODE=1\r\n");
-			}
-			break;
-		case STATE_PROCESS_CWMODE1:
-			if(strcmp((const char *)String,"OK") == 0)
-			{
-				// Change to other state
-				sysState = STATE_PROCESS_DHCP;
-				// Enable DHCP for station mode
-				sendTxString("AT+CWDHCP=1,1\r\n");
-			}
-			break;
-		case STATE_PROCESS_DHCP:
-			if(strcmp((const char *)String,"OK") == 0)
-			{
-				// Change to other state
-				sysState = STATE_PROCESS_CONNECT_WIFI;
-				// Connect to wifi
-				sendTxString("AT+CWJAP=\"Vincom-NN\",\"vincom!@!@\"\r\n");
-			}
-			break;
-		case STATE_PROCESS_CONNECT_WIFI:
-			if(strcmp((const char *)String,"WIFI CONNECTED") == 0)
-			{
-				wifiStatus = WIFI_CONNECTED;
-			}
-			else if(strcmp((const char *)String,"WIFI GOT IP") == 0)
+			// No response, keep the readings for the next request
+			finishUpload();
+		}
+
+		if ((sysState == APP_STATE_IDLE) && !atEngineBusy())
+		{
+			if (wifiStatus == WIFI_NOT_CONNECT)
 			{
-				wifiStatus = WIFI_GOT_IP;
+				// Lost the access point, join it again
+				sysState = APP_STATE_CONNECT;
+				atEngineRun(connectScript,
+							sizeof(connectScript) / sizeof(connectScript[0]),
+							connectDone);
 			}
-			else if(strcmp((const char *)String,"OK") == 0)
+			else if (telemetryReady(atEngineTicks()))
 			{
-				if (wifiStatus == WIFI_GOT_IP)
+				sysState = APP_STATE_UPLOAD;
+				if (linkOpen)
 				{
-					// Change to other state
-					sysState = STATE_PROCESS_CIPMUX1;
-					wifiStatus = WIFI_READY;
-					// Enable multiple connections
-					sendTxString("AT+CIPMUX=1\r\n");
+					startUpload();
+				}
+				else
+				{
+					// Only reconnect when the link was closed
+					atEngineRun(openScript,
+								sizeof(openScript) / sizeof(openScript[0]),
+								openDone);
 				}
 			}
-			break;
-		case STATE_PROCESS_CIPMUX1:
-			if(strcmp((const char *)String,"OK") == 0)
-			{
-				// Change to other state
-				sysState = STATE_PROCESS_CONNECT_IP;
-				// Connect to ThingSpeak
-				sendTxString("AT+CIPSTART=3,\"TCP\",\"184.106.153.149\",80\r\n");
-			}
-			break;
-		case STATE_PROCESS_CONNECT_IP:
-			if(strcmp((const char *)String,"ALREAY CONNECT") == 0)
-			{
-				// Create a face data of sensor
-				faceData();
-				// Change to other state
-				sysState = STATE_SEND_DATA;
-				sendTxString("AT+CIPSEND=3,68\r\n");
-			}
-			else if(strcmp((const char *)String,"3,CLOSED") == 0)
-			{
-				// Trying to connect to ThingSpeak again
-				sendTxString("AT+CIPSTART=3,\"TCP\",\"184.106.153.149\",80\r\n");
-			}
-			else if(strcmp((const char *)String,"OK") == 0)
-			{
-				// Create a face data of sensor
-				faceData();
-				// Change to other state
-				sysState = STATE_SEND_DATA;
-				sendTxString("AT+CIPSEND=3,68\r\n");
-			}
-			break;
-		case STATE_SEND_DATA:
-			if(strcmp((const char *)String,">") == 0)
-			{
-				// Change to other state
-				sysState = STATE_CLOSE;
-				sendTxString(thingspeakString);
-				sendTxString("\r\n");
-			}
-			break;
-		case STATE_CLOSE:
-			if(strcmp((const char *)String,"SEND OK") == 0)
-			{
-				// delay 4 minutes
-				__delay_cycles(0xFFFFFFFF);
-				// delay 4 minutes
-				__delay_cycles(0xFFFFFFFF);
-				// Change to other state
-				sysState = STATE_PROCESS_CONNECT_IP;
-				// Connect to ThingSpeak
-				sendTxString("AT+CIPSTART=3,\"TCP\",\"184.106.153.149\",80\r\n");
-			}
-			break;
-		default:
-			break;
 		}
+
+		// Sleep in LPM3 until the next tick or received line, SMCLK is
+		// kept while a byte from the collector is being sampled
+		atEngineSleep(collectorUartBusy() ? LPM0_bits : LPM3_bits);
 	}
 }
 
-// Echo back RXed character, confirm TX buffer is ready first
-#pragma vector=USCIAB0RX_VECTOR
-__interrupt void USCI0RX_ISR(void)
+// Connect script finished
+void connectDone(uint8_t status)
+{
+	if (status == AT_SCRIPT_DONE)
+	{
+		sysState = APP_STATE_IDLE;
+		wifiStatus = WIFI_READY;
+		linkOpen = 0;
+	}
+	else
+	{
+		// ESP8266 does not answer, reset it then connect again
+		atEngineRun(resetScript, sizeof(resetScript) / sizeof(resetScript[0]),
+					resetDone);
+	}
+}
+
+// Reset script finished
+void resetDone(uint8_t status)
+{
+	atEngineRun(connectScript, sizeof(connectScript) / sizeof(connectScript[0]),
+				connectDone);
+}
+
+// Open script finished
+void openDone(uint8_t status)
+{
+	if (linkOpen)
+	{
+		startUpload();
+	}
+	else
+	{
+		// Cannot reach ThingSpeak, check the access point again
+		sysState = APP_STATE_IDLE;
+		wifiStatus = WIFI_NOT_CONNECT;
+	}
+}
+
+// Send all queued readings in one request
+void startUpload(void)
+{
+	requestLength = telemetryPrepare(atEngineTicks());
+	httpStatus = 0;
+	atEngineRun(uploadScript, sizeof(uploadScript) / sizeof(uploadScript[0]),
+				uploadDone);
+}
+
+// Upload script finished
+void uploadDone(uint8_t status)
+{
+	if (status != AT_SCRIPT_DONE)
+	{
+		// Keep the readings and reopen the link: "3,CLOSED" is missed when
+		// ESP8266 prints it right after the response data, with no <CR><LF>,
+		// and AT+CIPSTART only answers "ALREADY CONNECTED" if it is still up
+		sysState = APP_STATE_IDLE;
+		linkOpen = 0;
+		telemetryCancel();
+	}
+	else if (httpStatus != 0)
+	{
+		// The response came in before "SEND OK"
+		finishUpload();
+	}
+	else
+	{
+		sysState = APP_STATE_WAIT_RESPONSE;
+		responseDeadline = atEngineTicks() + HTTP_RESPONSE_TIMEOUT;
+	}
+}
+
+// The HTTP response came in or never will, drop the readings only if
+// ThingSpeak took them
+void finishUpload(void)
 {
-	// Get Rx data to array
-	receiveArray[indexReceiveArray++] = UCA0RXBUF;
-	// If we receive a <CR><LF> string
-	if ((receiveArray[indexReceiveArray - 2]== 0x0D)&&(receiveArray[indexReceiveArray - 1]== 0x0A))
+	sysState = APP_STATE_IDLE;
+	if ((httpStatus >= 200) && (httpStatus <= 299))
 	{
-		receiveArray[indexReceiveArray - 2] = 0;
-		receiveArray[indexReceiveArray - 1] = 0;
-		indexReceiveArray = 0;
-//		sendTxString(receiveArray);
-//		getReceiveString = 1;
-		ringBufferPush(&ringBuff,receiveArray);
+		telemetryAck();
 	}
-	// If we receive a ">"
-	else if (receiveArray[indexReceiveArray - 1]== '>')
+	else
 	{
-		receiveArray[indexReceiveArray] = 0;
-		indexReceiveArray = 0;
-//		getReceiveString = 1;
-		ringBufferPush(&ringBuff,receiveArray);
+		telemetryCancel();
 	}
-	// If receive string is too Long
-	else if (indexReceiveArray >= 20)
+}
+
+// Parse the lines received from the collector
+void processCollector(void)
+{
+	ringBufferSpan line;
+	uint8_t status;
+	int16_t field[TELEMETRY_FIELDS];
+
+	while ((status = ringBufferGetLine(&collectorRing, &line)) != RINGBUFF_EMPTY)
 	{
-		indexReceiveArray = 0;
+		if ((status == RINGBUFF_OK) && telemetryParse(&line, field))
+		{
+			telemetryAdd(atEngineTicks(), field);
+		}
+		ringBufferRelease(&collectorRing, &line);
+	}
+}
+
+void urcWifiConnected(const ringBufferSpan *line)
+{
+	wifiStatus = WIFI_CONNECTED;
+}
+
+void urcWifiGotIp(const ringBufferSpan *line)
+{
+	wifiStatus = WIFI_GOT_IP;
+}
+
+void urcWifiDisconnect(const ringBufferSpan *line)
+{
+	wifiStatus = WIFI_NOT_CONNECT;
+}
+
+void urcConnect(const ringBufferSpan *line)
+{
+	linkOpen = 1;
+}
+
+void urcClosed(const ringBufferSpan *line)
+{
+	linkOpen = 0;
+}
+
+// First line of the data received on the ThingSpeak link
+void urcIpd(const ringBufferSpan *line)
+{
+	int16_t status = telemetryHttpStatus(line);
+
+	if ((status == 0) ||
+		((sysState != APP_STATE_UPLOAD) && (sysState != APP_STATE_WAIT_RESPONSE)))
 		return;
+
+	httpStatus = status;
+	if (sysState == APP_STATE_WAIT_RESPONSE)
+		finishUpload();
+}
+
+// First step of the upload script, the length is computed from the batch
+void sendCipsend(void)
+{
+	uint8_t digits[6];
+	uint8_t n = 0;
+	uint16_t length = requestLength;
+
+	sendTxString("AT+CIPSEND=3,");
+	do
+	{
+		digits[n++] = '0' + (length % 10);
+		length /= 10;
+	} while (length != 0);
+	while (n > 0)
+		sendTxChar(digits[--n]);
+	sendTxString("\r\n");
+}
+
+// Second step of the upload script, streamed without a RAM copy
+void sendRequest(void)
+{
+	telemetryWrite(sendTxChar);
+}
+
+// Queue RXed character, wake the main loop at the end of a line
+#pragma vector=USCIAB0RX_VECTOR
+__interrupt void USCI0RX_ISR(void)
+{
+	uint8_t data = UCA0RXBUF;
+
+	// Only queue the byte, lines are framed in the main loop
+	ringBufferPut(&ringBuff,data);
+	if ((data == '\n') || (data == '>'))
+	{
+		atEngineWake();
+		__bic_SR_register_on_exit(LPM3_bits);
 	}
 }
 
+// Engine tick
+#pragma vector=TIMER0_A0_VECTOR
+__interrupt void TIMER0_A0_ISR(void)
+{
+	atEngineTick();
+	__bic_SR_register_on_exit(LPM3_bits);
+}
+
 void SetupUart (void)
 {
 //	  DCOCTL = 0;                               // Select lowest DCOx and MODx settings
@@ -251,35 +360,22 @@ void SetupUart (void)
 	  __bis_SR_register(GIE);       // Enter LPM0, interrupts enabled
 }
 
+void SetupTimer (void)
+{
+	  BCSCTL3 |= LFXT1S_2;                      // ACLK = VLO, runs in LPM3
+	  TA0CCR0 = (VLO_HZ / 1000) * AT_TICK_MS - 1;
+	  TA0CCTL0 = CCIE;                          // Tick interrupt
+	  TA0CTL = TASSEL_1 + MC_1 + TACLR;         // ACLK, up mode
+}
+
 void sendTxChar (uint8_t Character)
 {
 	  while (!(IFG2&UCA0TXIFG));                // USCI_A0 TX buffer ready?
 	  UCA0TXBUF = Character;                    // TX -> character
 }
 
-void sendTxString (uint8_t* String)
+void sendTxString (const char* String)
 {
 	while (*String!=0)
 		sendTxChar(*String++);
 }
-
-void faceData(void)
-{
-	strcpy(thingspeakString,"GET /update?api_key=WUZZ3SUHKQUCF89U&field1=");
-	Temp[0] 	= 2 + 48;
-	Temp[1] 	= rand()%10 + 48;
-	Temp[2] 	= '\0';
-	Hum[0] 		= (5 + rand()%(4)) + 48;
-	Hum[1] 		= rand()%10 + 48;
-	Hum[2]		= '\0';
-	Cacbon[0] 	= (3 + rand()%(4)) + 48;
-	Cacbon[1] 	= rand()%10 + 48;
-	Cacbon[2] 	= '\0';
-	strcat(thingspeakString,Temp);
-	strcat(thingspeakString,"&field2=");
-	strcat(thingspeakString,Hum);
-	strcat(thingspeakString,"&field3=");
-	strcat(thingspeakString,Cacbon);
-	strcat(thingspeakString,"\r\n");
-}
-
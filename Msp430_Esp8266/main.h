@@ -10,22 +10,28 @@
 
 #include <msp430.h>
 #include <ringBuffer.h>
+#include <atEngine.h>
+#include <telemetry.h>
+#include <collectorUart.h>
 #include <stdlib.h>
 
+// VLO frequency, clock of the engine tick timer (typical 12kHz)
+#define VLO_HZ					12000
+
+// Time to wait for the HTTP response once the request is sent
+#define HTTP_RESPONSE_TIMEOUT	AT_MS(15000)
+
+// Receive rings, power of two sizes
+#define ESP_RX_BUFFER_SIZE		128
+#define COLLECTOR_RX_BUFFER_SIZE	32
+
 typedef enum
 {
-	STATE_SEND_RESET_COMMAND  = 0,
-	STATE_START_ESP8266,
-	STATE_CHECK_AT,
-	STATE_PROCESS_ATE0,
-	STATE_PROCESS_CWMODE1,
-	STATE_PROCESS_DHCP,
-	STATE_PROCESS_CONNECT_WIFI,
-	STATE_PROCESS_CIPMUX1,
-	STATE_PROCESS_CONNECT_IP,
-	STATE_SEND_DATA,
-	STATE_CLOSE
-}systemState;
+	APP_STATE_CONNECT = 0,
+	APP_STATE_IDLE,
+	APP_STATE_UPLOAD,
+	APP_STATE_WAIT_RESPONSE
+}appState;
 
 typedef enum
 {
@@ -35,6 +41,24 @@ typedef enum
 	WIFI_READY
 }wifiState;
 
-
+void SetupUart (void);
+void SetupTimer (void);
+void sendTxChar (uint8_t Character);
+void sendTxString (const char* String);
+void sendCipsend(void);
+void sendRequest(void);
+void startUpload(void);
+void processCollector(void);
+void connectDone(uint8_t status);
+void resetDone(uint8_t status);
+void openDone(uint8_t status);
+void uploadDone(uint8_t status);
+void finishUpload(void);
+void urcWifiConnected(const ringBufferSpan *line);
+void urcWifiGotIp(const ringBufferSpan *line);
+void urcWifiDisconnect(const ringBufferSpan *line);
+void urcConnect(const ringBufferSpan *line);
+void urcClosed(const ringBufferSpan *line);
+void urcIpd(const ringBufferSpan *line);
 
 #endif /* MAIN_H_ */
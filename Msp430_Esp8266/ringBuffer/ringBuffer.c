@@ -2,84 +2,278 @@
   ******************************************************************************
   * @file        ringBuffer.c
   * @author      OS Team
-  * @version     V0.0.1
+  * @version     V0.0.2
   * @date        4-September-2016
-  * @brief       this file is ring buffer protocol for  asynchronous transmission 
-  * @revision
+  * @brief       this file is ring buffer protocol for  asynchronous transmission
+  * @revision    V0.0.2: byte stream SPSC ring with line framing over spans
   ******************************************************************************
   */
-  
-  
+
+
 /******************************************************************************
 **                      INCLUDE
 *******************************************************************************/
 #include "ringBuffer.h"
 
+/******************************************************************************
+**                      DEFIINITIONS
+*******************************************************************************/
+
+// Fill level at which an unterminated line is handed out in pieces, so that
+// long responses (+IPD payloads, HTTP headers) are never dropped
+#define RING_BUFFER_PARTIAL_LEVEL(c) ((((c)->mask + 1) * 3) / 4)
+
 /******************************************************************************
 **                      VARIABLE
 *******************************************************************************/
 
+/******************************************************************************
+**                      LOCAL FUNCTIONS
+*******************************************************************************/
+
+/*
+ *@functions: ringBufferAt
+ *@brief    : get a byte relative to the tail
+ *@param    : ringBuffer, offset from tail
+ *@return   : the byte
+ */
+
+static uint8_t ringBufferAt(const ringBuffer *c, uint8_t offset)
+{
+    return c->buffer[(uint8_t)(c->tail + offset) & c->mask];
+}
+
+/*
+ *@functions: ringBufferMakeSpan
+ *@brief    : describe len bytes from the tail, split where the ring wraps
+ *@param    : ringBuffer, span, line length, terminator length
+ *@return   : none
+ */
+
+static void ringBufferMakeSpan(const ringBuffer *c, ringBufferSpan *span,
+                               uint8_t len, uint8_t skip)
+{
+    uint8_t start = c->tail & c->mask;
+    uint8_t first = c->mask + 1 - start;
+
+    if (first > len)
+        first = len;
+
+    span->data[0] = &c->buffer[start];
+    span->len[0] = first;
+    span->data[1] = &c->buffer[0];
+    span->len[1] = len - first;
+    span->skip = skip;
+}
+
+/******************************************************************************
+**                      FUNCTIONS
+*******************************************************************************/
+
 /*
- *@functions: ringBufferPush
- *@brief    : push array into asyn buffer
- *@param    : ringBuffer, the pushed array
+ *@functions: ringBufferInit
+ *@brief    : reset the ring buffer
+ *@param    : ringBuffer, storage, storage size (power of two, at most
+ *            RING_BUFFER_MAX_SIZE)
+ *@return   : none
+ */
+
+void ringBufferInit(ringBuffer *c, uint8_t *buffer, uint8_t size)
+{
+    c->buffer = buffer;
+    c->mask = size - 1;
+    c->head = 0;
+    c->tail = 0;
+    c->scan = 0;
+    c->overflow = 0;
+}
+
+/*
+ *@functions: ringBufferPut
+ *@brief    : push one byte into the buffer, producer side (RX ISR)
+ *@param    : ringBuffer, the pushed byte
  *@return   : RINGBUFF_OK,RINGBUFF_FULL
  */
 
-uint8_t ringBufferPush(ringBuffer *c, uint8_t* data)
+uint8_t ringBufferPut(ringBuffer *c, uint8_t data)
 {
-    uint8_t next = c->head + 1;
-    //check the maximum buffer
-    if (next >= MAX_RING_BUFFER)
-        next = 0;
+    uint8_t head = c->head;
 
     // check if buffer is full
-    if (next == c->tail)
+    if ((uint8_t)(head - c->tail) > c->mask)
+    {
+        c->overflow++;
         return RINGBUFF_FULL;  // quit with full message
+    }
 
-    //copy data
-    strcpy((char *)c->buffer[c->head],(char*)data);
+    c->buffer[head & c->mask] = data;
 
-    //next string
-    c->head = next;
+    // publish the byte only once it is stored
+    c->head = head + 1;
     return RINGBUFF_OK;
 }
 
 /*
- *@functions: ringBufferPop
- *@brief    : pop array from asyn buffer
- *@param    : ringBuffer, the poped array
- *@return   : RINGBUFF_OK,RINGBUFF_EMPTY
+ *@functions: ringBufferCount
+ *@brief    : number of bytes waiting in the buffer
+ *@param    : ringBuffer
+ *@return   : byte count
  */
 
-uint8_t ringBufferPop(ringBuffer *c, uint8_t *data)
+uint8_t ringBufferCount(const ringBuffer *c)
 {
-	uint8_t next = c->tail + 1;
+    return (uint8_t)(c->head - c->tail);
+}
+
+/*
+ *@functions: ringBufferGetLine
+ *@brief    : find the next line terminated by <CR><LF> (or <LF>), or a ">"
+ *            prompt at the start of a line. Bytes already searched are not
+ *            searched again. Nothing is copied: the span points into the
+ *            ring and stays valid until ringBufferRelease().
+ *@param    : ringBuffer, the line span
+ *@return   : RINGBUFF_OK        complete line, terminator not included
+ *            RINGBUFF_PARTIAL   no terminator yet but the buffer is nearly
+ *                               full, span holds the start of the line
+ *            RINGBUFF_EMPTY     no complete line yet
+ */
 
-	//check the maximum buffer
-    if (next >= MAX_RING_BUFFER)
-        next = 0;
+uint8_t ringBufferGetLine(ringBuffer *c, ringBufferSpan *span)
+{
+    uint8_t count = ringBufferCount(c);
+    uint8_t i;
 
-    // if the head isn't ahead of the tail, we don't have any
-	// buffer is empty
-    if (c->head == c->tail)
+    for (i = c->scan; i < count; i++)
     {
-        // copy empty string data
-        strcpy((char*)data,(char*)emptyString);
-        // quit with empty message
-        return RINGBUFF_EMPTY;
+        uint8_t data = ringBufferAt(c, i);
+
+        // prompt of AT+CIPSEND, "> " not followed by <CR><LF>
+        if ((i == 0) && (data == '>'))
+        {
+            ringBufferMakeSpan(c, span, 1,
+                               (count > 1) && (ringBufferAt(c, 1) == ' '));
+            return RINGBUFF_OK;
+        }
+
+        if (data == '\n')
+        {
+            if ((i > 0) && (ringBufferAt(c, i - 1) == '\r'))
+                ringBufferMakeSpan(c, span, i - 1, 2);
+            else
+                ringBufferMakeSpan(c, span, i, 1);
+            return RINGBUFF_OK;
+        }
     }
+    c->scan = count;
 
-    // copy data
-    strcpy((char*)data,(char*)c->buffer[c->tail]);
-    //nexy tail
-    c->tail = next;
-/*    if (next < c->head)
+    if (count >= RING_BUFFER_PARTIAL_LEVEL(c))
     {
-    	// post event until ringBuffer to empty
-    	//Event_post(myEvent, Event_Id_01);
-    	return RINGBUFF_HAS_DATA;
-    }*/
+        // keep a trailing <CR> so the terminator is still recognised
+        if (ringBufferAt(c, count - 1) == '\r')
+            count--;
+        ringBufferMakeSpan(c, span, count, 0);
+        return RINGBUFF_PARTIAL;
+    }
 
-    return RINGBUFF_OK;
+    return RINGBUFF_EMPTY;
+}
+
+/*
+ *@functions: ringBufferRelease
+ *@brief    : give the bytes of a line (and its terminator) back to the ring
+ *@param    : ringBuffer, span returned by ringBufferGetLine
+ *@return   : none
+ */
+
+void ringBufferRelease(ringBuffer *c, const ringBufferSpan *span)
+{
+    c->scan = 0;
+    c->tail = c->tail + ringBufferSpanLength(span) + span->skip;
+}
+
+/*
+ *@functions: ringBufferSpanLength
+ *@brief    : length of a span
+ *@param    : span
+ *@return   : length in bytes
+ */
+
+uint8_t ringBufferSpanLength(const ringBufferSpan *span)
+{
+    return span->len[0] + span->len[1];
+}
+
+/*
+ *@functions: ringBufferSpanByte
+ *@brief    : get a byte of a span
+ *@param    : span, index in the span
+ *@return   : the byte
+ */
+
+uint8_t ringBufferSpanByte(const ringBufferSpan *span, uint8_t i)
+{
+    if (i < span->len[0])
+        return span->data[0][i];
+
+    return span->data[1][i - span->len[0]];
+}
+
+/*
+ *@functions: ringBufferSpanStartsWith
+ *@brief    : compare the start of a span with a string
+ *@param    : span, the string
+ *@return   : 1 if the span starts with the string, 0 otherwise
+ */
+
+uint8_t ringBufferSpanStartsWith(const ringBufferSpan *span, const char *str)
+{
+    uint8_t len = ringBufferSpanLength(span);
+    uint8_t i;
+
+    for (i = 0; str[i] != 0; i++)
+    {
+        if ((i >= len) || (ringBufferSpanByte(span, i) != (uint8_t)str[i]))
+            return 0;
+    }
+
+    return 1;
+}
+
+/*
+ *@functions: ringBufferSpanEquals
+ *@brief    : compare a span with a string
+ *@param    : span, the string
+ *@return   : 1 if equal, 0 otherwise
+ */
+
+uint8_t ringBufferSpanEquals(const ringBufferSpan *span, const char *str)
+{
+    return (strlen(str) == ringBufferSpanLength(span)) &&
+           ringBufferSpanStartsWith(span, str);
+}
+
+/*
+ *@functions: ringBufferSpanCopy
+ *@brief    : copy a span into a zero terminated string, truncating it
+ *@param    : span, destination, destination size
+ *@return   : number of bytes copied
+ */
+
+uint8_t ringBufferSpanCopy(const ringBufferSpan *span, uint8_t *data,
+                           uint8_t size)
+{
+    uint8_t len = ringBufferSpanLength(span);
+    uint8_t i;
+
+    if (size == 0)
+        return 0;
+
+    if (len > size - 1)
+        len = size - 1;
+
+    for (i = 0; i < len; i++)
+        data[i] = ringBufferSpanByte(span, i);
+    data[len] = 0;
+
+    return len;
 }
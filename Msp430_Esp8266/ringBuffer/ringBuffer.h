@@ -2,17 +2,17 @@
   ******************************************************************************
   * @file        ringBuffer.h
   * @author      OS Team
-  * @version     V0.0.1
+  * @version     V0.0.2
   * @date        4-September-2016
-  * @brief       this file is header file of ringBuffer.c 
-  * @revision
+  * @brief       this file is header file of ringBuffer.c
+  * @revision    V0.0.2: byte stream SPSC ring with line framing over spans
   ******************************************************************************
   */
 
 #ifndef		_RINGBUFFER_H_
 #define		_RINGBUFFER_H_
-  
-  
+
+
 /******************************************************************************
 **                      INCLUDE
 *******************************************************************************/
@@ -24,33 +24,43 @@
 **                      DEFIINITIONS
 *******************************************************************************/
 
-#define MAX_INDEX_RING_BUFFER        20
-#define MAX_RING_BUFFER              10
-
+// Largest ring size in bytes. Sizes must be a power of two and at most 128
+// so that the free running 8 bit head/tail counters can tell full from empty
+#define RING_BUFFER_MAX_SIZE         128
 
 #define TEST_RING_BUFFER             0
 
-uint8_t emptyString [20];
-
-
-
-
 
 //ring buffer struct
+// head is only written by the producer (UART RX ISR), tail and scan are only
+// written by the consumer (main loop), so no locking is needed: on the
+// MSP430 an 8 bit load or store is atomic.
 typedef struct
 {
-    uint8_t buffer[MAX_RING_BUFFER][MAX_INDEX_RING_BUFFER];
-    uint8_t head;
-    uint8_t tail;
+    uint8_t *buffer;            // storage given to ringBufferInit
+    uint8_t mask;               // size - 1
+    volatile uint8_t head;      // free running write counter (producer)
+    volatile uint8_t tail;      // free running read counter (consumer)
+    uint8_t scan;               // bytes after tail already searched for EOL
+    uint8_t overflow;           // bytes dropped because the ring was full
 }ringBuffer;
 
+// zero copy view of a line in the ring, split in two when it wraps
+typedef struct
+{
+    const uint8_t *data[2];
+    uint8_t len[2];
+    uint8_t skip;               // terminator bytes to release after the line
+}ringBufferSpan;
+
 //ringbuffer status
 typedef enum
 {
 	RINGBUFF_OK = 0,
 	RINGBUFF_FULL,
 	RINGBUFF_EMPTY,
-	RINGBUFF_HAS_DATA
+	RINGBUFF_HAS_DATA,
+	RINGBUFF_PARTIAL
 }ringBufferStatus;
 
 
@@ -58,7 +68,16 @@ typedef enum
 **                      FUNCTIONS
 *******************************************************************************/
 
-uint8_t ringBufferPush(ringBuffer *c, uint8_t* data);
-uint8_t ringBufferPop (ringBuffer *c, uint8_t *data);
+void    ringBufferInit(ringBuffer *c, uint8_t *buffer, uint8_t size);
+uint8_t ringBufferPut(ringBuffer *c, uint8_t data);
+uint8_t ringBufferCount(const ringBuffer *c);
+uint8_t ringBufferGetLine(ringBuffer *c, ringBufferSpan *span);
+void    ringBufferRelease(ringBuffer *c, const ringBufferSpan *span);
+uint8_t ringBufferSpanLength(const ringBufferSpan *span);
+uint8_t ringBufferSpanByte(const ringBufferSpan *span, uint8_t i);
+uint8_t ringBufferSpanEquals(const ringBufferSpan *span, const char *str);
+uint8_t ringBufferSpanStartsWith(const ringBufferSpan *span, const char *str);
+uint8_t ringBufferSpanCopy(const ringBufferSpan *span, uint8_t *data,
+                           uint8_t size);
 
 #endif
@@ -0,0 +1,455 @@
+/**
+  ******************************************************************************
+  * @file        telemetry.c
+  * @author      OS Team
+  * @version     V0.0.1
+  * @date        19-October-2016
+  * @brief       this file keeps the readings received from the collector and
+  *              formats them as one ThingSpeak bulk update request, so many
+  *              readings share one HTTP request over a kept alive connection.
+  *              Without a channel ID each request is a single /update
+  * @revision
+  ******************************************************************************
+  */
+
+
+/******************************************************************************
+**                      INCLUDE
+*******************************************************************************/
+#include "telemetry.h"
+
+/******************************************************************************
+**                      DEFIINITIONS
+*******************************************************************************/
+
+// Line sent by the collector, see Csf_deviceSensorDataUpdate() in the
+// collector's csf.c: "$S,<temperature>,<humidity>,<light>"
+#define TELEMETRY_LINE_PREFIX        "$S,"
+
+// Status line of the HTTP response, after the "+IPD,<id>,<length>:" header
+#define TELEMETRY_HTTP_PREFIX        "HTTP/1."
+
+#define TELEMETRY_TICKS_PER_SECOND   (1000 / AT_TICK_MS)
+
+/******************************************************************************
+**                      VARIABLE
+*******************************************************************************/
+
+static telemetryReading		readings[TELEMETRY_MAX_READINGS];
+static uint8_t				readingFirst;
+static uint8_t				readingCount;
+static uint8_t				readingInFlight;	// readings in the request
+static uint16_t				readingDropped;
+static uint16_t				batchTick;			// time of the request
+static uint8_t				batchSent;			// a request was prepared
+#if THINGSPEAK_BULK_UPDATE
+static uint16_t				bodyLength;
+#endif
+static uint16_t				countLength;
+
+/******************************************************************************
+**                      LOCAL FUNCTIONS
+*******************************************************************************/
+
+/*
+ *@functions: countChar
+ *@brief    : output that only counts bytes
+ *@param    : the byte
+ *@return   : none
+ */
+
+static void countChar(uint8_t c)
+{
+    (void)c;
+    countLength++;
+}
+
+/*
+ *@functions: writeString
+ *@brief    : write a zero terminated string
+ *@param    : output, the string
+ *@return   : none
+ */
+
+static void writeString(void (*put)(uint8_t c), const char *str)
+{
+    while (*str != 0)
+        put(*str++);
+}
+
+/*
+ *@functions: writeNumber
+ *@brief    : write a signed decimal number
+ *@param    : output, the number
+ *@return   : none
+ */
+
+static void writeNumber(void (*put)(uint8_t c), int32_t value)
+{
+    uint8_t digits[10];
+    uint8_t n = 0;
+
+    if (value < 0)
+    {
+        put('-');
+        value = -value;
+    }
+
+    do
+    {
+        digits[n++] = '0' + (value % 10);
+        value /= 10;
+    } while (value != 0);
+
+    while (n > 0)
+        put(digits[--n]);
+}
+
+#if THINGSPEAK_BULK_UPDATE
+
+/*
+ *@functions: writeBody
+ *@brief    : write the form body with the readings of the request. Each
+ *            update is "<seconds before request>,<field1>,<field2>,<field3>"
+ *@param    : output
+ *@return   : none
+ */
+
+static void writeBody(void (*put)(uint8_t c))
+{
+    uint8_t i, f;
+
+    writeString(put, "write_api_key=" THINGSPEAK_API_KEY
+                     "&time_format=relative&updates=");
+
+    for (i = 0; i < readingInFlight; i++)
+    {
+        const telemetryReading *r =
+            &readings[(readingFirst + i) % TELEMETRY_MAX_READINGS];
+
+        if (i > 0)
+            put('|');
+        writeNumber(put, (uint16_t)(batchTick - r->tick) /
+                         TELEMETRY_TICKS_PER_SECOND);
+        for (f = 0; f < TELEMETRY_FIELDS; f++)
+        {
+            put(',');
+            writeNumber(put, r->field[f]);
+        }
+    }
+}
+
+#else
+
+/*
+ *@functions: writeFields
+ *@brief    : write the query of a single update with the oldest reading,
+ *            "&field1=<field1>&field2=<field2>&field3=<field3>"
+ *@param    : output
+ *@return   : none
+ */
+
+static void writeFields(void (*put)(uint8_t c))
+{
+    uint8_t f;
+
+    for (f = 0; f < TELEMETRY_FIELDS; f++)
+    {
+        writeString(put, "&field");
+        put('1' + f);
+        put('=');
+        writeNumber(put, readings[readingFirst].field[f]);
+    }
+}
+
+#endif
+
+/*
+ *@functions: parseNumber
+ *@brief    : parse a signed decimal number from a span
+ *@param    : span, position (updated), the number
+ *@return   : 1 if a number was found and fits an int16_t
+ */
+
+static uint8_t parseNumber(const ringBufferSpan *line, uint8_t *pos,
+                           int16_t *value)
+{
+    uint8_t len = ringBufferSpanLength(line);
+    uint8_t negative = 0;
+    uint8_t digits = 0;
+    uint16_t limit = 32767;
+    uint16_t result = 0;
+    uint8_t c;
+
+    if ((*pos < len) && (ringBufferSpanByte(line, *pos) == '-'))
+    {
+        negative = 1;
+        limit = 32768;
+        (*pos)++;
+    }
+
+    while (*pos < len)
+    {
+        c = ringBufferSpanByte(line, *pos);
+        if ((c < '0') || (c > '9'))
+            break;
+        // the value would not fit, the line is rejected
+        if (result > (limit - (c - '0')) / 10)
+            return 0;
+        result = result * 10 + (c - '0');
+        digits++;
+        (*pos)++;
+    }
+
+    *value = negative ? (int16_t)(0 - result) : (int16_t)result;
+    return digits != 0;
+}
+
+/******************************************************************************
+**                      FUNCTIONS
+*******************************************************************************/
+
+/*
+ *@functions: telemetryInit
+ *@brief    : empty the reading buffer
+ *@param    : none
+ *@return   : none
+ */
+
+void telemetryInit(void)
+{
+    readingFirst = 0;
+    readingCount = 0;
+    readingInFlight = 0;
+    readingDropped = 0;
+    batchSent = 0;
+}
+
+/*
+ *@functions: telemetryParse
+ *@brief    : parse a reading line from the collector
+ *@param    : the line, the TELEMETRY_FIELDS values
+ *@return   : 1 if the line is a valid reading
+ */
+
+uint8_t telemetryParse(const ringBufferSpan *line, int16_t *field)
+{
+    uint8_t pos = sizeof(TELEMETRY_LINE_PREFIX) - 1;
+    uint8_t f;
+
+    if (!ringBufferSpanStartsWith(line, TELEMETRY_LINE_PREFIX))
+        return 0;
+
+    for (f = 0; f < TELEMETRY_FIELDS; f++)
+    {
+        if ((f > 0) && ((pos >= ringBufferSpanLength(line)) ||
+                        (ringBufferSpanByte(line, pos++) != ',')))
+            return 0;
+        if (!parseNumber(line, &pos, &field[f]))
+            return 0;
+    }
+
+    return pos == ringBufferSpanLength(line);
+}
+
+/*
+ *@functions: telemetryAdd
+ *@brief    : queue a reading. When the buffer is full the oldest reading is
+ *            dropped, or the new one while the buffer is being uploaded.
+ *@param    : reception tick, the TELEMETRY_FIELDS values
+ *@return   : none
+ */
+
+void telemetryAdd(uint16_t tick, const int16_t *field)
+{
+    telemetryReading *r;
+    uint8_t f;
+
+    if (readingCount >= TELEMETRY_MAX_READINGS)
+    {
+        readingDropped++;
+        if (readingInFlight != 0)
+            return;
+        readingFirst = (readingFirst + 1) % TELEMETRY_MAX_READINGS;
+        readingCount--;
+    }
+
+    r = &readings[(readingFirst + readingCount) % TELEMETRY_MAX_READINGS];
+    r->tick = tick;
+    for (f = 0; f < TELEMETRY_FIELDS; f++)
+        r->field[f] = field[f];
+    readingCount++;
+}
+
+/*
+ *@functions: telemetryCount
+ *@brief    : number of queued readings
+ *@param    : none
+ *@return   : reading count
+ */
+
+uint8_t telemetryCount(void)
+{
+    return readingCount;
+}
+
+/*
+ *@functions: telemetryReady
+ *@brief    : check if a batch should be uploaded now
+ *@param    : current tick
+ *@return   : 1 if the batch is full or its oldest reading is too old, for
+ *            single updates 1 once THINGSPEAK_UPDATE_INTERVAL has passed
+ */
+
+uint8_t telemetryReady(uint16_t now)
+{
+    if (readingCount == 0)
+        return 0;
+
+#if THINGSPEAK_BULK_UPDATE
+    return (readingCount >= TELEMETRY_BATCH_SIZE) ||
+           ((uint16_t)(now - readings[readingFirst].tick) >= TELEMETRY_MAX_AGE);
+#else
+    // one reading per request, as soon as ThingSpeak takes the next one
+    return !batchSent ||
+           ((uint16_t)(now - batchTick) >= THINGSPEAK_UPDATE_INTERVAL);
+#endif
+}
+
+/*
+ *@functions: telemetryPrepare
+ *@brief    : put all queued readings in the next request, or the oldest
+ *            one for a single update
+ *@param    : current tick
+ *@return   : length of the request, for AT+CIPSEND
+ */
+
+uint16_t telemetryPrepare(uint16_t now)
+{
+    batchTick = now;
+    batchSent = 1;
+
+#if THINGSPEAK_BULK_UPDATE
+    readingInFlight = readingCount;
+
+    countLength = 0;
+    writeBody(countChar);
+    bodyLength = countLength;
+#else
+    readingInFlight = 1;
+#endif
+
+    countLength = 0;
+    telemetryWrite(countChar);
+    return countLength;
+}
+
+/*
+ *@functions: telemetryWrite
+ *@brief    : write the HTTP request prepared by telemetryPrepare
+ *@param    : output
+ *@return   : none
+ */
+
+void telemetryWrite(void (*put)(uint8_t c))
+{
+#if THINGSPEAK_BULK_UPDATE
+    writeString(put, "POST /channels/" THINGSPEAK_CHANNEL_ID
+                     "/bulk_update.csv HTTP/1.1\r\n"
+                     "Host: " THINGSPEAK_HOST "\r\n"
+                     "Connection: keep-alive\r\n"
+                     "Content-Type: application/x-www-form-urlencoded\r\n"
+                     "Content-Length: ");
+    writeNumber(put, bodyLength);
+    writeString(put, "\r\n\r\n");
+    writeBody(put);
+#else
+    writeString(put, "GET /update?api_key=" THINGSPEAK_API_KEY);
+    writeFields(put);
+    writeString(put, " HTTP/1.1\r\n"
+                     "Host: " THINGSPEAK_HOST "\r\n"
+                     "Connection: keep-alive\r\n\r\n");
+#endif
+}
+
+/*
+ *@functions: telemetryAck
+ *@brief    : the server accepted the request (HTTP 2xx), drop its readings
+ *@param    : none
+ *@return   : none
+ */
+
+void telemetryAck(void)
+{
+    readingFirst = (readingFirst + readingInFlight) % TELEMETRY_MAX_READINGS;
+    readingCount -= readingInFlight;
+    readingInFlight = 0;
+}
+
+/*
+ *@functions: telemetryCancel
+ *@brief    : the request failed, keep its readings for the next one
+ *@param    : none
+ *@return   : none
+ */
+
+void telemetryCancel(void)
+{
+    readingInFlight = 0;
+}
+
+/*
+ *@functions: telemetryHttpStatus
+ *@brief    : find the status code of the HTTP response, in the first line
+ *            of the "+IPD,<id>,<length>:HTTP/1.1 200 OK" data
+ *@param    : the line
+ *@return   : status code, 0 if the line is not a status line
+ */
+
+int16_t telemetryHttpStatus(const ringBufferSpan *line)
+{
+    uint8_t len = ringBufferSpanLength(line);
+    uint8_t pos = 0;
+    uint8_t i;
+    int16_t status = 0;
+
+    // the data starts after the ':' of the +IPD header
+    while ((pos < len) && (ringBufferSpanByte(line, pos) != ':'))
+        pos++;
+    pos++;
+
+    for (i = 0; TELEMETRY_HTTP_PREFIX[i] != 0; i++, pos++)
+    {
+        if ((pos >= len) ||
+            (ringBufferSpanByte(line, pos) != TELEMETRY_HTTP_PREFIX[i]))
+            return 0;
+    }
+
+    // minor version, then a space and three digits
+    pos += 2;
+    for (i = 0; i < 3; i++, pos++)
+    {
+        uint8_t c;
+
+        if (pos >= len)
+            return 0;
+        c = ringBufferSpanByte(line, pos);
+        if ((c < '0') || (c > '9'))
+            return 0;
+        status = status * 10 + (c - '0');
+    }
+
+    return status;
+}
+
+/*
+ *@functions: telemetryDropped
+ *@brief    : number of readings lost because the buffer was full
+ *@param    : none
+ *@return   : dropped count
+ */
+
+uint16_t telemetryDropped(void)
+{
+    return readingDropped;
+}
@@ -0,0 +1,83 @@
+/**
+  ******************************************************************************
+  * @file        telemetry.h
+  * @author      OS Team
+  * @version     V0.0.1
+  * @date        19-October-2016
+  * @brief       this file is header file of telemetry.c
+  * @revision
+  ******************************************************************************
+  */
+
+#ifndef		_TELEMETRY_H_
+#define		_TELEMETRY_H_
+
+
+/******************************************************************************
+**                      INCLUDE
+*******************************************************************************/
+#include "stdint.h"
+#include "ringBuffer.h"
+#include "atEngine.h"
+
+
+/******************************************************************************
+**                      DEFIINITIONS
+*******************************************************************************/
+
+// ThingSpeak channel, field1..field3 = temperature, humidity, light. With
+// THINGSPEAK_CHANNEL_ID defined for the channel of the write key, e.g.
+// --define=THINGSPEAK_CHANNEL_ID=\"123456\", the readings are sent in bulk
+// updates. Without it each request is one /update, as before bulk updates.
+#define THINGSPEAK_HOST              "api.thingspeak.com"
+#if !defined(THINGSPEAK_API_KEY)
+#define THINGSPEAK_API_KEY           "WUZZ3SUHKQUCF89U"
+#endif
+#if defined(THINGSPEAK_CHANNEL_ID)
+#define THINGSPEAK_BULK_UPDATE       1
+#else
+#define THINGSPEAK_BULK_UPDATE       0
+#endif
+
+// ThingSpeak drops an /update received less than 15 s after the previous
+// one. A retry of AT+CIPSEND holds a request back by up to 2.5 s, so single
+// updates are prepared at least this far apart.
+#define THINGSPEAK_UPDATE_INTERVAL   AT_MS(18000)
+
+// Fields of one reading
+#define TELEMETRY_FIELDS             3
+
+// Readings kept while waiting for an upload, the oldest is dropped when full
+#define TELEMETRY_MAX_READINGS       12
+
+// Upload when this many readings are queued (bulk updates)...
+#define TELEMETRY_BATCH_SIZE         8
+
+// ...or when the oldest reading has waited this long
+#define TELEMETRY_MAX_AGE            AT_MS(300000UL)
+
+//one reading from the collector
+typedef struct
+{
+    uint16_t tick;                          // atEngineTicks() at reception
+    int16_t field[TELEMETRY_FIELDS];
+}telemetryReading;
+
+
+/******************************************************************************
+**                      FUNCTIONS
+*******************************************************************************/
+
+void     telemetryInit(void);
+uint8_t  telemetryParse(const ringBufferSpan *line, int16_t *field);
+void     telemetryAdd(uint16_t tick, const int16_t *field);
+uint8_t  telemetryCount(void);
+uint8_t  telemetryReady(uint16_t now);
+uint16_t telemetryPrepare(uint16_t now);
+void     telemetryWrite(void (*put)(uint8_t c));
+void     telemetryAck(void);
+void     telemetryCancel(void);
+int16_t  telemetryHttpStatus(const ringBufferSpan *line);
+uint16_t telemetryDropped(void);
+
+#endif
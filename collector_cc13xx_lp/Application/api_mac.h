@@ -53,6 +53,9 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#include "mac_pib_multi.h"
+#include "mac_sec_devices.h"
+
 /*!
  @mainpage TIMAC 2.0 API
 
@@ -92,6 +95,7 @@
  ===============================
  - ApiMac_init()
  - ApiMac_registerCallbacks()
+ - ApiMac_registerCheckPending()
  - ApiMac_processIncoming()
 
  Data Interfaces
@@ -121,6 +125,7 @@
  - ApiMac_mlmeGetReqUint16()
  - ApiMac_mlmeGetReqUint32()
  - ApiMac_mlmeGetReqArray()
+ - ApiMac_mlmeGetReqMulti()
  - ApiMac_mlmeGetFhReqUint8()
  - ApiMac_mlmeGetFhReqUint16()
  - ApiMac_mlmeGetFhReqUint32()
@@ -134,6 +139,7 @@
  - ApiMac_mlmeSetReqUint16()
  - ApiMac_mlmeSetReqUint32()
  - ApiMac_mlmeSetReqArray()
+ - ApiMac_mlmeSetReqMulti()
  - ApiMac_mlmeSetFhReqUint8()
  - ApiMac_mlmeSetFhReqUint16()
  - ApiMac_mlmeSetFhReqUint32()
@@ -146,7 +152,9 @@
  Simplified Security Interfaces
  ===============================
  - ApiMac_secAddDevice()
+ - ApiMac_secAddDevices()
  - ApiMac_secDeleteDevice()
+ - ApiMac_secDeleteDevices()
  - ApiMac_secDeleteKeyAndAssocDevices()
  - ApiMac_secDeleteAllDevices()
  - ApiMac_secGetDefaultSourceKey()
@@ -181,6 +189,9 @@ extern "C"
 /*! IEEE Address Length */
 #define APIMAC_SADDR_EXT_LEN 8
 
+/*! Maximum number of attributes in a batched get or set request */
+#define APIMAC_PIB_MULTI_MAX_ENTRIES MAC_PIB_MULTI_MAX_ENTRIES
+
 /*! Maximum number of key table entries */
 #define APIMAC_MAX_KEY_TABLE_ENTRIES 2
 
@@ -1136,6 +1147,14 @@ typedef enum
 /*! Extended address */
 typedef uint8_t ApiMac_sAddrExt_t[APIMAC_SADDR_EXT_LEN];
 
+/*!
+ One attribute of ApiMac_mlmeGetReqMulti() or ApiMac_mlmeSetReqMulti():
+ attribute is an ApiMac_attribute_* value, status is filled in for each
+ attribute, and for a get len is the size of the pValue buffer on input and
+ the length read on output.
+ */
+typedef macPibMultiEntry_t ApiMac_mlmePibEntry_t;
+
 /*! MAC address type field structure */
 typedef struct
 {
@@ -2271,6 +2290,12 @@ typedef void (*ApiMac_commStatusIndFp_t)(
  */
 typedef void (*ApiMac_pollIndFp_t)(ApiMac_mlmePollInd_t *pPollInd);
 
+/*!
+ Pending Message Check function pointer prototype, returns the number of
+ messages the application holds for polling devices.
+ */
+typedef uint8_t (*ApiMac_checkPendingFp_t)(void);
+
 /*!
  Data Confirmation Callback function pointer prototype
  for the [callback table](@ref ApiMac_callbacks_t)
@@ -2376,6 +2401,19 @@ extern void *ApiMac_init(bool enableFH);
  */
 extern void ApiMac_registerCallbacks(ApiMac_callbacks_t *pCallbacks);
 
+/*!
+ * @brief       Register the function the MAC calls when a data request
+ *              comes in and its own indirect queue has nothing for the
+ *              polling device. A non zero return sets the frame pending bit
+ *              of the acknowledgement and the application sends the data in
+ *              its poll indication callback.  The function is called in the
+ *              context of the MAC, so it should only return a count.
+ *
+ * @param       pCheckPendingFp - function to call, NULL to stop
+ */
+extern void ApiMac_registerCheckPending(
+                ApiMac_checkPendingFp_t pCheckPendingFp);
+
 /*!
  * @brief       Process incoming messages from the MAC stack.  
  */
@@ -2551,6 +2589,24 @@ extern ApiMac_status_t ApiMac_mlmeGetReqArray(
                 ApiMac_attribute_array_t pibAttribute,
                 uint8_t *pValue);
 
+/*!
+ * @brief       This direct execute function retrieves a list of attribute
+ *              values from the MAC PIB with a single request to the MAC.
+ *              Attributes that don't change after init (the extended
+ *              address) are served from a local cache; when every attribute
+ *              is cached no request is sent.
+ *
+ * @param       pEntries - list of attributes, each with its value buffer
+ *                         and buffer size
+ * @param       count - number of entries, at most
+ *                      APIMAC_PIB_MULTI_MAX_ENTRIES
+ *
+ * @return      The first failing status, or
+ *              [ApiMac_status_success](@ref ApiMac_status_success)
+ */
+extern ApiMac_status_t ApiMac_mlmeGetReqMulti(ApiMac_mlmePibEntry_t *pEntries,
+                                              uint8_t count);
+
 /*!
  * @brief       This direct execute function retrieves an attribute value from
  *              the MAC Frequency Hopping PIB.
@@ -2854,6 +2910,20 @@ extern ApiMac_status_t ApiMac_mlmeSetReqArray(
                 ApiMac_attribute_array_t pibAttribute,
                 uint8_t *pValue);
 
+/*!
+ * @brief       This direct execute function sets a list of attribute values
+ *              in the MAC PIB with a single request to the MAC.
+ *
+ * @param       pEntries - list of attributes, each with its value
+ * @param       count - number of entries, at most
+ *                      APIMAC_PIB_MULTI_MAX_ENTRIES
+ *
+ * @return      The first failing status, or
+ *              [ApiMac_status_success](@ref ApiMac_status_success)
+ */
+extern ApiMac_status_t ApiMac_mlmeSetReqMulti(ApiMac_mlmePibEntry_t *pEntries,
+                                              uint8_t count);
+
 /*!
  * @brief       This direct execute function sets an attribute value
  *              in the MAC Frequency Hopping PIB.
@@ -3238,6 +3308,37 @@ extern ApiMac_status_t ApiMac_secAddDevice(ApiMac_secAddDevice_t *pAddDevice);
  */
 extern ApiMac_status_t ApiMac_secDeleteDevice(ApiMac_sAddrExt_t *pExtAddr);
 
+/*!
+ * @brief      Adds a list of MAC device table entries. The devices are sent
+ *             to the MAC in groups, one ICall message per group, instead of
+ *             one message per device. A device that can't be added does not
+ *             stop the others.
+ *
+ * @param      pDevices - devices to add
+ * @param      count - number of devices
+ * @param      pStatus - optional, NULL or an array of count entries that
+ *                       receives the status of each device
+ *
+ * @return     [ApiMac_status_success](@ref ApiMac_status_success) if
+ *             every device was added, otherwise the first failing status.
+ */
+extern ApiMac_status_t ApiMac_secAddDevices(ApiMac_secAddDevice_t *pDevices,
+                                            uint16_t count,
+                                            ApiMac_status_t *pStatus);
+
+/*!
+ * @brief      Removes the MAC device table entries of a list of devices,
+ *             in groups of one ICall message per group.
+ *
+ * @param      pExtAddrs - extended addresses of the devices to remove
+ * @param      count - number of devices
+ *
+ * @return     [ApiMac_status_success](@ref ApiMac_status_success) if
+ *             successful, otherwise the first failing status.
+ */
+extern ApiMac_status_t ApiMac_secDeleteDevices(ApiMac_sAddrExt_t *pExtAddrs,
+                                               uint16_t count);
+
 /*!
  * @brief      Removes the key at the specified key Index and removes all
  *             MAC device table enteries associated with this key. Also
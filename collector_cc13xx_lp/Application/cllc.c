@@ -53,6 +53,7 @@
 #include "cllc.h"
 #include "csf.h"
 #include "util.h"
+#include "fh_hop_table.h"
 
 /******************************************************************************
  Constants and definitions
@@ -330,8 +331,7 @@ void Cllc_init(ApiMac_callbacks_t *pMacCbs, Cllc_callbacks_t *pCllcCbs)
     else
     {
         uint8_t excludeChannels[APIMAC_154G_CHANNEL_BITMAP_SIZ];
-        uint8_t sizeOfChannelMask, idx;
-        uint8_t configChannelMask[] = CONFIG_FH_CHANNEL_MASK;
+        static const uint8_t configChannelMask[] = CONFIG_FH_CHANNEL_MASK;
 
         /* Always set association permit to 1 for FH */
         ApiMac_mlmeSetReqBool(ApiMac_attribute_associatePermit, true);
@@ -347,16 +347,10 @@ void Cllc_init(ApiMac_callbacks_t *pMacCbs, Cllc_callbacks_t *pCllcCbs)
                                  CONFIG_DWELL_TIME);
 
         /* set Exclude Channels */
-        sizeOfChannelMask = sizeof(configChannelMask)/sizeof(uint8_t);
-        if(sizeOfChannelMask > APIMAC_154G_CHANNEL_BITMAP_SIZ)
-        {
-            sizeOfChannelMask = APIMAC_154G_CHANNEL_BITMAP_SIZ;
-        }
-        memset(excludeChannels, 0, APIMAC_154G_CHANNEL_BITMAP_SIZ);
-        for(idx = 0; idx < sizeOfChannelMask; idx++)
-        {
-            excludeChannels[idx] = ~configChannelMask[idx];
-        }
+        FhHopTable_excludeChannels(configChannelMask,
+                                   sizeof(configChannelMask)/sizeof(uint8_t),
+                                   excludeChannels,
+                                   APIMAC_154G_CHANNEL_BITMAP_SIZ);
         ApiMac_mlmeSetFhReqArray(ApiMac_FHAttribute_unicastExcludedChannels,
                                  excludeChannels);
         ApiMac_mlmeSetFhReqArray(ApiMac_FHAttribute_broadcastExcludedChannels,
@@ -720,6 +714,74 @@ ApiMac_status_t Cllc_addSecDevice(uint16_t panID, uint16_t shortAddr,
     }
 }
 
+/*!
+ Add a list of devices to the MAC security device table.
+
+ Public function defined in cllc.h
+ */
+ApiMac_status_t Cllc_addSecDevices(Llc_deviceListItem_t *pDevList,
+                                   uint16_t numDevices)
+{
+    ApiMac_status_t status = ApiMac_status_success;
+
+    if((macSecurity == true) && (numDevices > 0))
+    {
+        ApiMac_secAddDevice_t *pDevices;
+        uint16_t i;
+
+        pDevices = (ApiMac_secAddDevice_t *)Csf_malloc(
+                        sizeof(ApiMac_secAddDevice_t) * numDevices);
+
+        if(pDevices == NULL)
+        {
+            /* Not enough memory for the list, add them one at a time */
+            for(i = 0; i < numDevices; i++)
+            {
+                ApiMac_status_t devStatus;
+
+                devStatus = Cllc_addSecDevice(pDevList[i].devInfo.panID,
+                                              pDevList[i].devInfo.shortAddress,
+                                              &pDevList[i].devInfo.extAddress,
+                                              pDevList[i].rxFrameCounter);
+                if(status == ApiMac_status_success)
+                {
+                    status = devStatus;
+                }
+            }
+            return(status);
+        }
+
+        memset(pDevices, 0, sizeof(ApiMac_secAddDevice_t) * numDevices);
+
+        for(i = 0; i < numDevices; i++)
+        {
+            ApiMac_secAddDevice_t *pDevice = &pDevices[i];
+
+            pDevice->panID = pDevList[i].devInfo.panID;
+            pDevice->shortAddr = pDevList[i].devInfo.shortAddress;
+            memcpy(pDevice->extAddr, pDevList[i].devInfo.extAddress,
+                   sizeof(ApiMac_sAddrExt_t));
+            pDevice->frameCounter = pDevList[i].rxFrameCounter;
+
+            pDevice->exempt = false;
+
+            /* get the key lookup information from the initial loaded key */
+            pDevice->keyIdLookupDataSize = keyIdLookupList[0].lookupDataSize;
+            memcpy(pDevice->keyIdLookupData, keyIdLookupList[0].lookupData,
+                   (APIMAC_MAX_KEY_LOOKUP_LEN));
+
+            pDevice->uniqueDevice = false;
+            pDevice->duplicateDevFlag = false;
+        }
+
+        status = ApiMac_secAddDevices(pDevices, numDevices, NULL);
+
+        Csf_free(pDevices);
+    }
+
+    return(status);
+}
+
 
 /******************************************************************************
  Local Functions
@@ -784,14 +846,22 @@ static void processState(Cllc_coord_states_t state)
 
             networkInfo.fh = CONFIG_FH_ENABLE;
             /* Setup basics */
-            ApiMac_mlmeGetReqUint8(ApiMac_attribute_logicalChannel,
-                                   &networkInfo.channel);
-            ApiMac_mlmeGetReqUint16(ApiMac_attribute_panId,
-                                    &networkInfo.devInfo.panID);
-            ApiMac_mlmeGetReqArray(ApiMac_attribute_extendedAddress,
-                                   (uint8_t*)&networkInfo.devInfo.extAddress);
-            ApiMac_mlmeGetReqUint16(ApiMac_attribute_shortAddress,
-                                    &networkInfo.devInfo.shortAddress);
+            {
+                ApiMac_mlmePibEntry_t pib[] =
+                {
+                    { ApiMac_attribute_logicalChannel, 0, sizeof(uint8_t),
+                      &networkInfo.channel },
+                    { ApiMac_attribute_panId, 0, sizeof(uint16_t),
+                      &networkInfo.devInfo.panID },
+                    { ApiMac_attribute_extendedAddress, 0,
+                      APIMAC_SADDR_EXT_LEN,
+                      &networkInfo.devInfo.extAddress },
+                    { ApiMac_attribute_shortAddress, 0, sizeof(uint16_t),
+                      &networkInfo.devInfo.shortAddress }
+                };
+
+                ApiMac_mlmeGetReqMulti(pib, sizeof(pib) / sizeof(pib[0]));
+            }
 
             if(CONFIG_FH_ENABLE)
             {
@@ -319,6 +319,18 @@ extern ApiMac_status_t Cllc_addSecDevice(uint16_t panID,
                                               ApiMac_sAddrExt_t *pExtAddr,
                                               uint32_t frameCounter);
 
+/*!
+ * @brief      Add a list of devices to the MAC security device table, a
+ *             group of devices per MAC message instead of one.
+ *
+ * @param      pDevList - list of devices
+ * @param      numDevices - number of devices in the list
+ *
+ * @return     first failing status returned by ApiMac_secAddDevices()
+ */
+extern ApiMac_status_t Cllc_addSecDevices(Llc_deviceListItem_t *pDevList,
+                                          uint16_t numDevices);
+
 //*****************************************************************************
 //*****************************************************************************
 
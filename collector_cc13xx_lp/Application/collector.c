@@ -56,6 +56,8 @@
 #include "csf.h"
 #include "smsgs.h"
 #include "collector.h"
+#include "indq.h"
+#include "probe.h"
 
 /******************************************************************************
  Constants and definitions
@@ -81,7 +83,7 @@
 #define INDIRECT_PERSISTENT_TIME 750
 
 /* default MSDU Handle rollover */
-#define MSDU_HANDLE_MAX 0x3F
+#define MSDU_HANDLE_MAX 0x1F
 
 /* App marker in MSDU handle */
 #define APP_MARKER_MSDU_HANDLE 0x80
@@ -89,12 +91,20 @@
 /* App Config request marker for the MSDU handle */
 #define APP_CONFIG_MSDU_HANDLE 0x40
 
+/* App Config epoch marker for the MSDU handle */
+#define APP_EPOCH_MSDU_HANDLE 0x20
+
+/* Broadcast short address */
+#define BROADCAST_SHORT_ADDR 0xFFFF
+
 /* Default configuration frame control */
 #define CONFIG_FRAME_CONTROL (Smsgs_dataFields_tempSensor | \
                               Smsgs_dataFields_lightSensor | \
                               Smsgs_dataFields_humiditySensor | \
                               Smsgs_dataFields_msgStats | \
-                              Smsgs_dataFields_configSettings)
+                              Smsgs_dataFields_configSettings | \
+                              Smsgs_dataFields_configEpoch | \
+                              Smsgs_dataFields_powerStats)
 
 /* Default configuration reporting interval, in milliseconds */
 #define CONFIG_REPORTING_INTERVAL 90000
@@ -102,6 +112,19 @@
 /* Default configuration polling interval, in milliseconds */
 #define CONFIG_POLLING_INTERVAL 6000
 
+/*
+ Default configuration report policy, see Smsgs_reportPolicyField_t. It's
+ sent to every sensor that takes it, a heartbeat interval of 0 turns the
+ sensors' policy off.
+ */
+#define CONFIG_REPORT_TEMP_DEADBAND 0
+#define CONFIG_REPORT_LIGHT_DEADBAND 0
+#define CONFIG_REPORT_HUMIDITY_DEADBAND 0
+#define CONFIG_REPORT_HEARTBEAT_INTERVAL 0
+
+/* Number of times a new config epoch is broadcast, CONFIG_DELAY apart */
+#define CONFIG_EPOCH_BROADCASTS 3
+
 /* Delay for config request retry in busy network */
 #define CONFIG_DELAY 1000
 #define CONFIG_RESPONSE_DELAY 3*CONFIG_DELAY
@@ -114,6 +137,9 @@
 #define ASSOC_CONFIG_SENT       0x0100    /* Config Req sent */
 #define ASSOC_CONFIG_RSP        0x0200    /* Config Rsp received */
 #define ASSOC_CONFIG_MASK       0x0300    /* Config mask */
+#define ASSOC_EPOCH_STALE       0x0400    /* Config epoch not applied */
+#define ASSOC_CONFIG_POLICY     0x0800    /* Config Req had the policy */
+#define ASSOC_REPORT_POLICY     0x0080    /* Takes the report policy */
 #define ASSOC_TRACKING_SENT     0x1000    /* Tracking Req sent */
 #define ASSOC_TRACKING_RSP      0x2000    /* Tracking Rsp received */
 #define ASSOC_TRACKING_RETRY    0x4000    /* Tracking Req retried */
@@ -147,6 +173,15 @@ STATIC uint16_t devicePanId = 0xFFFF;
 /*! Device's Outgoing MSDU Handle values */
 STATIC uint8_t deviceTxMsduHandle = 0;
 
+/*!
+ Configuration sent to the devices. The epoch is 0 until the configuration
+ is changed with Collector_setConfig().
+ */
+STATIC Smsgs_configEpochMsg_t fleetConfig;
+
+/*! Broadcasts of the config epoch left to send */
+STATIC uint8_t epochBroadcasts = 0;
+
 STATIC bool fhEnabled = false;
 
 /******************************************************************************
@@ -165,12 +200,26 @@ static void processConfigResponse(ApiMac_mcpsDataInd_t *pDataInd);
 static void processTrackingResponse(ApiMac_mcpsDataInd_t *pDataInd);
 static void processToggleLedResponse(ApiMac_mcpsDataInd_t *pDataInd);
 static void processSensorData(ApiMac_mcpsDataInd_t *pDataInd);
+static void processSensorBatch(ApiMac_mcpsDataInd_t *pDataInd);
+static uint8_t *parseMsgStats(uint8_t *pBuf, Smsgs_msgStatsField_t *pStats);
+static uint8_t *parsePowerStats(uint8_t *pBuf,
+                                Smsgs_powerStatsField_t *pStats);
+static uint8_t *parseConfigSettings(uint8_t *pBuf,
+                                    Smsgs_configSettingsField_t *pSettings);
 static Cllc_associated_devices_t *findDevice(ApiMac_sAddr_t *pAddr);
 static Cllc_associated_devices_t *findDeviceStatusBit(uint16_t mask, uint16_t statusBit);
 static uint8_t getMsduHandle(Smsgs_cmdIds_t msgType);
-static void sendMsg(Smsgs_cmdIds_t type, uint16_t dstShortAddr, bool rxOnIdle,
-                    uint16_t len,
-                    uint8_t *pData);
+static Indq_priority_t getMsgPriority(Smsgs_cmdIds_t msgType);
+static ApiMac_status_t sendMsg(Smsgs_cmdIds_t type, uint16_t dstShortAddr,
+                               bool rxOnIdle, uint16_t len, uint8_t *pData);
+static void sendDataReq(uint16_t dstShortAddr, uint8_t msduHandle,
+                        bool indirect, bool pendingBit, uint16_t len,
+                        uint8_t *pData);
+static void indqDroppedCB(uint8_t msduHandle, ApiMac_status_t status);
+static uint16_t buildConfigEpoch(uint8_t *pBuf);
+static void broadcastConfigEpoch(void);
+static void sendConfigEpoch(Cllc_associated_devices_t *pDev);
+static void checkConfigEpoch(ApiMac_sAddr_t *pSrcAddr, uint8_t epoch);
 static void generateConfigRequests(void);
 static void generateTrackingRequests(void);
 static void sendTrackingRequest(Cllc_associated_devices_t *pDev);
@@ -248,6 +297,19 @@ void Collector_init(void)
     /* Initialize the collector's statistics */
     memset(&Collector_statistics, 0, sizeof(Collector_statistics_t));
 
+    /* Initialize the configuration sent to the devices */
+    memset(&fleetConfig, 0, sizeof(Smsgs_configEpochMsg_t));
+    fleetConfig.cmdId = Smsgs_cmdIds_configEpoch;
+    fleetConfig.frameControl = CONFIG_FRAME_CONTROL;
+    fleetConfig.reportingInterval = CONFIG_REPORTING_INTERVAL;
+    fleetConfig.pollingInterval = CONFIG_POLLING_INTERVAL;
+    fleetConfig.reportPolicy.tempDeadband = CONFIG_REPORT_TEMP_DEADBAND;
+    fleetConfig.reportPolicy.lightDeadband = CONFIG_REPORT_LIGHT_DEADBAND;
+    fleetConfig.reportPolicy.humidityDeadband =
+                    CONFIG_REPORT_HUMIDITY_DEADBAND;
+    fleetConfig.reportPolicy.heartbeatInterval =
+                    CONFIG_REPORT_HEARTBEAT_INTERVAL;
+
     /* Initialize the MAC */
     sem = ApiMac_init(CONFIG_FH_ENABLE);
 
@@ -257,14 +319,42 @@ void Collector_init(void)
     /* Register the MAC Callbacks */
     ApiMac_registerCallbacks(&Collector_macCallbacks);
 
+    /* Hold the messages for sleepy devices until they poll */
+    Indq_init(indqDroppedCB);
+    ApiMac_registerCheckPending(Indq_checkPending);
+
     /* Initialize the platform specific functions */
     Csf_init(sem);
 
-    /* Set the indirect persistent timeout */
-    ApiMac_mlmeSetReqUint16(ApiMac_attribute_transactionPersistenceTime,
-                            INDIRECT_PERSISTENT_TIME);
-    ApiMac_mlmeSetReqUint8(ApiMac_attribute_phyTransmitPowerSigned,
-                           (uint8_t)CONFIG_TRANSMIT_POWER);
+    /*
+     Pick up the configuration of all of the devices and its epoch where it
+     was left, the devices that applied it ignore an epoch they already have
+     */
+    {
+        Smsgs_configEpochMsg_t savedConfig;
+
+        if(Csf_getFleetConfig(&savedConfig)
+           && (savedConfig.cmdId == Smsgs_cmdIds_configEpoch))
+        {
+            memcpy(&fleetConfig, &savedConfig,
+                   sizeof(Smsgs_configEpochMsg_t));
+        }
+    }
+
+    /* Set the indirect persistent timeout and the transmit power */
+    {
+        uint16_t persistenceTime = INDIRECT_PERSISTENT_TIME;
+        uint8_t txPower = (uint8_t)CONFIG_TRANSMIT_POWER;
+        ApiMac_mlmePibEntry_t pib[] =
+        {
+            { ApiMac_attribute_transactionPersistenceTime, 0,
+              sizeof(uint16_t), &persistenceTime },
+            { ApiMac_attribute_phyTransmitPowerSigned, 0,
+              sizeof(uint8_t), &txPower }
+        };
+
+        ApiMac_mlmeSetReqMulti(pib, sizeof(pib) / sizeof(pib[0]));
+    }
 
     /* Initialize the app clocks */
     initializeClocks();
@@ -338,10 +428,10 @@ void Collector_process(void)
 
  Public function defined in collector.h
  */
-Collector_status_t Collector_sendConfigRequest(ApiMac_sAddr_t *pDstAddr,
-                                               uint16_t frameControl,
-                                               uint32_t reportingInterval,
-                                               uint32_t pollingInterval)
+Collector_status_t Collector_sendConfigRequest(
+                ApiMac_sAddr_t *pDstAddr, uint16_t frameControl,
+                uint32_t reportingInterval, uint32_t pollingInterval,
+                Smsgs_reportPolicyField_t *pReportPolicy)
 {
     Collector_status_t status = Collector_status_invalid_state;
 
@@ -353,8 +443,9 @@ Collector_status_t Collector_sendConfigRequest(ApiMac_sAddr_t *pDstAddr,
         /* Is the device a known device? */
         if(Csf_getDevice(pDstAddr, &item))
         {
-            uint8_t buffer[SMSGS_CONFIG_REQUEST_MSG_LENGTH];
+            uint8_t buffer[SMSGS_CONFIG_REQUEST_POLICY_MSG_LENGTH];
             uint8_t *pBuf = buffer;
+            uint16_t len = SMSGS_CONFIG_REQUEST_MSG_LENGTH;
 
             /* Build the message */
             *pBuf++ = (uint8_t)Smsgs_cmdIds_configReq;
@@ -367,14 +458,30 @@ Collector_status_t Collector_sendConfigRequest(ApiMac_sAddr_t *pDstAddr,
             *pBuf++ = Util_breakUint32(pollingInterval, 0);
             *pBuf++ = Util_breakUint32(pollingInterval, 1);
             *pBuf++ = Util_breakUint32(pollingInterval, 2);
-            *pBuf = Util_breakUint32(pollingInterval, 3);
-
-            sendMsg(Smsgs_cmdIds_configReq, item.devInfo.shortAddress,
-                    item.capInfo.rxOnWhenIdle,
-                    (SMSGS_CONFIG_REQUEST_MSG_LENGTH),
-                    buffer);
-            status = Collector_status_success;
-            Collector_statistics.configRequestAttempts++;
+            *pBuf++ = Util_breakUint32(pollingInterval, 3);
+
+            if(pReportPolicy != NULL)
+            {
+                pBuf = Util_bufferUint16(pBuf, pReportPolicy->tempDeadband);
+                pBuf = Util_bufferUint16(pBuf, pReportPolicy->lightDeadband);
+                pBuf = Util_bufferUint16(pBuf,
+                                         pReportPolicy->humidityDeadband);
+                pBuf = Util_bufferUint32(pBuf,
+                                         pReportPolicy->heartbeatInterval);
+                len = SMSGS_CONFIG_REQUEST_POLICY_MSG_LENGTH;
+            }
+
+            if(sendMsg(Smsgs_cmdIds_configReq, item.devInfo.shortAddress,
+                       item.capInfo.rxOnWhenIdle, len, buffer)
+               == ApiMac_status_success)
+            {
+                status = Collector_status_success;
+                Collector_statistics.configRequestAttempts++;
+            }
+            else
+            {
+                status = Collector_status_noResources;
+            }
             /* set timer for retry in case response is not received */
             Csf_setConfigClock(CONFIG_DELAY);
         }
@@ -390,12 +497,82 @@ Collector_status_t Collector_sendConfigRequest(ApiMac_sAddr_t *pDstAddr,
  */
 void Collector_updateStats( void )
 {
+    ApiMac_mlmePibEntry_t pib[] =
+    {
+        { ApiMac_attribute_diagRxSecureFail, 0, sizeof(uint32_t),
+          &Collector_statistics.rxDecryptFailures },
+        { ApiMac_attribute_diagTxSecureFail, 0, sizeof(uint32_t),
+          &Collector_statistics.txEncryptFailures }
+    };
+
     /* update the stats from the MAC */
-    ApiMac_mlmeGetReqUint32(ApiMac_attribute_diagRxSecureFail,
-                            &Collector_statistics.rxDecryptFailures);
+    ApiMac_mlmeGetReqMulti(pib, sizeof(pib) / sizeof(pib[0]));
+}
+
+/*!
+ Change the configuration of all of the devices.
+
+ Public function defined in collector.h
+ */
+Collector_status_t Collector_setConfig(uint16_t frameControl,
+                                       uint32_t reportingInterval,
+                                       uint32_t pollingInterval,
+                                       Smsgs_reportPolicyField_t *pReportPolicy)
+{
+    int x;
+
+    /* Are we in the right state? */
+    if(cllcState < Cllc_states_started)
+    {
+        return (Collector_status_invalid_state);
+    }
 
-    ApiMac_mlmeGetReqUint32(ApiMac_attribute_diagTxSecureFail,
-                            &Collector_statistics.txEncryptFailures);
+    fleetConfig.frameControl = frameControl;
+    fleetConfig.reportingInterval = reportingInterval;
+    fleetConfig.pollingInterval = pollingInterval;
+    if(pReportPolicy != NULL)
+    {
+        memcpy(&fleetConfig.reportPolicy, pReportPolicy,
+               sizeof(Smsgs_reportPolicyField_t));
+    }
+
+    /* New epoch, 0 means none */
+    fleetConfig.epoch++;
+    if(fleetConfig.epoch == 0)
+    {
+        fleetConfig.epoch = 1;
+    }
+
+    /*
+     The devices that are awake apply the broadcast, a sleepy device is sent
+     the epoch when it next polls and any other device when it reports an
+     older epoch.
+     */
+    for(x = 0; x < CONFIG_MAX_DEVICES; x++)
+    {
+        if(Cllc_associatedDevList[x].shortAddr != CSF_INVALID_SHORT_ADDR)
+        {
+            Cllc_associatedDevList[x].status |= ASSOC_EPOCH_STALE;
+        }
+    }
+
+    /* Keep the epoch across a reset, the devices hold on to theirs */
+    Csf_updateFleetConfig(&fleetConfig);
+
+    epochBroadcasts = CONFIG_EPOCH_BROADCASTS;
+    broadcastConfigEpoch();
+
+    return (Collector_status_success);
+}
+
+/*!
+ Get the configuration of all of the devices.
+
+ Public function defined in collector.h
+ */
+void Collector_getConfig(Smsgs_configEpochMsg_t *pConfig)
+{
+    memcpy(pConfig, &fleetConfig, sizeof(Smsgs_configEpochMsg_t));
 }
 
 /*!
@@ -420,12 +597,17 @@ Collector_status_t Collector_sendToggleLedRequest(ApiMac_sAddr_t *pDstAddr)
             /* Build the message */
             buffer[0] = (uint8_t)Smsgs_cmdIds_toggleLedReq;
 
-            sendMsg(Smsgs_cmdIds_toggleLedReq, item.devInfo.shortAddress,
-                    item.capInfo.rxOnWhenIdle,
-                    SMSGS_TOGGLE_LED_REQUEST_MSG_LEN,
-                    buffer);
-
-            status = Collector_status_success;
+            if(sendMsg(Smsgs_cmdIds_toggleLedReq, item.devInfo.shortAddress,
+                       item.capInfo.rxOnWhenIdle,
+                       SMSGS_TOGGLE_LED_REQUEST_MSG_LEN,
+                       buffer) == ApiMac_status_success)
+            {
+                status = Collector_status_success;
+            }
+            else
+            {
+                status = Collector_status_noResources;
+            }
         }
         else
         {
@@ -560,7 +742,15 @@ static void dataCnfCB(ApiMac_mcpsDataCnf_t *pDataCnf)
     if(pDataCnf->msduHandle & APP_MARKER_MSDU_HANDLE)
     {
         /* What message type was the original request? */
-        if(pDataCnf->msduHandle & APP_CONFIG_MSDU_HANDLE)
+        if(pDataCnf->msduHandle & APP_EPOCH_MSDU_HANDLE)
+        {
+            /* Config Epoch, the next sensor data tells if it was applied */
+            if(pDataCnf->status == ApiMac_status_success)
+            {
+                Collector_statistics.configEpochSent++;
+            }
+        }
+        else if(pDataCnf->msduHandle & APP_CONFIG_MSDU_HANDLE)
         {
             /* Config Request */
             Cllc_associated_devices_t *pDev;
@@ -684,6 +874,10 @@ static void dataIndCB(ApiMac_mcpsDataInd_t *pDataInd)
                 processSensorData(pDataInd);
                 break;
 
+            case Smsgs_cmdIds_sensorBatch:
+                processSensorBatch(pDataInd);
+                break;
+
             default:
                 /* Should not receive other messages */
                 break;
@@ -725,13 +919,10 @@ static void processStartEvent(void)
                 for(i = 0; i < numDevices; i++, pItem++)
                 {
                     Csf_getDeviceItem(i, pItem);
-
-                    /* Add device to security device table */
-                    Cllc_addSecDevice(pItem->devInfo.panID,
-                                      pItem->devInfo.shortAddress,
-                                      &pItem->devInfo.extAddress,
-                                      pItem->rxFrameCounter);
                 }
+
+                /* Add the devices to the security device table */
+                Cllc_addSecDevices(pDevList, numDevices);
             }
             else
             {
@@ -799,6 +990,14 @@ static void processConfigResponse(ApiMac_mcpsDataInd_t *pDataInd)
             /* Clear the sent flag and set the response flag */
             pDev->status &= ~ASSOC_CONFIG_SENT;
             pDev->status |= ASSOC_CONFIG_RSP;
+
+            /* It was found to take the report policy after the request */
+            if((pDev->status & (ASSOC_REPORT_POLICY | ASSOC_CONFIG_POLICY))
+               == ASSOC_REPORT_POLICY)
+            {
+                pDev->status &= ~ASSOC_CONFIG_RSP;
+                processConfigRetry();
+            }
         }
 
         /* report the config response */
@@ -876,6 +1075,7 @@ static void processSensorData(ApiMac_mcpsDataInd_t *pDataInd)
 {
     Smsgs_sensorMsg_t sensorData;
     uint8_t *pBuf = pDataInd->msdu.p;
+    PROBE_BEGIN(probeStart);
 
     memset(&sensorData, 0, sizeof(Smsgs_sensorMsg_t));
 
@@ -912,80 +1112,321 @@ static void processSensorData(ApiMac_mcpsDataInd_t *pDataInd)
 
     if(sensorData.frameControl & Smsgs_dataFields_msgStats)
     {
-        sensorData.msgStats.joinAttempts = Util_buildUint16(pBuf[0], pBuf[1]);
-        pBuf += 2;
-        sensorData.msgStats.joinFails = Util_buildUint16(pBuf[0], pBuf[1]);
-        pBuf += 2;
-        sensorData.msgStats.msgsAttempted = Util_buildUint16(pBuf[0], pBuf[1]);
-        pBuf += 2;
-        sensorData.msgStats.msgsSent = Util_buildUint16(pBuf[0], pBuf[1]);
-        pBuf += 2;
-        sensorData.msgStats.trackingRequests = Util_buildUint16(pBuf[0],
-                                                                pBuf[1]);
-        pBuf += 2;
-        sensorData.msgStats.trackingResponseAttempts = Util_buildUint16(
-                        pBuf[0],
-                        pBuf[1]);
-        pBuf += 2;
-        sensorData.msgStats.trackingResponseSent = Util_buildUint16(pBuf[0],
-                                                                    pBuf[1]);
-        pBuf += 2;
-        sensorData.msgStats.configRequests = Util_buildUint16(pBuf[0],
-                                                              pBuf[1]);
-        pBuf += 2;
-        sensorData.msgStats.configResponseAttempts = Util_buildUint16(
-                        pBuf[0],
-                        pBuf[1]);
-        pBuf += 2;
-        sensorData.msgStats.configResponseSent = Util_buildUint16(pBuf[0],
-                                                                  pBuf[1]);
-        pBuf += 2;
-        sensorData.msgStats.channelAccessFailures = Util_buildUint16(pBuf[0],
-                                                                     pBuf[1]);
-        pBuf += 2;
-        sensorData.msgStats.macAckFailures = Util_buildUint16(pBuf[0], pBuf[1]);
-        pBuf += 2;
-        sensorData.msgStats.otherDataRequestFailures = Util_buildUint16(
-                        pBuf[0],
-                        pBuf[1]);
-        pBuf += 2;
-        sensorData.msgStats.syncLossIndications = Util_buildUint16(pBuf[0],
-                                                                   pBuf[1]);
-        pBuf += 2;
-        sensorData.msgStats.rxDecryptFailures = Util_buildUint16(pBuf[0],
-                                                                 pBuf[1]);
-        pBuf += 2;
-        sensorData.msgStats.txEncryptFailures = Util_buildUint16(pBuf[0],
-                                                                 pBuf[1]);
-        pBuf += 2;
-        sensorData.msgStats.resetCount = Util_buildUint16(pBuf[0],
-                                                          pBuf[1]);
-        pBuf += 2;
-        sensorData.msgStats.lastResetReason = Util_buildUint16(pBuf[0],
-                                                               pBuf[1]);
-        pBuf += 2;
+        pBuf = parseMsgStats(pBuf, &sensorData.msgStats);
     }
 
     if(sensorData.frameControl & Smsgs_dataFields_configSettings)
     {
-        sensorData.configSettings.reportingInterval = Util_buildUint32(pBuf[0],
-                                                                       pBuf[1],
-                                                                       pBuf[2],
-                                                                       pBuf[3]);
-        pBuf += 4;
-        sensorData.configSettings.pollingInterval = Util_buildUint32(pBuf[0],
-                                                                     pBuf[1],
-                                                                     pBuf[2],
-                                                                     pBuf[3]);
+        pBuf = parseConfigSettings(pBuf, &sensorData.configSettings);
+    }
+
+    if(sensorData.frameControl & Smsgs_dataFields_configEpoch)
+    {
+        sensorData.configEpoch = *pBuf++;
+        checkConfigEpoch(&pDataInd->srcAddr, sensorData.configEpoch);
+    }
+
+    if(sensorData.frameControl & Smsgs_dataFields_powerStats)
+    {
+        pBuf = parsePowerStats(pBuf, &sensorData.powerStats);
     }
 
     Collector_statistics.sensorMessagesReceived++;
 
     /* Report the sensor data */
     Csf_deviceSensorDataUpdate(&pDataInd->srcAddr, pDataInd->rssi,
-                               &sensorData);
+                               &sensorData, 0);
 
     processDataRetry(&(pDataInd->srcAddr));
+
+    PROBE_END(Probe_id_sensorData, probeStart);
+}
+
+/*!
+ * @brief      Process the Sensor Batch message. Each sample is reported as a
+ *             Sensor Data message, oldest first, with its age from the
+ *             sample intervals; the message statistics, config settings,
+ *             config epoch and power statistics, when included, go with the
+ *             last sample. The extended address isn't in the message, it's
+ *             taken from the device list.
+ *
+ * @param      pDataInd - pointer to the data indication information
+ */
+static void processSensorBatch(ApiMac_mcpsDataInd_t *pDataInd)
+{
+    Smsgs_sensorMsg_t sensorData;
+    Llc_deviceListItem_t item;
+    uint8_t *pBuf = pDataInd->msdu.p;
+    uint8_t *pIntervals;
+    uint8_t *pTemp = NULL;
+    uint8_t *pLight = NULL;
+    uint8_t *pHumidity = NULL;
+    uint16_t frameControl;
+    uint16_t len;
+    uint32_t sampleAge = 0;
+    uint8_t numSamples;
+    uint8_t idx;
+
+    if(pDataInd->msdu.len < SMSGS_BASIC_SENSOR_BATCH_LEN)
+    {
+        return;
+    }
+
+    /* Skip past the command ID */
+    pBuf++;
+
+    frameControl = Util_buildUint16(pBuf[0], pBuf[1]);
+    pBuf += 2;
+    numSamples = *pBuf++;
+
+    if((numSamples == 0) || (numSamples > SMSGS_SENSOR_BATCH_MAX_SAMPLES))
+    {
+        return;
+    }
+
+    /* The length has to match the fields, the samples are read in place */
+    len = SMSGS_BASIC_SENSOR_BATCH_LEN
+          + ((numSamples - 1) * SMSGS_SENSOR_BATCH_INTERVAL_LEN);
+    if(frameControl & Smsgs_dataFields_tempSensor)
+    {
+        len += numSamples * SMSGS_SENSOR_TEMP_LEN;
+    }
+    if(frameControl & Smsgs_dataFields_lightSensor)
+    {
+        len += numSamples * SMSGS_SENSOR_LIGHT_LEN;
+    }
+    if(frameControl & Smsgs_dataFields_humiditySensor)
+    {
+        len += numSamples * SMSGS_SENSOR_HUMIDITY_LEN;
+    }
+    if(frameControl & Smsgs_dataFields_msgStats)
+    {
+        len += SMSGS_SENSOR_MSG_STATS_LEN;
+    }
+    if(frameControl & Smsgs_dataFields_configSettings)
+    {
+        len += SMSGS_SENSOR_CONFIG_SETTINGS_LEN;
+    }
+    if(frameControl & Smsgs_dataFields_configEpoch)
+    {
+        len += SMSGS_SENSOR_CONFIG_EPOCH_LEN;
+    }
+    if(frameControl & Smsgs_dataFields_powerStats)
+    {
+        len += SMSGS_SENSOR_POWER_STATS_LEN;
+    }
+    if(pDataInd->msdu.len != len)
+    {
+        return;
+    }
+
+    /* The first sample's age is the sum of the intervals */
+    pIntervals = pBuf;
+    for(idx = 0; idx < (numSamples - 1); idx++)
+    {
+        sampleAge += Util_buildUint16(pBuf[0], pBuf[1]);
+        pBuf += SMSGS_SENSOR_BATCH_INTERVAL_LEN;
+    }
+
+    if(frameControl & Smsgs_dataFields_tempSensor)
+    {
+        pTemp = pBuf;
+        pBuf += numSamples * SMSGS_SENSOR_TEMP_LEN;
+    }
+    if(frameControl & Smsgs_dataFields_lightSensor)
+    {
+        pLight = pBuf;
+        pBuf += numSamples * SMSGS_SENSOR_LIGHT_LEN;
+    }
+    if(frameControl & Smsgs_dataFields_humiditySensor)
+    {
+        pHumidity = pBuf;
+        pBuf += numSamples * SMSGS_SENSOR_HUMIDITY_LEN;
+    }
+
+    memset(&sensorData, 0, sizeof(Smsgs_sensorMsg_t));
+    sensorData.cmdId = Smsgs_cmdIds_sensorData;
+
+    if(pDataInd->srcAddr.addrMode == ApiMac_addrType_extended)
+    {
+        memcpy(sensorData.extAddress, pDataInd->srcAddr.addr.extAddr,
+               SMGS_SENSOR_EXTADDR_LEN);
+    }
+    else if((findDevice(&pDataInd->srcAddr) != NULL)
+            && Csf_getDevice(&pDataInd->srcAddr, &item))
+    {
+        memcpy(sensorData.extAddress, item.devInfo.extAddress,
+               SMGS_SENSOR_EXTADDR_LEN);
+    }
+
+    if(frameControl & Smsgs_dataFields_msgStats)
+    {
+        pBuf = parseMsgStats(pBuf, &sensorData.msgStats);
+    }
+    if(frameControl & Smsgs_dataFields_configSettings)
+    {
+        pBuf = parseConfigSettings(pBuf, &sensorData.configSettings);
+    }
+    if(frameControl & Smsgs_dataFields_configEpoch)
+    {
+        sensorData.configEpoch = *pBuf++;
+        checkConfigEpoch(&pDataInd->srcAddr, sensorData.configEpoch);
+    }
+    if(frameControl & Smsgs_dataFields_powerStats)
+    {
+        pBuf = parsePowerStats(pBuf, &sensorData.powerStats);
+    }
+
+    Collector_statistics.sensorMessagesReceived++;
+
+    for(idx = 0; idx < numSamples; idx++)
+    {
+        sensorData.frameControl = frameControl;
+        if(idx < (numSamples - 1))
+        {
+            sensorData.frameControl &= ~(Smsgs_dataFields_msgStats
+                            | Smsgs_dataFields_configSettings
+                            | Smsgs_dataFields_configEpoch
+                            | Smsgs_dataFields_powerStats);
+        }
+
+        if(pTemp != NULL)
+        {
+            sensorData.tempSensor.ambienceTemp = Util_buildUint16(pTemp[0],
+                                                                  pTemp[1]);
+            sensorData.tempSensor.objectTemp = Util_buildUint16(pTemp[2],
+                                                                pTemp[3]);
+            pTemp += SMSGS_SENSOR_TEMP_LEN;
+        }
+        if(pLight != NULL)
+        {
+            sensorData.lightSensor.rawData = Util_buildUint16(pLight[0],
+                                                              pLight[1]);
+            pLight += SMSGS_SENSOR_LIGHT_LEN;
+        }
+        if(pHumidity != NULL)
+        {
+            sensorData.humiditySensor.temp = Util_buildUint16(pHumidity[0],
+                                                              pHumidity[1]);
+            sensorData.humiditySensor.humidity = Util_buildUint16(
+                            pHumidity[2], pHumidity[3]);
+            pHumidity += SMSGS_SENSOR_HUMIDITY_LEN;
+        }
+
+        /* Report the sensor data */
+        Csf_deviceSensorDataUpdate(&pDataInd->srcAddr, pDataInd->rssi,
+                                   &sensorData, sampleAge);
+
+        if(idx < (numSamples - 1))
+        {
+            sampleAge -= Util_buildUint16(pIntervals[0], pIntervals[1]);
+            pIntervals += SMSGS_SENSOR_BATCH_INTERVAL_LEN;
+        }
+    }
+
+    processDataRetry(&(pDataInd->srcAddr));
+}
+
+/*!
+ * @brief      Parse the message statistics field of a sensor message.
+ *
+ * @param      pBuf - pointer to the field
+ * @param      pStats - filled in with the message statistics
+ *
+ * @return     pointer to the byte after the field
+ */
+static uint8_t *parseMsgStats(uint8_t *pBuf, Smsgs_msgStatsField_t *pStats)
+{
+    pStats->joinAttempts = Util_buildUint16(pBuf[0], pBuf[1]);
+    pBuf += 2;
+    pStats->joinFails = Util_buildUint16(pBuf[0], pBuf[1]);
+    pBuf += 2;
+    pStats->msgsAttempted = Util_buildUint16(pBuf[0], pBuf[1]);
+    pBuf += 2;
+    pStats->msgsSent = Util_buildUint16(pBuf[0], pBuf[1]);
+    pBuf += 2;
+    pStats->trackingRequests = Util_buildUint16(pBuf[0], pBuf[1]);
+    pBuf += 2;
+    pStats->trackingResponseAttempts = Util_buildUint16(pBuf[0], pBuf[1]);
+    pBuf += 2;
+    pStats->trackingResponseSent = Util_buildUint16(pBuf[0], pBuf[1]);
+    pBuf += 2;
+    pStats->configRequests = Util_buildUint16(pBuf[0], pBuf[1]);
+    pBuf += 2;
+    pStats->configResponseAttempts = Util_buildUint16(pBuf[0], pBuf[1]);
+    pBuf += 2;
+    pStats->configResponseSent = Util_buildUint16(pBuf[0], pBuf[1]);
+    pBuf += 2;
+    pStats->channelAccessFailures = Util_buildUint16(pBuf[0], pBuf[1]);
+    pBuf += 2;
+    pStats->macAckFailures = Util_buildUint16(pBuf[0], pBuf[1]);
+    pBuf += 2;
+    pStats->otherDataRequestFailures = Util_buildUint16(pBuf[0], pBuf[1]);
+    pBuf += 2;
+    pStats->syncLossIndications = Util_buildUint16(pBuf[0], pBuf[1]);
+    pBuf += 2;
+    pStats->rxDecryptFailures = Util_buildUint16(pBuf[0], pBuf[1]);
+    pBuf += 2;
+    pStats->txEncryptFailures = Util_buildUint16(pBuf[0], pBuf[1]);
+    pBuf += 2;
+    pStats->resetCount = Util_buildUint16(pBuf[0], pBuf[1]);
+    pBuf += 2;
+    pStats->lastResetReason = Util_buildUint16(pBuf[0], pBuf[1]);
+    pBuf += 2;
+
+    return (pBuf);
+}
+
+/*!
+ * @brief      Parse the power statistics field of a sensor message.
+ *
+ * @param      pBuf - pointer to the field
+ * @param      pStats - filled in with the power statistics
+ *
+ * @return     pointer to the byte after the field
+ */
+static uint8_t *parsePowerStats(uint8_t *pBuf,
+                                Smsgs_powerStatsField_t *pStats)
+{
+    pStats->stackActive = Util_buildUint16(pBuf[0], pBuf[1]);
+    pBuf += 2;
+    pStats->appActive = Util_buildUint16(pBuf[0], pBuf[1]);
+    pBuf += 2;
+    pStats->otherActive = Util_buildUint16(pBuf[0], pBuf[1]);
+    pBuf += 2;
+    pStats->idleSleep = Util_buildUint16(pBuf[0], pBuf[1]);
+    pBuf += 2;
+    pStats->standbySleep = Util_buildUint16(pBuf[0], pBuf[1]);
+    pBuf += 2;
+    pStats->timerWakeups = Util_buildUint16(pBuf[0], pBuf[1]);
+    pBuf += 2;
+    pStats->radioWakeups = Util_buildUint16(pBuf[0], pBuf[1]);
+    pBuf += 2;
+    pStats->otherWakeups = Util_buildUint16(pBuf[0], pBuf[1]);
+    pBuf += 2;
+
+    return (pBuf);
+}
+
+/*!
+ * @brief      Parse the config settings field of a sensor message.
+ *
+ * @param      pBuf - pointer to the field
+ * @param      pSettings - filled in with the config settings
+ *
+ * @return     pointer to the byte after the field
+ */
+static uint8_t *parseConfigSettings(uint8_t *pBuf,
+                                    Smsgs_configSettingsField_t *pSettings)
+{
+    pSettings->reportingInterval = Util_buildUint32(pBuf[0], pBuf[1],
+                                                    pBuf[2], pBuf[3]);
+    pBuf += 4;
+    pSettings->pollingInterval = Util_buildUint32(pBuf[0], pBuf[1],
+                                                  pBuf[2], pBuf[3]);
+    pBuf += 4;
+
+    return (pBuf);
 }
 
 /*!
@@ -1061,7 +1502,8 @@ static Cllc_associated_devices_t *findDeviceStatusBit(uint16_t mask, uint16_t st
  *             The MSDU handle has 3 parts:<BR>
  *             - The MSBit(7), when set means the the application sent the message
  *             - Bit 6, when set means that the app message is a config request
- *             - Bits 0-5, used as a message counter that rolls over.
+ *             - Bit 5, when set means that the app message is a config epoch
+ *             - Bits 0-4, used as a message counter that rolls over.
  *
  * @param      msgType - message command id needed
  *
@@ -1089,22 +1531,94 @@ static uint8_t getMsduHandle(Smsgs_cmdIds_t msgType)
     {
         msduHandle |= APP_CONFIG_MSDU_HANDLE;
     }
+    else if(msgType == Smsgs_cmdIds_configEpoch)
+    {
+        msduHandle |= APP_EPOCH_MSDU_HANDLE;
+    }
 
     return (msduHandle);
 }
 
 /*!
- * @brief      Send MAC data request
+ * @brief      Get the priority of a message held for a sleepy device
+ *
+ * @param      msgType - message command id
+ *
+ * @return     priority
+ */
+static Indq_priority_t getMsgPriority(Smsgs_cmdIds_t msgType)
+{
+    if((msgType == Smsgs_cmdIds_configReq)
+       || (msgType == Smsgs_cmdIds_configEpoch))
+    {
+        return (Indq_priority_high);
+    }
+    else if(msgType == Smsgs_cmdIds_trackingReq)
+    {
+        return (Indq_priority_low);
+    }
+
+    return (Indq_priority_normal);
+}
+
+/*!
+ * @brief      Send a message to a device. Messages for a sleepy device are
+ *             held until the device polls, a newer config or tracking
+ *             request replaces a pending one.
  *
  * @param      type - message type
  * @param      dstShortAddr - destination short address
  * @param      rxOnIdle - true if not a sleepy device
  * @param      len - length of payload
  * @param      pData - pointer to the buffer
+ *
+ * @return     ApiMac_status_success, or ApiMac_status_transactionOverflow
+ *             when the message couldn't be held for the sleepy device. No
+ *             data confirm follows a failure, the caller mustn't wait for
+ *             one.
+ */
+static ApiMac_status_t sendMsg(Smsgs_cmdIds_t type, uint16_t dstShortAddr,
+                               bool rxOnIdle, uint16_t len, uint8_t *pData)
+{
+    uint8_t msduHandle = getMsduHandle(type);
+
+    if((rxOnIdle == false) && (fhEnabled == false))
+    {
+        ApiMac_status_t status;
+
+        status = Indq_add(dstShortAddr, msduHandle, getMsgPriority(type),
+                          (type != Smsgs_cmdIds_toggleLedReq), len, pData);
+        if(status == ApiMac_status_transactionOverflow)
+        {
+            Collector_statistics.txTransactionOverflow++;
+        }
+
+        if(status != ApiMac_status_invalidParameter)
+        {
+            return (status);
+        }
+
+        /* Too long to hold, leave it to the MAC indirect queue */
+    }
+
+    sendDataReq(dstShortAddr, msduHandle, !rxOnIdle, false, len, pData);
+
+    return (ApiMac_status_success);
+}
+
+/*!
+ * @brief      Send MAC data request
+ *
+ * @param      dstShortAddr - destination short address
+ * @param      msduHandle - MSDU handle
+ * @param      indirect - true to queue in the MAC until the device polls
+ * @param      pendingBit - true to tell the device more data is pending
+ * @param      len - length of payload
+ * @param      pData - pointer to the buffer
  */
-static void sendMsg(Smsgs_cmdIds_t type, uint16_t dstShortAddr, bool rxOnIdle,
-                    uint16_t len,
-                    uint8_t *pData)
+static void sendDataReq(uint16_t dstShortAddr, uint8_t msduHandle,
+                        bool indirect, bool pendingBit, uint16_t len,
+                        uint8_t *pData)
 {
     ApiMac_mcpsDataReq_t dataReq;
 
@@ -1115,7 +1629,11 @@ static void sendMsg(Smsgs_cmdIds_t type, uint16_t dstShortAddr, bool rxOnIdle,
     dataReq.dstAddr.addr.shortAddr = dstShortAddr;
     dataReq.srcAddrMode = ApiMac_addrType_short;
 
-    if(fhEnabled)
+    if(fhEnabled && (dstShortAddr == BROADCAST_SHORT_ADDR))
+    {
+        dataReq.srcAddrMode = ApiMac_addrType_extended;
+    }
+    else if(fhEnabled)
     {
         Llc_deviceListItem_t item;
 
@@ -1136,13 +1654,13 @@ static void sendMsg(Smsgs_cmdIds_t type, uint16_t dstShortAddr, bool rxOnIdle,
 
     dataReq.dstPanId = devicePanId;
 
-    dataReq.msduHandle = getMsduHandle(type);
+    dataReq.msduHandle = msduHandle;
 
-    dataReq.txOptions.ack = true;
-    if(rxOnIdle == false)
-    {
-        dataReq.txOptions.indirect = true;
-    }
+    /* Broadcasts aren't acknowledged */
+    dataReq.txOptions.ack = (dstShortAddr != BROADCAST_SHORT_ADDR) ? true
+                    : false;
+    dataReq.txOptions.indirect = indirect;
+    dataReq.txOptions.pendingBit = pendingBit;
 
     dataReq.msdu.len = len;
     dataReq.msdu.p = pData;
@@ -1162,6 +1680,12 @@ static void generateConfigRequests(void)
 {
     int x;
 
+    /* Repeat the config epoch broadcast */
+    if(epochBroadcasts > 0)
+    {
+        broadcastConfigEpoch();
+    }
+
     /* Clear any timed out transactions */
     for(x = 0; x < CONFIG_MAX_DEVICES; x++)
     {
@@ -1197,24 +1721,40 @@ static void generateConfigRequests(void)
                 {
                     ApiMac_sAddr_t dstAddr;
                     Collector_status_t stat;
+                    Smsgs_reportPolicyField_t *pPolicy = NULL;
 
                     /* Set up the destination address */
                     dstAddr.addrMode = ApiMac_addrType_short;
                     dstAddr.addr.shortAddr =
                         Cllc_associatedDevList[x].shortAddr;
 
-                    /* Send the Config Request */
+                    /*
+                     Sensors that don't report their config epoch reject a
+                     Config Request with the policy. The others get it even
+                     when it's off, so one that rejoins drops the one it had.
+                     */
+                    if(status & ASSOC_REPORT_POLICY)
+                    {
+                        pPolicy = &fleetConfig.reportPolicy;
+                    }
+
                     stat = Collector_sendConfigRequest(
-                                    &dstAddr, (CONFIG_FRAME_CONTROL),
-                                    (CONFIG_REPORTING_INTERVAL),
-                                    (CONFIG_POLLING_INTERVAL));
+                                    &dstAddr, fleetConfig.frameControl,
+                                    fleetConfig.reportingInterval,
+                                    fleetConfig.pollingInterval, pPolicy);
                     if(stat == Collector_status_success)
                     {
                         /*
                          Mark as the message has been sent and expecting a response
                          */
                         Cllc_associatedDevList[x].status |= ASSOC_CONFIG_SENT;
-                        Cllc_associatedDevList[x].status &= ~ASSOC_CONFIG_RSP;
+                        Cllc_associatedDevList[x].status &= ~(ASSOC_CONFIG_RSP
+                                        | ASSOC_CONFIG_POLICY);
+                        if(pPolicy != NULL)
+                        {
+                            Cllc_associatedDevList[x].status |=
+                                ASSOC_CONFIG_POLICY;
+                        }
                     }
 
                     /* Only do one at a time */
@@ -1374,10 +1914,15 @@ static void sendTrackingRequest(Cllc_associated_devices_t *pDev)
     uint8_t cmdId = Smsgs_cmdIds_trackingReq;
 
     /* Send the Tracking Request */
-    sendMsg(Smsgs_cmdIds_trackingReq, pDev->shortAddr,
-            pDev->capInfo.rxOnWhenIdle,
-            (SMSGS_TRACKING_REQUEST_MSG_LENGTH),
-            &cmdId);
+    if(sendMsg(Smsgs_cmdIds_trackingReq, pDev->shortAddr,
+               pDev->capInfo.rxOnWhenIdle,
+               (SMSGS_TRACKING_REQUEST_MSG_LENGTH),
+               &cmdId) != ApiMac_status_success)
+    {
+        /* Not held for the device, try again later */
+        Csf_setTrackingClock(TRACKING_CNF_DELAY_TIME);
+        return;
+    }
 
     /* Mark as Tracking Request sent */
     pDev->status |= ASSOC_TRACKING_SENT;
@@ -1407,6 +1952,9 @@ static void commStatusIndCB(ApiMac_mlmeCommStatusInd_t *pCommStatusInd)
             {
                 /* Mark as inactive and clear config and tracking states */
                 pDev->status = 0;
+
+                /* Nothing held for it will be sent */
+                Indq_remove(pDev->shortAddr);
             }
         }
     }
@@ -1419,7 +1967,9 @@ static void commStatusIndCB(ApiMac_mlmeCommStatusInd_t *pCommStatusInd)
  */
 static void pollIndCB(ApiMac_mlmePollInd_t *pPollInd)
 {
+    Cllc_associated_devices_t *pDev;
     ApiMac_sAddr_t addr;
+    Indq_msg_t msg;
 
     addr.addrMode = ApiMac_addrType_short;
     if (pPollInd->srcAddr.addrMode == ApiMac_addrType_short)
@@ -1432,9 +1982,49 @@ static void pollIndCB(ApiMac_mlmePollInd_t *pPollInd)
                         &pPollInd->srcAddr.addr.extAddr);
     }
 
+    /* Hold the config epoch for a device that hasn't applied it yet */
+    pDev = findDevice(&addr);
+    if((pDev != NULL) && (pDev->status & ASSOC_EPOCH_STALE)
+       && (Indq_checkPending() < INDQ_MAX_MSGS))
+    {
+        pDev->status &= ~ASSOC_EPOCH_STALE;
+        sendConfigEpoch(pDev);
+    }
+
+    /*
+     The acknowledgement had the frame pending bit set, so the device is
+     waiting for a frame: release its next held message.
+     */
+    if((pPollInd->noRsp == false)
+       && (addr.addr.shortAddr != CSF_INVALID_SHORT_ADDR)
+       && Indq_get(addr.addr.shortAddr, &msg))
+    {
+        sendDataReq(addr.addr.shortAddr, msg.msduHandle, false, msg.more,
+                    msg.len, msg.data);
+    }
+
     processDataRetry(&addr);
 }
 
+/*!
+ * @brief      A message held for a sleepy device was dropped, report it
+ *             like the MAC reports an indirect frame it couldn't send.
+ *
+ * @param      msduHandle - MSDU handle of the message
+ * @param      status - ApiMac_status_transactionExpired or
+ *                      ApiMac_status_transactionOverflow
+ */
+static void indqDroppedCB(uint8_t msduHandle, ApiMac_status_t status)
+{
+    ApiMac_mcpsDataCnf_t dataCnf;
+
+    memset(&dataCnf, 0, sizeof(ApiMac_mcpsDataCnf_t));
+    dataCnf.msduHandle = msduHandle;
+    dataCnf.status = status;
+
+    dataCnfCB(&dataCnf);
+}
+
 /*!
  * @brief      Process retries for config and tracking messages
  *
@@ -1487,3 +2077,123 @@ static void processConfigRetry(void)
         Csf_setConfigClock(CONFIG_DELAY);
     }
 }
+
+/*!
+ * @brief      Build the Config Epoch message of the current configuration,
+ *             with the report policy.
+ *
+ * @param      pBuf - buffer of SMSGS_CONFIG_EPOCH_POLICY_MSG_LENGTH bytes
+ *
+ * @return     message length
+ */
+static uint16_t buildConfigEpoch(uint8_t *pBuf)
+{
+    Smsgs_reportPolicyField_t *pPolicy = &fleetConfig.reportPolicy;
+
+    *pBuf++ = (uint8_t)Smsgs_cmdIds_configEpoch;
+    *pBuf++ = fleetConfig.epoch;
+    pBuf = Util_bufferUint16(pBuf, fleetConfig.frameControl);
+    pBuf = Util_bufferUint32(pBuf, fleetConfig.reportingInterval);
+    pBuf = Util_bufferUint32(pBuf, fleetConfig.pollingInterval);
+    pBuf = Util_bufferUint16(pBuf, pPolicy->tempDeadband);
+    pBuf = Util_bufferUint16(pBuf, pPolicy->lightDeadband);
+    pBuf = Util_bufferUint16(pBuf, pPolicy->humidityDeadband);
+    (void)Util_bufferUint32(pBuf, pPolicy->heartbeatInterval);
+
+    return (SMSGS_CONFIG_EPOCH_POLICY_MSG_LENGTH);
+}
+
+/*!
+ * @brief      Broadcast the Config Epoch message, and set up the next
+ *             broadcast if there are more to send.
+ */
+static void broadcastConfigEpoch(void)
+{
+    uint8_t buffer[SMSGS_CONFIG_EPOCH_POLICY_MSG_LENGTH];
+    uint16_t len;
+
+    len = buildConfigEpoch(buffer);
+    sendDataReq(BROADCAST_SHORT_ADDR, getMsduHandle(Smsgs_cmdIds_configEpoch),
+                false, false, len, buffer);
+    Collector_statistics.configEpochBroadcasts++;
+
+    epochBroadcasts--;
+    if(epochBroadcasts > 0)
+    {
+        Csf_setConfigClock(CONFIG_DELAY);
+    }
+}
+
+/*!
+ * @brief      Send the Config Epoch message to a device. For a sleepy
+ *             device it is held until the device polls, in place of one
+ *             already held.
+ *
+ * @param      pDev - device
+ */
+static void sendConfigEpoch(Cllc_associated_devices_t *pDev)
+{
+    uint8_t buffer[SMSGS_CONFIG_EPOCH_POLICY_MSG_LENGTH];
+    uint16_t len;
+
+    len = buildConfigEpoch(buffer);
+    if(sendMsg(Smsgs_cmdIds_configEpoch, pDev->shortAddr,
+               pDev->capInfo.rxOnWhenIdle, len, buffer)
+       == ApiMac_status_success)
+    {
+        /* Else its next report tells it is still behind */
+        Collector_statistics.configEpochAttempts++;
+    }
+}
+
+/*!
+ * @brief      Check the config epoch reported by a device. A device that
+ *             reports an older epoch is sent the current one: right away
+ *             if it doesn't sleep, else when it next polls. A device that
+ *             reports its epoch takes the report policy, it's configured
+ *             again if its Config Request didn't have it.
+ *
+ * @param      pSrcAddr - address of the device
+ * @param      epoch - epoch reported by the device
+ */
+static void checkConfigEpoch(ApiMac_sAddr_t *pSrcAddr, uint8_t epoch)
+{
+    Cllc_associated_devices_t *pDev;
+
+    pDev = findDevice(pSrcAddr);
+    if(pDev == NULL)
+    {
+        return;
+    }
+
+    if((pDev->status & ASSOC_REPORT_POLICY) == 0)
+    {
+        pDev->status |= ASSOC_REPORT_POLICY;
+
+        /* A request in flight is sent again when its response comes in */
+        if((pDev->status & ASSOC_CONFIG_MASK) == ASSOC_CONFIG_RSP)
+        {
+            pDev->status &= ~ASSOC_CONFIG_RSP;
+            processConfigRetry();
+        }
+    }
+
+    /* Nothing to push before the configuration is changed */
+    if(fleetConfig.epoch == 0)
+    {
+        return;
+    }
+
+    if(epoch == fleetConfig.epoch)
+    {
+        pDev->status &= ~ASSOC_EPOCH_STALE;
+    }
+    else if(pDev->capInfo.rxOnWhenIdle)
+    {
+        sendConfigEpoch(pDev);
+    }
+    else
+    {
+        pDev->status |= ASSOC_EPOCH_STALE;
+    }
+}
@@ -54,6 +54,7 @@
 #include <stdint.h>
 
 #include "api_mac.h"
+#include "smsgs.h"
 
 #ifdef __cplusplus
 extern "C"
@@ -79,7 +80,9 @@ typedef enum
     /*! Device Not Found */
     Collector_status_deviceNotFound = 1,
     /*! Collector isn't in the correct state to send a message */
-    Collector_status_invalid_state = 2
+    Collector_status_invalid_state = 2,
+    /*! No room to hold the message until the sleepy device polls */
+    Collector_status_noResources = 3
 } Collector_status_t;
 
 /******************************************************************************
@@ -138,6 +141,18 @@ typedef struct
     uint32_t txTransactionExpired;
     /* Total transaction Overflow error */
     uint32_t txTransactionOverflow;
+    /*!
+     Total number of config epoch messages broadcast
+     */
+    uint32_t configEpochBroadcasts;
+    /*!
+     Total number of config epoch messages attempted to a device
+     */
+    uint32_t configEpochAttempts;
+    /*!
+     Total number of config epoch messages sent, broadcast or to a device
+     */
+    uint32_t configEpochSent;
 } Collector_statistics_t;
 
 /******************************************************************************
@@ -179,14 +194,55 @@ extern void Collector_process(void);
  * @param pollingInterval - in milliseconds- how often to the device is to
  *                          poll its parent for data (for sleeping devices
  *                          only.
+ * @param pReportPolicy - which readings the device is to send, or NULL to
+ *                        leave the device's report policy unchanged. Only
+ *                        sensors that report their config epoch take it,
+ *                        older ones reject the request.
  *
- * @return Collector_status_success, Collector_status_invalid_state
- *         or Collector_status_deviceNotFound
+ * @return Collector_status_success, Collector_status_invalid_state,
+ *         Collector_status_deviceNotFound or Collector_status_noResources
  */
 extern Collector_status_t Collector_sendConfigRequest(ApiMac_sAddr_t *pDstAddr,
                 uint16_t frameControl,
                 uint32_t reportingInterval,
-                uint32_t pollingInterval);
+                uint32_t pollingInterval,
+                Smsgs_reportPolicyField_t *pReportPolicy);
+
+/*!
+ * @brief Change the configuration of all of the devices. A new config epoch
+ *        is broadcast with the configuration CONFIG_EPOCH_BROADCASTS times,
+ *        for the devices that are awake. Each sleepy device is sent it on its
+ *        own when it next polls, and any device that later reports an older
+ *        epoch in its sensor data is sent it again. Devices that join get
+ *        the configuration in their Config Request and the epoch after their
+ *        first report.
+ *
+ * @param frameControl - Frame Control field
+ * @param reportingInterval - in milliseconds- how often to report, 0
+ *                            means to turn off automated reporting, but will
+ *                            force the sensor device to send the Sensor Data
+ *                            message once.
+ * @param pollingInterval - in milliseconds- how often to the device is to
+ *                          poll its parent for data (for sleeping devices
+ *                          only.
+ * @param pReportPolicy - which readings the devices are to send, or NULL to
+ *                        keep the current one.
+ *
+ * @return Collector_status_success or Collector_status_invalid_state
+ */
+extern Collector_status_t Collector_setConfig(uint16_t frameControl,
+                uint32_t reportingInterval,
+                uint32_t pollingInterval,
+                Smsgs_reportPolicyField_t *pReportPolicy);
+
+/*!
+ * @brief Get the configuration of all of the devices, as last set with
+ *        Collector_setConfig().
+ *
+ * @param pConfig - pointer to place to put the configuration, with its
+ *                  config epoch
+ */
+extern void Collector_getConfig(Smsgs_configEpochMsg_t *pConfig);
 
 /*!
  * @brief Update the collector statistics
@@ -198,8 +254,8 @@ extern void Collector_updateStats( void );
  *
  * @param pDstAddr - destination address of the device to send the message
  *
- * @return Collector_status_success, Collector_status_invalid_state
- *         or Collector_status_deviceNotFound
+ * @return Collector_status_success, Collector_status_invalid_state,
+ *         Collector_status_deviceNotFound or Collector_status_noResources
  */
 extern Collector_status_t Collector_sendToggleLedRequest(
                 ApiMac_sAddr_t *pDstAddr);
@@ -60,6 +60,7 @@
 #include <string.h>
 #include <inc/hw_ints.h>
 #include <aon_event.h>
+#include <aon_rtc.h>
 #include <ioc.h>
 
 #include "board.h"
@@ -78,11 +79,22 @@
 #include "collector.h"
 #include "cllc.h"
 #include "csf.h"
+#include "defq.h"
+#include "board_status.h"
+#include "blist.h"
+#include "tstore.h"
 
 #if defined(MT_CSF)
 #include "mt_csf.h"
 #endif
 
+#if defined(CSF_BRIDGE_UART)
+#if defined(MT_CSF)
+#error "CSF_BRIDGE_UART and MT_CSF both use the UART"
+#endif
+#include <ti/drivers/UART.h>
+#endif
+
 /******************************************************************************
  Constants and definitions
  *****************************************************************************/
@@ -104,6 +116,8 @@
 #define CSF_NV_FRAMECOUNTER_ID 0x0006
 /* NV Item ID - reset reason */
 #define CSF_NV_RESET_REASON_ID 0x0007
+/* NV Item ID - configuration of all of the devices and its epoch */
+#define CSF_NV_FLEET_CONFIG_ID 0x0008
 
 /* Maximum number of black list entries */
 #define CSF_MAX_BLACKLIST_ENTRIES 10
@@ -130,6 +144,13 @@
 #define JOIN_TIMEOUT_VALUE       20
 /* timeout value for config request delay */
 #define CONFIG_TIMEOUT_VALUE 1000
+
+/*
+ Reporting interval, in milliseconds, all of the devices are switched to
+ when both keys are pressed, and back from when pressed again.
+ */
+#define CSF_KEY_REPORTING_INTERVAL 10000
+
 /*
  The increment value needed to save a frame counter. Example, setting this
  constant to 100, means that the frame counter will be saved when the new
@@ -145,6 +166,58 @@
 /*! NV driver item ID for reset reason */
 #define NVID_RESET {NVINTF_SYSID_APP, CSF_NV_RESET_REASON_ID, 0}
 
+/* Deferred work key of the coordinator frame counter */
+#define COORD_FRAMECOUNTER_KEY  0xFFFF
+
+/*
+ Lock the device list records, held across reading and writing back a
+ record so the deferred frame counter update can't overwrite a record
+ that was removed or replaced in the meantime.
+ */
+#define CSF_DEVICELIST_LOCK() Semaphore_pend(deviceListMutex, BIOS_WAIT_FOREVER)
+#define CSF_DEVICELIST_UNLOCK() Semaphore_post(deviceListMutex)
+
+/*
+ Lock the time-series store, the MT CSF requests may come from another
+ task than the sensor readings.
+ */
+#define CSF_TSTORE_LOCK() Semaphore_pend(tstoreMutex, BIOS_WAIT_FOREVER)
+#define CSF_TSTORE_UNLOCK() Semaphore_post(tstoreMutex)
+
+/*
+ Baud rate of the telemetry bridge, the bit banged receiver of the MSP430
+ ESP8266 bridge only keeps up with 9600.
+ */
+#define CSF_BRIDGE_BAUD 9600
+
+/* Longest telemetry bridge line, "$S,-32768,-32768,-32768\n" */
+#define CSF_BRIDGE_LINE_LEN 26
+
+#if defined(MT_CSF)
+/* Sensor data indication, deferred */
+typedef struct
+{
+    ApiMac_sAddr_t srcAddr;
+    int8_t rssi;
+    Smsgs_sensorMsg_t msg;
+} csfSensorData_t;
+
+/*
+ The sensor data indication is copied into a deferred work item, fail the
+ build if it grows past DEFQ_MAX_DATA_LEN rather than drop every report.
+ */
+typedef char csfSensorDataFits[
+    (sizeof(csfSensorData_t) <= DEFQ_MAX_DATA_LEN) ? 1 : -1];
+#endif
+
+/* Frame counter update, deferred */
+typedef struct
+{
+    /* Device address, or no address for the coordinator */
+    ApiMac_sAddr_t devAddr;
+    uint32_t frameCntr;
+} csfFrameCounter_t;
+
 /******************************************************************************
  External variables
  *****************************************************************************/
@@ -191,11 +264,43 @@ static bool started = false;
 /* The last saved coordinator frame counter */
 static uint32_t lastSavedCoordinatorFrameCounter = 0;
 
+/* Device list records lock */
+static Semaphore_Struct deviceListMutexStruct;
+static Semaphore_Handle deviceListMutex;
+
+#if TSTORE_ENABLED
+/* Time-series store lock */
+static Semaphore_Struct tstoreMutexStruct;
+static Semaphore_Handle tstoreMutex;
+#endif
+
+/* RAM copy of the black list, the join filter reads only this */
+static Blist_entry_t blackListEntries[CSF_MAX_BLACKLIST_ENTRIES];
+static Blist_t blackList;
+
+/* NV items of the black list, the NV functions are set at init */
+static Blist_nv_t blackListNv =
+{
+    NULL, CSF_NV_BLACKLIST_ID, CSF_NV_BLACKLIST_ENTRIES_ID,
+    CSF_MAX_BLACKLIST_IDS
+};
+
 #if defined(MT_CSF)
 /*! NV driver item ID for reset reason */
 static const NVINTF_itemID_t nvResetId = NVID_RESET;
 #endif
 
+#if defined(CSF_BRIDGE_UART)
+/* UART to the MSP430 ESP8266 telemetry bridge */
+static UART_Handle bridgeUart = NULL;
+#endif
+
+/*
+ Reporting interval of all the devices before the keys switched it to
+ CSF_KEY_REPORTING_INTERVAL, 0 while not switched
+ */
+static uint32_t keySavedReportingInterval = 0;
+
 /******************************************************************************
  Global variables
  *****************************************************************************/
@@ -214,19 +319,36 @@ Cllc_states_t savedCllcState = Cllc_states_initWaiting;
 
 static void processTackingTimeoutCallback(UArg a0);
 static void processKeyChangeCallback(uint8_t keysPressed);
+static void changeFleetReporting(void);
 static void processPATrickleTimeoutCallback(UArg a0);
 static void processPCTrickleTimeoutCallback(UArg a0);
 static void processJoinTimeoutCallback(UArg a0);
 static void processConfigTimeoutCallback(UArg a0);
+#if defined(MT_CSF)
+static void processSensorDataUpdate(void *pData);
+#endif
+#if defined(CSF_BRIDGE_UART)
+static void openBridgeUart(void);
+static void bridgeSensorData(ApiMac_sAddr_t *pSrcAddr,
+                             Smsgs_sensorMsg_t *pMsg);
+static void processBridgeLine(void *pData);
+static int16_t bridgeValue(uint16_t value);
+#endif
+static void processStatusRefresh(void *pData);
+static void processStatusTimeoutCallback(void);
+static void processFrameCounterUpdate(void *pData);
+static void saveFrameCounter(ApiMac_sAddr_t *pDevAddr, uint32_t frameCntr);
+#if TSTORE_ENABLED
+static bool storeSensorData(ApiMac_sAddr_t *pSrcAddr, int8_t rssi,
+                            Smsgs_sensorMsg_t *pMsg, uint32_t sampleAge);
+static uint32_t readStoreTime(void);
+#endif
 static bool addDeviceListItem(Llc_deviceListItem_t *pItem);
 static void updateDeviceListItem(Llc_deviceListItem_t *pItem);
 static int findDeviceListIndex(ApiMac_sAddrExt_t *pAddr);
 static int findUnusedDeviceListIndex(void);
 static void saveNumDeviceListEntries(uint16_t numEntries);
 static int findBlackListIndex(ApiMac_sAddr_t *pAddr);
-static int findUnusedBlackListIndex(void);
-static uint16_t getNumBlackListEntries(void);
-static void saveNumBlackListEntries(uint16_t numEntries);
 void removeBlackListItem(ApiMac_sAddr_t *pAddr);
 #if defined(TEST_REMOVE_DEVICE)
 static void removeTheFirstDevice(void);
@@ -245,6 +367,8 @@ static uint16_t getTheFirstDevice(void);
  */
 void Csf_init(void *sem)
 {
+    Semaphore_Params semParams;
+
 #ifdef NV_RESTORE
     /* Save off the NV Function Pointers */
     pNV = &Main_user1Cfg.nvFps;
@@ -253,6 +377,28 @@ void Csf_init(void *sem)
     /* Save off the semaphore */
     collectorSem = sem;
 
+    Semaphore_Params_init(&semParams);
+    semParams.mode = Semaphore_Mode_BINARY;
+    Semaphore_construct(&deviceListMutexStruct, 1, &semParams);
+    deviceListMutex = Semaphore_handle(&deviceListMutexStruct);
+
+#if TSTORE_ENABLED
+    Semaphore_construct(&tstoreMutexStruct, 1, &semParams);
+    tstoreMutex = Semaphore_handle(&tstoreMutexStruct);
+
+    Tstore_init();
+#endif
+
+    /* Start the worker task for the NV, LCD and MT updates */
+    Defq_init();
+
+#if defined(CSF_BRIDGE_UART)
+    openBridgeUart();
+#endif
+
+    Blist_init(&blackList, blackListEntries, CSF_MAX_BLACKLIST_ENTRIES);
+    blackListNv.pNV = pNV;
+
     /* Initialize keys */
     if(Board_Key_initialize(processKeyChangeCallback) == KEY_RIGHT)
     {
@@ -260,16 +406,22 @@ void Csf_init(void *sem)
         Csf_clearAllNVItems();
     }
 
+    /* Read the black list from NV once, lookups use the RAM copy */
+    Blist_load(&blackList, &blackListNv);
+
     /* Initialize the LCD */
     Board_LCD_open();
 
-    LCD_WRITE_STRING("TI Collector", 1);
+    STATUS_WRITE_STRING("TI Collector", 1);
 #if !defined(AUTO_START)
-    LCD_WRITE_STRING("Waiting...", 2);
+    STATUS_WRITE_STRING("Waiting...", 2);
 #endif /* AUTO_START */
 
     Board_Led_initialize();
 
+    /* Paint the LCD and LEDs from the worker task */
+    Board_Status_init(processStatusTimeoutCallback);
+
 #if defined(MT_CSF)
     {
         uint8_t resetReseason = 0;
@@ -295,7 +447,7 @@ void Csf_init(void *sem)
         /* Did we reset because of assert? */
         if(resetReseason > 0)
         {
-            LCD_WRITE_STRING("Restarting...", 2);
+            STATUS_WRITE_STRING("Restarting...", 2);
 
             /* Tell the collector to restart */
             Csf_events |= CSF_KEY_EVENT;
@@ -318,6 +470,16 @@ void Csf_processEvents(void)
     {
         /* LaunchPad only supports KEY_LEFT and KEY_RIGHT */
 
+        if((Csf_keys & (KEY_LEFT | KEY_RIGHT)) == (KEY_LEFT | KEY_RIGHT))
+        {
+            /* Both keys, switch the reporting interval of all devices */
+            if(started == true)
+            {
+                changeFleetReporting();
+            }
+            Csf_keys &= ~(KEY_LEFT | KEY_RIGHT);
+        }
+
         if(Csf_keys & KEY_LEFT)
         {
 
@@ -325,7 +487,7 @@ void Csf_processEvents(void)
             /* Process the Left Key */
             if(started == false)
             {
-                LCD_WRITE_STRING("Starting...", 2);
+                STATUS_WRITE_STRING("Starting...", 2);
 
                 /* Tell the collector to start */
                 Util_setEvent(&Collector_events, COLLECTOR_START_EVT);
@@ -366,13 +528,13 @@ void Csf_processEvents(void)
             {
                 permitJoining = false;
                 duration = 0;
-                LCD_WRITE_STRING("PermitJoin-OFF", 3);
+                STATUS_WRITE_STRING("PermitJoin-OFF", 3);
             }
             else
             {
                 permitJoining = true;
                 duration = 0xFFFFFFFF;
-                LCD_WRITE_STRING("PermitJoin-ON ", 3);
+                STATUS_WRITE_STRING("PermitJoin-ON ", 3);
             }
 
             /* Set permit joining */
@@ -386,6 +548,16 @@ void Csf_processEvents(void)
         Util_clearEvent(&Csf_events, CSF_KEY_EVENT);
     }
 
+    /* Is the status display due for a refresh? */
+    if(Csf_events & CSF_STATUS_EVENT)
+    {
+        /* Painting is left to the worker task, retried next period if full */
+        (void)Defq_post(processStatusRefresh, 0, true, 0, NULL);
+
+        /* Clear the event */
+        Util_clearEvent(&Csf_events, CSF_STATUS_EVENT);
+    }
+
 #if defined(MT_CSF)
     MTCSF_displayStatistics();
 #endif
@@ -445,20 +617,21 @@ void Csf_networkUpdate(bool restored, Llc_netInfo_t *pNetworkInfo)
 
         if(restored == false)
         {
-            LCD_WRITE_STRING("Started", 2);
+            STATUS_WRITE_STRING("Started", 2);
         }
         else
         {
-            LCD_WRITE_STRING("Restarted", 2);
+            STATUS_WRITE_STRING("Restarted", 2);
         }
 
         if(pNetworkInfo->fh == false)
         {
-            LCD_WRITE_STRING_VALUE("Channel: ", pNetworkInfo->channel, 10, 3);
+            STATUS_WRITE_STRING_VALUE("Channel: ", pNetworkInfo->channel, 10,
+                                      3);
         }
         else
         {
-            LCD_WRITE_STRING("Freq. Hopping", 3);
+            STATUS_WRITE_STRING("Freq. Hopping", 3);
         }
 
         Board_Led_control(board_led_type_LED1, board_led_state_ON);
@@ -495,7 +668,8 @@ ApiMac_assocStatus_t Csf_deviceUpdate(ApiMac_deviceDescriptor_t *pDevInfo,
         /* Denied */
         status = ApiMac_assocStatus_panAccessDenied;
 
-        LCD_WRITE_STRING_VALUE("Denied: 0x", pDevInfo->shortAddress, 16, 4);
+        STATUS_WRITE_STRING_VALUE("Denied: 0x", pDevInfo->shortAddress, 16,
+                                  4);
     }
     else
     {
@@ -510,12 +684,13 @@ ApiMac_assocStatus_t Csf_deviceUpdate(ApiMac_deviceDescriptor_t *pDevInfo,
         {
             status = ApiMac_assocStatus_panAtCapacity;
 
-            LCD_WRITE_STRING_VALUE("Failed: 0x", pDevInfo->shortAddress,
-                                   16, 4);
+            STATUS_WRITE_STRING_VALUE("Failed: 0x", pDevInfo->shortAddress,
+                                      16, 4);
         }
         else
         {
-            LCD_WRITE_STRING_VALUE("Joined: 0x", pDevInfo->shortAddress, 16, 4);
+            STATUS_WRITE_STRING_VALUE("Joined: 0x", pDevInfo->shortAddress,
+                                      16, 4);
         }
     }
 
@@ -536,9 +711,8 @@ ApiMac_assocStatus_t Csf_deviceUpdate(ApiMac_deviceDescriptor_t *pDevInfo,
 void Csf_deviceNotActiveUpdate(ApiMac_deviceDescriptor_t *pDevInfo,
 bool timeout)
 {
-    LCD_WRITE_STRING_VALUE("!Responding: 0x", pDevInfo->shortAddress,
-                           16,
-                           5);
+    STATUS_WRITE_STRING_VALUE("!Responding: 0x", pDevInfo->shortAddress,
+                              16, 5);
 
 #if defined(MT_CSF)
     MTCSF_deviceNotActiveIndCB(pDevInfo, timeout);
@@ -554,7 +728,8 @@ bool timeout)
 void Csf_deviceConfigUpdate(ApiMac_sAddr_t *pSrcAddr, int8_t rssi,
                             Smsgs_configRspMsg_t *pMsg)
 {
-    LCD_WRITE_STRING_VALUE("ConfigRsp: 0x", pSrcAddr->addr.shortAddr, 16, 5);
+    STATUS_WRITE_STRING_VALUE("ConfigRsp: 0x", pSrcAddr->addr.shortAddr, 16,
+                              5);
 
 #if defined(MT_CSF)
     MTCSF_configResponseIndCB(pSrcAddr, rssi, pMsg);
@@ -568,15 +743,53 @@ void Csf_deviceConfigUpdate(ApiMac_sAddr_t *pSrcAddr, int8_t rssi,
  Public function defined in csf.h
  */
 void Csf_deviceSensorDataUpdate(ApiMac_sAddr_t *pSrcAddr, int8_t rssi,
-                                Smsgs_sensorMsg_t *pMsg)
+                                Smsgs_sensorMsg_t *pMsg, uint32_t sampleAge)
 {
-    Board_Led_toggle(board_led_type_LED2);
+    bool indicate = true;
+
+    STATUS_LED_TOGGLE(board_led_type_LED2);
 
-    LCD_WRITE_STRING_VALUE("Sensor 0x", pSrcAddr->addr.shortAddr, 16, 6);
+    STATUS_WRITE_STRING_VALUE("Sensor 0x", pSrcAddr->addr.shortAddr, 16, 6);
+
+#if TSTORE_ENABLED
+    /*
+     The host asks the store for readings, it's told of threshold events,
+     or of every reading until it sets a threshold.
+     */
+    indicate = storeSensorData(pSrcAddr, rssi, pMsg, sampleAge);
+#else
+    (void)sampleAge;
+#endif
 
 #if defined(MT_CSF)
-    MTCSF_sensorUpdateIndCB(pSrcAddr, rssi, pMsg);
+    if(indicate == true)
+    {
+        csfSensorData_t data;
+
+        memcpy(&data.srcAddr, pSrcAddr, sizeof(ApiMac_sAddr_t));
+        data.rssi = rssi;
+        memcpy(&data.msg, pMsg, sizeof(Smsgs_sensorMsg_t));
+
+        /*
+         The MT indication is left to the worker task, inline if the queue
+         is full so the host gets every reading.
+         */
+        if(Defq_post(processSensorDataUpdate, pSrcAddr->addr.shortAddr, false,
+                     sizeof(csfSensorData_t), &data) == false)
+        {
+            processSensorDataUpdate(&data);
+        }
+    }
+#endif
+
+#if defined(CSF_BRIDGE_UART)
+    if(indicate == true)
+    {
+        bridgeSensorData(pSrcAddr, pMsg);
+    }
 #endif
+
+    (void)indicate; /* Not used without MT_CSF or CSF_BRIDGE_UART */
 }
 
 /*!
@@ -1009,51 +1222,42 @@ void Csf_free(void *ptr)
  */
 void Csf_updateFrameCounter(ApiMac_sAddr_t *pDevAddr, uint32_t frameCntr)
 {
-    if((pNV != NULL) && (pNV->writeItem != NULL))
+    csfFrameCounter_t update;
+    uint16_t key = COORD_FRAMECOUNTER_KEY;
+
+    if(pDevAddr == NULL)
     {
-        if(pDevAddr == NULL)
+        /* Most confirms fall inside the save window, nothing to post */
+        if(frameCntr < (lastSavedCoordinatorFrameCounter
+                        + FRAME_COUNTER_SAVE_WINDOW))
         {
-            /* Update this device's frame counter */
-            if((frameCntr >=
-                (lastSavedCoordinatorFrameCounter + FRAME_COUNTER_SAVE_WINDOW)))
-            {
-                NVINTF_itemID_t id;
-
-                /* Setup NV ID */
-                id.systemID = NVINTF_SYSID_APP;
-                id.itemID = CSF_NV_FRAMECOUNTER_ID;
-                id.subID = 0;
+            return;
+        }
 
-                /* Write the NV item */
-                if(pNV->writeItem(id, sizeof(uint32_t), &frameCntr)
-                                == NVINTF_SUCCESS)
-                {
-                    lastSavedCoordinatorFrameCounter = frameCntr;
-                }
-            }
+        update.devAddr.addrMode = ApiMac_addrType_none;
+    }
+    else
+    {
+        memcpy(&update.devAddr, pDevAddr, sizeof(ApiMac_sAddr_t));
+        if(pDevAddr->addrMode == ApiMac_addrType_short)
+        {
+            key = pDevAddr->addr.shortAddr;
         }
         else
         {
-            /* Child frame counter update */
-            Llc_deviceListItem_t devItem;
-
-            /* Is the device in our database? */
-            if(Csf_getDevice(pDevAddr, &devItem))
-            {
-                /*
-                 Don't save every update, only save if the new frame
-                 counter falls outside the save window.
-                 */
-                if((devItem.rxFrameCounter + FRAME_COUNTER_SAVE_WINDOW)
-                                <= frameCntr)
-                {
-                    /* Update the frame counter */
-                    devItem.rxFrameCounter = frameCntr;
-                    updateDeviceListItem(&devItem);
-                }
-            }
+            key = Util_buildUint16(pDevAddr->addr.extAddr[0],
+                                   pDevAddr->addr.extAddr[1]);
         }
     }
+    update.frameCntr = frameCntr;
+
+    /*
+     The device list lookup and the NV write are left to the worker task.
+     If the queue is full the update is dropped, the saved frame counter
+     is unchanged so the next frame posts it again.
+     */
+    (void)Defq_post(processFrameCounterUpdate, key, true,
+                    sizeof(csfFrameCounter_t), &update);
 }
 
 /*!
@@ -1124,6 +1328,8 @@ void Csf_removeDeviceListItem(ApiMac_sAddrExt_t *pAddr)
     {
         int index;
 
+        CSF_DEVICELIST_LOCK();
+
         /* Does the item exist? */
         index = findDeviceListIndex(pAddr);
         if(index != DEVICE_INDEX_NOT_FOUND)
@@ -1148,6 +1354,8 @@ void Csf_removeDeviceListItem(ApiMac_sAddrExt_t *pAddr)
                 }
             }
         }
+
+        CSF_DEVICELIST_UNLOCK();
     }
 }
 
@@ -1174,6 +1382,9 @@ void Csf_assertInd(uint8_t reason)
  */
 void Csf_clearAllNVItems(void)
 {
+    /* Clear the black list, its count and every possible record */
+    Blist_eraseAll(&blackList, &blackListNv);
+
     if((pNV != NULL) && (pNV->deleteItem != NULL))
     {
         NVINTF_itemID_t id;
@@ -1185,25 +1396,6 @@ void Csf_clearAllNVItems(void)
         id.subID = 0;
         pNV->deleteItem(id);
 
-        /* Clear the black list entries number */
-        id.systemID = NVINTF_SYSID_APP;
-        id.itemID = CSF_NV_BLACKLIST_ENTRIES_ID;
-        id.subID = 0;
-        pNV->deleteItem(id);
-
-        /*
-         Clear the black list entries.  Brute force through
-         every possible subID, if it doesn't exist that's fine,
-         it will fail in deleteItem.
-         */
-        id.systemID = NVINTF_SYSID_APP;
-        id.itemID = CSF_NV_BLACKLIST_ID;
-        for(entries = 0; entries < CSF_MAX_BLACKLIST_IDS; entries++)
-        {
-            id.subID = entries;
-            pNV->deleteItem(id);
-        }
-
         /* Clear the device list entries number */
         id.systemID = NVINTF_SYSID_APP;
         id.itemID = CSF_NV_DEVICELIST_ENTRIES_ID;
@@ -1228,54 +1420,72 @@ void Csf_clearAllNVItems(void)
         id.itemID = CSF_NV_FRAMECOUNTER_ID;
         id.subID = 0;
         pNV->deleteItem(id);
+
+        /* Clear the configuration of all of the devices */
+        id.systemID = NVINTF_SYSID_APP;
+        id.itemID = CSF_NV_FLEET_CONFIG_ID;
+        id.subID = 0;
+        pNV->deleteItem(id);
     }
 }
 
-
 /*!
- Add an entry into the black list
+ Save the configuration of all of the devices
 
  Public function defined in csf.h
  */
-bool Csf_addBlackListItem(ApiMac_sAddr_t *pAddr)
+void Csf_updateFleetConfig(Smsgs_configEpochMsg_t *pConfig)
 {
-    bool retVal = false;
+    if((pNV != NULL) && (pNV->writeItem != NULL) && (pConfig != NULL))
+    {
+        NVINTF_itemID_t id;
+
+        /* Setup NV ID */
+        id.systemID = NVINTF_SYSID_APP;
+        id.itemID = CSF_NV_FLEET_CONFIG_ID;
+        id.subID = 0;
+
+        /* Write the NV item */
+        pNV->writeItem(id, sizeof(Smsgs_configEpochMsg_t), pConfig);
+    }
+}
+
+/*!
+ Get the saved configuration of all of the devices
 
-    if((pNV != NULL) && (pAddr != NULL)
-       && (pAddr->addrMode != ApiMac_addrType_none))
+ Public function defined in csf.h
+ */
+bool Csf_getFleetConfig(Smsgs_configEpochMsg_t *pConfig)
+{
+    if((pNV != NULL) && (pNV->readItem != NULL) && (pConfig != NULL))
     {
-        if(findBlackListIndex(pAddr))
-        {
-            retVal = true;
-        }
-        else
-        {
-            uint8_t stat;
-            NVINTF_itemID_t id;
-            uint16_t numEntries = getNumBlackListEntries();
+        NVINTF_itemID_t id;
 
-            /* Check the maximum size */
-            if(numEntries < CSF_MAX_BLACKLIST_ENTRIES)
-            {
-                /* Setup NV ID for the black list record */
-                id.systemID = NVINTF_SYSID_APP;
-                id.itemID = CSF_NV_BLACKLIST_ID;
-                id.subID = (uint16_t)findUnusedBlackListIndex();
+        /* Setup NV ID */
+        id.systemID = NVINTF_SYSID_APP;
+        id.itemID = CSF_NV_FLEET_CONFIG_ID;
+        id.subID = 0;
 
-                /* write the black list record */
-                stat = pNV->writeItem(id, sizeof(ApiMac_sAddr_t), pAddr);
-                if(stat == NVINTF_SUCCESS)
-                {
-                    /* Update the number of entries */
-                    numEntries++;
-                    saveNumBlackListEntries(numEntries);
-                    retVal = true;
-                }
-            }
+        /* Read the configuration from NV */
+        if(pNV->readItem(id, 0, sizeof(Smsgs_configEpochMsg_t), pConfig)
+           == NVINTF_SUCCESS)
+        {
+            return(true);
         }
     }
+    return(false);
+}
 
-    return (retVal);
+
+/*!
+ Add an entry into the black list
+
+ Public function defined in csf.h
+ */
+bool Csf_addBlackListItem(ApiMac_sAddr_t *pAddr)
+{
+    /* Write the black list record, then the RAM copy */
+    return (Blist_store(&blackList, &blackListNv, pAddr));
 }
 
 /*!
@@ -1287,6 +1497,38 @@ bool Csf_isConfigTimerActive(void)
 {
     return(Timer_isActive(&configClkStruct));
 }
+
+/*!
+ Run a sensor time-series request from the host
+
+ Public function defined in csf.h
+ */
+uint16_t Csf_sensorSeriesReq(uint8_t *pReq, uint16_t reqLen, uint8_t *pRsp,
+                             uint16_t rspMax)
+{
+#if TSTORE_ENABLED
+    uint16_t len;
+
+    CSF_TSTORE_LOCK();
+    len = Tstore_processReq(readStoreTime(), pReq, reqLen, pRsp, rspMax);
+    CSF_TSTORE_UNLOCK();
+
+    return (len);
+#else
+    (void)pReq;
+    (void)reqLen;
+
+    if(rspMax < TSTORE_RSP_HDR_LEN)
+    {
+        return (0);
+    }
+
+    memset(pRsp, 0, TSTORE_RSP_HDR_LEN);
+    pRsp[0] = Tstore_status_unsupported;
+
+    return (TSTORE_RSP_HDR_LEN);
+#endif
+}
 /******************************************************************************
  Local Functions
  *****************************************************************************/
@@ -1382,55 +1624,369 @@ static void processKeyChangeCallback(uint8_t keysPressed)
 }
 
 /*!
- * @brief       Add an entry into the device list
- *
- * @param       pItem - pointer to the device list entry
- *
- * @return      true if added or already existed, false if problem
+ * @brief       Switch the reporting interval of all of the devices to
+ *              CSF_KEY_REPORTING_INTERVAL, or back to what it was, with a new
+ *              config epoch.
  */
-static bool addDeviceListItem(Llc_deviceListItem_t *pItem)
+static void changeFleetReporting(void)
 {
-    bool retVal = false;
+    Smsgs_configEpochMsg_t config;
+    uint32_t interval = CSF_KEY_REPORTING_INTERVAL;
 
-    if((pNV != NULL) && (pItem != NULL))
+    Collector_getConfig(&config);
+    if(keySavedReportingInterval != 0)
     {
-        if(findDeviceListIndex(&pItem->devInfo.extAddress)
-                        != DEVICE_INDEX_NOT_FOUND)
-        {
-            retVal = true;
-        }
-        else
-        {
-            uint8_t stat;
-            NVINTF_itemID_t id;
-            uint16_t numEntries = Csf_getNumDeviceListEntries();
-
-            /* Check the maximum size */
-            if(numEntries < CSF_MAX_DEVICELIST_ENTRIES)
-            {
-                /* Setup NV ID for the device list record */
-                id.systemID = NVINTF_SYSID_APP;
-                id.itemID = CSF_NV_DEVICELIST_ID;
-                id.subID = (uint16_t)findUnusedDeviceListIndex();
-
-                /* write the device list record */
-                stat = pNV->writeItem(id, sizeof(Llc_deviceListItem_t), pItem);
-                if(stat == NVINTF_SUCCESS)
-                {
-                    /* Update the number of entries */
-                    numEntries++;
-                    saveNumDeviceListEntries(numEntries);
-                    retVal = true;
-                }
-            }
-        }
+        interval = keySavedReportingInterval;
     }
 
-    return (retVal);
+    if(Collector_setConfig(config.frameControl, interval,
+                           config.pollingInterval, NULL)
+       == Collector_status_success)
+    {
+        keySavedReportingInterval = (keySavedReportingInterval != 0) ? 0 :
+                                    config.reportingInterval;
+        STATUS_WRITE_STRING_VALUE("Report ms: ", interval, 10, 3);
+    }
 }
 
 /*!
- * @brief       Update an entry in the device list
+ * @brief       Status display notify function, called from the refresh
+ *              clock when a line or LED is dirty.
+ */
+static void processStatusTimeoutCallback(void)
+{
+    Csf_events |= CSF_STATUS_EVENT;
+
+    /* Wake up the application thread when it waits for clock event */
+    Semaphore_post(collectorSem);
+}
+
+#if defined(MT_CSF)
+/*!
+ * @brief       Deferred sensor data MT indication.
+ *
+ * @param       pData - csfSensorData_t
+ */
+static void processSensorDataUpdate(void *pData)
+{
+    csfSensorData_t *pSensorData = (csfSensorData_t *)pData;
+
+    MTCSF_sensorUpdateIndCB(&pSensorData->srcAddr, pSensorData->rssi,
+                            &pSensorData->msg);
+}
+#endif
+
+#if defined(CSF_BRIDGE_UART)
+/*!
+ * @brief       Open the UART to the MSP430 ESP8266 telemetry bridge, which
+ *              uploads the readings to ThingSpeak. Writes block the worker
+ *              task only.
+ */
+static void openBridgeUart(void)
+{
+    UART_Params uartParams;
+
+    UART_init();
+
+    UART_Params_init(&uartParams);
+    uartParams.writeDataMode = UART_DATA_BINARY;
+    uartParams.readEcho = UART_ECHO_OFF;
+    uartParams.baudRate = CSF_BRIDGE_BAUD;
+    bridgeUart = UART_open(Board_UART0, &uartParams);
+}
+
+/*!
+ * @brief       Send a sensor reading to the telemetry bridge as a
+ *              "$S,<temperature>,<humidity>,<light>" line: the ambience
+ *              temperature in degrees C, then the humidity and light sensor
+ *              values as the sensor reported them. A sensor without a
+ *              temperature reading has nothing to chart and is skipped.
+ *
+ * @param       pSrcAddr - address of the device that sent the message
+ * @param       pMsg - Sensor Data message
+ */
+static void bridgeSensorData(ApiMac_sAddr_t *pSrcAddr,
+                             Smsgs_sensorMsg_t *pMsg)
+{
+    char line[CSF_BRIDGE_LINE_LEN];
+    int16_t humidity = 0;
+    int16_t light = 0;
+    int len;
+
+    if((bridgeUart == NULL)
+       || ((pMsg->frameControl & Smsgs_dataFields_tempSensor) == 0))
+    {
+        return;
+    }
+
+    if(pMsg->frameControl & Smsgs_dataFields_humiditySensor)
+    {
+        humidity = bridgeValue(pMsg->humiditySensor.humidity);
+    }
+    if(pMsg->frameControl & Smsgs_dataFields_lightSensor)
+    {
+        light = bridgeValue(pMsg->lightSensor.rawData);
+    }
+
+    len = System_snprintf(line, sizeof(line), "$S,%d,%d,%d\n",
+                          (int)pMsg->tempSensor.ambienceTemp, (int)humidity,
+                          (int)light);
+
+    /* The newest reading of a device replaces one still waiting */
+    (void)Defq_post(processBridgeLine, pSrcAddr->addr.shortAddr, true,
+                    (uint16_t)(len + 1), line);
+}
+
+/*!
+ * @brief       Deferred telemetry bridge line write.
+ *
+ * @param       pData - line, zero terminated
+ */
+static void processBridgeLine(void *pData)
+{
+    UART_write(bridgeUart, pData, strlen((char *)pData));
+}
+
+/*!
+ * @brief       Clamp an unsigned sensor value to the signed 16 bit range the
+ *              bridge parses.
+ *
+ * @param       value - sensor value
+ *
+ * @return      value, 32767 at most
+ */
+static int16_t bridgeValue(uint16_t value)
+{
+    if(value > INT16_MAX)
+    {
+        value = INT16_MAX;
+    }
+
+    return ((int16_t)value);
+}
+#endif
+
+#if TSTORE_ENABLED
+/*!
+ * @brief       Add a sensor reading to the time-series store.
+ *
+ * @param       pSrcAddr - address of the device that sent the message
+ * @param       rssi - the received packet's signal strength
+ * @param       pMsg - Sensor Data message
+ * @param       sampleAge - time in milliseconds from the reading to the
+ *                          message
+ *
+ * @return      true if the reading is indicated to the host
+ */
+static bool storeSensorData(ApiMac_sAddr_t *pSrcAddr, int8_t rssi,
+                            Smsgs_sensorMsg_t *pMsg, uint32_t sampleAge)
+{
+    Tstore_reading_t reading;
+    uint16_t shortAddr = pSrcAddr->addr.shortAddr;
+    bool event;
+
+    if(pSrcAddr->addrMode == ApiMac_addrType_extended)
+    {
+        shortAddr = Csf_getDeviceShort(&pSrcAddr->addr.extAddr);
+    }
+
+    reading.chans = (uint8_t)(1 << Tstore_chan_rssi);
+    reading.value[Tstore_chan_rssi] = rssi;
+
+    if(pMsg->frameControl & Smsgs_dataFields_tempSensor)
+    {
+        reading.chans |= (uint8_t)((1 << Tstore_chan_ambienceTemp)
+                                   | (1 << Tstore_chan_objectTemp));
+        reading.value[Tstore_chan_ambienceTemp] =
+                        pMsg->tempSensor.ambienceTemp;
+        reading.value[Tstore_chan_objectTemp] = pMsg->tempSensor.objectTemp;
+    }
+    if(pMsg->frameControl & Smsgs_dataFields_lightSensor)
+    {
+        reading.chans |= (uint8_t)(1 << Tstore_chan_light);
+        reading.value[Tstore_chan_light] = pMsg->lightSensor.rawData;
+    }
+    if(pMsg->frameControl & Smsgs_dataFields_humiditySensor)
+    {
+        reading.chans |= (uint8_t)((1 << Tstore_chan_humidityTemp)
+                                   | (1 << Tstore_chan_humidity));
+        reading.value[Tstore_chan_humidityTemp] = pMsg->humiditySensor.temp;
+        reading.value[Tstore_chan_humidity] = pMsg->humiditySensor.humidity;
+    }
+
+    /* The older samples of a batch are stored at the time they were read */
+    sampleAge /= TSTORE_TIME_RES_MS;
+
+    CSF_TSTORE_LOCK();
+    reading.time = readStoreTime();
+    reading.time = (reading.time > sampleAge) ? (reading.time - sampleAge) : 0;
+    event = Tstore_add(shortAddr, &reading);
+    CSF_TSTORE_UNLOCK();
+
+    return (event);
+}
+
+/*!
+ * @brief       Read the time of the time-series store from the RTC, which
+ *              doesn't wrap like the RTOS tick count.
+ *
+ * @return      time, in units of TSTORE_TIME_RES_MS
+ */
+static uint32_t readStoreTime(void)
+{
+    uint64_t rtc = AONRTCCurrent64BitValueGet();
+    uint64_t ms;
+
+    /* Seconds in the top word, fraction of a second in the bottom one */
+    ms = ((rtc >> 32) * 1000) + (((rtc & 0xFFFFFFFF) * 1000) >> 32);
+
+    return ((uint32_t)(ms / TSTORE_TIME_RES_MS));
+}
+#endif
+
+/*!
+ * @brief       Deferred status display refresh.
+ *
+ * @param       pData - ignored
+ */
+static void processStatusRefresh(void *pData)
+{
+    (void)pData;
+
+    Board_Status_refresh();
+}
+
+/*!
+ * @brief       Deferred frame counter update.
+ *
+ * @param       pData - csfFrameCounter_t
+ */
+static void processFrameCounterUpdate(void *pData)
+{
+    csfFrameCounter_t *pUpdate = (csfFrameCounter_t *)pData;
+
+    if(pUpdate->devAddr.addrMode == ApiMac_addrType_none)
+    {
+        saveFrameCounter(NULL, pUpdate->frameCntr);
+    }
+    else
+    {
+        CSF_DEVICELIST_LOCK();
+        saveFrameCounter(&pUpdate->devAddr, pUpdate->frameCntr);
+        CSF_DEVICELIST_UNLOCK();
+    }
+}
+
+/*!
+ * @brief       Save a frame counter in NV when it falls outside the
+ *              save window.
+ *
+ * @param       pDevAddr - device address, NULL for this device
+ * @param       frameCntr - frame counter
+ */
+static void saveFrameCounter(ApiMac_sAddr_t *pDevAddr, uint32_t frameCntr)
+{
+    if((pNV != NULL) && (pNV->writeItem != NULL))
+    {
+        if(pDevAddr == NULL)
+        {
+            /* Update this device's frame counter */
+            if((frameCntr >=
+                (lastSavedCoordinatorFrameCounter + FRAME_COUNTER_SAVE_WINDOW)))
+            {
+                NVINTF_itemID_t id;
+
+                /* Setup NV ID */
+                id.systemID = NVINTF_SYSID_APP;
+                id.itemID = CSF_NV_FRAMECOUNTER_ID;
+                id.subID = 0;
+
+                /* Write the NV item */
+                if(pNV->writeItem(id, sizeof(uint32_t), &frameCntr)
+                                == NVINTF_SUCCESS)
+                {
+                    lastSavedCoordinatorFrameCounter = frameCntr;
+                }
+            }
+        }
+        else
+        {
+            /* Child frame counter update */
+            Llc_deviceListItem_t devItem;
+
+            /* Is the device in our database? */
+            if(Csf_getDevice(pDevAddr, &devItem))
+            {
+                /*
+                 Don't save every update, only save if the new frame
+                 counter falls outside the save window.
+                 */
+                if((devItem.rxFrameCounter + FRAME_COUNTER_SAVE_WINDOW)
+                                <= frameCntr)
+                {
+                    /* Update the frame counter */
+                    devItem.rxFrameCounter = frameCntr;
+                    updateDeviceListItem(&devItem);
+                }
+            }
+        }
+    }
+}
+
+/*!
+ * @brief       Add an entry into the device list
+ *
+ * @param       pItem - pointer to the device list entry
+ *
+ * @return      true if added or already existed, false if problem
+ */
+static bool addDeviceListItem(Llc_deviceListItem_t *pItem)
+{
+    bool retVal = false;
+
+    if((pNV != NULL) && (pItem != NULL))
+    {
+        CSF_DEVICELIST_LOCK();
+
+        if(findDeviceListIndex(&pItem->devInfo.extAddress)
+                        != DEVICE_INDEX_NOT_FOUND)
+        {
+            retVal = true;
+        }
+        else
+        {
+            uint8_t stat;
+            NVINTF_itemID_t id;
+            uint16_t numEntries = Csf_getNumDeviceListEntries();
+
+            /* Check the maximum size */
+            if(numEntries < CSF_MAX_DEVICELIST_ENTRIES)
+            {
+                /* Setup NV ID for the device list record */
+                id.systemID = NVINTF_SYSID_APP;
+                id.itemID = CSF_NV_DEVICELIST_ID;
+                id.subID = (uint16_t)findUnusedDeviceListIndex();
+
+                /* write the device list record */
+                stat = pNV->writeItem(id, sizeof(Llc_deviceListItem_t), pItem);
+                if(stat == NVINTF_SUCCESS)
+                {
+                    /* Update the number of entries */
+                    numEntries++;
+                    saveNumDeviceListEntries(numEntries);
+                    retVal = true;
+                }
+            }
+        }
+
+        CSF_DEVICELIST_UNLOCK();
+    }
+
+    return (retVal);
+}
+
+/*!
+ * @brief       Update an entry in the device list
  *
  * @param       pItem - pointer to the device list entry
  */
@@ -1594,156 +2150,7 @@ static void saveNumDeviceListEntries(uint16_t numEntries)
  */
 static int findBlackListIndex(ApiMac_sAddr_t *pAddr)
 {
-    if((pNV != NULL) && (pAddr != NULL)
-       && (pAddr->addrMode != ApiMac_addrType_none))
-    {
-        uint16_t numEntries;
-
-        numEntries = getNumBlackListEntries();
-
-        if(numEntries > 0)
-        {
-            NVINTF_itemID_t id;
-            uint8_t stat;
-            int subId = 0;
-            int readItems = 0;
-
-            /* Setup NV ID for the black list records */
-            id.systemID = NVINTF_SYSID_APP;
-            id.itemID = CSF_NV_BLACKLIST_ID;
-
-            while((readItems < numEntries) && (subId < CSF_MAX_BLACKLIST_IDS))
-            {
-                ApiMac_sAddr_t item;
-
-                id.subID = (uint16_t)subId;
-
-                /* Read Network Information from NV */
-                stat = pNV->readItem(id, 0, sizeof(ApiMac_sAddr_t), &item);
-                if(stat == NVINTF_SUCCESS)
-                {
-                    if(pAddr->addrMode == item.addrMode)
-                    {
-                        /* Is the address the same */
-                        if(((pAddr->addrMode == ApiMac_addrType_short)
-                            && (pAddr->addr.shortAddr == item.addr.shortAddr))
-                           || ((pAddr->addrMode == ApiMac_addrType_extended)
-                               && (memcmp(&pAddr->addr.extAddr,
-                                          &item.addr.extAddr,
-                                          APIMAC_SADDR_EXT_LEN)
-                                   == 0)))
-                        {
-                            return (subId);
-                        }
-                    }
-                    readItems++;
-                }
-                subId++;
-            }
-        }
-    }
-
-    return (-1);
-}
-
-/*!
- * @brief       Find an unused blacklist index
- *
- * @return      index that is not in use
- */
-static int findUnusedBlackListIndex(void)
-{
-    int subId = 0;
-
-    if(pNV != NULL)
-    {
-        uint16_t numEntries;
-
-        numEntries = getNumBlackListEntries();
-
-        if(numEntries > 0)
-        {
-            NVINTF_itemID_t id;
-
-            int readItems = 0;
-            /* Setup NV ID for the black list records */
-            id.systemID = NVINTF_SYSID_APP;
-            id.itemID = CSF_NV_BLACKLIST_ID;
-
-            while((readItems < numEntries) && (subId < CSF_MAX_BLACKLIST_IDS))
-            {
-                ApiMac_sAddr_t item;
-                uint8_t stat;
-
-                id.subID = (uint16_t)subId;
-
-                /* Read Network Information from NV */
-                stat = pNV->readItem(id, 0, sizeof(ApiMac_sAddr_t), &item);
-                if(stat == NVINTF_NOTFOUND)
-                {
-                    /* Use this sub id */
-                    break;
-                }
-                else if(stat == NVINTF_SUCCESS)
-                {
-                    readItems++;
-                }
-                subId++;
-            }
-        }
-    }
-
-    return (subId);
-}
-
-/*!
- * @brief       Read the number of black list items stored
- *
- * @return      number of entries in the black list
- */
-static uint16_t getNumBlackListEntries(void)
-{
-    uint16_t numEntries = 0;
-
-    if(pNV != NULL)
-    {
-        NVINTF_itemID_t id;
-        uint8_t stat;
-
-        /* Setup NV ID for the number of entries in the black list */
-        id.systemID = NVINTF_SYSID_APP;
-        id.itemID = CSF_NV_BLACKLIST_ENTRIES_ID;
-        id.subID = 0;
-
-        /* Read the number of black list items from NV */
-        stat = pNV->readItem(id, 0, sizeof(uint16_t), &numEntries);
-        if(stat != NVINTF_SUCCESS)
-        {
-            numEntries = 0;
-        }
-    }
-    return (numEntries);
-}
-
-/*!
- * @brief       Read the number of black list items stored
- *
- * @param       numEntries - number of entries in the black list
- */
-static void saveNumBlackListEntries(uint16_t numEntries)
-{
-    if(pNV != NULL)
-    {
-        NVINTF_itemID_t id;
-
-        /* Setup NV ID for the number of entries in the black list */
-        id.systemID = NVINTF_SYSID_APP;
-        id.itemID = CSF_NV_BLACKLIST_ENTRIES_ID;
-        id.subID = 0;
-
-        /* Read the number of black list items from NV */
-        pNV->writeItem(id, sizeof(uint16_t), &numEntries);
-    }
+    return (Blist_find(&blackList, pAddr));
 }
 
 /*!
@@ -1753,35 +2160,8 @@ static void saveNumBlackListEntries(uint16_t numEntries)
  */
 void removeBlackListItem(ApiMac_sAddr_t *pAddr)
 {
-    if(pNV != NULL)
-    {
-        int index;
-
-        /* Does the item exist? */
-        index = findBlackListIndex(pAddr);
-        if(index > 0)
-        {
-            uint8_t stat;
-            NVINTF_itemID_t id;
-
-            /* Setup NV ID for the black list record */
-            id.systemID = NVINTF_SYSID_APP;
-            id.itemID = CSF_NV_BLACKLIST_ID;
-            id.subID = (uint16_t)index;
-
-            stat = pNV->deleteItem(id);
-            if(stat == NVINTF_SUCCESS)
-            {
-                /* Update the number of entries */
-                uint16_t numEntries = getNumBlackListEntries();
-                if(numEntries > 0)
-                {
-                    numEntries--;
-                    saveNumBlackListEntries(numEntries);
-                }
-            }
-        }
-    }
+    /* Delete the black list record, then the RAM copy */
+    Blist_erase(&blackList, &blackListNv, pAddr);
 }
 
 #if defined(TEST_REMOVE_DEVICE)
@@ -1831,7 +2211,7 @@ static void removeTheFirstDevice(void)
                     addr.addrMode = ApiMac_addrType_extended;
                     memcpy(&addr.addr.extAddr, &item.devInfo.extAddress,
                            (APIMAC_SADDR_EXT_LEN));
-                    addBlackListItem(&addr);
+                    Csf_addBlackListItem(&addr);
                     break;
                 }
                 subId++;
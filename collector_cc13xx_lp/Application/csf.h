@@ -68,6 +68,8 @@ extern "C"
 
 /*! CSF Events - Key Event */
 #define CSF_KEY_EVENT 0x0001
+/*! CSF Events - Status display refresh */
+#define CSF_STATUS_EVENT 0x0002
 
 #define CSF_INVALID_SHORT_ADDR   0xFFFF
 
@@ -175,9 +177,13 @@ extern void Csf_deviceConfigUpdate(ApiMac_sAddr_t *pSrcAddr, int8_t rssi,
  * @param       pSrcAddr - short address of the device that sent the message
  * @param       rssi - the received packet's signal strength
  * @param       pMsg - pointer to the Sensor Data message
+ * @param       sampleAge - time in milliseconds from the reading to the
+ *                          message, 0 except for the older samples of a
+ *                          Sensor Batch message
  */
 extern void Csf_deviceSensorDataUpdate(ApiMac_sAddr_t *pSrcAddr, int8_t rssi,
-                                       Smsgs_sensorMsg_t *pMsg);
+                                       Smsgs_sensorMsg_t *pMsg,
+                                       uint32_t sampleAge);
 
 /*!
  * @brief       The application calls this function to indicate that a device
@@ -321,6 +327,23 @@ extern void Csf_updateFrameCounter(ApiMac_sAddr_t *pDevAddr,
 extern bool Csf_getFrameCounter(ApiMac_sAddr_t *pDevAddr,
                                    uint32_t *pFrameCntr);
 
+/*!
+ * @brief       Save the configuration sent to all of the devices, with its
+ *              config epoch, so the epoch goes on from there after a reset.
+ *
+ * @param       pConfig - configuration
+ */
+extern void Csf_updateFleetConfig(Smsgs_configEpochMsg_t *pConfig);
+
+/*!
+ * @brief       Get the saved configuration of all of the devices.
+ *
+ * @param       pConfig - pointer to place to put the configuration
+ *
+ * @return      true if a configuration was saved, false if not.
+ */
+extern bool Csf_getFleetConfig(Smsgs_configEpochMsg_t *pConfig);
+
 /*!
  * @brief       Delete an entry from the device list
  *
@@ -360,6 +383,22 @@ extern bool Csf_addBlackListItem(ApiMac_sAddr_t *pAddr);
  */
 extern bool Csf_isConfigTimerActive(void);
 
+/*!
+ * @brief       Run a sensor time-series request from the host, an
+ *              MT_UTIL_SENSOR_SERIES command of MT UTIL, see
+ *              Tstore_processReq() in tstore.h for the request and response.
+ *
+ * @param       pReq - request
+ * @param       reqLen - request length
+ * @param       pRsp - buffer for the response
+ * @param       rspMax - size of the response buffer
+ *
+ * @return      response length, a Tstore_status_unsupported response when
+ *              the store isn't built
+ */
+extern uint16_t Csf_sensorSeriesReq(uint8_t *pReq, uint16_t reqLen,
+                                    uint8_t *pRsp, uint16_t rspMax);
+
 #ifdef __cplusplus
 }
 #endif
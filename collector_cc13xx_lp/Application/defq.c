@@ -0,0 +1,218 @@
+/******************************************************************************
+
+ @file defq.c
+
+ @brief Collector deferred work queue
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+#include <string.h>
+#include <xdc/std.h>
+#include <ti/sysbios/BIOS.h>
+#include <ti/sysbios/knl/Task.h>
+#include <ti/sysbios/knl/Semaphore.h>
+
+#include "defq.h"
+
+/******************************************************************************
+ Constants and definitions
+ *****************************************************************************/
+
+/*! Data size in words, so the copy is aligned for any structure */
+#define DEFQ_DATA_WORDS         ((DEFQ_MAX_DATA_LEN + 3) / 4)
+
+/*! A waiting work item */
+typedef struct
+{
+    /*! Work function */
+    Defq_workFp_t pWorkFp;
+    /*! Coalescing key */
+    uint16_t key;
+    /*! Data */
+    uint32_t data[DEFQ_DATA_WORDS];
+} defqItem_t;
+
+/******************************************************************************
+ Global variables
+ *****************************************************************************/
+
+/*! Deferred work queue statistics */
+Defq_statistics_t Defq_statistics;
+
+/******************************************************************************
+ Local variables
+ *****************************************************************************/
+
+/*! Waiting work, oldest at defqHead */
+static defqItem_t defqItems[DEFQ_MAX_ITEMS];
+
+/*! Index of the oldest waiting item */
+static uint8_t defqHead = 0;
+
+/*! Number of waiting items */
+static uint8_t defqCount = 0;
+
+/*! Data of the item being run */
+static uint32_t defqWorkData[DEFQ_DATA_WORDS];
+
+/*! Worker task */
+static Task_Struct defqTask;
+static Char defqTaskStack[DEFQ_TASK_STACK_SIZE];
+
+/*! Posted when work is queued */
+static Semaphore_Struct defqSemStruct;
+static Semaphore_Handle defqSem;
+
+/******************************************************************************
+ Local function prototypes
+ *****************************************************************************/
+static Void defqTaskFxn(UArg a0, UArg a1);
+
+/******************************************************************************
+ Public Functions
+ *****************************************************************************/
+
+/*!
+ Initialize the deferred work queue.
+
+ Public function defined in defq.h
+ */
+void Defq_init(void)
+{
+    Semaphore_Params semParams;
+    Task_Params taskParams;
+
+    memset(&Defq_statistics, 0, sizeof(Defq_statistics_t));
+    defqHead = 0;
+    defqCount = 0;
+
+    Semaphore_Params_init(&semParams);
+    semParams.mode = Semaphore_Mode_BINARY;
+    Semaphore_construct(&defqSemStruct, 0, &semParams);
+    defqSem = Semaphore_handle(&defqSemStruct);
+
+    Task_Params_init(&taskParams);
+    taskParams.stack = defqTaskStack;
+    taskParams.stackSize = DEFQ_TASK_STACK_SIZE;
+    taskParams.priority = DEFQ_TASK_PRIORITY;
+    Task_construct(&defqTask, defqTaskFxn, &taskParams, NULL);
+}
+
+/*!
+ Post work to be run by the worker task.
+
+ Public function defined in defq.h
+ */
+bool Defq_post(Defq_workFp_t pWorkFp, uint16_t key, bool coalesce,
+               uint16_t len, void *pData)
+{
+    defqItem_t *pItem = NULL;
+    UInt taskKey;
+    uint8_t i;
+
+    if((pWorkFp == NULL) || (len > DEFQ_MAX_DATA_LEN))
+    {
+        return (false);
+    }
+
+    /* The worker task takes items out, keep it off the queue */
+    taskKey = Task_disable();
+
+    for(i = 0; (i < defqCount) && (coalesce == true); i++)
+    {
+        defqItem_t *pWaiting = &defqItems[(defqHead + i) % DEFQ_MAX_ITEMS];
+
+        if((pWaiting->pWorkFp == pWorkFp) && (pWaiting->key == key))
+        {
+            /* Newer data for waiting work, keep its place */
+            Defq_statistics.coalesced++;
+            pItem = pWaiting;
+            break;
+        }
+    }
+
+    if(pItem == NULL)
+    {
+        if(defqCount >= DEFQ_MAX_ITEMS)
+        {
+            Defq_statistics.overflows++;
+            Task_restore(taskKey);
+            return (false);
+        }
+
+        pItem = &defqItems[(defqHead + defqCount) % DEFQ_MAX_ITEMS];
+        pItem->pWorkFp = pWorkFp;
+        pItem->key = key;
+        defqCount++;
+
+        if(defqCount > Defq_statistics.maxDepth)
+        {
+            Defq_statistics.maxDepth = defqCount;
+        }
+    }
+
+    if(len > 0)
+    {
+        memcpy(pItem->data, pData, len);
+    }
+    Defq_statistics.posted++;
+
+    Task_restore(taskKey);
+
+    Semaphore_post(defqSem);
+
+    return (true);
+}
+
+/******************************************************************************
+ Local Functions
+ *****************************************************************************/
+
+/*!
+ * @brief       Worker task, runs the waiting work oldest first.
+ *
+ * @param       a0 - ignored
+ * @param       a1 - ignored
+ */
+static Void defqTaskFxn(UArg a0, UArg a1)
+{
+    while(1)
+    {
+        Semaphore_pend(defqSem, BIOS_WAIT_FOREVER);
+
+        while(1)
+        {
+            Defq_workFp_t pWorkFp;
+            UInt taskKey;
+
+            taskKey = Task_disable();
+
+            if(defqCount == 0)
+            {
+                Task_restore(taskKey);
+                break;
+            }
+
+            /*
+             Copy the item out so it can be posted again while the work
+             runs.
+             */
+            pWorkFp = defqItems[defqHead].pWorkFp;
+            memcpy(defqWorkData, defqItems[defqHead].data,
+                   sizeof(defqWorkData));
+            defqHead = (defqHead + 1) % DEFQ_MAX_ITEMS;
+            defqCount--;
+
+            Task_restore(taskKey);
+
+            pWorkFp(defqWorkData);
+            Defq_statistics.serviced++;
+        }
+    }
+}
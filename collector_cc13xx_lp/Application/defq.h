@@ -0,0 +1,133 @@
+/******************************************************************************
+
+ @file defq.h
+
+ @brief Collector deferred work queue
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+#ifndef DEFQ_H
+#define DEFQ_H
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*!
+ \defgroup Defq Deferred Work Queue
+ <BR>
+ The application task receives every MAC callback, so anything slow done
+ inside a callback (an NV write that ends up compacting a flash page, an
+ LCD update, an MT indication) holds back the next received frame while
+ the MAC receive queue, only MAC_CFG_RX_MAX frames deep, fills up.
+ <BR>
+ Work that doesn't have to finish before the callback returns is posted
+ here instead, with a copy of its data, and is run by a worker task at a
+ lower priority than the application task. The worker only runs while the
+ application task waits for MAC messages, and the application task takes
+ the CPU back as soon as the next message arrives.
+ <BR>
+ Work posted as coalesced, with the same function and key as work still
+ waiting, replaces the waiting data in its place, so a burst from one device
+ runs once with the newest data.
+ <BR>
+ */
+
+/*!
+ * \ingroup Defq
+ * @{
+ */
+
+/******************************************************************************
+ Constants and definitions
+ *****************************************************************************/
+
+/*! Number of work items waiting */
+#if !defined(DEFQ_MAX_ITEMS)
+#define DEFQ_MAX_ITEMS          4
+#endif
+
+/*! Largest data copied with a work item, a sensor data report of csf.c */
+#if !defined(DEFQ_MAX_DATA_LEN)
+#define DEFQ_MAX_DATA_LEN       104
+#endif
+
+/*! Worker task priority, below the application task */
+#if !defined(DEFQ_TASK_PRIORITY)
+#define DEFQ_TASK_PRIORITY      1
+#endif
+
+/*! Worker task stack size */
+#if !defined(DEFQ_TASK_STACK_SIZE)
+#define DEFQ_TASK_STACK_SIZE    512
+#endif
+
+/*! Work function type, called by the worker task with the copied data */
+typedef void (*Defq_workFp_t)(void *pData);
+
+/*! Deferred work queue statistics */
+typedef struct _defq_statistics_t
+{
+    /*! Work items posted */
+    uint32_t posted;
+    /*! Work items that replaced the data of a waiting item */
+    uint32_t coalesced;
+    /*! Work items rejected because the queue was full */
+    uint32_t overflows;
+    /*! Work items run by the worker task */
+    uint32_t serviced;
+    /*! Largest number of items waiting */
+    uint8_t maxDepth;
+} Defq_statistics_t;
+
+/******************************************************************************
+ Global Variables
+ *****************************************************************************/
+
+/*! Deferred work queue statistics */
+extern Defq_statistics_t Defq_statistics;
+
+/******************************************************************************
+ Function Prototypes
+ *****************************************************************************/
+
+/*!
+ * @brief       Initialize the deferred work queue and start the worker task.
+ *              Called once, from the application task.
+ */
+extern void Defq_init(void);
+
+/*!
+ * @brief       Post work to be run by the worker task.
+ *
+ * @param       pWorkFp - work function
+ * @param       key - coalescing key
+ * @param       coalesce - true to replace the data of waiting work with the
+ *                         same function and key
+ * @param       len - data length, DEFQ_MAX_DATA_LEN at most
+ * @param       pData - data, copied, may be NULL when len is 0
+ *
+ * @return      true if the work was queued, false if the data is too long
+ *              or the queue is full and the caller has to do the work itself
+ *              or drop it
+ */
+extern bool Defq_post(Defq_workFp_t pWorkFp, uint16_t key, bool coalesce,
+                      uint16_t len, void *pData);
+
+/*! @} end group Defq */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DEFQ_H */
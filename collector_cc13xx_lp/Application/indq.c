@@ -0,0 +1,372 @@
+/******************************************************************************
+
+ @file indq.c
+
+ @brief Collector pending message store for sleepy devices
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+#include <string.h>
+#include <ti/sysbios/knl/Clock.h>
+
+#include "indq.h"
+
+/******************************************************************************
+ Constants and definitions
+ *****************************************************************************/
+
+/*! Short address of a free entry */
+#define INDQ_FREE_ADDR          0xFFFF
+
+/*! Convert milliseconds to clock ticks */
+#define INDQ_MS_TO_TICKS(ms)    ((ms) * (1000 / Clock_tickPeriod))
+
+/*! A held message */
+typedef struct
+{
+    /*! Destination, INDQ_FREE_ADDR when the entry is free */
+    uint16_t shortAddr;
+    /*! MSDU handle */
+    uint8_t msduHandle;
+    /*! Indq_priority_t */
+    uint8_t priority;
+    /*! Time the message was first queued, in clock ticks */
+    uint32_t queued;
+    /*! Time the message expires, in clock ticks */
+    uint32_t expires;
+    /*! Payload length */
+    uint16_t len;
+    /*! Payload */
+    uint8_t data[INDQ_MAX_MSG_LEN];
+} indqEntry_t;
+
+/******************************************************************************
+ Global variables
+ *****************************************************************************/
+
+/*! Pending message store statistics */
+Indq_statistics_t Indq_statistics;
+
+/******************************************************************************
+ Local variables
+ *****************************************************************************/
+
+/*! Held messages */
+static indqEntry_t indqEntries[INDQ_MAX_MSGS];
+
+/*! Number of held messages, read by the MAC task */
+static volatile uint8_t indqCount = 0;
+
+/*! Dropped message function */
+static Indq_droppedFp_t pIndqDroppedFp = NULL;
+
+/******************************************************************************
+ Local function prototypes
+ *****************************************************************************/
+static void freeEntry(indqEntry_t *pEntry, ApiMac_status_t status);
+static void expireEntries(uint32_t now);
+static indqEntry_t *findEntry(uint16_t shortAddr, uint8_t cmdId);
+static indqEntry_t *findNext(uint16_t shortAddr, indqEntry_t *pSkip);
+static indqEntry_t *findVictim(uint8_t priority);
+
+/******************************************************************************
+ Public Functions
+ *****************************************************************************/
+
+/*!
+ Initialize the pending message store.
+
+ Public function defined in indq.h
+ */
+void Indq_init(Indq_droppedFp_t pDroppedFp)
+{
+    uint8_t i;
+
+    memset(&Indq_statistics, 0, sizeof(Indq_statistics_t));
+
+    for(i = 0; i < INDQ_MAX_MSGS; i++)
+    {
+        indqEntries[i].shortAddr = INDQ_FREE_ADDR;
+    }
+
+    indqCount = 0;
+    pIndqDroppedFp = pDroppedFp;
+}
+
+/*!
+ Hold a message until its device polls.
+
+ Public function defined in indq.h
+ */
+ApiMac_status_t Indq_add(uint16_t shortAddr, uint8_t msduHandle,
+                         Indq_priority_t priority, bool coalesce,
+                         uint16_t len, uint8_t *pData)
+{
+    uint32_t now = Clock_getTicks();
+    indqEntry_t *pEntry = NULL;
+
+    if((shortAddr == INDQ_FREE_ADDR) || (len == 0)
+       || (len > INDQ_MAX_MSG_LEN))
+    {
+        return (ApiMac_status_invalidParameter);
+    }
+
+    expireEntries(now);
+
+    if(coalesce == true)
+    {
+        /* A newer message supersedes the pending one, in its place */
+        pEntry = findEntry(shortAddr, pData[0]);
+        if(pEntry != NULL)
+        {
+            Indq_statistics.coalesced++;
+            if(priority < pEntry->priority)
+            {
+                priority = (Indq_priority_t)pEntry->priority;
+            }
+        }
+    }
+
+    if(pEntry == NULL)
+    {
+        pEntry = findEntry(INDQ_FREE_ADDR, 0);
+        if(pEntry == NULL)
+        {
+            pEntry = findVictim(priority);
+            if(pEntry == NULL)
+            {
+                Indq_statistics.overflows++;
+                return (ApiMac_status_transactionOverflow);
+            }
+            freeEntry(pEntry, ApiMac_status_transactionOverflow);
+            Indq_statistics.overflows++;
+        }
+
+        pEntry->shortAddr = shortAddr;
+        pEntry->queued = now;
+        indqCount++;
+    }
+
+    pEntry->msduHandle = msduHandle;
+    pEntry->priority = (uint8_t)priority;
+    pEntry->expires = now + INDQ_MS_TO_TICKS(INDQ_PERSISTENT_TIME);
+    pEntry->len = len;
+    memcpy(pEntry->data, pData, len);
+
+    Indq_statistics.queued++;
+
+    return (ApiMac_status_success);
+}
+
+/*!
+ Take the next message for a device that polled.
+
+ Public function defined in indq.h
+ */
+bool Indq_get(uint16_t shortAddr, Indq_msg_t *pMsg)
+{
+    uint32_t now = Clock_getTicks();
+    indqEntry_t *pEntry;
+
+    if(shortAddr == INDQ_FREE_ADDR)
+    {
+        return (false);
+    }
+
+    expireEntries(now);
+
+    pEntry = findNext(shortAddr, NULL);
+    if(pEntry == NULL)
+    {
+        return (false);
+    }
+
+    pMsg->msduHandle = pEntry->msduHandle;
+    pMsg->len = pEntry->len;
+    memcpy(pMsg->data, pEntry->data, pEntry->len);
+    pMsg->more = (findNext(shortAddr, pEntry) != NULL) ? true : false;
+
+    Indq_statistics.released++;
+    Indq_statistics.totalLatency += (now - pEntry->queued)
+                    / INDQ_MS_TO_TICKS(1);
+
+    freeEntry(pEntry, ApiMac_status_success);
+
+    return (true);
+}
+
+/*!
+ Drop all of the messages of a device.
+
+ Public function defined in indq.h
+ */
+void Indq_remove(uint16_t shortAddr)
+{
+    indqEntry_t *pEntry;
+
+    if(shortAddr == INDQ_FREE_ADDR)
+    {
+        return;
+    }
+
+    while((pEntry = findNext(shortAddr, NULL)) != NULL)
+    {
+        freeEntry(pEntry, ApiMac_status_success);
+    }
+}
+
+/*!
+ Number of messages held.
+
+ Public function defined in indq.h
+ */
+uint8_t Indq_checkPending(void)
+{
+    return (indqCount);
+}
+
+/******************************************************************************
+ Local Functions
+ *****************************************************************************/
+
+/*!
+ * @brief       Free an entry, and report it as dropped unless the status is
+ *              ApiMac_status_success.
+ *
+ * @param       pEntry - entry to free
+ * @param       status - why the entry is freed
+ */
+static void freeEntry(indqEntry_t *pEntry, ApiMac_status_t status)
+{
+    uint8_t msduHandle = pEntry->msduHandle;
+
+    pEntry->shortAddr = INDQ_FREE_ADDR;
+    indqCount--;
+
+    if((status != ApiMac_status_success) && (pIndqDroppedFp != NULL))
+    {
+        pIndqDroppedFp(msduHandle, status);
+    }
+}
+
+/*!
+ * @brief       Drop the messages whose device didn't poll in time.
+ *
+ * @param       now - current time, in clock ticks
+ */
+static void expireEntries(uint32_t now)
+{
+    uint8_t i;
+
+    for(i = 0; (i < INDQ_MAX_MSGS) && (indqCount > 0); i++)
+    {
+        if((indqEntries[i].shortAddr != INDQ_FREE_ADDR)
+           && ((int32_t)(now - indqEntries[i].expires) >= 0))
+        {
+            Indq_statistics.expired++;
+            freeEntry(&indqEntries[i], ApiMac_status_transactionExpired);
+        }
+    }
+}
+
+/*!
+ * @brief       Find the message of a device with a command ID.
+ *
+ * @param       shortAddr - short address, INDQ_FREE_ADDR for a free entry
+ * @param       cmdId - command ID, ignored for a free entry
+ *
+ * @return      entry, or NULL if not found
+ */
+static indqEntry_t *findEntry(uint16_t shortAddr, uint8_t cmdId)
+{
+    uint8_t i;
+
+    for(i = 0; i < INDQ_MAX_MSGS; i++)
+    {
+        if((indqEntries[i].shortAddr == shortAddr)
+           && ((shortAddr == INDQ_FREE_ADDR)
+               || (indqEntries[i].data[0] == cmdId)))
+        {
+            return (&indqEntries[i]);
+        }
+    }
+
+    return (NULL);
+}
+
+/*!
+ * @brief       Find the next message to release to a device: the highest
+ *              priority, then the longest waiting.
+ *
+ * @param       shortAddr - short address of the device
+ * @param       pSkip - entry to ignore, or NULL
+ *
+ * @return      entry, or NULL if the device has no other message
+ */
+static indqEntry_t *findNext(uint16_t shortAddr, indqEntry_t *pSkip)
+{
+    uint32_t now = Clock_getTicks();
+    indqEntry_t *pFound = NULL;
+    uint8_t i;
+
+    for(i = 0; i < INDQ_MAX_MSGS; i++)
+    {
+        indqEntry_t *pEntry = &indqEntries[i];
+
+        if((pEntry->shortAddr != shortAddr) || (pEntry == pSkip))
+        {
+            continue;
+        }
+
+        if((pFound == NULL) || (pEntry->priority > pFound->priority)
+           || ((pEntry->priority == pFound->priority)
+               && ((now - pEntry->queued) > (now - pFound->queued))))
+        {
+            pFound = pEntry;
+        }
+    }
+
+    return (pFound);
+}
+
+/*!
+ * @brief       Find the message to drop to make room for a new one: the
+ *              longest waiting of the lowest priority below the new one.
+ *
+ * @param       priority - priority of the new message
+ *
+ * @return      entry, or NULL if every message has the same or a higher
+ *              priority
+ */
+static indqEntry_t *findVictim(uint8_t priority)
+{
+    uint32_t now = Clock_getTicks();
+    indqEntry_t *pFound = NULL;
+    uint8_t i;
+
+    for(i = 0; i < INDQ_MAX_MSGS; i++)
+    {
+        indqEntry_t *pEntry = &indqEntries[i];
+
+        if((pEntry->shortAddr == INDQ_FREE_ADDR)
+           || (pEntry->priority >= priority))
+        {
+            continue;
+        }
+
+        if((pFound == NULL) || (pEntry->priority < pFound->priority)
+           || ((pEntry->priority == pFound->priority)
+               && ((now - pEntry->queued) > (now - pFound->queued))))
+        {
+            pFound = pEntry;
+        }
+    }
+
+    return (pFound);
+}
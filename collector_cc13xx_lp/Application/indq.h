@@ -0,0 +1,191 @@
+/******************************************************************************
+
+ @file indq.h
+
+ @brief Collector pending message store for sleepy devices
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+#ifndef INDQ_H
+#define INDQ_H
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "api_mac.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*!
+ \defgroup Indq Pending Message Store
+ <BR>
+ Messages for devices that don't keep their receiver on (rxOnWhenIdle false)
+ are held here instead of in the MAC indirect queue, which only has room for
+ MAC_CFG_TX_DATA_MAX frames. The MAC asks the application whether data is
+ pending through MAC_CbackCheckPending() when a data request comes in and
+ reports the poll with a MAC_MLME_POLL_IND; the message is then sent to the
+ polling device as a direct frame.
+ <BR>
+ A device has at most one message of each command ID that is marked as
+ coalesced, a newer one replaces the older one. Messages are released
+ highest priority first, oldest first within a priority.
+ <BR>
+ */
+
+/*!
+ * \ingroup Indq
+ * @{
+ */
+
+/******************************************************************************
+ Constants and definitions
+ *****************************************************************************/
+
+/*! Number of messages held for all the sleepy devices */
+#if !defined(INDQ_MAX_MSGS)
+#define INDQ_MAX_MSGS          16
+#endif
+
+/*! Largest message payload, longer messages use the MAC indirect queue */
+#if !defined(INDQ_MAX_MSG_LEN)
+#define INDQ_MAX_MSG_LEN       16
+#endif
+
+/*!
+ Time in milliseconds a message waits for its device to poll before it
+ expires, about the same as the MAC transaction persistence time the
+ collector sets.
+ */
+#if !defined(INDQ_PERSISTENT_TIME)
+#define INDQ_PERSISTENT_TIME   15000
+#endif
+
+/*! Message priority, higher priority messages are released first */
+typedef enum
+{
+    /*! Periodic traffic, the first to be replaced when the store is full */
+    Indq_priority_low = 0,
+    /*! Default priority */
+    Indq_priority_normal = 1,
+    /*! Configuration */
+    Indq_priority_high = 2
+} Indq_priority_t;
+
+/*! A message released to a polling device */
+typedef struct _indq_msg_t
+{
+    /*! MSDU handle given to Indq_add() */
+    uint8_t msduHandle;
+    /*! More messages are waiting for the same device */
+    bool more;
+    /*! Payload length */
+    uint16_t len;
+    /*! Payload */
+    uint8_t data[INDQ_MAX_MSG_LEN];
+} Indq_msg_t;
+
+/*!
+ Dropped message function type, called with the MSDU handle of a message
+ that expired or was replaced by a higher priority message, and
+ ApiMac_status_transactionExpired or ApiMac_status_transactionOverflow.
+ */
+typedef void (*Indq_droppedFp_t)(uint8_t msduHandle, ApiMac_status_t status);
+
+/*! Pending message store statistics */
+typedef struct _indq_statistics_t
+{
+    /*! Messages added */
+    uint32_t queued;
+    /*! Messages sent to a polling device */
+    uint32_t released;
+    /*! Messages replaced by a newer message of the same command */
+    uint32_t coalesced;
+    /*! Messages that expired before their device polled */
+    uint32_t expired;
+    /*! Messages rejected or dropped because the store was full */
+    uint32_t overflows;
+    /*! Total time, in milliseconds, released messages waited */
+    uint32_t totalLatency;
+} Indq_statistics_t;
+
+/******************************************************************************
+ Global Variables
+ *****************************************************************************/
+
+/*! Pending message store statistics */
+extern Indq_statistics_t Indq_statistics;
+
+/******************************************************************************
+ Function Prototypes
+ *****************************************************************************/
+
+/*!
+ * @brief       Initialize the pending message store.
+ *
+ * @param       pDroppedFp - function called for a dropped message, or NULL
+ */
+extern void Indq_init(Indq_droppedFp_t pDroppedFp);
+
+/*!
+ * @brief       Hold a message until its device polls. Expired messages are
+ *              dropped first. When the store is full, the oldest message of
+ *              a lower priority is dropped to make room.
+ *
+ * @param       shortAddr - short address of the device
+ * @param       msduHandle - MSDU handle used when the message is released
+ * @param       priority - message priority
+ * @param       coalesce - true to replace a pending message with the same
+ *                         command ID (first payload byte)
+ * @param       len - payload length
+ * @param       pData - payload, copied
+ *
+ * @return      ApiMac_status_success,
+ *              ApiMac_status_invalidParameter when the payload is too long,
+ *              ApiMac_status_transactionOverflow when the store is full
+ */
+extern ApiMac_status_t Indq_add(uint16_t shortAddr, uint8_t msduHandle,
+                                Indq_priority_t priority, bool coalesce,
+                                uint16_t len, uint8_t *pData);
+
+/*!
+ * @brief       Take the next message for a device that polled.
+ *
+ * @param       shortAddr - short address of the device
+ * @param       pMsg - filled in with the message
+ *
+ * @return      true if a message was found
+ */
+extern bool Indq_get(uint16_t shortAddr, Indq_msg_t *pMsg);
+
+/*!
+ * @brief       Drop all of the messages of a device, without calling the
+ *              dropped message function.
+ *
+ * @param       shortAddr - short address of the device
+ */
+extern void Indq_remove(uint16_t shortAddr);
+
+/*!
+ * @brief       Number of messages held. Given to the MAC as its
+ *              MAC_CbackCheckPending() function, so it only reads a count
+ *              and may be called from the MAC task.
+ *
+ * @return      number of messages held
+ */
+extern uint8_t Indq_checkPending(void);
+
+/*! @} end group Indq */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INDQ_H */
@@ -50,7 +50,11 @@
 /******************************************************************************
  Includes
  *****************************************************************************/
+#if defined(MACTRACE_HOST)
+#include "mactrace.h"
+#else
 #include <ti/sysbios/knl/Clock.h>
+#endif
 
 #ifdef __cplusplus
 extern "C"
@@ -68,6 +72,17 @@ extern "C"
  Constants and definitions
  *****************************************************************************/
 
+#if defined(MACTRACE_HOST)
+/*!
+ Host builds run the timers on the virtual clock of the MAC trace replay,
+ see mactrace.h
+ */
+typedef uintptr_t UArg;
+typedef Mactrace_timerFp_t Clock_FuncPtr;
+typedef Mactrace_timer_t Clock_Struct;
+typedef Mactrace_timer_t *Clock_Handle;
+#endif
+
 /*!
  * \ingroup TimerClock
  * @{
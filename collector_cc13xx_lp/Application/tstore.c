@@ -0,0 +1,1085 @@
+/******************************************************************************
+
+ @file tstore.c
+
+ @brief Collector time-series store of sensor readings
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+#include <string.h>
+
+#include "tstore.h"
+
+#if TSTORE_ENABLED
+
+/******************************************************************************
+ Constants and definitions
+ *****************************************************************************/
+
+/*! Index of no block, ends a block list */
+#define TSTORE_NO_BLOCK         0xFF
+
+/*! Longest encoded reading: header, mask and a 5 byte varint per channel */
+#define TSTORE_READING_MAX      (5 + 1 + (5 * Tstore_chan_max))
+
+/*! Largest time delta-of-delta that fits the reading header */
+#define TSTORE_DOD_MAX          0x1FFFFFFF
+
+/*! All the channels */
+#define TSTORE_ALL_CHANS        ((1 << Tstore_chan_max) - 1)
+
+/*! Channels that are signed */
+#define TSTORE_SIGNED_CHANS     ((1 << Tstore_chan_ambienceTemp) \
+                                 | (1 << Tstore_chan_objectTemp) \
+                                 | (1 << Tstore_chan_rssi))
+
+/*! A block of readings */
+typedef struct
+{
+    /*! Time of the first reading */
+    uint32_t firstTime;
+    /*! Time of the last reading */
+    uint32_t lastTime;
+    /*! Next block of the device, or of the free list */
+    uint8_t next;
+    /*! Number of readings */
+    uint8_t count;
+    /*! Length of the readings */
+    uint8_t len;
+    /*! Readings */
+    uint8_t data[TSTORE_BLOCK_SIZE];
+} block_t;
+
+/*! A device with readings */
+typedef struct
+{
+    /*! true if the slot is in use */
+    bool used;
+    /*! Device short address */
+    uint16_t shortAddr;
+    /*! Oldest block */
+    uint8_t head;
+    /*! Newest block, the one written to */
+    uint8_t tail;
+    /*! Channels out of range above the high threshold */
+    uint8_t aboveHigh;
+    /*! Channels out of range below the low threshold */
+    uint8_t belowLow;
+    /*! Time of the last reading */
+    uint32_t lastTime;
+    /*! Encoder state of the newest block */
+    uint8_t chans;
+    int32_t timeDelta;
+    int32_t value[Tstore_chan_max];
+} device_t;
+
+/*! Thresholds of a channel */
+typedef struct
+{
+    int32_t low;
+    int32_t high;
+} threshold_t;
+
+/*! Decoder state of a block */
+typedef struct
+{
+    const uint8_t *pData;
+    const uint8_t *pEnd;
+    uint8_t remaining;
+    bool first;
+    uint8_t chans;
+    uint32_t time;
+    int32_t timeDelta;
+    int32_t value[Tstore_chan_max];
+} decoder_t;
+
+/******************************************************************************
+ Global variables
+ *****************************************************************************/
+
+/*! Store statistics */
+Tstore_statistics_t Tstore_statistics;
+
+/******************************************************************************
+ Local variables
+ *****************************************************************************/
+
+/*! Block pool */
+static block_t blocks[TSTORE_NUM_BLOCKS];
+
+/*! First free block */
+static uint8_t freeBlocks;
+
+/*! Devices with readings */
+static device_t devices[TSTORE_MAX_DEVICES];
+
+/*! Channel thresholds, and the channels they are enabled for */
+static threshold_t thresholds[Tstore_chan_max];
+static uint8_t thresholdChans;
+
+/******************************************************************************
+ Local function prototypes
+ *****************************************************************************/
+static device_t *findDevice(uint16_t shortAddr);
+static device_t *addDevice(uint16_t shortAddr);
+static void freeDeviceBlocks(device_t *pDev);
+static uint8_t allocBlock(void);
+static uint8_t encodeReading(device_t *pDev, const Tstore_reading_t *pReading,
+                             bool first, uint8_t *pBuf);
+static bool checkThresholds(device_t *pDev, const Tstore_reading_t *pReading);
+static void decodeInit(decoder_t *pDec, uint32_t firstTime, uint8_t count,
+                       const uint8_t *pData, uint8_t len);
+static bool decodeNext(decoder_t *pDec, Tstore_reading_t *pReading);
+static uint8_t putVarint(uint8_t *pBuf, uint32_t value);
+static bool getVarint(decoder_t *pDec, uint32_t *pValue);
+static uint32_t zigzag(int32_t value);
+static int32_t unzigzag(uint32_t value);
+static int32_t toValue(Tstore_chan_t chan, uint16_t raw);
+static uint16_t summaryRsp(const uint8_t *pReq, uint16_t reqLen,
+                           uint8_t *pRsp, uint16_t rspMax, uint8_t *pStatus);
+static uint16_t rawRsp(const uint8_t *pReq, uint16_t reqLen, uint8_t *pRsp,
+                       uint16_t rspMax, uint8_t *pStatus);
+static uint8_t thresholdReq(const uint8_t *pReq, uint16_t reqLen);
+static void put16(uint8_t *pBuf, uint16_t value);
+static void put32(uint8_t *pBuf, uint32_t value);
+static uint32_t get32(const uint8_t *pBuf);
+
+/******************************************************************************
+ Public Functions
+ *****************************************************************************/
+
+/*!
+ Empty the store and disable the thresholds.
+
+ Public function defined in tstore.h
+ */
+void Tstore_init(void)
+{
+    uint8_t i;
+
+    memset(&Tstore_statistics, 0, sizeof(Tstore_statistics_t));
+    memset(devices, 0, sizeof(devices));
+    thresholdChans = 0;
+
+    /* Chain all the blocks on the free list */
+    for(i = 0; i < TSTORE_NUM_BLOCKS; i++)
+    {
+        blocks[i].next = (uint8_t)(i + 1);
+    }
+    blocks[TSTORE_NUM_BLOCKS - 1].next = TSTORE_NO_BLOCK;
+    freeBlocks = 0;
+}
+
+/*!
+ Add a reading.
+
+ Public function defined in tstore.h
+ */
+bool Tstore_add(uint16_t shortAddr, const Tstore_reading_t *pReading)
+{
+    uint8_t buf[TSTORE_READING_MAX];
+    device_t *pDev;
+    block_t *pBlock = NULL;
+    uint8_t len = 0;
+
+    pDev = findDevice(shortAddr);
+    if(pDev == NULL)
+    {
+        pDev = addDevice(shortAddr);
+    }
+
+    if(pDev->tail != TSTORE_NO_BLOCK)
+    {
+        int32_t dod;
+
+        pBlock = &blocks[pDev->tail];
+
+        /* Readings out of order are stored at the time of the last one */
+        dod = (int32_t)(((pReading->time > pBlock->lastTime) ?
+                        (pReading->time - pBlock->lastTime) : 0)
+                        - (uint32_t)pDev->timeDelta);
+
+        if((pBlock->count < 0xFF) && (dod <= TSTORE_DOD_MAX)
+           && (dod >= -TSTORE_DOD_MAX))
+        {
+            len = encodeReading(pDev, pReading, false, buf);
+            if((pBlock->len + len) > TSTORE_BLOCK_SIZE)
+            {
+                len = 0;
+            }
+        }
+    }
+
+    if(len == 0)
+    {
+        /* Start a block, it holds the values whole */
+        uint8_t index = allocBlock();
+
+        /* The device may have lost all its blocks to the allocation */
+        if(pDev->tail == TSTORE_NO_BLOCK)
+        {
+            pDev->head = index;
+        }
+        else
+        {
+            blocks[pDev->tail].next = index;
+        }
+        pDev->tail = index;
+
+        pBlock = &blocks[index];
+        pBlock->next = TSTORE_NO_BLOCK;
+        pBlock->count = 0;
+        pBlock->len = 0;
+        pBlock->firstTime = (pReading->time > pDev->lastTime) ?
+                        pReading->time : pDev->lastTime;
+        pBlock->lastTime = pBlock->firstTime;
+
+        len = encodeReading(pDev, pReading, true, buf);
+    }
+    else
+    {
+        if(pReading->time > pBlock->lastTime)
+        {
+            pDev->timeDelta = (int32_t)(pReading->time - pBlock->lastTime);
+            pBlock->lastTime = pReading->time;
+        }
+        else
+        {
+            pDev->timeDelta = 0;
+        }
+    }
+
+    memcpy(&pBlock->data[pBlock->len], buf, len);
+    pBlock->len += len;
+    pBlock->count++;
+    pDev->lastTime = pBlock->lastTime;
+
+    Tstore_statistics.readings++;
+    Tstore_statistics.bytes += len;
+
+    return (checkThresholds(pDev, pReading));
+}
+
+/*!
+ Set the thresholds of a channel.
+
+ Public function defined in tstore.h
+ */
+bool Tstore_setThreshold(Tstore_chan_t chan, bool enable, int32_t low,
+                         int32_t high)
+{
+    uint8_t mask;
+    uint8_t i;
+
+    if((uint8_t)chan >= Tstore_chan_max)
+    {
+        return (false);
+    }
+
+    mask = (uint8_t)(1 << chan);
+    thresholds[chan].low = low;
+    thresholds[chan].high = high;
+    if(enable == true)
+    {
+        thresholdChans |= mask;
+    }
+    else
+    {
+        thresholdChans &= ~mask;
+    }
+
+    /* Start over in range, the next reading out of range is indicated */
+    for(i = 0; i < TSTORE_MAX_DEVICES; i++)
+    {
+        devices[i].aboveHigh &= ~mask;
+        devices[i].belowLow &= ~mask;
+    }
+
+    return (true);
+}
+
+/*!
+ Summarize a channel of a device over consecutive windows.
+
+ Public function defined in tstore.h
+ */
+bool Tstore_summarize(uint16_t shortAddr, Tstore_chan_t chan,
+                      uint32_t startTime, uint32_t windowLen,
+                      uint8_t numWindows, Tstore_summary_t *pSummaries)
+{
+    device_t *pDev = findDevice(shortAddr);
+    uint8_t mask = (uint8_t)(1 << chan);
+    uint8_t w;
+
+    if((pDev == NULL) || ((uint8_t)chan >= Tstore_chan_max)
+       || (windowLen == 0))
+    {
+        return (false);
+    }
+
+    for(w = 0; w < numWindows; w++)
+    {
+        Tstore_summary_t *pSum = &pSummaries[w];
+        uint32_t start = startTime + (w * windowLen);
+        uint32_t end = start + windowLen;
+        int64_t sum = 0;
+        uint8_t index;
+
+        memset(pSum, 0, sizeof(Tstore_summary_t));
+
+        /* Decode only the blocks that overlap the window */
+        for(index = pDev->head; index != TSTORE_NO_BLOCK;
+            index = blocks[index].next)
+        {
+            block_t *pBlock = &blocks[index];
+            Tstore_reading_t reading;
+            decoder_t dec;
+
+            if(pBlock->firstTime >= end)
+            {
+                break;
+            }
+            if(pBlock->lastTime < start)
+            {
+                continue;
+            }
+
+            decodeInit(&dec, pBlock->firstTime, pBlock->count, pBlock->data,
+                       pBlock->len);
+            while(decodeNext(&dec, &reading) == true)
+            {
+                int32_t value = reading.value[chan];
+
+                if((reading.time < start) || ((reading.chans & mask) == 0))
+                {
+                    continue;
+                }
+                if(reading.time >= end)
+                {
+                    break;
+                }
+
+                if((pSum->count == 0) || (value < pSum->min))
+                {
+                    pSum->min = value;
+                }
+                if((pSum->count == 0) || (value > pSum->max))
+                {
+                    pSum->max = value;
+                }
+                pSum->last = value;
+                sum += value;
+                if(pSum->count < 0xFFFF)
+                {
+                    pSum->count++;
+                }
+            }
+        }
+
+        if(pSum->count > 0)
+        {
+            pSum->mean = (int32_t)(sum / pSum->count);
+        }
+    }
+
+    return (true);
+}
+
+/*!
+ Decode the readings of a block.
+
+ Public function defined in tstore.h
+ */
+bool Tstore_decodeBlock(uint32_t firstTime, uint8_t count,
+                        const uint8_t *pData, uint8_t len,
+                        Tstore_reading_t *pReadings)
+{
+    decoder_t dec;
+    uint8_t i;
+
+    decodeInit(&dec, firstTime, count, pData, len);
+    for(i = 0; i < count; i++)
+    {
+        if(decodeNext(&dec, &pReadings[i]) == false)
+        {
+            return (false);
+        }
+    }
+
+    /* Every byte belongs to a reading */
+    return (dec.pData == dec.pEnd);
+}
+
+/*!
+ Run an MT CSF store request.
+
+ Public function defined in tstore.h
+ */
+uint16_t Tstore_processReq(uint32_t time, const uint8_t *pReq,
+                           uint16_t reqLen, uint8_t *pRsp, uint16_t rspMax)
+{
+    uint8_t status = Tstore_status_invalidParam;
+    uint16_t len = TSTORE_RSP_HDR_LEN;
+
+    if(rspMax < TSTORE_RSP_HDR_LEN)
+    {
+        return (0);
+    }
+
+    if(reqLen >= 1)
+    {
+        switch(pReq[0])
+        {
+            case Tstore_req_summary:
+                len += summaryRsp(&pReq[1], reqLen - 1,
+                                  &pRsp[TSTORE_RSP_HDR_LEN],
+                                  rspMax - TSTORE_RSP_HDR_LEN, &status);
+                break;
+
+            case Tstore_req_raw:
+                len += rawRsp(&pReq[1], reqLen - 1, &pRsp[TSTORE_RSP_HDR_LEN],
+                              rspMax - TSTORE_RSP_HDR_LEN, &status);
+                break;
+
+            case Tstore_req_threshold:
+                status = thresholdReq(&pReq[1], reqLen - 1);
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    pRsp[0] = status;
+    put32(&pRsp[1], time);
+
+    return (len);
+}
+
+/******************************************************************************
+ Local Functions
+ *****************************************************************************/
+
+/*!
+ * @brief       Find the slot of a device.
+ *
+ * @param       shortAddr - device short address
+ *
+ * @return      device slot, NULL if not found
+ */
+static device_t *findDevice(uint16_t shortAddr)
+{
+    uint8_t i;
+
+    for(i = 0; i < TSTORE_MAX_DEVICES; i++)
+    {
+        if((devices[i].used == true) && (devices[i].shortAddr == shortAddr))
+        {
+            return (&devices[i]);
+        }
+    }
+
+    return (NULL);
+}
+
+/*!
+ * @brief       Take a slot for a device, a free one or else the one of the
+ *              device that reported least recently.
+ *
+ * @param       shortAddr - device short address
+ *
+ * @return      device slot
+ */
+static device_t *addDevice(uint16_t shortAddr)
+{
+    device_t *pDev = NULL;
+    uint8_t i;
+
+    for(i = 0; i < TSTORE_MAX_DEVICES; i++)
+    {
+        if(devices[i].used == false)
+        {
+            pDev = &devices[i];
+            break;
+        }
+        if((pDev == NULL) || (devices[i].lastTime < pDev->lastTime))
+        {
+            pDev = &devices[i];
+        }
+    }
+
+    if(pDev->used == true)
+    {
+        freeDeviceBlocks(pDev);
+        Tstore_statistics.deviceEvictions++;
+    }
+
+    memset(pDev, 0, sizeof(device_t));
+    pDev->used = true;
+    pDev->shortAddr = shortAddr;
+    pDev->head = TSTORE_NO_BLOCK;
+    pDev->tail = TSTORE_NO_BLOCK;
+
+    return (pDev);
+}
+
+/*!
+ * @brief       Put the blocks of a device on the free list.
+ *
+ * @param       pDev - device slot
+ */
+static void freeDeviceBlocks(device_t *pDev)
+{
+    if(pDev->head != TSTORE_NO_BLOCK)
+    {
+        blocks[pDev->tail].next = freeBlocks;
+        freeBlocks = pDev->head;
+        pDev->head = TSTORE_NO_BLOCK;
+        pDev->tail = TSTORE_NO_BLOCK;
+    }
+}
+
+/*!
+ * @brief       Take a block, a free one or else the oldest block of all,
+ *              the oldest of the device whose oldest block started first.
+ *
+ * @return      block index
+ */
+static uint8_t allocBlock(void)
+{
+    device_t *pOldest = NULL;
+    uint8_t index;
+    uint8_t i;
+
+    if(freeBlocks != TSTORE_NO_BLOCK)
+    {
+        index = freeBlocks;
+        freeBlocks = blocks[index].next;
+        return (index);
+    }
+
+    for(i = 0; i < TSTORE_MAX_DEVICES; i++)
+    {
+        if((devices[i].used == true) && (devices[i].head != TSTORE_NO_BLOCK)
+           && ((pOldest == NULL) || (blocks[devices[i].head].firstTime
+                                     < blocks[pOldest->head].firstTime)))
+        {
+            pOldest = &devices[i];
+        }
+    }
+
+    /* The pool is never empty with no device holding a block */
+    index = pOldest->head;
+    pOldest->head = blocks[index].next;
+    if(pOldest->head == TSTORE_NO_BLOCK)
+    {
+        pOldest->tail = TSTORE_NO_BLOCK;
+    }
+
+    Tstore_statistics.evictions++;
+
+    return (index);
+}
+
+/*!
+ * @brief       Encode a reading and update the encoder state of the
+ *              device. The time state is updated by the caller.
+ *
+ * @param       pDev - device slot
+ * @param       pReading - reading
+ * @param       first - true for the first reading of a block
+ * @param       pBuf - encoded reading, TSTORE_READING_MAX bytes
+ *
+ * @return      length of the encoded reading
+ */
+static uint8_t encodeReading(device_t *pDev, const Tstore_reading_t *pReading,
+                             bool first, uint8_t *pBuf)
+{
+    uint8_t chans = pReading->chans & TSTORE_ALL_CHANS;
+    uint8_t len = 0;
+    uint8_t chan;
+
+    if(first == true)
+    {
+        /* Values and mask start from nothing, the time is in the header */
+        memset(pDev->value, 0, sizeof(pDev->value));
+        pDev->timeDelta = 0;
+        pBuf[len++] = chans;
+    }
+    else
+    {
+        uint32_t delta = (pReading->time > pDev->lastTime) ?
+                        (pReading->time - pDev->lastTime) : 0;
+        uint32_t header;
+
+        header = zigzag((int32_t)(delta - (uint32_t)pDev->timeDelta)) << 1;
+        if(chans != pDev->chans)
+        {
+            header |= 1;
+        }
+        len += putVarint(&pBuf[len], header);
+        if(chans != pDev->chans)
+        {
+            pBuf[len++] = chans;
+        }
+    }
+    pDev->chans = chans;
+
+    for(chan = 0; chan < Tstore_chan_max; chan++)
+    {
+        if(chans & (1 << chan))
+        {
+            len += putVarint(&pBuf[len],
+                             zigzag(pReading->value[chan]
+                                    - pDev->value[chan]));
+            pDev->value[chan] = pReading->value[chan];
+        }
+    }
+
+    return (len);
+}
+
+/*!
+ * @brief       Check a reading against the thresholds.
+ *
+ * @param       pDev - device slot
+ * @param       pReading - reading
+ *
+ * @return      true if a channel went out of range or came back, or if
+ *              no threshold is set
+ */
+static bool checkThresholds(device_t *pDev, const Tstore_reading_t *pReading)
+{
+    uint8_t checked = pReading->chans & thresholdChans;
+    uint8_t aboveHigh = pDev->aboveHigh;
+    uint8_t belowLow = pDev->belowLow;
+    uint8_t chan;
+
+    /* Until the host sets a threshold it's told of every reading */
+    if(thresholdChans == 0)
+    {
+        return (true);
+    }
+
+    if(checked == 0)
+    {
+        return (false);
+    }
+
+    for(chan = 0; chan < Tstore_chan_max; chan++)
+    {
+        uint8_t mask = (uint8_t)(1 << chan);
+
+        if(checked & mask)
+        {
+            aboveHigh &= ~mask;
+            belowLow &= ~mask;
+            if(pReading->value[chan] > thresholds[chan].high)
+            {
+                aboveHigh |= mask;
+            }
+            else if(pReading->value[chan] < thresholds[chan].low)
+            {
+                belowLow |= mask;
+            }
+        }
+    }
+
+    if((aboveHigh == pDev->aboveHigh) && (belowLow == pDev->belowLow))
+    {
+        return (false);
+    }
+
+    pDev->aboveHigh = aboveHigh;
+    pDev->belowLow = belowLow;
+    Tstore_statistics.events++;
+
+    return (true);
+}
+
+/*!
+ * @brief       Start decoding a block.
+ *
+ * @param       pDec - decoder state
+ * @param       firstTime - time of the first reading
+ * @param       count - number of readings
+ * @param       pData - readings
+ * @param       len - length of the readings
+ */
+static void decodeInit(decoder_t *pDec, uint32_t firstTime, uint8_t count,
+                       const uint8_t *pData, uint8_t len)
+{
+    memset(pDec, 0, sizeof(decoder_t));
+    pDec->pData = pData;
+    pDec->pEnd = pData + len;
+    pDec->remaining = count;
+    pDec->first = true;
+    pDec->time = firstTime;
+}
+
+/*!
+ * @brief       Decode the next reading of a block.
+ *
+ * @param       pDec - decoder state
+ * @param       pReading - reading
+ *
+ * @return      true if decoded, false at the end of the block or if it is
+ *              malformed
+ */
+static bool decodeNext(decoder_t *pDec, Tstore_reading_t *pReading)
+{
+    uint32_t value;
+    uint8_t chan;
+
+    if(pDec->remaining == 0)
+    {
+        return (false);
+    }
+
+    if(pDec->first == true)
+    {
+        if(pDec->pData >= pDec->pEnd)
+        {
+            return (false);
+        }
+        pDec->chans = *pDec->pData++;
+        pDec->first = false;
+    }
+    else
+    {
+        if(getVarint(pDec, &value) == false)
+        {
+            return (false);
+        }
+        pDec->timeDelta += unzigzag(value >> 1);
+        pDec->time += (uint32_t)pDec->timeDelta;
+        if(value & 1)
+        {
+            if(pDec->pData >= pDec->pEnd)
+            {
+                return (false);
+            }
+            pDec->chans = *pDec->pData++;
+        }
+    }
+
+    for(chan = 0; chan < Tstore_chan_max; chan++)
+    {
+        if(pDec->chans & (1 << chan))
+        {
+            if(getVarint(pDec, &value) == false)
+            {
+                return (false);
+            }
+            pDec->value[chan] += unzigzag(value);
+        }
+    }
+
+    pReading->time = pDec->time;
+    pReading->chans = pDec->chans;
+    memcpy(pReading->value, pDec->value, sizeof(pReading->value));
+    pDec->remaining--;
+
+    return (true);
+}
+
+/*!
+ * @brief       Write a varint.
+ *
+ * @param       pBuf - buffer, 5 bytes at least
+ * @param       value - value
+ *
+ * @return      number of bytes written
+ */
+static uint8_t putVarint(uint8_t *pBuf, uint32_t value)
+{
+    uint8_t len = 0;
+
+    while(value >= 0x80)
+    {
+        pBuf[len++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    pBuf[len++] = (uint8_t)value;
+
+    return (len);
+}
+
+/*!
+ * @brief       Read a varint.
+ *
+ * @param       pDec - decoder state
+ * @param       pValue - value
+ *
+ * @return      true if read, false if the block ended first
+ */
+static bool getVarint(decoder_t *pDec, uint32_t *pValue)
+{
+    uint32_t value = 0;
+    uint8_t shift;
+
+    for(shift = 0; shift < 35; shift += 7)
+    {
+        uint8_t byte;
+
+        if(pDec->pData >= pDec->pEnd)
+        {
+            return (false);
+        }
+        byte = *pDec->pData++;
+        value |= (uint32_t)(byte & 0x7F) << shift;
+        if((byte & 0x80) == 0)
+        {
+            *pValue = value;
+            return (true);
+        }
+    }
+
+    return (false);
+}
+
+/*!
+ * @brief       Zigzag code a signed value, small magnitudes give small
+ *              codes.
+ *
+ * @param       value - signed value
+ *
+ * @return      code
+ */
+static uint32_t zigzag(int32_t value)
+{
+    return (((uint32_t)value << 1) ^ (uint32_t)(value >> 31));
+}
+
+/*!
+ * @brief       Decode a zigzag code.
+ *
+ * @param       value - code
+ *
+ * @return      signed value
+ */
+static int32_t unzigzag(uint32_t value)
+{
+    return ((int32_t)(value >> 1) ^ -(int32_t)(value & 1));
+}
+
+/*!
+ * @brief       Convert a 16 bit value from a request to a channel value.
+ *
+ * @param       chan - channel
+ * @param       raw - value
+ *
+ * @return      channel value, sign extended for the signed channels
+ */
+static int32_t toValue(Tstore_chan_t chan, uint16_t raw)
+{
+    if(TSTORE_SIGNED_CHANS & (1 << chan))
+    {
+        return ((int16_t)raw);
+    }
+
+    return (raw);
+}
+
+/*!
+ * @brief       Build a summary response.
+ *
+ * @param       pReq - request, after its type
+ * @param       reqLen - request length
+ * @param       pRsp - response data
+ * @param       rspMax - size of the response data
+ * @param       pStatus - response status
+ *
+ * @return      length of the response data
+ */
+static uint16_t summaryRsp(const uint8_t *pReq, uint16_t reqLen,
+                           uint8_t *pRsp, uint16_t rspMax, uint8_t *pStatus)
+{
+    Tstore_summary_t sum;
+    uint16_t shortAddr;
+    uint32_t startTime;
+    uint32_t windowLen;
+    uint8_t chan;
+    uint8_t numWindows;
+    uint16_t len = 1;
+    uint8_t w;
+
+    if((reqLen != 12) || (rspMax < 1))
+    {
+        return (0);
+    }
+
+    shortAddr = (uint16_t)(pReq[0] | (pReq[1] << 8));
+    chan = pReq[2];
+    startTime = get32(&pReq[3]);
+    windowLen = get32(&pReq[7]);
+    numWindows = pReq[11];
+
+    if((chan >= Tstore_chan_max) || (windowLen == 0))
+    {
+        return (0);
+    }
+    if(findDevice(shortAddr) == NULL)
+    {
+        *pStatus = Tstore_status_noDevice;
+        return (0);
+    }
+
+    /* Windows that don't fit the response are left out */
+    if(numWindows > ((rspMax - 1) / TSTORE_SUMMARY_LEN))
+    {
+        numWindows = (uint8_t)((rspMax - 1) / TSTORE_SUMMARY_LEN);
+    }
+
+    for(w = 0; w < numWindows; w++)
+    {
+        Tstore_summarize(shortAddr, (Tstore_chan_t)chan,
+                         startTime + (w * windowLen), windowLen, 1, &sum);
+        put16(&pRsp[len], sum.count);
+        put16(&pRsp[len + 2], (uint16_t)sum.min);
+        put16(&pRsp[len + 4], (uint16_t)sum.max);
+        put16(&pRsp[len + 6], (uint16_t)sum.mean);
+        put16(&pRsp[len + 8], (uint16_t)sum.last);
+        len += TSTORE_SUMMARY_LEN;
+    }
+    pRsp[0] = numWindows;
+
+    *pStatus = Tstore_status_success;
+
+    return (len);
+}
+
+/*!
+ * @brief       Build a raw response.
+ *
+ * @param       pReq - request, after its type
+ * @param       reqLen - request length
+ * @param       pRsp - response data
+ * @param       rspMax - size of the response data
+ * @param       pStatus - response status
+ *
+ * @return      length of the response data
+ */
+static uint16_t rawRsp(const uint8_t *pReq, uint16_t reqLen, uint8_t *pRsp,
+                       uint16_t rspMax, uint8_t *pStatus)
+{
+    device_t *pDev;
+    uint32_t startTime;
+    uint8_t numBlocks = 0;
+    uint16_t len = 1;
+    uint8_t index;
+
+    if((reqLen != 6) || (rspMax < 1))
+    {
+        return (0);
+    }
+
+    pDev = findDevice((uint16_t)(pReq[0] | (pReq[1] << 8)));
+    if(pDev == NULL)
+    {
+        *pStatus = Tstore_status_noDevice;
+        return (0);
+    }
+    startTime = get32(&pReq[2]);
+
+    /*
+     Whole blocks only, the host asks again from the last time it got plus
+     one for the rest
+     */
+    for(index = pDev->head; index != TSTORE_NO_BLOCK;
+        index = blocks[index].next)
+    {
+        block_t *pBlock = &blocks[index];
+
+        if(pBlock->lastTime < startTime)
+        {
+            continue;
+        }
+        if((len + TSTORE_BLOCK_HDR_LEN + pBlock->len) > rspMax)
+        {
+            break;
+        }
+
+        put32(&pRsp[len], pBlock->firstTime);
+        pRsp[len + 4] = pBlock->count;
+        pRsp[len + 5] = pBlock->len;
+        memcpy(&pRsp[len + TSTORE_BLOCK_HDR_LEN], pBlock->data, pBlock->len);
+        len += TSTORE_BLOCK_HDR_LEN + pBlock->len;
+        numBlocks++;
+    }
+    pRsp[0] = numBlocks;
+
+    *pStatus = Tstore_status_success;
+
+    return (len);
+}
+
+/*!
+ * @brief       Run a threshold request.
+ *
+ * @param       pReq - request, after its type
+ * @param       reqLen - request length
+ *
+ * @return      response status
+ */
+static uint8_t thresholdReq(const uint8_t *pReq, uint16_t reqLen)
+{
+    Tstore_chan_t chan;
+
+    if((reqLen != 6) || (pReq[0] >= Tstore_chan_max))
+    {
+        return (Tstore_status_invalidParam);
+    }
+
+    chan = (Tstore_chan_t)pReq[0];
+    Tstore_setThreshold(chan, (pReq[1] != 0),
+                        toValue(chan, (uint16_t)(pReq[2] | (pReq[3] << 8))),
+                        toValue(chan, (uint16_t)(pReq[4] | (pReq[5] << 8))));
+
+    return (Tstore_status_success);
+}
+
+/*!
+ * @brief       Write a 16 bit value, little endian.
+ *
+ * @param       pBuf - buffer
+ * @param       value - value
+ */
+static void put16(uint8_t *pBuf, uint16_t value)
+{
+    pBuf[0] = (uint8_t)value;
+    pBuf[1] = (uint8_t)(value >> 8);
+}
+
+/*!
+ * @brief       Write a 32 bit value, little endian.
+ *
+ * @param       pBuf - buffer
+ * @param       value - value
+ */
+static void put32(uint8_t *pBuf, uint32_t value)
+{
+    put16(pBuf, (uint16_t)value);
+    put16(&pBuf[2], (uint16_t)(value >> 16));
+}
+
+/*!
+ * @brief       Read a 32 bit value, little endian.
+ *
+ * @param       pBuf - buffer
+ *
+ * @return      value
+ */
+static uint32_t get32(const uint8_t *pBuf)
+{
+    return ((uint32_t)pBuf[0] | ((uint32_t)pBuf[1] << 8)
+            | ((uint32_t)pBuf[2] << 16) | ((uint32_t)pBuf[3] << 24));
+}
+
+#endif /* TSTORE_ENABLED */
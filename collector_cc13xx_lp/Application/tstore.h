@@ -0,0 +1,308 @@
+/******************************************************************************
+
+ @file tstore.h
+
+ @brief Collector time-series store of sensor readings
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+#ifndef TSTORE_H
+#define TSTORE_H
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*!
+ \defgroup Tstore Time-Series Store
+ <BR>
+ Every sensor report used to become an MT indication to the host with the
+ whole parsed message. With the store built, readings are kept in RAM
+ instead and the host asks for them: windowed summaries of a channel, or
+ the compressed blocks themselves to decode on its side. Every reading is
+ still indicated until the host sets a threshold, from then on an
+ indication is only sent when a channel crosses one of the thresholds.
+ <BR>
+ Readings are written to blocks of TSTORE_BLOCK_SIZE bytes taken from a
+ pool shared by all devices, each device keeping its blocks as a list from
+ oldest to newest. When the pool is empty the oldest block of all is taken
+ back, so a device that reports often doesn't push out the history of one
+ that doesn't.
+ <BR>
+ The first reading of a block holds its values whole, the time is in the
+ block header. Each later reading is a varint of the time delta-of-delta,
+ shifted up by one with the low bit set when the channel mask follows,
+ then the channel mask if it changed, then the delta from the previous
+ value of each channel in the mask. Varints are 7 bits a byte, low group
+ first, the top bit set on all but the last, and signed values are zigzag
+ coded first. A device reporting at a steady interval with slowly moving
+ values takes a byte per reading plus a byte per channel.
+ <BR>
+ Times are in units of TSTORE_TIME_RES_MS and are given by the caller.
+ The store has no lock of its own, csf.c adds the readings and runs the
+ host requests, through Csf_sensorSeriesReq(), under its lock. The host
+ sends them as MT_UTIL_SENSOR_SERIES, see mt.h, the request and response
+ below are the data of the MT frames.
+ <BR>
+ The store is built with TSTORE_ENABLED set to 1. It doesn't use the
+ RTOS, so it also builds on a host to run with synthetic readings.
+ <BR>
+ */
+
+/*!
+ * \ingroup Tstore
+ * @{
+ */
+
+/******************************************************************************
+ Constants and definitions
+ *****************************************************************************/
+
+/*! Set to 1 to build the store */
+#if !defined(TSTORE_ENABLED)
+#define TSTORE_ENABLED          0
+#endif
+
+/*! Number of devices with readings in the store */
+#if !defined(TSTORE_MAX_DEVICES)
+#define TSTORE_MAX_DEVICES      16
+#endif
+
+/*! Number of blocks in the pool */
+#if !defined(TSTORE_NUM_BLOCKS)
+#define TSTORE_NUM_BLOCKS       32
+#endif
+
+/*!
+ Size of the readings in a block, 255 at most. A raw response holds whole
+ blocks, so a block and the headers must fit the MT response.
+ */
+#if !defined(TSTORE_BLOCK_SIZE)
+#define TSTORE_BLOCK_SIZE       64
+#endif
+
+/*! Time resolution, in milliseconds */
+#if !defined(TSTORE_TIME_RES_MS)
+#define TSTORE_TIME_RES_MS      100
+#endif
+
+/*! Length of a block header in a raw read: first time, count and length */
+#define TSTORE_BLOCK_HDR_LEN    6
+
+/*! Length of a window summary in a summary read */
+#define TSTORE_SUMMARY_LEN      10
+
+/*! Length of a response header: status and time */
+#define TSTORE_RSP_HDR_LEN      5
+
+/*! Reading channels */
+typedef enum
+{
+    /*! Ambience temperature, int16_t */
+    Tstore_chan_ambienceTemp = 0,
+    /*! Object temperature, int16_t */
+    Tstore_chan_objectTemp = 1,
+    /*! Light sensor raw data, uint16_t */
+    Tstore_chan_light = 2,
+    /*! Humidity sensor temperature, uint16_t */
+    Tstore_chan_humidityTemp = 3,
+    /*! Humidity, uint16_t */
+    Tstore_chan_humidity = 4,
+    /*! RSSI of the report, int8_t */
+    Tstore_chan_rssi = 5,
+    /*! Number of channels */
+    Tstore_chan_max = 6
+} Tstore_chan_t;
+
+/*! MT request types, the first byte of a request */
+typedef enum
+{
+    /*!
+     Windowed summaries of a channel. Request: short address (2), channel
+     (1), start time (4), window length (4), number of windows (1).
+     Response: number of windows (1), then for each the number of readings
+     (2), min (2), max (2), mean (2) and last value (2).
+     */
+    Tstore_req_summary = 0,
+    /*!
+     Compressed blocks of a device holding readings at or after a time.
+     Request: short address (2), start time (4). Response: number of
+     blocks (1), then for each its first time (4), number of readings (1),
+     length (1) and readings.
+     */
+    Tstore_req_raw = 1,
+    /*!
+     Set the thresholds of a channel. Request: channel (1), enable (1),
+     low (2), high (2). Response: nothing more.
+     */
+    Tstore_req_threshold = 2
+} Tstore_req_t;
+
+/*! MT response status, the first byte of a response */
+typedef enum
+{
+    /*! Success */
+    Tstore_status_success = 0,
+    /*! Malformed request or bad parameter */
+    Tstore_status_invalidParam = 1,
+    /*! No readings from the device */
+    Tstore_status_noDevice = 2,
+    /*! Store not built */
+    Tstore_status_unsupported = 3
+} Tstore_status_t;
+
+/*! A reading */
+typedef struct _tstore_reading_t
+{
+    /*! Time, in units of TSTORE_TIME_RES_MS */
+    uint32_t time;
+    /*! Channels present, bit (1 << Tstore_chan_t) */
+    uint8_t chans;
+    /*! Values, sign extended for the signed channels */
+    int32_t value[Tstore_chan_max];
+} Tstore_reading_t;
+
+/*! Summary of a channel over a window */
+typedef struct _tstore_summary_t
+{
+    /*! Number of readings in the window, the rest is 0 if none */
+    uint16_t count;
+    /*! Smallest value */
+    int32_t min;
+    /*! Largest value */
+    int32_t max;
+    /*! Mean value, rounded toward zero */
+    int32_t mean;
+    /*! Newest value */
+    int32_t last;
+} Tstore_summary_t;
+
+/*! Store statistics */
+typedef struct _tstore_statistics_t
+{
+    /*! Readings added */
+    uint32_t readings;
+    /*! Bytes of readings written to blocks */
+    uint32_t bytes;
+    /*! Blocks taken back from a device to reuse */
+    uint32_t evictions;
+    /*! Device slots reused for another device */
+    uint16_t deviceEvictions;
+    /*! Threshold events */
+    uint16_t events;
+} Tstore_statistics_t;
+
+/******************************************************************************
+ Global Variables
+ *****************************************************************************/
+
+#if TSTORE_ENABLED
+/*! Store statistics */
+extern Tstore_statistics_t Tstore_statistics;
+#endif
+
+/******************************************************************************
+ Function Prototypes
+ *****************************************************************************/
+
+#if TSTORE_ENABLED
+/*!
+ * @brief       Empty the store and disable the thresholds, every reading
+ *              is indicated until one is set.
+ */
+extern void Tstore_init(void);
+
+/*!
+ * @brief       Add a reading. When the store has no slot for the device,
+ *              the slot of the device that reported least recently is
+ *              reused.
+ *
+ * @param       shortAddr - device short address
+ * @param       pReading - reading, channels not in chans are ignored
+ *
+ * @return      true if the reading should be indicated to the host: a
+ *              channel crossed a threshold, into or out of range, or no
+ *              threshold is set
+ */
+extern bool Tstore_add(uint16_t shortAddr, const Tstore_reading_t *pReading);
+
+/*!
+ * @brief       Set the thresholds of a channel. A channel is in range while
+ *              low <= value <= high.
+ *
+ * @param       chan - channel
+ * @param       enable - false to disable the thresholds of the channel
+ * @param       low - low threshold
+ * @param       high - high threshold
+ *
+ * @return      true if set, false for a bad channel
+ */
+extern bool Tstore_setThreshold(Tstore_chan_t chan, bool enable, int32_t low,
+                                int32_t high);
+
+/*!
+ * @brief       Summarize a channel of a device over consecutive windows.
+ *
+ * @param       shortAddr - device short address
+ * @param       chan - channel
+ * @param       startTime - start of the first window
+ * @param       windowLen - length of each window, not 0
+ * @param       numWindows - number of windows
+ * @param       pSummaries - summary of each window
+ *
+ * @return      true if summarized, false if the device has no readings
+ */
+extern bool Tstore_summarize(uint16_t shortAddr, Tstore_chan_t chan,
+                             uint32_t startTime, uint32_t windowLen,
+                             uint8_t numWindows, Tstore_summary_t *pSummaries);
+
+/*!
+ * @brief       Decode the readings of a block, as returned by a raw read.
+ *              Used by hosts, the store decodes its own blocks the same way.
+ *
+ * @param       firstTime - time of the first reading of the block
+ * @param       count - number of readings in the block
+ * @param       pData - readings
+ * @param       len - length of the readings
+ * @param       pReadings - decoded readings, count of them
+ *
+ * @return      true if decoded, false if the block is malformed
+ */
+extern bool Tstore_decodeBlock(uint32_t firstTime, uint8_t count,
+                               const uint8_t *pData, uint8_t len,
+                               Tstore_reading_t *pReadings);
+
+/*!
+ * @brief       Run an MT CSF store request.
+ *
+ * @param       time - current time
+ * @param       pReq - request, starting with its Tstore_req_t
+ * @param       reqLen - request length
+ * @param       pRsp - response, a Tstore_status_t, the time and the data
+ * @param       rspMax - size of the response buffer, TSTORE_RSP_HDR_LEN at
+ *                       least, readings that don't fit are left out
+ *
+ * @return      response length
+ */
+extern uint16_t Tstore_processReq(uint32_t time, const uint8_t *pReq,
+                                  uint16_t reqLen, uint8_t *pRsp,
+                                  uint16_t rspMax);
+#endif
+
+/*! @} end group Tstore */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TSTORE_H */
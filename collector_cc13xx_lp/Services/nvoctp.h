@@ -0,0 +1,104 @@
+/******************************************************************************
+
+ @file  nvoctp.h
+
+ @brief NV definitions for CC26xx devices - On-Chip Two-Page Flash Memory
+
+ Group: WCS, LPC, BTS
+ Target Device: CC13xx
+
+ ******************************************************************************
+ 
+ Copyright (c) 2014-2016, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ Release Name: ti-15.4-stack-sdk_2_00_00_25
+ Release Date: 2016-07-14 14:37:14
+ *****************************************************************************/
+
+#ifndef NVOCTP_H
+#define NVOCTP_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+// Includes
+//*****************************************************************************
+
+#include "nvintf.h"
+
+//*****************************************************************************
+// Constants and definitions
+//*****************************************************************************
+
+// NV driver item ID definitions
+#define NVOCTP_NVID_DIAG {NVINTF_SYSID_NVDRVR, 1, 0}
+
+// Exception function can be defined to handle NV corruption issues
+// If none provided, NV module attempts to proceed ignoring problem
+#if !defined (NVOCTP_EXCEPTION)
+#define NVOCTP_EXCEPTION(pg, err)
+#endif
+
+//*****************************************************************************
+// Typedefs
+//*****************************************************************************
+
+// NV driver diagnostic data
+typedef struct
+{
+    uint32_t compacts;  // Number of page compactions
+    uint16_t resets;    // Number of driver resets (power on)
+    uint16_t available; // Number of available bytes after last compaction
+    uint16_t active;    // Number of active items after last compaction
+    uint16_t reserved;  // Reserved for future use
+} NVOCTP_diag_t;
+
+//*****************************************************************************
+// Functions
+//*****************************************************************************
+
+extern void NVOCTP_loadApiPtrs(NVINTF_nvFuncts_t *pfn);
+
+// Not part of the NV driver API, see the description in nvoctp.c
+extern uint8_t NVOCTP_listItems(NVINTF_itemID_t *pStart,
+                                NVINTF_itemID_t *pIds,
+                                uint16_t *pLens,
+                                uint8_t maxIds);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NVOCTP_H */
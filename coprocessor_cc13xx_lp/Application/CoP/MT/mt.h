@@ -145,6 +145,10 @@ typedef struct
 #define MT_MAC_READ_KEY_REQ        0x37
 /*! MT command code - MAC Security Write Key request */
 #define MT_MAC_WRITE_KEY_REQ       0x38
+/*! MT command code - MAC Security Add Devices request, a list of devices */
+#define MT_MAC_ADD_DEVICES_REQ     0x39
+/*! MT command code - MAC Security Delete Devices request, a list of devices */
+#define MT_MAC_DELETE_DEVICES_REQ  0x3A
 
 /*! MT command code - MAC Frequency Hop Enable request */
 #define MT_MAC_FH_ENABLE_REQ       0x40
@@ -233,6 +237,12 @@ typedef struct
 #define MT_SYS_NV_UPDATE           0x35
 /*! MT command code - SYS NV Compact request */
 #define MT_SYS_NV_COMPACT          0x36
+/*! MT command code - SYS NV Enumerate request, a list of item IDs */
+#define MT_SYS_NV_ENUM             0x37
+/*! MT command code - SYS NV Read Items request, a list of items */
+#define MT_SYS_NV_READ_ITEMS       0x38
+/*! MT command code - SYS NV Write Items request, a list of items */
+#define MT_SYS_NV_WRITE_ITEMS      0x39
 
 /*
  SYS AREQ indication to host
@@ -252,6 +262,17 @@ typedef struct
 #define MT_UTIL_LOOPBACK           0x10
 /*! MT command code - UTIL Random Number request */
 #define MT_UTIL_RANDOM             0x12
+/*! MT command code - UTIL Probe Statistics request, see probe.h */
+#define MT_UTIL_PROBE_STATS        0x30
+/*! MT command code - UTIL Power Statistics request, see pwracct.h */
+#define MT_UTIL_PWR_STATS          0x31
+/*! MT command code - UTIL MAC Trace request, see mactrace.h */
+#define MT_UTIL_MAC_TRACE          0x32
+/*!
+ MT command code - UTIL Sensor Series request of the collector, the data is
+ a Tstore_req_t and its parameters, see tstore.h
+ */
+#define MT_UTIL_SENSOR_SERIES      0x33
 /*! MT command code - UTIL Extended Address request */
 #define MT_UTIL_EXT_ADDR           0xEE
 
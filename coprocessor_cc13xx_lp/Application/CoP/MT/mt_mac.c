@@ -223,8 +223,10 @@ static void macSyncReq(Mt_mpb_t *pMpb);
 
 /* Security PIB request/response functions */
 static void macAddDeviceReq(Mt_mpb_t *pMpb);
+static void macAddDevicesReq(Mt_mpb_t *pMpb);
 static void macDeleteAllDevicesReq(Mt_mpb_t *pMpb);
 static void macDeleteDeviceReq(Mt_mpb_t *pMpb);
+static void macDeleteDevicesReq(Mt_mpb_t *pMpb);
 static void macDeleteKeyReq(Mt_mpb_t *pMpb);
 static void macGetSecReq(Mt_mpb_t *pMpb);
 static void macReadKeyReq(Mt_mpb_t *pMpb);
@@ -240,6 +242,7 @@ static void nBeaconInd(ApiMac_mlmeBeaconNotifyInd_t *pInd);
 /* General utility functions */
 static uint8_t *copyExtAdr(uint8_t *pDst, uint8_t *pSrc);
 static uint8_t *macAdrToSba(uint8_t *pDst, ApiMac_sAddr_t *pSrc);
+static void macSbaToAddDevice(ApiMac_secAddDevice_t *pDst, uint8_t *pSrc);
 static void macSbaToAdr(ApiMac_sAddr_t *pDst, uint8_t *pSrc);
 static void macSbaToSec(ApiMac_sec_t *pDst, uint8_t *pSrc);
 static void macSecToSba(uint8_t *pDst, ApiMac_sec_t *pSrc);
@@ -247,6 +250,7 @@ static void parseOptBits(uint8_t optBits, ApiMac_txOptions_t *txOptions);
 static void sendCRSP(uint8_t rId, uint16_t rLen, uint8_t *pRsp);
 static void sendDRSP(uint8_t rId, uint16_t rLen, uint8_t *pRsp);
 static void sendSRSP(uint8_t rId, uint8_t rsp);
+static void sendDevicesSRSP(uint8_t rId, uint8_t rsp, uint8_t accepted);
 
 /* Security PIB utility functions */
 static uint8_t bufferDeviceEntry(uint8_t *pDst, void *pSrc);
@@ -367,6 +371,14 @@ uint8_t MtMac_commandProcessing(Mt_mpb_t *pMpb)
             macDeleteDeviceReq(pMpb);
             break;
 
+        case MT_MAC_ADD_DEVICES_REQ:
+            macAddDevicesReq(pMpb);
+            break;
+
+        case MT_MAC_DELETE_DEVICES_REQ:
+            macDeleteDevicesReq(pMpb);
+            break;
+
         case MT_MAC_DELETE_ALL_REQ:
             macDeleteAllDevicesReq(pMpb);
             break;
@@ -455,46 +467,86 @@ static void macAddDeviceReq(Mt_mpb_t *pMpb)
 
     if(pMpb->length == sizeof(MtPkt_addDevReq_t))
     {
-        uint8_t *pBuf = pMpb->pData;
         ApiMac_secAddDevice_t aReq;
 
-        /* New device's Pan ID */
-        aReq.panID = Util_parseUint16(pBuf);
-        pBuf += 2;
+        macSbaToAddDevice(&aReq, pMpb->pData);
 
-        /* New device's short address */
-        aReq.shortAddr = Util_parseUint16(pBuf);
-        pBuf += 2;
+        /* Send request to the MAC task */
+        status = ApiMac_secAddDevice(&aReq);
+    }
 
-        /* New device's extended address */
-        (void)copyExtAdr(aReq.extAddr, pBuf);
-        pBuf += APIMAC_SADDR_EXT_LEN;
+    /* Send host a response */
+    sendSRSP(MT_MAC_ADD_DEVICE_REQ, status);
+}
 
-        /* Frame counter */
-        aReq.frameCounter = Util_parseUint32(pBuf);
-        pBuf += 4;
+/*!
+ * @brief   Process MAC_ADD_DEVICES_REQ command issued by host. The request
+ *          is a device count followed by that many MtPkt_addDevReq_t. A
+ *          long list is sent as several requests, or as one request using
+ *          extended fragmentation.
+ *
+ * @param   pMpb - pointer to incoming message parameter block
+ */
+static void macAddDevicesReq(Mt_mpb_t *pMpb)
+{
+    uint8_t status = ApiMac_status_lengthError;
+    uint8_t accepted = 0;
 
-        /* Minimum security override indicator */
-        aReq.exempt = *pBuf++;
+    if((pMpb->length >= 1) && (pMpb->length ==
+       (1 + (pMpb->pData[0] * sizeof(MtPkt_addDevReq_t)))))
+    {
+        uint8_t count = pMpb->pData[0];
+        ApiMac_secAddDevice_t *pReq = NULL;
+        ApiMac_status_t *pStatus = NULL;
 
-        /* Key device descriptor uniqueDevice indicator */
-        aReq.uniqueDevice = *pBuf++;
+        status = ApiMac_status_success;
 
-        /* Duplicate device entry indicator */
-        aReq.duplicateDevFlag = *pBuf++;
+        if(count > 0)
+        {
+            pReq = ICall_malloc(count * sizeof(ApiMac_secAddDevice_t));
+            pStatus = ICall_malloc(count * sizeof(ApiMac_status_t));
 
-        /* Key ID lookup data size indicator, 0=5 bytes, 1=9 bytes */
-        aReq.keyIdLookupDataSize = *pBuf++;
+            if((pReq == NULL) || (pStatus == NULL))
+            {
+                /* Not enough memory for the device list */
+                status = ApiMac_status_noResources;
+            }
+            else
+            {
+                uint8_t *pBuf = pMpb->pData + 1;
+                uint8_t i;
 
-        /* Key ID lookup data */
-        memcpy(&aReq.keyIdLookupData, pBuf, APIMAC_MAX_KEY_LOOKUP_LEN);
+                for(i = 0; i < count; i++)
+                {
+                    macSbaToAddDevice(&pReq[i], pBuf);
+                    pBuf += sizeof(MtPkt_addDevReq_t);
+                }
 
-        /* Send request to the MAC task */
-        status = ApiMac_secAddDevice(&aReq);
+                /* Send request to the MAC task */
+                status = ApiMac_secAddDevices(pReq, count, pStatus);
+
+                for(i = 0; i < count; i++)
+                {
+                    if(pStatus[i] == ApiMac_status_success)
+                    {
+                        accepted++;
+                    }
+                }
+            }
+
+            if(pReq != NULL)
+            {
+                ICall_free(pReq);
+            }
+            if(pStatus != NULL)
+            {
+                ICall_free(pStatus);
+            }
+        }
     }
 
     /* Send host a response */
-    sendSRSP(MT_MAC_ADD_DEVICE_REQ, status);
+    sendDevicesSRSP(MT_MAC_ADD_DEVICES_REQ, status, accepted);
 }
 
 /*!
@@ -737,6 +789,33 @@ static void macDeleteDeviceReq(Mt_mpb_t *pMpb)
     sendSRSP(MT_MAC_DELETE_DEVICE_REQ, status);
 }
 
+/*!
+ * @brief   Process MAC_DELETE_DEVICES_REQ command issued by host. The
+ *          request is a device count followed by that many extended
+ *          addresses.
+ *
+ * @param   pMpb - pointer to incoming message parameter block
+ */
+static void macDeleteDevicesReq(Mt_mpb_t *pMpb)
+{
+    uint8_t status = ApiMac_status_lengthError;
+    uint8_t count = 0;
+
+    if((pMpb->length >= 1) && (pMpb->length ==
+       (1 + (pMpb->pData[0] * sizeof(MtPkt_delDevReq_t)))))
+    {
+        count = pMpb->pData[0];
+
+        /* Send request to the MAC task */
+        status = ApiMac_secDeleteDevices((ApiMac_sAddrExt_t *)&pMpb->pData[1],
+                                         count);
+    }
+
+    /* Send host a response */
+    sendDevicesSRSP(MT_MAC_DELETE_DEVICES_REQ, status,
+                    (status == ApiMac_status_success) ? count : 0);
+}
+
 /*!
  * @brief   Process MAC_DELETE_KEY_ID_REQ command issued by host
  *
@@ -2995,6 +3074,46 @@ static uint8_t* macAdrToSba(uint8_t *pDst, ApiMac_sAddr_t *pSrc)
     return(pDst);
 }
 
+/*!
+ * @brief   Convert a serial byte array to an ApiMac add device structure
+ *
+ * @param   pDst - pointer to ApiMac add device structure
+ * @param   pSrc - pointer to a packed MtPkt_addDevReq_t
+ */
+static void macSbaToAddDevice(ApiMac_secAddDevice_t *pDst, uint8_t *pSrc)
+{
+    /* New device's Pan ID */
+    pDst->panID = Util_parseUint16(pSrc);
+    pSrc += 2;
+
+    /* New device's short address */
+    pDst->shortAddr = Util_parseUint16(pSrc);
+    pSrc += 2;
+
+    /* New device's extended address */
+    (void)copyExtAdr(pDst->extAddr, pSrc);
+    pSrc += APIMAC_SADDR_EXT_LEN;
+
+    /* Frame counter */
+    pDst->frameCounter = Util_parseUint32(pSrc);
+    pSrc += 4;
+
+    /* Minimum security override indicator */
+    pDst->exempt = *pSrc++;
+
+    /* Key device descriptor uniqueDevice indicator */
+    pDst->uniqueDevice = *pSrc++;
+
+    /* Duplicate device entry indicator */
+    pDst->duplicateDevFlag = *pSrc++;
+
+    /* Key ID lookup data size indicator, 0=5 bytes, 1=9 bytes */
+    pDst->keyIdLookupDataSize = *pSrc++;
+
+    /* Key ID lookup data */
+    memcpy(&pDst->keyIdLookupData, pSrc, APIMAC_MAX_KEY_LOOKUP_LEN);
+}
+
 /*!
  * @brief   Copy an address from an serial byte array to an ApiMac struct
  *          The addrMode in pDst must already be set.
@@ -3157,6 +3276,23 @@ static void sendSRSP(uint8_t rspId, uint8_t rsp)
     (void)MT_sendResponse(MT_SRSP_MAC, rspId, 1, &rsp);
 }
 
+/*!
+ * @brief   Send MT SRSP message of a device list request
+ *
+ * @param   rspId - MT response message ID
+ * @param   rsp - first failing status
+ * @param   accepted - number of devices added or deleted
+ */
+static void sendDevicesSRSP(uint8_t rspId, uint8_t rsp, uint8_t accepted)
+{
+    uint8_t rBuf[2];
+
+    rBuf[0] = rsp;
+    rBuf[1] = accepted;
+
+    (void)MT_sendResponse(MT_SRSP_MAC, rspId, sizeof(rBuf), rBuf);
+}
+
 /*!
  * @brief   Parse txOptions bits to ApiMac txOptions structure
  *
@@ -1106,6 +1106,75 @@ typedef struct
     uint8_t data[];
 } MtPkt_nvUpdate_t;
 
+/*! Packed serial command packet - NV Enumerate */
+typedef struct
+{
+    /*! First System ID to list */
+    uint8_t sysId[1];
+    /*! First Item ID to list */
+    uint8_t itemId[2];
+    /*! First Sub ID to list */
+    uint8_t subId[2];
+    /*! Maximum number of items to list */
+    uint8_t count[1];
+} MtPkt_nvEnum_t;
+
+/*! Packed serial response entry - NV Enumerate, one per item listed */
+typedef struct
+{
+    /*! System ID */
+    uint8_t sysId[1];
+    /*! Item ID */
+    uint8_t itemId[2];
+    /*! Sub ID */
+    uint8_t subId[2];
+    /*! Data length */
+    uint8_t length[2];
+} MtPkt_nvEnumItem_t;
+
+/*!
+ Packed serial command entry - NV Read Items. The command is an item count
+ followed by that many entries.
+ */
+typedef struct
+{
+    /*! System ID */
+    uint8_t sysId[1];
+    /*! Item ID */
+    uint8_t itemId[2];
+    /*! Sub ID */
+    uint8_t subId[2];
+} MtPkt_nvReadItem_t;
+
+/*! Packed serial response entry - NV Read Items, one per item read */
+typedef struct
+{
+    /*! Read status */
+    uint8_t status[1];
+    /*! Data length, 0 if not read */
+    uint8_t length[2];
+    /*! Data block */
+    uint8_t data[];
+} MtPkt_nvReadItemRsp_t;
+
+/*!
+ Packed serial command entry - NV Write Items. The command is an options
+ byte and an item count followed by that many entries.
+ */
+typedef struct
+{
+    /*! System ID */
+    uint8_t sysId[1];
+    /*! Item ID */
+    uint8_t itemId[2];
+    /*! Sub ID */
+    uint8_t subId[2];
+    /*! Data length */
+    uint8_t length[2];
+    /*! Data block */
+    uint8_t data[];
+} MtPkt_nvWriteItem_t;
+
 /******************************************************************************
  Typedefs - MT_UTIL Command Packed Structures
  *****************************************************************************/
@@ -1134,6 +1203,29 @@ typedef struct
     uint8_t timeout[4];
 } MtPkt_loopBack_t;
 
+/*! Packed serial command packet - Probe Statistics */
+typedef struct
+{
+    /*! Probe ID */
+    uint8_t probeId[1];
+    /*! Non-zero to clear the statistics once read */
+    uint8_t reset[1];
+} MtPkt_probeStats_t;
+
+/*! Packed serial command packet - Power Statistics */
+typedef struct
+{
+    /*! Non-zero to clear the statistics once read */
+    uint8_t reset[1];
+} MtPkt_pwrStats_t;
+
+/*! Packed serial command packet - MAC Trace */
+typedef struct
+{
+    /*! Most record bytes to return */
+    uint8_t maxLen[2];
+} MtPkt_macTrace_t;
+
 #ifdef __cplusplus
 }
 #endif
@@ -54,6 +54,7 @@
 #include "api_mac.h"
 #include "macconfig.h"
 #include "nvintf.h"
+#include "nvoctp.h"
 
 #include "mt_pkt.h"
 #include "mt_sys.h"
@@ -101,6 +102,20 @@
 /*! NV driver item ID for reset reason */
 #define MTSYS_NVID_RESET {NVINTF_SYSID_APP, 1, 0}
 
+/*! Maximum number of items listed by an NV Enumerate response */
+#define MTSYS_NV_ENUM_MAX  32
+
+/*!
+ Maximum length of an NV Read Items response, sent with extended
+ fragmentation when longer than an MT frame
+ */
+#if !defined(MTSYS_NV_READ_MAX)
+#define MTSYS_NV_READ_MAX  1024
+#endif
+
+/*! NV Write Items option - put back the items written if a write fails */
+#define MTSYS_NV_ATOMIC    0x01
+
 /******************************************************************************
  Constants
  *****************************************************************************/
@@ -149,15 +164,20 @@ static NVINTF_nvFuncts_t *pNV = &Main_user1Cfg.nvFps;
 static void compactNvPage(Mt_mpb_t *pMpb);
 static void createNvItem(Mt_mpb_t *pMpb);
 static void deleteNvItem(Mt_mpb_t *pMpb);
+static void enumNvItems(Mt_mpb_t *pMpb);
 static void getNvLength(Mt_mpb_t *pMpb);
 static void getVersion(Mt_mpb_t *pMpb);
 static void pingSystem(Mt_mpb_t *pMpb);
 static void readNvItem(Mt_mpb_t *pMpb);
+static void readNvItems(Mt_mpb_t *pMpb);
 static void writeNvItem(Mt_mpb_t *pMpb);
+static void writeNvItems(Mt_mpb_t *pMpb);
 
 /* Utility functions */
 static uint8_t mapNvError(uint8_t error);
 static uint8_t *parseNvExtId(uint8_t *pBuf, NVINTF_itemID_t *nvId);
+static bool checkNvItems(uint8_t *pBuf, uint8_t count, uint16_t length);
+static void freeNvItems(uint8_t **ppSave, uint8_t count);
 static void sendDRSP(uint8_t rspId, uint16_t rspLen, uint8_t *rspPtr);
 static void sendSRSP(uint8_t rId, uint8_t rsp);
 
@@ -212,6 +232,18 @@ uint8_t MtSys_commandProcessing(Mt_mpb_t *pMpb)
             compactNvPage(pMpb);
             break;
 
+        case MT_SYS_NV_ENUM:
+            enumNvItems(pMpb);
+            break;
+
+        case MT_SYS_NV_READ_ITEMS:
+            readNvItems(pMpb);
+            break;
+
+        case MT_SYS_NV_WRITE_ITEMS:
+            writeNvItems(pMpb);
+            break;
+
         default:
             status = ApiMac_status_commandIDError;
             break;
@@ -397,6 +429,97 @@ static void deleteNvItem(Mt_mpb_t *pMpb)
     sendSRSP(MT_SYS_NV_DELETE, status);
 }
 
+/*!
+ * @brief   List the NV items, in order of ID, starting at an ID. The
+ *          response is the status, the number of items listed, the ID to
+ *          start the next request at and a MtPkt_nvEnumItem_t per item.
+ *          Fewer items than requested means the list is complete.
+ *
+ * @param   pMpb - pointer to incoming message parameter block
+ */
+static void enumNvItems(Mt_mpb_t *pMpb)
+{
+    uint8_t status = ApiMac_status_lengthError;
+    uint8_t count = 0;
+    uint8_t *pRspBuf = NULL;
+    uint8_t rspLen = 7;  /* Rsp header: status, count, next ID */
+    NVINTF_itemID_t nvId = {0, 0, 0};
+
+    if(pMpb->length == sizeof(MtPkt_nvEnum_t))
+    {
+        NVINTF_itemID_t *pIds;
+        uint16_t *pLens;
+        uint8_t maxCount;
+
+        /* Get the NV ID parameters of the first item */
+        maxCount = *parseNvExtId(pMpb->pData, &nvId);
+
+        if(maxCount > MTSYS_NV_ENUM_MAX)
+        {
+            /* The response fits in one MT frame */
+            maxCount = MTSYS_NV_ENUM_MAX;
+        }
+
+        pIds = ICall_malloc(maxCount * sizeof(NVINTF_itemID_t));
+        pLens = ICall_malloc(maxCount * sizeof(uint16_t));
+        pRspBuf = ICall_malloc(rspLen
+                               + (maxCount * sizeof(MtPkt_nvEnumItem_t)));
+
+        if((pIds != NULL) && (pLens != NULL) && (pRspBuf != NULL))
+        {
+            uint8_t *pBuf = &pRspBuf[rspLen];
+            uint8_t i;
+
+            /* One pass over the NV page lists all items of the response */
+            count = NVOCTP_listItems(&nvId, pIds, pLens, maxCount);
+            status = ApiMac_status_success;
+
+            for(i = 0; i < count; i++)
+            {
+                *pBuf++ = pIds[i].systemID;
+                pBuf = Util_bufferUint16(pBuf, pIds[i].itemID);
+                pBuf = Util_bufferUint16(pBuf, pIds[i].subID);
+                pBuf = Util_bufferUint16(pBuf, pLens[i]);
+            }
+            rspLen += count * sizeof(MtPkt_nvEnumItem_t);
+        }
+        else
+        {
+            /* Could not get buffers for the list */
+            status = ApiMac_status_noResources;
+        }
+
+        if(pIds != NULL)
+        {
+            ICall_free(pIds);
+        }
+        if(pLens != NULL)
+        {
+            ICall_free(pLens);
+        }
+    }
+
+    if(status == ApiMac_status_success)
+    {
+        pRspBuf[0] = status;
+        pRspBuf[1] = count;
+        pRspBuf[2] = nvId.systemID;
+        (void)Util_bufferUint16(&pRspBuf[3], nvId.itemID);
+        (void)Util_bufferUint16(&pRspBuf[5], nvId.subID);
+        sendDRSP(MT_SYS_NV_ENUM, rspLen, pRspBuf);
+    }
+    else
+    {
+        uint8_t tmp[7] = {status, 0, 0, 0, 0, 0, 0};
+        sendDRSP(MT_SYS_NV_ENUM, sizeof(tmp), tmp);
+    }
+
+    if(pRspBuf != NULL)
+    {
+        ICall_free(pRspBuf);
+    }
+}
+
 /*!
  * @brief   Process the SYS_VERSION command issued by host
  *
@@ -528,6 +651,99 @@ static void readNvItem(Mt_mpb_t *pMpb)
     }
 }
 
+/*!
+ * @brief   Read a list of NV items, each in full. The response is the
+ *          status, the number of items answered and a MtPkt_nvReadItemRsp_t
+ *          per item. Items are answered in order until the response would
+ *          grow past MTSYS_NV_READ_MAX, the host asks again for the rest.
+ *
+ * @param   pMpb - pointer to incoming message parameter block
+ */
+static void readNvItems(Mt_mpb_t *pMpb)
+{
+    uint8_t status = ApiMac_status_lengthError;
+    uint8_t count = 0;
+    uint8_t *pRspBuf = NULL;
+    uint16_t rspLen = 2;  /* Rsp header: status, count */
+    uint8_t *pData = pMpb->pData;
+
+    if((pMpb->length >= 1) && (pMpb->length ==
+       (1 + (pData[0] * sizeof(MtPkt_nvReadItem_t)))))
+    {
+        if((pNV->readItem == NULL) || (pNV->getItemLen == NULL))
+        {
+            /* NV item length/read function not available */
+            status = ApiMac_status_unsupported;
+        }
+        else
+        {
+            pRspBuf = ICall_malloc(MTSYS_NV_READ_MAX);
+            if(pRspBuf == NULL)
+            {
+                /* Could not get buffer for NV data */
+                status = ApiMac_status_noResources;
+            }
+        }
+    }
+
+    if(pRspBuf != NULL)
+    {
+        uint8_t *pBuf = &pData[1];
+
+        status = ApiMac_status_success;
+
+        while(count < pData[0])
+        {
+            NVINTF_itemID_t nvId;
+            uint32_t nvLen;
+            uint8_t itemStatus;
+            uint8_t *pItem = &pRspBuf[rspLen];
+
+            /* Get the NV ID parameters */
+            pBuf = parseNvExtId(pBuf, &nvId);
+
+            nvLen = pNV->getItemLen(nvId);
+            if((rspLen + sizeof(MtPkt_nvReadItemRsp_t) + nvLen)
+               <= MTSYS_NV_READ_MAX)
+            {
+                /* Attempt to read the whole item */
+                itemStatus = mapNvError(pNV->readItem(nvId, 0, nvLen,
+                                                      &pItem[3]));
+            }
+            else if(count > 0)
+            {
+                /* Left for the next request */
+                break;
+            }
+            else
+            {
+                /* Item can't be read in one response */
+                itemStatus = ApiMac_status_noResources;
+            }
+
+            if(itemStatus != ApiMac_status_success)
+            {
+                nvLen = 0;
+            }
+
+            pItem[0] = itemStatus;
+            (void)Util_bufferUint16(&pItem[1], nvLen);
+            rspLen += sizeof(MtPkt_nvReadItemRsp_t) + nvLen;
+            count++;
+        }
+
+        pRspBuf[0] = status;
+        pRspBuf[1] = count;
+        sendDRSP(MT_SYS_NV_READ_ITEMS, rspLen, pRspBuf);
+        ICall_free(pRspBuf);
+    }
+    else
+    {
+        uint8_t tmp[2] = {status, 0};
+        sendDRSP(MT_SYS_NV_READ_ITEMS, sizeof(tmp), tmp);
+    }
+}
+
 /*!
  * @brief   Attempt to write an NV item
  *
@@ -589,6 +805,154 @@ static void writeNvItem(Mt_mpb_t *pMpb)
     sendSRSP(cmdId, status);
 }
 
+/*!
+ * @brief   Write a list of NV items, each in full, creating those that
+ *          don't exist. The command is the options, the number of items
+ *          and a MtPkt_nvWriteItem_t per item, the response the status and
+ *          the number of items written. The items are written in order and
+ *          the first failure stops the list. With MTSYS_NV_ATOMIC set, the
+ *          items are read before being written, and the items written are
+ *          put back if a write fails.
+ *
+ * @param   pMpb - pointer to incoming message parameter block
+ */
+static void writeNvItems(Mt_mpb_t *pMpb)
+{
+    uint8_t status = ApiMac_status_lengthError;
+    uint8_t count = 0;
+    uint8_t rspBuf[2];
+    uint8_t *pData = pMpb->pData;
+
+    if((pMpb->length >= 2)
+       && (checkNvItems(&pData[2], pData[1], pMpb->length - 2) == true))
+    {
+        uint8_t options = pData[0];
+        uint8_t **ppSave = NULL;
+        uint8_t *pBuf;
+        uint8_t i;
+
+        status = ApiMac_status_success;
+
+        if(pNV->writeItem == NULL)
+        {
+            /* NV item write function not available */
+            status = ApiMac_status_unsupported;
+        }
+        else if((options & MTSYS_NV_ATOMIC) && (pData[1] > 0))
+        {
+            if((pNV->readItem == NULL) || (pNV->getItemLen == NULL)
+               || (pNV->deleteItem == NULL))
+            {
+                /* Items can't be put back */
+                status = ApiMac_status_unsupported;
+            }
+            else if((ppSave = ICall_malloc(pData[1] * sizeof(uint8_t *)))
+                    == NULL)
+            {
+                status = ApiMac_status_noResources;
+            }
+            else
+            {
+                memset(ppSave, 0, pData[1] * sizeof(uint8_t *));
+                pBuf = &pData[2];
+
+                /* Save the items about to be written, NULL if not found */
+                for(i = 0; i < pData[1]; i++)
+                {
+                    NVINTF_itemID_t nvId;
+                    uint32_t nvLen;
+                    uint8_t err;
+
+                    pBuf = parseNvExtId(pBuf, &nvId);
+                    pBuf += 2 + Util_parseUint16(pBuf);
+
+                    nvLen = pNV->getItemLen(nvId);
+                    ppSave[i] = ICall_malloc(2 + nvLen);
+                    if(ppSave[i] == NULL)
+                    {
+                        status = ApiMac_status_noResources;
+                        break;
+                    }
+
+                    err = pNV->readItem(nvId, 0, nvLen, &ppSave[i][2]);
+                    if(err == NVINTF_NOTFOUND)
+                    {
+                        /* Deleted if a write fails */
+                        ICall_free(ppSave[i]);
+                        ppSave[i] = NULL;
+                    }
+                    else if(err != NVINTF_SUCCESS)
+                    {
+                        status = mapNvError(err);
+                        break;
+                    }
+                    else
+                    {
+                        (void)Util_bufferUint16(ppSave[i], nvLen);
+                    }
+                }
+            }
+        }
+
+        if(status == ApiMac_status_success)
+        {
+            pBuf = &pData[2];
+
+            for(count = 0; count < pData[1]; count++)
+            {
+                NVINTF_itemID_t nvId;
+                uint16_t dataLen;
+
+                pBuf = parseNvExtId(pBuf, &nvId);
+                dataLen = Util_parseUint16(pBuf);
+                pBuf += 2;
+
+                /* Attempt to write (create) the specified item */
+                status = mapNvError(pNV->writeItem(nvId, dataLen, pBuf));
+                if(status != ApiMac_status_success)
+                {
+                    break;
+                }
+                pBuf += dataLen;
+            }
+
+            if((status != ApiMac_status_success) && (ppSave != NULL))
+            {
+                /* Put back the items written */
+                pBuf = &pData[2];
+                for(i = 0; i < count; i++)
+                {
+                    NVINTF_itemID_t nvId;
+
+                    pBuf = parseNvExtId(pBuf, &nvId);
+                    pBuf += 2 + Util_parseUint16(pBuf);
+
+                    if(ppSave[i] == NULL)
+                    {
+                        (void)pNV->deleteItem(nvId);
+                    }
+                    else
+                    {
+                        (void)pNV->writeItem(nvId, Util_parseUint16(ppSave[i]),
+                                             &ppSave[i][2]);
+                    }
+                }
+                count = 0;
+            }
+        }
+
+        if(ppSave != NULL)
+        {
+            freeNvItems(ppSave, pData[1]);
+        }
+    }
+
+    /* Build and send back the response */
+    rspBuf[0] = status;
+    rspBuf[1] = count;
+    sendDRSP(MT_SYS_NV_WRITE_ITEMS, sizeof(rspBuf), rspBuf);
+}
+
 /******************************************************************************
  Local Utility Functions
  *****************************************************************************/
@@ -649,6 +1013,63 @@ static uint8_t *parseNvExtId(uint8_t *pBuf, NVINTF_itemID_t *nvId)
     return(pBuf + 5);
 }
 
+/*!
+ * @brief   Check that a list of MtPkt_nvWriteItem_t fills a command
+ *
+ * @param   pBuf   - pointer to the first item
+ * @param   count  - number of items
+ * @param   length - length of the list
+ *
+ * @return  true if the items end at the end of the list
+ */
+static bool checkNvItems(uint8_t *pBuf, uint8_t count, uint16_t length)
+{
+    uint8_t i;
+
+    for(i = 0; i < count; i++)
+    {
+        uint16_t itemLen;
+
+        if(length < sizeof(MtPkt_nvWriteItem_t))
+        {
+            return(false);
+        }
+
+        itemLen = sizeof(MtPkt_nvWriteItem_t)
+                  + Util_parseUint16(&pBuf[sizeof(MtPkt_nvWriteItem_t) - 2]);
+        if(length < itemLen)
+        {
+            return(false);
+        }
+
+        pBuf += itemLen;
+        length -= itemLen;
+    }
+
+    return(length == 0);
+}
+
+/*!
+ * @brief   Free the items saved by writeNvItems()
+ *
+ * @param   ppSave - pointer to the saved items, NULL entries not saved
+ * @param   count  - number of entries
+ */
+static void freeNvItems(uint8_t **ppSave, uint8_t count)
+{
+    uint8_t i;
+
+    for(i = 0; i < count; i++)
+    {
+        if(ppSave[i] != NULL)
+        {
+            ICall_free(ppSave[i]);
+        }
+    }
+
+    ICall_free(ppSave);
+}
+
 /*!
  * @brief   Wrapper for MT_sendResponse() for MT_SYS ARSP
  *
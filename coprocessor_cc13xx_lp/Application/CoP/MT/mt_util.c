@@ -58,6 +58,12 @@
 #include "mt_sys.h"
 #include "mt_util.h"
 #include "util.h"
+#include "probe.h"
+#include "pwracct.h"
+#include "mactrace.h"
+#if TSTORE_ENABLED
+#include "csf.h"
+#endif
 
 #if defined(MT_UTIL_FUNC)
 /******************************************************************************
@@ -78,6 +84,23 @@
 /*! Default loopback timer (milliseconds) */
 #define DEFAULT_LOOPBACK_TIME  1000
 
+/*!
+ Probe statistics response: status, probe ID, tick rate, count, minimum,
+ maximum, sum, number of histogram bins and the bins
+ */
+#define PROBE_STATS_RSP_LEN (2 + 4 + 12 + 8 + 1 + (2 * PROBE_HIST_BINS))
+
+/*!
+ Power statistics response: status, tick rate, elapsed time, number of task
+ classes and their times, standby time, idle time, number of wakeup causes
+ and their counts
+ */
+#define PWR_STATS_RSP_LEN (1 + 4 + 4 + 1 + (4 * Pwracct_task_max) + 8 + 1 \
+                           + (2 * Pwracct_wake_max))
+
+/*! MAC trace response header: status and length of the records */
+#define MAC_TRACE_RSP_HDR_LEN 3
+
 /******************************************************************************
  Local Function Prototypes
  *****************************************************************************/
@@ -86,6 +109,18 @@ static void getExtAddr(Mt_mpb_t *pMpb);
 static void getRandomNbr(Mt_mpb_t *pMpb);
 static void sendLoopBack(Mt_mpb_t *pMpb);
 static void setCallbacks(Mt_mpb_t *pMpb);
+#if PROBE_ENABLED
+static void getProbeStats(Mt_mpb_t *pMpb);
+#endif
+#if PWRACCT_ENABLED
+static void getPwrStats(Mt_mpb_t *pMpb);
+#endif
+#if MACTRACE_ENABLED
+static void getMacTrace(Mt_mpb_t *pMpb);
+#endif
+#if TSTORE_ENABLED
+static void getSensorSeries(Mt_mpb_t *pMpb);
+#endif
 
 /* Utility functions */
 static void loopTimerCB(UArg a0);
@@ -137,6 +172,30 @@ uint8_t MtUtil_commandProcessing(Mt_mpb_t *pMpb)
             getExtAddr(pMpb);
             break;
 
+#if PROBE_ENABLED
+        case MT_UTIL_PROBE_STATS:
+            getProbeStats(pMpb);
+            break;
+#endif
+
+#if PWRACCT_ENABLED
+        case MT_UTIL_PWR_STATS:
+            getPwrStats(pMpb);
+            break;
+#endif
+
+#if MACTRACE_ENABLED
+        case MT_UTIL_MAC_TRACE:
+            getMacTrace(pMpb);
+            break;
+#endif
+
+#if TSTORE_ENABLED
+        case MT_UTIL_SENSOR_SERIES:
+            getSensorSeries(pMpb);
+            break;
+#endif
+
         default:
             status = ApiMac_status_commandIDError;
             break;
@@ -262,6 +321,165 @@ static void getExtAddr(Mt_mpb_t *pMpb)
     sendSRSP(MT_UTIL_EXT_ADDR, sizeof(rsp), rsp);
 }
 
+#if PROBE_ENABLED
+/*!
+ * @brief   Process MT_UTIL_PROBE_STATS command issued by host, one probe
+ *          per request so the response fits in a frame
+ *
+ * @param   pMpb - pointer to incoming message parameter block
+ */
+static void getProbeStats(Mt_mpb_t *pMpb)
+{
+    uint8_t *pReq = (uint8_t *)pMpb->pData;
+    uint8_t rsp[PROBE_STATS_RSP_LEN];
+    uint8_t *pBuf = rsp;
+    Probe_stats_t stats;
+    uint8_t probeId = 0xFF;
+    uint8_t i;
+
+    memset(&stats, 0, sizeof(Probe_stats_t));
+
+    if(pMpb->length != sizeof(MtPkt_probeStats_t))
+    {
+        /* Invalid incoming message length */
+        *pBuf++ = ApiMac_status_lengthError;
+    }
+    else if(pReq[0] >= Probe_id_max)
+    {
+        /* Past the last probe, the host stops asking */
+        probeId = pReq[0];
+        *pBuf++ = ApiMac_status_invalidParameter;
+    }
+    else
+    {
+        probeId = pReq[0];
+        Probe_read((Probe_id_t)probeId, &stats,
+                   (pReq[1] != 0) ? true : false);
+        *pBuf++ = ApiMac_status_success;
+    }
+
+    *pBuf++ = probeId;
+    pBuf = Util_bufferUint32(pBuf, PROBE_TICK_HZ);
+    pBuf = Util_bufferUint32(pBuf, stats.count);
+    pBuf = Util_bufferUint32(pBuf, stats.min);
+    pBuf = Util_bufferUint32(pBuf, stats.max);
+    pBuf = Util_bufferUint32(pBuf, (uint32_t)stats.sum);
+    pBuf = Util_bufferUint32(pBuf, (uint32_t)(stats.sum >> 32));
+    *pBuf++ = PROBE_HIST_BINS;
+    for(i = 0; i < PROBE_HIST_BINS; i++)
+    {
+        pBuf = Util_bufferUint16(pBuf, stats.hist[i]);
+    }
+
+    sendSRSP(MT_UTIL_PROBE_STATS, sizeof(rsp), rsp);
+}
+#endif /* PROBE_ENABLED */
+
+#if PWRACCT_ENABLED
+/*!
+ * @brief   Process MT_UTIL_PWR_STATS command issued by host
+ *
+ * @param   pMpb - pointer to incoming message parameter block
+ */
+static void getPwrStats(Mt_mpb_t *pMpb)
+{
+    uint8_t *pReq = (uint8_t *)pMpb->pData;
+    uint8_t rsp[PWR_STATS_RSP_LEN];
+    uint8_t *pBuf = rsp;
+    Pwracct_stats_t stats;
+    uint8_t i;
+
+    memset(&stats, 0, sizeof(Pwracct_stats_t));
+
+    if(pMpb->length != sizeof(MtPkt_pwrStats_t))
+    {
+        /* Invalid incoming message length */
+        *pBuf++ = ApiMac_status_lengthError;
+    }
+    else
+    {
+        Pwracct_read(&stats, (pReq[0] != 0) ? true : false);
+        *pBuf++ = ApiMac_status_success;
+    }
+
+    pBuf = Util_bufferUint32(pBuf, PWRACCT_TICK_HZ);
+    pBuf = Util_bufferUint32(pBuf, stats.elapsed);
+    *pBuf++ = Pwracct_task_max;
+    for(i = 0; i < Pwracct_task_max; i++)
+    {
+        pBuf = Util_bufferUint32(pBuf, stats.taskTime[i]);
+    }
+    pBuf = Util_bufferUint32(pBuf, stats.standbyTime);
+    pBuf = Util_bufferUint32(pBuf, stats.idleTime);
+    *pBuf++ = Pwracct_wake_max;
+    for(i = 0; i < Pwracct_wake_max; i++)
+    {
+        pBuf = Util_bufferUint16(pBuf, stats.wakeups[i]);
+    }
+
+    sendSRSP(MT_UTIL_PWR_STATS, sizeof(rsp), rsp);
+}
+#endif /* PWRACCT_ENABLED */
+
+#if MACTRACE_ENABLED
+/*!
+ * @brief   Process MT_UTIL_MAC_TRACE command issued by host. Whole records
+ *          are drained, as many as fit in one frame, the host asks again
+ *          until none are left.
+ *
+ * @param   pMpb - pointer to incoming message parameter block
+ */
+static void getMacTrace(Mt_mpb_t *pMpb)
+{
+    uint8_t *pReq = (uint8_t *)pMpb->pData;
+    uint8_t rsp[MTRPC_DATA_MAX];
+    uint16_t maxLen;
+    uint16_t len = 0;
+
+    if(pMpb->length != sizeof(MtPkt_macTrace_t))
+    {
+        /* Invalid incoming message length */
+        rsp[0] = ApiMac_status_lengthError;
+    }
+    else
+    {
+        maxLen = Util_buildUint16(pReq[0], pReq[1]);
+        if(maxLen > (sizeof(rsp) - MAC_TRACE_RSP_HDR_LEN))
+        {
+            maxLen = sizeof(rsp) - MAC_TRACE_RSP_HDR_LEN;
+        }
+
+        len = Mactrace_read(&rsp[MAC_TRACE_RSP_HDR_LEN], maxLen);
+        rsp[0] = ApiMac_status_success;
+    }
+
+    rsp[1] = Util_loUint16(len);
+    rsp[2] = Util_hiUint16(len);
+
+    sendSRSP(MT_UTIL_MAC_TRACE, (MAC_TRACE_RSP_HDR_LEN + len), rsp);
+}
+#endif /* MACTRACE_ENABLED */
+
+#if TSTORE_ENABLED
+/*!
+ * @brief   Process MT_UTIL_SENSOR_SERIES command issued by host, run on the
+ *          time-series store of the collector. Readings that don't fit in
+ *          one frame are left out, the host asks again from the last one.
+ *
+ * @param   pMpb - pointer to incoming message parameter block
+ */
+static void getSensorSeries(Mt_mpb_t *pMpb)
+{
+    uint8_t rsp[MTRPC_DATA_MAX];
+    uint16_t len;
+
+    len = Csf_sensorSeriesReq((uint8_t *)pMpb->pData, pMpb->length, rsp,
+                              sizeof(rsp));
+
+    sendSRSP(MT_UTIL_SENSOR_SERIES, len, rsp);
+}
+#endif /* TSTORE_ENABLED */
+
 /*!
  * @brief   Process MT_UTIL_LOOPBACK command issued by host
  *
@@ -84,6 +84,7 @@ by starting the search at the last entry in the page (higher memory address).
 #include "hal_mcu.h"
 #include "nvoctp.h"
 #include "pwrmon.h"
+#include "probe.h"
 #include "driverlib/vims.h"
 
 //*****************************************************************************
@@ -126,6 +127,11 @@ by starting the search at the last entry in the page (higher memory address).
 // Block size for Flash-Flash XFER
 #define NVOCTP_XFERBLKMAX  8
 
+#if !defined (NVOCTP_LISTMAX)
+// Maximum number of items returned by one NVOCTP_listItems() call
+#define NVOCTP_LISTMAX  32
+#endif
+
 #if defined (NVOCTP_DIAGNOSTICS)
 // NV item ID for driver diagnostics
 static const NVINTF_itemID_t diagId = NVOCTP_NVID_DIAG;
@@ -887,6 +893,149 @@ static uint8_t NVOCTP_writeItemExApi(NVINTF_itemID_t id,
     NVOCTP_UNLOCK(err);
 }
 
+/******************************************************************************
+ * @fn      NVOCTP_listItems
+ *
+ * @brief   Global function to list the active NV items, in order of system
+ *          ID, item ID and sub ID. Not part of the NV driver API: the items
+ *          are found with one pass over the active page rather than with a
+ *          search per item ID. The whole list is read by calling again
+ *          until fewer than maxIds items are listed.
+ *
+ * @param   pStart - first NV item ID to list, set to the ID following the
+ *                   last item listed
+ * @param   pIds   - pointer to caller's buffer of maxIds item IDs
+ * @param   pLens  - pointer to caller's buffer of maxIds item lengths
+ * @param   maxIds - maximum number of items to list
+ *
+ * @return  Number of items listed, 0 if none or NV not ready
+ */
+uint8_t NVOCTP_listItems(NVINTF_itemID_t *pStart,
+                         NVINTF_itemID_t *pIds,
+                         uint16_t *pLens,
+                         uint8_t maxIds)
+{
+    uint8_t n;
+    uint8_t cnt = 0;
+    uint16_t ofs;
+    uint32_t cids[NVOCTP_LISTMAX];
+    uint32_t sid;
+
+    // Prevent RTOS thread contention
+    NVOCTP_LOCK();
+
+    if(maxIds > NVOCTP_LISTMAX)
+    {
+        maxIds = NVOCTP_LISTMAX;
+    }
+
+    if((failF == NVINTF_NOTREADY) || (maxIds == 0))
+    {
+        NVOCTP_UNLOCK(0);
+    }
+
+    sid = NVOCTP_CMPRID(pStart->systemID, pStart->itemID, pStart->subID);
+    ofs = pgOff;
+
+    // Same walk as NVOCTP_findItem(), newest item first
+    while(ofs >= (NVOCTP_PGHDRLEN + NVOCTP_ITEMHDRLEN))
+    {
+        NVOCTP_itemHdr_t iHdr;
+
+        // Align to start of item header
+        ofs -= NVOCTP_ITEMHDRLEN;
+
+        // Read and decompress item header
+        NVOCTP_readHeader(activePg, ofs, &iHdr);
+
+        if((iHdr.cmpid >= sid) &&
+           (iHdr.stats & NVOCTP_ACTIVEIDBIT) &&
+          !(iHdr.stats & NVOCTP_VALIDIDBIT) &&
+           ((cnt < maxIds) || (iHdr.cmpid < cids[cnt - 1])))
+        {
+            uint8_t i;
+
+            // Insertion point in the sorted list
+            for(i = cnt; (i > 0) && (cids[i - 1] > iHdr.cmpid); i--)
+            {
+            }
+
+            // An older copy of an item already listed is skipped
+            if((i == 0) || (cids[i - 1] != iHdr.cmpid))
+            {
+                uint8_t j;
+
+                // Drop the largest when full
+                j = (cnt < maxIds) ? cnt++ : (cnt - 1);
+                for(; j > i; j--)
+                {
+                    cids[j] = cids[j - 1];
+                    pLens[j] = pLens[j - 1];
+                }
+                cids[i] = iHdr.cmpid;
+                pLens[i] = iHdr.len;
+            }
+        }
+
+        if(!(iHdr.stats & NVOCTP_VALIDLENBIT))
+        {
+            // Item length appears to be valid
+            if(iHdr.len < ofs)
+            {
+                // Adjust offset for next try
+                ofs -= iHdr.len;
+            }
+            else
+            {
+                // Should never get here - item is corrupt
+                failF = failW = NVINTF_BADLENGTH;
+                NVOCTP_EXCEPTION(activePg, failF);
+                cnt = 0;
+                break;
+            }
+        }
+        else
+        {
+            // Length is invalid, find offset to previous item
+            ofs = NVOCTP_findOffset(activePg, ofs - 1);
+        }
+    }
+
+    // Uncompress the item IDs
+    for(n = 0; n < cnt; n++)
+    {
+        pIds[n].systemID = (cids[n] >> 24) & NVOCTP_MAXSYSID;
+        pIds[n].itemID = (cids[n] >> 12) & NVOCTP_MAXITEMID;
+        pIds[n].subID = cids[n] & NVOCTP_MAXSUBID;
+    }
+
+    if(cnt > 0)
+    {
+        // Next call starts after the last item
+        *pStart = pIds[cnt - 1];
+        if(pStart->subID < NVOCTP_MAXSUBID)
+        {
+            pStart->subID++;
+        }
+        else
+        {
+            // Carry into the item ID, then the system ID
+            pStart->subID = 0;
+            if(pStart->itemID < NVOCTP_MAXITEMID)
+            {
+                pStart->itemID++;
+            }
+            else
+            {
+                pStart->itemID = 0;
+                pStart->systemID++;
+            }
+        }
+    }
+
+    NVOCTP_UNLOCK(cnt);
+}
+
 //*****************************************************************************
 // Local NV Driver Utility Functions
 //*****************************************************************************
@@ -1342,6 +1491,7 @@ static int16_t NVOCTP_findItem(uint8_t pg,
                                uint32_t cid)
 {
     uint16 items = 0;
+    PROBE_BEGIN(probeStart);
 
     while(ofs >= (NVOCTP_PGHDRLEN + NVOCTP_ITEMHDRLEN))
     {
@@ -1358,6 +1508,7 @@ static int16_t NVOCTP_findItem(uint8_t pg,
           !(iHdr.stats & NVOCTP_VALIDIDBIT))
         {
             // Item found - return offset of item header
+            PROBE_END(Probe_id_nvFindItem, probeStart);
             return (ofs);
         }
         else if(!(iHdr.stats & NVOCTP_VALIDLENBIT))
@@ -1387,6 +1538,7 @@ static int16_t NVOCTP_findItem(uint8_t pg,
     }
 
     // Item not found (negate number of items searched)
+    PROBE_END(Probe_id_nvFindItem, probeStart);
     return (-items);
 }
 
@@ -1422,6 +1574,7 @@ static int16_t NVOCTP_compactPage(uint8_t srcPg,
     uint16_t ritems = 0;
     uint16_t nvdOfs = 0;
 #endif
+    PROBE_BEGIN(probeStart);
 
     // Reset Flash erase/write fail indicator
     failW = NVINTF_SUCCESS;
@@ -1564,6 +1717,7 @@ static int16_t NVOCTP_compactPage(uint8_t srcPg,
                             // Invalid length, source page must be corrupt.
                             failF = failW = NVINTF_BADLENGTH;
                             NVOCTP_EXCEPTION(srcPg, failW);
+                            PROBE_END(Probe_id_nvCompactPage, probeStart);
                             return (-1);
                         }
                     }
@@ -1572,6 +1726,7 @@ static int16_t NVOCTP_compactPage(uint8_t srcPg,
             else
             {
                 // Failure during item xfer makes next findItem() unreliable
+                PROBE_END(Probe_id_nvCompactPage, probeStart);
                 return (-1);
             }
         }
@@ -1618,6 +1773,7 @@ static int16_t NVOCTP_compactPage(uint8_t srcPg,
     if(failW != NVINTF_SUCCESS)
     {
         // Something bad happened when trying to compact the page
+        PROBE_END(Probe_id_nvCompactPage, probeStart);
         return (-1);
     }
 
@@ -1627,6 +1783,7 @@ static int16_t NVOCTP_compactPage(uint8_t srcPg,
     NVOCTP_erasePage(srcPg);
 
     // Tell caller how much room is left on the active page
+    PROBE_END(Probe_id_nvCompactPage, probeStart);
     return (FLASH_PAGE_SIZE - dstOff);
 }
 
@@ -52,10 +52,12 @@
 #include <string.h>
 
 #include <stdbool.h>
+#if !defined(MACTRACE_HOST)
 #include <ti/sysbios/knl/Semaphore.h>
 #include <ti/sysbios/knl/Queue.h>
 
 #include <ICall.h>
+#endif
 
 #include "timer.h"
 
@@ -66,12 +68,14 @@
 /*! Adjustment for the timers */
 #define TIMER_MS_ADJUSTMENT     100
 
+#if !defined(MACTRACE_HOST)
 /* RTOS queue for profile/app messages. */
 typedef struct _queueRec_
 {
     Queue_Elem _elem;    /* queue element */
     uint8_t *pData;      /* pointer to app data */
 } queueRec_t;
+#endif
 
 /******************************************************************************
  Public Functions
@@ -87,6 +91,20 @@ Clock_Handle Timer_construct(Clock_Struct *pClock, Clock_FuncPtr clockCB,
                                  uint8_t startFlag,
                                  UArg arg)
 {
+#if defined(MACTRACE_HOST)
+    memset(pClock, 0, sizeof(Clock_Struct));
+    pClock->fxn = clockCB;
+    pClock->arg = arg;
+    pClock->timeout = clockDuration;
+    pClock->period = clockPeriod;
+
+    if(startFlag)
+    {
+        Mactrace_timerStart(pClock, clockDuration);
+    }
+
+    return (pClock);
+#else
     Clock_Params clockParams;
 
     /* Convert clockDuration in milliseconds to ticks. */
@@ -111,6 +129,7 @@ Clock_Handle Timer_construct(Clock_Struct *pClock, Clock_FuncPtr clockCB,
     Clock_construct(pClock, clockCB, clockTicks, &clockParams);
 
     return Clock_handle(pClock);
+#endif
 }
 
 /*!
@@ -120,10 +139,14 @@ Clock_Handle Timer_construct(Clock_Struct *pClock, Clock_FuncPtr clockCB,
  */
 void Timer_start(Clock_Struct *pClock)
 {
+#if defined(MACTRACE_HOST)
+    Mactrace_timerStart(pClock, pClock->timeout);
+#else
     Clock_Handle handle = Clock_handle(pClock);
 
     /* Start clock instance */
     Clock_start(handle);
+#endif
 }
 
 /*!
@@ -133,10 +156,14 @@ void Timer_start(Clock_Struct *pClock)
  */
 bool Timer_isActive(Clock_Struct *pClock)
 {
+#if defined(MACTRACE_HOST)
+    return (pClock->active);
+#else
     Clock_Handle handle = Clock_handle(pClock);
 
     /* Start clock instance */
     return Clock_isActive(handle);
+#endif
 }
 
 /*!
@@ -146,10 +173,14 @@ bool Timer_isActive(Clock_Struct *pClock)
  */
 void Timer_stop(Clock_Struct *pClock)
 {
+#if defined(MACTRACE_HOST)
+    Mactrace_timerStop(pClock);
+#else
     Clock_Handle handle = Clock_handle(pClock);
 
     /* Start clock instance */
     Clock_stop(handle);
+#endif
 }
 
 /*!
@@ -159,5 +190,10 @@ void Timer_stop(Clock_Struct *pClock)
  */
 void Timer_setTimeout(Clock_Handle handle, uint32_t timeout)
 {
+#if defined(MACTRACE_HOST)
+    /* The virtual clock counts milliseconds */
+    handle->timeout = timeout;
+#else
     Clock_setTimeout(handle, (timeout * TIMER_MS_ADJUSTMENT));
+#endif
 }
@@ -71,6 +71,8 @@
 #include <string.h>
 
 #include "api_mac.h"
+#include "probe.h"
+#include "pwracct.h"
 #include "mt_sys.h"
 #include "mcp.h"
 
@@ -158,12 +160,19 @@ void main()
      */
     PIN_init(BoardGpioInitTable);
 
+    /* Start the cycle counter of the hot path probes */
+    Probe_init();
+
+    /* Start the task and sleep time accounting */
+    Pwracct_init();
+
     /* Configure task */
     Task_Params_init(&taskParams);
     taskParams.stack = myTaskStack;
     taskParams.stackSize = APP_TASK_STACK_SIZE;
     taskParams.priority = 1;
     Task_construct(&myTask, taskFxn, &taskParams, NULL);
+    Pwracct_setTask(Task_handle(&myTask), Pwracct_task_app);
 
     BIOS_start(); /* enable interrupts and start SYS/BIOS */
 }
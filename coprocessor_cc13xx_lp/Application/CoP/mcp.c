@@ -48,6 +48,7 @@
  Includes
  *****************************************************************************/
 #include <string.h>
+#include <ti/sysbios/knl/Semaphore.h>
 
 #include "icall.h"
 #include "api_mac.h"
@@ -60,6 +61,7 @@
 #include "board.h"
 #include "board_led.h"
 #include "board_lcd.h"
+#include "board_status.h"
 #include "timer.h"
 
 /******************************************************************************
@@ -80,6 +82,12 @@ static uint16_t numRxMsgs = 0;
 /* Number of responses sent to host */
 static uint16_t numTxMsgs = 0;
 
+/* The application's semaphore */
+static ICall_Semaphore mcpSem;
+
+/* Status display refresh requested by its clock */
+static volatile bool statusRefresh = false;
+
 /******************************************************************************
  Local function prototypes
  *****************************************************************************/
@@ -87,6 +95,7 @@ static void MCP_init(void);
 static void processMsg(uint16_t p1, uint16_t p2, void *pMsg);
 static void relayTxMsg(void *pMsg);
 static void relayRxMsg(void *pMsg);
+static void processStatusTimeoutCallback(void);
 
 /******************************************************************************
  ApiMac MAC callback table
@@ -151,6 +160,14 @@ void MCP_task(void)
     {
         /* Wait for MAC/NPI messages */
         ApiMac_processIncoming();
+
+        if(statusRefresh == true)
+        {
+            statusRefresh = false;
+
+            /* Paint the message counters, at most once per period */
+            Board_Status_refresh();
+        }
     }
 }
 
@@ -163,7 +180,7 @@ void MCP_task(void)
 static void MCP_init(void)
 {
     /* Initialize the MAC interface, do not enable FH */
-    (void)ApiMac_init(false);
+    mcpSem = ApiMac_init(false);
     /* Register the MAC Callbacks */
     ApiMac_registerCallbacks(&macCallbacks);
 
@@ -186,6 +203,9 @@ static void MCP_init(void)
     Board_LCD_open();
     LCD_WRITE_STRING("Texas Instruments", 1);
     LCD_WRITE_STRING("TIMAC Co-Processor", 2);
+
+    /* Paint the message counters and LEDs from this task */
+    Board_Status_init(processStatusTimeoutCallback);
 }
 
 /*!
@@ -209,8 +229,8 @@ static void processMsg(uint16_t entityID, uint16_t param2, void *pMsg)
         /* Count an incoming MT message */
         numRxMsgs += 1;
 
-        LCD_WRITE_STRING_VALUE("MT RX Msgs:", numRxMsgs, 10, 4);
-        Board_Led_control(board_led_type_LED1, board_led_state_BLINK);
+        STATUS_WRITE_STRING_VALUE("MT RX Msgs:", numRxMsgs, 10, 4);
+        STATUS_LED_CONTROL(board_led_type_LED1, board_led_state_BLINK);
     }
 }
 
@@ -244,6 +264,18 @@ static void relayTxMsg(void *pMsg)
     /* Count an outgoing MT message */
     numTxMsgs += 1;
 
-    LCD_WRITE_STRING_VALUE("MT TX Msgs:", numTxMsgs, 10, 5);
-    Board_Led_control(board_led_type_LED2, board_led_state_BLINK);
+    STATUS_WRITE_STRING_VALUE("MT TX Msgs:", numTxMsgs, 10, 5);
+    STATUS_LED_CONTROL(board_led_type_LED2, board_led_state_BLINK);
+}
+
+/*!
+ * @brief   Status display notify function, called from the refresh clock
+ *          when a line or LED is dirty
+ */
+static void processStatusTimeoutCallback(void)
+{
+    statusRefresh = true;
+
+    /* Wake up the application thread */
+    Semaphore_post(mcpSem);
 }
@@ -53,6 +53,10 @@
 #include "mt_rpc.h"
 #include "inc/npi_frame.h"
 #include "inc/npi_rxbuf.h"
+#include "probe.h"
+#if defined(NPI_FRAME_CRC16)
+#include "crc16.h"
+#endif
 
 /******************************************************************************
  Constants and Definitions
@@ -66,8 +70,21 @@
 #define NPIFRAMEMT_LEN_STATE 0x03
 #define NPIFRAMEMT_DATA_STATE 0x04
 #define NPIFRAMEMT_FCS_STATE 0x05
+#define NPIFRAMEMT_FCS_STATE2 0x06
 //@}
 
+//! \brief Frame check sequence. The MT default is a one byte XOR of the
+//!        frame; NPI_FRAME_CRC16 replaces it with a two byte CRC-16 sent
+//!        MSB first. The host must be built with the same setting.
+//!
+#if defined(NPI_FRAME_CRC16)
+typedef uint16_t npiFcs_t;
+#define NPIFRAMEMT_FCS_LEN 2
+#else
+typedef uint8_t npiFcs_t;
+#define NPIFRAMEMT_FCS_LEN 1
+#endif
+
 //! \brief Start-of-frame delimiter for UART transport
 //!
 #define MT_SOF 0xFE
@@ -84,7 +101,7 @@ static npiIncomingFrameCBack_t incomingFrameCBFunc = NULL;
 //@{
 static uint8_t state = 0;
 static uint8_t LEN_Token = 0;
-static uint8_t FSC_Token = 0;
+static npiFcs_t FSC_Token = 0;
 static uint8_t *pMsg = NULL;
 static uint8_t tempDataLen;
 //@}
@@ -99,9 +116,9 @@ static uint8_t tempDataLen;
  * \param  msg_ptr   Pointer to message buffer.
  * \param  len       Length of message pointer pointed to by msg_ptr.
  *
- * \return     uint8_t   Calculated FCS.
+ * \return     npiFcs_t  Calculated FCS.
  *---------------------------------------------------------------------------*/
-static uint8_t npiframe_calcMTFCS(uint8_t *msg_ptr, uint8_t len);
+static npiFcs_t npiframe_calcMTFCS(uint8_t *msg_ptr, uint8_t len);
 
 /******************************************************************************
  Public Functions
@@ -147,10 +164,13 @@ NPIMSG_msg_t *NPIFrame_frameMsg(uint8_t *pIncomingMsg)
         // extract the message length from the MT header bytes.
         uint8_t inMsgLen = pIncomingMsg[MTRPC_POS_LEN] + MTRPC_FRAME_HDR_SZ;
 
-        // allocate a new buffer that is the incoming buffer length + 2
-        // additional bytes for the SOF and FCS bytes.
-        if((npiMsg->pBuf = (uint8_t *)ICall_allocMsg(inMsgLen + 2)) != NULL)
+        // allocate a new buffer that is the incoming buffer length plus
+        // the additional SOF and FCS bytes.
+        if((npiMsg->pBuf = (uint8_t *)ICall_allocMsg(inMsgLen + 1 +
+                                                     NPIFRAMEMT_FCS_LEN)) != NULL)
         {
+            npiFcs_t fcs;
+
             // mark the start of frame.
             npiMsg->pBuf[0] = MT_SOF;
             payload = npiMsg->pBuf + 1;
@@ -158,9 +178,14 @@ NPIMSG_msg_t *NPIFrame_frameMsg(uint8_t *pIncomingMsg)
             // copy the incoming buffer into the newly created buffer
             memcpy(payload, pIncomingMsg, inMsgLen);
 
-            // calculate and capture the FCS in the final byte.
-            npiMsg->pBuf[inMsgLen + 1] = npiframe_calcMTFCS(npiMsg->pBuf + 1,
-                                                            inMsgLen);
+            // calculate and capture the FCS in the final byte(s).
+            fcs = npiframe_calcMTFCS(npiMsg->pBuf + 1, inMsgLen);
+#if defined(NPI_FRAME_CRC16)
+            npiMsg->pBuf[inMsgLen + 1] = (uint8_t)(fcs >> 8);
+            npiMsg->pBuf[inMsgLen + 2] = (uint8_t)fcs;
+#else
+            npiMsg->pBuf[inMsgLen + 1] = fcs;
+#endif
 #if defined(NPI_SREQRSP)
             // document message type (SYNC or ASYNC) in the NPI container.
             if((pIncomingMsg[MTRPC_POS_CMD0] & MTRPC_CMD_TYPE_MASK) == MTRPC_CMD_SRSP)
@@ -175,7 +200,7 @@ NPIMSG_msg_t *NPIFrame_frameMsg(uint8_t *pIncomingMsg)
             npiMsg->msgType = NPIMSG_Type_ASYNC;
 #endif
             // capture the included buffer size in the NPI container.
-            npiMsg->pBufSize = inMsgLen + 2;
+            npiMsg->pBufSize = inMsgLen + 1 + NPIFRAMEMT_FCS_LEN;
         }
         else
         {
@@ -203,6 +228,7 @@ void NPIFrame_collectFrameData(void)
 {
     uint8_t ch;
     uint8_t uint8_tsInRxBuffer;
+    PROBE_BEGIN(probeStart);
 
     while (NPIRxBuf_GetRxBufCount())
     {
@@ -233,6 +259,7 @@ void NPIFrame_collectFrameData(void)
                 else
                 {
                     state = NPIFRAMEMT_SOP_STATE;
+                    PROBE_END(Probe_id_npiRxFrame, probeStart);
                     return;
                 }
                 break;
@@ -287,6 +314,16 @@ void NPIFrame_collectFrameData(void)
 
                 FSC_Token = ch;
 
+#if defined(NPI_FRAME_CRC16)
+                /* First byte is the MSB, wait for the second one */
+                state = NPIFRAMEMT_FCS_STATE2;
+                break;
+
+            case NPIFRAMEMT_FCS_STATE2:
+
+                FSC_Token = (FSC_Token << 8) | ch;
+#endif
+
                 /* Make sure it's correct */
                 if ((npiframe_calcMTFCS((uint8_t *)&pMsg[0], MTRPC_FRAME_HDR_SZ + LEN_Token) == FSC_Token))
                 {
@@ -328,6 +365,8 @@ void NPIFrame_collectFrameData(void)
                 break;
         }
     }
+
+    PROBE_END(Probe_id_npiRxFrame, probeStart);
 }
 
 
@@ -335,16 +374,20 @@ void NPIFrame_collectFrameData(void)
  Local Functions
  *****************************************************************************/
 // ----------------------------------------------------------------------------
-//! \brief      Calculate the FCS of a message buffer by XOR'ing each uint8_t.
+//! \brief      Calculate the FCS of a message buffer by XOR'ing each uint8_t,
+//!             or the CRC-16 of the buffer when NPI_FRAME_CRC16 is defined.
 //!         Remember to exclude SOP and FCS fields, so start at the CMD field.
 //!
 //! \param  msg_ptr   message pointer
 //! \param  len       ength (in uint8_ts) of message
 //!
-//! \return     uint8_t
+//! \return     npiFcs_t
 // ----------------------------------------------------------------------------
-static uint8_t npiframe_calcMTFCS(uint8_t *msg_ptr, uint8_t len)
+static npiFcs_t npiframe_calcMTFCS(uint8_t *msg_ptr, uint8_t len)
 {
+#if defined(NPI_FRAME_CRC16)
+    return (CRC16_calc(msg_ptr, len));
+#else
     uint8_t x;
     uint8_t xorResult;
 
@@ -356,4 +399,5 @@ static uint8_t npiframe_calcMTFCS(uint8_t *msg_ptr, uint8_t len)
     }
 
     return (xorResult);
+#endif
 }
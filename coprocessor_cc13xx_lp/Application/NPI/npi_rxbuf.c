@@ -58,11 +58,6 @@
 // ****************************************************************************
 // defines
 // ****************************************************************************
-#define NPIRXBUF_RXHEAD_INC(x)   RxBufHead += x;               \
-    RxBufHead %= NPI_TL_BUF_SIZE;
-
-#define NPIRXBUF_RXTAIL_INC(x)   RxBufTail += x;               \
-    RxBufTail %= NPI_TL_BUF_SIZE;
 
 // ****************************************************************************
 // typedefs
@@ -72,77 +67,56 @@
 // globals
 //*****************************************************************************
 
-//Receive Buffer for all NPI messages
-static uint8 RxBuf[NPI_TL_BUF_SIZE];
-static uint16 RxBufHead = 0;
-static uint16 RxBufTail = 0;
+//Next unparsed byte of the transport buffer being parsed
+static uint8 *pRxData = NULL;
+//Number of unparsed bytes left in that buffer
+static uint16 RxDataLen = 0;
 
 //*****************************************************************************
 // function prototypes
 //*****************************************************************************
 
 // -----------------------------------------------------------------------------
-//! \brief      NPIRxBuf_Read
-//!
-//! \param[in]  len -
+//! \brief      Returns number of bytes that are unparsed in the transport
+//!             buffer being parsed. Once it is used up, moves on to the next
+//!             buffer received.
 //!
 //! \return     uint16 -
 // -----------------------------------------------------------------------------
-uint16 NPIRxBuf_Read(uint16 len)
+uint16 NPIRxBuf_GetRxBufCount(void)
 {
-    uint16 partialLen = 0;
-
-    // Need to make two reads due to wrap around of circular buffer
-    if ((len + RxBufTail) > NPI_TL_BUF_SIZE)
+    if (RxDataLen == 0)
     {
-        partialLen = NPI_TL_BUF_SIZE - RxBufTail;
-        NPITL_readTL(&RxBuf[RxBufTail],partialLen);
-        len -= partialLen;
-        RxBufTail = 0;
+        RxDataLen = NPITL_getRxBuf(&pRxData);
     }
 
-    // Read remainder of data from Transport Layer
-    NPITL_readTL(&RxBuf[RxBufTail],len);
-    NPIRXBUF_RXTAIL_INC(len);
-
-    // Return len to original size
-    len += partialLen;
-
-    return len;
+    return RxDataLen;
 }
 
 // -----------------------------------------------------------------------------
-//! \brief      Returns number of bytes that are unparsed in RxBuf
-//!
-//! \return     uint16 -
-// -----------------------------------------------------------------------------
-uint16 NPIRxBuf_GetRxBufCount(void)
-{
-    return ((RxBufTail - RxBufHead) + NPI_TL_BUF_SIZE) % NPI_TL_BUF_SIZE;
-}
-
-// -----------------------------------------------------------------------------
-//! \brief      Returns number of bytes that are available in RxBuf
-//!
-//! \return     uint16 -
-// -----------------------------------------------------------------------------
-uint16 NPIRxBuf_GetRxBufAvail(void)
-{
-    return (NPI_TL_BUF_SIZE - NPIRxBuf_GetRxBufCount());
-}
-
-// -----------------------------------------------------------------------------
-//! \brief      NPIRxBuf_ReadFromRxBuf
+//! \brief      NPIRxBuf_ReadFromRxBuf, copies up to len bytes straight out of
+//!             the transport buffer, which is handed back to the transport
+//!             once used up
 //!
 //! \return     uint16 -
 // -----------------------------------------------------------------------------
 uint16 NPIRxBuf_ReadFromRxBuf(uint8_t *buf, uint16 len)
 {
-	uint16_t idx;
-    for (idx = 0; idx < len; idx++)
+    if (len > RxDataLen)
+    {
+        len = RxDataLen;
+    }
+
+    if (len)
     {
-        *buf++ = RxBuf[RxBufHead];
-        NPIRXBUF_RXHEAD_INC(1)
+        memcpy(buf, pRxData, len);
+        pRxData += len;
+        RxDataLen -= len;
+
+        if (RxDataLen == 0)
+        {
+            NPITL_releaseRxBuf();
+        }
     }
 
     return len;
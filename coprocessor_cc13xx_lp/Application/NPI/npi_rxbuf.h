@@ -75,30 +75,16 @@ extern "C"
 //*****************************************************************************
 
 // -----------------------------------------------------------------------------
-//! \brief      NPIRxBuf_Read
-//!
-//! \param[in]  len -
-//!
-//! \return     uint16 -
-// -----------------------------------------------------------------------------
-uint16 NPIRxBuf_Read(uint16);
-
-// -----------------------------------------------------------------------------
-//! \brief      Returns number of bytes that are unparsed in RxBuf
+//! \brief      Returns number of bytes that are unparsed in the transport
+//!             buffer being parsed
 //!
 //! \return     uint16 -
 // -----------------------------------------------------------------------------
 uint16 NPIRxBuf_GetRxBufCount();
 
 // -----------------------------------------------------------------------------
-//! \brief      Returns number of bytes that are available in RxBuf
-//!
-//! \return     uint16 -
-// -----------------------------------------------------------------------------
-uint16 NPIRxBuf_GetRxBufAvail();
-
-// -----------------------------------------------------------------------------
-//! \brief      NPIRxBuf_ReadFromRxBuf
+//! \brief      NPIRxBuf_ReadFromRxBuf, at most NPIRxBuf_GetRxBufCount()
+//!             bytes
 //!
 //! \return     uint16 -
 // -----------------------------------------------------------------------------
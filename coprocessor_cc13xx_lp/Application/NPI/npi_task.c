@@ -68,6 +68,8 @@
 #include "inc/npi_frame.h"
 #include "inc/npi_rxbuf.h"
 #include "inc/npi_tl.h"
+#include "probe.h"
+#include "pwracct.h"
 
 // ****************************************************************************
 // defines
@@ -741,6 +743,7 @@ void NPITask_createTask(uint32_t stackID)
     npiTaskParams.priority = NPITASK_PRIORITY;
 
     Task_construct(&npiTaskStruct, NPITask_Fxn, &npiTaskParams, NULL);
+    Pwracct_setTask(Task_handle(&npiTaskStruct), Pwracct_task_npi);
 }
 
 // -----------------------------------------------------------------------------
@@ -1000,6 +1003,7 @@ static void NPITask_ProcessTXQ(void)
 {
     ICall_CSState key;
     NPI_QueueRec *recPtr = NULL;
+    PROBE_BEGIN(probeStart);
 
     // Processing of any TX Queue should only be done 
     // in a critical section since any application
@@ -1020,6 +1024,8 @@ static void NPITask_ProcessTXQ(void)
     }
                         
     ICall_leaveCriticalSection(key);
+
+    PROBE_END(Probe_id_npiTxQueue, probeStart);
 }
 
 #if defined(NPI_SREQRSP)                            
@@ -1295,33 +1301,16 @@ static void NPITask_incomingFrameCB(uint8_t frameSize, uint8_t *pFrame,
 // -----------------------------------------------------------------------------
 static void NPITask_transportRXCallBack(int size)
 {
-    // Check for overflow of RxBuf: 
-    // If the buffer has overflowed there is no way to safely recover. All 
-    // received bytes can be packet fragments so if a packet fragment is lost
-    // the frame parser behavior becomes undefined. The only way to prevent
-    // RxBuf overflow is to enable NPI_FLOW_CTRL.
-    //
-    // If NPI_FLOW_CTRL is not enabled then there is no way to for slave to 
-    // control the master transfer rate. With NPI_FLOW_CTRL the slave has SRDY
-    // to use as a software flow control mechanism. 
-    // When using NPI_FLOW_CTRL make sure to increase NPI_TL_BUF_SIZE
-    // to suit the NPI frame length that is expected to be received.
-    if ( size < NPIRxBuf_GetRxBufAvail() )
-    {
-        NPIRxBuf_Read(size);
+    // The bytes stay in the transport buffer until parsed. While the NPI
+    // task is parsing it the transport fills its other buffer, and waits if
+    // that one hasn't been parsed yet: the NPI task must keep up with the
+    // host or NPI_FLOW_CTRL must be enabled.
 #ifdef ICALL_EVENTS
-        Event_post(syncEvent, NPITASK_TRANSPORT_RX_EVENT);
+    Event_post(syncEvent, NPITASK_TRANSPORT_RX_EVENT);
 #else //!ICALL_EVENTS
-        TRANSPORT_RX_ISR_EVENT_FLAG = NPITASK_TRANSPORT_RX_EVENT;
-        Semaphore_post(appSem);
+    TRANSPORT_RX_ISR_EVENT_FLAG = NPITASK_TRANSPORT_RX_EVENT;
+    Semaphore_post(appSem);
 #endif //ICALL_EVENTS
-    }
-    else
-    {
-        // Trap here for pending buffer overflow. If NPI_FLOW_CTRL is
-        // enabled, increase size of RxBuf to handle larger frames from host.
-        for(;;);
-    }
 }
 
 // -----------------------------------------------------------------------------
@@ -97,15 +97,6 @@ static volatile uint32 mrdyPktStamp = 0;
 //! \brief Packets transmitted counter
 static uint32 txPktCount = 0;
 
-//! \brief NPI Transport Layer receive buffer
-static Char npiRxBuf[NPI_TL_BUF_SIZE];
-
-//! \brief Index to last byte written into NPI Transport Layer receive buffer
-static uint16_t npiRxBufTail = 0;
-
-//! \brief Index to first byte to be read from NPI Transport Layer receive buffer
-static uint16_t npiRxBufHead = 0;
-
 //! \brief NPI Transport Layer transmit buffer
 static Char npiTxBuf[NPI_TL_BUF_SIZE];
 
@@ -155,6 +146,10 @@ static uint8 mrdy_state;
 //              invoked upon the completion of a transmission
 static void NPITL_transmissionCallBack(uint16 Rxlen, uint16 Txlen);
 
+//! \brief Call back function provided to underlying serial interface to be
+//              invoked when received bytes are ready to be parsed
+static void NPITL_receiveCallBack(uint16 Rxlen);
+
 #if (NPI_FLOW_CTRL == 1)
 //! \brief HWI interrupt function for MRDY
 static void NPITL_MRDYPinHwiFxn(PIN_Handle hPin, PIN_Id pinId);
@@ -182,7 +177,7 @@ void NPITL_initTL(npiRtosCB_t npiCBTx, npiRtosCB_t npiCBRx, npiRtosCB_t npiCBMrd
     taskMrdyCB = npiCBMrdy;
 #endif // NPI_FLOW_CTRL = 1
 
-    transportInit(npiRxBuf,npiTxBuf, NPITL_transmissionCallBack);
+    transportInit(npiTxBuf, NPITL_transmissionCallBack, NPITL_receiveCallBack);
 
 #if (NPI_FLOW_CTRL == 1)
     SRDY_DISABLE();
@@ -340,10 +335,10 @@ static void NPITL_MRDYPinHwiFxn(PIN_Handle hPin, PIN_Id pinId)
 
 // -----------------------------------------------------------------------------
 //! \brief      This callback is invoked on the completion of one transmission
-//!             to/from the host MCU. Any bytes receives will be [0,Rxlen) in
-//!             npiRxBuf.
-//!             If bytes were receives or transmitted, this function notifies
-//!             the NPI task via registered call backs
+//!             to/from the host MCU. Received bytes have already been passed
+//!             to the NPI task by NPITL_receiveCallBack() as they arrived.
+//!             If bytes were transmitted, this function notifies the NPI
+//!             task via registered call backs
 //!
 //! \param[in]  Rxlen   - lenth of the data received
 //! \param[in]  Txlen   - length of the data transferred
@@ -352,16 +347,6 @@ static void NPITL_MRDYPinHwiFxn(PIN_Handle hPin, PIN_Id pinId)
 // -----------------------------------------------------------------------------
 static void NPITL_transmissionCallBack(uint16 Rxlen, uint16 Txlen)
 {
-    npiRxBufHead = 0;
-    npiRxBufTail = Rxlen;
-
-    if(Rxlen)
-    {
-        if ( taskRxCB )
-        {
-            taskRxCB(Rxlen);
-        }
-    }
     if(Txlen)
     {
         npiTxActive = FALSE;
@@ -390,22 +375,43 @@ static void NPITL_transmissionCallBack(uint16 Rxlen, uint16 Txlen)
 }
 
 // -----------------------------------------------------------------------------
-//! \brief      This routine reads data from the transport layer based on len,
-//!             and places it into the buffer.
+//! \brief      This callback is invoked by the transport layer each time a
+//!             receive buffer has been filled, and notifies the NPI task
 //!
-//! \param[in]  buf - Pointer to buffer to place read data.
-//! \param[in]  len - Number of bytes to read.
+//! \param[in]  Rxlen   - length of the data received
 //!
-//! \return     uint16 - the number of bytes read from transport
+//! \return     void
 // -----------------------------------------------------------------------------
-uint16 NPITL_readTL(uint8 *buf, uint16 len)
+static void NPITL_receiveCallBack(uint16 Rxlen)
 {
-    // Only copy the lowest number between len and bytes remaining in buffer
-    len = (len > NPITL_getRxBufLen()) ? NPITL_getRxBufLen() : len;
+    if ( taskRxCB )
+    {
+        taskRxCB(Rxlen);
+    }
+}
 
-    memcpy(buf, &npiRxBuf[npiRxBufHead], len);
-    npiRxBufHead += len;
-    return len;
+// -----------------------------------------------------------------------------
+//! \brief      This routine returns the oldest transport buffer holding
+//!             received bytes, to be parsed in place.
+//!
+//! \param[out] ppBuf - set to the buffer
+//!
+//! \return     uint16 - the number of bytes in the buffer, 0 if none
+// -----------------------------------------------------------------------------
+uint16 NPITL_getRxBuf(uint8 **ppBuf)
+{
+    return transportGetRxBuf(ppBuf);
+}
+
+// -----------------------------------------------------------------------------
+//! \brief      This routine hands the buffer returned by NPITL_getRxBuf() back
+//!             to the transport layer.
+//!
+//! \return     void
+// -----------------------------------------------------------------------------
+void NPITL_releaseRxBuf(void)
+{
+    transportReleaseRxBuf();
 }
 
 // -----------------------------------------------------------------------------
@@ -478,13 +484,3 @@ uint16 NPITL_getMaxTxBufSize(void)
 {
     return(NPI_TL_BUF_SIZE);
 }
-
-// -----------------------------------------------------------------------------
-//! \brief      Returns number of bytes that are unread in RxBuf
-//!
-//! \return     uint16 - number of unread bytes
-// -----------------------------------------------------------------------------
-uint16 NPITL_getRxBufLen(void)
-{
-    return ((npiRxBufTail - npiRxBufHead) + NPI_TL_BUF_SIZE) % NPI_TL_BUF_SIZE;
-}
@@ -68,12 +68,16 @@ extern "C"
 #define transportWrite NPITLUART_writeTransport
 #define transportStopTransfer NPITLUART_stopTransfer
 #define transportMrdyEvent NPITLUART_handleMrdyEvent
+#define transportGetRxBuf NPITLUART_getRxBuf
+#define transportReleaseRxBuf NPITLUART_releaseRxBuf
 #elif defined(NPI_USE_SPI)
 #define transportInit NPITLSPI_initializeTransport
 #define transportRead NPITLSPI_readTransport
 #define transportWrite NPITLSPI_writeTransport
 #define transportStopTransfer NPITLSPI_stopTransfer
 #define transportMrdyEvent NPITLSPI_handleMrdyEvent
+#define transportGetRxBuf NPITLSPI_getRxBuf
+#define transportReleaseRxBuf NPITLSPI_releaseRxBuf
 #endif
 
 // ****************************************************************************
@@ -119,15 +123,23 @@ typedef void (*npiMrdyRtosCB_t)();
 void NPITL_initTL(npiRtosCB_t npiCBTx, npiRtosCB_t npiCBRx, npiRtosCB_t npiCBMrdy);
 
 // -----------------------------------------------------------------------------
-//! \brief      This routine reads data from the transport layer based on len,
-//!             and places it into the buffer.
+//! \brief      This routine returns the oldest transport buffer holding
+//!             received bytes. The bytes are parsed in place and the buffer
+//!             is handed back with NPITL_releaseRxBuf().
 //!
-//! \param[in]  buf - Pointer to buffer to place read data.
-//! \param[in]  len - Number of bytes to read.
+//! \param[out] ppBuf - set to the buffer
 //!
-//! \return     uint16 - the number of bytes read from transport
+//! \return     uint16 - the number of bytes in the buffer, 0 if none
 // -----------------------------------------------------------------------------
-uint16 NPITL_readTL(uint8 *buf, uint16 len);
+uint16 NPITL_getRxBuf(uint8 **ppBuf);
+
+// -----------------------------------------------------------------------------
+//! \brief      This routine hands the buffer returned by NPITL_getRxBuf() back
+//!             to the transport layer once all its bytes are parsed.
+//!
+//! \return     void
+// -----------------------------------------------------------------------------
+void NPITL_releaseRxBuf(void);
 
 // -----------------------------------------------------------------------------
 //! \brief      This routine writes data from the buffer to the transport layer.
@@ -162,13 +174,6 @@ uint16 NPITL_getMaxRxBufSize(void);
 // -----------------------------------------------------------------------------
 uint16 NPITL_getMaxTxBufSize(void);
 
-// -----------------------------------------------------------------------------
-//! \brief      Returns number of bytes that are unread in RxBuf
-//!
-//! \return     uint16 - number of unread bytes
-// -----------------------------------------------------------------------------
-uint16 NPITL_getRxBufLen(void);
-
 // -----------------------------------------------------------------------------
 //! \brief      This routine returns the state of transmission on NPI
 //!
@@ -77,12 +77,28 @@
 //! \brief UART Handle for UART Driver
 static UART_Handle uartHandle;
 
-//! \brief UART ISR Rx Buffer
-static Char isrRxBuf[UART_ISR_BUF_SIZE];
+//! \brief UART ISR Rx Buffers. The driver fills one while the NPI task
+//!        parses the others in place
+static Char isrRxBuf[UART_ISR_BUF_CNT][UART_ISR_BUF_SIZE];
+
+//! \brief Number of bytes received in each UART ISR Rx Buffer, 0 if free
+static uint16 isrRxLen[UART_ISR_BUF_CNT];
+
+//! \brief Index of the UART ISR Rx Buffer the driver fills
+static uint8 isrRxFill = 0;
+
+//! \brief Index of the oldest UART ISR Rx Buffer holding received bytes
+static uint8 isrRxParse = 0;
+
+//! \brief Flag signalling a UART_read() is pending
+static uint8 isrRxArmed = FALSE;
 
 //! \brief NPI TL call back function for the end of a UART transaction
 static npiCB_t npiTransmitCB = NULL;
 
+//! \brief NPI TL call back function for a filled UART ISR Rx Buffer
+static npiRxCB_t npiReceiveCB = NULL;
+
 #if (NPI_FLOW_CTRL == 1)
 //! \brief Flag signalling receive in progress
 static uint8 RxActive = FALSE;
@@ -94,9 +110,6 @@ static uint8 TxActive = FALSE;
 static uint8 mrdy_flag = 1;
 #endif // NPI_FLOW_CTRL = 1
 
-//! \brief Pointer to NPI TL TX Buffer
-static Char* TransportRxBuf;
-
 //! \brief Length of bytes received
 static uint16 TransportRxLen = 0;
 
@@ -113,8 +126,8 @@ extern UARTCC26XX_Object uartCC26XXObjects[];
 // function prototypes
 //*****************************************************************************
 
-//! \brief UART ISR function. Invoked upon specific threshold of UART RX FIFO size
-static uint16 NPITLUART_readIsrBuf(size_t size);
+//! \brief Start a UART_read() into the next UART ISR Rx Buffer if it is free
+static void NPITLUART_armRead(void);
 
 //! \brief UART Callback invoked after UART write completion
 static void NPITLUART_writeCallBack(UART_Handle handle, void *ptr, size_t size);
@@ -126,20 +139,22 @@ static void NPITLUART_readCallBack(UART_Handle handle, void *ptr, size_t size);
 //! \brief      This routine initializes the transport layer and opens the port
 //!             of the device.
 //!
-//! \param[in]  tRxBuf - pointer to NPI TL Tx Buffer
-//! \param[in]  tTxBuf - pointer to NPI TL Rx Buffer
+//! \param[in]  tTxBuf - pointer to NPI TL Tx Buffer
 //! \param[in]  npiCBack - NPI TL call back function to be invoked at the end of
 //!             a UART transaction
+//! \param[in]  npiRxCBack - NPI TL call back function to be invoked when a
+//!             UART ISR Rx Buffer has been filled
 //!
 //! \return     void
 // -----------------------------------------------------------------------------
-void NPITLUART_initializeTransport(Char *tRxBuf, Char *tTxBuf, npiCB_t npiCBack)
+void NPITLUART_initializeTransport(Char *tTxBuf, npiCB_t npiCBack,
+                                   npiRxCB_t npiRxCBack)
 {
     UART_Params params;
 
-    TransportRxBuf = tRxBuf;
     TransportTxBuf = tTxBuf;
     npiTransmitCB = npiCBack;
+    npiReceiveCB = npiRxCBack;
 
     // Configure UART parameters.
     UART_Params_init(&params);
@@ -279,7 +294,9 @@ static void NPITLUART_writeCallBack(UART_Handle handle, void *ptr, size_t size)
 
 // -----------------------------------------------------------------------------
 //! \brief      This callback is invoked on Read completion of readSize/receive
-//!             timeout
+//!             timeout. The filled buffer is handed to the NPI TL as it is
+//!             and the next read goes to the other buffer, so nothing is
+//!             copied here.
 //!
 //! \param[in]  handle - handle to the UART port
 //! \param[in]  ptr    - pointer to buffer to read data into
@@ -292,20 +309,13 @@ static void NPITLUART_readCallBack(UART_Handle handle, void *ptr, size_t size)
     ICall_CSState key;
     key = ICall_enterCriticalSection();
 
+    isrRxArmed = FALSE;
+
     if (size)
     {
-        if (size != NPITLUART_readIsrBuf(size))
-        {
-            // Buffer overflow imminent. Cancel read and pass to higher layers
-            // for handling
-#if (NPI_FLOW_CTRL == 1)
-            RxActive = FALSE;
-#endif // NPI_FLOW_CTRL = 1
-            if ( npiTransmitCB )
-            {
-                npiTransmitCB(NPI_TL_BUF_SIZE,TransportTxLen);
-            }
-        }
+        isrRxLen[isrRxFill] = size;
+        isrRxFill = (isrRxFill + 1) % UART_ISR_BUF_CNT;
+        TransportRxLen += size;
     }
 
 #if (NPI_FLOW_CTRL == 1)
@@ -324,42 +334,77 @@ static void NPITLUART_readCallBack(UART_Handle handle, void *ptr, size_t size)
     }
     else
     {
-        UART_read(uartHandle, &isrRxBuf[0], UART_ISR_BUF_SIZE);
+        NPITLUART_armRead();
     }
 #else
-    if ( npiTransmitCB )
-    {
-        npiTransmitCB(size,0);
-    }
-    TransportRxLen = 0;
-    UART_read(uartHandle, &isrRxBuf[0], UART_ISR_BUF_SIZE);
+    NPITLUART_armRead();
 #endif // NPI_FLOW_CTRL = 1
 
     ICall_leaveCriticalSection(key);
+
+    // The NPI task parses the bytes while the next buffer fills, even in the
+    // middle of a transaction
+    if ( size && npiReceiveCB )
+    {
+        npiReceiveCB(size);
+    }
 }
 
 // -----------------------------------------------------------------------------
-//! \brief      This routine reads data from the transport layer based on len,
-//!             and places it into the buffer.
+//! \brief      This routine starts a UART_read() into the next UART ISR Rx
+//!             Buffer. If the NPI task is still parsing that buffer the read
+//!             is started when it is released. Called with interrupts
+//!             disabled.
 //!
-//! \param[in]  size - amount of bytes in UART ISR Rx Buffer
+//! \return     void
+// -----------------------------------------------------------------------------
+static void NPITLUART_armRead(void)
+{
+    if ( !isrRxArmed && (isrRxLen[isrRxFill] == 0) )
+    {
+        isrRxArmed = TRUE;
+        UART_read(uartHandle, &isrRxBuf[isrRxFill][0], UART_ISR_BUF_SIZE);
+    }
+}
+
+// -----------------------------------------------------------------------------
+//! \brief      This routine returns the oldest UART ISR Rx Buffer holding
+//!             received bytes, to be parsed in place
+//!
+//! \param[out] ppBuf - set to the buffer
+//!
+//! \return     uint16 - number of bytes in the buffer, 0 if none
+// -----------------------------------------------------------------------------
+uint16 NPITLUART_getRxBuf(uint8 **ppBuf)
+{
+    *ppBuf = (uint8 *)&isrRxBuf[isrRxParse][0];
+
+    return isrRxLen[isrRxParse];
+}
+
+// -----------------------------------------------------------------------------
+//! \brief      This routine releases the buffer returned by
+//!             NPITLUART_getRxBuf() once parsed, and restarts a read that was
+//!             waiting for it
 //!
-//! \return     uint16 - number of bytes read from transport
+//! \return     void
 // -----------------------------------------------------------------------------
-static uint16 NPITLUART_readIsrBuf(size_t size)
+void NPITLUART_releaseRxBuf(void)
 {
-    uint8_t i = 0;
+    ICall_CSState key;
+    key = ICall_enterCriticalSection();
+
+    isrRxLen[isrRxParse] = 0;
+    isrRxParse = (isrRxParse + 1) % UART_ISR_BUF_CNT;
 
-    // Copy the UART buffer to the application buffer
-    // Do not allow overflow of buffer. Instead pass up to NPI module and allow
-    // it to handle
-    for (; (i < size) && (TransportRxLen < NPI_TL_BUF_SIZE); i++)
+#if (NPI_FLOW_CTRL == 1)
+    if ( RxActive )
+#endif // NPI_FLOW_CTRL = 1
     {
-        TransportRxBuf[TransportRxLen++] = isrRxBuf[i];
-        isrRxBuf[i] = 0;
+        NPITLUART_armRead();
     }
 
-    return i;
+    ICall_leaveCriticalSection(key);
 }
 
 // -----------------------------------------------------------------------------
@@ -377,7 +422,7 @@ void NPITLUART_readTransport(void)
 #endif // NPI_FLOW_CTRL = 1
 
     TransportRxLen = 0;
-    UART_read(uartHandle, &isrRxBuf[0], UART_ISR_BUF_SIZE);
+    NPITLUART_armRead();
 
     ICall_leaveCriticalSection(key);
 }
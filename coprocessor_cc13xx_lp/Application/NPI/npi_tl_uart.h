@@ -67,9 +67,13 @@ extern "C"
 #define NPI_UART_BR 115200
 #endif // !NPI_UART_BR
 
-// UART ISR Buffer define
+// UART ISR Buffer define, the driver fills one buffer while the others are
+// parsed. With no free buffer only the UART FIFO holds incoming bytes: the
+// buffers must cover the longest the NPI task can be kept from parsing.
 #define UART_ISR_BUF_SIZE 32
-#define UART_ISR_BUF_CNT 2
+#if !defined(UART_ISR_BUF_CNT)
+#define UART_ISR_BUF_CNT 8
+#endif // !UART_ISR_BUF_CNT
   
 // ****************************************************************************
 // typedefs
@@ -84,6 +88,15 @@ extern "C"
 // ----------------------------------------------------------------------------- 
 typedef void (*npiCB_t)(uint16 Rxlen, uint16 Txlen);
 
+// -----------------------------------------------------------------------------
+//! \brief      Typedef for call back function mechanism to notify NPI TL that
+//!             a UART ISR Rx Buffer has been filled
+//! \param[in]  uint16     number of bytes received
+//!
+//! \return     void
+// -----------------------------------------------------------------------------
+typedef void (*npiRxCB_t)(uint16 Rxlen);
+
 //*****************************************************************************
 // globals
 //*****************************************************************************
@@ -96,14 +109,16 @@ typedef void (*npiCB_t)(uint16 Rxlen, uint16 Txlen);
 //! \brief      This routine initializes the transport layer and opens the port
 //!             of the device.
 //!
-//! \param[in]  tRxBuf - pointer to NPI TL Tx Buffer
-//! \param[in]  tTxBuf - pointer to NPI TL Rx Buffer
+//! \param[in]  tTxBuf - pointer to NPI TL Tx Buffer
 //! \param[in]  npiCBack - NPI TL call back function to be invoked at the end of 
 //!             a UART transaction                     
+//! \param[in]  npiRxCBack - NPI TL call back function to be invoked when a
+//!             UART ISR Rx Buffer has been filled
 //!
 //! \return     void
 // -----------------------------------------------------------------------------
-void NPITLUART_initializeTransport(Char *tRxBuf, Char *tTxBuf, npiCB_t npiCBack);
+void NPITLUART_initializeTransport(Char *tTxBuf, npiCB_t npiCBack,
+                                   npiRxCB_t npiRxCBack);
 
 // -----------------------------------------------------------------------------
 //! \brief      This routine reads data from the UART
@@ -121,6 +136,24 @@ void NPITLUART_readTransport(void);
 // -----------------------------------------------------------------------------
 uint16 NPITLUART_writeTransport(uint16);
 
+// -----------------------------------------------------------------------------
+//! \brief      This routine returns the oldest UART ISR Rx Buffer holding
+//!             received bytes, to be parsed in place
+//!
+//! \param[out] ppBuf - set to the buffer
+//!
+//! \return     uint16 - number of bytes in the buffer, 0 if none
+// -----------------------------------------------------------------------------
+uint16 NPITLUART_getRxBuf(uint8 **ppBuf);
+
+// -----------------------------------------------------------------------------
+//! \brief      This routine releases the buffer returned by
+//!             NPITLUART_getRxBuf() once parsed
+//!
+//! \return     void
+// -----------------------------------------------------------------------------
+void NPITLUART_releaseRxBuf(void);
+
 // -----------------------------------------------------------------------------
 //! \brief      This routine stops any pending reads
 //!
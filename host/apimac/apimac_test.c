@@ -0,0 +1,697 @@
+/******************************************************************************
+
+ @file apimac_test.c
+
+ @brief Host test of the batched MAC PIB requests and the PIB cache of
+        api_mac_pib.c, counting the ICall round trips to the MAC stack.
+
+        Each call site that was moved to ApiMac_mlmeGetReqMulti() or
+        ApiMac_mlmeSetReqMulti() is replayed twice against a model of the
+        MAC stack: attribute by attribute, the way the single requests of
+        api_mac.c send them, and as one batch. Both must leave the same
+        values, the batch in one round trip.
+
+        The cache checks cover a get of the extended address served
+        without a message, the update by a set, the clear of a MAC reset,
+        and the requests that must not be served from it.
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "icall.h"
+#include "api_mac.h"
+#include "api_mac_pib.h"
+
+/******************************************************************************
+ Constants and definitions
+ *****************************************************************************/
+
+/*! Message events of the single requests, as the MAC stack model sees them */
+#define TEST_GET_REQ            0x01
+#define TEST_SET_REQ            0x02
+
+/*! Largest attribute of the model */
+#define TEST_MAX_LEN            APIMAC_SADDR_EXT_LEN
+
+/*! Attribute that the model does not have */
+#define TEST_UNKNOWN_ATTRIBUTE  0x01
+
+/*! Single get or set request, the layout of macGetParam_t cut down */
+typedef struct
+{
+    uint8_t event;
+    uint8_t status;
+    uint8_t attribute;
+    void *pValue;
+} singleReq_t;
+
+/*! Attribute of the MAC stack model */
+typedef struct
+{
+    uint8_t attribute;
+    uint8_t len;
+    uint8_t value[TEST_MAX_LEN];
+} macAttr_t;
+
+/*! Call site of the applications that sends a batch */
+typedef struct
+{
+    const char *name;
+    bool set;
+    uint8_t count;
+    uint8_t attributes[APIMAC_PIB_MULTI_MAX_ENTRIES];
+} callSite_t;
+
+/******************************************************************************
+ Local Variables
+ *****************************************************************************/
+
+/*! ICall entity of api_mac.c */
+ICall_EntityID ApiMac_appEntity = 1;
+
+/*! MAC PIB of the model, the values set by resetMac() */
+static macAttr_t macPib[] =
+{
+    { ApiMac_attribute_diagRxSecureFail, 4, {0} },
+    { ApiMac_attribute_diagTxSecureFail, 4, {0} },
+    { ApiMac_attribute_extendedAddress, APIMAC_SADDR_EXT_LEN, {0} },
+    { ApiMac_attribute_logicalChannel, 1, {0} },
+    { ApiMac_attribute_panId, 2, {0} },
+    { ApiMac_attribute_shortAddress, 2, {0} },
+    { ApiMac_attribute_transactionPersistenceTime, 2, {0} },
+    { ApiMac_attribute_phyTransmitPowerSigned, 1, {0} },
+    { ApiMac_attribute_coordExtendedAddress, APIMAC_SADDR_EXT_LEN, {0} },
+    { ApiMac_attribute_coordShortAddress, 2, {0} }
+};
+
+/*! Number of attributes of the model */
+#define MAC_PIB_COUNT           (sizeof(macPib) / sizeof(macPib[0]))
+
+/*! The call sites moved to the batched requests */
+static const callSite_t callSites[] =
+{
+    { "sensor report", false, 3,
+      { ApiMac_attribute_diagRxSecureFail, ApiMac_attribute_diagTxSecureFail,
+        ApiMac_attribute_extendedAddress } },
+    { "collector stats", false, 2,
+      { ApiMac_attribute_diagRxSecureFail,
+        ApiMac_attribute_diagTxSecureFail } },
+    { "cllc start", false, 4,
+      { ApiMac_attribute_logicalChannel, ApiMac_attribute_panId,
+        ApiMac_attribute_extendedAddress, ApiMac_attribute_shortAddress } },
+    { "collector init", true, 2,
+      { ApiMac_attribute_transactionPersistenceTime,
+        ApiMac_attribute_phyTransmitPowerSigned } },
+    { "jdllc rejoin", true, 5,
+      { ApiMac_attribute_panId, ApiMac_attribute_shortAddress,
+        ApiMac_attribute_coordExtendedAddress,
+        ApiMac_attribute_logicalChannel,
+        ApiMac_attribute_coordShortAddress } }
+};
+
+/*! Messages sent to the MAC stack */
+static unsigned int roundTrips;
+
+/*! Reply waiting for ICall_waitMatch() */
+static void *pReply;
+
+/*! Messages allocated and not freed */
+static int msgsHeld;
+
+/*! Fail the next message allocation */
+static bool failAlloc;
+
+/******************************************************************************
+ Local Functions
+ *****************************************************************************/
+
+/*!
+ * @brief       Find an attribute of the model.
+ *
+ * @param       attribute - attribute Id
+ *
+ * @return      the attribute, NULL if the model does not have it
+ */
+static macAttr_t *findAttr(uint8_t attribute)
+{
+    unsigned int i;
+
+    for(i = 0; i < MAC_PIB_COUNT; i++)
+    {
+        if(macPib[i].attribute == attribute)
+        {
+            return (&macPib[i]);
+        }
+    }
+    return (NULL);
+}
+
+/*!
+ * @brief       Put the model and the cache back to their reset values.
+ */
+static void resetMac(void)
+{
+    unsigned int i;
+    uint8_t j;
+
+    for(i = 0; i < MAC_PIB_COUNT; i++)
+    {
+        for(j = 0; j < macPib[i].len; j++)
+        {
+            macPib[i].value[j] = (uint8_t)((macPib[i].attribute * 7) + j);
+        }
+    }
+    ApiMacPib_cacheClear();
+}
+
+/*!
+ * @brief       Model of the MAC stack handling a batched request, the way
+ *              the ICall handler of the stack reads and writes the caller's
+ *              buffers.
+ *
+ * @param       pMsg - request, answered in place
+ */
+static void macMulti(macPibMultiParam_t *pMsg)
+{
+    uint8_t i;
+
+    pMsg->status = ApiMac_status_success;
+
+    for(i = 0; i < pMsg->count; i++)
+    {
+        macPibMultiEntry_t *pEntry = &pMsg->pEntries[i];
+        macAttr_t *pAttr = findAttr(pEntry->attribute);
+
+        if(pAttr == NULL)
+        {
+            pEntry->status = ApiMac_status_unsupportedAttribute;
+        }
+        else if(pMsg->event == MAC_SET_REQ_MULTI)
+        {
+            memcpy(pAttr->value, pEntry->pValue, pAttr->len);
+            pEntry->status = ApiMac_status_success;
+        }
+        else if(pEntry->len < pAttr->len)
+        {
+            pEntry->status = ApiMac_status_invalidParameter;
+        }
+        else
+        {
+            memcpy(pEntry->pValue, pAttr->value, pAttr->len);
+            pEntry->len = pAttr->len;
+            pEntry->status = ApiMac_status_success;
+        }
+
+        if((pEntry->status != ApiMac_status_success)
+           && (pMsg->status == ApiMac_status_success))
+        {
+            pMsg->status = pEntry->status;
+        }
+    }
+}
+
+/*!
+ * @brief       Model of the MAC stack handling a single request.
+ *
+ * @param       pMsg - request, answered in place
+ */
+static void macSingle(singleReq_t *pMsg)
+{
+    macAttr_t *pAttr = findAttr(pMsg->attribute);
+
+    if(pAttr == NULL)
+    {
+        pMsg->status = ApiMac_status_unsupportedAttribute;
+    }
+    else if(pMsg->event == TEST_SET_REQ)
+    {
+        memcpy(pAttr->value, pMsg->pValue, pAttr->len);
+        pMsg->status = ApiMac_status_success;
+    }
+    else
+    {
+        memcpy(pMsg->pValue, pAttr->value, pAttr->len);
+        pMsg->status = ApiMac_status_success;
+    }
+}
+
+/*!
+ * @brief       Match the reply of a single request.
+ *
+ * @param       src - originator of the message as a service enumeration
+ * @param       dest - destination entity id of the message
+ * @param       msg - pointer to the message body
+ *
+ * @return      true when the message is a single request
+ */
+static bool matchSingle(ICall_ServiceEnum src, ICall_EntityID dest,
+                        const void *msg)
+{
+    const singleReq_t *pMsg = (const singleReq_t *)msg;
+
+    (void)src;
+    (void)dest;
+    return ((pMsg->event == TEST_GET_REQ) || (pMsg->event == TEST_SET_REQ));
+}
+
+/*!
+ * @brief       Get one attribute the way getTypeReq() of api_mac.c does:
+ *              from the cache, else in one round trip.
+ *
+ * @param       attribute - attribute Id
+ * @param       pValue - place to put the value
+ *
+ * @return      ApiMac_status_t
+ */
+static ApiMac_status_t singleGet(uint8_t attribute, void *pValue)
+{
+    ApiMac_status_t status = ApiMac_status_noResources;
+    singleReq_t *pMsg;
+
+    if(ApiMacPib_cacheRead(attribute, pValue, NULL))
+    {
+        return (ApiMac_status_success);
+    }
+
+    pMsg = (singleReq_t *)ICall_allocMsg(sizeof(singleReq_t));
+    if(pMsg != NULL)
+    {
+        singleReq_t *pCmdStatus = NULL;
+
+        pMsg->event = TEST_GET_REQ;
+        pMsg->status = 0;
+        pMsg->attribute = attribute;
+        pMsg->pValue = pValue;
+
+        if((ICall_sendServiceMsg(ApiMac_appEntity, ICALL_SERVICE_CLASS_TIMAC,
+                                 ICALL_MSG_FORMAT_KEEP, pMsg)
+            == ICALL_ERRNO_SUCCESS)
+           && (ICall_waitMatch(ICALL_TIMEOUT_FOREVER, matchSingle, NULL, NULL,
+                               (void **)&pCmdStatus) == ICALL_ERRNO_SUCCESS))
+        {
+            status = (ApiMac_status_t)pCmdStatus->status;
+            if(status == ApiMac_status_success)
+            {
+                ApiMacPib_cacheUpdate(attribute, pValue);
+            }
+        }
+        ICall_freeMsg(pMsg);
+    }
+    return (status);
+}
+
+/*!
+ * @brief       Set one attribute the way setTypeReq() of api_mac.c does, in
+ *              one round trip.
+ *
+ * @param       attribute - attribute Id
+ * @param       pValue - value
+ *
+ * @return      ApiMac_status_t
+ */
+static ApiMac_status_t singleSet(uint8_t attribute, void *pValue)
+{
+    ApiMac_status_t status = ApiMac_status_noResources;
+    singleReq_t *pMsg = (singleReq_t *)ICall_allocMsg(sizeof(singleReq_t));
+
+    if(pMsg != NULL)
+    {
+        singleReq_t *pCmdStatus = NULL;
+
+        pMsg->event = TEST_SET_REQ;
+        pMsg->status = 0;
+        pMsg->attribute = attribute;
+        pMsg->pValue = pValue;
+
+        if((ICall_sendServiceMsg(ApiMac_appEntity, ICALL_SERVICE_CLASS_TIMAC,
+                                 ICALL_MSG_FORMAT_KEEP, pMsg)
+            == ICALL_ERRNO_SUCCESS)
+           && (ICall_waitMatch(ICALL_TIMEOUT_FOREVER, matchSingle, NULL, NULL,
+                               (void **)&pCmdStatus) == ICALL_ERRNO_SUCCESS))
+        {
+            status = (ApiMac_status_t)pCmdStatus->status;
+            if(status == ApiMac_status_success)
+            {
+                ApiMacPib_cacheUpdate(attribute, pValue);
+            }
+        }
+        ICall_freeMsg(pMsg);
+    }
+    return (status);
+}
+
+/*!
+ * @brief       Replay a call site attribute by attribute and as a batch.
+ *
+ * @param       pSite - call site
+ *
+ * @return      0 on success, 1 on a failure
+ */
+static int runCallSite(const callSite_t *pSite)
+{
+    uint8_t single[APIMAC_PIB_MULTI_MAX_ENTRIES][TEST_MAX_LEN];
+    uint8_t batch[APIMAC_PIB_MULTI_MAX_ENTRIES][TEST_MAX_LEN];
+    macAttr_t singlePib[MAC_PIB_COUNT];
+    ApiMac_mlmePibEntry_t entries[APIMAC_PIB_MULTI_MAX_ENTRIES];
+    unsigned int singleTrips;
+    uint8_t i;
+
+    memset(single, 0, sizeof(single));
+    memset(batch, 0, sizeof(batch));
+
+    /* Values for the sets, not the reset values of the model */
+    if(pSite->set)
+    {
+        for(i = 0; i < pSite->count; i++)
+        {
+            memset(single[i], 0xA0 + i, TEST_MAX_LEN);
+            memset(batch[i], 0xA0 + i, TEST_MAX_LEN);
+        }
+    }
+
+    resetMac();
+    roundTrips = 0;
+    for(i = 0; i < pSite->count; i++)
+    {
+        ApiMac_status_t status = (pSite->set) ?
+                        singleSet(pSite->attributes[i], single[i]) :
+                        singleGet(pSite->attributes[i], single[i]);
+
+        if(status != ApiMac_status_success)
+        {
+            printf("FAIL: %s single request %u status 0x%02X\n", pSite->name,
+                   i, status);
+            return (1);
+        }
+    }
+    singleTrips = roundTrips;
+    memcpy(singlePib, macPib, sizeof(macPib));
+
+    resetMac();
+    roundTrips = 0;
+    for(i = 0; i < pSite->count; i++)
+    {
+        entries[i].attribute = pSite->attributes[i];
+        entries[i].status = 0;
+        entries[i].len = (pSite->set) ? 0 : TEST_MAX_LEN;
+        entries[i].pValue = batch[i];
+    }
+
+    if(((pSite->set) ? ApiMac_mlmeSetReqMulti(entries, pSite->count) :
+        ApiMac_mlmeGetReqMulti(entries, pSite->count))
+       != ApiMac_status_success)
+    {
+        printf("FAIL: %s batch request failed\n", pSite->name);
+        return (1);
+    }
+
+    for(i = 0; i < pSite->count; i++)
+    {
+        macAttr_t *pAttr = findAttr(pSite->attributes[i]);
+
+        if(entries[i].status != ApiMac_status_success)
+        {
+            printf("FAIL: %s batch entry %u status 0x%02X\n", pSite->name,
+                   i, entries[i].status);
+            return (1);
+        }
+        if(!pSite->set && ((entries[i].len != pAttr->len)
+                           || memcmp(single[i], batch[i], TEST_MAX_LEN)))
+        {
+            printf("FAIL: %s batch read of entry %u differs\n", pSite->name,
+                   i);
+            return (1);
+        }
+    }
+
+    if(memcmp(singlePib, macPib, sizeof(macPib)))
+    {
+        printf("FAIL: %s batch left the MAC PIB different\n", pSite->name);
+        return (1);
+    }
+
+    printf("%-16s %u attributes, round trips: single %u, batch %u\n",
+           pSite->name, pSite->count, singleTrips, roundTrips);
+
+    if((singleTrips != pSite->count) || (roundTrips != 1))
+    {
+        printf("FAIL: %s expected %u round trips to 1\n", pSite->name,
+               pSite->count);
+        return (1);
+    }
+    return (0);
+}
+
+/*!
+ * @brief       Check the PIB cache and the requests that must not use it.
+ *
+ * @return      0 on success, 1 on a failure
+ */
+static int runCacheChecks(void)
+{
+    uint8_t extAddr[APIMAC_SADDR_EXT_LEN];
+    uint8_t newAddr[APIMAC_SADDR_EXT_LEN];
+    uint8_t shortValue[4];
+    uint32_t counter = 0;
+    ApiMac_mlmePibEntry_t entry;
+    ApiMac_mlmePibEntry_t pair[2];
+    ApiMac_mlmePibEntry_t many[APIMAC_PIB_MULTI_MAX_ENTRIES + 1];
+    macAttr_t *pExt = findAttr(ApiMac_attribute_extendedAddress);
+
+    resetMac();
+
+    /* The first get of the address goes to the MAC, the next ones don't */
+    roundTrips = 0;
+    entry.attribute = ApiMac_attribute_extendedAddress;
+    entry.len = sizeof(extAddr);
+    entry.pValue = extAddr;
+    if((ApiMac_mlmeGetReqMulti(&entry, 1) != ApiMac_status_success)
+       || (roundTrips != 1) || memcmp(extAddr, pExt->value, sizeof(extAddr)))
+    {
+        printf("FAIL: first get of the extended address\n");
+        return (1);
+    }
+
+    memset(extAddr, 0, sizeof(extAddr));
+    entry.len = sizeof(extAddr);
+    if((ApiMac_mlmeGetReqMulti(&entry, 1) != ApiMac_status_success)
+       || (singleGet(ApiMac_attribute_extendedAddress, newAddr)
+           != ApiMac_status_success)
+       || (roundTrips != 1) || (entry.len != APIMAC_SADDR_EXT_LEN)
+       || memcmp(extAddr, pExt->value, sizeof(extAddr))
+       || memcmp(newAddr, pExt->value, sizeof(newAddr)))
+    {
+        printf("FAIL: cached extended address, %u round trips\n",
+               roundTrips);
+        return (1);
+    }
+
+    /* A batch with an attribute that isn't cached goes to the MAC */
+    pair[0] = entry;
+    pair[1].attribute = ApiMac_attribute_diagRxSecureFail;
+    pair[1].len = sizeof(counter);
+    pair[1].pValue = &counter;
+    if((ApiMac_mlmeGetReqMulti(pair, 2) != ApiMac_status_success)
+       || (roundTrips != 2))
+    {
+        printf("FAIL: batch with an uncached attribute\n");
+        return (1);
+    }
+
+    /* A buffer shorter than the cached value goes to the MAC */
+    entry.len = 4;
+    entry.pValue = shortValue;
+    if((ApiMac_mlmeGetReqMulti(&entry, 1) != ApiMac_status_invalidParameter)
+       || (entry.status != ApiMac_status_invalidParameter)
+       || (roundTrips != 3))
+    {
+        printf("FAIL: short buffer served from the cache\n");
+        return (1);
+    }
+
+    /* A set updates the cache */
+    memset(newAddr, 0x5A, sizeof(newAddr));
+    entry.len = 0;
+    entry.pValue = newAddr;
+    if((ApiMac_mlmeSetReqMulti(&entry, 1) != ApiMac_status_success)
+       || (roundTrips != 4))
+    {
+        printf("FAIL: set of the extended address\n");
+        return (1);
+    }
+
+    entry.len = sizeof(extAddr);
+    entry.pValue = extAddr;
+    if((ApiMac_mlmeGetReqMulti(&entry, 1) != ApiMac_status_success)
+       || (roundTrips != 4) || memcmp(extAddr, newAddr, sizeof(extAddr)))
+    {
+        printf("FAIL: cache not updated by the set\n");
+        return (1);
+    }
+
+    /* A MAC reset clears it */
+    ApiMacPib_cacheClear();
+    if(ApiMacPib_cacheRead(ApiMac_attribute_extendedAddress, extAddr, NULL)
+       || (singleGet(ApiMac_attribute_extendedAddress, extAddr)
+           != ApiMac_status_success)
+       || (roundTrips != 5))
+    {
+        printf("FAIL: cache not cleared\n");
+        return (1);
+    }
+
+    /* A failing attribute fails the batch and isn't cached */
+    ApiMacPib_cacheClear();
+    pair[0].attribute = TEST_UNKNOWN_ATTRIBUTE;
+    pair[0].len = sizeof(counter);
+    pair[0].pValue = &counter;
+    pair[1].attribute = ApiMac_attribute_extendedAddress;
+    pair[1].len = sizeof(extAddr);
+    pair[1].pValue = extAddr;
+    if((ApiMac_mlmeGetReqMulti(pair, 2) != ApiMac_status_unsupportedAttribute)
+       || (pair[0].status != ApiMac_status_unsupportedAttribute)
+       || (pair[1].status != ApiMac_status_success)
+       || !ApiMacPib_cacheRead(ApiMac_attribute_extendedAddress, newAddr,
+                               NULL))
+    {
+        printf("FAIL: batch with an unknown attribute\n");
+        return (1);
+    }
+
+    /* Bad counts are refused without a message */
+    roundTrips = 0;
+    memset(many, 0, sizeof(many));
+    if((ApiMac_mlmeGetReqMulti(many, 0) != ApiMac_status_invalidParameter)
+       || (ApiMac_mlmeSetReqMulti(many, APIMAC_PIB_MULTI_MAX_ENTRIES + 1)
+           != ApiMac_status_invalidParameter)
+       || (roundTrips != 0))
+    {
+        printf("FAIL: bad entry counts\n");
+        return (1);
+    }
+
+    /* No message buffer: every entry reports it */
+    ApiMacPib_cacheClear();
+    failAlloc = true;
+    pair[0].attribute = ApiMac_attribute_panId;
+    pair[0].status = 0;
+    pair[1].status = 0;
+    if((ApiMac_mlmeGetReqMulti(pair, 2) != ApiMac_status_noResources)
+       || (pair[0].status != ApiMac_status_noResources)
+       || (pair[1].status != ApiMac_status_noResources)
+       || (roundTrips != 0))
+    {
+        printf("FAIL: no message buffer\n");
+        return (1);
+    }
+
+    return (0);
+}
+
+/******************************************************************************
+ Public Functions
+ *****************************************************************************/
+
+/*!
+ ICall message allocation, fails when the test asks for it
+ */
+void *ICall_allocMsg(size_t size)
+{
+    if(failAlloc)
+    {
+        failAlloc = false;
+        return (NULL);
+    }
+    msgsHeld++;
+    return (malloc(size));
+}
+
+/*!
+ ICall message free
+ */
+void ICall_freeMsg(void *msg)
+{
+    msgsHeld--;
+    free(msg);
+}
+
+/*!
+ Send a message to the MAC stack, which answers it at once
+ */
+ICall_Errno ICall_sendServiceMsg(ICall_EntityID src, ICall_ServiceEnum dest,
+                                 ICall_MSGFormat format, void *msg)
+{
+    uint8_t event = *(uint8_t *)msg;
+
+    (void)src;
+    (void)dest;
+    (void)format;
+
+    roundTrips++;
+    if((event == MAC_GET_REQ_MULTI) || (event == MAC_SET_REQ_MULTI))
+    {
+        macMulti((macPibMultiParam_t *)msg);
+    }
+    else
+    {
+        macSingle((singleReq_t *)msg);
+    }
+    pReply = msg;
+    return (ICALL_ERRNO_SUCCESS);
+}
+
+/*!
+ Wait for the reply of the MAC stack
+ */
+ICall_Errno ICall_waitMatch(uint_least32_t milliseconds,
+                            ICall_MsgMatchFn matchFn, ICall_ServiceEnum *src,
+                            ICall_EntityID *dest, void **msg)
+{
+    (void)milliseconds;
+    (void)src;
+    (void)dest;
+
+    if((pReply == NULL) || !matchFn(ICALL_SERVICE_CLASS_TIMAC, 0, pReply))
+    {
+        printf("FAIL: no matching reply\n");
+        exit(1);
+    }
+    *msg = pReply;
+    pReply = NULL;
+    return (ICALL_ERRNO_SUCCESS);
+}
+
+int main(void)
+{
+    unsigned int i;
+
+    for(i = 0; i < sizeof(callSites) / sizeof(callSites[0]); i++)
+    {
+        if(runCallSite(&callSites[i]))
+        {
+            return (1);
+        }
+    }
+
+    if(runCacheChecks())
+    {
+        return (1);
+    }
+
+    if(msgsHeld != 0)
+    {
+        printf("FAIL: %d messages not freed\n", msgsHeld);
+        return (1);
+    }
+
+    return (0);
+}
@@ -0,0 +1,41 @@
+/******************************************************************************
+
+ @file icall.h
+
+ @brief Host stand-in for ICall: the message calls of the ApiMac requests,
+        answered by the model of the MAC stack in apimac_test.c.
+
+ *****************************************************************************/
+#ifndef ICALL_H
+#define ICALL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define ICALL_ERRNO_SUCCESS                     0
+#define ICALL_ERRNO_NOMSG                       2
+
+#define ICALL_SERVICE_CLASS_TIMAC               0x0010
+#define ICALL_MSG_FORMAT_KEEP                   0
+#define ICALL_TIMEOUT_FOREVER                   0xFFFFFFFF
+
+typedef int_fast16_t ICall_Errno;
+typedef uint_least8_t ICall_EntityID;
+typedef uint_least16_t ICall_ServiceEnum;
+typedef uint_least8_t ICall_MSGFormat;
+
+typedef bool (*ICall_MsgMatchFn)(ICall_ServiceEnum src, ICall_EntityID dest,
+                                 const void *msg);
+
+extern void *ICall_allocMsg(size_t size);
+extern void ICall_freeMsg(void *msg);
+extern ICall_Errno ICall_sendServiceMsg(ICall_EntityID src,
+                                        ICall_ServiceEnum dest,
+                                        ICall_MSGFormat format, void *msg);
+extern ICall_Errno ICall_waitMatch(uint_least32_t milliseconds,
+                                   ICall_MsgMatchFn matchFn,
+                                   ICall_ServiceEnum *src,
+                                   ICall_EntityID *dest, void **msg);
+
+#endif /* ICALL_H */
@@ -0,0 +1,657 @@
+/******************************************************************************
+
+ @file blist_test.c
+
+ @brief Host test and benchmark of the black list copy, blist.c, on a
+        model of the NV driver.
+
+        The checker stores and erases addresses from a small pool, with NV
+        writes and deletes failing at random, and power cycles in between.
+        After every operation the RAM copy must hold exactly the address
+        records in NV, under their sub IDs, the count item must match it,
+        and a reload from NV must give the same copy.
+
+        The benchmark runs the beacon filter of jdllc.c with 10 to 100
+        addresses in the list. Each beacon is looked up in the RAM copy and
+        by the NV scan Ssf_findBlackListIndex() did before the copy, which
+        read the count item and then the records until a match. The NV
+        model keeps its items in write order and a read walks the item
+        headers from the newest, as NVOCTP_findItem() does on the page.
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "blist.h"
+
+/******************************************************************************
+ Constants and definitions
+ *****************************************************************************/
+
+/*! NV items of the list, as ssf.c stores them */
+#define NV_BLACKLIST_ENTRIES_ID 0x0002
+#define NV_BLACKLIST_ID         0x0003
+#define NV_MAX_SUB_IDS          500
+
+/*! Other application items on the page */
+#define NV_OTHER_ID             0x0010
+#define NV_OTHER_ITEMS          8
+
+/*! Items in the NV model */
+#define NV_MAX_ITEMS            1024
+
+/*! Longest item of the NV model */
+#define NV_MAX_LEN              16
+
+/*! Entries of the sensor's list, and addresses the checker picks from */
+#define CHECK_ENTRIES           10
+#define CHECK_POOL              24
+
+/*! Random operations of the checker */
+#define CHECK_OPS               20000
+
+/*! Largest list of the benchmark */
+#define BENCH_MAX_ENTRIES       100
+
+/*! Beacons of a benchmark run, one in BENCH_LISTED_EVERY is listed */
+#define BENCH_BEACONS           10000
+#define BENCH_LISTED_EVERY      10
+
+/*! Item of the NV model */
+typedef struct
+{
+    uint16_t itemId;
+    uint16_t subId;
+    uint16_t len;
+    bool valid;
+    uint8_t data[NV_MAX_LEN];
+} nvItem_t;
+
+/******************************************************************************
+ Local Variables
+ *****************************************************************************/
+
+/*! NV items, in write order */
+static nvItem_t nvItems[NV_MAX_ITEMS];
+static unsigned int nvNumItems;
+
+/*! readItem() calls and item headers walked */
+static unsigned long nvReads;
+static unsigned long nvHeaders;
+
+/*! Fail the next write or delete of an address record */
+static bool nvFailWrite;
+static bool nvFailDelete;
+
+/*! Random number state */
+static uint32_t randState = 1;
+
+/*! Entry storage of the list and of a reloaded copy */
+static Blist_entry_t listEntries[BENCH_MAX_ENTRIES];
+static Blist_entry_t reloadEntries[BENCH_MAX_ENTRIES];
+
+/******************************************************************************
+ Local Functions
+ *****************************************************************************/
+
+/*!
+ * @brief       Find the newest valid NV item, walking from the newest.
+ *
+ * @param       id - item ID
+ *
+ * @return      item, NULL if not found
+ */
+static nvItem_t *nvFind(NVINTF_itemID_t id)
+{
+    unsigned int i;
+
+    for(i = nvNumItems; i > 0; i--)
+    {
+        nvItem_t *pItem = &nvItems[i - 1];
+
+        nvHeaders++;
+        if(pItem->valid && (pItem->itemId == id.itemID)
+           && (pItem->subId == id.subID))
+        {
+            return (pItem);
+        }
+    }
+    return (NULL);
+}
+
+/*!
+ * @brief       NV model: delete an item.
+ */
+static uint8_t nvDeleteItem(NVINTF_itemID_t id)
+{
+    nvItem_t *pItem;
+
+    if((id.itemID == NV_BLACKLIST_ID) && nvFailDelete)
+    {
+        nvFailDelete = false;
+        return (NVINTF_FAILURE);
+    }
+
+    pItem = nvFind(id);
+    if(pItem == NULL)
+    {
+        return (NVINTF_NOTFOUND);
+    }
+
+    pItem->valid = false;
+    return (NVINTF_SUCCESS);
+}
+
+/*!
+ * @brief       NV model: read an item.
+ */
+static uint8_t nvReadItem(NVINTF_itemID_t id, uint16_t offset, uint16_t bLen,
+                          void *pBuf)
+{
+    nvItem_t *pItem;
+
+    nvReads++;
+
+    pItem = nvFind(id);
+    if((pItem == NULL) || ((offset + bLen) > pItem->len))
+    {
+        return (NVINTF_NOTFOUND);
+    }
+
+    memcpy(pBuf, &pItem->data[offset], bLen);
+    return (NVINTF_SUCCESS);
+}
+
+/*!
+ * @brief       NV model: write an item, after the others. The items are
+ *              compacted when the model is full.
+ */
+static uint8_t nvWriteItem(NVINTF_itemID_t id, uint16_t bLen, void *pBuf)
+{
+    nvItem_t *pItem;
+
+    if(((id.itemID == NV_BLACKLIST_ID) && nvFailWrite)
+       || (bLen > NV_MAX_LEN))
+    {
+        nvFailWrite = false;
+        return (NVINTF_FAILURE);
+    }
+
+    pItem = nvFind(id);
+    if(pItem != NULL)
+    {
+        pItem->valid = false;
+    }
+
+    if(nvNumItems == NV_MAX_ITEMS)
+    {
+        unsigned int i;
+        unsigned int kept = 0;
+
+        for(i = 0; i < nvNumItems; i++)
+        {
+            if(nvItems[i].valid)
+            {
+                nvItems[kept++] = nvItems[i];
+            }
+        }
+        nvNumItems = kept;
+    }
+
+    pItem = &nvItems[nvNumItems++];
+    pItem->itemId = id.itemID;
+    pItem->subId = id.subID;
+    pItem->len = bLen;
+    pItem->valid = true;
+    memcpy(pItem->data, pBuf, bLen);
+
+    return (NVINTF_SUCCESS);
+}
+
+/*! NV functions of the model */
+static NVINTF_nvFuncts_t nvFuncts =
+{
+    nvDeleteItem, nvReadItem, nvWriteItem
+};
+
+/*! NV items of the list */
+static const Blist_nv_t listNv =
+{
+    &nvFuncts, NV_BLACKLIST_ID, NV_BLACKLIST_ENTRIES_ID, NV_MAX_SUB_IDS
+};
+
+/*!
+ * @brief       Erase the NV model.
+ */
+static void nvErase(void)
+{
+    nvNumItems = 0;
+    nvFailWrite = false;
+    nvFailDelete = false;
+}
+
+/*!
+ * @brief       Random number from 0 to range - 1.
+ *
+ * @param       range - number of values
+ *
+ * @return      random number
+ */
+static uint32_t randomRange(uint32_t range)
+{
+    randState = randState * 1103515245 + 12345;
+
+    return ((randState >> 8) % range);
+}
+
+/*!
+ * @brief       Read a monotonic clock.
+ *
+ * @return      time, in nanoseconds
+ */
+static uint64_t readNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (((uint64_t)ts.tv_sec * 1000000000u) + (uint64_t)ts.tv_nsec);
+}
+
+/*!
+ * @brief       Make a random extended address.
+ *
+ * @param       pAddr - address
+ */
+static void randomExtAddr(ApiMac_sAddr_t *pAddr)
+{
+    uint8_t i;
+
+    memset(pAddr, 0, sizeof(ApiMac_sAddr_t));
+    pAddr->addrMode = ApiMac_addrType_extended;
+    for(i = 0; i < APIMAC_SADDR_EXT_LEN; i++)
+    {
+        /* The top bits, the low ones of the generator repeat too soon */
+        pAddr->addr.extAddr[i] = (uint8_t)(randomRange(1u << 24) >> 16);
+    }
+}
+
+/*!
+ * @brief       Look an address up as Ssf_findBlackListIndex() did before
+ *              the RAM copy: read the count, then the records from sub ID 0
+ *              until a match.
+ *
+ * @param       pAddr - address
+ *
+ * @return      sub ID of the address, BLIST_NOT_FOUND if not in the list
+ */
+static int nvFindIndex(ApiMac_sAddr_t *pAddr)
+{
+    NVINTF_itemID_t id;
+    uint16_t numEntries = 0;
+    int readItems = 0;
+    int subId = 0;
+
+    id.systemID = NVINTF_SYSID_APP;
+    id.itemID = NV_BLACKLIST_ENTRIES_ID;
+    id.subID = 0;
+    if(nvReadItem(id, 0, sizeof(uint16_t), &numEntries) != NVINTF_SUCCESS)
+    {
+        return (BLIST_NOT_FOUND);
+    }
+
+    id.itemID = NV_BLACKLIST_ID;
+    while((readItems < numEntries) && (subId < NV_MAX_SUB_IDS))
+    {
+        ApiMac_sAddr_t item;
+
+        id.subID = (uint16_t)subId;
+        if(nvReadItem(id, 0, sizeof(ApiMac_sAddr_t), &item) == NVINTF_SUCCESS)
+        {
+            if((pAddr->addrMode == item.addrMode)
+               && (((pAddr->addrMode == ApiMac_addrType_short)
+                    && (pAddr->addr.shortAddr == item.addr.shortAddr))
+                   || ((pAddr->addrMode == ApiMac_addrType_extended)
+                       && (memcmp(pAddr->addr.extAddr, item.addr.extAddr,
+                                  APIMAC_SADDR_EXT_LEN) == 0))))
+            {
+                return (subId);
+            }
+            readItems++;
+        }
+        subId++;
+    }
+    return (BLIST_NOT_FOUND);
+}
+
+/*!
+ * @brief       Check the list against the address records in NV, and
+ *              against a reload from NV.
+ *
+ * @param       pList - list
+ *
+ * @return      true if consistent
+ */
+static bool checkMirror(Blist_t *pList)
+{
+    Blist_t reload;
+    unsigned int records = 0;
+    unsigned int i;
+    NVINTF_itemID_t id;
+    uint16_t numItems = 0;
+
+    for(i = 0; i < nvNumItems; i++)
+    {
+        nvItem_t *pItem = &nvItems[i];
+        ApiMac_sAddr_t addr;
+
+        if(!pItem->valid || (pItem->itemId != NV_BLACKLIST_ID))
+        {
+            continue;
+        }
+
+        records++;
+        memcpy(&addr, pItem->data, sizeof(addr));
+        if(Blist_find(pList, &addr) != (int)pItem->subId)
+        {
+            printf("FAIL: NV record %u is not in the copy\n", pItem->subId);
+            return (false);
+        }
+    }
+
+    if(records != pList->numEntries)
+    {
+        printf("FAIL: %u NV records, %u in the copy\n", records,
+               pList->numEntries);
+        return (false);
+    }
+
+    id.systemID = NVINTF_SYSID_APP;
+    id.itemID = NV_BLACKLIST_ENTRIES_ID;
+    id.subID = 0;
+    nvReadItem(id, 0, sizeof(uint16_t), &numItems);
+    if(numItems != pList->numEntries)
+    {
+        printf("FAIL: count item %u, %u in the copy\n", numItems,
+               pList->numEntries);
+        return (false);
+    }
+
+    Blist_init(&reload, reloadEntries, pList->maxEntries);
+    Blist_load(&reload, &listNv);
+    if((reload.numEntries != pList->numEntries)
+       || (memcmp(reload.pEntries, pList->pEntries,
+                  pList->numEntries * sizeof(Blist_entry_t)) != 0))
+    {
+        printf("FAIL: reload from NV differs from the copy\n");
+        return (false);
+    }
+
+    return (true);
+}
+
+/*!
+ * @brief       Random stores, erases and power cycles with NV failures,
+ *              the copy checked against NV after each.
+ *
+ * @return      0 on success, 1 on a failure
+ */
+static int runChecker(void)
+{
+    ApiMac_sAddr_t pool[CHECK_POOL];
+    bool listed[CHECK_POOL];
+    unsigned int numListed = 0;
+    unsigned long stores = 0;
+    unsigned long erases = 0;
+    unsigned long failed = 0;
+    Blist_t list;
+    unsigned int i;
+    unsigned int op;
+
+    nvErase();
+    Blist_init(&list, listEntries, CHECK_ENTRIES);
+    Blist_load(&list, &listNv);
+
+    /* Extended addresses, and short ones of the same first 2 bytes */
+    for(i = 0; i < CHECK_POOL; i++)
+    {
+        randomExtAddr(&pool[i]);
+        if(i & 1)
+        {
+            uint16_t shortAddr = (uint16_t)(pool[i - 1].addr.extAddr[0]
+                                 | (pool[i - 1].addr.extAddr[1] << 8));
+
+            memset(&pool[i], 0, sizeof(pool[i]));
+            pool[i].addrMode = ApiMac_addrType_short;
+            pool[i].addr.shortAddr = shortAddr;
+        }
+        listed[i] = false;
+    }
+
+    for(op = 0; op < CHECK_OPS; op++)
+    {
+        uint32_t pick = randomRange(100);
+
+        i = randomRange(CHECK_POOL);
+
+        if(pick < 50)
+        {
+            bool fail = (randomRange(10) == 0);
+            bool expect = listed[i] || (!fail && (numListed < CHECK_ENTRIES));
+
+            nvFailWrite = fail;
+            if(Blist_store(&list, &listNv, &pool[i]) != expect)
+            {
+                printf("FAIL: store of address %u returned %d\n", i, !expect);
+                return (1);
+            }
+            if(expect && !listed[i])
+            {
+                listed[i] = true;
+                numListed++;
+                stores++;
+            }
+            failed += (fail && !listed[i]) ? 1 : 0;
+            nvFailWrite = false;
+        }
+        else if(pick < 90)
+        {
+            bool fail = (randomRange(10) == 0);
+
+            nvFailDelete = fail;
+            Blist_erase(&list, &listNv, &pool[i]);
+            if(listed[i] && !fail)
+            {
+                listed[i] = false;
+                numListed--;
+                erases++;
+            }
+            failed += (fail && listed[i]) ? 1 : 0;
+            nvFailDelete = false;
+        }
+        else if(pick < 99)
+        {
+            /* Power cycle */
+            Blist_init(&list, listEntries, CHECK_ENTRIES);
+            Blist_load(&list, &listNv);
+        }
+        else
+        {
+            Blist_eraseAll(&list, &listNv);
+            memset(listed, 0, sizeof(listed));
+            numListed = 0;
+        }
+
+        if(!checkMirror(&list))
+        {
+            printf("FAIL: after operation %u\n", op);
+            return (1);
+        }
+
+        for(i = 0; i < CHECK_POOL; i++)
+        {
+            if((Blist_find(&list, &pool[i]) != BLIST_NOT_FOUND) != listed[i])
+            {
+                printf("FAIL: address %u listed %d in the copy, %d in the "
+                       "model\n", i, !listed[i], listed[i]);
+                return (1);
+            }
+        }
+    }
+
+    printf("checker: %u operations, %lu stores, %lu erases, %lu NV failures "
+           "left the copy as it was\n", CHECK_OPS, stores, erases, failed);
+
+    return (0);
+}
+
+/*!
+ * @brief       Time the beacon filter, on the copy and on the NV scan.
+ *
+ * @param       numEntries - addresses in the list
+ *
+ * @return      0 on success, 1 on a failure
+ */
+static int runBench(unsigned int numEntries)
+{
+    static ApiMac_sAddr_t beacons[BENCH_BEACONS];
+    static int expect[BENCH_BEACONS];
+    ApiMac_sAddr_t other;
+    Blist_t list;
+    unsigned int i;
+    unsigned long listedBeacons = 0;
+    unsigned long reads;
+    unsigned long headers;
+    uint64_t start;
+    uint64_t oldNs;
+    uint64_t newNs;
+    volatile int sink = 0;
+
+    nvErase();
+    randomExtAddr(&other);
+    for(i = 0; i < NV_OTHER_ITEMS; i++)
+    {
+        NVINTF_itemID_t id = { NVINTF_SYSID_APP, NV_OTHER_ID, (uint16_t)i };
+
+        nvWriteItem(id, sizeof(other), &other);
+    }
+
+    Blist_init(&list, listEntries, BENCH_MAX_ENTRIES);
+    while(list.numEntries < numEntries)
+    {
+        ApiMac_sAddr_t addr;
+
+        randomExtAddr(&addr);
+        if(!Blist_store(&list, &listNv, &addr))
+        {
+            printf("FAIL: store %u of %u\n", list.numEntries, numEntries);
+            return (1);
+        }
+    }
+
+    /* Beacons from coordinators, one in BENCH_LISTED_EVERY listed */
+    for(i = 0; i < BENCH_BEACONS; i++)
+    {
+        if(randomRange(BENCH_LISTED_EVERY) == 0)
+        {
+            Blist_entry_t *pEntry = &list.pEntries[randomRange(numEntries)];
+
+            memset(&beacons[i], 0, sizeof(beacons[i]));
+            beacons[i].addrMode = ApiMac_addrType_extended;
+            memcpy(beacons[i].addr.extAddr, &pEntry->key[1],
+                   APIMAC_SADDR_EXT_LEN);
+            expect[i] = pEntry->subId;
+            listedBeacons++;
+        }
+        else
+        {
+            do
+            {
+                randomExtAddr(&beacons[i]);
+            } while(Blist_find(&list, &beacons[i]) != BLIST_NOT_FOUND);
+            expect[i] = BLIST_NOT_FOUND;
+        }
+    }
+
+    nvReads = nvHeaders = 0;
+    start = readNs();
+    for(i = 0; i < BENCH_BEACONS; i++)
+    {
+        int index = nvFindIndex(&beacons[i]);
+
+        if(index != expect[i])
+        {
+            printf("FAIL: NV scan of beacon %u gave %d\n", i, index);
+            return (1);
+        }
+    }
+    oldNs = readNs() - start;
+    reads = nvReads;
+    headers = nvHeaders;
+
+    nvReads = nvHeaders = 0;
+    start = readNs();
+    for(i = 0; i < BENCH_BEACONS; i++)
+    {
+        sink += Blist_find(&list, &beacons[i]);
+    }
+    newNs = readNs() - start;
+
+    for(i = 0; i < BENCH_BEACONS; i++)
+    {
+        if(Blist_find(&list, &beacons[i]) != expect[i])
+        {
+            printf("FAIL: copy lookup of beacon %u\n", i);
+            return (1);
+        }
+    }
+    if(nvReads != 0)
+    {
+        printf("FAIL: %lu NV reads on the beacon path\n", nvReads);
+        return (1);
+    }
+
+    printf("%3u entries, %lu of %u beacons listed: NV scan %6.1f reads "
+           "%7.1f headers %8.0f ns, copy 0 reads %5.0f ns per beacon\n",
+           numEntries, listedBeacons, BENCH_BEACONS,
+           (double)reads / BENCH_BEACONS, (double)headers / BENCH_BEACONS,
+           (double)oldNs / BENCH_BEACONS, (double)newNs / BENCH_BEACONS);
+
+    (void)sink;
+    return (0);
+}
+
+/******************************************************************************
+ Public Functions
+ *****************************************************************************/
+
+int main(void)
+{
+    static const unsigned int counts[] = { 10, 25, 50, 100 };
+    unsigned int c;
+
+    if(runChecker())
+    {
+        return (1);
+    }
+
+    for(c = 0; c < sizeof(counts) / sizeof(counts[0]); c++)
+    {
+        if(runBench(counts[c]))
+        {
+            return (1);
+        }
+    }
+
+    return (0);
+}
@@ -0,0 +1,40 @@
+/******************************************************************************
+
+ @file nvintf.h
+
+ @brief Host stand-in for the NV driver interface, the item functions the
+        black list uses.
+
+ *****************************************************************************/
+#ifndef NVINTF_H
+#define NVINTF_H
+
+#include <stdint.h>
+
+#define NVINTF_SUCCESS          0
+#define NVINTF_FAILURE          1
+#define NVINTF_NOTFOUND         6
+
+#define NVINTF_SYSID_APP        5
+
+typedef struct nvintf_itemid_t
+{
+    uint8_t systemID;
+    uint16_t itemID;
+    uint16_t subID;
+} NVINTF_itemID_t;
+
+typedef uint8_t (*NVINTF_deleteItem)(NVINTF_itemID_t id);
+typedef uint8_t (*NVINTF_readItem)(NVINTF_itemID_t id, uint16_t offset,
+                                   uint16_t bLen, void *pBuf);
+typedef uint8_t (*NVINTF_writeItem)(NVINTF_itemID_t id, uint16_t bLen,
+                                    void *pBuf);
+
+typedef struct nvintf_nvfuncts_t
+{
+    NVINTF_deleteItem deleteItem;
+    NVINTF_readItem readItem;
+    NVINTF_writeItem writeItem;
+} NVINTF_nvFuncts_t;
+
+#endif /* NVINTF_H */
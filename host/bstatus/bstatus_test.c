@@ -0,0 +1,293 @@
+/******************************************************************************
+
+ @file bstatus_test.c
+
+ @brief Host counter test of the status display service, board_status.c:
+        LCD and LED writes per 1000 messages.
+
+        The trace writes the display the way the co-processor does for each
+        MT message received and sent (mcp.c), and the collector for each
+        sensor frame (csf.c), at 50 to 1000 messages a second. The refresh
+        clock is fired on a simulated clock, and Board_Status_refresh() is
+        called when it notifies.
+
+        Built with BOARD_STATUS_ENABLED set to 1, the writes per 1000
+        messages are bounded by the refresh periods. Set to 0, every
+        message is written directly. Either way the LCD must end with the
+        last text of each line.
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "timer.h"
+#include "board_status.h"
+
+/******************************************************************************
+ Constants and definitions
+ *****************************************************************************/
+
+/*! Messages of each run */
+#define MESSAGES                1000
+
+/*! Lines written by the trace */
+#define LINE_RX                 4
+#define LINE_TX                 5
+#define LINE_SENSOR             6
+
+/*! Lines and LEDs written per refresh at most */
+#define LINES_USED              3
+#define LED_WRITES_USED         3
+
+/*! Painted text of an LCD line */
+typedef struct
+{
+    char *str;
+    uint16_t value;
+    bool painted;
+} lcdLine_t;
+
+/******************************************************************************
+ Local Variables
+ *****************************************************************************/
+
+/*! Refresh clock, constructed by Board_Status_init() */
+static Clock_Struct *pRefreshClock;
+
+/*! Set by the notify function, cleared by the refresh */
+static bool refreshPending;
+
+/*! LCD and LED writes */
+static unsigned long lcdWrites;
+static unsigned long ledWrites;
+
+/*! Notifies of the refresh clock */
+static unsigned long notifies;
+
+/*! Text on the LCD */
+static lcdLine_t lcd[8];
+
+/******************************************************************************
+ Local Functions
+ *****************************************************************************/
+
+/*!
+ * @brief       Notify function of the status display, posts the refresh.
+ */
+static void statusNotify(void)
+{
+    notifies++;
+    refreshPending = true;
+}
+
+/*!
+ * @brief       Fire the refresh clock and run the refresh it asked for, as
+ *              the application task does.
+ */
+static void fireRefresh(void)
+{
+    if(pRefreshClock != NULL)
+    {
+        pRefreshClock->fxn(pRefreshClock->arg);
+    }
+
+    if(refreshPending)
+    {
+        refreshPending = false;
+        Board_Status_refresh();
+    }
+}
+
+/*!
+ * @brief       Run the trace at a message rate.
+ *
+ * @param       rate - messages a second
+ *
+ * @return      0 on success, 1 on a failure
+ */
+static int runTrace(unsigned int rate)
+{
+    static char rxStr[] = "MT RX Msgs:";
+    static char txStr[] = "MT TX Msgs:";
+    static char sensorStr[] = "Sensor 0x";
+    uint16_t numRxMsgs = 0;
+    uint16_t numTxMsgs = 0;
+    uint16_t sensor = 0;
+    uint32_t period = BOARD_STATUS_PERIOD;
+    uint32_t nextRefresh = period;
+    unsigned long periods = 0;
+    unsigned int msg;
+
+    lcdWrites = ledWrites = notifies = 0;
+    memset(lcd, 0, sizeof(lcd));
+
+    for(msg = 0; msg < MESSAGES; msg++)
+    {
+        uint32_t now = (uint32_t)(((uint64_t)msg * 1000) / rate);
+
+        while(now >= nextRefresh)
+        {
+            fireRefresh();
+            nextRefresh += period;
+            periods++;
+        }
+
+        switch(msg % 3)
+        {
+            case 0:
+                numRxMsgs++;
+                STATUS_WRITE_STRING_VALUE(rxStr, numRxMsgs, 10, LINE_RX);
+                STATUS_LED_CONTROL(board_led_type_LED1,
+                                   board_led_state_BLINK);
+                break;
+
+            case 1:
+                numTxMsgs++;
+                STATUS_WRITE_STRING_VALUE(txStr, numTxMsgs, 10, LINE_TX);
+                STATUS_LED_CONTROL(board_led_type_LED2,
+                                   board_led_state_BLINK);
+                break;
+
+            default:
+                sensor = (uint16_t)(0x0001 + (msg % 50));
+                STATUS_LED_TOGGLE(board_led_type_LED2);
+                STATUS_WRITE_STRING_VALUE(sensorStr, sensor, 16, LINE_SENSOR);
+                break;
+        }
+    }
+
+    /* One more period paints what is left, the next one finds nothing */
+    fireRefresh();
+    periods++;
+    notifies = 0;
+    fireRefresh();
+
+    printf("enabled %d, %4u msg/s: %5.0f LCD writes, %5.0f LED writes "
+           "per 1000 messages, %lu refreshes\n", BOARD_STATUS_ENABLED, rate,
+           (lcdWrites * 1000.0) / MESSAGES, (ledWrites * 1000.0) / MESSAGES,
+           periods);
+
+    if(!lcd[LINE_RX].painted || (lcd[LINE_RX].str != rxStr)
+       || (lcd[LINE_RX].value != numRxMsgs)
+       || !lcd[LINE_TX].painted || (lcd[LINE_TX].value != numTxMsgs)
+       || !lcd[LINE_SENSOR].painted || (lcd[LINE_SENSOR].value != sensor))
+    {
+        printf("FAIL: LCD does not show the last text of each line\n");
+        return (1);
+    }
+
+#if BOARD_STATUS_ENABLED
+    if((lcdWrites > (LINES_USED * periods))
+       || (ledWrites > (LED_WRITES_USED * periods)) || (notifies != 0))
+    {
+        printf("FAIL: more writes than refreshes allow, or an idle refresh\n");
+        return (1);
+    }
+    if((Board_Status_statistics.lcdWrites != lcdWrites)
+       || (Board_Status_statistics.ledWrites != ledWrites))
+    {
+        printf("FAIL: statistics differ from the writes\n");
+        return (1);
+    }
+    memset(&Board_Status_statistics, 0, sizeof(Board_Status_statistics));
+#else
+    if((lcdWrites != MESSAGES) || (ledWrites != MESSAGES))
+    {
+        printf("FAIL: direct build skipped writes\n");
+        return (1);
+    }
+#endif
+
+    return (0);
+}
+
+/******************************************************************************
+ Public Functions
+ *****************************************************************************/
+
+/*!
+ Construct the refresh clock, fired by the test
+ */
+Clock_Handle Timer_construct(Clock_Struct *pClock, Clock_FuncPtr clockCB,
+                             uint32_t clockDuration, uint32_t clockPeriod,
+                             uint8_t startFlag, UArg arg)
+{
+    (void)clockDuration;
+    (void)startFlag;
+
+    pClock->fxn = clockCB;
+    pClock->period = clockPeriod;
+    pClock->arg = arg;
+    pRefreshClock = pClock;
+    return (pClock);
+}
+
+/*!
+ Write a string to the LCD, counted
+ */
+void Board_Lcd_writeString(char *str, uint8_t line)
+{
+    lcdWrites++;
+    lcd[line].str = str;
+    lcd[line].value = 0;
+    lcd[line].painted = true;
+}
+
+/*!
+ Write a string with a value to the LCD, counted
+ */
+void Board_Lcd_writeStringValue(char *str, uint16_t value, uint8_t format,
+                                uint8_t line)
+{
+    (void)format;
+
+    lcdWrites++;
+    lcd[line].str = str;
+    lcd[line].value = value;
+    lcd[line].painted = true;
+}
+
+/*!
+ Set an LED, counted
+ */
+void Board_Led_control(board_led_type led, board_led_state state)
+{
+    (void)led;
+    (void)state;
+    ledWrites++;
+}
+
+/*!
+ Toggle an LED, counted
+ */
+void Board_Led_toggle(board_led_type led)
+{
+    (void)led;
+    ledWrites++;
+}
+
+int main(void)
+{
+    static const unsigned int rates[] = { 50, 200, 1000 };
+    unsigned int r;
+
+    Board_Status_init(statusNotify);
+
+    for(r = 0; r < sizeof(rates) / sizeof(rates[0]); r++)
+    {
+        if(runTrace(rates[r]))
+        {
+            return (1);
+        }
+    }
+
+    return (0);
+}
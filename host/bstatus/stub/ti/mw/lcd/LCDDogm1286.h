@@ -0,0 +1,14 @@
+/******************************************************************************
+
+ @file LCDDogm1286.h
+
+ @brief Host stand-in, the LCD writes of board_lcd.h are counted by
+        bstatus_test.c.
+
+ *****************************************************************************/
+#ifndef ti_mw_lcd_LCDDogm1286__include
+#define ti_mw_lcd_LCDDogm1286__include
+
+#include <stdint.h>
+
+#endif /* ti_mw_lcd_LCDDogm1286__include */
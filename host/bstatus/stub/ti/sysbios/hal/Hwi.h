@@ -0,0 +1,24 @@
+/******************************************************************************
+
+ @file Hwi.h
+
+ @brief Host stand-in for the SYS/BIOS interrupt lock, the host test has
+        one thread.
+
+ *****************************************************************************/
+#ifndef ti_sysbios_hal_Hwi__include
+#define ti_sysbios_hal_Hwi__include
+
+#include <xdc/std.h>
+
+static inline UInt Hwi_disable(void)
+{
+    return (0);
+}
+
+static inline void Hwi_restore(UInt key)
+{
+    (void)key;
+}
+
+#endif /* ti_sysbios_hal_Hwi__include */
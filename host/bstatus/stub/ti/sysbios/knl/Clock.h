@@ -0,0 +1,25 @@
+/******************************************************************************
+
+ @file Clock.h
+
+ @brief Host stand-in for the SYS/BIOS clock types of timer.h, the refresh
+        clock is fired by bstatus_test.c.
+
+ *****************************************************************************/
+#ifndef ti_sysbios_knl_Clock__include
+#define ti_sysbios_knl_Clock__include
+
+#include <xdc/std.h>
+
+typedef void (*Clock_FuncPtr)(UArg arg);
+
+typedef struct
+{
+    Clock_FuncPtr fxn;
+    uint32_t period;
+    UArg arg;
+} Clock_Struct;
+
+typedef Clock_Struct *Clock_Handle;
+
+#endif /* ti_sysbios_knl_Clock__include */
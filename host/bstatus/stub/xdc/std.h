@@ -0,0 +1,19 @@
+/******************************************************************************
+
+ @file std.h
+
+ @brief Host stand-in for the XDC types used by board_status.c.
+
+ *****************************************************************************/
+#ifndef xdc_std__include
+#define xdc_std__include
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef void Void;
+typedef unsigned int UInt;
+typedef uintptr_t UArg;
+
+#endif /* xdc_std__include */
@@ -0,0 +1,176 @@
+/******************************************************************************
+
+ @file crc16_test.c
+
+ @brief Host test of the CRC-16 engine: the engine built with CRC16_ENGINE
+        must give the same register as the original bit-by-bit loop of
+        slow_crc16() on random buffers and start values. Also times the
+        engine over a stack image sized buffer.
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "crc16.h"
+
+/******************************************************************************
+ Constants and definitions
+ *****************************************************************************/
+
+/*! Random buffers checked */
+#define TEST_ITERATIONS         5000
+
+/*! Longest random buffer */
+#define TEST_MAX_LEN            4096
+
+/*! Size of the benchmark buffer, about a stack image */
+#define BENCH_LEN               (128 * 1024)
+
+/*! Benchmark passes */
+#define BENCH_PASSES            50
+
+/******************************************************************************
+ Local Functions
+ *****************************************************************************/
+
+/*!
+ * @brief       The original slow_crc16() loop of icall_startup.c.
+ *
+ * @param       crc - CRC register
+ * @param       pData - data
+ * @param       len - length of the data
+ *
+ * @return      updated CRC register
+ */
+static uint16_t slowCrc16(uint16_t crc, const uint8_t *pData, uint32_t len)
+{
+    while(len--)
+    {
+        uint8_t byte = *pData++;
+        uint8_t i;
+
+        for(i = 0; i < 8; i++)
+        {
+            uint32_t temp = crc;
+
+            crc <<= 1;
+            if(byte & 0x80)
+            {
+                crc |= 1;
+            }
+            if(temp & 0x8000)
+            {
+                crc ^= CRC16_POLYNOMIAL;
+            }
+            byte <<= 1;
+        }
+    }
+
+    return (crc);
+}
+
+/*!
+ * @brief       Read a monotonic clock.
+ *
+ * @return      time, in nanoseconds
+ */
+static uint64_t readNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (((uint64_t)ts.tv_sec * 1000000000u) + (uint64_t)ts.tv_nsec);
+}
+
+/******************************************************************************
+ Public Functions
+ *****************************************************************************/
+
+int main(void)
+{
+    static uint8_t buf[BENCH_LEN];
+    static const uint8_t zeros[CRC16_FINAL_ZEROS] = { 0 };
+    volatile uint16_t sink = 0;
+    uint64_t start;
+    uint64_t fastNs;
+    uint64_t slowNs;
+    int it;
+    int i;
+
+    srand(1);
+
+    for(it = 0; it < TEST_ITERATIONS; it++)
+    {
+        uint32_t len = (uint32_t)(rand() % TEST_MAX_LEN);
+        uint32_t split = (len > 0) ? ((uint32_t)rand() % len) : 0;
+        uint16_t seed = (uint16_t)rand();
+        uint16_t crc;
+
+        for(i = 0; i < (int)len; i++)
+        {
+            buf[i] = (uint8_t)rand();
+        }
+
+        /* Any start value, and chained over two pieces */
+        crc = CRC16_update(seed, buf, split);
+        crc = CRC16_update(crc, &buf[split], len - split);
+        if(crc != slowCrc16(seed, buf, len))
+        {
+            printf("FAIL: update, len %u seed 0x%04x\n", len, seed);
+            return (1);
+        }
+
+        if(CRC16_finalize(crc) != slowCrc16(crc, zeros, sizeof(zeros)))
+        {
+            printf("FAIL: finalize, len %u\n", len);
+            return (1);
+        }
+
+        if(CRC16_calc(buf, len)
+           != slowCrc16(slowCrc16(0, buf, len), zeros, sizeof(zeros)))
+        {
+            printf("FAIL: calc, len %u\n", len);
+            return (1);
+        }
+    }
+
+    for(i = 0; i < BENCH_LEN; i++)
+    {
+        buf[i] = (uint8_t)rand();
+    }
+
+    start = readNs();
+    for(it = 0; it < BENCH_PASSES; it++)
+    {
+        sink ^= CRC16_calc(buf, BENCH_LEN);
+    }
+    fastNs = readNs() - start;
+
+    start = readNs();
+    for(it = 0; it < BENCH_PASSES; it++)
+    {
+        sink ^= slowCrc16(0, buf, BENCH_LEN);
+    }
+    slowNs = readNs() - start;
+
+    printf("crc16 engine %d: %d buffers bit-exact, %.3f ns/byte "
+           "(bit-by-bit %.3f ns/byte, %.1fx)\n",
+           CRC16_ENGINE, TEST_ITERATIONS,
+           (double)fastNs / ((double)BENCH_LEN * BENCH_PASSES),
+           (double)slowNs / ((double)BENCH_LEN * BENCH_PASSES),
+           (double)slowNs / (double)(fastNs ? fastNs : 1));
+
+    (void)sink;
+
+    return (0);
+}
@@ -0,0 +1,735 @@
+/******************************************************************************
+
+ @file defq_sim.c
+
+ @brief Host test of the collector deferred work queue, defq.c, and a model
+        of the receive path latency with and without it.
+
+        The worker task of defq.c runs as a coroutine on a simulated clock.
+        The queue checks fill it, post to a full queue, coalesce into it,
+        post too much data, and repost from a running item.
+
+        The model runs the sensor data and frame counter work of csf.c,
+        inline in the MAC data callback or posted to the queue, under
+        Poisson frame arrivals from 100 devices and a MAC receive queue of
+        MAC_CFG_RX_MAX frames. Every 60th NV write compacts a page, with a
+        flash stall that nothing can preempt. It reports the callback
+        latency, from the frame arrival to the callback return, the frames
+        the MAC dropped and the work the full queue refused.
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <ucontext.h>
+
+#include "defq.h"
+#include <ti/sysbios/knl/Task.h>
+#include <ti/sysbios/knl/Semaphore.h>
+
+/******************************************************************************
+ Constants and definitions
+ *****************************************************************************/
+
+/*! Frames the MAC holds for the application, MAC_CFG_RX_MAX */
+#define RX_MAX                  2
+
+/*! Devices sending frames */
+#define DEVICES                 100
+
+/*! Simulated time of each run, in us */
+#define SIM_US                  (600ull * 1000000ull)
+
+/*! Costs of the work, in us */
+#define COST_FAST_PATH          250
+#define COST_POST               10
+#define COST_LCD                2000
+#define COST_NV_LOOKUP          500
+#define COST_NV_WRITE           200
+#define COST_PAGE_COPY          1000
+#define COST_PAGE_ERASE         20000
+
+/*! NV writes between page compactions, and the copies of one */
+#define COMPACT_EVERY           60
+#define COMPACT_COPIES          30
+
+/*! Stack of the worker coroutine */
+#define WORKER_STACK_SIZE       (64 * 1024)
+
+/*! A received frame */
+typedef struct
+{
+    uint64_t arrival;
+    uint16_t device;
+} frame_t;
+
+/*! Results of a run of the model */
+typedef struct
+{
+    unsigned long frames;
+    unsigned long dropped;
+    unsigned long refused;
+    double p50;
+    double p99;
+    double p999;
+    double max;
+} runResult_t;
+
+/******************************************************************************
+ Local Variables
+ *****************************************************************************/
+
+/*! Simulated time, in us */
+static uint64_t simNow;
+
+/*! Time of the next frame, UINT64_MAX when there are no more */
+static uint64_t nextArrival;
+
+/*! Mean gap between frames, in us */
+static double meanGap;
+
+/*! Frames held by the MAC */
+static frame_t rxQueue[RX_MAX];
+static unsigned int rxHead;
+static unsigned int rxCount;
+
+/*! Frames that arrived and that the MAC dropped */
+static unsigned long arrivals;
+static unsigned long rxDropped;
+
+/*! NV writes, for the compactions */
+static unsigned long nvWrites;
+
+/*! Noise of the model, the same on every run */
+static uint32_t randState = 1;
+
+/*! Worker task coroutine and the simulation it switches back to */
+static ucontext_t schedCtx;
+static ucontext_t workerCtx;
+static char workerStack[WORKER_STACK_SIZE];
+static Task_FuncPtr workerFxn;
+
+/*! Worker state */
+static bool workerStarted;
+static bool workerPended;
+static bool workerPreempted;
+static bool inWorker;
+
+/*! Semaphore of the worker */
+static Semaphore_Handle workerSem;
+
+/*! Work functions run by the queue checks, in order */
+static uint16_t checkRuns[16];
+static uint8_t checkData[16];
+static unsigned int checkRunCount;
+
+/*! Reposts left for repostWork() */
+static unsigned int reposts;
+
+/******************************************************************************
+ Local Functions
+ *****************************************************************************/
+
+/*!
+ * @brief       Pseudo random number between 0 and 1, 0 excluded.
+ *
+ * @return      the number
+ */
+static double randomUnit(void)
+{
+    randState = randState * 1103515245 + 12345;
+
+    return (((randState >> 8) + 1) / 16777217.0);
+}
+
+/*!
+ * @brief       Draw the time of the next frame.
+ */
+static void drawArrival(void)
+{
+    nextArrival += (uint64_t)(-meanGap * log(randomUnit())) + 1;
+}
+
+/*!
+ * @brief       Advance the simulated time, the MAC receiving frames.
+ *
+ * @param       until - time to advance to
+ */
+static void advanceTo(uint64_t until)
+{
+    while(nextArrival <= until)
+    {
+        arrivals++;
+        if(rxCount < RX_MAX)
+        {
+            frame_t *pFrame = &rxQueue[(rxHead + rxCount) % RX_MAX];
+
+            pFrame->arrival = nextArrival;
+            pFrame->device = (uint16_t)(randomUnit() * DEVICES);
+            rxCount++;
+        }
+        else
+        {
+            rxDropped++;
+        }
+        drawArrival();
+    }
+    simNow = until;
+}
+
+/*!
+ * @brief       Spend CPU time. Work of the worker task that can be preempted
+ *              gives the CPU to the application task as soon as a frame
+ *              is waiting.
+ *
+ * @param       us - time
+ * @param       preemptible - true if the application task can run meanwhile
+ */
+static void busy(uint64_t us, bool preemptible)
+{
+    uint64_t left = us;
+
+    if(!inWorker || !preemptible)
+    {
+        advanceTo(simNow + us);
+        return;
+    }
+
+    while(1)
+    {
+        uint64_t step;
+
+        if(rxCount > 0)
+        {
+            workerPreempted = true;
+            inWorker = false;
+            swapcontext(&workerCtx, &schedCtx);
+        }
+
+        if(left == 0)
+        {
+            break;
+        }
+
+        step = (nextArrival - simNow < left) ? (nextArrival - simNow) : left;
+        advanceTo(simNow + step);
+        left -= step;
+    }
+}
+
+/*!
+ * @brief       Write an NV item, compacting the page every COMPACT_EVERY
+ *              writes. The copies can be preempted between each other, the
+ *              erase stalls the flash for every task.
+ *
+ * @param       preemptible - true in the worker task
+ */
+static void nvWrite(bool preemptible)
+{
+    busy(COST_NV_WRITE, false);
+
+    if((++nvWrites % COMPACT_EVERY) == 0)
+    {
+        int i;
+
+        for(i = 0; i < COMPACT_COPIES; i++)
+        {
+            busy(COST_PAGE_COPY, false);
+            busy(0, preemptible);
+        }
+        busy(COST_PAGE_ERASE, false);
+    }
+}
+
+/*!
+ * @brief       Fill a sensor report with a pattern of its device.
+ *
+ * @param       pData - report, DEFQ_MAX_DATA_LEN bytes
+ * @param       device - device
+ */
+static void fillReport(uint8_t *pData, uint16_t device)
+{
+    int i;
+
+    for(i = 0; i < DEFQ_MAX_DATA_LEN; i++)
+    {
+        pData[i] = (uint8_t)(device + i);
+    }
+}
+
+/*!
+ * @brief       Sensor data work of csf.c: LED, LCD line and MT indication.
+ *
+ * @param       pData - report copied by the queue
+ */
+static void sensorWork(void *pData)
+{
+    uint8_t *pReport = (uint8_t *)pData;
+    int i;
+
+    for(i = 1; i < DEFQ_MAX_DATA_LEN; i++)
+    {
+        if(pReport[i] != (uint8_t)(pReport[0] + i))
+        {
+            printf("FAIL: sensor report corrupted in the queue\n");
+            exit(1);
+        }
+    }
+    busy(COST_LCD, true);
+}
+
+/*!
+ * @brief       Frame counter work of csf.c: device list lookup and NV write.
+ *
+ * @param       pData - frame counter
+ */
+static void frameCounterWork(void *pData)
+{
+    (void)pData;
+    busy(COST_NV_LOOKUP, true);
+    nvWrite(true);
+}
+
+/*!
+ * @brief       MAC data callback of the collector.
+ *
+ * @param       pFrame - frame
+ * @param       deferred - true to post the work, false to do it inline
+ * @param       pRefused - work the full queue refused, counted
+ */
+static void dataIndCb(const frame_t *pFrame, bool deferred,
+                      unsigned long *pRefused)
+{
+    uint8_t report[DEFQ_MAX_DATA_LEN];
+    uint32_t frameCounter = (uint32_t)arrivals;
+
+    busy(COST_FAST_PATH, false);
+
+    if(!deferred)
+    {
+        busy(COST_LCD, false);
+        busy(COST_NV_LOOKUP, false);
+        nvWrite(false);
+        return;
+    }
+
+    fillReport(report, pFrame->device);
+    busy(2 * COST_POST, false);
+
+    /* Without MT_CSF both coalesce per device, csf.c drops refused work */
+    if(!Defq_post(sensorWork, pFrame->device, true, sizeof(report), report))
+    {
+        (*pRefused)++;
+    }
+    if(!Defq_post(frameCounterWork, pFrame->device, true,
+                  sizeof(frameCounter), &frameCounter))
+    {
+        (*pRefused)++;
+    }
+}
+
+/*!
+ * @brief       Coroutine entry of the worker task.
+ */
+static void workerEntry(void)
+{
+    workerFxn(0, 0);
+}
+
+/*!
+ * @brief       Check whether the worker task can run.
+ *
+ * @return      true if it is preempted, not started, or its semaphore was
+ *              posted
+ */
+static bool workerReady(void)
+{
+    return (workerPreempted || !workerStarted
+            || (workerPended && (workerSem->count > 0)));
+}
+
+/*!
+ * @brief       Run the worker task until it waits or is preempted.
+ */
+static void runWorker(void)
+{
+    workerStarted = true;
+    workerPended = false;
+    workerPreempted = false;
+    inWorker = true;
+    swapcontext(&schedCtx, &workerCtx);
+    inWorker = false;
+}
+
+/*!
+ * @brief       Compare latencies, for qsort().
+ */
+static int compareLatency(const void *pA, const void *pB)
+{
+    uint32_t a = *(const uint32_t *)pA;
+    uint32_t b = *(const uint32_t *)pB;
+
+    return ((a > b) - (a < b));
+}
+
+/*!
+ * @brief       Run the model for a mean gap between frames.
+ *
+ * @param       gapMs - mean gap, in ms
+ * @param       deferred - true to post the work to the queue
+ * @param       pResult - results, out
+ *
+ * @return      0 on success, 1 on a failure
+ */
+static int runModel(double gapMs, bool deferred, runResult_t *pResult)
+{
+    size_t maxFrames = (size_t)(SIM_US / (gapMs * 1000.0)) * 2 + 1000;
+    uint32_t *pLatency = malloc(maxFrames * sizeof(uint32_t));
+    unsigned long frames = 0;
+
+    memset(pResult, 0, sizeof(*pResult));
+    simNow = 0;
+    meanGap = gapMs * 1000.0;
+    nextArrival = 0;
+    drawArrival();
+    rxHead = rxCount = 0;
+    arrivals = rxDropped = nvWrites = 0;
+    Defq_init();
+
+    while(simNow < SIM_US)
+    {
+        if(rxCount > 0)
+        {
+            frame_t frame = rxQueue[rxHead];
+
+            rxHead = (rxHead + 1) % RX_MAX;
+            rxCount--;
+            dataIndCb(&frame, deferred, &pResult->refused);
+            if(frames < maxFrames)
+            {
+                pLatency[frames++] = (uint32_t)(simNow - frame.arrival);
+            }
+        }
+        else if(workerReady())
+        {
+            runWorker();
+        }
+        else
+        {
+            advanceTo(nextArrival);
+        }
+    }
+
+    /* No more frames, let the worker finish */
+    nextArrival = UINT64_MAX;
+    while(workerReady())
+    {
+        runWorker();
+    }
+
+    if(Defq_statistics.serviced
+       != (Defq_statistics.posted - Defq_statistics.coalesced))
+    {
+        printf("FAIL: %u posted, %u coalesced, %u run\n",
+               Defq_statistics.posted, Defq_statistics.coalesced,
+               Defq_statistics.serviced);
+        free(pLatency);
+        return (1);
+    }
+
+    qsort(pLatency, frames, sizeof(uint32_t), compareLatency);
+    pResult->frames = arrivals;
+    pResult->dropped = rxDropped;
+    pResult->p50 = pLatency[frames / 2] / 1000.0;
+    pResult->p99 = pLatency[(frames * 99) / 100] / 1000.0;
+    pResult->p999 = pLatency[(frames * 999) / 1000] / 1000.0;
+    pResult->max = pLatency[frames - 1] / 1000.0;
+    free(pLatency);
+    return (0);
+}
+
+/*!
+ * @brief       Work of the queue checks, records its key and first byte.
+ *
+ * @param       pData - data copied by the queue
+ */
+static void checkWork(void *pData)
+{
+    uint8_t *pBytes = (uint8_t *)pData;
+
+    checkRuns[checkRunCount] = pBytes[0];
+    checkData[checkRunCount] = pBytes[DEFQ_MAX_DATA_LEN - 1];
+    checkRunCount++;
+}
+
+/*!
+ * @brief       Work of the queue checks that posts itself again while it
+ *              runs.
+ *
+ * @param       pData - data copied by the queue
+ */
+static void repostWork(void *pData)
+{
+    checkWork(pData);
+
+    if(reposts > 0)
+    {
+        reposts--;
+        if(!Defq_post(repostWork, 7, true, DEFQ_MAX_DATA_LEN, pData))
+        {
+            printf("FAIL: repost from running work refused\n");
+            exit(1);
+        }
+    }
+}
+
+/*!
+ * @brief       Post check work with a key, its data all the key.
+ *
+ * @param       pWorkFp - work function
+ * @param       key - key, also the data
+ * @param       coalesce - coalesce with waiting work
+ * @param       last - last data byte
+ *
+ * @return      the result of Defq_post()
+ */
+static bool postCheck(Defq_workFp_t pWorkFp, uint16_t key, bool coalesce,
+                      uint8_t last)
+{
+    uint8_t data[DEFQ_MAX_DATA_LEN];
+
+    memset(data, (uint8_t)key, sizeof(data));
+    data[DEFQ_MAX_DATA_LEN - 1] = last;
+    return (Defq_post(pWorkFp, key, coalesce, sizeof(data), data));
+}
+
+/*!
+ * @brief       Full queue, coalescing, bad posts and reposts.
+ *
+ * @return      0 on success, 1 on a failure
+ */
+static int runQueueChecks(void)
+{
+    uint8_t big[DEFQ_MAX_DATA_LEN + 1];
+    uint16_t key;
+
+    Defq_init();
+    runWorker();
+    checkRunCount = 0;
+
+    /* Fill the queue, the next post is refused */
+    for(key = 1; key <= DEFQ_MAX_ITEMS; key++)
+    {
+        if(!postCheck(checkWork, key, false, 0))
+        {
+            printf("FAIL: post %u to a queue with room\n", key);
+            return (1);
+        }
+    }
+    if(postCheck(checkWork, DEFQ_MAX_ITEMS + 1, false, 0)
+       || postCheck(checkWork, DEFQ_MAX_ITEMS + 1, true, 0)
+       || (Defq_statistics.overflows != 2)
+       || (Defq_statistics.posted != DEFQ_MAX_ITEMS)
+       || (Defq_statistics.maxDepth != DEFQ_MAX_ITEMS))
+    {
+        printf("FAIL: full queue took a post\n");
+        return (1);
+    }
+
+    /* A full queue still takes newer data for waiting work */
+    if(!postCheck(checkWork, 2, true, 0xA5)
+       || (Defq_statistics.coalesced != 1))
+    {
+        printf("FAIL: full queue refused to coalesce\n");
+        return (1);
+    }
+
+    /* Bad posts are refused without counting an overflow */
+    memset(big, 0, sizeof(big));
+    if(Defq_post(checkWork, 9, false, sizeof(big), big)
+       || Defq_post(NULL, 9, false, 0, NULL)
+       || (Defq_statistics.overflows != 2))
+    {
+        printf("FAIL: bad post taken\n");
+        return (1);
+    }
+
+    /* Oldest first, the coalesced data in its place */
+    if(!workerReady())
+    {
+        printf("FAIL: worker not posted\n");
+        return (1);
+    }
+    runWorker();
+    for(key = 1; key <= DEFQ_MAX_ITEMS; key++)
+    {
+        if((checkRunCount != DEFQ_MAX_ITEMS) || (checkRuns[key - 1] != key)
+           || (checkData[key - 1] != ((key == 2) ? 0xA5 : 0)))
+        {
+            printf("FAIL: work %u ran out of order or with old data\n", key);
+            return (1);
+        }
+    }
+
+    /* Room again once the worker ran */
+    if(!postCheck(checkWork, DEFQ_MAX_ITEMS + 1, false, 0x5A))
+    {
+        printf("FAIL: post refused after the queue drained\n");
+        return (1);
+    }
+
+    /* Running work is out of the queue, a repost is new work */
+    reposts = 2;
+    if(!postCheck(repostWork, 7, true, 0x77))
+    {
+        printf("FAIL: post of the repost work\n");
+        return (1);
+    }
+    runWorker();
+    if((checkRunCount != DEFQ_MAX_ITEMS + 4) || (checkRuns[4] != 5)
+       || (checkData[4] != 0x5A) || (checkRuns[5] != 7) || (checkRuns[7] != 7)
+       || (checkData[7] != 0x77) || workerReady()
+       || (Defq_statistics.serviced
+           != (Defq_statistics.posted - Defq_statistics.coalesced)))
+    {
+        printf("FAIL: reposts from running work\n");
+        return (1);
+    }
+
+    printf("queue: %u items of %u bytes, full queue refuses new work and "
+           "coalesces\n", DEFQ_MAX_ITEMS, DEFQ_MAX_DATA_LEN);
+    return (0);
+}
+
+/******************************************************************************
+ Public Functions
+ *****************************************************************************/
+
+/*!
+ Task parameters
+ */
+void Task_Params_init(Task_Params *pParams)
+{
+    memset(pParams, 0, sizeof(*pParams));
+}
+
+/*!
+ Start the worker task coroutine, it runs at the next runWorker()
+ */
+void Task_construct(Task_Struct *pTask, Task_FuncPtr fxn,
+                    Task_Params *pParams, void *pError)
+{
+    (void)pParams;
+    (void)pError;
+
+    pTask->fxn = fxn;
+    workerFxn = fxn;
+    getcontext(&workerCtx);
+    workerCtx.uc_stack.ss_sp = workerStack;
+    workerCtx.uc_stack.ss_size = sizeof(workerStack);
+    workerCtx.uc_link = &schedCtx;
+    makecontext(&workerCtx, workerEntry, 0);
+    workerStarted = false;
+    workerPended = false;
+    workerPreempted = false;
+}
+
+/*!
+ Semaphore parameters
+ */
+void Semaphore_Params_init(Semaphore_Params *pParams)
+{
+    pParams->mode = Semaphore_Mode_COUNTING;
+}
+
+/*!
+ Construct the worker semaphore
+ */
+void Semaphore_construct(Semaphore_Struct *pSem, Int count,
+                         Semaphore_Params *pParams)
+{
+    pSem->mode = pParams->mode;
+    pSem->count = (UInt)count;
+    workerSem = pSem;
+}
+
+/*!
+ Pend on a semaphore, from the worker task: switch back to the simulation
+ until it is posted
+ */
+Bool Semaphore_pend(Semaphore_Handle handle, UInt timeout)
+{
+    (void)timeout;
+
+    if(handle->count == 0)
+    {
+        workerPended = true;
+        inWorker = false;
+        swapcontext(&workerCtx, &schedCtx);
+    }
+    handle->count--;
+    return (TRUE);
+}
+
+/*!
+ Post a semaphore
+ */
+void Semaphore_post(Semaphore_Handle handle)
+{
+    if((handle->mode == Semaphore_Mode_COUNTING) || (handle->count == 0))
+    {
+        handle->count++;
+    }
+}
+
+int main(void)
+{
+    static const double gaps[] = { 20.0, 10.0, 5.0 };
+    unsigned int g;
+
+    if(runQueueChecks())
+    {
+        return (1);
+    }
+
+    printf("mean gap  path      dropped  refused  p50      p99      "
+           "p99.9     max\n");
+
+    for(g = 0; g < sizeof(gaps) / sizeof(gaps[0]); g++)
+    {
+        runResult_t results[2];
+        int d;
+
+        for(d = 0; d < 2; d++)
+        {
+            if(runModel(gaps[g], (d == 1), &results[d]))
+            {
+                return (1);
+            }
+            printf("%5.0f ms  %-8s %6.2f%%  %7lu  %5.2f ms  %5.2f ms  "
+                   "%6.2f ms  %5.1f ms\n", gaps[g],
+                   (d == 1) ? "deferred" : "inline",
+                   100.0 * results[d].dropped / results[d].frames,
+                   results[d].refused, results[d].p50, results[d].p99,
+                   results[d].p999, results[d].max);
+        }
+
+        if((results[1].p99 >= results[0].p99)
+           || (results[1].dropped >= results[0].dropped))
+        {
+            printf("FAIL: deferred work no better at a %.0f ms gap\n",
+                   gaps[g]);
+            return (1);
+        }
+    }
+
+    return (0);
+}
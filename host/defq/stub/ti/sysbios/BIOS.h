@@ -0,0 +1,16 @@
+/******************************************************************************
+
+ @file BIOS.h
+
+ @brief Host stand-in for the SYS/BIOS timeouts.
+
+ *****************************************************************************/
+#ifndef ti_sysbios_BIOS__include
+#define ti_sysbios_BIOS__include
+
+#include <xdc/std.h>
+
+#define BIOS_WAIT_FOREVER       (~(UInt)0)
+#define BIOS_NO_WAIT            0
+
+#endif /* ti_sysbios_BIOS__include */
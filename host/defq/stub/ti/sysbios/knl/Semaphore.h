@@ -0,0 +1,41 @@
+/******************************************************************************
+
+ @file Semaphore.h
+
+ @brief Host stand-in for the SYS/BIOS semaphores, simulated by defq_sim.c.
+        A pend that would block switches back to the simulation.
+
+ *****************************************************************************/
+#ifndef ti_sysbios_knl_Semaphore__include
+#define ti_sysbios_knl_Semaphore__include
+
+#include <xdc/std.h>
+
+typedef enum
+{
+    Semaphore_Mode_COUNTING,
+    Semaphore_Mode_BINARY
+} Semaphore_Mode;
+
+typedef struct
+{
+    Semaphore_Mode mode;
+} Semaphore_Params;
+
+typedef struct
+{
+    Semaphore_Mode mode;
+    UInt count;
+} Semaphore_Struct;
+
+typedef Semaphore_Struct *Semaphore_Handle;
+
+extern void Semaphore_Params_init(Semaphore_Params *pParams);
+extern void Semaphore_construct(Semaphore_Struct *pSem, Int count,
+                                Semaphore_Params *pParams);
+extern Bool Semaphore_pend(Semaphore_Handle handle, UInt timeout);
+extern void Semaphore_post(Semaphore_Handle handle);
+
+#define Semaphore_handle(pSem)  (pSem)
+
+#endif /* ti_sysbios_knl_Semaphore__include */
@@ -0,0 +1,43 @@
+/******************************************************************************
+
+ @file Task.h
+
+ @brief Host stand-in for the SYS/BIOS tasks: the worker task of defq.c
+        runs as a coroutine of defq_sim.c, which only switches tasks where
+        the simulated work allows it, so Task_disable() has nothing to do.
+
+ *****************************************************************************/
+#ifndef ti_sysbios_knl_Task__include
+#define ti_sysbios_knl_Task__include
+
+#include <xdc/std.h>
+
+typedef void (*Task_FuncPtr)(UArg arg0, UArg arg1);
+
+typedef struct
+{
+    void *stack;
+    size_t stackSize;
+    Int priority;
+} Task_Params;
+
+typedef struct
+{
+    Task_FuncPtr fxn;
+} Task_Struct;
+
+extern void Task_Params_init(Task_Params *pParams);
+extern void Task_construct(Task_Struct *pTask, Task_FuncPtr fxn,
+                           Task_Params *pParams, void *pError);
+
+static inline UInt Task_disable(void)
+{
+    return (0);
+}
+
+static inline void Task_restore(UInt key)
+{
+    (void)key;
+}
+
+#endif /* ti_sysbios_knl_Task__include */
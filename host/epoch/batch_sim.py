@@ -0,0 +1,103 @@
+"""
+Model of the channel use of the sensor reports: one Sensor Data message
+per reading, against a Sensor Batch message of CONFIG_BATCH_SAMPLES
+readings with the statistics in one message of CONFIG_BATCH_STATS_INTERVAL,
+at 50 and 500 sensors.
+
+Every sensor reads its sensors at the reporting interval and sends through
+unslotted CSMA-CA, on the 50 kbps 2-FSK PHY with secured frames. A frame
+and its ACK are delivered when nothing else is on the air in the meantime,
+there are no MAC retries. The channel is busy while any frame or ACK is on
+the air.
+
+This is a model of the sensor traffic, it doesn't build the sensor code.
+Run with:
+
+    make -C host sim
+"""
+import heapq, random
+BYTE_MS = 8 / 50.0  # 50 kbps
+PHY = 8             # preamble 4, SFD 2, PHR 2
+MAC = 9 + 4 + 6 + 4 # MHR with short addresses, FCS, aux security header, MIC-32
+ACK_MS = (PHY + 3 + 4) * BYTE_MS
+TURN_MS = 1.0       # aTurnaroundTime, CCA to TX and TX to ACK
+UBP_MS = 1.0 + 0.16 # unit backoff period: turnaround and CCA
+MIN_BE = 3          # macMinBE
+MAX_BE = 5          # macMaxBE
+MAX_NB = 4          # macMaxCSMABackoffs
+FIELDS = 4 + 2 + 4  # SMSGS_SENSOR_TEMP_LEN, _LIGHT_LEN, _HUMIDITY_LEN
+STATS = 36 + 8      # SMSGS_SENSOR_MSG_STATS_LEN, _CONFIG_SETTINGS_LEN
+DATA_HDR = 1 + 8 + 2    # command ID, extended address, frame control
+BATCH_HDR = 4           # SMSGS_BASIC_SENSOR_BATCH_LEN
+INTERVAL = 2            # SMSGS_SENSOR_BATCH_INTERVAL_LEN
+STATS_EVERY = 4         # CONFIG_BATCH_STATS_INTERVAL
+SECS = 120
+
+def payload(k, frame):
+    """Sensor Data message of k = 1, else Sensor Batch message of k samples."""
+    if k == 1:
+        return DATA_HDR + FIELDS + STATS
+    return (BATCH_HDR + INTERVAL * (k - 1) + k * FIELDS
+            + (STATS if frame % STATS_EVERY == 0 else 0))
+
+def run(nodes, period_ms, k, rnd):
+    frame_ms = period_ms * k
+    end = SECS * 1000.0
+    ev = []                             # (time, node, NB, BE) of a CCA
+    frames = [0] * nodes
+    phase = [rnd.uniform(0, frame_ms) for _ in range(nodes)]
+    for n in range(nodes):
+        heapq.heappush(ev, (phase[n] + rnd.randrange(1 << MIN_BE) * UBP_MS, n, 0, MIN_BE))
+    air = []                            # (start, end) of each frame and its ACK
+    active = []
+    ccas = failures = tx_ms = 0
+    while ev:
+        t, n, nb, be = heapq.heappop(ev)
+        if t > end:
+            break
+        ccas += 1
+        active = [a for a in active if a[1] > t]
+        if any(a[0] <= t for a in active):
+            if nb < MAX_NB:
+                be = min(be + 1, MAX_BE)
+                heapq.heappush(ev, (t + rnd.randrange(1 << be) * UBP_MS, n, nb + 1, be))
+                continue
+            failures += 1               # channel access failure, frame dropped
+        else:
+            dur = (PHY + MAC + payload(k, frames[n])) * BYTE_MS
+            start = t + TURN_MS
+            active.append((start, start + dur + TURN_MS + ACK_MS))
+            air.append(active[-1])
+            tx_ms += dur
+        frames[n] += 1                  # next frame, 5 % clock jitter
+        t = max(t, phase[n] + frames[n] * frame_ms * rnd.uniform(0.95, 1.05))
+        heapq.heappush(ev, (t + rnd.randrange(1 << MIN_BE) * UBP_MS, n, 0, MIN_BE))
+    return air, ccas, failures, tx_ms, sum(frames)
+
+def channel(air, end):
+    """Offered and busy time, and the frames nothing else overlapped."""
+    air.sort()
+    offered = sum(e - s for s, e in air)
+    busy = 0.0; ok = 0; reach = -1.0
+    for i, (s, e) in enumerate(air):
+        busy += max(0.0, e - max(s, reach))
+        clear = s >= reach and (i + 1 == len(air) or air[i + 1][0] >= e)
+        ok += 1 if clear else 0
+        reach = max(reach, e)
+    return offered / end, busy / end, ok
+
+print("50 kbps 2-FSK, secured frames, unslotted CSMA-CA, no retries, %d s; "
+      "statistics in 1 of %d batches" % (SECS, STATS_EVERY))
+print("%-6s %-7s %-3s %-6s %-9s %-9s %-9s %-8s %-8s %s" % ("nodes", "period", "K",
+      "B/read", "offered", "busy", "delivered", "no CCA", "CCA/read", "tx ms/delivered"))
+for nodes in (50, 500):
+    for period in (1, 10):
+        for k in (1, 4, 8):
+            rnd = random.Random(1)
+            air, ccas, failures, tx_ms, frames = run(nodes, period * 1000.0, k, rnd)
+            offered, busy, ok = channel(air, SECS * 1000.0)
+            size = PHY + MAC + sum(payload(k, f) for f in range(STATS_EVERY)) / STATS_EVERY
+            print("%-6d %4d s  %-3d %5.1f %7.1f %% %7.1f %% %7.1f %% %6.1f %% %7.2f %9.2f" % (
+                nodes, period, k, size / k, 100 * offered, 100 * busy,
+                100 * ok / frames, 100 * failures / frames,
+                ccas / (frames * k), tx_ms / max(ok * k, 1)))
@@ -0,0 +1,98 @@
+"""
+Model of how long a configuration change takes to reach every device:
+one Config Request at a time from generateConfigRequests(), against the
+config epoch of Collector_setConfig() with its broadcasts, the epoch held
+in the pending message store for sleepy devices and the epoch resent to
+devices that report an older one.
+
+This is a model of the collector traffic, it doesn't build the collector
+code. Run with:
+
+    make -C host sim
+"""
+import heapq, random, statistics
+POLL = 6.0          # CONFIG_POLLING_INTERVAL, s
+REPORT = 90.0       # CONFIG_REPORTING_INTERVAL, s
+CFG_DELAY = 1.0     # CONFIG_DELAY
+RSP_DELAY = 3.0     # CONFIG_RESPONSE_DELAY
+BCASTS = 3          # CONFIG_EPOCH_BROADCASTS
+INDQ = 16           # INDQ_MAX_MSGS
+AIR = 0.01          # one frame + ACK, s
+LOSS = 0.05         # per attempt
+FAIL = LOSS ** 4    # acknowledged frame, after the MAC's 3 retries
+
+def next_poll(t, phase):
+    return phase + (int((t - phase) // POLL) + 1) * POLL
+
+def before(n, sleepy_frac, rnd):
+    """generateConfigRequests(): one device at a time."""
+    t = 0.0; msgs = 0
+    for _ in range(n):
+        sleepy = rnd.random() < sleepy_frac
+        phase = rnd.uniform(0, POLL)
+        while True:
+            t = (next_poll(t, phase) if sleepy else t) + AIR
+            msgs += 1
+            if rnd.random() < FAIL:
+                t += CFG_DELAY          # data confirm failure, retry
+                continue
+            msgs += 1                   # Config Response
+            if rnd.random() < FAIL:
+                t += RSP_DELAY          # no response, request again
+                continue
+            t += AIR
+            break
+    return t, msgs
+
+def after(n, sleepy_frac, rnd):
+    """Collector_setConfig(): broadcasts, then pollIndCB / checkConfigEpoch."""
+    msgs = BCASTS
+    done = {}
+    ev = []                             # (time, kind, dev)
+    sleepy = [rnd.random() < sleepy_frac for _ in range(n)]
+    stale = [True] * n
+    held = 0
+    for d in range(n):
+        if not sleepy[d] and any(rnd.random() >= LOSS for _ in range(BCASTS)):
+            done[d] = AIR
+            continue
+        heapq.heappush(ev, (rnd.uniform(0, REPORT), 'report', d))
+        if sleepy[d]:
+            heapq.heappush(ev, (rnd.uniform(0, POLL), 'poll', d))
+    pend = {}
+    while ev and len(done) < n:
+        t, kind, d = heapq.heappop(ev)
+        if d in done:
+            continue
+        if kind == 'poll':
+            heapq.heappush(ev, (t + POLL, 'poll', d))
+            if d in pend:               # released on this poll
+                held -= 1; del pend[d]; msgs += 1
+                if rnd.random() >= FAIL:
+                    done[d] = t; continue
+            if stale[d] and held < INDQ:
+                stale[d] = False; pend[d] = t; held += 1
+        else:
+            heapq.heappush(ev, (t + REPORT, 'report', d))
+            if rnd.random() < FAIL:
+                continue
+            if sleepy[d]:
+                stale[d] = True
+            else:
+                msgs += 1
+                if rnd.random() >= FAIL:
+                    done[d] = t + AIR
+    return max(done.values()), msgs
+
+def run(f, n, sf, runs=300):
+    rnd = random.Random(1)
+    r = [f(n, sf, rnd) for _ in range(runs)]
+    ts = sorted(x[0] for x in r)
+    return statistics.mean(ts), ts[int(0.95 * runs)], statistics.mean(x[1] for x in r)
+
+print("poll %gs, report %gs, %d%% loss per attempt, 300 runs; time until every device has the new config" % (POLL, REPORT, LOSS * 100))
+print("%-5s %-7s %-30s %-30s" % ("N", "sleepy", "sequential mean/p95 (frames)", "epoch mean/p95 (frames)"))
+for n in (10, 50, 200):
+    for sf in (0.0, 0.8, 1.0):
+        b = run(before, n, sf); a = run(after, n, sf)
+        print("%-5d %-7s %6.1f/%6.1f s (%5.0f)          %6.1f/%6.1f s (%5.0f)" % (n, "%d%%" % (sf * 100), b[0], b[1], b[2], a[0], a[1], a[2]))
@@ -0,0 +1,971 @@
+/******************************************************************************
+
+ @file esp_sim.c
+
+ @brief Host simulation of the MSP430 ESP8266 bridge firmware against a
+        scripted ESP8266 and ThingSpeak server.
+
+        main.c, the AT engine, the telemetry and the ring run unchanged on
+        a simulated clock: the timer tick, the UART bytes of the ESP8266 at
+        115200 baud and the collector readings are interrupts delivered
+        while the firmware sleeps in LPM3. The ESP8266 stand-in boots,
+        answers the AT commands, joins the access point, keeps the TCP
+        link until it idles and takes the bytes of AT+CIPSEND to the
+        server, which checks and stores the readings of the request.
+
+        Each run is some hours of readings, with a share of the commands
+        and HTTP responses dropped and an access point outage. Reports the
+        time from a reading to the server, the readings lost and sent
+        twice, and the time from a dropped response to the next stored
+        request. Fails when a request is malformed, a reading is neither
+        stored, queued nor counted lost, or the bridge stops uploading.
+
+        Built with THINGSPEAK_CHANNEL_ID the server takes bulk updates,
+        without it single /update requests, dropping one received less
+        than 15 s after the last as ThingSpeak does.
+
+ Group: WCS LPC
+ Target Device: MSP430G2553
+
+ *****************************************************************************/
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+#include <setjmp.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "main.h"
+
+/******************************************************************************
+ Constants and definitions
+ *****************************************************************************/
+
+/*! Simulated microseconds */
+#define MS                      1000ull
+#define SECONDS                 1000000ull
+
+/*! Time of a byte at 115200 baud, 8N1 */
+#define BYTE_US                 87
+
+/*! Time of the engine tick */
+#define TICK_US                 (AT_TICK_MS * MS)
+
+/*! Simulated run */
+#define RUN_TIME                (6 * 3600 * SECONDS)
+
+/*! A reading from the collector every... */
+#define READING_PERIOD          (20 * SECONDS)
+
+/*! Readings of a run */
+#define MAX_SEQ                 ((RUN_TIME / READING_PERIOD) + 1)
+
+/*! ESP8266 boot time, from power up or AT+RST */
+#define ESP_BOOT_TIME           (1500 * MS)
+
+/*! AT+CWJAP: connected, got IP and OK after... */
+#define ESP_JOIN_CONNECTED      (1500 * MS)
+#define ESP_JOIN_GOT_IP         (2500 * MS)
+#define ESP_JOIN_OK             (2600 * MS)
+
+/*! AT+CWJAP gives up while the access point is down after... */
+#define ESP_JOIN_FAIL           (5 * SECONDS)
+
+/*! AT+CIPSTART connects after... */
+#define ESP_CONNECT_TIME        (200 * MS)
+
+/*! "SEND OK" and the HTTP response after the last request byte */
+#define ESP_SEND_OK_TIME        (20 * MS)
+#define SERVER_RESPONSE_TIME    (300 * MS)
+
+/*! The server drops a single update less than this after the last one */
+#define SERVER_UPDATE_INTERVAL  (15 * SECONDS)
+
+/*! The server closes an idle link after... */
+#define SERVER_IDLE_CLOSE       (60 * SECONDS)
+
+/*! Access point outage of the runs that have one */
+#define OUTAGE_START            (2 * 3600 * SECONDS)
+#define OUTAGE_LENGTH           (600 * SECONDS)
+
+/*! The last request must be stored this close to the end of a run */
+#define MAX_UPLOAD_GAP          (900 * SECONDS)
+
+/*! Largest error of the relative time of a reading */
+#define MAX_TIME_SKEW           (5 * SECONDS)
+
+/*! Queue of the bytes sent by the ESP8266 */
+#define RX_QUEUE_SIZE           4096
+
+/*! Longest command line and request */
+#define MAX_COMMAND_LEN         128
+#define MAX_REQUEST_LEN         2048
+
+/*! One run */
+typedef struct
+{
+    const char *pName;
+    /*! Share of commands and HTTP responses dropped, in percent */
+    uint32_t dropPercent;
+    /*! Access point down for OUTAGE_LENGTH at OUTAGE_START */
+    uint8_t outage;
+} scenario_t;
+
+/*! A byte sent by the ESP8266 and when it's received */
+typedef struct
+{
+    uint64_t time;
+    uint8_t data;
+} rxByte_t;
+
+/*! The ESP8266 stand-in */
+typedef struct
+{
+    /*! Commands are ignored until it has booted */
+    uint64_t bootAt;
+    uint8_t echo;
+    uint8_t joined;
+    uint8_t link;
+    uint64_t linkActive;
+    char command[MAX_COMMAND_LEN];
+    uint16_t commandLen;
+    /*! Request bytes still to take after "> " */
+    uint16_t sendLeft;
+    char request[MAX_REQUEST_LEN + 1];
+    uint16_t requestLen;
+} esp_t;
+
+/*! What a run found */
+typedef struct
+{
+    uint64_t joined;
+    uint32_t produced;
+    uint32_t stored;
+    uint32_t duplicated;
+    uint32_t requests;
+    uint32_t badRequests;
+    uint32_t rateLimited;
+    uint64_t lastRequest;
+    uint64_t latencySum;
+    uint64_t latencyMax;
+    uint32_t dropped;
+    uint32_t recovered;
+    uint64_t recoverySum;
+    uint64_t recoveryMax;
+} result_t;
+
+/******************************************************************************
+ Local Variables
+ *****************************************************************************/
+
+static const scenario_t scenarios[] =
+{
+    { "no faults", 0, 0 },
+    { "5% dropped, outage", 5, 1 },
+    { "20% dropped, outage", 20, 1 }
+};
+
+/*! Registers of the stand-in msp430.h */
+volatile uint16_t WDTCTL;
+volatile uint8_t CALBC1_1MHZ;
+volatile uint8_t CALBC1_16MHZ;
+volatile uint8_t CALDCO_16MHZ;
+volatile uint8_t DCOCTL;
+volatile uint8_t BCSCTL1;
+volatile uint8_t BCSCTL3;
+volatile uint8_t P1SEL;
+volatile uint8_t P1SEL2;
+volatile uint8_t UCA0CTL1;
+volatile uint8_t UCA0BR0;
+volatile uint8_t UCA0BR1;
+volatile uint8_t UCA0MCTL;
+volatile uint8_t IE2;
+volatile uint16_t TA0CCR0;
+volatile uint16_t TA0CCTL0;
+volatile uint16_t TA0CTL;
+volatile uint8_t espRxData;
+uint8_t espTxFifo[ESP_TX_FIFO_SIZE];
+uint16_t espTxHead;
+
+static uint16_t espTxTail;
+
+/*! Simulated clock and the next interrupts */
+static uint64_t simNow;
+static uint64_t nextTick;
+static uint64_t nextReading;
+static uint64_t simEnd;
+static jmp_buf simExit;
+
+/*! An interrupt left the low power mode on exit */
+static uint8_t wakeOnExit;
+
+static rxByte_t rxQueue[RX_QUEUE_SIZE];
+static uint32_t rxHead;
+static uint32_t rxTail;
+static uint64_t rxLast;
+
+static ringBuffer *pCollectorRx;
+
+static const scenario_t *pScenario;
+static esp_t esp;
+static uint8_t apDown;
+static uint32_t seed;
+
+/*! Time each reading was sent by the collector and stored by the server */
+static uint64_t *pProduceTime;
+static uint64_t *pStoreTime;
+
+/*! Dropped responses not followed by a stored request yet */
+static uint64_t *pDropTime;
+static uint32_t dropPending;
+
+static result_t result;
+
+/*! Time the server stored the last single update */
+static uint64_t serverLastUpdate;
+
+/*! State of main.c */
+extern appState sysState;
+extern wifiState wifiStatus;
+extern uint8_t linkOpen;
+extern int16_t httpStatus;
+
+/******************************************************************************
+ Local Functions
+ *****************************************************************************/
+
+/* main.c's main(), renamed on the command line, and its ISRs */
+#undef main
+extern int bridgeMain(void);
+extern void USCI0RX_ISR(void);
+extern void TIMER0_A0_ISR(void);
+
+/*!
+ * @brief       Make a random number.
+ *
+ * @return      random number below 2^24
+ */
+static uint32_t random24(void)
+{
+    seed = (seed * 1103515245u) + 12345u;
+
+    return (seed >> 8);
+}
+
+/*!
+ * @brief       Check if the next command or response is dropped.
+ *
+ * @return      true if dropped
+ */
+static bool dropNow(void)
+{
+    if((random24() % 100) >= pScenario->dropPercent)
+    {
+        return (false);
+    }
+
+    if(dropPending < MAX_SEQ)
+    {
+        pDropTime[dropPending++] = simNow;
+    }
+    result.dropped++;
+
+    return (true);
+}
+
+/*!
+ * @brief       Queue bytes sent by the ESP8266, after the bytes already
+ *              queued and not before delay from now.
+ *
+ * @param       delay - time before the first byte
+ * @param       pStr - bytes
+ */
+static void espSend(uint64_t delay, const char *pStr)
+{
+    uint64_t t = simNow + delay;
+
+    while(*pStr != 0)
+    {
+        if((rxTail - rxHead) >= RX_QUEUE_SIZE)
+        {
+            printf("FAIL: ESP8266 output queue full\n");
+            exit(1);
+        }
+        if(t < (rxLast + BYTE_US))
+        {
+            t = rxLast + BYTE_US;
+        }
+        rxQueue[rxTail % RX_QUEUE_SIZE].time = t;
+        rxQueue[rxTail % RX_QUEUE_SIZE].data = (uint8_t)*pStr++;
+        rxTail++;
+        rxLast = t;
+    }
+}
+
+/*!
+ * @brief       Store a reading on the server.
+ *
+ * @param       seq - sequence number of the reading
+ */
+static void serverStore(uint32_t seq)
+{
+    uint64_t latency = simNow - pProduceTime[seq];
+
+    if(pStoreTime[seq] != 0)
+    {
+        result.duplicated++;
+        return;
+    }
+
+    pStoreTime[seq] = simNow;
+    result.stored++;
+    result.latencySum += latency;
+    if(latency > result.latencyMax)
+    {
+        result.latencyMax = latency;
+    }
+}
+
+#if THINGSPEAK_BULK_UPDATE
+
+/*!
+ * @brief       Store the readings of a bulk update request, as ThingSpeak.
+ *
+ * @param       pBodyOut - body of the response
+ *
+ * @return      HTTP status of the response
+ */
+static int serverRequest(const char **pBodyOut)
+{
+    static const char requestLine[] =
+        "POST /channels/" THINGSPEAK_CHANNEL_ID "/bulk_update.csv HTTP/1.1\r\n";
+    const char *pBody = strstr(esp.request, "\r\n\r\n");
+    const char *pLength = strstr(esp.request, "Content-Length: ");
+    const char *p;
+
+    *pBodyOut = "{\"success\":true}";
+
+    if((strncmp(esp.request, requestLine, sizeof(requestLine) - 1) != 0)
+       || (pBody == NULL) || (pLength == NULL)
+       || ((size_t)atoi(pLength + 16) != strlen(pBody + 4)))
+    {
+        return (400);
+    }
+
+    p = strstr(pBody, "&updates=");
+    if(p == NULL)
+    {
+        return (400);
+    }
+    p += 9;
+
+    while(*p != 0)
+    {
+        long secs;
+        long seq;
+        int64_t offset;
+        char *pEnd;
+
+        secs = strtol(p, &pEnd, 10);
+        if((*pEnd != ',') || (secs < 0))
+        {
+            return (400);
+        }
+        seq = strtol(pEnd + 1, &pEnd, 10);
+        if((*pEnd != ',') || (seq < 0) || ((uint32_t)seq >= result.produced))
+        {
+            return (400);
+        }
+
+        /* Relative time in whole seconds from a tick of the bridge, taken
+           before AT+CIPSEND, whose retry delays the request */
+        offset = (int64_t)(simNow - (secs * SECONDS))
+                 - (int64_t)pProduceTime[seq];
+        if((offset < -(int64_t)(200 * MS))
+           || (offset > (int64_t)MAX_TIME_SKEW))
+        {
+            return (400);
+        }
+
+        serverStore((uint32_t)seq);
+
+        p = strchr(pEnd, '|');
+        if(p == NULL)
+        {
+            break;
+        }
+        p++;
+    }
+
+    return (200);
+}
+
+#else
+
+/*!
+ * @brief       Store the reading of a single update request, as ThingSpeak:
+ *              an update too soon after the previous one is answered with
+ *              entry 0 and not stored.
+ *
+ * @param       pBodyOut - body of the response
+ *
+ * @return      HTTP status of the response
+ */
+static int serverRequest(const char **pBodyOut)
+{
+    static const char requestStart[] =
+        "GET /update?api_key=" THINGSPEAK_API_KEY "&field1=";
+    static const char requestEnd[] =
+        " HTTP/1.1\r\nHost: " THINGSPEAK_HOST
+        "\r\nConnection: keep-alive\r\n\r\n";
+    const char *p = esp.request + sizeof(requestStart) - 1;
+    char *pEnd;
+    long seq;
+    int f;
+
+    *pBodyOut = "0";
+
+    if(strncmp(esp.request, requestStart, sizeof(requestStart) - 1) != 0)
+    {
+        return (400);
+    }
+    seq = strtol(p, &pEnd, 10);
+    if((seq < 0) || ((uint32_t)seq >= result.produced))
+    {
+        return (400);
+    }
+    for(f = 2; f <= TELEMETRY_FIELDS; f++)
+    {
+        char field[16];
+
+        snprintf(field, sizeof(field), "&field%d=", f);
+        if(strncmp(pEnd, field, strlen(field)) != 0)
+        {
+            return (400);
+        }
+        strtol(pEnd + strlen(field), &pEnd, 10);
+    }
+    if(strcmp(pEnd, requestEnd) != 0)
+    {
+        return (400);
+    }
+
+    if((serverLastUpdate != 0)
+       && ((simNow - serverLastUpdate) < SERVER_UPDATE_INTERVAL))
+    {
+        result.rateLimited++;
+        return (200);
+    }
+    serverLastUpdate = simNow;
+
+    serverStore((uint32_t)seq);
+    *pBodyOut = "1";
+
+    return (200);
+}
+
+#endif
+
+/*!
+ * @brief       The ESP8266 took the last byte of a request: send it and
+ *              queue the response of the server.
+ */
+static void espRequestDone(void)
+{
+    char response[256];
+    char ipd[300];
+    const char *pBody;
+    int status;
+
+    esp.request[esp.requestLen] = 0;
+    esp.linkActive = simNow;
+    snprintf(ipd, sizeof(ipd), "\r\nRecv %u bytes\r\n", esp.requestLen);
+    espSend(0, ipd);
+    espSend(ESP_SEND_OK_TIME, "\r\nSEND OK\r\n");
+
+    result.requests++;
+    status = serverRequest(&pBody);
+    if(status != 200)
+    {
+        result.badRequests++;
+        printf("FAIL: bad request\n%s\n", esp.request);
+    }
+
+    /* The readings are stored even when the response is lost */
+    if(dropNow())
+    {
+        return;
+    }
+
+    result.lastRequest = simNow;
+    while(dropPending > 0)
+    {
+        uint64_t recovery = simNow - pDropTime[--dropPending];
+
+        result.recovered++;
+        result.recoverySum += recovery;
+        if(recovery > result.recoveryMax)
+        {
+            result.recoveryMax = recovery;
+        }
+    }
+
+    snprintf(response, sizeof(response),
+             "HTTP/1.1 %d %s\r\nContent-Type: text/plain\r\n"
+             "Content-Length: %u\r\nConnection: keep-alive\r\n\r\n%s",
+             status, (status == 200) ? "OK" : "Bad Request",
+             (unsigned int)strlen(pBody), pBody);
+    snprintf(ipd, sizeof(ipd), "\r\n+IPD,3,%u:%s",
+             (unsigned int)strlen(response), response);
+    espSend(SERVER_RESPONSE_TIME, ipd);
+}
+
+/*!
+ * @brief       Answer an AT command of the bridge.
+ *
+ * @param       pCmd - command line, without its terminator
+ */
+static void espCommand(const char *pCmd)
+{
+    if(dropNow())
+    {
+        return;
+    }
+
+    if(esp.echo)
+    {
+        espSend(0, pCmd);
+        espSend(0, "\r\n");
+    }
+
+    if(strcmp(pCmd, "AT") == 0)
+    {
+        espSend(2 * MS, "\r\nOK\r\n");
+    }
+    else if(strcmp(pCmd, "ATE0") == 0)
+    {
+        esp.echo = 0;
+        espSend(2 * MS, "\r\nOK\r\n");
+    }
+    else if((strcmp(pCmd, "AT+CWMODE=1") == 0)
+            || (strcmp(pCmd, "AT+CWDHCP=1,1") == 0)
+            || (strcmp(pCmd, "AT+CIPMUX=1") == 0))
+    {
+        espSend(2 * MS, "\r\nOK\r\n");
+    }
+    else if(strncmp(pCmd, "AT+CWJAP=", 9) == 0)
+    {
+        if(apDown)
+        {
+            espSend(ESP_JOIN_FAIL, "+CWJAP:3\r\n\r\nFAIL\r\n");
+        }
+        else
+        {
+            esp.joined = 1;
+            espSend(ESP_JOIN_CONNECTED, "WIFI CONNECTED\r\n");
+            espSend(ESP_JOIN_GOT_IP, "WIFI GOT IP\r\n");
+            espSend(ESP_JOIN_OK, "\r\nOK\r\n");
+        }
+    }
+    else if(strcmp(pCmd, "AT+RST") == 0)
+    {
+        espSend(2 * MS, "\r\nOK\r\n");
+        espSend(ESP_BOOT_TIME, "\r\n\x8f\xe1\r\nready\r\n");
+        esp.bootAt = simNow + ESP_BOOT_TIME;
+        esp.echo = 1;
+        esp.joined = 0;
+        esp.link = 0;
+    }
+    else if(strncmp(pCmd, "AT+CIPSTART=3,", 14) == 0)
+    {
+        if(!esp.joined)
+        {
+            espSend(2 * MS, "\r\nERROR\r\n");
+        }
+        else if(esp.link)
+        {
+            espSend(2 * MS, "ALREADY CONNECTED\r\n\r\nERROR\r\n");
+        }
+        else
+        {
+            esp.link = 1;
+            esp.linkActive = simNow;
+            espSend(ESP_CONNECT_TIME, "3,CONNECT\r\n\r\nOK\r\n");
+        }
+    }
+    else if(strncmp(pCmd, "AT+CIPSEND=3,", 13) == 0)
+    {
+        int length = atoi(pCmd + 13);
+
+        if(!esp.link)
+        {
+            espSend(2 * MS, "link is not valid\r\n\r\nERROR\r\n");
+        }
+        else if((length <= 0) || (length > MAX_REQUEST_LEN))
+        {
+            espSend(2 * MS, "\r\nERROR\r\n");
+        }
+        else
+        {
+            esp.sendLeft = (uint16_t)length;
+            esp.requestLen = 0;
+            espSend(2 * MS, "\r\nOK\r\n> ");
+        }
+    }
+    else
+    {
+        espSend(2 * MS, "\r\nERROR\r\n");
+    }
+}
+
+/*!
+ * @brief       Take a byte sent by the bridge.
+ *
+ * @param       c - byte
+ */
+static void espReceive(uint8_t c)
+{
+    if(simNow < esp.bootAt)
+    {
+        return;
+    }
+
+    if(esp.sendLeft > 0)
+    {
+        esp.request[esp.requestLen++] = (char)c;
+        if(--esp.sendLeft == 0)
+        {
+            espRequestDone();
+        }
+        return;
+    }
+
+    if(c == '\n')
+    {
+        if((esp.commandLen > 0) && (esp.command[esp.commandLen - 1] == '\r'))
+        {
+            esp.commandLen--;
+        }
+        esp.command[esp.commandLen] = 0;
+        espCommand(esp.command);
+        esp.commandLen = 0;
+    }
+    else if(esp.commandLen < (MAX_COMMAND_LEN - 1))
+    {
+        esp.command[esp.commandLen++] = (char)c;
+    }
+}
+
+/*!
+ * @brief       Access point and server events of a tick.
+ */
+static void worldTick(void)
+{
+    if(pScenario->outage && (simNow >= OUTAGE_START)
+       && (simNow < (OUTAGE_START + OUTAGE_LENGTH)) && !apDown)
+    {
+        apDown = 1;
+        if(esp.joined)
+        {
+            espSend(0, "WIFI DISCONNECT\r\n");
+        }
+        if(esp.link)
+        {
+            espSend(0, "3,CLOSED\r\n");
+        }
+        esp.joined = 0;
+        esp.link = 0;
+    }
+    else if(apDown && (simNow >= (OUTAGE_START + OUTAGE_LENGTH)))
+    {
+        apDown = 0;
+    }
+
+    if(esp.link && (esp.sendLeft == 0) && (rxHead == rxTail)
+       && ((simNow - esp.linkActive) >= SERVER_IDLE_CLOSE))
+    {
+        esp.link = 0;
+        espSend(0, "3,CLOSED\r\n");
+    }
+}
+
+/*!
+ * @brief       The collector sends a reading, its first field is its
+ *              sequence number.
+ */
+static void collectorReading(void)
+{
+    char line[32];
+    const char *p = line;
+
+    if(result.produced >= MAX_SEQ)
+    {
+        return;
+    }
+
+    snprintf(line, sizeof(line), "$S,%u,%u,%u\r\n", result.produced,
+             result.produced % 40, result.produced % 1000);
+    pProduceTime[result.produced++] = simNow;
+
+    while(*p != 0)
+    {
+        ringBufferPut(pCollectorRx, (uint8_t)*p++);
+    }
+    atEngineWake();
+    wakeOnExit = 1;
+}
+
+/*!
+ * @brief       Sleep in a low power mode: deliver the interrupts in time
+ *              order until one of them wakes the main loop.
+ */
+static void simSleep(void)
+{
+    espTxFlags();
+
+    while(!wakeOnExit)
+    {
+        uint64_t next = nextTick;
+
+        if(nextReading < next)
+        {
+            next = nextReading;
+        }
+        if((rxHead != rxTail) && (rxQueue[rxHead % RX_QUEUE_SIZE].time < next))
+        {
+            next = rxQueue[rxHead % RX_QUEUE_SIZE].time;
+        }
+        if(next >= simEnd)
+        {
+            longjmp(simExit, 1);
+        }
+        simNow = next;
+
+        if((rxHead != rxTail) && (rxQueue[rxHead % RX_QUEUE_SIZE].time == next))
+        {
+            espRxData = rxQueue[rxHead++ % RX_QUEUE_SIZE].data;
+            USCI0RX_ISR();
+        }
+        else if(nextReading == next)
+        {
+            collectorReading();
+            nextReading += READING_PERIOD;
+        }
+        else
+        {
+            worldTick();
+            TIMER0_A0_ISR();
+            nextTick += TICK_US;
+        }
+    }
+
+    wakeOnExit = 0;
+
+    if((result.joined == 0) && (sysState == APP_STATE_IDLE))
+    {
+        result.joined = simNow;
+    }
+}
+
+/*!
+ * @brief       Run the firmware through a scenario.
+ *
+ * @param       pScen - scenario
+ *
+ * @return      0 if the run passes its checks
+ */
+static int runScenario(const scenario_t *pScen)
+{
+    uint32_t queued;
+    uint32_t lost;
+
+    pScenario = pScen;
+    memset(&result, 0, sizeof(result));
+    memset(&esp, 0, sizeof(esp));
+    memset(pProduceTime, 0, MAX_SEQ * sizeof(uint64_t));
+    memset(pStoreTime, 0, MAX_SEQ * sizeof(uint64_t));
+    esp.bootAt = ESP_BOOT_TIME;
+    esp.echo = 1;
+    apDown = 0;
+    seed = pScen->dropPercent + 1;
+    dropPending = 0;
+    serverLastUpdate = 0;
+    simNow = 0;
+    nextTick = TICK_US;
+    nextReading = 30 * SECONDS;
+    simEnd = RUN_TIME;
+    rxHead = rxTail = 0;
+    rxLast = 0;
+    espTxHead = espTxTail = 0;
+    wakeOnExit = 0;
+
+    /* Power up state of main.c */
+    sysState = APP_STATE_CONNECT;
+    wifiStatus = WIFI_NOT_CONNECT;
+    linkOpen = 0;
+    httpStatus = 0;
+
+    espSend(ESP_BOOT_TIME, "\r\n\x8f\xe1\r\nready\r\n");
+
+    if(setjmp(simExit) == 0)
+    {
+        bridgeMain();
+    }
+
+    queued = telemetryCount();
+    lost = telemetryDropped();
+
+    printf("esp %-20s: joined %4.1f s, %u readings, %u stored in %u "
+           "requests, %u queued, %u lost, %u sent twice\n", pScen->pName,
+           (double)result.joined / SECONDS, result.produced, result.stored,
+           result.requests, queued, lost, result.duplicated);
+    printf("esp %-20s: to the server mean %5.1f s max %5.1f s, %u dropped "
+           "responses, recovered mean %5.1f s max %5.1f s\n", "",
+           result.stored ? (double)result.latencySum / result.stored / SECONDS
+                         : 0.0,
+           (double)result.latencyMax / SECONDS, result.dropped,
+           result.recovered ? (double)result.recoverySum / result.recovered
+                              / SECONDS : 0.0,
+           (double)result.recoveryMax / SECONDS);
+
+    if(result.badRequests != 0)
+    {
+        return (1);
+    }
+
+    if(result.rateLimited != 0)
+    {
+        printf("FAIL: %u updates too soon after the previous one\n",
+               result.rateLimited);
+        return (1);
+    }
+
+    /* A reading stored with its response lost may later be dropped from
+       the full queue too, so it can be both stored and lost */
+    if(((result.stored + queued + lost) < result.produced)
+       || ((result.dropped == 0) && ((result.stored + queued + lost)
+                                     != result.produced)))
+    {
+        printf("FAIL: %u readings stored, queued or lost of %u\n",
+               result.stored + queued + lost, result.produced);
+        return (1);
+    }
+
+    if((RUN_TIME - result.lastRequest) > MAX_UPLOAD_GAP)
+    {
+        printf("FAIL: no request stored in the last %llu s\n",
+               (unsigned long long)((RUN_TIME - result.lastRequest) / SECONDS));
+        return (1);
+    }
+
+    if((pScen->dropPercent == 0) && !pScen->outage)
+    {
+        if((lost != 0) || (result.duplicated != 0))
+        {
+            printf("FAIL: readings lost or sent twice without faults\n");
+            return (1);
+        }
+        if(result.latencyMax > ((TELEMETRY_BATCH_SIZE * READING_PERIOD)
+                                + (5 * SECONDS)))
+        {
+            printf("FAIL: a reading took longer than a batch\n");
+            return (1);
+        }
+    }
+
+    return (0);
+}
+
+/******************************************************************************
+ Public Functions
+ *****************************************************************************/
+
+/*!
+ * @brief       Stand-in for the collector software UART: readings are put
+ *              in the ring by collectorReading().
+ */
+void collectorUartInit(ringBuffer *rx)
+{
+    pCollectorRx = rx;
+}
+
+uint8_t collectorUartBusy(void)
+{
+    return (0);
+}
+
+/*!
+ * @brief       USCI_A0 TX flags: the ESP8266 takes the bytes written so
+ *              far, the TX buffer is always ready.
+ */
+uint8_t espTxFlags(void)
+{
+    while(espTxTail != espTxHead)
+    {
+        espReceive(espTxFifo[espTxTail++ % ESP_TX_FIFO_SIZE]);
+    }
+
+    return (UCA0TXIFG);
+}
+
+void __disable_interrupt(void)
+{
+}
+
+void __enable_interrupt(void)
+{
+}
+
+/*!
+ * @brief       Set status register bits, CPUOFF enters the low power mode.
+ */
+void __bis_SR_register(uint16_t bits)
+{
+    if(bits & CPUOFF)
+    {
+        simSleep();
+    }
+}
+
+/*!
+ * @brief       Clear status register bits when the interrupt returns, the
+ *              main loop wakes.
+ */
+void __bic_SR_register_on_exit(uint16_t bits)
+{
+    if(bits & CPUOFF)
+    {
+        wakeOnExit = 1;
+    }
+}
+
+int main(void)
+{
+    unsigned int i;
+
+    pProduceTime = malloc(MAX_SEQ * sizeof(uint64_t));
+    pStoreTime = malloc(MAX_SEQ * sizeof(uint64_t));
+    pDropTime = malloc(MAX_SEQ * sizeof(uint64_t));
+    if((pProduceTime == NULL) || (pStoreTime == NULL) || (pDropTime == NULL))
+    {
+        printf("FAIL: no memory for the readings\n");
+        return (1);
+    }
+
+    for(i = 0; i < (sizeof(scenarios) / sizeof(scenarios[0])); i++)
+    {
+        if(runScenario(&scenarios[i]))
+        {
+            return (1);
+        }
+    }
+
+    free(pProduceTime);
+    free(pStoreTime);
+    free(pDropTime);
+
+    return (0);
+}
@@ -0,0 +1,79 @@
+/******************************************************************************
+
+ @file msp430.h
+
+ @brief Host stand-in for the MSP430G2553 registers and intrinsics used by
+        the ESP8266 bridge. The registers are plain variables, the UART and
+        the low power modes are simulated by esp_sim.c.
+
+ *****************************************************************************/
+#ifndef MSP430_H
+#define MSP430_H
+
+#include <stdint.h>
+
+/* Status register bits */
+#define GIE                     0x0008
+#define CPUOFF                  0x0010
+#define SCG0                    0x0040
+#define SCG1                    0x0080
+#define LPM0_bits               (CPUOFF)
+#define LPM3_bits               (SCG1 + SCG0 + CPUOFF)
+
+/* Bits of the registers written at start up, values don't matter */
+#define BIT0                    0x01
+#define BIT1                    0x02
+#define BIT2                    0x04
+#define WDTPW                   0x5A00
+#define WDTHOLD                 0x0080
+#define UCSSEL_2                0x80
+#define UCBRS0                  0x02
+#define UCBRS2                  0x08
+#define UCSWRST                 0x01
+#define UCA0RXIE                0x01
+#define UCA0TXIFG               0x02
+#define LFXT1S_2                0x20
+#define CCIE                    0x0010
+#define TASSEL_1                0x0100
+#define MC_1                    0x0010
+#define TACLR                   0x0004
+
+/* Start up registers, written and never read back */
+extern volatile uint16_t WDTCTL;
+extern volatile uint8_t CALBC1_1MHZ;
+extern volatile uint8_t CALBC1_16MHZ;
+extern volatile uint8_t CALDCO_16MHZ;
+extern volatile uint8_t DCOCTL;
+extern volatile uint8_t BCSCTL1;
+extern volatile uint8_t BCSCTL3;
+extern volatile uint8_t P1SEL;
+extern volatile uint8_t P1SEL2;
+extern volatile uint8_t UCA0CTL1;
+extern volatile uint8_t UCA0BR0;
+extern volatile uint8_t UCA0BR1;
+extern volatile uint8_t UCA0MCTL;
+extern volatile uint8_t IE2;
+extern volatile uint16_t TA0CCR0;
+extern volatile uint16_t TA0CCTL0;
+extern volatile uint16_t TA0CTL;
+
+/* USCI_A0: the byte of the RX ISR, and a TX FIFO read by the ESP8266 */
+#define ESP_TX_FIFO_SIZE        4096
+extern volatile uint8_t espRxData;
+extern uint8_t espTxFifo[ESP_TX_FIFO_SIZE];
+extern uint16_t espTxHead;
+extern uint8_t espTxFlags(void);
+
+#define UCA0RXBUF               espRxData
+#define UCA0TXBUF               espTxFifo[espTxHead++ % ESP_TX_FIFO_SIZE]
+#define IFG2                    espTxFlags()
+
+/* Interrupt vectors are plain functions called by the simulation */
+#define __interrupt
+
+extern void __disable_interrupt(void);
+extern void __enable_interrupt(void);
+extern void __bis_SR_register(uint16_t bits);
+extern void __bic_SR_register_on_exit(uint16_t bits);
+
+#endif /* MSP430_H */
@@ -0,0 +1,357 @@
+/******************************************************************************
+
+ @file fh_hop_table_test.c
+
+ @brief Host test of the FH hop sequence table: on random channel masks the
+        table must step through every enabled channel in ascending order,
+        and give the same channels as the bit by bit walk of the mask that
+        the sleepy node did on each poll before the table. The excluded
+        channels bitmap must be the complement of the mask.
+
+        Then times the table against the walk, with the default mask of the
+        sensor and with a sparse mask.
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "fh_hop_table.h"
+
+/******************************************************************************
+ Constants and definitions
+ *****************************************************************************/
+
+/*! Channel returned when the mask is empty */
+#define DEFAULT_CHANNEL         0
+
+/*! Channel mask length, APIMAC_154G_CHANNEL_BITMAP_SIZ */
+#define MASK_LEN                17
+
+/*! Channels, APIMAC_154G_MAX_NUM_CHANNEL */
+#define MAX_CHANNELS            129
+
+/*! Random masks checked */
+#define TEST_MASKS              200000
+
+/*! Channels checked on each mask, several times around the sequence */
+#define TEST_STEPS              600
+
+/*! Channels timed */
+#define BENCH_STEPS             20000000
+
+/******************************************************************************
+ Local Variables
+ *****************************************************************************/
+
+/*! Channel mask of the walk */
+static uint8_t fhChannelMask[MASK_LEN];
+
+/*! Next channel of the walk */
+static uint8_t sleepNodeChIdx;
+
+/******************************************************************************
+ Local Functions
+ *****************************************************************************/
+
+/*!
+ * @brief       The bit by bit walk of the sensor jdllc.c before the table.
+ *
+ * @return      next enabled channel
+ */
+static uint8_t walkNext(void)
+{
+    uint8_t curChBitMap = 0;
+    uint8_t curChListPos = 0;
+    uint8_t bitIdx;
+    uint8_t i;
+    uint8_t chanBitMapSize;
+    uint8_t startChListPos;
+    uint8_t retCh;
+
+    chanBitMapSize = sizeof(fhChannelMask) / sizeof(uint8_t);
+    curChListPos = sleepNodeChIdx >> 3;
+    startChListPos = curChListPos;
+    bitIdx = sleepNodeChIdx & 7;
+
+    if((!chanBitMapSize) || (curChListPos >= chanBitMapSize))
+    {
+        return (DEFAULT_CHANNEL);
+    }
+
+    curChBitMap = fhChannelMask[curChListPos] >> bitIdx;
+    curChListPos++;
+
+    while((!curChBitMap) && (curChListPos != startChListPos))
+    {
+        curChBitMap = fhChannelMask[curChListPos];
+        sleepNodeChIdx = curChListPos * 8;
+        curChListPos++;
+        if(curChListPos > (chanBitMapSize - 1))
+        {
+            curChListPos = 0;
+            curChBitMap = fhChannelMask[curChListPos];
+            sleepNodeChIdx = curChListPos * 8;
+        }
+    }
+
+    if(curChBitMap != 0)
+    {
+        i = sleepNodeChIdx;
+        while(i < (8 * (curChListPos + 1)))
+        {
+            if(curChBitMap & 1)
+            {
+                retCh = sleepNodeChIdx;
+                sleepNodeChIdx += 1;
+                return (retCh);
+            }
+            else
+            {
+                sleepNodeChIdx += 1;
+                curChBitMap >>= 1;
+            }
+            i++;
+        }
+    }
+
+    return (DEFAULT_CHANNEL);
+}
+
+/*!
+ * @brief       Fill the mask with random channels, of a random density,
+ *              some bytes left empty.
+ */
+static void randomMask(void)
+{
+    int density = rand() % 9;
+    int ch;
+    int i;
+
+    for(i = 0; i < MASK_LEN; i++)
+    {
+        uint8_t byte = 0;
+        int b;
+
+        for(b = 0; b < 8; b++)
+        {
+            if((rand() % 8) < density)
+            {
+                byte |= (uint8_t)(1 << b);
+            }
+        }
+        fhChannelMask[i] = ((rand() % 4) == 0) ? 0 : byte;
+    }
+
+    /* No channels past the last one */
+    for(ch = MAX_CHANNELS; ch < (MASK_LEN * 8); ch++)
+    {
+        fhChannelMask[ch >> 3] &= (uint8_t)~(1 << (ch & 7));
+    }
+}
+
+/*!
+ * @brief       Check the table against the enabled channels of the mask.
+ *
+ * @param       pTable - table built from the mask
+ *
+ * @return      0 if the table steps through the channels in order
+ */
+static int checkSequence(FhHopTable_t *pTable)
+{
+    uint8_t expected[MAX_CHANNELS];
+    uint8_t count = 0;
+    uint8_t pos = 0;
+    int ch;
+    int k;
+
+    for(ch = 0; ch < MAX_CHANNELS; ch++)
+    {
+        if(fhChannelMask[ch >> 3] & (1 << (ch & 7)))
+        {
+            expected[count++] = (uint8_t)ch;
+        }
+    }
+    if(count != pTable->count)
+    {
+        printf("FAIL: %u channels in the table, %u in the mask\n",
+               pTable->count, count);
+        return (1);
+    }
+
+    for(k = 0; k < TEST_STEPS; k++)
+    {
+        uint8_t channel = FhHopTable_next(pTable, DEFAULT_CHANNEL);
+
+        if(channel != (count ? expected[pos] : DEFAULT_CHANNEL))
+        {
+            printf("FAIL: step %d, channel %u\n", k, channel);
+            return (1);
+        }
+        if(count)
+        {
+            pos = (uint8_t)((pos + 1) % count);
+        }
+    }
+
+    return (0);
+}
+
+/*!
+ * @brief       Check the excluded channels bitmap of the mask.
+ *
+ * @return      0 if it is the complement of the mask, cleared past its end
+ */
+static int checkExclude(void)
+{
+    uint8_t exclude[MASK_LEN + 2];
+    int i;
+
+    memset(exclude, 0x5A, sizeof(exclude));
+    FhHopTable_excludeChannels(fhChannelMask, MASK_LEN, exclude,
+                               sizeof(exclude));
+    for(i = 0; i < (int)sizeof(exclude); i++)
+    {
+        uint8_t expected = (i < MASK_LEN) ? (uint8_t)~fhChannelMask[i] : 0;
+
+        if(exclude[i] != expected)
+        {
+            printf("FAIL: excluded channels byte %d 0x%02x\n", i, exclude[i]);
+            return (1);
+        }
+    }
+
+    return (0);
+}
+
+/*!
+ * @brief       Check the table against the walk. Two quirks of the walk are
+ *              left out: it never reaches channel 128 from a lower byte, so
+ *              channel 128 is cleared, and it returns the default channel
+ *              once a cycle when all the channels sit in one byte that is
+ *              not the first, so that call is skipped.
+ *
+ * @param       pQuirks - incremented for each default channel skipped
+ *
+ * @return      0 if the channels are the same
+ */
+static int checkWalk(uint32_t *pQuirks)
+{
+    FhHopTable_t table;
+    int k;
+
+    fhChannelMask[MAX_CHANNELS >> 3] = 0;
+    sleepNodeChIdx = 0;
+    FhHopTable_init(&table, fhChannelMask, MASK_LEN, MAX_CHANNELS);
+
+    for(k = 0; k < TEST_STEPS; k++)
+    {
+        uint8_t walk = walkNext();
+        uint8_t channel = FhHopTable_next(&table, DEFAULT_CHANNEL);
+
+        if((walk != channel) && (walk == DEFAULT_CHANNEL))
+        {
+            (*pQuirks)++;
+            walk = walkNext();
+        }
+        if(walk != channel)
+        {
+            printf("FAIL: step %d, walk %u table %u\n", k, walk, channel);
+            return (1);
+        }
+    }
+
+    return (0);
+}
+
+/*!
+ * @brief       Read a monotonic clock.
+ *
+ * @return      time, in nanoseconds
+ */
+static uint64_t readNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (((uint64_t)ts.tv_sec * 1000000000u) + (uint64_t)ts.tv_nsec);
+}
+
+/******************************************************************************
+ Public Functions
+ *****************************************************************************/
+
+int main(void)
+{
+    static const uint8_t benchMasks[2][MASK_LEN] =
+    {
+        /* CONFIG_FH_CHANNEL_MASK of the sensor, channels 0 to 55 */
+        { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF },
+        /* Channels 0 and 128 */
+        { 0x01, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x01 }
+    };
+    static const char *benchNames[2] = { "default 56", "sparse {0,128}" };
+    FhHopTable_t table;
+    volatile uint32_t sink = 0;
+    uint32_t quirks = 0;
+    int m;
+    int i;
+
+    srand(1);
+
+    for(i = 0; i < TEST_MASKS; i++)
+    {
+        randomMask();
+        FhHopTable_init(&table, fhChannelMask, MASK_LEN, MAX_CHANNELS);
+        if(checkSequence(&table) || checkExclude() || checkWalk(&quirks))
+        {
+            printf("FAIL: mask %d\n", i);
+            return (1);
+        }
+    }
+
+    printf("fhhop %d masks x %d steps: sequence and excluded channels as "
+           "expected, same as the walk (%u walk defaults skipped)\n",
+           TEST_MASKS, TEST_STEPS, quirks);
+
+    for(m = 0; m < 2; m++)
+    {
+        uint64_t start;
+        uint64_t walkNs;
+        uint64_t tableNs;
+
+        memcpy(fhChannelMask, benchMasks[m], MASK_LEN);
+        sleepNodeChIdx = 0;
+        start = readNs();
+        for(i = 0; i < BENCH_STEPS; i++)
+        {
+            sink += walkNext();
+        }
+        walkNs = readNs() - start;
+
+        FhHopTable_init(&table, fhChannelMask, MASK_LEN, MAX_CHANNELS);
+        start = readNs();
+        for(i = 0; i < BENCH_STEPS; i++)
+        {
+            sink += FhHopTable_next(&table, DEFAULT_CHANNEL);
+        }
+        tableNs = readNs() - start;
+
+        printf("fhhop %-14s channels: walk %5.2f ns, table %5.2f ns a "
+               "channel\n", benchNames[m], (double)walkNs / BENCH_STEPS,
+               (double)tableNs / BENCH_STEPS);
+    }
+
+    (void)sink;
+
+    return (0);
+}
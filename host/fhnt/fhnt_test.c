@@ -0,0 +1,555 @@
+/******************************************************************************
+
+ @file fhnt_test.c
+
+ @brief Host test of the FH neighbor table index: every FHNT_getEntry()
+        through the hash must find the same node, with the same status, as
+        the linear scan of the table it replaced. A randomized run of
+        creates, lookups, removes and purges checks that, the node count,
+        that a full table gives up its least recently used node other than
+        the parent, and that a purge takes the nodes it should.
+
+        Then times FHNT_getEntry() against the linear scan, for neighbors
+        found and not found, with the table full.
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "fh_api.h"
+#include "fh_ie.h"
+#include "fh_nt.h"
+
+/******************************************************************************
+ Constants and definitions
+ *****************************************************************************/
+
+/*! Randomized operations checked */
+#define TEST_OPERATIONS         200000
+
+/*! Operations between checks of every key */
+#define TEST_FULL_CHECK         1000
+
+/*! Keys used, several per node so the table fills and evicts */
+#define TEST_NUM_KEYS           (4 * FHNT_MAX_NUMBER_OF_NODE)
+
+/*! Key of the parent */
+#define TEST_PARENT_KEY         5
+
+/*! Neighbor valid time of the FH PIB, in minutes */
+#define TEST_NEIGHBOR_VALID_TIME 120
+
+/*! Purge interval of fh_nt.c, in ticks */
+#define TEST_PURGE_TICKS        (10UL * 60 * 60 * 1000 * TICKPERIOD_MS_US)
+
+/*! Lookups timed */
+#define BENCH_LOOKUPS           2000000
+
+/*! Node unused in the shadow table */
+#define NO_KEY                  0xFFFF
+
+/******************************************************************************
+ Global Variables
+ *****************************************************************************/
+
+/*! Clock read by fh_nt.c */
+uint32_t fhntTestTicks;
+
+/******************************************************************************
+ Local Variables
+ *****************************************************************************/
+
+/*! Key held by each node, as the test expects it */
+static uint16_t keyAt[FHNT_MAX_NUMBER_OF_NODE];
+
+/*! Use count at the last use of each key, the LRU order of the table */
+static uint32_t lastUse[TEST_NUM_KEYS];
+static uint32_t useCount;
+
+/*! Random generator state */
+static uint32_t rndState = 7;
+
+/******************************************************************************
+ Local Functions
+ *****************************************************************************/
+
+/*!
+ * @brief       Xorshift random number.
+ *
+ * @return      random number
+ */
+static uint32_t rnd(void)
+{
+    rndState ^= rndState << 13;
+    rndState ^= rndState >> 17;
+    rndState ^= rndState << 5;
+
+    return (rndState);
+}
+
+/*!
+ * @brief       EUI-64 of a key, TI OUI first like real devices.
+ *
+ * @param       addr - EUI-64
+ * @param       key - key
+ */
+static void makeAddr(sAddrExt_t addr, uint32_t key)
+{
+    addr[0] = 0x00;
+    addr[1] = 0x12;
+    addr[2] = 0x4b;
+    addr[3] = 0x00;
+    addr[4] = (uint8_t)(key >> 24);
+    addr[5] = (uint8_t)(key >> 16);
+    addr[6] = (uint8_t)(key >> 8);
+    addr[7] = (uint8_t)key;
+}
+
+/*!
+ * @brief       FH PIB stand-in, the parent EUI and the neighbor valid time.
+ *
+ * @param       attrId - attribute
+ * @param       pData - value
+ */
+void FHPIB_get(uint16_t attrId, void *pData)
+{
+    if(attrId == FHPIB_TRACK_PARENT_EUI)
+    {
+        makeAddr(pData, TEST_PARENT_KEY);
+    }
+    else
+    {
+        *(uint16_t *)pData = TEST_NEIGHBOR_VALID_TIME;
+    }
+}
+
+/*!
+ * @brief       The linear scan FHNT_getEntry() of fh_nt.c before the index.
+ *
+ * @param       pAddr - EUI-64
+ * @param       pEntry - node found, or NULL
+ *
+ * @return      status
+ */
+static FHAPI_status scanGetEntry(sAddrExt_t *pAddr, NODE_ENTRY_s **pEntry)
+{
+    uint16_t i;
+    NODE_ENTRY_s *pNodeEntry;
+    uint16_t neighborValidTime;
+    uint32_t curTime;
+
+    *pEntry = NULL;
+    pNodeEntry = FHNT_table.node;
+    FHPIB_get(FHPIB_NEIGHBOR_VALID_TIME, &neighborValidTime);
+    curTime = ICall_getTicks();
+
+    for(i = 0; i < FHNT_MAX_NUMBER_OF_NODE; i++, pNodeEntry++)
+    {
+        if((pNodeEntry->valid)
+           && !memcmp(&(pNodeEntry->dstAddr), pAddr, sizeof(sAddrExt_t)))
+        {
+            *pEntry = pNodeEntry;
+            if(pNodeEntry->UsieParams_s.channelFunc == FHIE_CF_DH1CF)
+            {
+                if((curTime - pNodeEntry->ref_timeStamp)
+                   >= (neighborValidTime * 60 * 1000 * TICKPERIOD_MS_US))
+                {
+                    pNodeEntry->valid |= FHNT_NODE_EXPIRED;
+                    return (FHAPI_STATUS_ERR_EXPIRED_NODE);
+                }
+                return (FHAPI_STATUS_SUCCESS);
+            }
+            else if(pNodeEntry->UsieParams_s.channelFunc
+                    == FHIE_CF_SINGLE_CHANNEL)
+            {
+                return (FHAPI_STATUS_SUCCESS);
+            }
+            return (FHAPI_STATUS_ERR);
+        }
+    }
+
+    return (FHAPI_STATUS_ERR_NO_ENTRY_IN_THE_NEIGHBOR);
+}
+
+/*!
+ * @brief       Look up a key through the index and the linear scan.
+ *
+ * @param       key - key
+ * @param       pEntry - node found, or NULL
+ *
+ * @return      true if both found the same node with the same status
+ */
+static bool checkKey(uint16_t key, NODE_ENTRY_s **pEntry)
+{
+    sAddrExt_t addr;
+    NODE_ENTRY_s *pScan;
+    FHAPI_status scanStatus;
+    FHAPI_status status;
+
+    makeAddr(addr, key);
+    scanStatus = scanGetEntry(&addr, &pScan);
+    status = FHNT_getEntry(&addr, pEntry);
+    if(*pEntry != NULL)
+    {
+        /* a node found moves to the front of the LRU list */
+        lastUse[key] = ++useCount;
+    }
+
+    return ((status == scanStatus) && (*pEntry == pScan));
+}
+
+/*!
+ * @brief       Check every key, the node count and the shadow table.
+ *
+ * @param       op - operation count
+ *
+ * @return      true if consistent
+ */
+static bool checkAll(uint32_t op)
+{
+    uint16_t valid = 0;
+    uint16_t key;
+    uint16_t i;
+
+    for(i = 0; i < FHNT_MAX_NUMBER_OF_NODE; i++)
+    {
+        if(FHNT_table.node[i].valid)
+        {
+            valid++;
+        }
+        if((FHNT_table.node[i].valid != 0) != (keyAt[i] != NO_KEY))
+        {
+            printf("FAIL: op %u, node %u valid %u, expected key %u\n", op, i,
+                   FHNT_table.node[i].valid, keyAt[i]);
+            return (false);
+        }
+    }
+    if(valid != FHNT_table.num_node)
+    {
+        printf("FAIL: op %u, %u valid nodes, num_node %u\n", op, valid,
+               FHNT_table.num_node);
+        return (false);
+    }
+
+    for(key = 0; key < TEST_NUM_KEYS; key++)
+    {
+        NODE_ENTRY_s *pEntry;
+
+        if(checkKey(key, &pEntry) == false)
+        {
+            printf("FAIL: op %u, key %u, index and scan differ\n", op, key);
+            return (false);
+        }
+        if((pEntry != NULL) && (keyAt[pEntry - FHNT_table.node] != key))
+        {
+            printf("FAIL: op %u, key %u found in the wrong node\n", op, key);
+            return (false);
+        }
+    }
+
+    return (true);
+}
+
+/*!
+ * @brief       Create a node for a key that has none.
+ *
+ * @param       key - key
+ * @param       op - operation count
+ *
+ * @return      true if the node was created, and a full table gave up the
+ *              least recently used node other than the parent
+ */
+static bool createKey(uint16_t key, uint32_t op)
+{
+    static const uint8_t channelFuncs[] =
+    {
+        FHIE_CF_SINGLE_CHANNEL, FHIE_CF_DH1CF, FHIE_CF_DH1CF, 1
+    };
+    bool full = (FHNT_table.num_node >= FHNT_MAX_NUMBER_OF_NODE);
+    uint16_t expected = NO_KEY;
+    sAddrExt_t addr;
+    NODE_ENTRY_s *pEntry;
+    uint16_t idx;
+    uint16_t i;
+
+    if(full)
+    {
+        /* least recently used, the parent only when it is the only node */
+        for(i = 0; i < FHNT_MAX_NUMBER_OF_NODE; i++)
+        {
+            uint16_t k = keyAt[i];
+
+            if((k != TEST_PARENT_KEY)
+               && ((expected == NO_KEY) || (lastUse[k] < lastUse[expected])))
+            {
+                expected = k;
+            }
+        }
+    }
+
+    makeAddr(addr, key);
+    pEntry = FHNT_createEntry(&addr);
+    if(pEntry == NULL)
+    {
+        printf("FAIL: op %u, no node created\n", op);
+        return (false);
+    }
+    idx = (uint16_t)(pEntry - FHNT_table.node);
+
+    if(full && (keyAt[idx] != expected))
+    {
+        printf("FAIL: op %u, evicted key %u, least recently used %u\n", op,
+               keyAt[idx], expected);
+        return (false);
+    }
+    if(!full && (keyAt[idx] != NO_KEY))
+    {
+        printf("FAIL: op %u, node %u reused before the table is full\n", op,
+               idx);
+        return (false);
+    }
+
+    keyAt[idx] = key;
+    lastUse[key] = ++useCount;
+    pEntry->UsieParams_s.channelFunc = channelFuncs[rnd() % 4];
+    pEntry->ref_timeStamp = fhntTestTicks;
+    if(rnd() % 4)
+    {
+        pEntry->valid |= FHNT_NODE_W_UTIE;
+    }
+
+    return (true);
+}
+
+/*!
+ * @brief       Purge and check the nodes taken.
+ *
+ * @param       op - operation count
+ *
+ * @return      true if the purge took the nodes with a UTIE not heard from
+ *              for the purge interval, other than the parent
+ */
+static bool purge(uint32_t op)
+{
+    bool expected[FHNT_MAX_NUMBER_OF_NODE];
+    uint16_t i;
+
+    for(i = 0; i < FHNT_MAX_NUMBER_OF_NODE; i++)
+    {
+        NODE_ENTRY_s *pNode = &FHNT_table.node[i];
+
+        expected[i] = (pNode->valid & FHNT_NODE_W_UTIE)
+                      && ((fhntTestTicks - pNode->ref_timeStamp)
+                          >= TEST_PURGE_TICKS)
+                      && (keyAt[i] != TEST_PARENT_KEY);
+    }
+
+    FHNT_purgeEntry(fhntTestTicks);
+
+    for(i = 0; i < FHNT_MAX_NUMBER_OF_NODE; i++)
+    {
+        bool purged = (keyAt[i] != NO_KEY)
+                      && (FHNT_table.node[i].valid == 0);
+
+        if(expected[i] != purged)
+        {
+            printf("FAIL: op %u, node %u purge %s\n", op, i,
+                   expected[i] ? "missed" : "unexpected");
+            return (false);
+        }
+        if(expected[i])
+        {
+            keyAt[i] = NO_KEY;
+        }
+    }
+
+    return (true);
+}
+
+/*!
+ * @brief       Randomized run against the linear scan.
+ *
+ * @return      true if passed
+ */
+static bool runCheck(void)
+{
+    uint32_t op;
+
+    FHNT_reset();
+    memset(keyAt, 0xFF, sizeof(keyAt));
+
+    for(op = 1; op <= TEST_OPERATIONS; op++)
+    {
+        uint16_t key = (uint16_t)(rnd() % TEST_NUM_KEYS);
+        NODE_ENTRY_s *pEntry;
+        sAddrExt_t addr;
+
+        /* a node left alone is purged after about 200 operations */
+        fhntTestTicks += rnd() % (2 * TEST_PURGE_TICKS / 200);
+
+        switch(rnd() % 8)
+        {
+            case 0:
+            case 1:
+            case 2:
+                if(checkKey(key, &pEntry) == false)
+                {
+                    printf("FAIL: op %u, key %u, index and scan differ\n", op,
+                           key);
+                    return (false);
+                }
+                if((pEntry == NULL) && (createKey(key, op) == false))
+                {
+                    return (false);
+                }
+                break;
+
+            case 3:
+            case 4:
+                if(checkKey(key, &pEntry) == false)
+                {
+                    printf("FAIL: op %u, key %u, index and scan differ\n", op,
+                           key);
+                    return (false);
+                }
+                if(pEntry != NULL)
+                {
+                    /* heard from again */
+                    pEntry->ref_timeStamp = fhntTestTicks;
+                }
+                break;
+
+            case 5:
+            case 6:
+                makeAddr(addr, key);
+                FHNT_removeEntry(&addr);
+                for(pEntry = FHNT_table.node;
+                    pEntry < &FHNT_table.node[FHNT_MAX_NUMBER_OF_NODE];
+                    pEntry++)
+                {
+                    if(keyAt[pEntry - FHNT_table.node] == key)
+                    {
+                        keyAt[pEntry - FHNT_table.node] = NO_KEY;
+                    }
+                }
+                break;
+
+            default:
+                if(purge(op) == false)
+                {
+                    return (false);
+                }
+                break;
+        }
+
+        if(((op % TEST_FULL_CHECK) == 0) && (checkAll(op) == false))
+        {
+            return (false);
+        }
+    }
+
+    return (checkAll(op));
+}
+
+/*!
+ * @brief       Read a monotonic clock.
+ *
+ * @return      time, in nanoseconds
+ */
+static uint64_t readNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (((uint64_t)ts.tv_sec * 1000000000u) + (uint64_t)ts.tv_nsec);
+}
+
+/*!
+ * @brief       Time lookups in a full table.
+ *
+ * @param       pGetFn - lookup function
+ * @param       hit - true to look up neighbors in the table
+ * @param       pFound - incremented for each neighbor found
+ *
+ * @return      time of a lookup, in nanoseconds
+ */
+static double timeLookups(FHAPI_status (*pGetFn)(sAddrExt_t *pAddr,
+                                                 NODE_ENTRY_s **pEntry),
+                          bool hit, uint32_t *pFound)
+{
+    sAddrExt_t addr;
+    NODE_ENTRY_s *pEntry;
+    uint64_t start;
+    uint32_t i;
+
+    rndState = 1;
+    start = readNs();
+    for(i = 0; i < BENCH_LOOKUPS; i++)
+    {
+        makeAddr(addr, ((rnd() % FHNT_MAX_NUMBER_OF_NODE) * 3) + (hit ? 1 : 2));
+        if(pGetFn(&addr, &pEntry) == FHAPI_STATUS_SUCCESS)
+        {
+            (*pFound)++;
+        }
+    }
+
+    return ((double)(readNs() - start) / BENCH_LOOKUPS);
+}
+
+/******************************************************************************
+ Public Functions
+ *****************************************************************************/
+
+int main(void)
+{
+    uint32_t found = 0;
+    double hitNs;
+    double missNs;
+    double scanHitNs;
+    double scanMissNs;
+    uint16_t i;
+
+    if(runCheck() == false)
+    {
+        return (1);
+    }
+
+    FHNT_reset();
+    for(i = 0; i < FHNT_MAX_NUMBER_OF_NODE; i++)
+    {
+        sAddrExt_t addr;
+        NODE_ENTRY_s *pEntry;
+
+        makeAddr(addr, (i * 3) + 1);
+        pEntry = FHNT_createEntry(&addr);
+        pEntry->UsieParams_s.channelFunc = FHIE_CF_SINGLE_CHANNEL;
+    }
+
+    hitNs = timeLookups(FHNT_getEntry, true, &found);
+    missNs = timeLookups(FHNT_getEntry, false, &found);
+    scanHitNs = timeLookups(scanGetEntry, true, &found);
+    scanMissNs = timeLookups(scanGetEntry, false, &found);
+
+    if(found != (2 * BENCH_LOOKUPS))
+    {
+        printf("FAIL: %u of %u neighbors found\n", found, 2 * BENCH_LOOKUPS);
+        return (1);
+    }
+
+    printf("fhnt %4u neighbors: %u operations match the scan, lookup hit "
+           "%5.1f ns miss %5.1f ns (scan %6.1f / %6.1f ns)\n",
+           FHNT_MAX_NUMBER_OF_NODE, TEST_OPERATIONS, hitNs, missNs,
+           scanHitNs, scanMissNs);
+
+    return (0);
+}
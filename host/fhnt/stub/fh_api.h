@@ -0,0 +1,42 @@
+/******************************************************************************
+
+ @file fh_api.h
+
+ @brief Host stand-in for the FH header of the same name: only the types,
+        status codes and platform macros that fh_nt.c uses. The clock and
+        the FH PIB are given by fhnt_test.c.
+
+ *****************************************************************************/
+#ifndef FH_API_H
+#define FH_API_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define TRUE                                1
+#define FALSE                               0
+#define MAC_INTERNAL_API
+
+#define SADDR_EXT_LEN                       8
+typedef uint8_t sAddrExt_t[SADDR_EXT_LEN];
+
+typedef uint8_t FHAPI_status;
+#define FHAPI_STATUS_SUCCESS                0x00
+#define FHAPI_STATUS_ERR                    0x61
+#define FHAPI_STATUS_ERR_EXPIRED_NODE       0x6a
+#define FHAPI_STATUS_ERR_NO_ENTRY_IN_THE_NEIGHBOR 0x6b
+
+typedef int halIntState_t;
+#define HAL_ENTER_CRITICAL_SECTION(s)       ((s) = 0)
+#define HAL_EXIT_CRITICAL_SECTION(s)        ((void)(s))
+
+/* Clock of fhnt_test.c, TICKPERIOD_MS_US ticks a millisecond */
+extern uint32_t fhntTestTicks;
+#define ICall_getTicks()                    (fhntTestTicks)
+#define TICKPERIOD_MS_US                    100
+
+#define FHPIB_TRACK_PARENT_EUI              1
+#define FHPIB_NEIGHBOR_VALID_TIME           2
+extern void FHPIB_get(uint16_t attrId, void *pData);
+
+#endif /* FH_API_H */
@@ -0,0 +1,15 @@
+/******************************************************************************
+
+ @file fh_ie.h
+
+ @brief Host stand-in for the FH header of the same name: the channel
+        functions that fh_nt.c checks.
+
+ *****************************************************************************/
+#ifndef FH_IE_H
+#define FH_IE_H
+
+#define FHIE_CF_SINGLE_CHANNEL              0
+#define FHIE_CF_DH1CF                       2
+
+#endif /* FH_IE_H */
@@ -0,0 +1,14 @@
+/******************************************************************************
+
+ @file fh_mgr.h
+
+ @brief Host stand-in for the FH header of the same name, the purge timer
+        is not run on the host.
+
+ *****************************************************************************/
+#ifndef FH_MGR_H
+#define FH_MGR_H
+
+#define FHMGR_macStartFHTimer(pTimer, on)   ((void)(pTimer), (void)(on))
+
+#endif /* FH_MGR_H */
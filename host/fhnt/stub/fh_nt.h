@@ -0,0 +1,70 @@
+/******************************************************************************
+
+ @file fh_nt.h
+
+ @brief Host stand-in for the SDK neighbor table header, with the table
+        and entry layout fh_nt.c relies on. FHNT_MAX_NUMBER_OF_NODE is set
+        by the host Makefile.
+
+ *****************************************************************************/
+#ifndef FH_NT_H
+#define FH_NT_H
+
+#include "fh_api.h"
+
+#if !defined(FHNT_MAX_NUMBER_OF_NODE)
+#define FHNT_MAX_NUMBER_OF_NODE             50
+#endif
+
+#define FHNT_NODE_INVALID                   0x00
+#define FHNT_NODE_CREATED                   0x01
+#define FHNT_NODE_W_UTIE                    0x02
+#define FHNT_NODE_EXPIRED                   0x04
+
+typedef struct
+{
+    uint8_t clockDrift;
+    uint8_t timingAccuracy;
+    uint8_t channelPlan;
+    uint8_t channelFunc;
+    uint8_t channelInfo[24];
+} USIE_PARAM_s;
+
+typedef struct
+{
+    sAddrExt_t dstAddr;
+    uint32_t ref_timeStamp;
+    USIE_PARAM_s UsieParams_s;
+    uint8_t valid;
+} NODE_ENTRY_s;
+
+typedef struct
+{
+    uint16_t num_node;
+    NODE_ENTRY_s node[FHNT_MAX_NUMBER_OF_NODE];
+} NWM_NEIGHBOR_TABLE_s;
+
+typedef struct
+{
+    void (*pFunc)(uint8_t parameter);
+    uint32_t duration;
+} FH_TIMER_s;
+
+typedef struct
+{
+    FH_TIMER_s purgeTimer;
+    uint32_t purgeCount;
+    uint32_t purgeTime;
+} FHNT_HND_s;
+
+extern NWM_NEIGHBOR_TABLE_s FHNT_table;
+extern FHNT_HND_s FHNT_hnd;
+
+extern void FHNT_reset(void);
+extern void FHNT_init(void);
+extern void FHNT_purgeEntry(uint32_t ts);
+extern void FHNT_removeEntry(sAddrExt_t *pAddr);
+extern NODE_ENTRY_s *FHNT_createEntry(sAddrExt_t *pAddr);
+extern FHAPI_status FHNT_getEntry(sAddrExt_t *pAddr, NODE_ENTRY_s **pEntry);
+
+#endif /* FH_NT_H */
@@ -0,0 +1,18 @@
+/******************************************************************************
+
+ @file fh_util.h
+
+ @brief Host stand-in for the FH header of the same name.
+
+ *****************************************************************************/
+#ifndef FH_UTIL_H
+#define FH_UTIL_H
+
+#include <stdint.h>
+
+static inline uint32_t FHUTIL_elapsedTime(uint32_t curTime, uint32_t oldTime)
+{
+    return (curTime - oldTime);
+}
+
+#endif /* FH_UTIL_H */
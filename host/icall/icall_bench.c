@@ -0,0 +1,631 @@
+/******************************************************************************
+
+ @file icall_bench.c
+
+ @brief Host benchmark of ICall_waitMatch(), the wait of the synchronous
+        ApiMac calls for their reply from the stack. icall.c runs on
+        simulated TI-RTOS tasks, semaphores and interrupts. For receive queue
+        depths of 1 to 256 unrelated messages it checks that:
+
+        - the match function never runs in a critical section
+        - each queued message is matched at most once per wait, and the
+          critical sections of a wait don't grow with the queue
+        - the unrelated messages stay queued, in order, with one semaphore
+          count each, whether the reply was queued before the wait, arrives
+          during it, or never arrives
+
+        and times a wait with the reply already queued and with the reply
+        sent by the stack while the application pends.
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <ti/sysbios/knl/Task.h>
+#include <ti/sysbios/knl/Semaphore.h>
+#include <ti/sysbios/knl/Clock.h>
+#include <ti/sysbios/hal/Hwi.h>
+#include <ti/sysbios/BIOS.h>
+
+#include "icall.h"
+
+/******************************************************************************
+ Constants and definitions
+ *****************************************************************************/
+
+/*! Largest receive queue depth */
+#define MAX_DEPTH               256
+
+/*! Most messages the stack sends while the application pends */
+#define MAX_PEND_SENDS          8
+
+/*! Unrelated messages the stack sends before the reply during a pend */
+#define PEND_UNRELATED          3
+
+/*! Waits timed per depth */
+#define TIMED_WAITS             20000
+
+/*! Most critical sections a wait may take, whatever the queue depth */
+#define MAX_WAIT_CS             4
+
+/*! Semaphores of the simulation */
+#define MAX_SEMAPHORES          8
+
+/*! Wait timeout, in milliseconds */
+#define WAIT_MS                 100
+
+/*! Event of a message: an indication, or the reply waited for */
+#define EVENT_INDICATION        1
+#define EVENT_REPLY             2
+
+/*! Message from the stack to the application */
+typedef struct
+{
+    uint8_t event;
+    uint16_t seq;
+} benchMsg_t;
+
+/*! Simulated task */
+struct Task_Object
+{
+    const char *pName;
+};
+
+/*! Simulated semaphore */
+struct Semaphore_Object
+{
+    int count;
+};
+
+/******************************************************************************
+ Local Variables
+ *****************************************************************************/
+
+static struct Task_Object appTask = { "application" };
+static struct Task_Object stackTask = { "stack" };
+static Task_Handle currentTask = &appTask;
+
+static struct Semaphore_Object semaphores[MAX_SEMAPHORES];
+static int numSemaphores;
+
+/*! Critical section nesting, and critical sections of the application */
+static int csDepth;
+static uint32_t csCount;
+
+/*! Simulated clock */
+static uint32_t simTicks;
+
+/*! Entities of the application and of the stack service */
+static ICall_EntityID appEntity;
+static ICall_EntityID stackEntity;
+static Semaphore_Handle appSem;
+
+/*! Messages the stack sends while the application pends */
+static uint8_t pendEvents[MAX_PEND_SENDS];
+static int numPendEvents;
+
+/*! Sequence number of the next message */
+static uint16_t nextSeq;
+
+/*! Match function calls, and calls in a critical section */
+static uint32_t matchCount;
+static uint32_t matchInCs;
+
+/******************************************************************************
+ Simulated TI-RTOS
+ *****************************************************************************/
+
+Task_Handle Task_self(void)
+{
+    return (currentTask);
+}
+
+UInt Task_disable(void)
+{
+    csDepth++;
+    return (0);
+}
+
+void Task_restore(UInt key)
+{
+    (void)key;
+    csDepth--;
+}
+
+void Task_enable(void)
+{
+}
+
+void Task_Params_init(Task_Params *pParams)
+{
+    memset(pParams, 0, sizeof(Task_Params));
+}
+
+Task_Handle Task_create(Task_FuncPtr fxn, Task_Params *pParams, void *pError)
+{
+    return (NULL);
+}
+
+UInt Hwi_disable(void)
+{
+    csDepth++;
+    if(currentTask == &appTask)
+    {
+        csCount++;
+    }
+    return (0);
+}
+
+void Hwi_restore(UInt key)
+{
+    (void)key;
+    csDepth--;
+}
+
+UInt Hwi_enable(void)
+{
+    return (0);
+}
+
+void Hwi_Params_init(Hwi_Params *pParams)
+{
+    memset(pParams, 0, sizeof(Hwi_Params));
+}
+
+Hwi_Handle Hwi_create(Int intNum, Hwi_FuncPtr fxn, Hwi_Params *pParams,
+                      void *pError)
+{
+    return (NULL);
+}
+
+void Hwi_enableInterrupt(UInt intNum)
+{
+}
+
+void Hwi_disableInterrupt(UInt intNum)
+{
+}
+
+uint32_t Clock_getTicks(void)
+{
+    return (simTicks);
+}
+
+void Clock_Params_init(Clock_Params *pParams)
+{
+    memset(pParams, 0, sizeof(Clock_Params));
+}
+
+Clock_Handle Clock_create(Clock_FuncPtr fxn, UInt timeout,
+                          Clock_Params *pParams, void *pError)
+{
+    return (NULL);
+}
+
+void Clock_setTimeout(Clock_Handle handle, UInt timeout)
+{
+}
+
+void Clock_start(Clock_Handle handle)
+{
+}
+
+void Clock_stop(Clock_Handle handle)
+{
+}
+
+void Semaphore_Params_init(Semaphore_Params *pParams)
+{
+    pParams->mode = Semaphore_Mode_COUNTING;
+}
+
+Semaphore_Handle Semaphore_create(Int count, Semaphore_Params *pParams,
+                                  void *pError)
+{
+    if(numSemaphores >= MAX_SEMAPHORES)
+    {
+        return (NULL);
+    }
+    semaphores[numSemaphores].count = count;
+
+    return (&semaphores[numSemaphores++]);
+}
+
+void Semaphore_post(Semaphore_Handle handle)
+{
+    handle->count++;
+}
+
+/*!
+ * @brief       Send a message from the stack to the application.
+ *
+ * @param       event - event of the message
+ */
+static void stackSend(uint8_t event)
+{
+    ICall_AllocArgs allocArgs;
+    ICall_SendArgs sendArgs;
+    benchMsg_t *pMsg;
+    Task_Handle task = currentTask;
+
+    currentTask = &stackTask;
+
+    allocArgs.hdr.service = ICALL_SERVICE_CLASS_PRIMITIVE;
+    allocArgs.hdr.func = ICALL_PRIMITIVE_FUNC_MSG_ALLOC;
+    allocArgs.size = sizeof(benchMsg_t);
+    if(ICall_dispatcher(&allocArgs.hdr) != ICALL_ERRNO_SUCCESS)
+    {
+        ICall_abort();
+    }
+    pMsg = allocArgs.ptr;
+    pMsg->event = event;
+    pMsg->seq = nextSeq++;
+
+    sendArgs.hdr.service = ICALL_SERVICE_CLASS_PRIMITIVE;
+    sendArgs.hdr.func = ICALL_PRIMITIVE_FUNC_SEND_MSG;
+    sendArgs.src = stackEntity;
+    sendArgs.dest.entityId = appEntity;
+    sendArgs.format = 0;
+    sendArgs.msg = pMsg;
+    if(ICall_dispatcher(&sendArgs.hdr) != ICALL_ERRNO_SUCCESS)
+    {
+        ICall_abort();
+    }
+
+    currentTask = task;
+}
+
+/*!
+ Pending with no count runs the stack, which sends the messages set up for
+ the pend, or lets the wait time out.
+ */
+Bool Semaphore_pend(Semaphore_Handle handle, UInt timeout)
+{
+    if((handle->count == 0) && (timeout != BIOS_NO_WAIT))
+    {
+        int i;
+
+        for(i = 0; i < numPendEvents; i++)
+        {
+            stackSend(pendEvents[i]);
+        }
+        numPendEvents = 0;
+    }
+
+    if(handle->count > 0)
+    {
+        handle->count--;
+        return (true);
+    }
+
+    if(timeout != BIOS_NO_WAIT)
+    {
+        simTicks += timeout;
+    }
+
+    return (false);
+}
+
+/******************************************************************************
+ Local Functions
+ *****************************************************************************/
+
+void ICall_abort(void)
+{
+    printf("FAIL: ICall abort\n");
+    exit(1);
+}
+
+void ICall_freeMsg(void *msg)
+{
+    ICall_FreeArgs args;
+
+    args.hdr.service = ICALL_SERVICE_CLASS_PRIMITIVE;
+    args.hdr.func = ICALL_PRIMITIVE_FUNC_MSG_FREE;
+    args.ptr = msg;
+    ICall_dispatcher(&args.hdr);
+}
+
+/*!
+ * @brief       Match function of the wait, for the reply of the stack.
+ *
+ * @param       src - service of the sender
+ * @param       dest - entity the message was sent to
+ * @param       msg - the message
+ *
+ * @return      true for the reply
+ */
+static bool matchReply(ICall_ServiceEnum src, ICall_EntityID dest,
+                       const void *msg)
+{
+    const benchMsg_t *pMsg = msg;
+
+    matchCount++;
+    if(csDepth != 0)
+    {
+        matchInCs++;
+    }
+
+    return ((src == ICALL_SERVICE_CLASS_TIMAC) && (dest == appEntity)
+            && (pMsg->event == EVENT_REPLY));
+}
+
+/*!
+ * @brief       Wait for the reply of the stack.
+ *
+ * @param       ppMsg - the reply, NULL when the wait timed out
+ *
+ * @return      ICall status of the wait
+ */
+static ICall_Errno waitReply(benchMsg_t **ppMsg)
+{
+    ICall_WaitMatchArgs args;
+    ICall_Errno status;
+
+    args.hdr.service = ICALL_SERVICE_CLASS_PRIMITIVE;
+    args.hdr.func = ICALL_PRIMITIVE_FUNC_WAIT_MATCH;
+    args.milliseconds = WAIT_MS;
+    args.matchFn = matchReply;
+    args.msg = NULL;
+    status = ICall_dispatcher(&args.hdr);
+    *ppMsg = (status == ICALL_ERRNO_SUCCESS) ? args.msg : NULL;
+
+    return (status);
+}
+
+/*!
+ * @brief       Fetch and free every message queued to the application.
+ *
+ * @param       pSeqs - sequence numbers of the messages, in queue order
+ * @param       maxSeqs - room in pSeqs
+ *
+ * @return      number of messages
+ */
+static int drainQueue(uint16_t *pSeqs, int maxSeqs)
+{
+    ICall_FetchMsgArgs args;
+    int n = 0;
+
+    args.hdr.service = ICALL_SERVICE_CLASS_PRIMITIVE;
+    args.hdr.func = ICALL_PRIMITIVE_FUNC_FETCH_MSG;
+    while(ICall_dispatcher(&args.hdr) == ICALL_ERRNO_SUCCESS)
+    {
+        if(n < maxSeqs)
+        {
+            pSeqs[n] = ((benchMsg_t *)args.msg)->seq;
+        }
+        n++;
+        ICall_freeMsg(args.msg);
+    }
+
+    return (n);
+}
+
+/*!
+ * @brief       Register the application and enroll the stack service.
+ */
+static void setup(void)
+{
+    ICall_EnrollServiceArgs enrollArgs;
+    ICall_RegisterAppArgs appArgs;
+
+    ICall_init();
+
+    currentTask = &stackTask;
+    enrollArgs.hdr.service = ICALL_SERVICE_CLASS_PRIMITIVE;
+    enrollArgs.hdr.func = ICALL_PRIMITIVE_FUNC_ENROLL;
+    enrollArgs.service = ICALL_SERVICE_CLASS_TIMAC;
+    enrollArgs.fn = NULL;
+    if(ICall_dispatcher(&enrollArgs.hdr) != ICALL_ERRNO_SUCCESS)
+    {
+        ICall_abort();
+    }
+    stackEntity = enrollArgs.entity;
+
+    currentTask = &appTask;
+    appArgs.hdr.service = ICALL_SERVICE_CLASS_PRIMITIVE;
+    appArgs.hdr.func = ICALL_PRIMITIVE_FUNC_REGISTER_APP;
+    if(ICall_dispatcher(&appArgs.hdr) != ICALL_ERRNO_SUCCESS)
+    {
+        ICall_abort();
+    }
+    appEntity = appArgs.entity;
+    appSem = appArgs.msgSyncHdl;
+}
+
+/*!
+ * @brief       One wait with unrelated messages queued.
+ *
+ * @param       depth - unrelated messages queued before the wait
+ * @param       replyQueued - the reply is queued after them before the wait
+ * @param       replyDuringPend - the stack sends more unrelated messages
+ *                                and the reply while the application pends
+ *
+ * @return      0 when the wait and the queue are right, 1 on a failure
+ */
+static int checkWait(int depth, bool replyQueued, bool replyDuringPend)
+{
+    uint16_t expected[MAX_DEPTH + PEND_UNRELATED];
+    uint16_t seqs[MAX_DEPTH + PEND_UNRELATED + 1];
+    uint32_t maxMatches = depth;
+    int numExpected = 0;
+    benchMsg_t *pMsg;
+    ICall_Errno status;
+    uint32_t cs;
+    int i, n;
+
+    for(i = 0; i < depth; i++)
+    {
+        expected[numExpected++] = nextSeq;
+        stackSend(EVENT_INDICATION);
+    }
+    if(replyQueued)
+    {
+        stackSend(EVENT_REPLY);
+        maxMatches++;
+    }
+    if(replyDuringPend)
+    {
+        for(i = 0; i < PEND_UNRELATED; i++)
+        {
+            expected[numExpected++] = nextSeq + i;
+            pendEvents[numPendEvents++] = EVENT_INDICATION;
+        }
+        pendEvents[numPendEvents++] = EVENT_REPLY;
+        maxMatches += PEND_UNRELATED + 1;
+    }
+
+    matchCount = 0;
+    cs = csCount;
+    status = waitReply(&pMsg);
+    cs = csCount - cs;
+    numPendEvents = 0;
+
+    if(matchInCs != 0)
+    {
+        printf("FAIL: depth %d: match function called in a critical "
+               "section\n", depth);
+        return (1);
+    }
+    if(replyQueued || replyDuringPend)
+    {
+        if((status != ICALL_ERRNO_SUCCESS) || (pMsg == NULL)
+           || (pMsg->event != EVENT_REPLY))
+        {
+            printf("FAIL: depth %d: reply not found, status %d\n", depth,
+                   (int)status);
+            return (1);
+        }
+        ICall_freeMsg(pMsg);
+    }
+    else if(status != ICALL_ERRNO_TIMEOUT)
+    {
+        printf("FAIL: depth %d: status %d without a reply\n", depth,
+               (int)status);
+        return (1);
+    }
+    if(matchCount > maxMatches)
+    {
+        printf("FAIL: depth %d: %u matches for %u messages\n", depth,
+               (unsigned)matchCount, (unsigned)maxMatches);
+        return (1);
+    }
+    if(cs > MAX_WAIT_CS)
+    {
+        printf("FAIL: depth %d: %u critical sections in a wait\n", depth,
+               (unsigned)cs);
+        return (1);
+    }
+
+    /* One count per unrelated message still queued */
+    if(appSem->count != numExpected)
+    {
+        printf("FAIL: depth %d: semaphore count %d for %d messages\n", depth,
+               appSem->count, numExpected);
+        return (1);
+    }
+    appSem->count = 0;
+    n = drainQueue(seqs, MAX_DEPTH + PEND_UNRELATED + 1);
+    if((n != numExpected)
+       || (memcmp(seqs, expected, n * sizeof(uint16_t)) != 0))
+    {
+        printf("FAIL: depth %d: %d messages left for %d, or out of order\n",
+               depth, n, numExpected);
+        return (1);
+    }
+
+    return (0);
+}
+
+/*!
+ * @brief       Time waits with unrelated messages queued.
+ *
+ * @param       depth - unrelated messages queued
+ * @param       duringPend - the reply is sent while the application pends,
+ *                           otherwise it is queued before the wait
+ * @param       pMatches - match function calls per wait
+ *
+ * @return      nanoseconds per wait
+ */
+static double timeWaits(int depth, bool duringPend, double *pMatches)
+{
+    struct timespec start, end;
+    benchMsg_t *pMsg;
+    int i;
+
+    for(i = 0; i < depth; i++)
+    {
+        stackSend(EVENT_INDICATION);
+    }
+
+    matchCount = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for(i = 0; i < TIMED_WAITS; i++)
+    {
+        if(duringPend)
+        {
+            pendEvents[0] = EVENT_REPLY;
+            numPendEvents = 1;
+        }
+        else
+        {
+            stackSend(EVENT_REPLY);
+        }
+        if(waitReply(&pMsg) != ICALL_ERRNO_SUCCESS)
+        {
+            ICall_abort();
+        }
+        ICall_freeMsg(pMsg);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    *pMatches = (double)matchCount / TIMED_WAITS;
+
+    appSem->count = 0;
+    drainQueue(NULL, 0);
+
+    return (((end.tv_sec - start.tv_sec) * 1e9
+             + (end.tv_nsec - start.tv_nsec)) / TIMED_WAITS);
+}
+
+/******************************************************************************
+ Public Functions
+ *****************************************************************************/
+
+int main(void)
+{
+    int depth;
+
+    setup();
+
+    for(depth = 1; depth <= MAX_DEPTH; depth++)
+    {
+        if(checkWait(depth - 1, true, false) || checkWait(depth, false, true)
+           || checkWait(depth, false, false))
+        {
+            return (1);
+        }
+    }
+
+    printf("%6s  %14s  %14s\n", "depth", "reply queued", "reply in pend");
+    printf("%6s  %7s %6s  %7s %6s\n", "", "ns", "match", "ns", "match");
+    for(depth = 1; depth <= MAX_DEPTH; depth *= 2)
+    {
+        double queuedMatches, pendMatches;
+        double queuedNs = timeWaits(depth - 1, false, &queuedMatches);
+        double pendNs = timeWaits(depth, true, &pendMatches);
+
+        printf("%6d  %7.0f %6.1f  %7.0f %6.1f\n", depth, queuedNs,
+               queuedMatches, pendNs, pendMatches);
+    }
+
+    return (0);
+}
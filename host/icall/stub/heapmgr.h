@@ -0,0 +1,44 @@
+/******************************************************************************
+
+ @file heapmgr.h
+
+ @brief Host stand-in for the ICall heap template, on the C library heap.
+
+ *****************************************************************************/
+#ifndef HEAPMGR_H
+#define HEAPMGR_H
+
+#include <stdlib.h>
+
+void HEAPMGR_INIT(void)
+{
+}
+
+void *HEAPMGR_MALLOC(uint16_t size)
+{
+    void *blk;
+
+    HEAPMGR_LOCK();
+    blk = malloc(size);
+    HEAPMGR_UNLOCK();
+
+    return (blk);
+}
+
+void *HEAPMGR_REALLOC(void *blk, uint16_t size)
+{
+    HEAPMGR_LOCK();
+    blk = realloc(blk, size);
+    HEAPMGR_UNLOCK();
+
+    return (blk);
+}
+
+void HEAPMGR_FREE(void *blk)
+{
+    HEAPMGR_LOCK();
+    free(blk);
+    HEAPMGR_UNLOCK();
+}
+
+#endif /* HEAPMGR_H */
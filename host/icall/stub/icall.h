@@ -0,0 +1,267 @@
+/******************************************************************************
+
+ @file icall.h
+
+ @brief Host stand-in for the ICall interface: the types, error codes and
+        primitive service function IDs used by icall.c, the IDs being the
+        indexes of its primitive service table.
+
+ *****************************************************************************/
+#ifndef ICALL_H
+#define ICALL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <ti/sysbios/knl/Task.h>
+
+/* Error codes */
+#define ICALL_ERRNO_SUCCESS                     0
+#define ICALL_ERRNO_INVALID_SERVICE             -1
+#define ICALL_ERRNO_INVALID_FUNCTION            -2
+#define ICALL_ERRNO_INVALID_PARAMETER           -3
+#define ICALL_ERRNO_NO_RESOURCE                 -4
+#define ICALL_ERRNO_UNKNOWN_THREAD              -5
+#define ICALL_ERRNO_CORRUPT_MSG                 -6
+#define ICALL_ERRNO_OVERFLOW                    -7
+#define ICALL_ERRNO_UNDERFLOW                   -8
+#define ICALL_ERRNO_TIMEOUT                     1
+#define ICALL_ERRNO_NOMSG                       2
+
+/* Service classes */
+#define ICALL_SERVICE_CLASS_PRIMITIVE           0x0008
+#define ICALL_SERVICE_CLASS_TIMAC               0x0010
+#define ICALL_SERVICE_CLASS_MASK                0xFFF8
+
+#define ICALL_INVALID_ENTITY_ID                 0xFF
+#define ICALL_INVALID_TIMER_ID                  0
+#define ICALL_UNDEF_DEST_ID                     0xFF
+#define ICALL_TIMEOUT_FOREVER                   0xFFFFFFFF
+#define ICALL_SEMAPHORE_MODE_BINARY             1
+
+/* Primitive service functions used by the benchmark */
+#define ICALL_PRIMITIVE_FUNC_ENROLL             0
+#define ICALL_PRIMITIVE_FUNC_REGISTER_APP       1
+#define ICALL_PRIMITIVE_FUNC_MSG_ALLOC          2
+#define ICALL_PRIMITIVE_FUNC_MSG_FREE           3
+#define ICALL_PRIMITIVE_FUNC_SEND_MSG           6
+#define ICALL_PRIMITIVE_FUNC_FETCH_MSG          7
+#define ICALL_PRIMITIVE_FUNC_WAIT_MATCH         25
+
+typedef int_fast16_t ICall_Errno;
+typedef uint_least8_t ICall_EntityID;
+typedef uint_least16_t ICall_ServiceEnum;
+typedef uint_least8_t ICall_MSGFormat;
+typedef uintptr_t ICall_TimerID;
+typedef uint_least32_t ICall_CSState;
+typedef void *ICall_SyncHandle;
+typedef void *ICall_Semaphore;
+
+typedef ICall_CSState (*ICall_EnterCS)(void);
+typedef void (*ICall_LeaveCS)(ICall_CSState key);
+typedef void (*ICall_TimerCback)(void *arg);
+typedef void (*ICall_ISRFunc)(void);
+typedef void (*ICall_TaskEntryFn)(UArg arg0, UArg arg1);
+typedef bool (*ICall_MsgMatchFn)(ICall_ServiceEnum src, ICall_EntityID dest,
+                                 const void *msg);
+
+/* Header of every message, in front of the message */
+typedef struct _icall_msg_hdr_t
+{
+    uint_least16_t len;
+    void *next;
+    uint_least8_t dest_id;
+    ICall_EntityID srcentity;
+    ICall_EntityID dstentity;
+    ICall_MSGFormat format;
+} ICall_MsgHdr;
+
+typedef struct _icall_func_args_hdr_t
+{
+    ICall_ServiceEnum service;
+    uint_least8_t func;
+} ICall_FuncArgsHdr;
+
+typedef ICall_Errno (*ICall_Dispatcher)(ICall_FuncArgsHdr *args);
+typedef ICall_Errno (*ICall_ServiceFunc)(ICall_FuncArgsHdr *args);
+
+typedef struct _icall_remote_task_arg_t
+{
+    ICall_Dispatcher dispatch;
+    ICall_EnterCS entercs;
+    ICall_LeaveCS leavecs;
+} ICall_RemoteTaskArg;
+
+typedef void (*ICall_RemoteTaskEntry)(const ICall_RemoteTaskArg *arg,
+                                      void *startupArg);
+
+typedef union
+{
+    ICall_EntityID entityId;
+    ICall_ServiceEnum servId;
+} ICall_EntityOrService;
+
+typedef struct
+{
+    ICall_FuncArgsHdr hdr;
+    ICall_ServiceEnum service;
+    ICall_ServiceFunc fn;
+    ICall_EntityID entity;
+    ICall_SyncHandle msgSyncHdl;
+} ICall_EnrollServiceArgs;
+
+typedef struct
+{
+    ICall_FuncArgsHdr hdr;
+    ICall_EntityID entity;
+    ICall_SyncHandle msgSyncHdl;
+} ICall_RegisterAppArgs;
+
+typedef struct
+{
+    ICall_FuncArgsHdr hdr;
+    size_t size;
+    void *ptr;
+} ICall_AllocArgs;
+
+typedef struct
+{
+    ICall_FuncArgsHdr hdr;
+    void *ptr;
+} ICall_FreeArgs;
+
+typedef struct
+{
+    ICall_FuncArgsHdr hdr;
+    ICall_EntityID src;
+    ICall_EntityOrService dest;
+    ICall_MSGFormat format;
+    void *msg;
+} ICall_SendArgs;
+
+typedef struct
+{
+    ICall_FuncArgsHdr hdr;
+    ICall_EntityOrService src;
+    ICall_EntityID dest;
+    void *msg;
+} ICall_FetchMsgArgs;
+
+typedef struct
+{
+    ICall_FuncArgsHdr hdr;
+    uint_fast32_t milliseconds;
+} ICall_WaitArgs;
+
+typedef struct
+{
+    ICall_FuncArgsHdr hdr;
+    ICall_SyncHandle syncHandle;
+} ICall_SignalArgs;
+
+typedef struct
+{
+    ICall_FuncArgsHdr hdr;
+    ICall_EntityID entityId;
+    ICall_ServiceEnum servId;
+} ICall_EntityId2ServiceIdArgs;
+
+typedef struct
+{
+    ICall_FuncArgsHdr hdr;
+    int_least32_t intnum;
+} ICall_IntNumArgs;
+
+typedef struct
+{
+    ICall_FuncArgsHdr hdr;
+    int_least32_t intnum;
+    ICall_ISRFunc isrfunc;
+} ICall_RegisterISRArgs;
+
+typedef struct
+{
+    ICall_FuncArgsHdr hdr;
+    int_least32_t intnum;
+    ICall_ISRFunc isrfunc;
+    int intPriority;
+} ICall_RegisterISRArgs_Ext;
+
+typedef struct
+{
+    ICall_FuncArgsHdr hdr;
+    uint_fast32_t value;
+} ICall_GetUint32Args;
+
+typedef struct
+{
+    ICall_FuncArgsHdr hdr;
+    uint_fast32_t timeout;
+    ICall_TimerID timerid;
+    ICall_TimerCback cback;
+    void *arg;
+} ICall_SetTimerArgs;
+
+typedef struct
+{
+    ICall_FuncArgsHdr hdr;
+    ICall_TimerID timerid;
+} ICall_StopTimerArgs;
+
+typedef struct
+{
+    ICall_FuncArgsHdr hdr;
+    uint_fast32_t milliseconds;
+    ICall_MsgMatchFn matchFn;
+    ICall_ServiceEnum servId;
+    ICall_EntityID dest;
+    void *msg;
+} ICall_WaitMatchArgs;
+
+typedef struct
+{
+    ICall_FuncArgsHdr hdr;
+    ICall_EntityID entity;
+} ICall_GetEntityIdArgs;
+
+typedef struct
+{
+    ICall_FuncArgsHdr hdr;
+    Task_Handle taskhandle;
+    ICall_ServiceEnum servId;
+    uint_fast8_t result;
+} ICall_ThreadServesArgs;
+
+typedef struct
+{
+    ICall_FuncArgsHdr hdr;
+    ICall_TaskEntryFn entryfn;
+    int priority;
+    uint_least16_t stacksize;
+    UArg arg;
+} ICall_CreateTaskArgs;
+
+typedef struct
+{
+    ICall_FuncArgsHdr hdr;
+    uint_least8_t mode;
+    int initcount;
+    ICall_Semaphore sem;
+} ICall_CreateSemaphoreArgs;
+
+typedef struct
+{
+    ICall_FuncArgsHdr hdr;
+    ICall_Semaphore sem;
+    uint_fast32_t milliseconds;
+} ICall_WaitSemaphoreArgs;
+
+extern ICall_Dispatcher ICall_dispatcher;
+extern ICall_CSState ICall_enterCSImpl(void);
+extern void ICall_leaveCSImpl(ICall_CSState key);
+extern void ICall_init(void);
+extern void ICall_abort(void);
+extern void ICall_freeMsg(void *msg);
+
+#endif /* ICALL_H */
@@ -0,0 +1,16 @@
+/******************************************************************************
+
+ @file icall_addrs.h
+
+ @brief Host stand-in, no stack image: the benchmark enrolls the stack
+        service itself.
+
+ *****************************************************************************/
+#ifndef ICALL_ADDRS_H
+#define ICALL_ADDRS_H
+
+#define ICALL_ADDR_MAPS         { NULL }
+#define ICALL_TASK_PRIORITIES   { 5 }
+#define ICALL_TASK_STACK_SIZES  { 1024 }
+
+#endif /* ICALL_ADDRS_H */
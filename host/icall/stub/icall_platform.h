@@ -0,0 +1,31 @@
+/******************************************************************************
+
+ @file icall_platform.h
+
+ @brief Host stand-in for the ICall platform, no power management.
+
+ *****************************************************************************/
+#ifndef ICALL_PLATFORM_H
+#define ICALL_PLATFORM_H
+
+#include "icall.h"
+
+#define ICALL_HOOK_ABORT_FUNC() ICall_abort()
+
+static inline ICall_Errno ICallPlatform_pwrStub(ICall_FuncArgsHdr *args)
+{
+    (void)args;
+    return (ICALL_ERRNO_SUCCESS);
+}
+
+#define ICallPlatform_pwrUpdActivityCounter     ICallPlatform_pwrStub
+#define ICallPlatform_pwrRegisterNotify         ICallPlatform_pwrStub
+#define ICallPlatform_pwrConfigACAction         ICallPlatform_pwrStub
+#define ICallPlatform_pwrRequire                ICallPlatform_pwrStub
+#define ICallPlatform_pwrDispense               ICallPlatform_pwrStub
+#define ICallPlatform_pwrIsStableXOSCHF         ICallPlatform_pwrStub
+#define ICallPlatform_pwrGetTransitionState     ICallPlatform_pwrStub
+#define ICallPlatform_pwrSwitchXOSCHF           ICallPlatform_pwrStub
+#define ICallPlatform_pwrGetXOSCStartupTime     ICallPlatform_pwrStub
+
+#endif /* ICALL_PLATFORM_H */
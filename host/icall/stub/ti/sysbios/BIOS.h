@@ -0,0 +1,29 @@
+/******************************************************************************
+
+ @file BIOS.h
+
+ @brief Host stand-in for the BIOS calls of ICall, every caller is a task.
+
+ *****************************************************************************/
+#ifndef ti_sysbios_BIOS__include
+#define ti_sysbios_BIOS__include
+
+#include <xdc/std.h>
+
+#define BIOS_NO_WAIT            0
+#define BIOS_WAIT_FOREVER       (~(UInt)0)
+
+typedef enum
+{
+    BIOS_ThreadType_Hwi,
+    BIOS_ThreadType_Swi,
+    BIOS_ThreadType_Task,
+    BIOS_ThreadType_Main
+} BIOS_ThreadType;
+
+static inline BIOS_ThreadType BIOS_getThreadType(void)
+{
+    return (BIOS_ThreadType_Task);
+}
+
+#endif /* ti_sysbios_BIOS__include */
@@ -0,0 +1,7 @@
+/******************************************************************************
+
+ @file GateHwi.h
+
+ @brief Host stand-in, not used by ICall.
+
+ *****************************************************************************/
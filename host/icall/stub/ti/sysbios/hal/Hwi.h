@@ -0,0 +1,31 @@
+/******************************************************************************
+
+ @file Hwi.h
+
+ @brief Host stand-in for the TI-RTOS interrupts, simulated by icall_bench.c.
+
+ *****************************************************************************/
+#ifndef ti_sysbios_hal_Hwi__include
+#define ti_sysbios_hal_Hwi__include
+
+#include <xdc/std.h>
+
+typedef struct Hwi_Object *Hwi_Handle;
+typedef void (*Hwi_FuncPtr)(UArg arg);
+
+typedef struct
+{
+    Int priority;
+    Bool enableInt;
+} Hwi_Params;
+
+extern UInt Hwi_disable(void);
+extern void Hwi_restore(UInt key);
+extern UInt Hwi_enable(void);
+extern void Hwi_Params_init(Hwi_Params *pParams);
+extern Hwi_Handle Hwi_create(Int intNum, Hwi_FuncPtr fxn, Hwi_Params *pParams,
+                             void *pError);
+extern void Hwi_enableInterrupt(UInt intNum);
+extern void Hwi_disableInterrupt(UInt intNum);
+
+#endif /* ti_sysbios_hal_Hwi__include */
@@ -0,0 +1,34 @@
+/******************************************************************************
+
+ @file Clock.h
+
+ @brief Host stand-in for the TI-RTOS clock, simulated by icall_bench.c.
+
+ *****************************************************************************/
+#ifndef ti_sysbios_knl_Clock__include
+#define ti_sysbios_knl_Clock__include
+
+#include <xdc/std.h>
+
+typedef struct Clock_Object *Clock_Handle;
+typedef void (*Clock_FuncPtr)(UArg arg);
+
+typedef struct
+{
+    UInt period;
+    Bool startFlag;
+    UArg arg;
+} Clock_Params;
+
+/*! Tick period in microseconds */
+#define Clock_tickPeriod        10
+
+extern uint32_t Clock_getTicks(void);
+extern void Clock_Params_init(Clock_Params *pParams);
+extern Clock_Handle Clock_create(Clock_FuncPtr fxn, UInt timeout,
+                                 Clock_Params *pParams, void *pError);
+extern void Clock_setTimeout(Clock_Handle handle, UInt timeout);
+extern void Clock_start(Clock_Handle handle);
+extern void Clock_stop(Clock_Handle handle);
+
+#endif /* ti_sysbios_knl_Clock__include */
@@ -0,0 +1,7 @@
+/******************************************************************************
+
+ @file Event.h
+
+ @brief Host stand-in, ICall is built with semaphores.
+
+ *****************************************************************************/
@@ -0,0 +1,32 @@
+/******************************************************************************
+
+ @file Semaphore.h
+
+ @brief Host stand-in for the TI-RTOS semaphores, simulated by icall_bench.c.
+
+ *****************************************************************************/
+#ifndef ti_sysbios_knl_Semaphore__include
+#define ti_sysbios_knl_Semaphore__include
+
+#include <xdc/std.h>
+
+typedef struct Semaphore_Object *Semaphore_Handle;
+
+typedef enum
+{
+    Semaphore_Mode_COUNTING,
+    Semaphore_Mode_BINARY
+} Semaphore_Mode;
+
+typedef struct
+{
+    Semaphore_Mode mode;
+} Semaphore_Params;
+
+extern void Semaphore_Params_init(Semaphore_Params *pParams);
+extern Semaphore_Handle Semaphore_create(Int count, Semaphore_Params *pParams,
+                                         void *pError);
+extern Bool Semaphore_pend(Semaphore_Handle handle, UInt timeout);
+extern void Semaphore_post(Semaphore_Handle handle);
+
+#endif /* ti_sysbios_knl_Semaphore__include */
@@ -0,0 +1,32 @@
+/******************************************************************************
+
+ @file Task.h
+
+ @brief Host stand-in for the TI-RTOS tasks, simulated by icall_bench.c.
+
+ *****************************************************************************/
+#ifndef ti_sysbios_knl_Task__include
+#define ti_sysbios_knl_Task__include
+
+#include <xdc/std.h>
+
+typedef struct Task_Object *Task_Handle;
+typedef void (*Task_FuncPtr)(UArg arg0, UArg arg1);
+
+typedef struct
+{
+    UArg arg0;
+    UArg arg1;
+    Int priority;
+    SizeT stackSize;
+} Task_Params;
+
+extern Task_Handle Task_self(void);
+extern UInt Task_disable(void);
+extern void Task_restore(UInt key);
+extern void Task_enable(void);
+extern void Task_Params_init(Task_Params *pParams);
+extern Task_Handle Task_create(Task_FuncPtr fxn, Task_Params *pParams,
+                               void *pError);
+
+#endif /* ti_sysbios_knl_Task__include */
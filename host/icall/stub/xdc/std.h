@@ -0,0 +1,25 @@
+/******************************************************************************
+
+ @file std.h
+
+ @brief Host stand-in for the XDC types used by ICall.
+
+ *****************************************************************************/
+#ifndef xdc_std__include
+#define xdc_std__include
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef void Void;
+typedef int Int;
+typedef unsigned int UInt;
+typedef bool Bool;
+typedef size_t SizeT;
+typedef uintptr_t UArg;
+
+#define TRUE                    1
+#define FALSE                   0
+
+#endif /* xdc_std__include */
@@ -0,0 +1,386 @@
+/******************************************************************************
+
+ @file indq_sim.c
+
+ @brief Host simulation of the collector pending message store against the
+        MAC indirect queue it replaces, over an hour of sleepy device
+        traffic on a millisecond clock.
+
+        The traffic is the collector's: a tracking request to one device
+        every 2 s round robin, a configuration request to every device
+        every 10 minutes and sent again a second later, and a toggle request
+        to a random device every 20 s. Each device polls every POLL_MS.
+
+        The baseline holds MAC_CFG_TX_DATA_MAX frames for all devices and
+        expires them after the transaction persistence time. The store
+        under test is indq.c itself, built with its defaults.
+
+        The store must overflow less than the baseline queue.
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+#include <stdio.h>
+#include <string.h>
+
+#include "indq.h"
+
+/******************************************************************************
+ Constants and definitions
+ *****************************************************************************/
+
+/*! Number of sleepy devices */
+#if !defined(NUM_DEVICES)
+#define NUM_DEVICES             30
+#endif
+
+/*! Poll interval of the devices, in milliseconds */
+#if !defined(POLL_MS)
+#define POLL_MS                 6000
+#endif
+
+/*! Frames the MAC indirect queue holds, MAC_CFG_TX_DATA_MAX of the FFD */
+#define MACQ_MAX_FRAMES         2
+
+/*! MAC transaction persistence time of the collector, in milliseconds */
+#define MACQ_PERSISTENT_TIME    14400
+
+/*! Simulated time, in milliseconds */
+#define SIM_TIME                (3600 * 1000)
+
+/* Command IDs of the simulated requests */
+#define CMD_CONFIG              1
+#define CMD_TRACKING            2
+#define CMD_TOGGLE              3
+
+/*! Length of a configuration request, the others are the command ID */
+#define CONFIG_LEN              11
+
+/*! A frame in the baseline queue */
+typedef struct
+{
+    /*! Device index */
+    uint16_t dev;
+    /*! Time queued */
+    uint32_t time;
+} frame_t;
+
+/*! Counts of one way of holding the messages */
+typedef struct
+{
+    /*! Messages offered */
+    uint32_t offered;
+    /*! Messages sent to a polling device */
+    uint32_t sent;
+    /*! Messages rejected or dropped because the queue was full */
+    uint32_t overflows;
+    /*! Messages that expired */
+    uint32_t expired;
+    /*! Total time, in milliseconds, sent messages waited */
+    uint64_t latency;
+} simCounts_t;
+
+/******************************************************************************
+ Global Variables
+ *****************************************************************************/
+
+/*! Simulated time, read by the Clock_getTicks() stand-in */
+uint32_t simTicks;
+
+/******************************************************************************
+ Local Variables
+ *****************************************************************************/
+
+/*! Baseline MAC indirect queue */
+static frame_t macq[MACQ_MAX_FRAMES];
+static uint8_t macqCount;
+
+/*! Next poll of each device */
+static uint32_t nextPoll[NUM_DEVICES];
+
+/*! Counts of the baseline and of the store */
+static simCounts_t baseline;
+static simCounts_t store;
+
+/*! Random generator state */
+static uint32_t rndState;
+
+/******************************************************************************
+ Local Functions
+ *****************************************************************************/
+
+/*!
+ * @brief       Xorshift random number.
+ *
+ * @return      random number
+ */
+static uint32_t rnd(void)
+{
+    rndState ^= rndState << 13;
+    rndState ^= rndState >> 17;
+    rndState ^= rndState << 5;
+
+    return (rndState);
+}
+
+/*!
+ * @brief       Seed the random numbers and spread the first polls.
+ */
+static void resetDevices(void)
+{
+    uint16_t d;
+
+    rndState = 12345;
+    for(d = 0; d < NUM_DEVICES; d++)
+    {
+        nextPoll[d] = rnd() % POLL_MS;
+    }
+}
+
+/*!
+ * @brief       Offer the requests of the current millisecond.
+ *
+ * @param       pSendFn - function holding a request for a device
+ */
+static void offerTraffic(void (*pSendFn)(uint16_t dev, uint8_t cmd))
+{
+    uint16_t d;
+
+    if((simTicks % 2000) == 0)
+    {
+        pSendFn((uint16_t)((simTicks / 2000) % NUM_DEVICES), CMD_TRACKING);
+    }
+    if(((simTicks % 600000) == 0) || ((simTicks % 600000) == 1000))
+    {
+        for(d = 0; d < NUM_DEVICES; d++)
+        {
+            pSendFn(d, CMD_CONFIG);
+        }
+    }
+    if((simTicks % 20000) == 0)
+    {
+        pSendFn((uint16_t)(rnd() % NUM_DEVICES), CMD_TOGGLE);
+    }
+}
+
+/*!
+ * @brief       Remove a frame from the baseline queue.
+ *
+ * @param       i - index of the frame
+ */
+static void macqRemove(uint8_t i)
+{
+    memmove(&macq[i], &macq[i + 1], (macqCount - i - 1) * sizeof(frame_t));
+    macqCount--;
+}
+
+/*!
+ * @brief       Hold a request in the baseline queue.
+ *
+ * @param       dev - device index
+ * @param       cmd - command ID, not used
+ */
+static void macqSend(uint16_t dev, uint8_t cmd)
+{
+    (void)cmd;
+
+    baseline.offered++;
+    if(macqCount >= MACQ_MAX_FRAMES)
+    {
+        baseline.overflows++;
+        return;
+    }
+    macq[macqCount].dev = dev;
+    macq[macqCount].time = simTicks;
+    macqCount++;
+}
+
+/*!
+ * @brief       Hold a request in the store, with the priority and coalescing
+ *              the collector gives it.
+ *
+ * @param       dev - device index, used as the short address
+ * @param       cmd - command ID
+ */
+static void indqSend(uint16_t dev, uint8_t cmd)
+{
+    uint8_t payload[CONFIG_LEN] = { 0 };
+    Indq_priority_t priority = Indq_priority_normal;
+    uint16_t len = 1;
+
+    payload[0] = cmd;
+    if(cmd == CMD_CONFIG)
+    {
+        priority = Indq_priority_high;
+        len = CONFIG_LEN;
+    }
+    else if(cmd == CMD_TRACKING)
+    {
+        priority = Indq_priority_low;
+    }
+
+    store.offered++;
+    if(Indq_add(dev, 0, priority, (cmd != CMD_TOGGLE), len, payload)
+       == ApiMac_status_transactionOverflow)
+    {
+        store.overflows++;
+    }
+}
+
+/*!
+ * @brief       Dropped message function of the store.
+ *
+ * @param       msduHandle - not used
+ * @param       status - reason
+ */
+static void indqDropped(uint8_t msduHandle, ApiMac_status_t status)
+{
+    (void)msduHandle;
+
+    if(status == ApiMac_status_transactionExpired)
+    {
+        store.expired++;
+    }
+    else
+    {
+        store.overflows++;
+    }
+}
+
+/*!
+ * @brief       Run the baseline queue.
+ */
+static void runBaseline(void)
+{
+    resetDevices();
+
+    for(simTicks = 0; simTicks < SIM_TIME; simTicks++)
+    {
+        uint16_t d;
+        uint8_t i;
+
+        for(i = 0; i < macqCount;)
+        {
+            if((simTicks - macq[i].time) >= MACQ_PERSISTENT_TIME)
+            {
+                baseline.expired++;
+                macqRemove(i);
+            }
+            else
+            {
+                i++;
+            }
+        }
+
+        offerTraffic(macqSend);
+
+        for(d = 0; d < NUM_DEVICES; d++)
+        {
+            if(simTicks != nextPoll[d])
+            {
+                continue;
+            }
+            nextPoll[d] += POLL_MS;
+
+            /* Frame pending keeps the device awake for all of its frames */
+            for(i = 0; i < macqCount;)
+            {
+                if(macq[i].dev == d)
+                {
+                    baseline.sent++;
+                    baseline.latency += simTicks - macq[i].time;
+                    macqRemove(i);
+                }
+                else
+                {
+                    i++;
+                }
+            }
+        }
+    }
+}
+
+/*!
+ * @brief       Run the pending message store.
+ */
+static void runIndq(void)
+{
+    resetDevices();
+    Indq_init(indqDropped);
+
+    for(simTicks = 0; simTicks < SIM_TIME; simTicks++)
+    {
+        uint16_t d;
+
+        offerTraffic(indqSend);
+
+        for(d = 0; d < NUM_DEVICES; d++)
+        {
+            Indq_msg_t msg;
+
+            if(simTicks != nextPoll[d])
+            {
+                continue;
+            }
+            nextPoll[d] += POLL_MS;
+
+            while(Indq_get(d, &msg))
+            {
+                store.sent++;
+                if(msg.more == false)
+                {
+                    break;
+                }
+            }
+        }
+    }
+
+    store.latency = Indq_statistics.totalLatency;
+}
+
+/*!
+ * @brief       Print the counts of one way of holding the messages.
+ *
+ * @param       pName - name
+ * @param       pCounts - counts
+ */
+static void printCounts(const char *pName, const simCounts_t *pCounts)
+{
+    uint32_t offered = pCounts->offered ? pCounts->offered : 1;
+    uint32_t sent = pCounts->sent ? pCounts->sent : 1;
+
+    printf("indq %-8s offered %5u sent %5u overflow %5u (%4.1f%%) "
+           "expired %4u (%4.1f%%) mean latency %5.0f ms\n",
+           pName, pCounts->offered, pCounts->sent, pCounts->overflows,
+           (100.0 * pCounts->overflows) / offered, pCounts->expired,
+           (100.0 * pCounts->expired) / offered,
+           (double)pCounts->latency / sent);
+}
+
+/******************************************************************************
+ Public Functions
+ *****************************************************************************/
+
+int main(void)
+{
+    runBaseline();
+    runIndq();
+
+    printf("indq %u devices polling every %u ms, %u coalesced\n",
+           NUM_DEVICES, POLL_MS, Indq_statistics.coalesced);
+    printCounts("MAC", &baseline);
+    printCounts("store", &store);
+
+    if(store.overflows >= baseline.overflows)
+    {
+        printf("FAIL: the store overflows as often as the MAC queue\n");
+        return (1);
+    }
+
+    return (0);
+}
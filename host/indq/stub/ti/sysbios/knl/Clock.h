@@ -0,0 +1,23 @@
+/******************************************************************************
+
+ @file Clock.h
+
+ @brief Host stand-in for the SYS/BIOS clock, read from the simulated time
+        of indq_sim.c, one tick a millisecond.
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+#ifndef ti_sysbios_knl_Clock__include
+#define ti_sysbios_knl_Clock__include
+
+#include <stdint.h>
+
+/*! Simulated time, in ticks */
+extern uint32_t simTicks;
+
+#define Clock_getTicks()        (simTicks)
+#define Clock_tickPeriod        1000
+
+#endif /* ti_sysbios_knl_Clock__include */
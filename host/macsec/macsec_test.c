@@ -0,0 +1,681 @@
+/******************************************************************************
+
+ @file macsec_test.c
+
+ @brief Host test and benchmark of the MAC security table indexes of
+        mac_security_pib.c, driven through the stack's own macwrapper.c.
+
+        The checker runs random device adds, deletes, frame counter
+        updates, key rotations and table reloads, and after each one
+        compares every index lookup of mac_sec_index.h with the answer
+        read from the tables themselves.
+
+        The benchmark times each lookup against the walk over the tables
+        through MAC_MlmeGetSecurityReq() that macwrapper.c made before the
+        indexes, for 50 to 254 devices.
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "mac_security_pib.h"
+#include "mac_sec_index.h"
+#include "macwrapper.h"
+
+/******************************************************************************
+ Constants and definitions
+ *****************************************************************************/
+
+/*! PAN ID of the devices */
+#define TEST_PAN_ID             0xACDC
+
+/*! Random operations of the checker */
+#define CHECK_OPS               20000
+
+/*! Extended addresses the checker picks from, more than the table holds */
+#define CHECK_ADDRESSES         (MAX_DEVICE_TABLE_ENTRIES + (MAX_DEVICE_TABLE_ENTRIES / 2))
+
+/*! Lookups of each timed pass */
+#define BENCH_LOOKUPS           20000
+
+/*! Length of the key ID lookup data used by macWrapperAddKeyInitFCtr() */
+#define LOOKUP_LEN              MAC_KEY_LOOKUP_LONG_LEN
+
+/******************************************************************************
+ Local Variables
+ *****************************************************************************/
+
+/*! Key ID lookup data of each key, the last byte is the key index */
+static uint8_t keyLookup[MAX_KEY_TABLE_ENTRIES][LOOKUP_LEN];
+
+/*! Key ID lookup data of the next key, bumped by each rotation */
+static uint8_t nextKeyId = 1;
+
+/*! Noise of the checker, the same on every run */
+static uint32_t randState = 1;
+
+/******************************************************************************
+ Local Functions
+ *****************************************************************************/
+
+/*!
+ * @brief       Pseudo random number.
+ *
+ * @param       range - values from 0 to range - 1
+ *
+ * @return      the number
+ */
+static uint32_t randomRange(uint32_t range)
+{
+    randState = randState * 1103515245 + 12345;
+
+    return ((randState >> 8) % range);
+}
+
+/*!
+ * @brief       Extended address of a device of the test.
+ *
+ * @param       n - device number
+ * @param       pExtAddr - address, out
+ */
+static void makeAddress(uint16_t n, uint8_t *pExtAddr)
+{
+    memset(pExtAddr, 0x12, SADDR_EXT_LEN);
+    pExtAddr[0] = (uint8_t)n;
+    pExtAddr[1] = (uint8_t)(n >> 8);
+}
+
+/*!
+ * @brief       Load a key with new lookup data, as a key rotation of the
+ *              collector does.
+ *
+ * @param       keyIndex - key to replace
+ */
+static void loadKey(uint8_t keyIndex)
+{
+    static uint8_t key[MAC_KEY_MAX_LEN];
+    uint8_t lookupList[2 + LOOKUP_LEN];
+
+    memset(keyLookup[keyIndex], 0x03, LOOKUP_LEN);
+    keyLookup[keyIndex][0] = nextKeyId++;
+    keyLookup[keyIndex][LOOKUP_LEN - 1] = keyIndex + 1;
+
+    lookupList[0] = 1;
+    lookupList[1] = LOOKUP_LEN;
+    memcpy(&lookupList[2], keyLookup[keyIndex], LOOKUP_LEN);
+    macWrapperAddKeyInitFCtr(key, 0, keyIndex, 1, lookupList);
+}
+
+/*!
+ * @brief       Empty the tables and load the first key, as after a
+ *              collector reset.
+ */
+static void resetTables(void)
+{
+    macSecurityPibReset();
+    MAC_MlmeSetSecurityReq(MAC_KEY_TABLE, NULL);
+    loadKey(0);
+}
+
+/*!
+ * @brief       Add a device for a key.
+ *
+ * @param       n - device number
+ * @param       keyIndex - key
+ * @param       duplicate - also add it to the other keys
+ *
+ * @return      status of macWrapperAddDevice()
+ */
+static uint8_t addDevice(uint16_t n, uint8_t keyIndex, uint8_t duplicate)
+{
+    uint8_t extAddr[SADDR_EXT_LEN];
+
+    makeAddress(n, extAddr);
+
+    return (macWrapperAddDevice(TEST_PAN_ID, n + 1, extAddr, FALSE, 1,
+                                keyLookup[keyIndex], randomRange(1000),
+                                FALSE, duplicate));
+}
+
+/*!
+ * @brief       Check whether an extended address marks an unused entry.
+ *
+ * @param       pExtAddr - address
+ *
+ * @return      true if every byte is 0xFF
+ */
+static bool addressUnused(const uint8_t *pExtAddr)
+{
+    uint8_t k;
+
+    for(k = 0; k < SADDR_EXT_LEN; k++)
+    {
+        if(pExtAddr[k] != 0xFF)
+        {
+            return (false);
+        }
+    }
+
+    return (true);
+}
+
+/*!
+ * @brief       Read from the lookup list whether a key is in use.
+ *
+ * @param       keyIndex - key
+ *
+ * @return      true if it has lookup entries and none marks it unused
+ */
+static bool tableKeyUsed(uint8_t keyIndex)
+{
+    keyIdLookupDescriptor_t *pLookup = macSecurityPib.macKeyIdLookupList[keyIndex];
+    uint8_t count = macSecurityPib.macKeyTable[keyIndex].keyIdLookupEntries;
+    uint8_t j;
+
+    if(count > MAX_KEY_ID_LOOKUP_ENTRIES)
+    {
+        count = MAX_KEY_ID_LOOKUP_ENTRIES;
+    }
+    for(j = 0; j < count; j++)
+    {
+        if((pLookup[j].lookupDataSize == 1)
+           && (pLookup[j].lookupData[LOOKUP_LEN - 1] == 0)
+           && addressUnused(pLookup[j].lookupData))
+        {
+            return (false);
+        }
+    }
+
+    return (count != 0);
+}
+
+/*!
+ * @brief       Compare every index lookup with the tables.
+ *
+ * @param       op - operation number, for the failure message
+ *
+ * @return      0 when they agree, 1 on a failure
+ */
+static int checkIndexes(uint32_t op)
+{
+    static uint8_t refs[MAX_DEVICE_TABLE_ENTRIES];
+    uint8_t freeDevice = MAC_SEC_INDEX_NONE;
+    uint8_t extAddr[SADDR_EXT_LEN];
+    uint16_t i;
+    uint8_t k;
+
+    /* Device index: every address in the table is found, at an entry of
+       that address, and the free entry is the first unused one. Until
+       macWrapperAddDevice() fills the table after a reset its entries
+       describe no device. */
+    if(macSecurityPib.deviceTableEntries == 0)
+    {
+        freeDevice = 0;
+    }
+    for(i = 0; (i < MAX_DEVICE_TABLE_ENTRIES)
+               && (macSecurityPib.deviceTableEntries != 0); i++)
+    {
+        const uint8_t *pExtAddr = macSecurityPib.macDeviceTable[i].extAddress;
+        uint8_t found;
+
+        if(addressUnused(pExtAddr))
+        {
+            if(freeDevice == MAC_SEC_INDEX_NONE)
+            {
+                freeDevice = (uint8_t)i;
+            }
+            continue;
+        }
+        found = macSecurityPibFindDevice(pExtAddr);
+        if((found >= MAX_DEVICE_TABLE_ENTRIES)
+           || (memcmp(macSecurityPib.macDeviceTable[found].extAddress,
+                      pExtAddr, SADDR_EXT_LEN) != 0))
+        {
+            printf("FAIL: op %u, device %u found at %u\n", op, i, found);
+            return (1);
+        }
+    }
+    if(macSecurityPibFreeDevice() != freeDevice)
+    {
+        printf("FAIL: op %u, free device %u, not %u\n", op,
+               macSecurityPibFreeDevice(), freeDevice);
+        return (1);
+    }
+
+    /* An address that is not in the table is not found */
+    makeAddress(CHECK_ADDRESSES + randomRange(1000), extAddr);
+    if(macSecurityPibFindDevice(extAddr) != MAC_SEC_INDEX_NONE)
+    {
+        printf("FAIL: op %u, unknown device found\n", op);
+        return (1);
+    }
+
+    for(k = 0; k < MAX_KEY_TABLE_ENTRIES; k++)
+    {
+        keyDescriptor_t *pKey = &macSecurityPib.macKeyTable[k];
+        uint8_t freeEntry = MAC_SEC_INDEX_NONE;
+        uint8_t used = tableKeyUsed(k);
+        uint8_t found;
+
+        /* Key index: a used key is found by its lookup data, the first
+           used key of that data */
+        if(macSecurityPibKeyUsed(k) != used)
+        {
+            printf("FAIL: op %u, key %u used %u, not %u\n", op, k,
+                   macSecurityPibKeyUsed(k), used);
+            return (1);
+        }
+        if(used)
+        {
+            uint8_t first;
+
+            for(first = 0; first < k; first++)
+            {
+                if(tableKeyUsed(first)
+                   && (memcmp(macSecurityPib.macKeyIdLookupList[first][0].lookupData,
+                              macSecurityPib.macKeyIdLookupList[k][0].lookupData,
+                              LOOKUP_LEN) == 0))
+                {
+                    break;
+                }
+            }
+            found = macSecurityPibFindKey(1,
+                              macSecurityPib.macKeyIdLookupList[k][0].lookupData);
+            if(found != first)
+            {
+                printf("FAIL: op %u, key %u found as %u\n", op, k, found);
+                return (1);
+            }
+        }
+
+        /* Key device index: an entry referencing the device, or none when
+           no entry does, and the free entry is the first one that
+           references no device */
+        memset(refs, 0, sizeof(refs));
+        for(i = 0; i < MAX_KEY_DEVICE_TABLE_ENTRIES; i++)
+        {
+            uint8_t handle = pKey->keyDeviceList ?
+                     macSecurityPib.macKeyDeviceList[k][i].deviceDescriptorHandle :
+                     MAC_SEC_INDEX_NONE;
+
+            if((i < pKey->keyDeviceListEntries)
+               && (handle < MAX_DEVICE_TABLE_ENTRIES))
+            {
+                refs[handle]++;
+            }
+            else if(freeEntry == MAC_SEC_INDEX_NONE)
+            {
+                freeEntry = (uint8_t)i;
+            }
+        }
+        if(macSecurityPibFreeKeyDevice(k) != freeEntry)
+        {
+            printf("FAIL: op %u, key %u free entry %u, not %u\n", op, k,
+                   macSecurityPibFreeKeyDevice(k), freeEntry);
+            return (1);
+        }
+        for(i = 0; i < MAX_DEVICE_TABLE_ENTRIES; i++)
+        {
+            found = macSecurityPibFindKeyDevice(k, (uint8_t)i);
+            if(refs[i] == 0)
+            {
+                if(found != MAC_SEC_INDEX_NONE)
+                {
+                    printf("FAIL: op %u, key %u device %u at stale entry "
+                           "%u\n", op, k, i, found);
+                    return (1);
+                }
+            }
+            else if(refs[i] > 1)
+            {
+                printf("FAIL: op %u, key %u device %u in %u entries\n", op,
+                       k, i, refs[i]);
+                return (1);
+            }
+            else if((found >= pKey->keyDeviceListEntries)
+                    || (macSecurityPib.macKeyDeviceList[k][found].deviceDescriptorHandle
+                        != i))
+            {
+                printf("FAIL: op %u, key %u device %u found at %u\n", op, k,
+                       i, found);
+                return (1);
+            }
+        }
+    }
+
+    return (0);
+}
+
+/*!
+ * @brief       Random operations on the tables, each followed by a check.
+ *
+ * @return      0 when the indexes always agree with the tables
+ */
+static int runChecker(void)
+{
+    uint32_t counts[6] = { 0 };
+    uint32_t op;
+
+    resetTables();
+    loadKey(1);
+    if(checkIndexes(0))
+    {
+        return (1);
+    }
+
+    for(op = 1; op <= CHECK_OPS; op++)
+    {
+        uint16_t n = (uint16_t)randomRange(CHECK_ADDRESSES);
+        uint32_t pick = randomRange(1000);
+        uint8_t extAddr[SADDR_EXT_LEN];
+
+        if(pick < 550)
+        {
+            /* Add, or a frame counter update of a device already there */
+            addDevice(n, (uint8_t)randomRange(MAX_KEY_TABLE_ENTRIES),
+                      randomRange(4) == 0);
+            counts[0]++;
+        }
+        else if(pick < 950)
+        {
+            makeAddress(n, extAddr);
+            macWrapperDeleteDevice(extAddr);
+            counts[1]++;
+        }
+        else if(pick < 980)
+        {
+            /* Key rotation: the new key takes the devices of the key in
+               use, then the old key and its devices go */
+            uint8_t oldKey = (uint8_t)randomRange(MAX_KEY_TABLE_ENTRIES);
+
+            if(!macSecurityPibKeyUsed(oldKey))
+            {
+                oldKey ^= 1;
+            }
+
+            loadKey(oldKey ^ 1);
+            macWrapperDeleteKeyAndAssociatedDevices(oldKey);
+            counts[2]++;
+        }
+        else if(pick < 990)
+        {
+            /* Table reload, as from NV */
+            static deviceDescriptor_t table[MAX_DEVICE_TABLE_ENTRIES];
+
+            memcpy(table, macSecurityPib.macDeviceTable, sizeof(table));
+            MAC_MlmeSetSecurityReq(MAC_DEVICE_TABLE, table);
+            MAC_MlmeSetSecurityReq(MAC_KEY_TABLE, NULL);
+            counts[3]++;
+        }
+        else if(pick < 998)
+        {
+            macWrapperDeleteAllDevices();
+            counts[4]++;
+        }
+        else
+        {
+            resetTables();
+            loadKey(1);
+            counts[5]++;
+        }
+
+        if(checkIndexes(op))
+        {
+            return (1);
+        }
+    }
+
+    printf("macsec checker: %u ops (%u add, %u delete, %u key rotation, "
+           "%u reload, %u delete all, %u reset), indexes match the tables\n",
+           CHECK_OPS, counts[0], counts[1], counts[2], counts[3], counts[4],
+           counts[5]);
+
+    return (0);
+}
+
+/*!
+ * @brief       Find a device through the key device list, as macwrapper.c
+ *              did before the indexes: each entry and its device copied out
+ *              with MAC_MlmeGetSecurityReq().
+ *
+ * @param       keyIndex - key
+ * @param       pExtAddr - address
+ *
+ * @return      key_device_index, or MAC_SEC_INDEX_NONE
+ */
+static uint8_t scanKeyDevice(uint8_t keyIndex, const uint8_t *pExtAddr)
+{
+    uint16_t j;
+
+    for(j = 0; j < MAX_KEY_DEVICE_TABLE_ENTRIES; j++)
+    {
+        macSecurityPibKeyDeviceEntry_t keyDeviceEntry;
+        macSecurityPibDeviceEntry_t deviceEntry;
+
+        keyDeviceEntry.key_index = keyIndex;
+        keyDeviceEntry.key_device_index = (uint8_t)j;
+        if((MAC_MlmeGetSecurityReq(MAC_KEY_DEVICE_ENTRY, &keyDeviceEntry)
+            != MAC_SUCCESS)
+           || (keyDeviceEntry.macKeyDeviceEntry.deviceDescriptorHandle == 0xFF))
+        {
+            continue;
+        }
+        deviceEntry.device_index =
+                    keyDeviceEntry.macKeyDeviceEntry.deviceDescriptorHandle;
+        if((MAC_MlmeGetSecurityReq(MAC_DEVICE_ENTRY, &deviceEntry)
+            == MAC_SUCCESS)
+           && (memcmp(deviceEntry.macDeviceEntry.extAddress, pExtAddr,
+                      SADDR_EXT_LEN) == 0))
+        {
+            return ((uint8_t)j);
+        }
+    }
+
+    return (MAC_SEC_INDEX_NONE);
+}
+
+/*!
+ * @brief       Find a free device table entry, as macwrapper.c did before
+ *              the indexes.
+ *
+ * @return      device_index, or MAC_SEC_INDEX_NONE
+ */
+static uint8_t scanFreeDevice(void)
+{
+    uint16_t i;
+
+    for(i = 0; i < MAX_DEVICE_TABLE_ENTRIES; i++)
+    {
+        macSecurityPibDeviceEntry_t deviceEntry;
+
+        deviceEntry.device_index = (uint8_t)i;
+        if((MAC_MlmeGetSecurityReq(MAC_DEVICE_ENTRY, &deviceEntry)
+            == MAC_SUCCESS)
+           && addressUnused(deviceEntry.macDeviceEntry.extAddress))
+        {
+            return ((uint8_t)i);
+        }
+    }
+
+    return (MAC_SEC_INDEX_NONE);
+}
+
+/*!
+ * @brief       Find the key of lookup data, as macwrapper.c did before the
+ *              indexes.
+ *
+ * @param       pLookupData - 9 byte lookup data
+ *
+ * @return      key_index, or MAC_SEC_INDEX_NONE
+ */
+static uint8_t scanKey(const uint8_t *pLookupData)
+{
+    uint8_t i, j;
+
+    for(i = 0; i < MAX_KEY_TABLE_ENTRIES; i++)
+    {
+        for(j = 0; j < MAX_KEY_ID_LOOKUP_ENTRIES; j++)
+        {
+            macSecurityPibKeyIdLookupEntry_t lookupEntry;
+
+            lookupEntry.key_index = i;
+            lookupEntry.key_id_lookup_index = j;
+            if((MAC_MlmeGetSecurityReq(MAC_KEY_ID_LOOKUP_ENTRY, &lookupEntry)
+                == MAC_SUCCESS)
+               && (lookupEntry.macKeyIdLookupEntry.lookupDataSize == 1)
+               && (memcmp(lookupEntry.macKeyIdLookupEntry.lookupData,
+                          pLookupData, LOOKUP_LEN) == 0))
+            {
+                return (i);
+            }
+        }
+    }
+
+    return (MAC_SEC_INDEX_NONE);
+}
+
+/*!
+ * @brief       Read a monotonic clock.
+ *
+ * @return      time, in nanoseconds
+ */
+static uint64_t readNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (((uint64_t)ts.tv_sec * 1000000000u) + (uint64_t)ts.tv_nsec);
+}
+
+/*!
+ * @brief       Time the lookups of a table of devices, before and after
+ *              the indexes. Each way runs BENCH_LOOKUPS times in a row.
+ *
+ * @param       count - devices in the table
+ *
+ * @return      0 when both ways agree, 1 on a failure
+ */
+static int runBench(uint16_t count)
+{
+    static uint8_t extAddr[BENCH_LOOKUPS][SADDR_EXT_LEN];
+    static uint8_t scanResult[BENCH_LOOKUPS];
+    static uint8_t indexResult[BENCH_LOOKUPS];
+    double scanNs[3], indexNs[3];
+    uint64_t start;
+    uint32_t l;
+    uint16_t i;
+
+    resetTables();
+    for(i = 0; i < count; i++)
+    {
+        if(addDevice(i, 0, FALSE) != MAC_SUCCESS)
+        {
+            printf("FAIL: %u devices, add %u failed\n", count, i);
+            return (1);
+        }
+    }
+    for(l = 0; l < BENCH_LOOKUPS; l++)
+    {
+        makeAddress((uint16_t)randomRange(count), extAddr[l]);
+    }
+
+    /* Key device entry of a secured frame, by its source address */
+    start = readNs();
+    for(l = 0; l < BENCH_LOOKUPS; l++)
+    {
+        scanResult[l] = scanKeyDevice(0, extAddr[l]);
+    }
+    scanNs[0] = (double)(readNs() - start) / BENCH_LOOKUPS;
+    start = readNs();
+    for(l = 0; l < BENCH_LOOKUPS; l++)
+    {
+        indexResult[l] = macSecurityPibFindKeyDevice(0,
+                                        macSecurityPibFindDevice(extAddr[l]));
+    }
+    indexNs[0] = (double)(readNs() - start) / BENCH_LOOKUPS;
+    if(memcmp(scanResult, indexResult, BENCH_LOOKUPS) != 0)
+    {
+        printf("FAIL: %u devices, device lookups differ\n", count);
+        return (1);
+    }
+
+    /* Free device table entry of an add */
+    start = readNs();
+    for(l = 0; l < BENCH_LOOKUPS; l++)
+    {
+        scanResult[l] = scanFreeDevice();
+    }
+    scanNs[1] = (double)(readNs() - start) / BENCH_LOOKUPS;
+    start = readNs();
+    for(l = 0; l < BENCH_LOOKUPS; l++)
+    {
+        indexResult[l] = macSecurityPibFreeDevice();
+    }
+    indexNs[1] = (double)(readNs() - start) / BENCH_LOOKUPS;
+    if(memcmp(scanResult, indexResult, BENCH_LOOKUPS) != 0)
+    {
+        printf("FAIL: %u devices, free entries differ\n", count);
+        return (1);
+    }
+
+    /* Key of the lookup data of an add */
+    start = readNs();
+    for(l = 0; l < BENCH_LOOKUPS; l++)
+    {
+        scanResult[l] = scanKey(keyLookup[l & 1]);
+    }
+    scanNs[2] = (double)(readNs() - start) / BENCH_LOOKUPS;
+    start = readNs();
+    for(l = 0; l < BENCH_LOOKUPS; l++)
+    {
+        indexResult[l] = macSecurityPibFindKey(1, keyLookup[l & 1]);
+    }
+    indexNs[2] = (double)(readNs() - start) / BENCH_LOOKUPS;
+    if(memcmp(scanResult, indexResult, BENCH_LOOKUPS) != 0)
+    {
+        printf("FAIL: %u devices, key lookups differ\n", count);
+        return (1);
+    }
+
+    printf("macsec %3u devices, ns per lookup, table walk -> index: "
+           "device %6.1f -> %4.1f, free entry %6.1f -> %4.1f, "
+           "key %4.1f -> %4.1f\n", count, scanNs[0], indexNs[0], scanNs[1],
+           indexNs[1], scanNs[2], indexNs[2]);
+
+    return (0);
+}
+
+/******************************************************************************
+ Public Functions
+ *****************************************************************************/
+
+int main(void)
+{
+    static const uint16_t counts[] = { 50, 100, 200, 254 };
+    unsigned int c;
+
+    if(runChecker())
+    {
+        return (1);
+    }
+
+    for(c = 0; c < sizeof(counts) / sizeof(counts[0]); c++)
+    {
+        if((counts[c] <= MAX_DEVICE_TABLE_ENTRIES) && runBench(counts[c]))
+        {
+            return (1);
+        }
+    }
+
+    return (0);
+}
@@ -0,0 +1,1235 @@
+/******************************************************************************
+
+ @file mactrace_replay.c
+
+ @brief Host capture and replay of a MAC callback trace through the
+        collector. collector.c, cllc.c, indq.c and timer.c are built with
+        MACTRACE_HOST and run against a model of the MAC, with the Csf
+        functions standing in for csf.c.
+
+        The MAC model starts the network, has NUM_DEVICES devices join,
+        answers the configuration and tracking requests, has the devices
+        send sensor data and has every fourth device poll as a sleepy
+        device would. The callbacks it makes are recorded to a trace.
+
+        The trace is then replayed at full speed into a new run of the
+        collector, recording it again. The two traces must be the same,
+        and the heap the collector takes with ICall_malloc() through
+        Csf_malloc() must all be given back.
+
+        With no arguments the capture and replay run as a test, the capture
+        in a child process so that the replay starts from a fresh collector.
+        Otherwise:
+
+          mactrace capture <trace> [ms]
+          mactrace replay <trace> [trace out]
+
+        replay also takes a trace read from a target.
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "icall.h"
+#include "mactrace.h"
+#include "timer.h"
+#include "util.h"
+#include "collector.h"
+#include "cllc.h"
+#include "csf.h"
+
+/******************************************************************************
+ Constants and definitions
+ *****************************************************************************/
+
+/*! Devices that join */
+#define NUM_DEVICES             50
+
+/*! Virtual time captured by the test, in milliseconds */
+#define CAPTURE_TIME            600000
+
+/*! Traces written by the test */
+#define CAPTURE_FILE            "build/mactrace_capture.bin"
+#define REPLAY_FILE             "build/mactrace_replay.bin"
+
+/*! Short address of the collector */
+#define COORD_SHORT_ADDR        0xAABB
+
+/*! Time a device sends sensor data, in milliseconds */
+#define SENSOR_INTERVAL         5000
+
+/*! Time a sleepy device polls, in milliseconds */
+#define POLL_INTERVAL           6000
+
+/*! Number of energy detect results */
+#define ED_CHANNELS             17
+
+/*! Longest PIB attribute value kept */
+#define PIB_VALUE_LEN           8
+
+/*! Application events run after a callback before giving up */
+#define MAX_PROCESS_LOOPS       100
+
+/*! MAC model events */
+typedef enum
+{
+    macEvent_scanCnf,
+    macEvent_startCnf,
+    macEvent_assocInd,
+    macEvent_commStatus,
+    macEvent_dataCnf,
+    macEvent_configRsp,
+    macEvent_trackingRsp,
+    macEvent_sensorData,
+    macEvent_pollInd
+} macEvent_t;
+
+/*! MAC model event waiting for its time */
+typedef struct _macevententry_t
+{
+    /*! Next event, in time order */
+    struct _macevententry_t *pNext;
+    /*! Virtual time, in milliseconds */
+    uint32_t time;
+    /*! Event */
+    macEvent_t event;
+    /*! Device index */
+    int dev;
+    /*! MSDU handle, or scan type of a scan confirm */
+    uint8_t handle;
+} macEventEntry_t;
+
+/******************************************************************************
+ Local Variables
+ *****************************************************************************/
+
+/*! true while replaying, the MAC model doesn't make callbacks */
+static bool replayMode;
+
+/*! Callback table the collector registered, wrapped by the trace */
+static ApiMac_callbacks_t *pMacCallbacks;
+
+/*! MAC model events, in time order */
+static macEventEntry_t *pEvents;
+
+/*! MAC model PIB, the values the collector set */
+static uint8_t pibValue[256][PIB_VALUE_LEN];
+
+/*! MAC model frame counter */
+static uint32_t frameCounter;
+
+/*! Short address given to each device, and whether it joined */
+static uint16_t devShortAddr[NUM_DEVICES];
+static bool devJoined[NUM_DEVICES];
+
+/*! Device list of the Csf stand-ins */
+static Llc_deviceListItem_t deviceList[NUM_DEVICES];
+static uint16_t numDevices;
+
+/*! Csf clocks */
+static Clock_Struct trackingClk;
+static Clock_Struct joinClk;
+static Clock_Struct configClk;
+
+/*! Counts, the same in the capture and the replay */
+static uint32_t dataRequests;
+static uint32_t sensorUpdates;
+
+/*! Names of the callback types, indexed by Mactrace_type_t */
+static const char *typeNames[Mactrace_type_lost] =
+{
+    "assocInd", "assocCnf", "disassocInd", "disassocCnf", "beaconNotifyInd",
+    "orphanInd", "scanCnf", "startCnf", "syncLossInd", "pollCnf",
+    "commStatusInd", "pollInd", "dataCnf", "dataInd", "purgeCnf",
+    "wsAsyncInd", "wsAsyncCnf"
+};
+
+/******************************************************************************
+ Local Functions
+ *****************************************************************************/
+
+/*!
+ * @brief       Add a MAC model event, after the events of the same time.
+ *
+ * @param       time - virtual time, in milliseconds
+ * @param       event - event
+ * @param       dev - device index
+ * @param       handle - MSDU handle or scan type
+ */
+static void addEvent(uint32_t time, macEvent_t event, int dev, uint8_t handle)
+{
+    macEventEntry_t *pEntry = malloc(sizeof(macEventEntry_t));
+    macEventEntry_t **ppNext = &pEvents;
+
+    pEntry->time = time;
+    pEntry->event = event;
+    pEntry->dev = dev;
+    pEntry->handle = handle;
+
+    while((*ppNext != NULL) && ((*ppNext)->time <= time))
+    {
+        ppNext = &(*ppNext)->pNext;
+    }
+    pEntry->pNext = *ppNext;
+    *ppNext = pEntry;
+}
+
+/*!
+ * @brief       Extended address of a device.
+ *
+ * @param       dev - device index
+ * @param       pExtAddr - filled in with the address
+ */
+static void getExtAddr(int dev, uint8_t *pExtAddr)
+{
+    int i;
+
+    for(i = 0; i < APIMAC_SADDR_EXT_LEN; i++)
+    {
+        pExtAddr[i] = (uint8_t)(0x10 + i + (dev * APIMAC_SADDR_EXT_LEN));
+    }
+}
+
+/*!
+ * @brief       Find a joined device by its short address.
+ *
+ * @param       shortAddr - short address
+ *
+ * @return      device index, -1 if not found
+ */
+static int findDev(uint16_t shortAddr)
+{
+    int i;
+
+    for(i = 0; i < NUM_DEVICES; i++)
+    {
+        if(devJoined[i] && (devShortAddr[i] == shortAddr))
+        {
+            return (i);
+        }
+    }
+
+    return (-1);
+}
+
+/*!
+ * @brief       Run the collector's events, as its task loop would.
+ */
+static void runApp(void)
+{
+    int loops = 0;
+
+    do
+    {
+        Collector_process();
+    } while((Collector_events || Cllc_events)
+            && (++loops < MAX_PROCESS_LOOPS));
+}
+
+/*!
+ * @brief       Build a data indication from a device and deliver it.
+ *
+ * @param       pEvent - MAC model event
+ */
+static void deliverDataInd(macEventEntry_t *pEvent)
+{
+    ApiMac_mcpsDataInd_t dataInd;
+    uint8_t msdu[32];
+    uint8_t *pBuf = msdu;
+    int i;
+
+    memset(&dataInd, 0, sizeof(ApiMac_mcpsDataInd_t));
+    dataInd.srcAddr.addrMode = ApiMac_addrType_short;
+    dataInd.srcAddr.addr.shortAddr = devShortAddr[pEvent->dev];
+    dataInd.dstAddr.addrMode = ApiMac_addrType_short;
+    dataInd.dstAddr.addr.shortAddr = COORD_SHORT_ADDR;
+    dataInd.srcPanId = pibValue[ApiMac_attribute_panId][0]
+                    | (pibValue[ApiMac_attribute_panId][1] << 8);
+    dataInd.dstPanId = dataInd.srcPanId;
+    dataInd.rssi = (int8_t)(-40 - pEvent->dev);
+    dataInd.mpduLinkQuality = 200;
+    dataInd.dsn = (uint8_t)pEvent->time;
+    dataInd.timestamp = pEvent->time;
+    dataInd.sec.securityLevel = ApiMac_secLevel_encMic32;
+    dataInd.sec.keyIdMode = ApiMac_keyIdMode_1;
+    dataInd.sec.keyIndex = 1;
+
+    if(pEvent->event == macEvent_configRsp)
+    {
+        *pBuf++ = Smsgs_cmdIds_configRsp;
+        *pBuf++ = Smsgs_statusValues_success;
+        *pBuf++ = 0;
+        *pBuf++ = Smsgs_dataFields_tempSensor | Smsgs_dataFields_lightSensor
+                  | Smsgs_dataFields_humiditySensor
+                  | Smsgs_dataFields_msgStats;
+        *pBuf++ = 0;
+        for(i = 0; i < 8; i++)
+        {
+            *pBuf++ = (uint8_t)(i * 3);
+        }
+    }
+    else if(pEvent->event == macEvent_trackingRsp)
+    {
+        *pBuf++ = Smsgs_cmdIds_trackingRsp;
+    }
+    else
+    {
+        *pBuf++ = Smsgs_cmdIds_sensorData;
+        getExtAddr(pEvent->dev, pBuf);
+        pBuf += APIMAC_SADDR_EXT_LEN;
+        *pBuf++ = Smsgs_dataFields_tempSensor | Smsgs_dataFields_lightSensor
+                  | Smsgs_dataFields_humiditySensor;
+        *pBuf++ = 0;
+        for(i = 0; i < 10; i++)
+        {
+            *pBuf++ = (uint8_t)(pEvent->time >> (i % 3));
+        }
+    }
+
+    dataInd.msdu.p = msdu;
+    dataInd.msdu.len = (uint16_t)(pBuf - msdu);
+    pMacCallbacks->pDataIndCb(&dataInd);
+}
+
+/*!
+ * @brief       Make the callback of a MAC model event.
+ *
+ * @param       pEvent - MAC model event
+ */
+static void deliverEvent(macEventEntry_t *pEvent)
+{
+    switch(pEvent->event)
+    {
+        case macEvent_scanCnf:
+        {
+            static uint8_t energy[ED_CHANNELS];
+            ApiMac_mlmeScanCnf_t scanCnf;
+            int i;
+
+            memset(&scanCnf, 0, sizeof(ApiMac_mlmeScanCnf_t));
+            scanCnf.scanType = (ApiMac_scantype_t)pEvent->handle;
+            scanCnf.status = ApiMac_status_noBeacon;
+            if(scanCnf.scanType == ApiMac_scantype_energyDetect)
+            {
+                for(i = 0; i < ED_CHANNELS; i++)
+                {
+                    energy[i] = (uint8_t)((i * 13) % 40);
+                }
+                scanCnf.status = ApiMac_status_success;
+                scanCnf.resultListSize = ED_CHANNELS;
+                scanCnf.result.pEnergyDetect = energy;
+            }
+            pMacCallbacks->pScanCnfCb(&scanCnf);
+            break;
+        }
+
+        case macEvent_startCnf:
+        {
+            ApiMac_mlmeStartCnf_t startCnf;
+
+            startCnf.status = ApiMac_status_success;
+            pMacCallbacks->pStartCnfCb(&startCnf);
+            break;
+        }
+
+        case macEvent_assocInd:
+        {
+            ApiMac_mlmeAssociateInd_t assocInd;
+
+            memset(&assocInd, 0, sizeof(ApiMac_mlmeAssociateInd_t));
+            getExtAddr(pEvent->dev, assocInd.deviceAddress);
+            assocInd.capabilityInformation.rxOnWhenIdle =
+                            ((pEvent->dev % 4) != 0);
+            assocInd.capabilityInformation.allocAddr = true;
+            pMacCallbacks->pAssocIndCb(&assocInd);
+            break;
+        }
+
+        case macEvent_commStatus:
+        {
+            ApiMac_mlmeCommStatusInd_t commStatus;
+
+            memset(&commStatus, 0, sizeof(ApiMac_mlmeCommStatusInd_t));
+            commStatus.status = ApiMac_status_success;
+            commStatus.reason = ApiMac_commStatusReason_assocRsp;
+            commStatus.dstAddr.addrMode = ApiMac_addrType_extended;
+            getExtAddr(pEvent->dev, commStatus.dstAddr.addr.extAddr);
+            commStatus.srcAddr.addrMode = ApiMac_addrType_short;
+            commStatus.srcAddr.addr.shortAddr = COORD_SHORT_ADDR;
+            pMacCallbacks->pCommStatusCb(&commStatus);
+            break;
+        }
+
+        case macEvent_dataCnf:
+        {
+            ApiMac_mcpsDataCnf_t dataCnf;
+
+            memset(&dataCnf, 0, sizeof(ApiMac_mcpsDataCnf_t));
+            dataCnf.status = ApiMac_status_success;
+            dataCnf.msduHandle = pEvent->handle;
+            dataCnf.frameCntr = ++frameCounter;
+            dataCnf.rssi = -50;
+            dataCnf.timestamp = pEvent->time;
+            pMacCallbacks->pDataCnfCb(&dataCnf);
+            break;
+        }
+
+        case macEvent_configRsp:
+        case macEvent_trackingRsp:
+            deliverDataInd(pEvent);
+            break;
+
+        case macEvent_sensorData:
+            deliverDataInd(pEvent);
+            addEvent(pEvent->time + SENSOR_INTERVAL
+                     + (uint32_t)((pEvent->dev * 37) % 500),
+                     macEvent_sensorData, pEvent->dev, 0);
+            break;
+
+        case macEvent_pollInd:
+        {
+            ApiMac_mlmePollInd_t pollInd;
+
+            memset(&pollInd, 0, sizeof(ApiMac_mlmePollInd_t));
+            pollInd.srcAddr.addrMode = ApiMac_addrType_short;
+            pollInd.srcAddr.addr.shortAddr = devShortAddr[pEvent->dev];
+            pollInd.srcPanId = pibValue[ApiMac_attribute_panId][0]
+                            | (pibValue[ApiMac_attribute_panId][1] << 8);
+            pMacCallbacks->pPollIndCb(&pollInd);
+            addEvent(pEvent->time + POLL_INTERVAL, macEvent_pollInd,
+                     pEvent->dev, 0);
+            break;
+        }
+    }
+}
+
+/*!
+ * @brief       Capture a trace of the MAC model.
+ *
+ * @param       pFileName - trace
+ * @param       endTime - virtual time to capture, in milliseconds
+ *
+ * @return      0 if captured
+ */
+static int capture(const char *pFileName, uint32_t endTime)
+{
+    int i;
+
+    Mactrace_pFile = fopen(pFileName, "wb");
+    if(Mactrace_pFile == NULL)
+    {
+        printf("FAIL: can't write %s\n", pFileName);
+        return (1);
+    }
+
+    Collector_init();
+    runApp();
+
+    for(i = 0; i < NUM_DEVICES; i++)
+    {
+        addEvent(1000 + (i * 40), macEvent_assocInd, i, 0);
+    }
+
+    while((pEvents != NULL) && (pEvents->time <= endTime))
+    {
+        macEventEntry_t *pEvent = pEvents;
+
+        pEvents = pEvent->pNext;
+        Mactrace_advance(pEvent->time, runApp);
+        deliverEvent(pEvent);
+        runApp();
+        free(pEvent);
+    }
+
+    fclose(Mactrace_pFile);
+    Mactrace_pFile = NULL;
+
+    printf("mactrace capture: %u data requests, %u sensor updates, "
+           "%u ms\n", dataRequests, sensorUpdates, Mactrace_now());
+
+    return (0);
+}
+
+/*!
+ * @brief       Replay a trace into the collector.
+ *
+ * @param       pFileName - trace
+ * @param       pOutName - trace to record the replay to, or NULL
+ * @param       pStats - filled in with the replay statistics
+ *
+ * @return      0 if the whole trace was replayed
+ */
+static int replay(const char *pFileName, const char *pOutName,
+                  Mactrace_replayStats_t *pStats)
+{
+    Mactrace_replayParams_t params;
+    FILE *pIn = fopen(pFileName, "rb");
+    bool ok;
+    int i;
+
+    if(pIn == NULL)
+    {
+        printf("FAIL: can't read %s\n", pFileName);
+        return (1);
+    }
+
+    replayMode = true;
+    if(pOutName != NULL)
+    {
+        Mactrace_pFile = fopen(pOutName, "wb");
+    }
+
+    Collector_init();
+    runApp();
+
+    params.pCallbacks = pMacCallbacks;
+    params.pProcessFp = runApp;
+    ok = Mactrace_replay(pIn, &params, pStats);
+
+    fclose(pIn);
+    if(Mactrace_pFile != NULL)
+    {
+        fclose(Mactrace_pFile);
+        Mactrace_pFile = NULL;
+    }
+
+    printf("mactrace replay %s: %u callbacks, %u lost, %u timers, %u ms "
+           "in %.3f ms, %u callbacks/s\n", ok ? "ok" : "FAILED",
+           pStats->msgs, pStats->lost, pStats->timers, pStats->virtualTime,
+           (double)pStats->elapsed / 1e6, pStats->msgsPerSec);
+    printf("mactrace heap high water %u bytes, %u in use, %u data requests, "
+           "%u sensor updates\n", pStats->heapHighWater, pStats->heapInUse,
+           dataRequests, sensorUpdates);
+    for(i = 0; i < Mactrace_type_lost; i++)
+    {
+        if(pStats->cb[i].count)
+        {
+            printf("  %-16s %7u  mean %6.0f ns  max %7u ns\n", typeNames[i],
+                   pStats->cb[i].count,
+                   (double)pStats->cb[i].sum / pStats->cb[i].count,
+                   pStats->cb[i].max);
+        }
+    }
+
+    return (ok ? 0 : 1);
+}
+
+/*!
+ * @brief       Compare two traces.
+ *
+ * @param       pName1 - first trace
+ * @param       pName2 - second trace
+ *
+ * @return      0 if they are the same
+ */
+static int compareTraces(const char *pName1, const char *pName2)
+{
+    FILE *pFile1 = fopen(pName1, "rb");
+    FILE *pFile2 = fopen(pName2, "rb");
+    long offset = 0;
+    int ret = 1;
+
+    if((pFile1 != NULL) && (pFile2 != NULL))
+    {
+        int c1;
+        int c2;
+
+        do
+        {
+            c1 = fgetc(pFile1);
+            c2 = fgetc(pFile2);
+            offset++;
+        } while((c1 == c2) && (c1 != EOF));
+
+        if(c1 == c2)
+        {
+            ret = 0;
+        }
+        else
+        {
+            printf("FAIL: the replay trace differs at byte %ld\n", offset - 1);
+        }
+    }
+
+    if(pFile1 != NULL)
+    {
+        fclose(pFile1);
+    }
+    if(pFile2 != NULL)
+    {
+        fclose(pFile2);
+    }
+
+    return (ret);
+}
+
+/*!
+ * @brief       Tracking clock expired.
+ *
+ * @param       arg - not used
+ */
+static void trackingClockCB(UArg arg)
+{
+    (void)arg;
+    Util_setEvent(&Collector_events, COLLECTOR_TRACKING_TIMEOUT_EVT);
+}
+
+/*!
+ * @brief       Join permit clock expired.
+ *
+ * @param       arg - not used
+ */
+static void joinClockCB(UArg arg)
+{
+    (void)arg;
+    Util_setEvent(&Cllc_events, CLLC_JOIN_EVT);
+}
+
+/*!
+ * @brief       Config clock expired.
+ *
+ * @param       arg - not used
+ */
+static void configClockCB(UArg arg)
+{
+    (void)arg;
+    Util_setEvent(&Collector_events, COLLECTOR_CONFIG_EVT);
+}
+
+/*!
+ * @brief       Restart a clock, or stop it.
+ *
+ * @param       pClock - clock
+ * @param       time - timeout in milliseconds, 0 to stop the clock
+ */
+static void setClock(Clock_Struct *pClock, uint32_t time)
+{
+    if(Timer_isActive(pClock))
+    {
+        Timer_stop(pClock);
+    }
+    if(time)
+    {
+        Timer_setTimeout(pClock, time);
+        Timer_start(pClock);
+    }
+}
+
+/*!
+ * @brief       Keep a PIB attribute value.
+ *
+ * @param       attribute - attribute
+ * @param       pValue - value
+ * @param       len - length of the value
+ */
+static void pibSet(uint8_t attribute, const void *pValue, uint16_t len)
+{
+    if(len > PIB_VALUE_LEN)
+    {
+        len = PIB_VALUE_LEN;
+    }
+    memcpy(pibValue[attribute], pValue, len);
+}
+
+/******************************************************************************
+ Public Functions - MAC model
+ *****************************************************************************/
+
+void *ApiMac_init(bool enableFH)
+{
+    (void)enableFH;
+
+    return (NULL);
+}
+
+void ApiMac_registerCallbacks(ApiMac_callbacks_t *pCallbacks)
+{
+    pMacCallbacks = Mactrace_wrapCallbacks(pCallbacks);
+}
+
+void ApiMac_registerCheckPending(ApiMac_checkPendingFp_t pCheckPendingFp)
+{
+    (void)pCheckPendingFp;
+}
+
+void ApiMac_processIncoming(void)
+{
+}
+
+uint8_t ApiMac_randomByte(void)
+{
+    return (0x5A);
+}
+
+ApiMac_status_t ApiMac_mcpsDataReq(ApiMac_mcpsDataReq_t *pData)
+{
+    dataRequests++;
+
+    if(replayMode == false)
+    {
+        uint32_t now = Mactrace_now();
+        int dev = findDev(pData->dstAddr.addr.shortAddr);
+
+        addEvent(now + 8, macEvent_dataCnf, 0, pData->msduHandle);
+        if((dev >= 0) && pData->msdu.len)
+        {
+            if(pData->msdu.p[0] == Smsgs_cmdIds_configReq)
+            {
+                addEvent(now + 30, macEvent_configRsp, dev, 0);
+            }
+            else if(pData->msdu.p[0] == Smsgs_cmdIds_trackingReq)
+            {
+                addEvent(now + 25, macEvent_trackingRsp, dev, 0);
+            }
+        }
+    }
+
+    return (ApiMac_status_success);
+}
+
+ApiMac_status_t ApiMac_mlmeAssociateRsp(ApiMac_mlmeAssociateRsp_t *pData)
+{
+    int i;
+
+    if(replayMode)
+    {
+        return (ApiMac_status_success);
+    }
+
+    for(i = 0; i < NUM_DEVICES; i++)
+    {
+        uint8_t extAddr[APIMAC_SADDR_EXT_LEN];
+
+        getExtAddr(i, extAddr);
+        if(memcmp(extAddr, pData->deviceAddress, APIMAC_SADDR_EXT_LEN) == 0)
+        {
+            uint32_t now = Mactrace_now();
+
+            devShortAddr[i] = pData->assocShortAddress;
+            devJoined[i] = true;
+            addEvent(now + 5, macEvent_commStatus, i, 0);
+            addEvent(now + 3000 + (i * 11), macEvent_sensorData, i, 0);
+            if((i % 4) == 0)
+            {
+                addEvent(now + 1500, macEvent_pollInd, i, 0);
+            }
+        }
+    }
+
+    return (ApiMac_status_success);
+}
+
+ApiMac_status_t ApiMac_mlmeScanReq(ApiMac_mlmeScanReq_t *pData)
+{
+    if(replayMode == false)
+    {
+        addEvent(Mactrace_now() + 200, macEvent_scanCnf, 0,
+                 (uint8_t)pData->scanType);
+    }
+
+    return (ApiMac_status_success);
+}
+
+ApiMac_status_t ApiMac_mlmeStartReq(ApiMac_mlmeStartReq_t *pData)
+{
+    pibSet(ApiMac_attribute_panId, &pData->panId, sizeof(uint16_t));
+    pibSet(ApiMac_attribute_logicalChannel, &pData->logicalChannel,
+           sizeof(uint8_t));
+    if(replayMode == false)
+    {
+        addEvent(Mactrace_now() + 5, macEvent_startCnf, 0, 0);
+    }
+
+    return (ApiMac_status_success);
+}
+
+ApiMac_status_t ApiMac_startFH(void)
+{
+    return (ApiMac_status_success);
+}
+
+ApiMac_status_t ApiMac_mlmeDisassociateReq(
+                ApiMac_mlmeDisassociateReq_t *pData)
+{
+    (void)pData;
+
+    return (ApiMac_status_success);
+}
+
+ApiMac_status_t ApiMac_mlmeOrphanRsp(ApiMac_mlmeOrphanRsp_t *pData)
+{
+    (void)pData;
+
+    return (ApiMac_status_success);
+}
+
+ApiMac_status_t ApiMac_mlmeGetReqUint8(ApiMac_attribute_uint8_t pibAttribute,
+                                       uint8_t *pValue)
+{
+    *pValue = pibValue[pibAttribute][0];
+
+    return (ApiMac_status_success);
+}
+
+ApiMac_status_t ApiMac_mlmeGetReqMulti(ApiMac_mlmePibEntry_t *pEntries,
+                                       uint8_t numEntries)
+{
+    uint8_t i;
+
+    for(i = 0; i < numEntries; i++)
+    {
+        uint16_t len = pEntries[i].len;
+
+        if(len > PIB_VALUE_LEN)
+        {
+            len = PIB_VALUE_LEN;
+        }
+        memcpy(pEntries[i].pValue, pibValue[pEntries[i].attribute], len);
+        pEntries[i].len = len;
+        pEntries[i].status = ApiMac_status_success;
+    }
+
+    return (ApiMac_status_success);
+}
+
+ApiMac_status_t ApiMac_mlmeSetReqBool(ApiMac_attribute_bool_t pibAttribute,
+                                      bool value)
+{
+    pibSet(pibAttribute, &value, sizeof(bool));
+
+    return (ApiMac_status_success);
+}
+
+ApiMac_status_t ApiMac_mlmeSetReqUint8(ApiMac_attribute_uint8_t pibAttribute,
+                                       uint8_t value)
+{
+    pibSet(pibAttribute, &value, sizeof(uint8_t));
+
+    return (ApiMac_status_success);
+}
+
+ApiMac_status_t ApiMac_mlmeSetReqUint16(
+                ApiMac_attribute_uint16_t pibAttribute, uint16_t value)
+{
+    pibSet(pibAttribute, &value, sizeof(uint16_t));
+
+    return (ApiMac_status_success);
+}
+
+ApiMac_status_t ApiMac_mlmeSetReqArray(ApiMac_attribute_array_t pibAttribute,
+                                       uint8_t *pValue)
+{
+    pibSet(pibAttribute, pValue, APIMAC_SADDR_EXT_LEN);
+
+    return (ApiMac_status_success);
+}
+
+ApiMac_status_t ApiMac_mlmeSetReqMulti(ApiMac_mlmePibEntry_t *pEntries,
+                                       uint8_t numEntries)
+{
+    uint8_t i;
+
+    for(i = 0; i < numEntries; i++)
+    {
+        pibSet(pEntries[i].attribute, pEntries[i].pValue, pEntries[i].len);
+        pEntries[i].status = ApiMac_status_success;
+    }
+
+    return (ApiMac_status_success);
+}
+
+ApiMac_status_t ApiMac_mlmeSetFhReqUint8(
+                ApiMac_FHAttribute_uint8_t pibAttribute, uint8_t value)
+{
+    (void)pibAttribute;
+    (void)value;
+
+    return (ApiMac_status_success);
+}
+
+ApiMac_status_t ApiMac_mlmeSetFhReqUint16(
+                ApiMac_FHAttribute_uint16_t pibAttribute, uint16_t value)
+{
+    (void)pibAttribute;
+    (void)value;
+
+    return (ApiMac_status_success);
+}
+
+ApiMac_status_t ApiMac_mlmeSetFhReqArray(
+                ApiMac_FHAttribute_array_t pibAttribute, uint8_t *pValue)
+{
+    (void)pibAttribute;
+    (void)pValue;
+
+    return (ApiMac_status_success);
+}
+
+ApiMac_status_t ApiMac_mlmeSetSecurityReqArray(
+                ApiMac_securityAttribute_array_t pibAttribute,
+                uint8_t *pValue)
+{
+    (void)pibAttribute;
+    (void)pValue;
+
+    return (ApiMac_status_success);
+}
+
+ApiMac_status_t ApiMac_mlmeSetSecurityReqStruct(
+                ApiMac_securityAttribute_struct_t pibAttribute, void *pValue)
+{
+    (void)pibAttribute;
+    (void)pValue;
+
+    return (ApiMac_status_success);
+}
+
+ApiMac_status_t ApiMac_mlmeWSAsyncReq(ApiMac_mlmeWSAsyncReq_t *pData)
+{
+    (void)pData;
+
+    return (ApiMac_status_success);
+}
+
+ApiMac_status_t ApiMac_parsePayloadGroupIEs(uint8_t *pPayload,
+                                            uint16_t payloadLen,
+                                            ApiMac_payloadIeRec_t **pList)
+{
+    (void)pPayload;
+    (void)payloadLen;
+    *pList = NULL;
+
+    return (ApiMac_status_success);
+}
+
+ApiMac_status_t ApiMac_parsePayloadSubIEs(uint8_t *pPayload,
+                                          uint16_t payloadLen,
+                                          ApiMac_payloadIeRec_t **pList)
+{
+    (void)pPayload;
+    (void)payloadLen;
+    *pList = NULL;
+
+    return (ApiMac_status_success);
+}
+
+void ApiMac_freeIEList(ApiMac_payloadIeRec_t *pList)
+{
+    (void)pList;
+}
+
+ApiMac_status_t ApiMac_secAddDevice(ApiMac_secAddDevice_t *pAddDevice)
+{
+    (void)pAddDevice;
+
+    return (ApiMac_status_success);
+}
+
+ApiMac_status_t ApiMac_secAddDevices(ApiMac_secAddDevice_t *pAddDevices,
+                                     uint16_t numDevices,
+                                     ApiMac_status_t *pStatus)
+{
+    (void)pAddDevices;
+    (void)numDevices;
+    (void)pStatus;
+
+    return (ApiMac_status_success);
+}
+
+ApiMac_status_t ApiMac_secAddKeyInitFrameCounter(
+                ApiMac_secAddKeyInitFrameCounter_t *pInfo)
+{
+    (void)pInfo;
+
+    return (ApiMac_status_success);
+}
+
+char *ltoa(long value, uint8_t *pBuf, int radix)
+{
+    (void)radix;
+    sprintf((char *)pBuf, "%ld", value);
+
+    return ((char *)pBuf);
+}
+
+/******************************************************************************
+ Public Functions - Csf stand-ins, the clocks on timer.c
+ *****************************************************************************/
+
+void Csf_init(void *sem)
+{
+    (void)sem;
+}
+
+void Csf_processEvents(void)
+{
+}
+
+bool Csf_getNetworkInformation(Llc_netInfo_t *pInfo)
+{
+    (void)pInfo;
+
+    return (false);
+}
+
+void Csf_networkUpdate(bool restored, Llc_netInfo_t *pNetworkInfo)
+{
+    (void)restored;
+    (void)pNetworkInfo;
+}
+
+ApiMac_assocStatus_t Csf_deviceUpdate(ApiMac_deviceDescriptor_t *pDevInfo,
+                                      ApiMac_capabilityInfo_t *pCapInfo)
+{
+    if(numDevices < NUM_DEVICES)
+    {
+        deviceList[numDevices].devInfo = *pDevInfo;
+        deviceList[numDevices].capInfo = *pCapInfo;
+        numDevices++;
+    }
+
+    return (ApiMac_assocStatus_success);
+}
+
+void Csf_deviceNotActiveUpdate(ApiMac_deviceDescriptor_t *pDevInfo,
+                               bool timeout)
+{
+    (void)pDevInfo;
+    (void)timeout;
+}
+
+void Csf_deviceConfigUpdate(ApiMac_sAddr_t *pSrcAddr, int8_t rssi,
+                            Smsgs_configRspMsg_t *pMsg)
+{
+    (void)pSrcAddr;
+    (void)rssi;
+    (void)pMsg;
+}
+
+void Csf_deviceSensorDataUpdate(ApiMac_sAddr_t *pSrcAddr, int8_t rssi,
+                                Smsgs_sensorMsg_t *pMsg, uint32_t sampleAge)
+{
+    (void)pSrcAddr;
+    (void)rssi;
+    (void)pMsg;
+    (void)sampleAge;
+    sensorUpdates++;
+}
+
+void Csf_toggleResponseReceived(ApiMac_sAddr_t *pSrcAddr, bool ledState)
+{
+    (void)pSrcAddr;
+    (void)ledState;
+}
+
+void Csf_stateChangeUpdate(Cllc_states_t state)
+{
+    (void)state;
+}
+
+void Csf_initializeTrackingClock(void)
+{
+    Timer_construct(&trackingClk, trackingClockCB, 1000, 0, false, 0);
+}
+
+void Csf_initializeJoinPermitClock(void)
+{
+    Timer_construct(&joinClk, joinClockCB, 1000, 0, false, 0);
+}
+
+void Csf_initializeConfigClock(void)
+{
+    Timer_construct(&configClk, configClockCB, 1000, 0, false, 0);
+}
+
+void Csf_setTrackingClock(uint32_t trackingTime)
+{
+    setClock(&trackingClk, trackingTime);
+}
+
+void Csf_setTrickleClock(uint32_t trickleTime, uint8_t frameType)
+{
+    (void)trickleTime;
+    (void)frameType;
+}
+
+void Csf_setJoinPermitClock(uint32_t joinDuration)
+{
+    setClock(&joinClk, joinDuration);
+}
+
+void Csf_setConfigClock(uint32_t delay)
+{
+    setClock(&configClk, delay);
+}
+
+bool Csf_isConfigTimerActive(void)
+{
+    return (Timer_isActive(&configClk));
+}
+
+uint16_t Csf_getNumDeviceListEntries(void)
+{
+    return (numDevices);
+}
+
+uint16_t Csf_getDeviceShort(ApiMac_sAddrExt_t *pExtAddr)
+{
+    uint16_t i;
+
+    for(i = 0; i < numDevices; i++)
+    {
+        if(memcmp(deviceList[i].devInfo.extAddress, pExtAddr,
+                  APIMAC_SADDR_EXT_LEN) == 0)
+        {
+            return (deviceList[i].devInfo.shortAddress);
+        }
+    }
+
+    return (CSF_INVALID_SHORT_ADDR);
+}
+
+bool Csf_getDevice(ApiMac_sAddr_t *pDevAddr, Llc_deviceListItem_t *pItem)
+{
+    uint16_t i;
+
+    for(i = 0; i < numDevices; i++)
+    {
+        if(((pDevAddr->addrMode == ApiMac_addrType_short)
+            && (deviceList[i].devInfo.shortAddress
+                == pDevAddr->addr.shortAddr))
+           || ((pDevAddr->addrMode == ApiMac_addrType_extended)
+               && (memcmp(deviceList[i].devInfo.extAddress,
+                          pDevAddr->addr.extAddr, APIMAC_SADDR_EXT_LEN) == 0)))
+        {
+            if(pItem != NULL)
+            {
+                *pItem = deviceList[i];
+            }
+            return (true);
+        }
+    }
+
+    return (false);
+}
+
+bool Csf_getDeviceItem(uint16_t devIndex, Llc_deviceListItem_t *pItem)
+{
+    if(devIndex >= numDevices)
+    {
+        return (false);
+    }
+    *pItem = deviceList[devIndex];
+
+    return (true);
+}
+
+void *Csf_malloc(uint16_t size)
+{
+    return (ICall_malloc(size));
+}
+
+void Csf_free(void *ptr)
+{
+    ICall_free(ptr);
+}
+
+void Csf_updateFrameCounter(ApiMac_sAddr_t *pDevAddr, uint32_t frameCntr)
+{
+    (void)pDevAddr;
+    (void)frameCntr;
+}
+
+bool Csf_getFrameCounter(ApiMac_sAddr_t *pDevAddr, uint32_t *pFrameCntr)
+{
+    (void)pDevAddr;
+    *pFrameCntr = 0;
+
+    return (false);
+}
+
+void Csf_updateFleetConfig(Smsgs_configEpochMsg_t *pConfig)
+{
+    (void)pConfig;
+}
+
+bool Csf_getFleetConfig(Smsgs_configEpochMsg_t *pConfig)
+{
+    (void)pConfig;
+
+    return (false);
+}
+
+void Csf_removeDeviceListItem(ApiMac_sAddrExt_t *pAddr)
+{
+    (void)pAddr;
+}
+
+int main(int argc, char **argv)
+{
+    Mactrace_replayStats_t stats;
+    int status;
+    pid_t pid;
+
+    if((argc >= 3) && (strcmp(argv[1], "capture") == 0))
+    {
+        return (capture(argv[2], (argc > 3) ? (uint32_t)atol(argv[3])
+                        : CAPTURE_TIME));
+    }
+    if((argc >= 3) && (strcmp(argv[1], "replay") == 0))
+    {
+        return (replay(argv[2], (argc > 3) ? argv[3] : NULL, &stats));
+    }
+    if(argc != 1)
+    {
+        printf("usage: %s [capture <trace> [ms] | replay <trace> "
+               "[trace out]]\n", argv[0]);
+        return (2);
+    }
+
+    /* Capture in a child, then replay the capture into this collector */
+    fflush(stdout);
+    pid = fork();
+    if(pid == 0)
+    {
+        if(capture(CAPTURE_FILE, CAPTURE_TIME))
+        {
+            exit(1);
+        }
+        if(dataRequests == 0)
+        {
+            printf("FAIL: the collector sent no data requests\n");
+            exit(1);
+        }
+        exit(0);
+    }
+    if((pid < 0) || (waitpid(pid, &status, 0) != pid)
+       || (WIFEXITED(status) == 0) || (WEXITSTATUS(status) != 0))
+    {
+        return (1);
+    }
+
+    if(replay(CAPTURE_FILE, REPLAY_FILE, &stats)
+       || compareTraces(CAPTURE_FILE, REPLAY_FILE))
+    {
+        return (1);
+    }
+    if((stats.heapHighWater == 0) || (stats.heapInUse != 0))
+    {
+        printf("FAIL: heap high water %u, %u in use\n", stats.heapHighWater,
+               stats.heapInUse);
+        return (1);
+    }
+
+    return (0);
+}
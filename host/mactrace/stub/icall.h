@@ -0,0 +1,34 @@
+/******************************************************************************
+
+ @file icall.h
+
+ @brief Host stand-in for ICall: the critical sections of util.c, and the
+        heap, taken from the heap the MAC trace replay accounts.
+
+ *****************************************************************************/
+#ifndef ICALL_H
+#define ICALL_H
+
+#include <stdint.h>
+
+#include "mactrace.h"
+
+typedef int ICall_CSState;
+
+static inline ICall_CSState ICall_enterCriticalSection(void)
+{
+    return (0);
+}
+
+static inline void ICall_leaveCriticalSection(ICall_CSState key)
+{
+    (void)key;
+}
+
+#define ICall_malloc(size)      Mactrace_malloc(size)
+#define ICall_free(pMem)        Mactrace_free(pMem)
+
+/*! ltoa() of the TI run time library, used by util.c */
+extern char *ltoa(long value, uint8_t *pBuf, int radix);
+
+#endif /* ICALL_H */
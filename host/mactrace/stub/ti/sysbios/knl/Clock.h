@@ -0,0 +1,19 @@
+/******************************************************************************
+
+ @file Clock.h
+
+ @brief Host stand-in for the SYS/BIOS clock of indq.c, read from the
+        virtual clock of the MAC trace, one tick a millisecond.
+
+ *****************************************************************************/
+#ifndef ti_sysbios_knl_Clock__include
+#define ti_sysbios_knl_Clock__include
+
+#include <stdint.h>
+
+#include "mactrace.h"
+
+#define Clock_getTicks()        (Mactrace_now())
+#define Clock_tickPeriod        1000
+
+#endif /* ti_sysbios_knl_Clock__include */
@@ -0,0 +1,1276 @@
+/******************************************************************************
+
+ @file mtnv_test.c
+
+ @brief Host test of the MT SYS NV commands of the coprocessor, mt_sys.c,
+        on the NV driver nvoctp.c over simulated flash.
+
+        Rollback: NV Write Items over a list of new and existing items,
+        with a write, a read or an allocation failing at every point. With
+        the atomic option the NV items must be left as they were, without
+        it the items before the failure must be written. Bad lengths and
+        empty lists, and no allocation may be left after a command.
+
+        Loopback: a host backs up and restores NV images of 100 to 500
+        items over a model of the MT UART link, item by item with NV
+        Length, Read, Update, Create and Write, and in bulk with NV
+        Enumerate, Read Items and Write Items. Every image is read back and
+        compared. The exchanges, the bytes on the wire, the link time and
+        the device time are reported.
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+
+#include "api_mac.h"
+#include "hal_mcu.h"
+#include "macconfig.h"
+#include "nvintf.h"
+#include "nvoctp.h"
+
+#include "mt.h"
+#include "mt_rpc.h"
+#include "mt_sys.h"
+#include "util.h"
+
+/******************************************************************************
+ Constants and definitions
+ *****************************************************************************/
+
+/*! Simulated flash, the two NV pages from page SNV_FIRST_PAGE (0x1D) */
+#define FLASH_ADDR              0x1D000
+#define FLASH_SIZE              0x2000
+#define FLASH_PAGE              0x1000
+
+/*! Longest item, and most items of an NV image */
+#define ITEM_MAX                300
+#define IMAGE_MAX               600
+
+/*! MT command ID byte of an SYS SREQ */
+#define SYS_SREQ                (MTRPC_CMD_SREQ | MTRPC_SYS_SYS)
+
+/*! NV Write Items option, as mt_sys.c */
+#define NV_ATOMIC               0x01
+
+/*! Items of the rollback image, and of the rollback list */
+#define BASE_ITEMS              6
+#define LIST_ITEMS              8
+
+/*! Link: MT UART at 115200 baud, 10 bits a byte */
+#define LINK_BAUD               115200.0
+/*! Host and NPI task turnaround of each exchange */
+#define LINK_TURN_US            1000.0
+/*! UART frame around the data: SOF, length, command ID and FCS */
+#define LINK_FRAME_OVHD         5
+/*! Extended fragment acknowledgement: status, block and MT status */
+#define LINK_ACK_LEN            3
+
+/*! Most data of an NV Read, NV Write and NV Update */
+#define READ_CHUNK              248
+#define WRITE_CHUNK             242
+#define UPDATE_MAX              244
+
+/*! Items listed by an NV Enumerate, and read by an NV Read Items */
+#define ENUM_COUNT              32
+#define READ_ITEMS_COUNT        49
+
+/*! Longest NV Write Items command of the bulk restore */
+#define WRITE_ITEMS_MAX         1024
+
+/*! Length of an item ID, and of an NV Write Items entry header */
+#define ID_LEN                  5
+#define ENTRY_HDR_LEN           (ID_LEN + 2)
+
+/*! NV item */
+typedef struct
+{
+    NVINTF_itemID_t id;
+    uint16_t len;
+    uint8_t data[ITEM_MAX];
+} item_t;
+
+/*! NV image, items in order of ID */
+typedef struct
+{
+    uint16_t count;
+    item_t items[IMAGE_MAX];
+} image_t;
+
+/*! Item of the rollback list: item ID, sub ID and length */
+typedef struct
+{
+    uint16_t itemID;
+    uint16_t subID;
+    uint16_t len;
+} plan_t;
+
+/******************************************************************************
+ Global Variables
+ *****************************************************************************/
+
+/*! MAC configuration, the NV functions of mt_sys.c */
+mac_Config_t Main_user1Cfg;
+
+/******************************************************************************
+ Local Variables
+ *****************************************************************************/
+
+/*! Rollback list: the existing items 0x20 and new items 0x21, one twice */
+static const plan_t rollbackPlan[LIST_ITEMS] =
+{
+    { 0x20, 0, 8 },     /* Same length */
+    { 0x21, 0, 5 },     /* New */
+    { 0x20, 2, 20 },    /* Longer */
+    { 0x21, 1, 40 },    /* New */
+    { 0x20, 4, 3 },     /* Shorter */
+    { 0x20, 0, 9 },     /* Again */
+    { 0x21, 2, 1 },     /* New */
+    { 0x20, 5, 13 },    /* Same length */
+};
+
+/*! NV driver functions of nvoctp.c, without the faults */
+static NVINTF_nvFuncts_t nvDrv;
+
+/*! Calls to fail, counted from armFaults(), 0 for none */
+static uint32_t writeFail;
+static uint32_t readFail;
+static uint32_t mallocFail;
+
+/*! Calls since armFaults() */
+static uint32_t writeCalls;
+static uint32_t readCalls;
+static uint32_t mallocCalls;
+
+/*! Allocations not freed */
+static int32_t liveAllocs;
+
+/*! Last response sent */
+static uint8_t rsp[2048];
+static uint16_t rspLen;
+static uint8_t rspCmd;
+
+/*! Link and device counts */
+static uint32_t exchanges;
+static uint32_t wireBytes;
+static uint64_t deviceNs;
+
+/*! Command buffer */
+static uint8_t req[2048];
+
+/*! NV images */
+static image_t src;
+static image_t got;
+static image_t expect;
+
+/*! Pseudo random state */
+static uint32_t randState = 1;
+
+/******************************************************************************
+ Local Functions
+ *****************************************************************************/
+
+/*!
+ * @brief       Read a monotonic clock.
+ *
+ * @return      time, in nanoseconds
+ */
+static uint64_t readNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (((uint64_t)ts.tv_sec * 1000000000u) + (uint64_t)ts.tv_nsec);
+}
+
+/*!
+ * @brief       Pseudo random number.
+ *
+ * @param       range - numbers from 0 to range - 1
+ *
+ * @return      number
+ */
+static uint32_t randomRange(uint32_t range)
+{
+    randState = (randState * 1103515245u) + 12345u;
+
+    return ((randState >> 8) % range);
+}
+
+/*!
+ * @brief       Pseudo random byte.
+ *
+ * @return      byte
+ */
+static uint8_t randomByte(void)
+{
+    return ((uint8_t)(randomRange(1u << 24) >> 16));
+}
+
+/*!
+ * @brief       Write-item of the NV functions, failing when armed.
+ */
+static uint8_t faultWriteItem(NVINTF_itemID_t id, uint16_t bLen, void *pBuf)
+{
+    if(++writeCalls == writeFail)
+    {
+        return (NVINTF_FAILURE);
+    }
+
+    return (nvDrv.writeItem(id, bLen, pBuf));
+}
+
+/*!
+ * @brief       Read-item of the NV functions, failing when armed.
+ */
+static uint8_t faultReadItem(NVINTF_itemID_t id, uint16_t ofs, uint16_t bLen,
+                             void *pBuf)
+{
+    if(++readCalls == readFail)
+    {
+        return (NVINTF_FAILURE);
+    }
+
+    return (nvDrv.readItem(id, ofs, bLen, pBuf));
+}
+
+/*!
+ * @brief       Fail a call of the NV functions or of the heap.
+ *
+ * @param       write - write-item call to fail, 0 for none
+ * @param       read - read-item call to fail, 0 for none
+ * @param       alloc - allocation to fail, 0 for none
+ */
+static void armFaults(uint32_t write, uint32_t read, uint32_t alloc)
+{
+    writeFail = write;
+    readFail = read;
+    mallocFail = alloc;
+    writeCalls = 0;
+    readCalls = 0;
+    mallocCalls = 0;
+}
+
+/*!
+ * @brief       Erase the flash and start the NV driver on it.
+ */
+static void nvFresh(void)
+{
+    memset((void *)(uintptr_t)FLASH_ADDR, 0xFF, FLASH_SIZE);
+
+    NVOCTP_loadApiPtrs(&nvDrv);
+    (void)nvDrv.initNV(NULL);
+
+    Main_user1Cfg.nvFps = nvDrv;
+    Main_user1Cfg.nvFps.writeItem = faultWriteItem;
+    Main_user1Cfg.nvFps.readItem = faultReadItem;
+    armFaults(0, 0, 0);
+}
+
+/*!
+ * @brief       Order of two item IDs: system ID, item ID and sub ID.
+ *
+ * @return      < 0, 0 or > 0
+ */
+static int idCmp(const NVINTF_itemID_t *pA, const NVINTF_itemID_t *pB)
+{
+    if(pA->systemID != pB->systemID)
+    {
+        return ((int)pA->systemID - (int)pB->systemID);
+    }
+    if(pA->itemID != pB->itemID)
+    {
+        return ((int)pA->itemID - (int)pB->itemID);
+    }
+
+    return ((int)pA->subID - (int)pB->subID);
+}
+
+/*!
+ * @brief       Order of two items, for qsort().
+ */
+static int itemCmp(const void *pA, const void *pB)
+{
+    return (idCmp(&((const item_t *)pA)->id, &((const item_t *)pB)->id));
+}
+
+/*!
+ * @brief       Write an item into an image, in order of ID.
+ *
+ * @param       pImage - image
+ * @param       pItem - item
+ */
+static void imagePut(image_t *pImage, const item_t *pItem)
+{
+    uint16_t i;
+
+    for(i = 0; i < pImage->count; i++)
+    {
+        int cmp = idCmp(&pImage->items[i].id, &pItem->id);
+
+        if(cmp == 0)
+        {
+            pImage->items[i] = *pItem;
+            return;
+        }
+        if(cmp > 0)
+        {
+            break;
+        }
+    }
+
+    memmove(&pImage->items[i + 1], &pImage->items[i],
+            (pImage->count - i) * sizeof(item_t));
+    pImage->items[i] = *pItem;
+    pImage->count++;
+}
+
+/*!
+ * @brief       Compare two images.
+ *
+ * @return      0 if the same, else the first item that differs plus 1
+ */
+static uint16_t imageCmp(const image_t *pA, const image_t *pB)
+{
+    uint16_t i;
+
+    for(i = 0; (i < pA->count) && (i < pB->count); i++)
+    {
+        const item_t *pItemA = &pA->items[i];
+        const item_t *pItemB = &pB->items[i];
+
+        if((idCmp(&pItemA->id, &pItemB->id) != 0)
+           || (pItemA->len != pItemB->len)
+           || (memcmp(pItemA->data, pItemB->data, pItemA->len) != 0))
+        {
+            return (i + 1);
+        }
+    }
+
+    return ((pA->count == pB->count) ? 0 : (i + 1));
+}
+
+/*!
+ * @brief       Read the NV items, but those of the NV driver, without MT.
+ *
+ * @param       pImage - image read
+ *
+ * @return      0 on success, 1 on a failure
+ */
+static int nvSnapshot(image_t *pImage)
+{
+    NVINTF_itemID_t start = { 0, 0, 0 };
+    NVINTF_itemID_t ids[ENUM_COUNT];
+    uint16_t lens[ENUM_COUNT];
+    uint8_t count;
+    uint8_t i;
+
+    pImage->count = 0;
+    do
+    {
+        count = NVOCTP_listItems(&start, ids, lens, ENUM_COUNT);
+        for(i = 0; i < count; i++)
+        {
+            item_t *pItem = &pImage->items[pImage->count];
+
+            if(ids[i].systemID == NVINTF_SYSID_NVDRVR)
+            {
+                continue;
+            }
+            if((pImage->count >= IMAGE_MAX) || (lens[i] > ITEM_MAX)
+               || (nvDrv.readItem(ids[i], 0, lens[i], pItem->data)
+                   != NVINTF_SUCCESS))
+            {
+                printf("FAIL: NV item %u/%u/%u of %u bytes not read\n",
+                       ids[i].systemID, ids[i].itemID, ids[i].subID, lens[i]);
+                return (1);
+            }
+            pItem->id = ids[i];
+            pItem->len = lens[i];
+            pImage->count++;
+        }
+    } while(count == ENUM_COUNT);
+
+    return (0);
+}
+
+/*!
+ * @brief       Write an image into NV, item by item, without MT.
+ *
+ * @param       pImage - image
+ */
+static void nvLoad(const image_t *pImage)
+{
+    uint16_t i;
+
+    for(i = 0; i < pImage->count; i++)
+    {
+        (void)nvDrv.writeItem(pImage->items[i].id, pImage->items[i].len,
+                              (void *)pImage->items[i].data);
+    }
+}
+
+/*!
+ * @brief       Count an MT frame on the link. Longer than an MT frame, it
+ *              is sent in fragments, each answered by an acknowledgement.
+ *
+ * @param       len - data length
+ */
+static void linkFrame(uint16_t len)
+{
+    uint16_t frags;
+
+    if(len <= MTRPC_DATA_MAX)
+    {
+        wireBytes += len + LINK_FRAME_OVHD;
+        return;
+    }
+
+    frags = (len + MTRPC_FRAG_MAX - 1) / MTRPC_FRAG_MAX;
+    wireBytes += len + (frags * (LINK_FRAME_OVHD + MTRPC_FRAG_HDR_SZ))
+                 + (frags * (LINK_FRAME_OVHD + LINK_ACK_LEN));
+    exchanges += frags - 1;
+}
+
+/*!
+ * @brief       Time on the link of the frames counted.
+ *
+ * @return      time, in milliseconds
+ */
+static double linkMs(void)
+{
+    return ((wireBytes * 10 * 1000.0 / LINK_BAUD)
+            + (exchanges * LINK_TURN_US / 1000.0));
+}
+
+/*!
+ * @brief       Clear the link and device counts.
+ */
+static void linkReset(void)
+{
+    exchanges = 0;
+    wireBytes = 0;
+    deviceNs = 0;
+}
+
+/*!
+ * @brief       Send an SYS SREQ to mt_sys.c, and take its response.
+ *
+ * @param       cmd - command ID
+ * @param       len - length of the command in req[]
+ *
+ * @return      0 on success, 1 if not answered or an allocation is left
+ */
+static int sreq(uint8_t cmd, uint16_t len)
+{
+    Mt_mpb_t mpb;
+    uint64_t start;
+
+    memset(&mpb, 0, sizeof(mpb));
+    mpb.cmd0 = SYS_SREQ;
+    mpb.cmd1 = cmd;
+    mpb.length = len;
+    mpb.pData = req;
+
+    linkFrame(len);
+    exchanges++;
+    rspCmd = 0;
+
+    start = readNs();
+    (void)MtSys_commandProcessing(&mpb);
+    deviceNs += readNs() - start;
+
+    if(rspCmd != cmd)
+    {
+        printf("FAIL: command 0x%02X not answered\n", cmd);
+        return (1);
+    }
+    if(liveAllocs != 0)
+    {
+        printf("FAIL: command 0x%02X left %d allocations\n", cmd, liveAllocs);
+        return (1);
+    }
+
+    return (0);
+}
+
+/*!
+ * @brief       Serialize an item ID.
+ *
+ * @return      next byte
+ */
+static uint8_t *putId(uint8_t *pBuf, NVINTF_itemID_t id)
+{
+    *pBuf++ = id.systemID;
+    pBuf = Util_bufferUint16(pBuf, id.itemID);
+
+    return (Util_bufferUint16(pBuf, id.subID));
+}
+
+/*!
+ * @brief       Build an NV Write Items command in req[].
+ *
+ * @param       options - options
+ * @param       pItems - items
+ * @param       count - number of items
+ *
+ * @return      command length
+ */
+static uint16_t buildWriteItems(uint8_t options, const item_t *pItems,
+                                uint8_t count)
+{
+    uint8_t *pBuf = &req[2];
+    uint8_t i;
+
+    req[0] = options;
+    req[1] = count;
+    for(i = 0; i < count; i++)
+    {
+        pBuf = putId(pBuf, pItems[i].id);
+        pBuf = Util_bufferUint16(pBuf, pItems[i].len);
+        memcpy(pBuf, pItems[i].data, pItems[i].len);
+        pBuf += pItems[i].len;
+    }
+
+    return ((uint16_t)(pBuf - req));
+}
+
+/*!
+ * @brief       Check an NV Write Items response and the NV items after it.
+ *
+ * @param       what - failure, for the report
+ * @param       status - status expected
+ * @param       count - items written expected
+ * @param       pExpect - NV items expected
+ *
+ * @return      0 on success, 1 on a failure
+ */
+static int checkWriteItems(const char *what, uint8_t status, uint8_t count,
+                           const image_t *pExpect)
+{
+    uint16_t diff;
+
+    if((rspLen != 2) || (rsp[0] != status) || (rsp[1] != count))
+    {
+        printf("FAIL: %s: status 0x%02X, %u written, 0x%02X and %u "
+               "expected\n", what, rsp[0], rsp[1], status, count);
+        return (1);
+    }
+    if(nvSnapshot(&got) != 0)
+    {
+        return (1);
+    }
+    diff = imageCmp(&got, pExpect);
+    if(diff != 0)
+    {
+        printf("FAIL: %s: NV item %u of %u differs, %u expected\n", what,
+               diff - 1, got.count, pExpect->count);
+        return (1);
+    }
+
+    return (0);
+}
+
+/*!
+ * @brief       NV Write Items with a write, a read or an allocation failing
+ *              at every point, atomic and not.
+ *
+ * @return      0 on success, 1 on a failure
+ */
+static int checkRollback(void)
+{
+    static image_t base;
+    item_t list[LIST_ITEMS];
+    uint32_t allocs;
+    uint16_t len;
+    uint8_t atomic;
+    uint8_t k;
+    uint8_t i;
+    char what[64];
+
+    /* The existing items, and the list written over them */
+    base.count = 0;
+    for(i = 0; i < BASE_ITEMS; i++)
+    {
+        item_t item;
+
+        item.id.systemID = NVINTF_SYSID_APP;
+        item.id.itemID = 0x20;
+        item.id.subID = i;
+        item.len = 8 + (i * 3);
+        for(len = 0; len < item.len; len++)
+        {
+            item.data[len] = randomByte();
+        }
+        imagePut(&base, &item);
+    }
+    for(i = 0; i < LIST_ITEMS; i++)
+    {
+        list[i].id.systemID = NVINTF_SYSID_APP;
+        list[i].id.itemID = rollbackPlan[i].itemID;
+        list[i].id.subID = rollbackPlan[i].subID;
+        list[i].len = rollbackPlan[i].len;
+        for(len = 0; len < list[i].len; len++)
+        {
+            list[i].data[len] = randomByte();
+        }
+    }
+
+    /* The write of item k fails, k = LIST_ITEMS for none */
+    for(atomic = 0; atomic < 2; atomic++)
+    {
+        for(k = 0; k <= LIST_ITEMS; k++)
+        {
+            bool failed = (k < LIST_ITEMS);
+
+            nvFresh();
+            nvLoad(&base);
+
+            expect = base;
+            if(!atomic || !failed)
+            {
+                for(i = 0; i < k; i++)
+                {
+                    imagePut(&expect, &list[i]);
+                }
+            }
+
+            len = buildWriteItems(atomic ? NV_ATOMIC : 0, list, LIST_ITEMS);
+            armFaults(failed ? (k + 1) : 0, 0, 0);
+            if(sreq(MT_SYS_NV_WRITE_ITEMS, len) != 0)
+            {
+                return (1);
+            }
+            armFaults(0, 0, 0);
+
+            sprintf(what, "atomic %u, write %u failed", atomic, k);
+            if(checkWriteItems(what,
+                               failed ? ApiMac_status_unsupported
+                                      : ApiMac_status_success,
+                               (atomic && failed) ? 0 : k, &expect) != 0)
+            {
+                return (1);
+            }
+        }
+    }
+
+    /* Saving the items: a read fails, nothing is written */
+    for(k = 0; k < LIST_ITEMS; k++)
+    {
+        nvFresh();
+        nvLoad(&base);
+
+        len = buildWriteItems(NV_ATOMIC, list, LIST_ITEMS);
+        armFaults(0, k + 1, 0);
+        if(sreq(MT_SYS_NV_WRITE_ITEMS, len) != 0)
+        {
+            return (1);
+        }
+        if(writeCalls != 0)
+        {
+            printf("FAIL: read %u failed, %u items written\n", k, writeCalls);
+            return (1);
+        }
+        armFaults(0, 0, 0);
+
+        sprintf(what, "read %u failed", k);
+        if(checkWriteItems(what, ApiMac_status_unsupported, 0, &base) != 0)
+        {
+            return (1);
+        }
+    }
+
+    /* Saving the items: an allocation fails, nothing is written */
+    nvFresh();
+    nvLoad(&base);
+    len = buildWriteItems(NV_ATOMIC, list, LIST_ITEMS);
+    if(sreq(MT_SYS_NV_WRITE_ITEMS, len) != 0)
+    {
+        return (1);
+    }
+    allocs = mallocCalls;
+    for(k = 0; k < allocs; k++)
+    {
+        nvFresh();
+        nvLoad(&base);
+
+        len = buildWriteItems(NV_ATOMIC, list, LIST_ITEMS);
+        armFaults(0, 0, k + 1);
+        if(sreq(MT_SYS_NV_WRITE_ITEMS, len) != 0)
+        {
+            return (1);
+        }
+        if(writeCalls != 0)
+        {
+            printf("FAIL: allocation %u failed, %u items written\n", k,
+                   writeCalls);
+            return (1);
+        }
+        armFaults(0, 0, 0);
+
+        sprintf(what, "allocation %u failed", k);
+        if(checkWriteItems(what, ApiMac_status_noResources, 0, &base) != 0)
+        {
+            return (1);
+        }
+    }
+
+    /* Bad lengths and empty lists write nothing */
+    nvFresh();
+    nvLoad(&base);
+    len = buildWriteItems(NV_ATOMIC, list, LIST_ITEMS);
+    req[1] = LIST_ITEMS + 1;
+    if((sreq(MT_SYS_NV_WRITE_ITEMS, len) != 0)
+       || (checkWriteItems("count too high", ApiMac_status_lengthError, 0,
+                           &base) != 0))
+    {
+        return (1);
+    }
+    req[1] = LIST_ITEMS;
+    if((sreq(MT_SYS_NV_WRITE_ITEMS, len - 1) != 0)
+       || (checkWriteItems("list short", ApiMac_status_lengthError, 0,
+                           &base) != 0))
+    {
+        return (1);
+    }
+    if((sreq(MT_SYS_NV_WRITE_ITEMS, 1) != 0)
+       || (checkWriteItems("no count", ApiMac_status_lengthError, 0,
+                           &base) != 0))
+    {
+        return (1);
+    }
+    len = buildWriteItems(NV_ATOMIC, list, 0);
+    if((sreq(MT_SYS_NV_WRITE_ITEMS, len) != 0)
+       || (checkWriteItems("empty list", ApiMac_status_success, 0,
+                           &base) != 0))
+    {
+        return (1);
+    }
+
+    req[0] = 0;
+    if((sreq(MT_SYS_NV_READ_ITEMS, 1) != 0) || (rsp[0] != ApiMac_status_success)
+       || (rsp[1] != 0))
+    {
+        printf("FAIL: empty read items, status 0x%02X count %u\n", rsp[0],
+               rsp[1]);
+        return (1);
+    }
+    req[0] = 2;
+    len = (uint16_t)(putId(&req[1], list[0].id) - req);
+    if((sreq(MT_SYS_NV_READ_ITEMS, len) != 0)
+       || (rsp[0] != ApiMac_status_lengthError))
+    {
+        printf("FAIL: short read items, status 0x%02X\n", rsp[0]);
+        return (1);
+    }
+
+    printf("write items rollback: %u write, %u read and %u allocation "
+           "failures, NV as expected\n", (LIST_ITEMS + 1) * 2, LIST_ITEMS,
+           allocs);
+
+    return (0);
+}
+
+/*!
+ * @brief       Back up item by item: NV Length and NV Read of each item of
+ *              a known image.
+ *
+ * @param       pIds - image of the items to read
+ * @param       pOut - image read
+ *
+ * @return      0 on success, 1 on a failure
+ */
+static int backupPerItem(const image_t *pIds, image_t *pOut)
+{
+    uint16_t i;
+
+    pOut->count = 0;
+    for(i = 0; i < pIds->count; i++)
+    {
+        item_t *pItem = &pOut->items[i];
+        uint16_t ofs;
+
+        pItem->id = pIds->items[i].id;
+        (void)putId(req, pItem->id);
+        if(sreq(MT_SYS_NV_LENGTH, ID_LEN) != 0)
+        {
+            return (1);
+        }
+        pItem->len = (uint16_t)Util_parseUint32(rsp);
+
+        for(ofs = 0; ofs < pItem->len; ofs += rsp[1])
+        {
+            uint16_t chunk = pItem->len - ofs;
+            uint8_t *pBuf;
+
+            if(chunk > READ_CHUNK)
+            {
+                chunk = READ_CHUNK;
+            }
+            pBuf = putId(req, pItem->id);
+            pBuf = Util_bufferUint16(pBuf, ofs);
+            *pBuf++ = (uint8_t)chunk;
+            if(sreq(MT_SYS_NV_READ, (uint16_t)(pBuf - req)) != 0)
+            {
+                return (1);
+            }
+            if((rsp[0] != ApiMac_status_success) || (rsp[1] != chunk))
+            {
+                printf("FAIL: NV read status 0x%02X\n", rsp[0]);
+                return (1);
+            }
+            memcpy(&pItem->data[ofs], &rsp[2], chunk);
+        }
+        pOut->count++;
+    }
+
+    return (0);
+}
+
+/*!
+ * @brief       Restore item by item: NV Update of the short items, NV
+ *              Create and NV Write of the others.
+ *
+ * @param       pImage - image
+ *
+ * @return      0 on success, 1 on a failure
+ */
+static int restorePerItem(const image_t *pImage)
+{
+    uint16_t i;
+
+    for(i = 0; i < pImage->count; i++)
+    {
+        const item_t *pItem = &pImage->items[i];
+        uint8_t *pBuf = putId(req, pItem->id);
+        uint16_t ofs;
+
+        if(pItem->len <= UPDATE_MAX)
+        {
+            *pBuf++ = (uint8_t)pItem->len;
+            memcpy(pBuf, pItem->data, pItem->len);
+            pBuf += pItem->len;
+            if((sreq(MT_SYS_NV_UPDATE, (uint16_t)(pBuf - req)) != 0)
+               || (rsp[0] != ApiMac_status_success))
+            {
+                printf("FAIL: NV update status 0x%02X\n", rsp[0]);
+                return (1);
+            }
+            continue;
+        }
+
+        pBuf = Util_bufferUint32(pBuf, pItem->len);
+        if(sreq(MT_SYS_NV_CREATE, (uint16_t)(pBuf - req)) != 0)
+        {
+            return (1);
+        }
+        for(ofs = 0; ofs < pItem->len; )
+        {
+            uint16_t chunk = pItem->len - ofs;
+
+            if(chunk > WRITE_CHUNK)
+            {
+                chunk = WRITE_CHUNK;
+            }
+            pBuf = putId(req, pItem->id);
+            pBuf = Util_bufferUint16(pBuf, ofs);
+            *pBuf++ = (uint8_t)chunk;
+            memcpy(pBuf, &pItem->data[ofs], chunk);
+            pBuf += chunk;
+            if((sreq(MT_SYS_NV_WRITE, (uint16_t)(pBuf - req)) != 0)
+               || (rsp[0] != ApiMac_status_success))
+            {
+                printf("FAIL: NV write status 0x%02X\n", rsp[0]);
+                return (1);
+            }
+            ofs += chunk;
+        }
+    }
+
+    return (0);
+}
+
+/*!
+ * @brief       Back up in bulk: NV Enumerate, then NV Read Items. The items
+ *              of the NV driver are listed and read too, then left out.
+ *
+ * @param       pOut - image read
+ *
+ * @return      0 on success, 1 on a failure
+ */
+static int backupBulk(image_t *pOut)
+{
+    NVINTF_itemID_t start = { 0, 0, 0 };
+    uint16_t listed = 0;
+    uint16_t i;
+    uint8_t count;
+
+    do
+    {
+        uint8_t *pBuf = putId(req, start);
+
+        *pBuf++ = ENUM_COUNT;
+        if((sreq(MT_SYS_NV_ENUM, (uint16_t)(pBuf - req)) != 0)
+           || (rsp[0] != ApiMac_status_success))
+        {
+            printf("FAIL: NV enumerate status 0x%02X\n", rsp[0]);
+            return (1);
+        }
+        count = rsp[1];
+        start.systemID = rsp[2];
+        start.itemID = Util_parseUint16(&rsp[3]);
+        start.subID = Util_parseUint16(&rsp[5]);
+
+        pBuf = &rsp[7];
+        for(i = 0; i < count; i++, listed++)
+        {
+            item_t *pItem = &pOut->items[listed];
+
+            pItem->id.systemID = pBuf[0];
+            pItem->id.itemID = Util_parseUint16(&pBuf[1]);
+            pItem->id.subID = Util_parseUint16(&pBuf[3]);
+            pItem->len = Util_parseUint16(&pBuf[5]);
+            pBuf += ID_LEN + 2;
+        }
+    } while(count == ENUM_COUNT);
+
+    for(i = 0; i < listed; )
+    {
+        uint8_t *pBuf = &req[1];
+        uint8_t j;
+
+        count = ((listed - i) > READ_ITEMS_COUNT) ? READ_ITEMS_COUNT
+                                                  : (listed - i);
+        req[0] = count;
+        for(j = 0; j < count; j++)
+        {
+            pBuf = putId(pBuf, pOut->items[i + j].id);
+        }
+        if((sreq(MT_SYS_NV_READ_ITEMS, (uint16_t)(pBuf - req)) != 0)
+           || (rsp[0] != ApiMac_status_success) || (rsp[1] == 0))
+        {
+            printf("FAIL: NV read items status 0x%02X\n", rsp[0]);
+            return (1);
+        }
+
+        pBuf = &rsp[2];
+        for(j = 0; j < rsp[1]; j++)
+        {
+            item_t *pItem = &pOut->items[i + j];
+            uint16_t len = Util_parseUint16(&pBuf[1]);
+
+            if((pBuf[0] != ApiMac_status_success) || (len != pItem->len))
+            {
+                printf("FAIL: NV read items, item status 0x%02X\n", pBuf[0]);
+                return (1);
+            }
+            memcpy(pItem->data, &pBuf[3], len);
+            pBuf += 3 + len;
+        }
+        i += rsp[1];
+    }
+
+    /* Leave out the items of the NV driver */
+    pOut->count = 0;
+    for(i = 0; i < listed; i++)
+    {
+        if(pOut->items[i].id.systemID != NVINTF_SYSID_NVDRVR)
+        {
+            pOut->items[pOut->count++] = pOut->items[i];
+        }
+    }
+
+    return (0);
+}
+
+/*!
+ * @brief       Restore in bulk: NV Write Items of up to WRITE_ITEMS_MAX
+ *              bytes.
+ *
+ * @param       pImage - image
+ * @param       options - NV Write Items options
+ *
+ * @return      0 on success, 1 on a failure
+ */
+static int restoreBulk(const image_t *pImage, uint8_t options)
+{
+    uint16_t i;
+
+    for(i = 0; i < pImage->count; )
+    {
+        uint16_t len = 2;
+        uint8_t count = 0;
+
+        while(((i + count) < pImage->count) && (count < 255)
+              && ((len + ENTRY_HDR_LEN + pImage->items[i + count].len)
+                  <= WRITE_ITEMS_MAX))
+        {
+            len += ENTRY_HDR_LEN + pImage->items[i + count].len;
+            count++;
+        }
+
+        len = buildWriteItems(options, &pImage->items[i], count);
+        if((sreq(MT_SYS_NV_WRITE_ITEMS, len) != 0)
+           || (rsp[0] != ApiMac_status_success) || (rsp[1] != count))
+        {
+            printf("FAIL: NV write items status 0x%02X, %u of %u\n", rsp[0],
+                   rsp[1], count);
+            return (1);
+        }
+        i += count;
+    }
+
+    return (0);
+}
+
+/*!
+ * @brief       Print the link and device counts.
+ */
+static void printLink(void)
+{
+    printf(" %5u %7u %8.1f %7.0f |", exchanges, wireBytes, linkMs(),
+           (double)deviceNs / 1000.0);
+}
+
+/*!
+ * @brief       Build an NV image like the device tables of the apps: short
+ *              items, and with few items a long one every 50. The two
+ *              4 kB pages of the NV driver limit what fits.
+ *
+ * @param       count - number of items
+ *
+ * @return      bytes of data
+ */
+static uint32_t buildImage(uint16_t count)
+{
+    uint32_t total = 0;
+    uint16_t i;
+
+    src.count = count;
+    for(i = 0; i < count; i++)
+    {
+        item_t *pItem = &src.items[i];
+        uint16_t j;
+
+        pItem->id.systemID = NVINTF_SYSID_APP;
+        pItem->id.itemID = 0x10 + (i % 4);
+        pItem->id.subID = i / 4;
+        if((count <= 200) && ((i % 50) == 7))
+        {
+            pItem->len = ITEM_MAX;
+        }
+        else if(count >= 400)
+        {
+            pItem->len = 1 + randomRange(3);
+        }
+        else
+        {
+            pItem->len = 4 + randomRange(9);
+        }
+        for(j = 0; j < pItem->len; j++)
+        {
+            pItem->data[j] = randomByte();
+        }
+        total += pItem->len;
+    }
+    qsort(src.items, src.count, sizeof(item_t), itemCmp);
+
+    return (total);
+}
+
+/*!
+ * @brief       Back up and restore NV images item by item and in bulk.
+ *
+ * @return      0 on success, 1 on a failure
+ */
+static int runLoopback(void)
+{
+    static const uint16_t sizes[] = { 100, 200, 300, 400, 500 };
+    uint8_t s;
+
+    printf("items bytes path     | backup: xchg  wire B  link ms  dev us |"
+           " restore: xchg  wire B  link ms  dev us |\n");
+
+    for(s = 0; s < (sizeof(sizes) / sizeof(sizes[0])); s++)
+    {
+        uint32_t total = buildImage(sizes[s]);
+        uint8_t bulk;
+
+        for(bulk = 0; bulk < 2; bulk++)
+        {
+            int err;
+            uint16_t diff;
+
+            /* The app wrote the items one by one */
+            nvFresh();
+            nvLoad(&src);
+
+            printf("%5u %5u %-8s |        ", src.count, total,
+                   bulk ? "bulk" : "per-item");
+            linkReset();
+            err = bulk ? backupBulk(&got) : backupPerItem(&src, &got);
+            if(err != 0)
+            {
+                return (1);
+            }
+            printLink();
+            diff = imageCmp(&got, &src);
+            if(diff != 0)
+            {
+                printf("\nFAIL: backup item %u of %u differs\n", diff - 1,
+                       got.count);
+                return (1);
+            }
+
+            nvFresh();
+            printf("         ");
+            linkReset();
+            err = bulk ? restoreBulk(&src, 0) : restorePerItem(&src);
+            if(err != 0)
+            {
+                return (1);
+            }
+            printLink();
+            printf("\n");
+            if(nvSnapshot(&got) != 0)
+            {
+                return (1);
+            }
+            diff = imageCmp(&got, &src);
+            if(diff != 0)
+            {
+                printf("FAIL: restored item %u of %u differs\n", diff - 1,
+                       got.count);
+                return (1);
+            }
+        }
+    }
+
+    /* Atomic restore over the same items */
+    buildImage(300);
+    nvFresh();
+    nvLoad(&src);
+    linkReset();
+    if(restoreBulk(&src, NV_ATOMIC) != 0)
+    {
+        return (1);
+    }
+    printf("atomic bulk restore of %u items over them: %u exchanges, "
+           "%.1f ms link, %.0f us device\n", src.count, exchanges, linkMs(),
+           (double)deviceNs / 1000.0);
+    if((nvSnapshot(&got) != 0) || (imageCmp(&got, &src) != 0))
+    {
+        printf("FAIL: atomic restore differs\n");
+        return (1);
+    }
+
+    return (0);
+}
+
+/******************************************************************************
+ Public Functions
+ *****************************************************************************/
+
+/*!
+ * @brief       Flash program of the NV driver: bits only go from 1 to 0.
+ */
+uint32_t FlashProgram(uint8_t *pBuf, uint32_t addr, uint32_t count)
+{
+    uint8_t *pFlash = (uint8_t *)(uintptr_t)addr;
+
+    while(count--)
+    {
+        *pFlash++ &= *pBuf++;
+    }
+
+    return (FAPI_STATUS_SUCCESS);
+}
+
+/*!
+ * @brief       Flash sector erase of the NV driver.
+ */
+uint32_t FlashSectorErase(uint32_t addr)
+{
+    memset((void *)(uintptr_t)(addr & ~(FLASH_PAGE - 1)), 0xFF, FLASH_PAGE);
+
+    return (FAPI_STATUS_SUCCESS);
+}
+
+/*!
+ * @brief       ICall heap, counted, failing when armed.
+ */
+void *ICall_malloc(size_t size)
+{
+    if(++mallocCalls == mallocFail)
+    {
+        return (NULL);
+    }
+
+    liveAllocs++;
+    return (malloc(size ? size : 1));
+}
+
+/*!
+ * @brief       ICall heap free.
+ */
+void ICall_free(void *pMem)
+{
+    liveAllocs--;
+    free(pMem);
+}
+
+/*!
+ * @brief       MT response: kept, and counted on the link.
+ */
+uint8_t MT_sendResponse(uint8_t type, uint8_t cmd, uint16_t len, uint8_t *pRsp)
+{
+    (void)type;
+
+    rspCmd = cmd;
+    rspLen = (len < sizeof(rsp)) ? len : sizeof(rsp);
+    memcpy(rsp, pRsp, rspLen);
+    linkFrame(len);
+
+    return (MTRPC_SUCCESS);
+}
+
+char *ltoa(long value, uint8_t *pBuf, int radix)
+{
+    (void)radix;
+    sprintf((char *)pBuf, "%ld", value);
+
+    return ((char *)pBuf);
+}
+
+int main(void)
+{
+    void *pFlash = mmap((void *)(uintptr_t)FLASH_ADDR, FLASH_SIZE,
+                        PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE,
+                        -1, 0);
+
+    if(pFlash != (void *)(uintptr_t)FLASH_ADDR)
+    {
+        printf("FAIL: NV flash at 0x%X can't be simulated\n", FLASH_ADDR);
+        return (1);
+    }
+
+    if(checkRollback() != 0)
+    {
+        return (1);
+    }
+
+    return (runLoopback());
+}
@@ -0,0 +1,33 @@
+/******************************************************************************
+
+ @file vims.h
+
+ @brief Host stand-in for the flash cache control, the simulated flash has
+        no cache, the mode is only kept.
+
+ *****************************************************************************/
+#ifndef VIMS_H
+#define VIMS_H
+
+#include <stdint.h>
+
+#define VIMS_BASE                       0
+#define VIMS_MODE_DISABLED              0
+#define VIMS_MODE_ENABLED               1
+#define VIMS_STAT_MODE_M                3
+
+static uint32_t vimsMode = VIMS_MODE_ENABLED;
+
+static inline uint32_t VIMSModeGet(uint32_t base)
+{
+    (void)base;
+    return (vimsMode);
+}
+
+static inline void VIMSModeSet(uint32_t base, uint32_t mode)
+{
+    (void)base;
+    vimsMode = mode;
+}
+
+#endif /* VIMS_H */
@@ -0,0 +1,29 @@
+/******************************************************************************
+
+ @file hal_mcu.h
+
+ @brief Host stand-in for the MCU HAL: types and the flash programming of
+        nvoctp.c, on the simulated flash of the test.
+
+ *****************************************************************************/
+#ifndef HAL_MCU_H
+#define HAL_MCU_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef uint8_t uint8;
+typedef uint16_t uint16;
+typedef uint32_t uint32;
+
+typedef int halIntState_t;
+
+#define HAL_ENTER_CRITICAL_SECTION(x)   ((x) = 0)
+#define HAL_EXIT_CRITICAL_SECTION(x)    ((void)(x))
+
+#define FAPI_STATUS_SUCCESS             0
+
+extern uint32_t FlashProgram(uint8_t *pBuf, uint32_t addr, uint32_t count);
+extern uint32_t FlashSectorErase(uint32_t addr);
+
+#endif /* HAL_MCU_H */
@@ -0,0 +1,35 @@
+/******************************************************************************
+
+ @file icall.h
+
+ @brief Host stand-in for ICall: the heap, counted by the test, and the
+        critical sections of util.c.
+
+ *****************************************************************************/
+#ifndef ICALL_H
+#define ICALL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef uint8_t ICall_EntityID;
+typedef uint8_t ICall_ServiceEnum;
+typedef int ICall_CSState;
+
+extern void *ICall_malloc(size_t size);
+extern void ICall_free(void *pMem);
+
+static inline ICall_CSState ICall_enterCriticalSection(void)
+{
+    return (0);
+}
+
+static inline void ICall_leaveCriticalSection(ICall_CSState key)
+{
+    (void)key;
+}
+
+/*! ltoa() of the TI run time library, used by util.c */
+extern char *ltoa(long value, uint8_t *pBuf, int radix);
+
+#endif /* ICALL_H */
@@ -0,0 +1,19 @@
+/******************************************************************************
+
+ @file macconfig.h
+
+ @brief Host stand-in for the MAC configuration, the NV functions mt_sys.c
+        uses.
+
+ *****************************************************************************/
+#ifndef MACCONFIG_H
+#define MACCONFIG_H
+
+#include "nvintf.h"
+
+typedef struct
+{
+    NVINTF_nvFuncts_t nvFps;
+} mac_Config_t;
+
+#endif /* MACCONFIG_H */
@@ -0,0 +1,64 @@
+/******************************************************************************
+
+ @file nvintf.h
+
+ @brief Host stand-in for the NV driver interface of the SDK.
+
+ *****************************************************************************/
+#ifndef NVINTF_H
+#define NVINTF_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define NVINTF_SUCCESS          0
+#define NVINTF_FAILURE          1
+#define NVINTF_CORRUPT          2
+#define NVINTF_NOTREADY         3
+#define NVINTF_BADPARAM         4
+#define NVINTF_BADLENGTH        5
+#define NVINTF_BADOFFSET        6
+#define NVINTF_BADITEMID        7
+#define NVINTF_BADSUBID         8
+#define NVINTF_BADSYSID         9
+#define NVINTF_NOTFOUND         10
+#define NVINTF_LOWPOWER         11
+#define NVINTF_BADVERSION       12
+
+#define NVINTF_SYSID_NVDRVR     0
+#define NVINTF_SYSID_TIMAC      2
+#define NVINTF_SYSID_APP        7
+
+typedef struct nvintf_itemid_t
+{
+    uint8_t systemID;
+    uint16_t itemID;
+    uint16_t subID;
+} NVINTF_itemID_t;
+
+typedef uint8_t (*NVINTF_initNV)(void *param);
+typedef uint8_t (*NVINTF_compactNV)(uint16_t min);
+typedef uint8_t (*NVINTF_createItem)(NVINTF_itemID_t id, uint32_t length,
+                                     void *buffer);
+typedef uint8_t (*NVINTF_deleteItem)(NVINTF_itemID_t id);
+typedef uint8_t (*NVINTF_readItem)(NVINTF_itemID_t id, uint16_t offset,
+                                   uint16_t bLen, void *pBuf);
+typedef uint8_t (*NVINTF_writeItem)(NVINTF_itemID_t id, uint16_t bLen,
+                                    void *pBuf);
+typedef uint8_t (*NVINTF_writeItemEx)(NVINTF_itemID_t id, uint16_t offset,
+                                      uint16_t bLen, void *pBuf);
+typedef uint32_t (*NVINTF_getItemLen)(NVINTF_itemID_t id);
+
+typedef struct nvintf_nvfuncts_t
+{
+    NVINTF_initNV initNV;
+    NVINTF_compactNV compactNV;
+    NVINTF_createItem createItem;
+    NVINTF_deleteItem deleteItem;
+    NVINTF_readItem readItem;
+    NVINTF_writeItem writeItem;
+    NVINTF_writeItemEx writeItemEx;
+    NVINTF_getItemLen getItemLen;
+} NVINTF_nvFuncts_t;
+
+#endif /* NVINTF_H */
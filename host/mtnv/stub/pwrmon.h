@@ -0,0 +1,21 @@
+/******************************************************************************
+
+ @file pwrmon.h
+
+ @brief Host stand-in for the power monitor, the supply is always good.
+
+ *****************************************************************************/
+#ifndef PWRMON_H
+#define PWRMON_H
+
+#include <stdbool.h>
+
+#define MIN_VDD_FLASH                   0
+
+static inline bool PWRMON_check(int voltage)
+{
+    (void)voltage;
+    return (true);
+}
+
+#endif /* PWRMON_H */
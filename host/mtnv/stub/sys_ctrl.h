@@ -0,0 +1,15 @@
+/******************************************************************************
+
+ @file sys_ctrl.h
+
+ @brief Host stand-in for the system control, the host is not reset.
+
+ *****************************************************************************/
+#ifndef SYS_CTRL_H
+#define SYS_CTRL_H
+
+static inline void SysCtrlSystemReset(void)
+{
+}
+
+#endif /* SYS_CTRL_H */
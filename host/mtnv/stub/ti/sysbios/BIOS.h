@@ -0,0 +1,13 @@
+/******************************************************************************
+
+ @file BIOS.h
+
+ @brief Host stand-in for TI-RTOS BIOS, the wait constant.
+
+ *****************************************************************************/
+#ifndef BIOS_H
+#define BIOS_H
+
+#define BIOS_WAIT_FOREVER               (~0u)
+
+#endif /* BIOS_H */
@@ -0,0 +1,50 @@
+/******************************************************************************
+
+ @file Semaphore.h
+
+ @brief Host stand-in for TI-RTOS semaphores, the NV lock of nvoctp.c. The
+        test has one thread, the lock is always free.
+
+ *****************************************************************************/
+#ifndef SEMAPHORE_H
+#define SEMAPHORE_H
+
+typedef int *Semaphore_Handle;
+
+typedef struct
+{
+    int mode;
+} Semaphore_Params;
+
+#define Semaphore_Mode_BINARY_PRIORITY  1
+
+static int semaphoreCount;
+
+static inline void Semaphore_Params_init(Semaphore_Params *pParams)
+{
+    pParams->mode = 0;
+}
+
+static inline Semaphore_Handle Semaphore_create(int count,
+                                                Semaphore_Params *pParams,
+                                                void *pError)
+{
+    (void)pParams;
+    (void)pError;
+    semaphoreCount = count;
+    return (&semaphoreCount);
+}
+
+static inline int Semaphore_pend(Semaphore_Handle handle, unsigned int timeout)
+{
+    (void)timeout;
+    (*handle)--;
+    return (1);
+}
+
+static inline void Semaphore_post(Semaphore_Handle handle)
+{
+    (*handle)++;
+}
+
+#endif /* SEMAPHORE_H */
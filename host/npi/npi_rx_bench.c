@@ -0,0 +1,474 @@
+/******************************************************************************
+
+ @file npi_rx_bench.c
+
+ @brief Host bench of the NPI UART receive path: the transport and the
+        NPIRxBuf cursor of the co-processor, fed by a UART with a 32 byte
+        FIFO that hands each read back on a full buffer or on an idle line.
+
+        Random MT frames are sent through it and parsed in the shape of
+        NPIFrame_collectFrameData(), right after each buffer fills and with
+        the NPI task lagging a number of bytes behind the UART. Every frame
+        must arrive intact, with no FIFO overrun, up to a lag of
+        BENCH_MAX_LAG bytes.
+
+        Times the critical sections of the read callback and the receive
+        path as a whole, critical sections and parsing, a byte.
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <xdc/std.h>
+#include "hal_types.h"
+#include "ICall.h"
+#include <ti/drivers/UART.h>
+#include <ti/drivers/uart/UARTCC26XX.h>
+#include "inc/npi_tl.h"
+#include "inc/npi_tl_uart.h"
+#include "inc/npi_rxbuf.h"
+
+/******************************************************************************
+ Constants and definitions
+ *****************************************************************************/
+
+/*! Bytes the UART FIFO holds */
+#define FIFO_LEN                32
+
+/*! Start of frame of an MT frame */
+#define MT_SOF                  0xFE
+
+/*! Longest MT frame payload */
+#define MT_MAX_LEN              250
+
+/*! Frames sent on each run */
+#define BENCH_FRAMES            20000
+
+/*! Longest NPI task lag, in bytes, all the frames must survive */
+#define BENCH_MAX_LAG           200
+
+/*! Frames between idle lines */
+#define FRAMES_PER_BURST        4
+
+/*! Counts of a run */
+typedef struct
+{
+    /*! Bytes sent */
+    uint32_t bytes;
+    /*! Frames parsed with a good FCS */
+    uint32_t good;
+    /*! Frames parsed with a bad FCS */
+    uint32_t bad;
+    /*! Bytes lost to a full FIFO */
+    uint32_t overruns;
+    /*! Outermost critical sections */
+    uint32_t csCount;
+    /*! Time in the critical sections, in nanoseconds */
+    uint64_t csTime;
+    /*! Time parsing, in nanoseconds */
+    uint64_t parseTime;
+} benchCounts_t;
+
+/*! States of the frame parser */
+typedef enum
+{
+    parseState_sof,
+    parseState_len,
+    parseState_cmd0,
+    parseState_cmd1,
+    parseState_data,
+    parseState_fcs
+} parseState_t;
+
+/******************************************************************************
+ Local Variables
+ *****************************************************************************/
+
+/*! Counts of the current run */
+static benchCounts_t counts;
+
+/*! Critical section nesting and start */
+static int csDepth;
+static uint64_t csStart;
+
+/*! UART: handle, read callback, pending read and FIFO */
+static struct UART_Config uartConfig;
+static UART_Callback uartReadCb;
+static uint8_t *pReadBuf;
+static size_t readSize;
+static size_t readCount;
+static bool readArmed;
+static uint8_t fifo[FIFO_LEN];
+static uint16_t fifoCount;
+
+/*! NPI task signalled by the transport */
+static bool rxEvent;
+
+/*! Frame parser */
+static parseState_t parseState;
+static uint8_t frameLen;
+static uint8_t frameGot;
+static uint8_t frame[3 + MT_MAX_LEN];
+
+/******************************************************************************
+ Local Functions
+ *****************************************************************************/
+
+/*!
+ * @brief       Read a monotonic clock.
+ *
+ * @return      time, in nanoseconds
+ */
+static uint64_t readNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (((uint64_t)ts.tv_sec * 1000000000u) + (uint64_t)ts.tv_nsec);
+}
+
+/*!
+ * @brief       Hand the pending read back to the transport.
+ */
+static void readComplete(void)
+{
+    readArmed = false;
+    uartReadCb(&uartConfig, pReadBuf, readCount);
+}
+
+/*!
+ * @brief       Receive a byte on the UART. It goes in the pending read, or
+ *              in the FIFO if no read is pending.
+ *
+ * @param       byte - byte received
+ */
+static void uartRxByte(uint8_t byte)
+{
+    if(readArmed)
+    {
+        pReadBuf[readCount++] = byte;
+        if(readCount == readSize)
+        {
+            readComplete();
+        }
+    }
+    else if(fifoCount < FIFO_LEN)
+    {
+        fifo[fifoCount++] = byte;
+    }
+    else
+    {
+        counts.overruns++;
+    }
+}
+
+/*!
+ * @brief       Idle line, the partial read is handed back.
+ */
+static void uartRxIdle(void)
+{
+    if(readArmed && readCount)
+    {
+        readComplete();
+    }
+}
+
+/*!
+ * @brief       NPI TL transmit callback, not used.
+ *
+ * @param       size - bytes sent
+ */
+static void npiTxCb(int size)
+{
+    (void)size;
+}
+
+/*!
+ * @brief       NPI TL receive callback, signals the NPI task.
+ *
+ * @param       size - bytes received
+ */
+static void npiRxCb(int size)
+{
+    (void)size;
+    rxEvent = true;
+}
+
+/*!
+ * @brief       Run the NPI task: parse the MT frames in the received bytes.
+ */
+static void npiParse(void)
+{
+    uint64_t start = readNs();
+    uint8_t ch;
+
+    while(NPIRxBuf_GetRxBufCount())
+    {
+        NPIRxBuf_ReadFromRxBuf(&ch, 1);
+        switch(parseState)
+        {
+            case parseState_sof:
+                if(ch == MT_SOF)
+                {
+                    parseState = parseState_len;
+                }
+                break;
+
+            case parseState_len:
+                frameLen = ch;
+                frameGot = 0;
+                frame[0] = ch;
+                parseState = parseState_cmd0;
+                break;
+
+            case parseState_cmd0:
+                frame[1] = ch;
+                parseState = parseState_cmd1;
+                break;
+
+            case parseState_cmd1:
+                frame[2] = ch;
+                parseState = frameLen ? parseState_data : parseState_fcs;
+                break;
+
+            case parseState_data:
+            {
+                uint16 avail;
+
+                /* The rest of the payload is read in one go, as MT does */
+                frame[3 + frameGot++] = ch;
+                avail = NPIRxBuf_GetRxBufCount();
+                if(avail > (frameLen - frameGot))
+                {
+                    avail = frameLen - frameGot;
+                }
+                NPIRxBuf_ReadFromRxBuf(&frame[3 + frameGot], avail);
+                frameGot += avail;
+                if(frameGot == frameLen)
+                {
+                    parseState = parseState_fcs;
+                }
+                break;
+            }
+
+            case parseState_fcs:
+            {
+                uint8_t fcs = 0;
+                int i;
+
+                for(i = 0; i < (3 + frameLen); i++)
+                {
+                    fcs ^= frame[i];
+                }
+                if(fcs == ch)
+                {
+                    counts.good++;
+                }
+                else
+                {
+                    counts.bad++;
+                }
+                parseState = parseState_sof;
+                break;
+            }
+        }
+    }
+
+    counts.parseTime += readNs() - start;
+    rxEvent = false;
+}
+
+/*!
+ * @brief       Send random MT frames through the UART.
+ *
+ * @param       lag - bytes the NPI task lags behind the UART, 0 to parse
+ *                    as soon as it is signalled
+ */
+static void runFrames(int lag)
+{
+    uint8_t buf[5 + MT_MAX_LEN];
+    int sinceParse = 0;
+    int k;
+
+    memset(&counts, 0, sizeof(counts));
+
+    for(k = 0; k < BENCH_FRAMES; k++)
+    {
+        uint8_t len = (uint8_t)(rand() % (MT_MAX_LEN + 1));
+        uint8_t fcs;
+        int i;
+
+        buf[0] = MT_SOF;
+        buf[1] = len;
+        buf[2] = (uint8_t)rand();
+        buf[3] = (uint8_t)rand();
+        fcs = buf[1] ^ buf[2] ^ buf[3];
+        for(i = 0; i < len; i++)
+        {
+            buf[4 + i] = (uint8_t)rand();
+            fcs ^= buf[4 + i];
+        }
+        buf[4 + len] = fcs;
+
+        for(i = 0; i < (5 + len); i++)
+        {
+            uartRxByte(buf[i]);
+            counts.bytes++;
+            sinceParse++;
+            if(lag ? (sinceParse >= lag) : rxEvent)
+            {
+                npiParse();
+                sinceParse = 0;
+            }
+        }
+
+        if((k % FRAMES_PER_BURST) == (FRAMES_PER_BURST - 1))
+        {
+            uartRxIdle();
+            if((lag == 0) && rxEvent)
+            {
+                npiParse();
+            }
+        }
+    }
+
+    uartRxIdle();
+    npiParse();
+}
+
+/******************************************************************************
+ Public Functions
+ *****************************************************************************/
+
+ICall_CSState ICall_enterCriticalSection(void)
+{
+    if(csDepth++ == 0)
+    {
+        csStart = readNs();
+    }
+
+    return (0);
+}
+
+void ICall_leaveCriticalSection(ICall_CSState key)
+{
+    (void)key;
+
+    if(--csDepth == 0)
+    {
+        uint64_t time = readNs() - csStart;
+
+        counts.csTime += time;
+        counts.csCount++;
+    }
+}
+
+void UART_Params_init(UART_Params *params)
+{
+    memset(params, 0, sizeof(UART_Params));
+}
+
+UART_Handle UART_open(unsigned int index, UART_Params *params)
+{
+    (void)index;
+
+    uartReadCb = params->readCallback;
+
+    return (&uartConfig);
+}
+
+int UART_control(UART_Handle handle, unsigned int cmd, void *arg)
+{
+    (void)handle;
+    (void)cmd;
+    (void)arg;
+
+    return (0);
+}
+
+int UART_read(UART_Handle handle, void *buf, size_t size)
+{
+    uint16_t i;
+
+    (void)handle;
+
+    pReadBuf = buf;
+    readSize = size;
+    readCount = 0;
+    readArmed = true;
+
+    /* The next receive interrupt empties the FIFO into the new buffer */
+    for(i = 0; (i < fifoCount) && (readCount < readSize); i++)
+    {
+        pReadBuf[readCount++] = fifo[i];
+    }
+    memmove(fifo, &fifo[i], fifoCount - i);
+    fifoCount -= i;
+    if(readCount == readSize)
+    {
+        readComplete();
+    }
+
+    return (0);
+}
+
+int UART_write(UART_Handle handle, const void *buf, size_t size)
+{
+    (void)handle;
+    (void)buf;
+    (void)size;
+
+    return (0);
+}
+
+void UART_readCancel(UART_Handle handle)
+{
+    (void)handle;
+}
+
+int UARTCharsAvail(unsigned long base)
+{
+    (void)base;
+
+    return (fifoCount);
+}
+
+int main(void)
+{
+    static const int lags[] = { 0, BENCH_MAX_LAG / 2, BENCH_MAX_LAG };
+    unsigned int i;
+
+    srand(1);
+    NPITL_initTL(npiTxCb, npiRxCb, NULL);
+
+    for(i = 0; i < (sizeof(lags) / sizeof(lags[0])); i++)
+    {
+        runFrames(lags[i]);
+
+        printf("npi %d buffers, lag %3d bytes: %u frames good %u bad %u, "
+               "overruns %u\n", UART_ISR_BUF_CNT, lags[i], BENCH_FRAMES,
+               counts.good, counts.bad, counts.overruns);
+        printf("npi critical sections mean %3.0f ns, rx path %5.2f ns a "
+               "byte\n", (double)counts.csTime / counts.csCount,
+               (double)(counts.csTime + counts.parseTime) / counts.bytes);
+
+        if((counts.good != BENCH_FRAMES) || counts.bad || counts.overruns)
+        {
+            printf("FAIL: frames lost with the NPI task %d bytes behind\n",
+                   lags[i]);
+            return (1);
+        }
+    }
+
+    return (0);
+}
@@ -0,0 +1,13 @@
+/******************************************************************************
+
+ @file Board.h
+
+ @brief Host stand-in for the board header, one UART.
+
+ *****************************************************************************/
+#ifndef BOARD_H
+#define BOARD_H
+
+#define Board_UART              0
+
+#endif /* BOARD_H */
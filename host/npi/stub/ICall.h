@@ -0,0 +1,19 @@
+/******************************************************************************
+
+ @file ICall.h
+
+ @brief Host stand-in for the ICall critical sections, timed by
+        npi_rx_bench.c.
+
+ *****************************************************************************/
+#ifndef ICALL_H
+#define ICALL_H
+
+#include <stdint.h>
+
+typedef uint32_t ICall_CSState;
+
+extern ICall_CSState ICall_enterCriticalSection(void);
+extern void ICall_leaveCriticalSection(ICall_CSState key);
+
+#endif /* ICALL_H */
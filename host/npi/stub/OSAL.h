@@ -0,0 +1,8 @@
+/******************************************************************************
+
+ @file OSAL.h
+
+ @brief Host stand-in for the OSAL header, not used by the NPI receive
+        path.
+
+ *****************************************************************************/
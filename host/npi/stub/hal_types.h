@@ -0,0 +1,26 @@
+/******************************************************************************
+
+ @file hal_types.h
+
+ @brief Host stand-in for the HAL types used by the NPI.
+
+ *****************************************************************************/
+#ifndef HAL_TYPES_H
+#define HAL_TYPES_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef uint8_t uint8;
+typedef uint16_t uint16;
+typedef uint32_t uint32;
+typedef int16_t int16;
+
+#if !defined(TRUE)
+#define TRUE 1
+#endif
+#if !defined(FALSE)
+#define FALSE 0
+#endif
+
+#endif /* HAL_TYPES_H */
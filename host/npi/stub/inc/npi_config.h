@@ -0,0 +1,9 @@
+/******************************************************************************
+
+ @file npi_config.h
+
+ @brief Host stand-in for the NPI include path, the header of the same name
+        in the NPI directory.
+
+ *****************************************************************************/
+#include <npi_config.h>
@@ -0,0 +1,9 @@
+/******************************************************************************
+
+ @file npi_tl_uart.h
+
+ @brief Host stand-in for the NPI include path, the header of the same name
+        in the NPI directory.
+
+ *****************************************************************************/
+#include <npi_tl_uart.h>
@@ -0,0 +1,54 @@
+/******************************************************************************
+
+ @file UART.h
+
+ @brief Host stand-in for the UART driver, the UART of npi_rx_bench.c.
+
+ *****************************************************************************/
+#ifndef ti_drivers_UART__include
+#define ti_drivers_UART__include
+
+#include <stddef.h>
+
+#define UART_ERROR              (-1)
+
+typedef struct UART_Config *UART_Handle;
+
+typedef void (*UART_Callback)(UART_Handle handle, void *buf, size_t count);
+
+typedef enum
+{
+    UART_DATA_BINARY = 0,
+    UART_LEN_8 = 0,
+    UART_STOP_ONE = 0,
+    UART_MODE_CALLBACK = 0,
+    UART_ECHO_OFF = 0
+} UART_Mode;
+
+struct UART_Config
+{
+    void const *hwAttrs;
+};
+
+typedef struct
+{
+    unsigned baudRate;
+    int readDataMode;
+    int writeDataMode;
+    int dataLength;
+    int stopBits;
+    int readMode;
+    int writeMode;
+    int readEcho;
+    UART_Callback readCallback;
+    UART_Callback writeCallback;
+} UART_Params;
+
+extern void UART_Params_init(UART_Params *params);
+extern UART_Handle UART_open(unsigned int index, UART_Params *params);
+extern int UART_control(UART_Handle handle, unsigned int cmd, void *arg);
+extern int UART_read(UART_Handle handle, void *buf, size_t size);
+extern int UART_write(UART_Handle handle, const void *buf, size_t size);
+extern void UART_readCancel(UART_Handle handle);
+
+#endif /* ti_drivers_UART__include */
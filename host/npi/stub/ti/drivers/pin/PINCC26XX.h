@@ -0,0 +1,7 @@
+/******************************************************************************
+
+ @file PINCC26XX.h
+
+ @brief Host stand-in, not used by the NPI receive path.
+
+ *****************************************************************************/
@@ -0,0 +1,26 @@
+/******************************************************************************
+
+ @file UARTCC26XX.h
+
+ @brief Host stand-in for the CC26XX UART driver, and for the driverlib
+        FIFO check the NPI makes.
+
+ *****************************************************************************/
+#ifndef ti_drivers_uart_UARTCC26XX__include
+#define ti_drivers_uart_UARTCC26XX__include
+
+#define UARTCC26XX_CMD_RETURN_PARTIAL_ENABLE    1
+
+typedef struct
+{
+    unsigned long baseAddr;
+} UARTCC26XX_HWAttrsV1;
+
+typedef struct
+{
+    int unused;
+} UARTCC26XX_Object;
+
+extern int UARTCharsAvail(unsigned long base);
+
+#endif /* ti_drivers_uart_UARTCC26XX__include */
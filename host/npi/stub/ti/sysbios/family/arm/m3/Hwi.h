@@ -0,0 +1,7 @@
+/******************************************************************************
+
+ @file Hwi.h
+
+ @brief Host stand-in, not used by the NPI receive path.
+
+ *****************************************************************************/
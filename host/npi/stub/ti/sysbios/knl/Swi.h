@@ -0,0 +1,7 @@
+/******************************************************************************
+
+ @file Swi.h
+
+ @brief Host stand-in, not used by the NPI receive path.
+
+ *****************************************************************************/
@@ -0,0 +1,21 @@
+/******************************************************************************
+
+ @file std.h
+
+ @brief Host stand-in for the XDC types used by the NPI.
+
+ *****************************************************************************/
+#ifndef xdc_std__include
+#define xdc_std__include
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef char Char;
+typedef void Void;
+typedef int Int;
+typedef unsigned int UInt;
+typedef uintptr_t UArg;
+
+#endif /* xdc_std__include */
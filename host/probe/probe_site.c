@@ -0,0 +1,63 @@
+/******************************************************************************
+
+ @file probe_site.c
+
+ @brief A probed function for the probe test, shaped like the hot paths:
+        declarations, PROBE_BEGIN(), an early return and a loop.
+
+        Built with PROBE_SITE_BARE set, the probe macros are left out. With
+        the probes disabled both builds must give the same code.
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+
+#include "probe.h"
+
+/******************************************************************************
+ Public Functions
+ *****************************************************************************/
+
+/*!
+ * @brief       Fletcher-16 of a frame, timed by the sensor data probe.
+ *
+ * @param       pData - frame
+ * @param       len - frame length
+ *
+ * @return      checksum, 0 when there is no frame
+ */
+uint16_t Probe_site(const uint8_t *pData, uint16_t len)
+{
+    uint16_t sum1 = 0;
+    uint16_t sum2 = 0;
+    uint16_t i;
+#if !defined(PROBE_SITE_BARE)
+    PROBE_BEGIN(probeStart);
+#endif
+
+    if(pData == NULL)
+    {
+#if !defined(PROBE_SITE_BARE)
+        PROBE_END(Probe_id_sensorData, probeStart);
+#endif
+        return (0);
+    }
+
+    for(i = 0; i < len; i++)
+    {
+        sum1 = (uint16_t)((sum1 + pData[i]) % 255);
+        sum2 = (uint16_t)((sum2 + sum1) % 255);
+    }
+
+#if !defined(PROBE_SITE_BARE)
+    PROBE_END(Probe_id_sensorData, probeStart);
+#endif
+    return ((uint16_t)((sum2 << 8) | sum1));
+}
@@ -0,0 +1,350 @@
+/******************************************************************************
+
+ @file probe_test.c
+
+ @brief Host test of the probes, probe.c, built with the probes enabled and
+        disabled.
+
+        Enabled, with the clock_gettime() clock of host builds: the
+        histogram bin of every power of two and its neighbours against a
+        log2 loop, the count, minimum, maximum and sum, bins that stop at
+        0xFFFF, reads that reset, bad probe IDs, nested probes, and probed
+        sleeps against the time clock_gettime() measures. The cost of a
+        probe is timed.
+
+        Disabled: the probe macros and Probe_init() must expand to nothing,
+        and the test links without anything from probe.c. The make rule
+        also checks that a probed function compiles to the same code as
+        the function without the probes.
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "probe.h"
+
+/******************************************************************************
+ Constants and definitions
+ *****************************************************************************/
+
+/*! Text of a macro once expanded */
+#define EXPANDED(x)             STRINGIFY(x)
+#define STRINGIFY(x)            #x
+
+/*! Length of the frames given to the probed function */
+#define FRAME_LEN               32
+
+/*! Probed calls timed */
+#define COST_CALLS              1000000
+
+/*! Sleeps timed by the probe, and the time of each */
+#define SLEEPS                  5
+#define SLEEP_NS                2000000
+
+/*! Longest a sleep may overrun the time clock_gettime() measures */
+#define SLEEP_SLACK_NS          100000
+
+/******************************************************************************
+ Local Variables
+ *****************************************************************************/
+
+/*! Frame given to the probed function */
+static uint8_t frame[FRAME_LEN];
+
+/******************************************************************************
+ Local Functions
+ *****************************************************************************/
+
+/*! Probed function, probe_site.c */
+extern uint16_t Probe_site(const uint8_t *pData, uint16_t len);
+
+/*!
+ * @brief       Read a monotonic clock.
+ *
+ * @return      time, in nanoseconds
+ */
+static uint64_t readNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (((uint64_t)ts.tv_sec * 1000000000u) + (uint64_t)ts.tv_nsec);
+}
+
+#if PROBE_ENABLED
+/*!
+ * @brief       Histogram bin of a time, by a loop.
+ *
+ * @param       ticks - time
+ *
+ * @return      bin
+ */
+static uint8_t refBin(uint32_t ticks)
+{
+    uint8_t bin;
+
+    for(bin = 0; ticks > 1; bin++)
+    {
+        ticks >>= 1;
+    }
+
+    return ((bin < PROBE_HIST_BINS) ? bin : (PROBE_HIST_BINS - 1));
+}
+
+/*!
+ * @brief       Check the bins, count, minimum, maximum and sum.
+ *
+ * @return      0 on success, 1 on a failure
+ */
+static int checkStats(void)
+{
+    uint32_t hist[PROBE_HIST_BINS];
+    uint64_t sum = 0;
+    uint32_t count = 0;
+    Probe_stats_t stats;
+    uint8_t shift;
+    uint8_t i;
+
+    memset(hist, 0, sizeof(hist));
+    Probe_init();
+
+    /* 0, then 2^n - 1, 2^n and 2^n + 1 of every n, then the longest */
+    Probe_record(Probe_id_nvFindItem, 0);
+    hist[refBin(0)]++;
+    count++;
+    for(shift = 0; shift < 32; shift++)
+    {
+        uint32_t pow = (uint32_t)1 << shift;
+        uint32_t ticks[3] = { pow - 1, pow, pow + 1 };
+
+        for(i = 0; i < 3; i++)
+        {
+            Probe_record(Probe_id_nvFindItem, ticks[i]);
+            hist[refBin(ticks[i])]++;
+            sum += ticks[i];
+            count++;
+        }
+    }
+    Probe_record(Probe_id_nvFindItem, 0xFFFFFFFF);
+    hist[refBin(0xFFFFFFFF)]++;
+    sum += 0xFFFFFFFF;
+    count++;
+
+    Probe_read(Probe_id_nvFindItem, &stats, false);
+    for(i = 0; i < PROBE_HIST_BINS; i++)
+    {
+        if(stats.hist[i] != hist[i])
+        {
+            printf("FAIL: bin %u has %u times, %u expected\n", i,
+                   stats.hist[i], hist[i]);
+            return (1);
+        }
+    }
+    if((stats.count != count) || (stats.min != 0)
+       || (stats.max != 0xFFFFFFFF) || (stats.sum != sum))
+    {
+        printf("FAIL: count %u min %u max %u sum %llu\n", stats.count,
+               stats.min, stats.max, (unsigned long long)stats.sum);
+        return (1);
+    }
+
+    /* Bins stop at 0xFFFF, the count goes on */
+    for(count = 0; count < 70000; count++)
+    {
+        Probe_record(Probe_id_nvCompactPage, 1000);
+    }
+    Probe_record(Probe_id_nvCompactPage, 999);
+    Probe_read(Probe_id_nvCompactPage, &stats, true);
+    if((stats.hist[refBin(1000)] != 0xFFFF) || (stats.count != 70001)
+       || (stats.min != 999) || (stats.max != 1000)
+       || (stats.sum != (70000ull * 1000) + 999))
+    {
+        printf("FAIL: full bin, count %u bin %u\n", stats.count,
+               stats.hist[refBin(1000)]);
+        return (1);
+    }
+
+    /* The read reset it, the other probes are untouched */
+    Probe_read(Probe_id_nvCompactPage, &stats, false);
+    if(stats.count != 0)
+    {
+        printf("FAIL: read with reset left %u times\n", stats.count);
+        return (1);
+    }
+    Probe_read(Probe_id_nvFindItem, &stats, false);
+    if(stats.count == 0)
+    {
+        printf("FAIL: read with reset cleared another probe\n");
+        return (1);
+    }
+
+    /* Bad probe IDs are ignored, and read as zero */
+    Probe_record(Probe_id_max, 5);
+    memset(&stats, 0xA5, sizeof(stats));
+    Probe_read(Probe_id_max, &stats, true);
+    if(stats.count != 0)
+    {
+        printf("FAIL: bad probe ID read %u times\n", stats.count);
+        return (1);
+    }
+
+    return (0);
+}
+
+/*!
+ * @brief       Check the clock_gettime() clock with probed sleeps, nested
+ *              in a probe of all of them.
+ *
+ * @return      0 on success, 1 on a failure
+ */
+static int checkClock(void)
+{
+    Probe_stats_t outer;
+    Probe_stats_t inner;
+    uint64_t slept = 0;
+    uint64_t start;
+    uint32_t now;
+    int i;
+
+    Probe_init();
+
+    /* The clock is the low 32 bits of the nanoseconds */
+    start = readNs();
+    now = Probe_now();
+    if((uint32_t)(now - (uint32_t)start) > SLEEP_SLACK_NS)
+    {
+        printf("FAIL: probe clock %u, clock_gettime() %u\n", now,
+               (uint32_t)start);
+        return (1);
+    }
+
+    {
+        PROBE_BEGIN(outerStart);
+
+        for(i = 0; i < SLEEPS; i++)
+        {
+            struct timespec ts = { 0, SLEEP_NS };
+            uint64_t t0 = readNs();
+            PROBE_BEGIN(innerStart);
+
+            nanosleep(&ts, NULL);
+
+            PROBE_END(Probe_id_icallWaitMatch, innerStart);
+            slept += readNs() - t0;
+        }
+
+        PROBE_END(Probe_id_osalTimerUpdate, outerStart);
+    }
+
+    Probe_read(Probe_id_icallWaitMatch, &inner, true);
+    Probe_read(Probe_id_osalTimerUpdate, &outer, true);
+
+    if((inner.count != SLEEPS) || (inner.min < SLEEP_NS)
+       || (inner.sum > slept))
+    {
+        printf("FAIL: %u sleeps of %u ns, shortest %u, %llu of %llu ns\n",
+               inner.count, SLEEP_NS, inner.min,
+               (unsigned long long)inner.sum, (unsigned long long)slept);
+        return (1);
+    }
+    if((outer.count != 1) || (outer.sum < inner.sum)
+       || (outer.hist[refBin(outer.max)] != 1))
+    {
+        printf("FAIL: outer probe %u times, %llu ns\n", outer.count,
+               (unsigned long long)outer.sum);
+        return (1);
+    }
+
+    printf("probe clock: %d sleeps of %u ns, %u to %u ns probed, "
+           "all %llu ns\n", SLEEPS, SLEEP_NS, inner.min, inner.max,
+           (unsigned long long)outer.sum);
+
+    return (0);
+}
+#endif
+
+/*!
+ * @brief       Time the probed function. Enabled, every call is counted.
+ *
+ * @return      0 on success, 1 on a failure
+ */
+static int timeSite(void)
+{
+    volatile uint16_t sink = 0;
+    uint64_t start;
+    uint64_t ns;
+    uint32_t i;
+
+    for(i = 0; i < FRAME_LEN; i++)
+    {
+        frame[i] = (uint8_t)(i * 7);
+    }
+
+    Probe_init();
+
+    start = readNs();
+    for(i = 0; i < COST_CALLS; i++)
+    {
+        sink += Probe_site(frame, FRAME_LEN);
+    }
+    sink += Probe_site(NULL, 0);
+    ns = readNs() - start;
+
+#if PROBE_ENABLED
+    {
+        Probe_stats_t stats;
+
+        Probe_read(Probe_id_sensorData, &stats, true);
+        if(stats.count != COST_CALLS + 1)
+        {
+            printf("FAIL: %u of %u calls counted\n", stats.count,
+                   COST_CALLS + 1);
+            return (1);
+        }
+    }
+#endif
+
+    printf("probes enabled %d: %.1f ns a call of a %u byte checksum\n",
+           PROBE_ENABLED, (double)ns / COST_CALLS, FRAME_LEN);
+
+    (void)sink;
+    return (0);
+}
+
+/******************************************************************************
+ Public Functions
+ *****************************************************************************/
+
+int main(void)
+{
+#if PROBE_ENABLED
+    if(checkStats() || checkClock())
+    {
+        return (1);
+    }
+#else
+    if((strcmp(EXPANDED(PROBE_BEGIN(start)), "") != 0)
+       || (strcmp(EXPANDED(PROBE_END(Probe_id_sensorData, start)), "") != 0)
+       || (strcmp(EXPANDED(Probe_init()), "") != 0))
+    {
+        printf("FAIL: disabled probes expand to \"%s\" \"%s\" \"%s\"\n",
+               EXPANDED(PROBE_BEGIN(start)),
+               EXPANDED(PROBE_END(Probe_id_sensorData, start)),
+               EXPANDED(Probe_init()));
+        return (1);
+    }
+#endif
+
+    return (timeSite());
+}
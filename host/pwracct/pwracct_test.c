@@ -0,0 +1,170 @@
+/******************************************************************************
+
+ @file pwracct_test.c
+
+ @brief Host test of the power accounting, on the simulated clock. Plays a
+        run of task switches and standby periods in place of the kernel and
+        checks the time charged to each task class, the split of the idle
+        task between standby and idling, the wakeup counts, a wrap of the
+        32-bit clock and the reset of the totals.
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+#include <stdio.h>
+
+#include "pwracct.h"
+
+/******************************************************************************
+ Constants and definitions
+ *****************************************************************************/
+
+/*! Switch from one task to another at a time */
+#define SWITCH(prev, next, time)                    \
+    do                                              \
+    {                                               \
+        Pwracct_simClock = (time);                  \
+        Pwracct_taskSwitch((prev), (next));         \
+    } while(0)
+
+/******************************************************************************
+ Local Variables
+ *****************************************************************************/
+
+/*! Task handles, the addresses stand in for the kernel's */
+static int stackTask;
+static int appTask;
+static int npiTask;
+static int idleTask;
+static int otherTask;
+
+/******************************************************************************
+ Local Functions
+ *****************************************************************************/
+
+/*!
+ * @brief       Check a value.
+ *
+ * @param       pName - name of the value
+ * @param       value - value read
+ * @param       expected - value expected
+ *
+ * @return      0 if they match
+ */
+static int check(const char *pName, uint32_t value, uint32_t expected)
+{
+    if(value != expected)
+    {
+        printf("FAIL: %s %u, expected %u\n", pName, value, expected);
+        return (1);
+    }
+
+    return (0);
+}
+
+/*!
+ * @brief       Check that the task times add up to the elapsed time.
+ *
+ * @param       pStats - statistics read
+ *
+ * @return      0 if they do
+ */
+static int checkSum(const Pwracct_stats_t *pStats)
+{
+    uint32_t sum = 0;
+    int i;
+
+    for(i = 0; i < Pwracct_task_max; i++)
+    {
+        sum += pStats->taskTime[i];
+    }
+
+    return (check("task time sum", sum, pStats->elapsed));
+}
+
+/******************************************************************************
+ Public Functions
+ *****************************************************************************/
+
+int main(void)
+{
+    Pwracct_stats_t stats;
+    int fails = 0;
+
+    /* The stack task is tagged by ICall before the init */
+    Pwracct_setTask(&stackTask, Pwracct_task_stack);
+    Pwracct_simClock = 1000;
+    Pwracct_init();
+    Pwracct_setTask(&idleTask, Pwracct_task_idle);
+    Pwracct_setTask(&appTask, Pwracct_task_app);
+    Pwracct_setTask(&npiTask, Pwracct_task_npi);
+
+    /* The time in main() before the kernel starts isn't charged */
+    SWITCH(NULL, &stackTask, 1500);
+    SWITCH(&stackTask, &appTask, 1600);
+    SWITCH(&appTask, &idleTask, 1900);
+
+    Pwracct_simClock = 1950;
+    Pwracct_standbyEnter();
+    Pwracct_simClock = 11950;
+    Pwracct_standbyExit(Pwracct_wake_timer);
+
+    SWITCH(&idleTask, &npiTask, 12000);
+    SWITCH(&npiTask, &otherTask, 12040);
+    SWITCH(&otherTask, &idleTask, 12060);
+
+    Pwracct_simClock = 12100;
+    Pwracct_standbyEnter();
+    Pwracct_simClock = 13100;
+    Pwracct_standbyExit(Pwracct_wake_pin);
+
+    SWITCH(&idleTask, &appTask, 13200);
+
+    /* The running task is charged up to the read */
+    Pwracct_simClock = 13250;
+    Pwracct_read(&stats, true);
+
+    fails += check("stack", stats.taskTime[Pwracct_task_stack], 100);
+    fails += check("app", stats.taskTime[Pwracct_task_app], 350);
+    fails += check("npi", stats.taskTime[Pwracct_task_npi], 40);
+    fails += check("idle", stats.taskTime[Pwracct_task_idle], 11240);
+    fails += check("other", stats.taskTime[Pwracct_task_other], 20);
+    fails += check("standby", stats.standbyTime, 11000);
+    fails += check("idling", stats.idleTime, 240);
+    fails += check("timer wakeups", stats.wakeups[Pwracct_wake_timer], 1);
+    fails += check("pin wakeups", stats.wakeups[Pwracct_wake_pin], 1);
+    fails += check("radio wakeups", stats.wakeups[Pwracct_wake_radio], 0);
+    fails += check("elapsed", stats.elapsed, 12250);
+
+    /* Time is carried across a wrap of the 32-bit clock */
+    SWITCH(&appTask, &stackTask, 0xFFFFFF00u);
+    Pwracct_simClock = 0x100;
+    Pwracct_read(&stats, false);
+
+    fails += check("stack after the wrap", stats.taskTime[Pwracct_task_stack],
+                   0x200);
+    fails += checkSum(&stats);
+
+    /* A reset clears the totals */
+    Pwracct_read(&stats, true);
+    Pwracct_read(&stats, false);
+
+    fails += check("elapsed after a reset", stats.elapsed, 0);
+    fails += check("stack after a reset", stats.taskTime[Pwracct_task_stack],
+                   0);
+
+    if(fails)
+    {
+        return (1);
+    }
+
+    printf("pwracct task, standby and idle times, wakeups, clock wrap and "
+           "reset as expected\n");
+
+    return (0);
+}
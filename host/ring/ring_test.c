@@ -0,0 +1,541 @@
+/******************************************************************************
+
+ @file ring_test.c
+
+ @brief Host stress test and benchmark of the MSP430 ESP8266 bridge receive
+        ring: the byte ring filled by the UART RX ISR and the line framing
+        of the main loop.
+
+        Checks the hand-out of an unterminated line once the ring is 3/4
+        full, keeping a trailing <CR>, and the overflow count of a full
+        ring. Then streams random lines, longer than the ring, with CIPSEND
+        prompts, through two kinds of interleaving:
+
+        - a scripted one, bursts of ISR bytes between the main loop's calls
+        - a real one, the ISR is a SIGALRM handler that preempts the main
+          loop at any instruction
+
+        The lines handed out, with their terminators, must rebuild exactly
+        the bytes the ring took. Times the main loop framing a byte.
+
+ Group: WCS LPC
+ Target Device: MSP430G2553
+
+ *****************************************************************************/
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+
+#include "ringBuffer.h"
+
+/******************************************************************************
+ Constants and definitions
+ *****************************************************************************/
+
+/*! Size of the ring, ESP_RX_BUFFER_SIZE of the bridge */
+#define RING_SIZE               128
+
+/*! Fill level of the partial hand-out */
+#define PARTIAL_LEVEL           ((RING_SIZE * 3) / 4)
+
+/*! Longest random line, past the ring size */
+#define MAX_LINE_LEN            300
+
+/*! Bytes streamed by the scripted interleaving */
+#define SCRIPT_BYTES            2000000
+
+/*! Run time of the signal interleaving, in seconds */
+#define SIGNAL_SECS             1
+
+/*! Period of the SIGALRM ISR, in microseconds */
+#define SIGNAL_PERIOD_US        50
+
+/*! Bytes the SIGALRM ISR puts each time */
+#define SIGNAL_BURST            8
+
+/*! Largest stream kept for the check */
+#define MAX_STREAM              (64u * 1024u * 1024u)
+
+/*! Random line generator */
+typedef struct
+{
+    /*! Bytes left of the current line, then its terminator */
+    uint16_t left;
+    /*! Terminator of the current line, "\r\n", "\n" or "> " */
+    const char *pTerm;
+    /*! Random number state */
+    uint32_t seed;
+} lineGen_t;
+
+/******************************************************************************
+ Local Variables
+ *****************************************************************************/
+
+static uint8_t storage[RING_SIZE];
+static ringBuffer ring;
+
+/*! Bytes the ring took, in order */
+static uint8_t *pTaken;
+static volatile uint32_t takenLen;
+
+/*! Bytes rebuilt from the lines handed out */
+static uint32_t rebuiltLen;
+
+/*! Line generator of the ISR */
+static lineGen_t isrGen;
+
+/*! Lines, partial lines and bytes rejected */
+static uint32_t lines;
+static uint32_t partials;
+static uint32_t rejected;
+
+/******************************************************************************
+ Local Functions
+ *****************************************************************************/
+
+/*!
+ * @brief       Make a random number.
+ *
+ * @param       pSeed - random number state
+ *
+ * @return      24 random bits
+ */
+static uint32_t random24(uint32_t *pSeed)
+{
+    *pSeed = (*pSeed * 1103515245u) + 12345u;
+
+    return (*pSeed >> 8);
+}
+
+/*!
+ * @brief       Get the next byte of the random line stream. Lines are
+ *              printable bytes other than '>', a prompt is "> " alone.
+ *
+ * @param       pGen - generator
+ *
+ * @return      byte
+ */
+static uint8_t nextByte(lineGen_t *pGen)
+{
+    uint32_t r;
+
+    if(pGen->left == 0)
+    {
+        if(pGen->pTerm != NULL)
+        {
+            uint8_t c = (uint8_t)*pGen->pTerm++;
+
+            if(*pGen->pTerm == 0)
+            {
+                pGen->pTerm = NULL;
+            }
+            return (c);
+        }
+
+        r = random24(&pGen->seed);
+        if((r % 10) == 0)
+        {
+            pGen->pTerm = "> ";
+            return (nextByte(pGen));
+        }
+        pGen->left = (uint16_t)(r % (MAX_LINE_LEN + 1));
+        pGen->pTerm = ((r >> 8) % 4) ? "\r\n" : "\n";
+        if(pGen->left == 0)
+        {
+            return (nextByte(pGen));
+        }
+    }
+
+    pGen->left--;
+    r = random24(&pGen->seed);
+
+    return ((uint8_t)(' ' + (r % ('>' - ' '))));
+}
+
+/*!
+ * @brief       RX ISR: put a byte, keep it if the ring took it.
+ *
+ * @param       c - byte received
+ */
+static void isrPut(uint8_t c)
+{
+    if(ringBufferPut(&ring, c) != RINGBUFF_OK)
+    {
+        rejected++;
+    }
+    else if(takenLen < MAX_STREAM)
+    {
+        pTaken[takenLen] = c;
+        takenLen = takenLen + 1;
+    }
+}
+
+/*!
+ * @brief       Check bytes handed out against the bytes the ring took.
+ *
+ * @param       c - byte handed out
+ *
+ * @return      0 if it's the next byte taken
+ */
+static int rebuild(uint8_t c)
+{
+    if((rebuiltLen >= takenLen) || (pTaken[rebuiltLen] != c))
+    {
+        printf("FAIL: byte %u handed out 0x%02x, taken 0x%02x\n", rebuiltLen,
+               c, (rebuiltLen < takenLen) ? pTaken[rebuiltLen] : 0);
+        return (1);
+    }
+    rebuiltLen++;
+
+    return (0);
+}
+
+/*!
+ * @brief       Main loop: frame and release the lines in the ring, and
+ *              rebuild the bytes they came from.
+ *
+ * @return      0 if every line matches the bytes taken
+ */
+static int consume(void)
+{
+    ringBufferSpan span;
+    uint8_t status;
+
+    while((status = ringBufferGetLine(&ring, &span)) != RINGBUFF_EMPTY)
+    {
+        uint8_t len = ringBufferSpanLength(&span);
+        uint8_t i;
+
+        for(i = 0; i < len; i++)
+        {
+            if(rebuild(ringBufferSpanByte(&span, i)))
+            {
+                return (1);
+            }
+        }
+
+        if(status == RINGBUFF_PARTIAL)
+        {
+            partials++;
+        }
+        else
+        {
+            const char *pTerm = "\r\n";
+
+            if(ringBufferSpanEquals(&span, ">"))
+            {
+                pTerm = " ";
+            }
+            else if(span.skip == 1)
+            {
+                pTerm = "\n";
+            }
+
+            for(i = 0; i < span.skip; i++)
+            {
+                if(rebuild((uint8_t)pTerm[i]))
+                {
+                    return (1);
+                }
+            }
+            lines++;
+        }
+
+        ringBufferRelease(&ring, &span);
+    }
+
+    return (0);
+}
+
+/*!
+ * @brief       Start a stream.
+ *
+ * @param       seed - seed of the generator
+ */
+static void startStream(uint32_t seed)
+{
+    ringBufferInit(&ring, storage, sizeof(storage));
+    memset(&isrGen, 0, sizeof(isrGen));
+    isrGen.seed = seed;
+    takenLen = 0;
+    rebuiltLen = 0;
+    lines = 0;
+    partials = 0;
+    rejected = 0;
+}
+
+/*!
+ * @brief       Check the partial hand-out of a long line and the overflow
+ *              of a full ring.
+ *
+ * @return      0 if as expected
+ */
+static int checkLevels(void)
+{
+    ringBufferSpan span;
+    uint8_t status;
+    int i;
+
+    startStream(1);
+
+    /* Unterminated, one byte short of the level */
+    for(i = 0; i < (PARTIAL_LEVEL - 1); i++)
+    {
+        isrPut('a');
+    }
+    if(ringBufferGetLine(&ring, &span) != RINGBUFF_EMPTY)
+    {
+        printf("FAIL: line handed out below the partial level\n");
+        return (1);
+    }
+
+    /* At the level, a trailing <CR> stays in the ring */
+    isrPut('\r');
+    status = ringBufferGetLine(&ring, &span);
+    if((status != RINGBUFF_PARTIAL)
+       || (ringBufferSpanLength(&span) != (PARTIAL_LEVEL - 1)))
+    {
+        printf("FAIL: partial line status %u length %u at the level\n",
+               status, ringBufferSpanLength(&span));
+        return (1);
+    }
+    ringBufferRelease(&ring, &span);
+
+    /* The <CR> still makes a terminator with the <LF> */
+    isrPut('\n');
+    status = ringBufferGetLine(&ring, &span);
+    if((status != RINGBUFF_OK) || (ringBufferSpanLength(&span) != 0)
+       || (span.skip != 2))
+    {
+        printf("FAIL: <CR> of a partial line lost\n");
+        return (1);
+    }
+    ringBufferRelease(&ring, &span);
+
+    /* A full ring drops the bytes and counts them */
+    for(i = 0; i < (RING_SIZE + 10); i++)
+    {
+        isrPut('b');
+    }
+    if((ringBufferCount(&ring) != RING_SIZE) || (ring.overflow != 10)
+       || (rejected != 10))
+    {
+        printf("FAIL: full ring holds %u, overflow %u\n",
+               ringBufferCount(&ring), ring.overflow);
+        return (1);
+    }
+
+    /* It's handed out whole then takes bytes again */
+    status = ringBufferGetLine(&ring, &span);
+    if((status != RINGBUFF_PARTIAL)
+       || (ringBufferSpanLength(&span) != RING_SIZE))
+    {
+        printf("FAIL: full ring handed out %u bytes\n",
+               ringBufferSpanLength(&span));
+        return (1);
+    }
+    ringBufferRelease(&ring, &span);
+    if((ringBufferCount(&ring) != 0) || (ringBufferPut(&ring, 'c')
+                                         != RINGBUFF_OK))
+    {
+        printf("FAIL: ring doesn't recover from a full ring\n");
+        return (1);
+    }
+
+    printf("ring partial line at %d of %d bytes, overflow of a full ring as "
+           "expected\n", PARTIAL_LEVEL, RING_SIZE);
+
+    return (0);
+}
+
+/*!
+ * @brief       Read a monotonic clock.
+ *
+ * @return      time, in nanoseconds
+ */
+static uint64_t readNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (((uint64_t)ts.tv_sec * 1000000000u) + (uint64_t)ts.tv_nsec);
+}
+
+/*!
+ * @brief       Stream lines with bursts of ISR bytes between the main loop
+ *              calls, the bursts up to maxBurst bytes, and time the framing.
+ *
+ * @param       maxBurst - longest burst
+ *
+ * @return      0 if the lines rebuild the bytes taken
+ */
+static int runScripted(uint32_t maxBurst)
+{
+    uint32_t seed = 7;
+    uint32_t sent = 0;
+    uint64_t busy = 0;
+    uint64_t t;
+
+    startStream(maxBurst);
+
+    while(sent < SCRIPT_BYTES)
+    {
+        uint32_t burst = random24(&seed) % (maxBurst + 1);
+
+        while(burst--)
+        {
+            isrPut(nextByte(&isrGen));
+            sent++;
+        }
+
+        t = readNs();
+        if(consume())
+        {
+            return (1);
+        }
+        busy += readNs() - t;
+    }
+
+    if(consume())
+    {
+        return (1);
+    }
+
+    printf("ring scripted bursts up to %3u: %u lines, %u partial, %u bytes "
+           "overflowed, %5.1f ns a byte framed\n", maxBurst, lines, partials,
+           rejected, (double)busy / rebuiltLen);
+
+    if(ringBufferCount(&ring) != (takenLen - rebuiltLen))
+    {
+        printf("FAIL: %u bytes in the ring, %u not handed out\n",
+               ringBufferCount(&ring), takenLen - rebuiltLen);
+        return (1);
+    }
+
+    return (0);
+}
+
+/*!
+ * @brief       SIGALRM handler standing in for the UART RX ISR.
+ *
+ * @param       sig - signal
+ */
+static void alarmIsr(int sig)
+{
+    int i;
+
+    (void)sig;
+
+    for(i = 0; i < SIGNAL_BURST; i++)
+    {
+        isrPut(nextByte(&isrGen));
+    }
+}
+
+/*!
+ * @brief       Stream lines from a SIGALRM ISR that preempts the main loop
+ *              anywhere.
+ *
+ * @return      0 if the lines rebuild the bytes taken
+ */
+static int runSignal(void)
+{
+    struct sigaction action;
+    struct itimerval timer;
+    sigset_t block;
+    uint64_t end;
+    int fail = 0;
+
+    startStream(99);
+
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = alarmIsr;
+    sigaction(SIGALRM, &action, NULL);
+
+    memset(&timer, 0, sizeof(timer));
+    timer.it_interval.tv_usec = SIGNAL_PERIOD_US;
+    timer.it_value.tv_usec = SIGNAL_PERIOD_US;
+    setitimer(ITIMER_REAL, &timer, NULL);
+
+    end = readNs() + ((uint64_t)SIGNAL_SECS * 1000000000u);
+    while(!fail && (readNs() < end))
+    {
+        fail = consume();
+    }
+
+    memset(&timer, 0, sizeof(timer));
+    setitimer(ITIMER_REAL, &timer, NULL);
+
+    /* The rest of the stream, the ISR is off now */
+    sigemptyset(&block);
+    sigaddset(&block, SIGALRM);
+    sigprocmask(SIG_BLOCK, &block, NULL);
+    if(!fail)
+    {
+        fail = consume();
+    }
+
+    if(fail)
+    {
+        return (1);
+    }
+
+    printf("ring SIGALRM ISR every %d us: %u bytes, %u lines, %u partial, %u "
+           "bytes overflowed\n", SIGNAL_PERIOD_US, rebuiltLen, lines,
+           partials, rejected);
+
+    if(lines == 0)
+    {
+        printf("FAIL: no line through the SIGALRM ISR\n");
+        return (1);
+    }
+
+    return (0);
+}
+
+/******************************************************************************
+ Public Functions
+ *****************************************************************************/
+
+int main(void)
+{
+    static const uint32_t bursts[] = { 1, 16, 64, 200 };
+    unsigned int i;
+
+    pTaken = malloc(MAX_STREAM);
+    if(pTaken == NULL)
+    {
+        printf("FAIL: no memory for the stream\n");
+        return (1);
+    }
+
+    if(checkLevels())
+    {
+        return (1);
+    }
+
+    for(i = 0; i < (sizeof(bursts) / sizeof(bursts[0])); i++)
+    {
+        if(runScripted(bursts[i]))
+        {
+            return (1);
+        }
+    }
+
+    if(runSignal())
+    {
+        return (1);
+    }
+
+    free(pTaken);
+
+    return (0);
+}
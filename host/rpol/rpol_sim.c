@@ -0,0 +1,457 @@
+/******************************************************************************
+
+ @file rpol_sim.c
+
+ @brief Trace driven simulation of the sensor report policy. Runs a trace of
+        readings through Rpol_checkReport() for a range of deadbands and
+        heartbeats, and reports:
+
+        - the messages sent against the readings taken, and the reduction
+        - the error of the collector's view, the last reported reading held
+          until the next one, against every reading of the trace
+
+        and checks that on a quiet channel the error stays within the
+        deadband of each field and no gap is longer than the heartbeat.
+        A busy channel run shows what the back off costs in error.
+
+        The trace is a week of synthetic readings every 90 seconds, or a
+        CSV file given as the argument with one reading per line:
+        "<ms>,<ambience>,<object>,<light>,<humidity temp>,<humidity>"
+        in the units of the sensor data message.
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "rpol.h"
+
+/******************************************************************************
+ Constants and definitions
+ *****************************************************************************/
+
+/*! Reporting interval of the synthetic trace, in milliseconds */
+#define REPORT_INTERVAL         90000
+
+/*! Length of the synthetic trace */
+#define TRACE_DAYS              7
+#define MS_PER_DAY              (24UL * 3600 * 1000)
+
+/*! Most readings in a trace */
+#define MAX_READINGS            100000
+
+/*! Fields of a reading, in the order of the CSV trace */
+#define NUM_FIELDS              5
+#define FIELD_AMBIENCE          0
+#define FIELD_OBJECT            1
+#define FIELD_LIGHT             2
+#define FIELD_HUM_TEMP          3
+#define FIELD_HUMIDITY          4
+
+/*! A reading of the trace */
+typedef struct
+{
+    uint32_t time;
+    int32_t field[NUM_FIELDS];
+} reading_t;
+
+/*! A policy to simulate */
+typedef struct
+{
+    const char *pName;
+    Smsgs_reportPolicyField_t policy;
+} simPolicy_t;
+
+/*! Result of a run */
+typedef struct
+{
+    uint32_t messages;
+    uint32_t maxGap;
+    int32_t maxError[NUM_FIELDS];
+    double sumSquares[NUM_FIELDS];
+} simResult_t;
+
+/******************************************************************************
+ Local Variables
+ *****************************************************************************/
+
+static const char *fieldNames[NUM_FIELDS] =
+{
+    "ambience", "object", "light", "hum temp", "humidity"
+};
+
+/*!
+ Policies: no policy, then deadbands of about 0.1, 0.25 and 0.5 C with
+ heartbeats of 10 minutes, 30 minutes and an hour
+ */
+static const simPolicy_t simPolicies[] =
+{
+    { "every reading", { 0, 0, 0, 0 } },
+    { "tight, 10 min", { 10, 50, 100, 10UL * 60 * 1000 } },
+    { "medium, 30 min", { 25, 100, 250, 30UL * 60 * 1000 } },
+    { "loose, 1 h", { 50, 200, 500, 60UL * 60 * 1000 } },
+};
+
+#define NUM_POLICIES            (sizeof(simPolicies) / sizeof(simPolicies[0]))
+
+/*! The trace */
+static reading_t trace[MAX_READINGS];
+static uint32_t traceLength;
+
+/*! State of the noise generator */
+static uint32_t randState = 1;
+
+/******************************************************************************
+ Local Functions
+ *****************************************************************************/
+
+/*!
+ * @brief       Pseudo random number, the same on every run.
+ *
+ * @param       range - values from -range to range
+ *
+ * @return      the number
+ */
+static int32_t noise(int32_t range)
+{
+    randState = randState * 1103515245 + 12345;
+
+    return ((int32_t)((randState >> 16) % (uint32_t)(2 * range + 1)) - range);
+}
+
+/*!
+ * @brief       Build a week of readings of an office: daily temperature
+ *              swing with the heating switched on in the morning, daylight
+ *              with passing clouds and lights in the evening, humidity
+ *              falling as it gets warm, and sensor noise on every field.
+ */
+static void synthesizeTrace(void)
+{
+    int32_t cloud = 0;
+    uint32_t t;
+
+    traceLength = 0;
+    for(t = 0; t < TRACE_DAYS * MS_PER_DAY; t += REPORT_INTERVAL)
+    {
+        reading_t *pReading = &trace[traceLength++];
+        double day = (double)(t % MS_PER_DAY) / MS_PER_DAY;
+        double hour = day * 24;
+        double swing = sin(2 * M_PI * (day - 0.375));
+        int32_t ambience;
+
+        /* 0.01 C */
+        ambience = 2100 + (int32_t)(250 * swing);
+        if((hour >= 7) && (hour < 8) && ((t / MS_PER_DAY) % 7 < 5))
+        {
+            ambience += (int32_t)(200 * (hour - 7));
+        }
+        else if((hour >= 8) && (hour < 18) && ((t / MS_PER_DAY) % 7 < 5))
+        {
+            ambience += 200;
+        }
+        pReading->time = t;
+        pReading->field[FIELD_AMBIENCE] = ambience + noise(4);
+        pReading->field[FIELD_OBJECT] = ambience + 60 + noise(6);
+
+        /* Raw light, clouds drift and jump */
+        cloud += noise(30);
+        if(noise(100) == 0)
+        {
+            cloud = noise(600);
+        }
+        cloud = (cloud > 800) ? 800 : ((cloud < -800) ? -800 : cloud);
+        if((hour > 6) && (hour < 18))
+        {
+            int32_t light = (int32_t)(2500 * sin(M_PI * (hour - 6) / 12))
+                            - cloud;
+
+            pReading->field[FIELD_LIGHT] = (light > 0) ? light : 0;
+        }
+        else
+        {
+            pReading->field[FIELD_LIGHT] = ((hour >= 18) && (hour < 23)) ?
+                                           400 : 0;
+        }
+        pReading->field[FIELD_LIGHT] += 20 + noise(15);
+
+        /* HDC1000 raw values, about 397 per C and 655 per % RH */
+        pReading->field[FIELD_HUM_TEMP] = (int32_t)((ambience / 100.0 + 40)
+                                                    * 397.2) + noise(20);
+        pReading->field[FIELD_HUMIDITY] = (int32_t)((45 - 8 * swing) * 655.4)
+                                          + noise(60);
+    }
+}
+
+/*!
+ * @brief       Read a CSV trace.
+ *
+ * @param       pFileName - trace file
+ *
+ * @return      0 when read, 1 on an error
+ */
+static int readTrace(const char *pFileName)
+{
+    FILE *pFile = fopen(pFileName, "r");
+    char line[256];
+
+    if(pFile == NULL)
+    {
+        printf("FAIL: cannot open %s\n", pFileName);
+        return (1);
+    }
+
+    traceLength = 0;
+    while((fgets(line, sizeof(line), pFile) != NULL)
+          && (traceLength < MAX_READINGS))
+    {
+        reading_t *pReading = &trace[traceLength];
+        long f[NUM_FIELDS];
+        unsigned long time;
+
+        if(sscanf(line, "%lu,%ld,%ld,%ld,%ld,%ld", &time, &f[0], &f[1],
+                  &f[2], &f[3], &f[4]) == 1 + NUM_FIELDS)
+        {
+            int i;
+
+            pReading->time = (uint32_t)time;
+            for(i = 0; i < NUM_FIELDS; i++)
+            {
+                pReading->field[i] = (int32_t)f[i];
+            }
+            traceLength++;
+        }
+    }
+    fclose(pFile);
+
+    if(traceLength < 2)
+    {
+        printf("FAIL: no readings in %s\n", pFileName);
+        return (1);
+    }
+
+    return (0);
+}
+
+/*!
+ * @brief       Fill the sensor data message of a reading.
+ *
+ * @param       pReading - the reading
+ * @param       pMsg - sensor data message
+ */
+static void buildMsg(const reading_t *pReading, Smsgs_sensorMsg_t *pMsg)
+{
+    memset(pMsg, 0, sizeof(Smsgs_sensorMsg_t));
+    pMsg->frameControl = Smsgs_dataFields_tempSensor
+                         | Smsgs_dataFields_lightSensor
+                         | Smsgs_dataFields_humiditySensor;
+    pMsg->tempSensor.ambienceTemp = (int16_t)pReading->field[FIELD_AMBIENCE];
+    pMsg->tempSensor.objectTemp = (int16_t)pReading->field[FIELD_OBJECT];
+    pMsg->lightSensor.rawData = (uint16_t)pReading->field[FIELD_LIGHT];
+    pMsg->humiditySensor.temp = (uint16_t)pReading->field[FIELD_HUM_TEMP];
+    pMsg->humiditySensor.humidity = (uint16_t)pReading->field[FIELD_HUMIDITY];
+}
+
+/*!
+ * @brief       Run the trace through a policy.
+ *
+ * @param       pPolicy - the policy
+ * @param       busy - true for a channel that fails half of the sends in
+ *                     the busy hours of each day
+ * @param       pResult - messages and errors of the run
+ */
+static void runPolicy(const simPolicy_t *pPolicy, bool busy,
+                      simResult_t *pResult)
+{
+    Smsgs_reportPolicyField_t policy = pPolicy->policy;
+    const reading_t *pHeld = NULL;
+    uint32_t txFailures = 0;
+    uint32_t i;
+
+    memset(pResult, 0, sizeof(simResult_t));
+    memset(&Rpol_statistics, 0, sizeof(Rpol_statistics));
+    Rpol_setPolicy(&policy);
+    randState = 7;
+
+    for(i = 0; i < traceLength; i++)
+    {
+        const reading_t *pReading = &trace[i];
+        Smsgs_sensorMsg_t msg;
+        int f;
+
+        buildMsg(pReading, &msg);
+        if(Rpol_checkReport(&msg, pReading->time, txFailures) == true)
+        {
+            uint32_t hour = (pReading->time % MS_PER_DAY) / 3600000;
+
+            if(pHeld != NULL)
+            {
+                uint32_t gap = pReading->time - pHeld->time;
+
+                if(gap > pResult->maxGap)
+                {
+                    pResult->maxGap = gap;
+                }
+            }
+            pHeld = pReading;
+            pResult->messages++;
+
+            if(busy && (hour >= 9) && (hour < 17) && (noise(1) != 0))
+            {
+                txFailures++;
+            }
+        }
+
+        /* What the collector shows for this reading */
+        for(f = 0; f < NUM_FIELDS; f++)
+        {
+            int32_t error = pReading->field[f] - pHeld->field[f];
+
+            if(error < 0)
+            {
+                error = -error;
+            }
+            if(error > pResult->maxError[f])
+            {
+                pResult->maxError[f] = error;
+            }
+            pResult->sumSquares[f] += (double)error * error;
+        }
+    }
+}
+
+/*!
+ * @brief       Print the result of a run.
+ *
+ * @param       pName - name of the run
+ * @param       pResult - messages and errors of the run
+ */
+static void printResult(const char *pName, const simResult_t *pResult)
+{
+    int f;
+
+    printf("%-16s %6u  %5.1f%%  %6.1f", pName, (unsigned)pResult->messages,
+           100.0 * (traceLength - pResult->messages) / traceLength,
+           pResult->maxGap / 60000.0);
+    for(f = 0; f < NUM_FIELDS; f++)
+    {
+        printf("  %5d/%6.1f", (int)pResult->maxError[f],
+               sqrt(pResult->sumSquares[f] / traceLength));
+    }
+    printf("\n");
+}
+
+/*!
+ * @brief       Check a quiet channel run against the bounds of its policy.
+ *
+ * @param       pPolicy - the policy
+ * @param       pResult - messages and errors of the run
+ *
+ * @return      0 when within bounds, 1 on a failure
+ */
+static int checkResult(const simPolicy_t *pPolicy, const simResult_t *pResult)
+{
+    const Smsgs_reportPolicyField_t *p = &pPolicy->policy;
+    uint32_t interval = (trace[traceLength - 1].time - trace[0].time)
+                        / (traceLength - 1);
+    uint16_t deadband[NUM_FIELDS];
+    int f;
+
+    deadband[FIELD_AMBIENCE] = p->tempDeadband;
+    deadband[FIELD_OBJECT] = p->tempDeadband;
+    deadband[FIELD_LIGHT] = p->lightDeadband;
+    deadband[FIELD_HUM_TEMP] = p->humidityDeadband;
+    deadband[FIELD_HUMIDITY] = p->humidityDeadband;
+
+    if(pResult->messages > traceLength)
+    {
+        printf("FAIL: %s: %u messages for %u readings\n", pPolicy->pName,
+               (unsigned)pResult->messages, (unsigned)traceLength);
+        return (1);
+    }
+
+    for(f = 0; f < NUM_FIELDS; f++)
+    {
+        if(pResult->maxError[f] > deadband[f])
+        {
+            printf("FAIL: %s: %s off by %d, deadband %u\n", pPolicy->pName,
+                   fieldNames[f], (int)pResult->maxError[f],
+                   (unsigned)deadband[f]);
+            return (1);
+        }
+    }
+
+    /* A heartbeat is sent by the first reading after the interval */
+    if((p->heartbeatInterval != 0)
+       && (pResult->maxGap >= p->heartbeatInterval + interval))
+    {
+        printf("FAIL: %s: %u ms without a report, heartbeat %u ms\n",
+               pPolicy->pName, (unsigned)pResult->maxGap,
+               (unsigned)p->heartbeatInterval);
+        return (1);
+    }
+
+    return (0);
+}
+
+/******************************************************************************
+ Public Functions
+ *****************************************************************************/
+
+int main(int argc, char *argv[])
+{
+    simResult_t result;
+    unsigned i;
+
+    if(argc > 1)
+    {
+        if(readTrace(argv[1]))
+        {
+            return (1);
+        }
+    }
+    else
+    {
+        synthesizeTrace();
+    }
+
+    printf("%u readings over %.1f days\n", (unsigned)traceLength,
+           (trace[traceLength - 1].time - trace[0].time) / 86400000.0);
+    printf("%-16s %6s  %6s  %6s", "policy", "msgs", "saved", "gap");
+    for(i = 0; i < NUM_FIELDS; i++)
+    {
+        printf("  %12s", fieldNames[i]);
+    }
+    printf("\n%-16s %6s  %6s  %6s", "", "", "", "min");
+    for(i = 0; i < NUM_FIELDS; i++)
+    {
+        printf("  %12s", "max/rms");
+    }
+    printf("\n");
+
+    for(i = 0; i < NUM_POLICIES; i++)
+    {
+        runPolicy(&simPolicies[i], false, &result);
+        printResult(simPolicies[i].pName, &result);
+        if(checkResult(&simPolicies[i], &result))
+        {
+            return (1);
+        }
+    }
+
+    /* Failures in the busy hours hold changed readings back */
+    printf("busy channel, 9:00 to 17:00:\n");
+    for(i = 1; i < NUM_POLICIES; i++)
+    {
+        runPolicy(&simPolicies[i], true, &result);
+        printResult(simPolicies[i].pName, &result);
+    }
+
+    return (0);
+}
@@ -0,0 +1,402 @@
+/******************************************************************************
+
+ @file secdev_bench.c
+
+ @brief Host benchmark of the bulk security device add against one add per
+        device, for a collector restoring 50, 200 and 500 devices.
+
+        The MAC side is the stack's own macWrapperAddDevice() and security
+        PIB, run on a thread of its own. The ICall message between the
+        application and the MAC task is modeled by a message allocation and
+        a handoff to that thread and back, the cost that the bulk add saves.
+        The application side splits the list the way ApiMac_secAddDevices()
+        does, and the MAC side loops over the entries the way the
+        MAC_SEC_ADD_DEVICES handler of MacStack.c does.
+
+        Both ways must leave the same device table and per device status.
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "mac_security_pib.h"
+#include "macwrapper.h"
+#include "mac_sec_devices.h"
+
+/******************************************************************************
+ Constants and definitions
+ *****************************************************************************/
+
+/*! PAN ID of the devices */
+#define BENCH_PAN_ID            0xACDC
+
+/*! Timed passes of each list */
+#define BENCH_PASSES            20
+
+/*! A message to the MAC thread, one device or a bulk list */
+typedef struct
+{
+    /*! MAC_SEC_ADD_DEVICES, or 0 for a single device */
+    uint8_t event;
+    /*! Status of a single device add */
+    uint8_t status;
+    /*! Single device, or the bulk request */
+    union
+    {
+        macSecDevicesEntry_t device;
+        macSecAddDevicesParam_t bulk;
+    } u;
+} benchMsg_t;
+
+/******************************************************************************
+ Local Variables
+ *****************************************************************************/
+
+/*! Lookup data of the network key */
+static const uint8_t keyLookup[MAC_SEC_DEVICES_LOOKUP_LEN] =
+{
+    0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x01
+};
+
+/* Handoff to the MAC thread, one message in flight like ICall_waitMatch() */
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t toMac = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t toApp = PTHREAD_COND_INITIALIZER;
+static benchMsg_t *pPending;
+static benchMsg_t *pReply;
+
+/*! Messages sent to the MAC thread */
+static uint32_t numMessages;
+
+/******************************************************************************
+ Local Functions
+ *****************************************************************************/
+
+/*!
+ * @brief       Add a device with the arguments of a bulk entry.
+ *
+ * @param       pEntry - device
+ *
+ * @return      status of macWrapperAddDevice()
+ */
+static uint8_t addEntry(macSecDevicesEntry_t *pEntry)
+{
+    return (macWrapperAddDevice(pEntry->panId, pEntry->shortAddr,
+                                pEntry->extAddr, pEntry->exempt,
+                                pEntry->keyIdLookupDataSize,
+                                pEntry->keyIdLookupData,
+                                pEntry->frameCounter, pEntry->uniqueDevice,
+                                pEntry->duplicateDevFlag));
+}
+
+/*!
+ * @brief       MAC thread, runs each message and hands back the reply.
+ *
+ * @param       pArg - not used
+ *
+ * @return      never returns
+ */
+static void *macThread(void *pArg)
+{
+    (void)pArg;
+
+    pthread_mutex_lock(&lock);
+    for(;;)
+    {
+        benchMsg_t *pMsg;
+
+        while(pPending == NULL)
+        {
+            pthread_cond_wait(&toMac, &lock);
+        }
+        pMsg = pPending;
+        pPending = NULL;
+
+        if(pMsg->event == MAC_SEC_ADD_DEVICES)
+        {
+            uint8_t i;
+
+            pMsg->u.bulk.status = MAC_SUCCESS;
+            for(i = 0; i < pMsg->u.bulk.count; i++)
+            {
+                macSecDevicesEntry_t *pEntry = &pMsg->u.bulk.entries[i];
+
+                pEntry->status = addEntry(pEntry);
+                if((pEntry->status != MAC_SUCCESS)
+                   && (pMsg->u.bulk.status == MAC_SUCCESS))
+                {
+                    pMsg->u.bulk.status = pEntry->status;
+                }
+            }
+        }
+        else
+        {
+            pMsg->status = addEntry(&pMsg->u.device);
+        }
+
+        pReply = pMsg;
+        pthread_cond_signal(&toApp);
+    }
+
+    return (NULL);
+}
+
+/*!
+ * @brief       Send a message to the MAC thread and wait for the reply.
+ *
+ * @param       pMsg - message
+ */
+static void sendAndWait(benchMsg_t *pMsg)
+{
+    pthread_mutex_lock(&lock);
+    pPending = pMsg;
+    numMessages++;
+    pthread_cond_signal(&toMac);
+    while(pReply != pMsg)
+    {
+        pthread_cond_wait(&toApp, &lock);
+    }
+    pReply = NULL;
+    pthread_mutex_unlock(&lock);
+}
+
+/*!
+ * @brief       Add the devices one message each, the path of
+ *              Cllc_addSecDevice().
+ *
+ * @param       pDevices - devices
+ * @param       count - number of devices
+ * @param       pStatus - status of each device
+ */
+static void addOneByOne(const macSecDevicesEntry_t *pDevices, uint16_t count,
+                        uint8_t *pStatus)
+{
+    uint16_t i;
+
+    for(i = 0; i < count; i++)
+    {
+        benchMsg_t *pMsg = malloc(sizeof(benchMsg_t));
+
+        pMsg->event = 0;
+        pMsg->u.device = pDevices[i];
+        sendAndWait(pMsg);
+        pStatus[i] = pMsg->status;
+        free(pMsg);
+    }
+}
+
+/*!
+ * @brief       Add the devices MAC_SEC_DEVICES_MAX_ENTRIES a message, the
+ *              path of ApiMac_secAddDevices().
+ *
+ * @param       pDevices - devices
+ * @param       count - number of devices
+ * @param       pStatus - status of each device
+ */
+static void addBulk(const macSecDevicesEntry_t *pDevices, uint16_t count,
+                    uint8_t *pStatus)
+{
+    uint16_t first;
+
+    for(first = 0; first < count; first += MAC_SEC_DEVICES_MAX_ENTRIES)
+    {
+        uint8_t group = ((count - first) > MAC_SEC_DEVICES_MAX_ENTRIES) ?
+                        MAC_SEC_DEVICES_MAX_ENTRIES : (count - first);
+        benchMsg_t *pMsg;
+        uint8_t i;
+
+        pMsg = malloc(sizeof(benchMsg_t)
+                      + (group * sizeof(macSecDevicesEntry_t)));
+        pMsg->event = MAC_SEC_ADD_DEVICES;
+        pMsg->u.bulk.count = group;
+        memcpy(pMsg->u.bulk.entries, &pDevices[first],
+               group * sizeof(macSecDevicesEntry_t));
+
+        sendAndWait(pMsg);
+
+        for(i = 0; i < group; i++)
+        {
+            pStatus[first + i] = pMsg->u.bulk.entries[i].status;
+        }
+        free(pMsg);
+    }
+}
+
+/*!
+ * @brief       Empty the device table and load the network key, as after a
+ *              collector reset.
+ */
+static void resetTables(void)
+{
+    static uint8_t key[MAC_KEY_MAX_LEN];
+    uint8_t lookupList[2 + MAC_SEC_DEVICES_LOOKUP_LEN];
+
+    macSecurityPibReset();
+    MAC_MlmeSetSecurityReq(MAC_KEY_TABLE, NULL);
+
+    lookupList[0] = 1;
+    lookupList[1] = MAC_SEC_DEVICES_LOOKUP_LEN;
+    memcpy(&lookupList[2], keyLookup, MAC_SEC_DEVICES_LOOKUP_LEN);
+    macWrapperAddKeyInitFCtr(key, 0, 0, 1, lookupList);
+}
+
+/*!
+ * @brief       Hash the devices of the network key, in key device list
+ *              order. Unused device table entries are left out,
+ *              macWrapperAddDevice() leaves their frame counters as they
+ *              were when it fills the table.
+ *
+ * @return      hash
+ */
+static uint32_t hashTables(void)
+{
+    uint32_t hash = macSecurityPib.macKeyTable[0].keyDeviceListEntries;
+    uint16_t i;
+
+    for(i = 0; i < macSecurityPib.macKeyTable[0].keyDeviceListEntries; i++)
+    {
+        uint8_t handle =
+                    macSecurityPib.macKeyDeviceList[0][i].deviceDescriptorHandle;
+        deviceDescriptor_t *pDev = &macSecurityPib.macDeviceTable[handle];
+        uint8_t j;
+
+        hash = (hash * 31) + handle;
+        hash = (hash * 31) + pDev->panID;
+        hash = (hash * 31) + pDev->shortAddress;
+        hash = (hash * 31) + pDev->frameCounter[0];
+        for(j = 0; j < SADDR_EXT_LEN; j++)
+        {
+            hash = (hash * 31) + pDev->extAddress[j];
+        }
+    }
+
+    return (hash);
+}
+
+/*!
+ * @brief       Read a monotonic clock.
+ *
+ * @return      time, in nanoseconds
+ */
+static uint64_t readNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (((uint64_t)ts.tv_sec * 1000000000u) + (uint64_t)ts.tv_nsec);
+}
+
+/******************************************************************************
+ Public Functions
+ *****************************************************************************/
+
+int main(void)
+{
+    static const uint16_t counts[] = { 50, 200, 500 };
+    pthread_t thread;
+    unsigned int c;
+
+    pthread_create(&thread, NULL, macThread, NULL);
+
+    for(c = 0; c < sizeof(counts) / sizeof(counts[0]); c++)
+    {
+        uint16_t count = counts[c];
+        macSecDevicesEntry_t *pDevices;
+        uint8_t *pOneStatus;
+        uint8_t *pBulkStatus;
+        uint64_t oneNs = 0;
+        uint64_t bulkNs = 0;
+        uint32_t oneMessages;
+        uint32_t bulkMessages;
+        uint32_t oneHash = 0;
+        uint32_t bulkHash = 0;
+        uint16_t added = 0;
+        uint16_t i;
+        int pass;
+
+        pDevices = calloc(count, sizeof(macSecDevicesEntry_t));
+        pOneStatus = malloc(count);
+        pBulkStatus = malloc(count);
+
+        for(i = 0; i < count; i++)
+        {
+            macSecDevicesEntry_t *pDevice = &pDevices[i];
+
+            pDevice->panId = BENCH_PAN_ID;
+            pDevice->shortAddr = (uint16_t)(i + 1);
+            memset(pDevice->extAddr, 0x12, MAC_SEC_DEVICES_EXT_LEN);
+            pDevice->extAddr[0] = (uint8_t)i;
+            pDevice->extAddr[1] = (uint8_t)(i >> 8);
+            pDevice->frameCounter = (uint32_t)i * 7;
+            pDevice->keyIdLookupDataSize = 1;
+            memcpy(pDevice->keyIdLookupData, keyLookup,
+                   MAC_SEC_DEVICES_LOOKUP_LEN);
+        }
+
+        for(pass = 0; pass < BENCH_PASSES; pass++)
+        {
+            uint64_t start;
+
+            resetTables();
+            numMessages = 0;
+            start = readNs();
+            addOneByOne(pDevices, count, pOneStatus);
+            oneNs += readNs() - start;
+            oneMessages = numMessages;
+            oneHash = hashTables();
+
+            resetTables();
+            numMessages = 0;
+            start = readNs();
+            addBulk(pDevices, count, pBulkStatus);
+            bulkNs += readNs() - start;
+            bulkMessages = numMessages;
+            bulkHash = hashTables();
+
+            if((oneHash != bulkHash)
+               || (memcmp(pOneStatus, pBulkStatus, count) != 0))
+            {
+                printf("FAIL: %u devices, tables or status differ\n", count);
+                return (1);
+            }
+        }
+
+        for(i = 0; i < count; i++)
+        {
+            if(pBulkStatus[i] == MAC_SUCCESS)
+            {
+                added++;
+            }
+        }
+        if(added != ((count < MAX_DEVICE_TABLE_ENTRIES) ?
+                        count : MAX_DEVICE_TABLE_ENTRIES))
+        {
+            printf("FAIL: %u devices, %u added\n", count, added);
+            return (1);
+        }
+
+        printf("secdev %3u devices (%u added): one by one %4u messages "
+               "%8.1f us, bulk %3u messages %8.1f us, %.1fx\n",
+               count, added, oneMessages,
+               (double)oneNs / (1000.0 * BENCH_PASSES), bulkMessages,
+               (double)bulkNs / (1000.0 * BENCH_PASSES),
+               (double)oneNs / (double)(bulkNs ? bulkNs : 1));
+
+        free(pDevices);
+        free(pOneStatus);
+        free(pBulkStatus);
+    }
+
+    return (0);
+}
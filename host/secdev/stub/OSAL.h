@@ -0,0 +1,14 @@
+/******************************************************************************
+
+ @file OSAL.h
+
+ @brief Host stand-in for the OSAL header, spelled as macwrapper.c includes
+        it.
+
+ *****************************************************************************/
+#ifndef OSAL_UPPER_H
+#define OSAL_UPPER_H
+
+#include "osal.h"
+
+#endif /* OSAL_UPPER_H */
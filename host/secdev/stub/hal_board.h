@@ -0,0 +1,12 @@
+/******************************************************************************
+
+ @file hal_board.h
+
+ @brief Host stand-in for the MAC stack header of the same name, nothing of
+        it is used by the code under test.
+
+ *****************************************************************************/
+#ifndef HAL_BOARD_H
+#define HAL_BOARD_H
+
+#endif /* HAL_BOARD_H */
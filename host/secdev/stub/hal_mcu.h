@@ -0,0 +1,17 @@
+/******************************************************************************
+
+ @file hal_mcu.h
+
+ @brief Host stand-in for the HAL critical sections, the host test has one
+        thread in the MAC code at a time.
+
+ *****************************************************************************/
+#ifndef HAL_MCU_H
+#define HAL_MCU_H
+
+typedef int halIntState_t;
+
+#define HAL_ENTER_CRITICAL_SECTION(x)   ((x) = 0)
+#define HAL_EXIT_CRITICAL_SECTION(x)    ((void)(x))
+
+#endif /* HAL_MCU_H */
@@ -0,0 +1,76 @@
+/******************************************************************************
+
+ @file mac_api.h
+
+ @brief Host stand-in for the MAC stack header of the same name: only the
+        types and constants that macwrapper.c and mac_security_pib.c use.
+
+ *****************************************************************************/
+#ifndef MAC_API_H
+#define MAC_API_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef uint8_t uint8;
+typedef uint16_t uint16;
+typedef uint32_t uint32;
+typedef int8_t int8;
+
+#define TRUE                                1
+#define FALSE                               0
+#define CODE
+#define MAC_INTERNAL_API
+
+#define SADDR_EXT_LEN                       8
+typedef uint8 sAddrExt_t[SADDR_EXT_LEN];
+typedef struct
+{
+    union
+    {
+        uint16 shortAddr;
+        sAddrExt_t extAddr;
+    } addr;
+    uint8 addrMode;
+} sAddr_t;
+#define SADDR_MODE_EXT                      3
+#define MAC_SHORT_ADDR_NONE                 0xFFFE
+
+#define MAC_SUCCESS                         0x00
+#define MAC_NO_RESOURCES                    0x1A
+#define MAC_INVALID_PARAMETER               0xE8
+#define MAC_UNAVAILABLE_KEY                 0xF3
+#define MAC_UNSUPPORTED_ATTRIBUTE           0xF4
+#define MAC_READ_ONLY                       0xFB
+#define MAC_BAD_STATE                       0xFC
+
+#define MAC_KEY_LOOKUP_SHORT_LEN            5
+#define MAC_KEY_LOOKUP_LONG_LEN             9
+#define MAC_KEY_MAX_LEN                     16
+#define MAC_KEY_SOURCE_MAX_LEN              8
+
+#define MAC_FRAME_TYPE_DATA                 1
+#define MAC_FRAME_TYPE_COMMAND              3
+#define MAC_DATA_REQ_FRAME                  4
+#define MAC_SEC_LEVEL_ENC_MIC_32            5
+
+#define MAC_KEY_TABLE                       0x71
+#define MAC_DEVICE_TABLE                    0x72
+#define MAC_SECURITY_LEVEL_TABLE            0x73
+#define MAC_KEY_TABLE_ENTRIES               0x81
+#define MAC_DEVICE_TABLE_ENTRIES            0x82
+#define MAC_SECURITY_LEVEL_TABLE_ENTRIES    0x83
+#define MAC_FRAME_COUNTER                   0x84
+#define MAC_DEFAULT_KEY_SOURCE              0x89
+#define MAC_KEY_ID_LOOKUP_ENTRY             0xD0
+#define MAC_KEY_DEVICE_ENTRY                0xD1
+#define MAC_KEY_USAGE_ENTRY                 0xD2
+#define MAC_KEY_ENTRY                       0xD3
+#define MAC_DEVICE_ENTRY                    0xD4
+#define MAC_SECURITY_LEVEL_ENTRY            0xD5
+
+extern uint8 MAC_MlmeGetSecurityReq(uint8 pibAttribute, void *pValue);
+extern uint8 MAC_MlmeSetSecurityReq(uint8 pibAttribute, void *pValue);
+
+#endif /* MAC_API_H */
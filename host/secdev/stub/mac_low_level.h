@@ -0,0 +1,12 @@
+/******************************************************************************
+
+ @file mac_low_level.h
+
+ @brief Host stand-in for the MAC stack header of the same name, nothing of
+        it is used by the code under test.
+
+ *****************************************************************************/
+#ifndef MAC_LOW_LEVEL_H
+#define MAC_LOW_LEVEL_H
+
+#endif /* MAC_LOW_LEVEL_H */
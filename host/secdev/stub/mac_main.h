@@ -0,0 +1,12 @@
+/******************************************************************************
+
+ @file mac_main.h
+
+ @brief Host stand-in for the MAC stack header of the same name, nothing of
+        it is used by the code under test.
+
+ *****************************************************************************/
+#ifndef MAC_MAIN_H
+#define MAC_MAIN_H
+
+#endif /* MAC_MAIN_H */
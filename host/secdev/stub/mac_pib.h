@@ -0,0 +1,12 @@
+/******************************************************************************
+
+ @file mac_pib.h
+
+ @brief Host stand-in for the MAC stack header of the same name, nothing of
+        it is used by the code under test.
+
+ *****************************************************************************/
+#ifndef MAC_PIB_H
+#define MAC_PIB_H
+
+#endif /* MAC_PIB_H */
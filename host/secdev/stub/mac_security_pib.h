@@ -0,0 +1,138 @@
+/******************************************************************************
+
+ @file mac_security_pib.h
+
+ @brief Host stand-in for the MAC stack header of the same name. The table
+        sizes follow the collector build, MAX_DEVICE_TABLE_ENTRIES is given
+        on the command line.
+
+ *****************************************************************************/
+#ifndef MAC_SECURITY_PIB_H
+#define MAC_SECURITY_PIB_H
+
+#include "mac_api.h"
+
+#define MAX_KEY_TABLE_ENTRIES               2
+#define MAX_KEY_ID_LOOKUP_ENTRIES           1
+#define MAX_KEY_DEVICE_TABLE_ENTRIES        MAX_DEVICE_TABLE_ENTRIES
+#define MAX_KEY_USAGE_TABLE_ENTRIES         2
+#define MAX_SECURITY_LEVEL_TABLE_ENTRIES    2
+
+typedef struct
+{
+    uint8 lookupData[MAC_KEY_LOOKUP_LONG_LEN];
+    uint8 lookupDataSize;
+} keyIdLookupDescriptor_t;
+
+typedef struct
+{
+    uint8 deviceDescriptorHandle;
+    bool uniqueDevice;
+    bool blackListed;
+} keyDeviceDescriptor_t;
+
+typedef struct
+{
+    uint8 frameType;
+    uint8 cmdFrameId;
+} keyUsageDescriptor_t;
+
+typedef struct
+{
+    keyIdLookupDescriptor_t *keyIdLookupList;
+    uint8 keyIdLookupEntries;
+    keyDeviceDescriptor_t *keyDeviceList;
+    uint8 keyDeviceListEntries;
+    keyUsageDescriptor_t *keyUsageList;
+    uint8 keyUsageListEntries;
+    uint8 key[MAC_KEY_MAX_LEN];
+    uint32 frameCounter;
+} keyDescriptor_t;
+
+typedef struct
+{
+    uint16 panID;
+    uint16 shortAddress;
+    sAddrExt_t extAddress;
+    uint32 frameCounter[MAX_KEY_TABLE_ENTRIES];
+    bool exempt;
+} deviceDescriptor_t;
+
+typedef struct
+{
+    uint8 frameType;
+    uint8 commandFrameIdentifier;
+    uint8 securityMinimum;
+    bool securityOverrideSecurityMinimum;
+} securityLevelDescriptor_t;
+
+typedef struct
+{
+    uint8 keyTableEntries;
+    uint8 deviceTableEntries;
+    uint8 securityLevelTableEntries;
+    uint8 autoRequestSecurityLevel;
+    uint8 autoRequestKeyIdMode;
+    uint8 autoRequestKeySource[MAC_KEY_SOURCE_MAX_LEN];
+    uint8 autoRequestKeyIndex;
+    uint8 defaultKeySource[MAC_KEY_SOURCE_MAX_LEN];
+    sAddr_t panCoordExtendedAddress;
+    uint16 panCoordShortAddress;
+    keyDescriptor_t macKeyTable[MAX_KEY_TABLE_ENTRIES];
+    keyIdLookupDescriptor_t
+        macKeyIdLookupList[MAX_KEY_TABLE_ENTRIES][MAX_KEY_ID_LOOKUP_ENTRIES];
+    keyDeviceDescriptor_t
+        macKeyDeviceList[MAX_KEY_TABLE_ENTRIES][MAX_KEY_DEVICE_TABLE_ENTRIES];
+    keyUsageDescriptor_t
+        macKeyUsageList[MAX_KEY_TABLE_ENTRIES][MAX_KEY_USAGE_TABLE_ENTRIES];
+    deviceDescriptor_t macDeviceTable[MAX_DEVICE_TABLE_ENTRIES];
+    securityLevelDescriptor_t
+        macSecurityLevelTable[MAX_SECURITY_LEVEL_TABLE_ENTRIES];
+} macSecurityPib_t;
+
+typedef struct
+{
+    uint8 key_index;
+    uint8 key_id_lookup_index;
+    keyIdLookupDescriptor_t macKeyIdLookupEntry;
+} macSecurityPibKeyIdLookupEntry_t;
+
+typedef struct
+{
+    uint8 key_index;
+    uint8 key_device_index;
+    keyDeviceDescriptor_t macKeyDeviceEntry;
+} macSecurityPibKeyDeviceEntry_t;
+
+typedef struct
+{
+    uint8 key_index;
+    uint8 key_key_usage_index;
+    keyUsageDescriptor_t macKeyUsageEntry;
+} macSecurityPibKeyUsageEntry_t;
+
+typedef struct
+{
+    uint8 key_index;
+    uint8 keyEntry[MAC_KEY_MAX_LEN];
+    uint32 frameCounter;
+} macSecurityPibKeyEntry_t;
+
+typedef struct
+{
+    uint8 device_index;
+    deviceDescriptor_t macDeviceEntry;
+} macSecurityPibDeviceEntry_t;
+
+typedef struct
+{
+    uint8 security_level_index;
+    securityLevelDescriptor_t macSecurityLevelEntry;
+} macSecurityPibSecurityLevelEntry_t;
+
+extern macSecurityPib_t macSecurityPib;
+#define pMacSecurityPib (&macSecurityPib)
+
+extern void macSecurityPibReset(void);
+
+#endif /* MAC_SECURITY_PIB_H */
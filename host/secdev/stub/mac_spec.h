@@ -0,0 +1,12 @@
+/******************************************************************************
+
+ @file mac_spec.h
+
+ @brief Host stand-in for the MAC stack header of the same name, nothing of
+        it is used by the code under test.
+
+ *****************************************************************************/
+#ifndef MAC_SPEC_H
+#define MAC_SPEC_H
+
+#endif /* MAC_SPEC_H */
@@ -0,0 +1,33 @@
+/******************************************************************************
+
+ @file macwrapper.h
+
+ @brief Host stand-in for the MAC stack header of the same name.
+
+ *****************************************************************************/
+#ifndef MACWRAPPER_H
+#define MACWRAPPER_H
+
+#include "mac_api.h"
+
+extern unsigned char macWrapperAddDevice(unsigned short panId,
+                                         unsigned short shortAddr,
+                                         const unsigned char *extAddr,
+                                         unsigned char exempt,
+                                         unsigned char keyIdLookupDataSize,
+                                         const unsigned char *keyIdLookupData,
+                                         unsigned long frameCounter,
+                                         unsigned char uniqueDevice,
+                                         unsigned char duplicateDevFlag);
+extern unsigned char macWrapperDeleteDevice(const unsigned char *extAddr);
+extern unsigned char macWrapperAddKeyInitFCtr(unsigned char *pKey,
+                                              uint32 frameCounter,
+                                              unsigned char replaceKeyIndex,
+                                              unsigned char newKeyFlag,
+                                              uint8 *pLookupList);
+extern unsigned char macWrapperGetDefaultSourceKey(unsigned char keyid,
+                                                   unsigned long *pFrameCounter);
+extern unsigned char macWrapperDeleteKeyAndAssociatedDevices(uint8 keyIndex);
+extern unsigned char macWrapperDeleteAllDevices(void);
+
+#endif /* MACWRAPPER_H */
@@ -0,0 +1,17 @@
+/******************************************************************************
+
+ @file osal.h
+
+ @brief Host stand-in for the OSAL memory helpers.
+
+ *****************************************************************************/
+#ifndef OSAL_H
+#define OSAL_H
+
+#include <string.h>
+
+#define osal_memcpy             memcpy
+#define osal_memset             memset
+#define osal_memcmp(a, b, n)    (memcmp((a), (b), (n)) == 0)
+
+#endif /* OSAL_H */
@@ -0,0 +1,757 @@
+/******************************************************************************
+
+ @file snv_test.c
+
+ @brief Host test and benchmark of the OSAL simple NV, osal_snv.c of the
+        stack, on simulated flash.
+
+        The checker runs random writes, unchanged writes, compactions and
+        power cycles against a model of the items. Every compaction is
+        replayed on a copy of the page by the compaction osal_snv.c had
+        before the copied-ID bitmap, which searched the destination page
+        for each item, and both pages must be the same. The old one lost
+        item 255, the replay starts without that bug so the checker, which
+        writes IDs 1 to 255, also covers the fix. Unchanged writes must
+        leave the flash as it was.
+
+        The benchmark fills a page with 8 byte items to 95% with updates,
+        then times osal_snv_compact(70) and unchanged writes, for 16 to
+        255 items. Reads are HalFlashRead() calls, those of the old
+        compaction counted on the copy of the page.
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "hal_flash.h"
+#include "comdef.h"
+#include "osal_snv.h"
+
+/******************************************************************************
+ Constants and definitions
+ *****************************************************************************/
+
+/*! Page and flash word sizes */
+#define PAGE_SIZE               HAL_FLASH_PAGE_SIZE
+#define WORD_SIZE               HAL_FLASH_WORD_SIZE
+
+/*! Page header of the active page, as osal_snv.c writes it */
+#define ACTIVE_PAGE_STATE       0x00100000
+
+/*! Item header marks */
+#define INVALID_LEN_MARK        0x8000
+#define INVALID_ID_MARK         0x8000
+
+/*! Random operations of the checker */
+#define CHECK_OPS               20000
+
+/*! Longest item of the checker, every ID fits in a page */
+#define CHECK_MAX_LEN           8
+
+/*! Checker operations between reads of every item */
+#define CHECK_ALL_EVERY         500
+
+/*! Length of the benchmark items */
+#define BENCH_LEN               8
+
+/*! Compactions timed for each item count */
+#define BENCH_REPS              50
+
+/*! Item header */
+typedef struct
+{
+    uint16_t id;
+    uint16_t len;
+} itemHdr_t;
+
+/*! Item of the model */
+typedef struct
+{
+    bool present;
+    uint16_t len;
+    uint8_t value[CHECK_MAX_LEN];
+} modelItem_t;
+
+/*! Reads of the old compaction */
+typedef struct
+{
+    /*! Every read */
+    unsigned int total;
+    /*! Reads searching the destination page */
+    unsigned int search;
+} refReads_t;
+
+/******************************************************************************
+ Global Variables
+ *****************************************************************************/
+
+/*! NV area of osal_snv.c, its address gives the page numbers */
+extern const uint8 SNV_FLASH[];
+
+/******************************************************************************
+ Local Variables
+ *****************************************************************************/
+
+/*! The simulated NV pages */
+static uint8_t simFlash[HAL_NV_PAGE_CNT][PAGE_SIZE]
+                __attribute__((aligned(PAGE_SIZE)));
+
+/*! Page number of the first NV page, as osal_snv_init() finds it */
+static uint8_t pageBase;
+
+/*! HalFlashRead() calls */
+static unsigned int flashReads;
+
+/*! HAL_ASSERT_FORCED() calls */
+static unsigned int asserts;
+
+/*! Items the checker wrote */
+static modelItem_t model[256];
+
+/*! Noise of the checker, the same on every run */
+static uint32_t randState = 1;
+
+/******************************************************************************
+ Local Functions
+ *****************************************************************************/
+
+/*!
+ * @brief       Pseudo random number.
+ *
+ * @param       range - values from 0 to range - 1
+ *
+ * @return      the number
+ */
+static uint32_t randomRange(uint32_t range)
+{
+    randState = randState * 1103515245 + 12345;
+
+    return ((randState >> 8) % range);
+}
+
+/*!
+ * @brief       Read a monotonic clock.
+ *
+ * @return      time, in nanoseconds
+ */
+static uint64_t readNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (((uint64_t)ts.tv_sec * 1000000000u) + (uint64_t)ts.tv_nsec);
+}
+
+/*!
+ * @brief       Find the active page.
+ *
+ * @return      index of the page in simFlash, -1 if none is active
+ */
+static int activePage(void)
+{
+    int i;
+
+    for(i = 0; i < HAL_NV_PAGE_CNT; i++)
+    {
+        uint32_t hdr;
+
+        memcpy(&hdr, simFlash[i], sizeof(hdr));
+        if(hdr == ACTIVE_PAGE_STATE)
+        {
+            return (i);
+        }
+    }
+    return (-1);
+}
+
+/*!
+ * @brief       Find the end of the items of a page, the way findOffset()
+ *              does.
+ *
+ * @param       pPage - page
+ *
+ * @return      offset of the first erased word after the items
+ */
+static uint16_t usedOffset(const uint8_t *pPage)
+{
+    uint16_t offset;
+
+    for(offset = PAGE_SIZE; offset > WORD_SIZE; offset -= WORD_SIZE)
+    {
+        uint32_t word;
+
+        memcpy(&word, &pPage[offset - WORD_SIZE], WORD_SIZE);
+        if(word != 0xFFFFFFFF)
+        {
+            break;
+        }
+    }
+    return (offset);
+}
+
+/*!
+ * @brief       Read an item header of a page copy, counted.
+ *
+ * @param       pPage - page
+ * @param       offset - offset of the header
+ * @param       pReads - read counter
+ *
+ * @return      the header
+ */
+static itemHdr_t refReadHdr(const uint8_t *pPage, uint16_t offset,
+                            unsigned int *pReads)
+{
+    itemHdr_t hdr;
+
+    memcpy(&hdr, &pPage[offset], sizeof(hdr));
+    (*pReads)++;
+    return (hdr);
+}
+
+/*!
+ * @brief       findItem() of osal_snv.c on a page copy.
+ *
+ * @param       pPage - page
+ * @param       offset - end of the items
+ * @param       id - item ID
+ * @param       pReads - read counter
+ *
+ * @return      offset of the item, 0 when not found
+ */
+static uint16_t refFindItem(const uint8_t *pPage, uint16_t offset,
+                            uint16_t id, unsigned int *pReads)
+{
+    offset -= WORD_SIZE;
+
+    while(offset >= WORD_SIZE)
+    {
+        itemHdr_t hdr = refReadHdr(pPage, offset, pReads);
+
+        if(hdr.id == id)
+        {
+            return (offset - (hdr.len & ~INVALID_LEN_MARK));
+        }
+        else if(hdr.len & INVALID_LEN_MARK)
+        {
+            offset -= WORD_SIZE;
+        }
+        else
+        {
+            offset -= hdr.len + WORD_SIZE;
+        }
+    }
+    return (0);
+}
+
+/*!
+ * @brief       The compaction of osal_snv.c before the copied-ID bitmap, on
+ *              a page copy: each item is searched for in the destination
+ *              page. lastId starts at no ID, without the loss of item 255.
+ *
+ * @param       pSrc - source page
+ * @param       srcEnd - end of the items of the source page
+ * @param       pDst - destination page, erased
+ * @param       pReads - reads, out. Those of the verify after each word
+ *                       write and of the two page headers are counted,
+ *                       as the stack does them.
+ *
+ * @return      end of the items of the destination page
+ */
+static uint16_t refCompact(const uint8_t *pSrc, uint16_t srcEnd,
+                           uint8_t *pDst, refReads_t *pReads)
+{
+    uint16_t srcOff = srcEnd - WORD_SIZE;
+    uint16_t dstOff = WORD_SIZE;
+    int32_t lastId = -1;
+
+    memset(pReads, 0, sizeof(*pReads));
+
+    while(srcOff >= WORD_SIZE)
+    {
+        itemHdr_t hdr = refReadHdr(pSrc, srcOff, &pReads->total);
+
+        if(hdr.id == 0xFFFF)
+        {
+            srcOff -= (hdr.len & INVALID_LEN_MARK) ?
+                            WORD_SIZE : (hdr.len + WORD_SIZE);
+            continue;
+        }
+
+        if(!(hdr.id & INVALID_ID_MARK) && ((int32_t)hdr.id != lastId))
+        {
+            lastId = hdr.id;
+
+            if(refFindItem(pDst, dstOff, hdr.id, &pReads->search) == 0)
+            {
+                /* Read, write and verify each word, header included */
+                memcpy(&pDst[dstOff], &pSrc[srcOff - hdr.len],
+                       hdr.len + WORD_SIZE);
+                pReads->total += 2 * ((hdr.len / WORD_SIZE) + 1);
+                dstOff += hdr.len + WORD_SIZE;
+            }
+        }
+        srcOff -= hdr.len + WORD_SIZE;
+    }
+
+    /* Verify of the transfer and active page headers */
+    pReads->total += 2 + pReads->search;
+    return (dstOff);
+}
+
+/*!
+ * @brief       Check a compaction against the old one.
+ *
+ * @param       pSrc - copy of the active page before the compaction
+ * @param       srcIdx - index of that page in simFlash
+ * @param       itemAdded - true if a write added an item after it
+ * @param       pReads - reads of the old compaction, out, can be NULL
+ *
+ * @return      0 on success, 1 on a failure
+ */
+static int checkCompaction(const uint8_t *pSrc, int srcIdx, bool itemAdded,
+                           refReads_t *pReads)
+{
+    static uint8_t dst[PAGE_SIZE];
+    refReads_t reads;
+    int dstIdx = activePage();
+    uint16_t dstEnd;
+    uint16_t i;
+
+    memset(dst, 0xFF, sizeof(dst));
+    dstEnd = refCompact(pSrc, usedOffset(pSrc), dst, &reads);
+
+    if((dstIdx < 0) || (dstIdx == srcIdx))
+    {
+        printf("FAIL: no new active page after the compaction\n");
+        return (1);
+    }
+
+    if(memcmp(&simFlash[dstIdx][WORD_SIZE], &dst[WORD_SIZE],
+              dstEnd - WORD_SIZE)
+       || (!itemAdded && (usedOffset(simFlash[dstIdx]) != dstEnd)))
+    {
+        printf("FAIL: compacted page differs from the old compaction\n");
+        return (1);
+    }
+
+    for(i = 0; i < PAGE_SIZE; i++)
+    {
+        if(simFlash[srcIdx][i] != 0xFF)
+        {
+            printf("FAIL: old page not erased after the compaction\n");
+            return (1);
+        }
+    }
+
+    if(pReads != NULL)
+    {
+        *pReads = reads;
+    }
+    return (0);
+}
+
+/*!
+ * @brief       Read an item back and compare it with the model.
+ *
+ * @param       id - item ID
+ *
+ * @return      0 on success, 1 on a failure
+ */
+static int checkItem(uint8_t id)
+{
+    uint8_t buf[CHECK_MAX_LEN];
+
+    if(!model[id].present)
+    {
+        return (0);
+    }
+
+    if((osal_snv_read(id, model[id].len, buf) != SUCCESS)
+       || memcmp(buf, model[id].value, model[id].len))
+    {
+        printf("FAIL: item %u does not read back\n", id);
+        return (1);
+    }
+    return (0);
+}
+
+/*!
+ * @brief       Read every item back.
+ *
+ * @return      0 on success, 1 on a failure
+ */
+static int checkAll(void)
+{
+    unsigned int id;
+
+    for(id = 1; id < 256; id++)
+    {
+        if(checkItem((uint8_t)id))
+        {
+            return (1);
+        }
+    }
+    return (0);
+}
+
+/*!
+ * @brief       Erase the simulated flash and start osal_snv on it.
+ *
+ * @return      0 on success, 1 on a failure
+ */
+static int startBlank(void)
+{
+    memset(simFlash, 0xFF, sizeof(simFlash));
+    memset(model, 0, sizeof(model));
+
+    if(osal_snv_init() != SUCCESS)
+    {
+        printf("FAIL: osal_snv_init() on erased flash\n");
+        return (1);
+    }
+    return (0);
+}
+
+/*!
+ * @brief       Random writes, unchanged writes, compactions and power cycles
+ *              against the model.
+ *
+ * @return      0 on success, 1 on a failure
+ */
+static int runChecker(void)
+{
+    static uint8_t before[HAL_NV_PAGE_CNT][PAGE_SIZE];
+    unsigned int compactions = 0;
+    unsigned int unchanged = 0;
+    unsigned int op;
+
+    if(startBlank())
+    {
+        return (1);
+    }
+
+    for(op = 0; op < CHECK_OPS; op++)
+    {
+        uint32_t r = randomRange(100);
+        int srcIdx = activePage();
+
+        memcpy(before, simFlash, sizeof(simFlash));
+
+        if(r < 2)
+        {
+            /* Power cycle */
+            if((osal_snv_init() != SUCCESS) || checkAll())
+            {
+                printf("FAIL: items lost over a power cycle\n");
+                return (1);
+            }
+        }
+        else if(r < 7)
+        {
+            if(osal_snv_compact(70) == SUCCESS)
+            {
+                compactions++;
+                if(checkCompaction(before[srcIdx], srcIdx, false, NULL))
+                {
+                    return (1);
+                }
+            }
+            else if(memcmp(before, simFlash, sizeof(simFlash)))
+            {
+                printf("FAIL: compaction below the threshold wrote\n");
+                return (1);
+            }
+        }
+        else
+        {
+            uint8_t id = (uint8_t)(1 + randomRange(255));
+            modelItem_t *pItem = &model[id];
+            bool same = pItem->present && (randomRange(3) == 0);
+            uint8_t i;
+
+            if(!same)
+            {
+                pItem->len = (uint16_t)(1 + randomRange(CHECK_MAX_LEN));
+                for(i = 0; i < pItem->len; i++)
+                {
+                    pItem->value[i] = (uint8_t)randomRange(256);
+                }
+            }
+
+            if(osal_snv_write(id, pItem->len, pItem->value) != SUCCESS)
+            {
+                printf("FAIL: write of item %u\n", id);
+                return (1);
+            }
+            pItem->present = true;
+
+            if(same)
+            {
+                unchanged++;
+                if(memcmp(before, simFlash, sizeof(simFlash)))
+                {
+                    printf("FAIL: unchanged write of item %u wrote\n", id);
+                    return (1);
+                }
+            }
+            else if(activePage() != srcIdx)
+            {
+                compactions++;
+                if(checkCompaction(before[srcIdx], srcIdx, true, NULL))
+                {
+                    return (1);
+                }
+            }
+
+            if(checkItem(id))
+            {
+                return (1);
+            }
+        }
+
+        if(((op % CHECK_ALL_EVERY) == 0) && checkAll())
+        {
+            return (1);
+        }
+    }
+
+    if(checkAll() || (asserts != 0))
+    {
+        printf("FAIL: %u asserts\n", asserts);
+        return (1);
+    }
+
+    printf("checker: %u operations, %u compactions, %u unchanged writes\n",
+           CHECK_OPS, compactions, unchanged);
+    return (0);
+}
+
+/*!
+ * @brief       Update the items with new values until the page is full to
+ *              95%.
+ *
+ * @param       count - items, IDs 1 to count
+ * @param       pRound - value round, bumped
+ *
+ * @return      0 on success, 1 on a failure
+ */
+static int fillPage(unsigned int count, uint8_t *pRound)
+{
+    unsigned int id = 1;
+
+    while((usedOffset(simFlash[activePage()]) * 100) < (PAGE_SIZE * 95))
+    {
+        modelItem_t *pItem = &model[id];
+
+        memset(pItem->value, *pRound, BENCH_LEN);
+        pItem->value[0] = (uint8_t)id;
+        pItem->len = BENCH_LEN;
+        pItem->present = true;
+
+        if(osal_snv_write((uint8_t)id, BENCH_LEN, pItem->value) != SUCCESS)
+        {
+            printf("FAIL: benchmark write of item %u\n", id);
+            return (1);
+        }
+
+        if(++id > count)
+        {
+            id = 1;
+            (*pRound)++;
+        }
+    }
+    return (0);
+}
+
+/*!
+ * @brief       Time the compaction and the unchanged writes of a page of
+ *              items.
+ *
+ * @param       count - items, IDs 1 to count
+ *
+ * @return      0 on success, 1 on a failure
+ */
+static int runBench(unsigned int count)
+{
+    static uint8_t before[PAGE_SIZE];
+    uint64_t compactNs = 0;
+    uint64_t writeNs = 0;
+    unsigned long compactReads = 0;
+    unsigned long writeReads = 0;
+    unsigned long oldReads = 0;
+    uint8_t round = 1;
+    unsigned int rep;
+    unsigned int id;
+
+    if(startBlank())
+    {
+        return (1);
+    }
+
+    for(rep = 0; rep < BENCH_REPS; rep++)
+    {
+        refReads_t reads;
+        unsigned int startReads;
+        uint64_t start;
+        int srcIdx;
+
+        if(fillPage(count, &round))
+        {
+            return (1);
+        }
+
+        srcIdx = activePage();
+        memcpy(before, simFlash[srcIdx], PAGE_SIZE);
+
+        startReads = flashReads;
+        start = readNs();
+        if(osal_snv_compact(70) != SUCCESS)
+        {
+            printf("FAIL: osal_snv_compact(70) of a full page\n");
+            return (1);
+        }
+        compactNs += readNs() - start;
+        compactReads += flashReads - startReads;
+
+        if(checkCompaction(before, srcIdx, false, &reads))
+        {
+            return (1);
+        }
+        oldReads += reads.total;
+
+        /* The same work, without the search of the destination page */
+        if((flashReads - startReads) != (reads.total - reads.search))
+        {
+            printf("FAIL: %u compaction reads, %u - %u expected\n",
+                   flashReads - startReads, reads.total, reads.search);
+            return (1);
+        }
+    }
+
+    /* Unchanged writes, the item is found and compared in place */
+    for(id = 1; id <= count; id++)
+    {
+        unsigned int startReads = flashReads;
+        uint64_t start = readNs();
+
+        if(osal_snv_write((uint8_t)id, BENCH_LEN, model[id].value)
+           != SUCCESS)
+        {
+            printf("FAIL: unchanged write of item %u\n", id);
+            return (1);
+        }
+        writeNs += readNs() - start;
+        writeReads += flashReads - startReads;
+    }
+
+    if(checkAll() || (asserts != 0))
+    {
+        return (1);
+    }
+
+    /* The old compare read each byte after the same search */
+    printf("%5u items: compaction %6.1f reads (old %7.1f) %6.2f us, "
+           "unchanged write %5.1f reads (old %5.1f) %5.2f us\n", count,
+           (double)compactReads / BENCH_REPS, (double)oldReads / BENCH_REPS,
+           (double)compactNs / BENCH_REPS / 1000.0,
+           (double)writeReads / count,
+           ((double)writeReads / count) + BENCH_LEN,
+           (double)writeNs / count / 1000.0);
+    return (0);
+}
+
+/******************************************************************************
+ Public Functions
+ *****************************************************************************/
+
+/*!
+ Address of a word of the simulated flash, 32 bits without PIE
+ */
+uint8 *HalFlashGetAddress(uint8 pg, uint16 offset)
+{
+    return (&simFlash[(uint8)(pg - pageBase)][offset]);
+}
+
+/*!
+ Read the simulated flash, counted
+ */
+void HalFlashRead(uint8 pg, uint16 offset, uint8 *buf, uint16 cnt)
+{
+    flashReads++;
+    memcpy(buf, HalFlashGetAddress(pg, offset), cnt);
+}
+
+/*!
+ Write the simulated flash, only clearing bits
+ */
+void HalFlashWrite(uint32 addr, uint8 *buf, uint16 cnt)
+{
+    uint8_t *pFlash = (uint8_t *)(uintptr_t)addr;
+    uint16_t i;
+
+    for(i = 0; i < cnt; i++)
+    {
+        pFlash[i] &= buf[i];
+    }
+}
+
+/*!
+ Erase a page of the simulated flash
+ */
+uint32_t FlashSectorErase(uint32_t ui32SectorAddress)
+{
+    uintptr_t offset = (uintptr_t)ui32SectorAddress - (uintptr_t)simFlash;
+
+    memset(simFlash[offset / PAGE_SIZE], 0xFF, PAGE_SIZE);
+    return (FAPI_STATUS_SUCCESS);
+}
+
+/*!
+ HAL_ASSERT_FORCED() of osal_snv.c
+ */
+void halAssertHandler(void)
+{
+    asserts++;
+}
+
+int main(void)
+{
+    static const unsigned int counts[] = { 16, 64, 128, 255 };
+    unsigned int c;
+
+    /* osal_snv_init() numbers the pages from the address of SNV_FLASH */
+    pageBase = (uint8_t)((uint32_t)(uintptr_t)SNV_FLASH >> 12);
+    if((pageBase == 0) || (pageBase == 0xFF)
+       || ((uintptr_t)simFlash > 0xFFFFFFFF))
+    {
+        printf("FAIL: NV area at %p can't be simulated\n", (void *)SNV_FLASH);
+        return (1);
+    }
+
+    if(runChecker())
+    {
+        return (1);
+    }
+
+    for(c = 0; c < sizeof(counts) / sizeof(counts[0]); c++)
+    {
+        if(runBench(counts[c]))
+        {
+            return (1);
+        }
+    }
+
+    return (0);
+}
@@ -0,0 +1,15 @@
+/******************************************************************************
+
+ @file OSAL.h
+
+ @brief Host stand-in for the OSAL memory helpers.
+
+ *****************************************************************************/
+#ifndef OSAL_H
+#define OSAL_H
+
+/* Without string.h, which would make NULL a pointer */
+#define osal_memset             __builtin_memset
+#define osal_memcmp(a, b, n)    (__builtin_memcmp((a), (b), (n)) == 0)
+
+#endif /* OSAL_H */
@@ -0,0 +1,18 @@
+/******************************************************************************
+
+ @file comdef.h
+
+ @brief Host stand-in for the OSAL status values used by osal_snv.c.
+
+ *****************************************************************************/
+#ifndef COMDEF_H
+#define COMDEF_H
+
+#include "hal_types.h"
+
+#define SUCCESS                         0x00
+#define FAILURE                         0x01
+#define INVALIDPARAMETER                0x02
+#define NV_OPER_FAILED                  0x0A
+
+#endif /* COMDEF_H */
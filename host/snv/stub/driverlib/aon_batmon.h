@@ -0,0 +1,11 @@
+/******************************************************************************
+
+ @file aon_batmon.h
+
+ @brief Host stand-in, the battery monitor check is not built.
+
+ *****************************************************************************/
+#ifndef AON_BATMON_H
+#define AON_BATMON_H
+
+#endif /* AON_BATMON_H */
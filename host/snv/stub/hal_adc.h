@@ -0,0 +1,11 @@
+/******************************************************************************
+
+ @file hal_adc.h
+
+ @brief Host stand-in, nothing of it is used by osal_snv.c.
+
+ *****************************************************************************/
+#ifndef HAL_ADC_H
+#define HAL_ADC_H
+
+#endif /* HAL_ADC_H */
@@ -0,0 +1,15 @@
+/******************************************************************************
+
+ @file hal_assert.h
+
+ @brief Host stand-in for the HAL assert, counted by snv_test.c.
+
+ *****************************************************************************/
+#ifndef HAL_ASSERT_H
+#define HAL_ASSERT_H
+
+extern void halAssertHandler(void);
+
+#define HAL_ASSERT_FORCED()             halAssertHandler()
+
+#endif /* HAL_ASSERT_H */
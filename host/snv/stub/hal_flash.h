@@ -0,0 +1,26 @@
+/******************************************************************************
+
+ @file hal_flash.h
+
+ @brief Host stand-in for the flash HAL, on the simulated flash of
+        snv_test.c. Writes clear bits like the flash does, and addresses
+        are 32 bits, so the test is built without PIE.
+
+ *****************************************************************************/
+#ifndef HAL_FLASH_H
+#define HAL_FLASH_H
+
+#include "hal_types.h"
+
+#define HAL_FLASH_PAGE_SIZE             4096
+#define HAL_FLASH_WORD_SIZE             4
+#define HAL_NV_PAGE_CNT                 2
+#define HAL_NV_PAGE_BEG                 0x1E
+
+#define FAPI_STATUS_SUCCESS             0
+
+extern void HalFlashRead(uint8 pg, uint16 offset, uint8 *buf, uint16 cnt);
+extern void HalFlashWrite(uint32 addr, uint8 *buf, uint16 cnt);
+extern uint32_t FlashSectorErase(uint32_t ui32SectorAddress);
+
+#endif /* HAL_FLASH_H */
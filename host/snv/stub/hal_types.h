@@ -0,0 +1,38 @@
+/******************************************************************************
+
+ @file hal_types.h
+
+ @brief Host stand-in for the HAL types and critical sections, the host test
+        has one thread.
+
+ *****************************************************************************/
+#ifndef HAL_TYPES_H
+#define HAL_TYPES_H
+
+#include <stdint.h>
+
+typedef int8_t int8;
+typedef uint8_t uint8;
+typedef int16_t int16;
+typedef uint16_t uint16;
+typedef int32_t int32;
+typedef uint32_t uint32;
+
+typedef int halIntState_t;
+
+#define HAL_ENTER_CRITICAL_SECTION(x)   ((x) = 0)
+#define HAL_EXIT_CRITICAL_SECTION(x)    ((void)(x))
+
+/* NULL is 0 here, osal_snv.c compares page numbers with it */
+#ifndef NULL
+#define NULL                            0
+#endif
+
+#ifndef TRUE
+#define TRUE                            1
+#endif
+#ifndef FALSE
+#define FALSE                           0
+#endif
+
+#endif /* HAL_TYPES_H */
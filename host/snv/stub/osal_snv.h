@@ -0,0 +1,21 @@
+/******************************************************************************
+
+ @file osal_snv.h
+
+ @brief Host stand-in for the OSAL simple NV interface, 8 bit item IDs.
+
+ *****************************************************************************/
+#ifndef OSAL_SNV_H
+#define OSAL_SNV_H
+
+#include "hal_types.h"
+
+typedef uint8 osalSnvId_t;
+typedef uint16 osalSnvLen_t;
+
+extern uint8 osal_snv_init(void);
+extern uint8 osal_snv_read(osalSnvId_t id, osalSnvLen_t len, void *pBuf);
+extern uint8 osal_snv_write(osalSnvId_t id, osalSnvLen_t len, void *pBuf);
+extern uint8 osal_snv_compact(uint8 threshold);
+
+#endif /* OSAL_SNV_H */
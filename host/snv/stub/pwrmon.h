@@ -0,0 +1,11 @@
+/******************************************************************************
+
+ @file pwrmon.h
+
+ @brief Host stand-in, nothing of it is used by osal_snv.c.
+
+ *****************************************************************************/
+#ifndef PWRMON_H
+#define PWRMON_H
+
+#endif /* PWRMON_H */
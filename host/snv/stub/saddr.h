@@ -0,0 +1,11 @@
+/******************************************************************************
+
+ @file saddr.h
+
+ @brief Host stand-in, nothing of it is used by osal_snv.c.
+
+ *****************************************************************************/
+#ifndef SADDR_H
+#define SADDR_H
+
+#endif /* SADDR_H */
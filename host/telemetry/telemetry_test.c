@@ -0,0 +1,194 @@
+/******************************************************************************
+
+ @file telemetry_test.c
+
+ @brief Host test of the MSP430 ESP8266 bridge telemetry parsers: the
+        "$S," reading lines of the collector, with values at and past the
+        int16_t range, and the status line of the ThingSpeak response.
+
+ Group: WCS LPC
+ Target Device: MSP430G2553
+
+ *****************************************************************************/
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+#include <stdio.h>
+#include <string.h>
+
+#include "telemetry.h"
+
+/******************************************************************************
+ Constants and definitions
+ *****************************************************************************/
+
+/*! Size of the line ring */
+#define TEST_RING_SIZE          128
+
+/*! A line and what the parser should make of it */
+typedef struct
+{
+    const char *line;
+    uint8_t valid;
+    int16_t field[TELEMETRY_FIELDS];
+} parseCase_t;
+
+/*! A line and the HTTP status found in it */
+typedef struct
+{
+    const char *line;
+    int16_t status;
+} statusCase_t;
+
+/******************************************************************************
+ Local Variables
+ *****************************************************************************/
+
+static const parseCase_t parseCases[] =
+{
+    { "$S,21,45,300", 1, { 21, 45, 300 } },
+    { "$S,-5,0,0", 1, { -5, 0, 0 } },
+    { "$S,32767,-32768,0", 1, { 32767, -32768, 0 } },
+    { "$S,32768,0,0", 0, { 0 } },
+    { "$S,0,-32769,0", 0, { 0 } },
+    { "$S,0,0,65536", 0, { 0 } },
+    { "$S,0,0,99999999", 0, { 0 } },
+    { "$S,1,2", 0, { 0 } },
+    { "$S,1,2,3,4", 0, { 0 } },
+    { "$S,1,,3", 0, { 0 } },
+    { "$S,-,2,3", 0, { 0 } },
+    { "$X,1,2,3", 0, { 0 } },
+};
+
+static const statusCase_t statusCases[] =
+{
+    { "+IPD,3,512:HTTP/1.1 200 OK", 200 },
+    { "+IPD,3,99:HTTP/1.1 202 Accepted", 202 },
+    { "+IPD,3,140:HTTP/1.1 400 Bad Request", 400 },
+    { "+IPD,3,140:HTTP/1.0 500 Internal Server Error", 500 },
+    { "+IPD,3,20:HTTP/1.1 2", 0 },
+    { "+IPD,3,20:Status: 200", 0 },
+    { "+IPD,3,20", 0 },
+    { "3,CLOSED", 0 },
+};
+
+static uint8_t ringStorage[TEST_RING_SIZE];
+static ringBuffer ring;
+
+/******************************************************************************
+ Local Functions
+ *****************************************************************************/
+
+/*!
+ * @brief       Put a line in the ring, after some filler so that it wraps,
+ *              and frame it.
+ *
+ * @param       pText - line, without the terminator
+ * @param       offset - filler bytes put and released first
+ * @param       pSpan - the framed line
+ *
+ * @return      1 if a whole line was framed
+ */
+static uint8_t frameLine(const char *pText, uint8_t offset,
+                         ringBufferSpan *pSpan)
+{
+    ringBufferSpan filler;
+    const char *p;
+    uint8_t i;
+
+    ringBufferInit(&ring, ringStorage, sizeof(ringStorage));
+
+    for(i = 0; i < offset; i++)
+    {
+        ringBufferPut(&ring, 'x');
+    }
+    ringBufferPut(&ring, '\r');
+    ringBufferPut(&ring, '\n');
+    if(ringBufferGetLine(&ring, &filler) == RINGBUFF_OK)
+    {
+        ringBufferRelease(&ring, &filler);
+    }
+
+    for(p = pText; *p != 0; p++)
+    {
+        ringBufferPut(&ring, (uint8_t)*p);
+    }
+    ringBufferPut(&ring, '\r');
+    ringBufferPut(&ring, '\n');
+
+    return (ringBufferGetLine(&ring, pSpan) == RINGBUFF_OK);
+}
+
+/******************************************************************************
+ Public Functions
+ *****************************************************************************/
+
+int main(void)
+{
+    ringBufferSpan span;
+    int16_t field[TELEMETRY_FIELDS];
+    unsigned int checked = 0;
+    unsigned int c;
+    uint8_t offset;
+    uint8_t f;
+
+    /* Each line at every position of the ring, wrapped or not */
+    for(offset = 0; offset < 80; offset++)
+    {
+        for(c = 0; c < sizeof(parseCases) / sizeof(parseCases[0]); c++)
+        {
+            const parseCase_t *pCase = &parseCases[c];
+            uint8_t valid;
+
+            if(!frameLine(pCase->line, offset, &span))
+            {
+                printf("FAIL: framing \"%s\"\n", pCase->line);
+                return (1);
+            }
+
+            valid = telemetryParse(&span, field);
+            if(valid != pCase->valid)
+            {
+                printf("FAIL: \"%s\" parsed %u, expected %u\n", pCase->line,
+                       valid, pCase->valid);
+                return (1);
+            }
+            for(f = 0; valid && (f < TELEMETRY_FIELDS); f++)
+            {
+                if(field[f] != pCase->field[f])
+                {
+                    printf("FAIL: \"%s\" field %u is %d\n", pCase->line, f,
+                           field[f]);
+                    return (1);
+                }
+            }
+            checked++;
+        }
+
+        for(c = 0; c < sizeof(statusCases) / sizeof(statusCases[0]); c++)
+        {
+            const statusCase_t *pCase = &statusCases[c];
+            int16_t status;
+
+            if(!frameLine(pCase->line, offset, &span))
+            {
+                printf("FAIL: framing \"%s\"\n", pCase->line);
+                return (1);
+            }
+
+            status = telemetryHttpStatus(&span);
+            if(status != pCase->status)
+            {
+                printf("FAIL: \"%s\" status %d, expected %d\n", pCase->line,
+                       status, pCase->status);
+                return (1);
+            }
+            checked++;
+        }
+    }
+
+    printf("telemetry: %u lines parsed as expected\n", checked);
+
+    return (0);
+}
@@ -0,0 +1,634 @@
+/******************************************************************************
+
+ @file tstore_test.c
+
+ @brief Host test of the sensor time-series store of the collector. Streams
+        six hours of synthetic readings from a number of devices, with
+        jitter, channel mask changes, a spike and hour long gaps, then
+        checks that:
+
+        - the raw blocks read through the MT request decode to the newest
+          readings of each device, exactly
+        - the windowed summaries match a brute force over those readings,
+          and the MT summary response carries the same windows
+        - malformed requests and blocks are rejected
+        - every reading is indicated until a threshold is set, and after
+          that only the threshold crossings
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+#include <stdio.h>
+#include <string.h>
+
+#include "tstore.h"
+
+/******************************************************************************
+ Constants and definitions
+ *****************************************************************************/
+
+/*! Number of devices reporting */
+#define NUM_DEVICES             12
+
+/*! Short address of the first device */
+#define FIRST_ADDR              0x0100
+
+/*! Length of the stream, in seconds */
+#define STREAM_SECS             (6 * 3600)
+
+/*! Most readings kept for reference */
+#define MAX_READINGS            200000
+
+/*! Windows in a summary */
+#define NUM_WINDOWS             24
+
+/*! Size of an MT response */
+#define RSP_MAX                 250
+
+/*! Device that spikes its ambience temperature, and when */
+#define SPIKE_DEVICE            7
+#define SPIKE_START             20000
+#define SPIKE_END               21000
+
+/*! Ambience temperature range of the threshold test */
+#define THRESHOLD_LOW           -1024
+#define THRESHOLD_HIGH          2500
+
+/*! A reading added, for reference */
+typedef struct
+{
+    uint16_t shortAddr;
+    Tstore_reading_t reading;
+} refReading_t;
+
+/******************************************************************************
+ Local Variables
+ *****************************************************************************/
+
+/*! Readings added, in order */
+static refReading_t refReadings[MAX_READINGS];
+static uint32_t numRefReadings;
+
+/*! Readings decoded from the store */
+static Tstore_reading_t decoded[MAX_READINGS];
+
+/*! Readings of a device, indexes into refReadings */
+static uint32_t devReadings[MAX_READINGS];
+
+/*! Readings the store said to indicate */
+static uint32_t indications;
+
+/*! Random number state */
+static uint32_t seed = 12345;
+
+/******************************************************************************
+ Local Functions
+ *****************************************************************************/
+
+/*!
+ * @brief       Make a random number.
+ *
+ * @return      24 random bits
+ */
+static uint32_t random24(void)
+{
+    seed = (seed * 1103515245u) + 12345u;
+
+    return (seed >> 8);
+}
+
+/*!
+ * @brief       Put a little endian 32-bit value in a buffer.
+ *
+ * @param       pBuf - buffer
+ * @param       value - value
+ */
+static void put32(uint8_t *pBuf, uint32_t value)
+{
+    pBuf[0] = (uint8_t)value;
+    pBuf[1] = (uint8_t)(value >> 8);
+    pBuf[2] = (uint8_t)(value >> 16);
+    pBuf[3] = (uint8_t)(value >> 24);
+}
+
+/*!
+ * @brief       Get a little endian 32-bit value from a buffer.
+ *
+ * @param       pBuf - buffer
+ *
+ * @return      value
+ */
+static uint32_t get32(const uint8_t *pBuf)
+{
+    return ((uint32_t)pBuf[0] | ((uint32_t)pBuf[1] << 8)
+            | ((uint32_t)pBuf[2] << 16) | ((uint32_t)pBuf[3] << 24));
+}
+
+/*!
+ * @brief       Compare two readings, over the channels present.
+ *
+ * @param       pA - reading
+ * @param       pB - reading
+ *
+ * @return      true if they are the same
+ */
+static bool sameReading(const Tstore_reading_t *pA, const Tstore_reading_t *pB)
+{
+    int chan;
+
+    if((pA->time != pB->time) || (pA->chans != pB->chans))
+    {
+        return (false);
+    }
+
+    for(chan = 0; chan < Tstore_chan_max; chan++)
+    {
+        if((pA->chans & (1 << chan)) && (pA->value[chan] != pB->value[chan]))
+        {
+            return (false);
+        }
+    }
+
+    return (true);
+}
+
+/*!
+ * @brief       Stream readings from all the devices into the store, every 5
+ *              to 16 seconds a device with a little jitter.
+ *
+ * @param       secs - length of the stream, in seconds
+ */
+static void streamReadings(uint32_t secs)
+{
+    uint32_t next[NUM_DEVICES];
+    int32_t value[NUM_DEVICES][Tstore_chan_max];
+    uint32_t time;
+    int dev;
+
+    for(dev = 0; dev < NUM_DEVICES; dev++)
+    {
+        next[dev] = 10 + (dev * 7);
+        value[dev][Tstore_chan_ambienceTemp] = 2300 + dev;
+        value[dev][Tstore_chan_objectTemp] = 2100;
+        value[dev][Tstore_chan_light] = 500 + (dev * 100);
+        value[dev][Tstore_chan_humidityTemp] = 26000;
+        value[dev][Tstore_chan_humidity] = 30000;
+        value[dev][Tstore_chan_rssi] = -60;
+    }
+
+    for(time = 0; time < (secs * 1000 / TSTORE_TIME_RES_MS); time++)
+    {
+        for(dev = 0; dev < NUM_DEVICES; dev++)
+        {
+            Tstore_reading_t reading;
+            refReading_t *pRef;
+            int chan;
+
+            if(time != next[dev])
+            {
+                continue;
+            }
+
+            memset(&reading, 0, sizeof(reading));
+            reading.time = time;
+
+            /* Every channel, or temperatures, light and RSSI */
+            reading.chans = ((dev % 3) == 0) ? 0x3F : 0x27;
+            if((dev == 5) && ((time / 300) % 2))
+            {
+                /* The channel mask changes */
+                reading.chans = 0x21;
+            }
+
+            for(chan = 0; chan < Tstore_chan_max; chan++)
+            {
+                value[dev][chan] += (int32_t)(random24() % 7) - 3;
+                reading.value[chan] = value[dev][chan];
+            }
+            if((dev == SPIKE_DEVICE) && (time > SPIKE_START)
+               && (time < SPIKE_END))
+            {
+                reading.value[Tstore_chan_ambienceTemp] = 8000 + time;
+            }
+            reading.value[Tstore_chan_ambienceTemp] =
+                (int16_t)reading.value[Tstore_chan_ambienceTemp];
+            reading.value[Tstore_chan_rssi] =
+                (int8_t)reading.value[Tstore_chan_rssi];
+
+            if(Tstore_add((uint16_t)(FIRST_ADDR + dev), &reading))
+            {
+                indications++;
+            }
+
+            if(numRefReadings < MAX_READINGS)
+            {
+                pRef = &refReadings[numRefReadings++];
+                pRef->shortAddr = (uint16_t)(FIRST_ADDR + dev);
+                pRef->reading = reading;
+            }
+
+            next[dev] = time + 50 + (dev * 10) + (random24() % 5);
+            if((dev == 9) && ((random24() % 50) == 0))
+            {
+                /* An hour long gap */
+                next[dev] += 36000;
+            }
+        }
+    }
+}
+
+/*!
+ * @brief       Read all the raw blocks of a device through the MT request
+ *              and decode them.
+ *
+ * @param       shortAddr - device short address
+ * @param       pReadings - decoded readings
+ * @param       pNum - number of readings decoded
+ *
+ * @return      0 if read
+ */
+static int readRaw(uint16_t shortAddr, Tstore_reading_t *pReadings,
+                   uint32_t *pNum)
+{
+    uint32_t start = 0;
+
+    *pNum = 0;
+
+    for(;;)
+    {
+        uint8_t req[7];
+        uint8_t rsp[RSP_MAX];
+        uint16_t len;
+        uint16_t off = TSTORE_RSP_HDR_LEN + 1;
+        uint8_t numBlocks;
+        uint8_t block;
+
+        req[0] = Tstore_req_raw;
+        req[1] = (uint8_t)shortAddr;
+        req[2] = (uint8_t)(shortAddr >> 8);
+        put32(&req[3], start);
+
+        len = Tstore_processReq(0, req, sizeof(req), rsp, sizeof(rsp));
+        if(rsp[0] == Tstore_status_noDevice)
+        {
+            return (0);
+        }
+        if(rsp[0] != Tstore_status_success)
+        {
+            printf("FAIL: raw read of 0x%04x status %u\n", shortAddr, rsp[0]);
+            return (1);
+        }
+
+        numBlocks = rsp[TSTORE_RSP_HDR_LEN];
+        if(numBlocks == 0)
+        {
+            return (0);
+        }
+
+        for(block = 0; block < numBlocks; block++)
+        {
+            uint32_t firstTime = get32(&rsp[off]);
+            uint8_t count = rsp[off + 4];
+            uint8_t dataLen = rsp[off + 5];
+
+            if(((*pNum + count) > MAX_READINGS)
+               || !Tstore_decodeBlock(firstTime, count,
+                                      &rsp[off + TSTORE_BLOCK_HDR_LEN],
+                                      dataLen, &pReadings[*pNum]))
+            {
+                printf("FAIL: block of 0x%04x doesn't decode\n", shortAddr);
+                return (1);
+            }
+
+            *pNum += count;
+            off += TSTORE_BLOCK_HDR_LEN + dataLen;
+        }
+
+        if(off != len)
+        {
+            printf("FAIL: raw response of 0x%04x %u bytes, blocks %u\n",
+                   shortAddr, len, off);
+            return (1);
+        }
+
+        start = pReadings[*pNum - 1].time + 1;
+    }
+}
+
+/*!
+ * @brief       Check that the raw blocks of each device decode to its newest
+ *              readings.
+ *
+ * @return      0 if they do
+ */
+static int checkRaw(void)
+{
+    uint32_t kept = 0;
+    int dev;
+
+    for(dev = 0; dev < NUM_DEVICES; dev++)
+    {
+        uint16_t shortAddr = (uint16_t)(FIRST_ADDR + dev);
+        uint32_t num;
+        uint32_t numDev = 0;
+        uint32_t i;
+
+        if(readRaw(shortAddr, decoded, &num))
+        {
+            return (1);
+        }
+
+        for(i = 0; i < numRefReadings; i++)
+        {
+            if(refReadings[i].shortAddr == shortAddr)
+            {
+                devReadings[numDev++] = i;
+            }
+        }
+
+        if(num > numDev)
+        {
+            printf("FAIL: 0x%04x %u readings decoded, %u added\n", shortAddr,
+                   num, numDev);
+            return (1);
+        }
+
+        for(i = 0; i < num; i++)
+        {
+            const Tstore_reading_t *pRef =
+                &refReadings[devReadings[numDev - num + i]].reading;
+
+            if(!sameReading(&decoded[i], pRef))
+            {
+                printf("FAIL: 0x%04x reading %u of %u differs\n", shortAddr,
+                       i, num);
+                return (1);
+            }
+        }
+
+        kept += num;
+    }
+
+    printf("tstore %u readings, %.2f bytes a reading, %u kept, %u block "
+           "evictions\n", Tstore_statistics.readings,
+           (double)Tstore_statistics.bytes / Tstore_statistics.readings, kept,
+           Tstore_statistics.evictions);
+
+    return (0);
+}
+
+/*!
+ * @brief       Check the summaries of each device against a brute force over
+ *              its decoded readings, and the MT summary response.
+ *
+ * @return      0 if they match
+ */
+static int checkSummaries(void)
+{
+    int dev;
+
+    for(dev = 0; dev < NUM_DEVICES; dev++)
+    {
+        uint16_t shortAddr = (uint16_t)(FIRST_ADDR + dev);
+        Tstore_summary_t summaries[NUM_WINDOWS];
+        uint8_t req[13];
+        uint8_t rsp[RSP_MAX];
+        uint32_t startTime;
+        uint32_t windowLen;
+        uint32_t num;
+        uint16_t len;
+        int chan;
+        int w;
+
+        if(readRaw(shortAddr, decoded, &num))
+        {
+            return (1);
+        }
+        if(num == 0)
+        {
+            continue;
+        }
+
+        startTime = decoded[0].time;
+        windowLen = ((decoded[num - 1].time - startTime) / NUM_WINDOWS) + 1;
+
+        for(chan = 0; chan < Tstore_chan_max; chan++)
+        {
+            if(!Tstore_summarize(shortAddr, (Tstore_chan_t)chan, startTime,
+                                 windowLen, NUM_WINDOWS, summaries))
+            {
+                printf("FAIL: 0x%04x not summarized\n", shortAddr);
+                return (1);
+            }
+
+            for(w = 0; w < NUM_WINDOWS; w++)
+            {
+                uint32_t from = startTime + (w * windowLen);
+                int64_t sum = 0;
+                uint16_t count = 0;
+                int32_t min = 0;
+                int32_t max = 0;
+                int32_t last = 0;
+                uint32_t i;
+
+                for(i = 0; i < num; i++)
+                {
+                    int32_t value = decoded[i].value[chan];
+
+                    if(!(decoded[i].chans & (1 << chan))
+                       || (decoded[i].time < from)
+                       || (decoded[i].time >= (from + windowLen)))
+                    {
+                        continue;
+                    }
+
+                    if((count == 0) || (value < min))
+                    {
+                        min = value;
+                    }
+                    if((count == 0) || (value > max))
+                    {
+                        max = value;
+                    }
+                    last = value;
+                    sum += value;
+                    count++;
+                }
+
+                if((summaries[w].count != count)
+                   || (count && ((summaries[w].min != min)
+                                 || (summaries[w].max != max)
+                                 || (summaries[w].last != last)
+                                 || (summaries[w].mean
+                                     != (int32_t)(sum / count)))))
+                {
+                    printf("FAIL: 0x%04x channel %d window %d summary\n",
+                           shortAddr, chan, w);
+                    return (1);
+                }
+            }
+        }
+
+        /* The MT response carries the same windows */
+        req[0] = Tstore_req_summary;
+        req[1] = (uint8_t)shortAddr;
+        req[2] = (uint8_t)(shortAddr >> 8);
+        req[3] = Tstore_chan_ambienceTemp;
+        put32(&req[4], startTime);
+        put32(&req[8], windowLen);
+        req[12] = NUM_WINDOWS;
+
+        len = Tstore_processReq(77, req, sizeof(req), rsp, sizeof(rsp));
+        Tstore_summarize(shortAddr, Tstore_chan_ambienceTemp, startTime,
+                         windowLen, NUM_WINDOWS, summaries);
+
+        if((rsp[0] != Tstore_status_success) || (get32(&rsp[1]) != 77)
+           || (rsp[TSTORE_RSP_HDR_LEN] != NUM_WINDOWS)
+           || (len != (TSTORE_RSP_HDR_LEN + 1
+                       + (NUM_WINDOWS * TSTORE_SUMMARY_LEN))))
+        {
+            printf("FAIL: 0x%04x summary response\n", shortAddr);
+            return (1);
+        }
+
+        for(w = 0; w < NUM_WINDOWS; w++)
+        {
+            const uint8_t *pWin = &rsp[TSTORE_RSP_HDR_LEN + 1
+                                       + (w * TSTORE_SUMMARY_LEN)];
+
+            if((((uint16_t)pWin[0] | (pWin[1] << 8)) != summaries[w].count)
+               || ((int16_t)(pWin[2] | (pWin[3] << 8)) != summaries[w].min))
+            {
+                printf("FAIL: 0x%04x summary response window %d\n",
+                       shortAddr, w);
+                return (1);
+            }
+        }
+    }
+
+    printf("tstore summaries match for %d devices, %d channels, %d windows\n",
+           NUM_DEVICES, Tstore_chan_max, NUM_WINDOWS);
+
+    return (0);
+}
+
+/*!
+ * @brief       Check that malformed requests and blocks are rejected.
+ *
+ * @return      0 if they are
+ */
+static int checkBadRequests(void)
+{
+    uint8_t badType[3] = { 9, 0, 0 };
+    uint8_t noDevice[7] = { Tstore_req_raw, 0x34, 0x12, 0, 0, 0, 0 };
+    uint8_t badChan[7] = { Tstore_req_threshold, 9, 1, 0, 0, 0, 0 };
+    uint8_t badBlock[3] = { 0x01, 0x80, 0x80 };
+    Tstore_reading_t readings[2];
+    uint8_t rsp[RSP_MAX];
+
+    if((Tstore_processReq(0, badType, sizeof(badType), rsp, sizeof(rsp))
+        != TSTORE_RSP_HDR_LEN) || (rsp[0] != Tstore_status_invalidParam))
+    {
+        printf("FAIL: bad request type accepted\n");
+        return (1);
+    }
+
+    if((Tstore_processReq(0, noDevice, sizeof(noDevice), rsp, sizeof(rsp))
+        != TSTORE_RSP_HDR_LEN) || (rsp[0] != Tstore_status_noDevice))
+    {
+        printf("FAIL: unknown device read\n");
+        return (1);
+    }
+
+    Tstore_processReq(0, badChan, sizeof(badChan), rsp, sizeof(rsp));
+    if(rsp[0] != Tstore_status_invalidParam)
+    {
+        printf("FAIL: threshold of a bad channel set\n");
+        return (1);
+    }
+
+    if(Tstore_decodeBlock(0, 2, badBlock, sizeof(badBlock), readings))
+    {
+        printf("FAIL: corrupt block decoded\n");
+        return (1);
+    }
+
+    return (0);
+}
+
+/*!
+ * @brief       Check that every reading is indicated with no threshold set,
+ *              and only the crossings once one is.
+ *
+ * @return      0 if they are
+ */
+static int checkThresholds(void)
+{
+    uint8_t req[7];
+    uint8_t rsp[RSP_MAX];
+
+    /* The first stream ran with no threshold */
+    if(indications != Tstore_statistics.readings)
+    {
+        printf("FAIL: %u of %u readings indicated with no threshold\n",
+               indications, Tstore_statistics.readings);
+        return (1);
+    }
+
+    Tstore_init();
+    numRefReadings = 0;
+    indications = 0;
+
+    req[0] = Tstore_req_threshold;
+    req[1] = Tstore_chan_ambienceTemp;
+    req[2] = 1;
+    req[3] = (uint8_t)THRESHOLD_LOW;
+    req[4] = (uint8_t)(THRESHOLD_LOW >> 8);
+    req[5] = (uint8_t)THRESHOLD_HIGH;
+    req[6] = (uint8_t)(THRESHOLD_HIGH >> 8);
+
+    Tstore_processReq(0, req, sizeof(req), rsp, sizeof(rsp));
+    if(rsp[0] != Tstore_status_success)
+    {
+        printf("FAIL: threshold not set\n");
+        return (1);
+    }
+
+    streamReadings(STREAM_SECS);
+
+    /* The spike goes out of range and comes back */
+    if((indications != 2) || (Tstore_statistics.events != 2))
+    {
+        printf("FAIL: %u indications, %u events with a threshold, "
+               "expected 2\n", indications, Tstore_statistics.events);
+        return (1);
+    }
+
+    printf("tstore %u readings indicated of %u with a threshold set\n",
+           indications, Tstore_statistics.readings);
+
+    return (0);
+}
+
+/******************************************************************************
+ Public Functions
+ *****************************************************************************/
+
+int main(void)
+{
+    Tstore_init();
+    streamReadings(STREAM_SECS);
+
+    if(checkRaw() || checkSummaries() || checkBadRequests()
+       || checkThresholds())
+    {
+        return (1);
+    }
+
+    return (0);
+}
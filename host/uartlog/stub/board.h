@@ -0,0 +1,13 @@
+/******************************************************************************
+
+ @file board.h
+
+ @brief Host stand-in for the board of the sensor.
+
+ *****************************************************************************/
+#ifndef BOARD_H
+#define BOARD_H
+
+#define Board_UART0             0
+
+#endif /* BOARD_H */
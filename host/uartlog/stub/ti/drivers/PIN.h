@@ -0,0 +1,7 @@
+/******************************************************************************
+
+ @file PIN.h
+
+ @brief Host stand-in, not used by uart_debug.c.
+
+ *****************************************************************************/
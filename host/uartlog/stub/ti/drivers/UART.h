@@ -0,0 +1,59 @@
+/******************************************************************************
+
+ @file UART.h
+
+ @brief Host stand-in for the UART driver in callback mode, simulated by
+        uart_log_test.c.
+
+ *****************************************************************************/
+#ifndef ti_drivers_UART__include
+#define ti_drivers_UART__include
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct UART_Config *UART_Handle;
+typedef void (*UART_Callback)(UART_Handle handle, void *buf, size_t count);
+
+typedef enum
+{
+    UART_MODE_BLOCKING,
+    UART_MODE_CALLBACK
+} UART_Mode;
+
+typedef enum
+{
+    UART_DATA_BINARY,
+    UART_DATA_TEXT
+} UART_DataMode;
+
+typedef enum
+{
+    UART_RETURN_PARTIAL,
+    UART_RETURN_FULL
+} UART_ReturnMode;
+
+typedef enum
+{
+    UART_ECHO_OFF,
+    UART_ECHO_ON
+} UART_Echo;
+
+typedef struct
+{
+    UART_Mode readMode;
+    UART_Mode writeMode;
+    UART_Callback readCallback;
+    UART_Callback writeCallback;
+    UART_ReturnMode readReturnMode;
+    UART_DataMode readDataMode;
+    UART_DataMode writeDataMode;
+    UART_Echo readEcho;
+    uint32_t baudRate;
+} UART_Params;
+
+extern void UART_Params_init(UART_Params *pParams);
+extern UART_Handle UART_open(unsigned int index, UART_Params *pParams);
+extern int UART_write(UART_Handle handle, const void *buf, size_t size);
+
+#endif /* ti_drivers_UART__include */
@@ -0,0 +1,23 @@
+/******************************************************************************
+
+ @file BIOS.h
+
+ @brief Host stand-in for the thread type, set by uart_log_test.c.
+
+ *****************************************************************************/
+#ifndef ti_sysbios_BIOS__include
+#define ti_sysbios_BIOS__include
+
+#include <xdc/std.h>
+
+typedef enum
+{
+    BIOS_ThreadType_Hwi,
+    BIOS_ThreadType_Swi,
+    BIOS_ThreadType_Task,
+    BIOS_ThreadType_Main
+} BIOS_ThreadType;
+
+extern BIOS_ThreadType BIOS_getThreadType(void);
+
+#endif /* ti_sysbios_BIOS__include */
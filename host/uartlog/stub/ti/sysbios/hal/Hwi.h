@@ -0,0 +1,17 @@
+/******************************************************************************
+
+ @file Hwi.h
+
+ @brief Host stand-in for the interrupt lock: blocks the signal that plays
+        the UART interrupt in uart_log_test.c.
+
+ *****************************************************************************/
+#ifndef ti_sysbios_hal_Hwi__include
+#define ti_sysbios_hal_Hwi__include
+
+#include <xdc/std.h>
+
+extern UInt Hwi_disable(void);
+extern void Hwi_restore(UInt key);
+
+#endif /* ti_sysbios_hal_Hwi__include */
@@ -0,0 +1,15 @@
+/******************************************************************************
+
+ @file Clock.h
+
+ @brief Host stand-in for the TI-RTOS clock, simulated by uart_log_test.c.
+
+ *****************************************************************************/
+#ifndef ti_sysbios_knl_Clock__include
+#define ti_sysbios_knl_Clock__include
+
+#include <xdc/std.h>
+
+extern uint32_t Clock_getTicks(void);
+
+#endif /* ti_sysbios_knl_Clock__include */
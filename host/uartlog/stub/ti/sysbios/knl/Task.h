@@ -0,0 +1,16 @@
+/******************************************************************************
+
+ @file Task.h
+
+ @brief Host stand-in for the task scheduler lock, one task on the host.
+
+ *****************************************************************************/
+#ifndef ti_sysbios_knl_Task__include
+#define ti_sysbios_knl_Task__include
+
+#include <xdc/std.h>
+
+extern UInt Task_disable(void);
+extern void Task_restore(UInt key);
+
+#endif /* ti_sysbios_knl_Task__include */
@@ -0,0 +1,13 @@
+/******************************************************************************
+
+ @file System.h
+
+ @brief Host stand-in for System_abort().
+
+ *****************************************************************************/
+#ifndef xdc_runtime_System__include
+#define xdc_runtime_System__include
+
+extern void System_abort(const char *str);
+
+#endif /* xdc_runtime_System__include */
@@ -0,0 +1,64 @@
+#!/usr/bin/env python3
+"""
+Test of uart_log_decode.py: the stream captured by build/uartlog is decoded
+with the format strings of that program and must give back the lines it
+recorded, with one drop line per drop record and the record times in order.
+
+Run with:
+
+    make -C host test
+"""
+import io, os, re, subprocess, sys
+
+HOST = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+sys.dont_write_bytecode = True
+sys.path.insert(0, os.path.join(HOST, '..', 'Include_Files', 'Sensor'))
+import uart_log_decode
+
+PROGRAM = os.path.join(HOST, 'build', 'uartlog')
+CAPTURE = os.path.join(HOST, 'build', 'uartlog.bin')
+EXPECT = os.path.join(HOST, 'build', 'uartlog.txt')
+STAMP = re.compile(r'\[ *(\d+\.\d+)\] ')
+DROP = re.compile(r'<(\d+) records dropped>$')
+
+def fail(msg):
+    print('FAIL: %s' % msg)
+    sys.exit(1)
+
+def main():
+    subprocess.run([PROGRAM, CAPTURE, EXPECT], check=True)
+    with open(EXPECT, encoding='latin-1') as f:
+        expect = f.read().split('\n')[:-1]
+
+    out = io.StringIO()
+    with open(CAPTURE, 'rb') as stream:
+        # One tick per 100 us, the resolution of the printed time
+        uart_log_decode.decode(uart_log_decode.Image(PROGRAM), stream, out,
+                               100.0)
+
+    lines = []; dropped = 0; last = -1.0
+    for line in out.getvalue().split('\n')[:-1]:
+        line = line.rstrip('\r')
+        match = STAMP.match(line)
+        if match:
+            line = line[match.end():]
+            drop = DROP.match(line)
+            if drop:
+                # Stamped when the ring had room, after the record it precedes
+                dropped += int(drop.group(1))
+                continue
+            stamp = float(match.group(1))
+            if stamp <= last:
+                fail('record at %s after %s' % (stamp, last))
+            last = stamp
+        lines.append(line)
+
+    if len(lines) != len(expect):
+        fail('%d lines decoded for %d recorded' % (len(lines), len(expect)))
+    for n, (got, want) in enumerate(zip(lines, expect)):
+        if got != want:
+            fail('line %d is %r, not %r' % (n + 1, got, want))
+    print('%d lines decoded, %d records dropped' % (len(lines), dropped))
+
+if __name__ == '__main__':
+    main()
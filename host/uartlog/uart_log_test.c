@@ -0,0 +1,496 @@
+/******************************************************************************
+
+ @file uart_log_test.c
+
+ @brief Host test of the debug_print() token ring of the sensor. The UART
+        write completes in a signal handler, at any point of the producer,
+        like the interrupt of the UART driver in callback mode. Bursts of
+        records overflow the ring. The test checks that:
+
+        - a record from a task never disables interrupts
+        - the stream is whole records, in order, with a drop record
+          accounting for every record lost to a full ring
+        - records from a Hwi or a Swi are dropped and counted, and don't
+          reach the stream
+
+        Given two file names it also writes the captured stream and the
+        lines the decoder must expand it to, for uart_log_decode_test.py.
+        The format strings are read from this program, built without PIE so
+        their addresses fit the 32 bits of a record.
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+#include <signal.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "uart_debug.h"
+
+/******************************************************************************
+ Constants and definitions
+ *****************************************************************************/
+
+/*! Records made by the test */
+#define NUM_RECORDS             100000
+
+/*! Size of the captured stream */
+#define CAPTURE_SIZE            (8 * 1024 * 1024)
+
+/*! Period of the UART interrupt, in microseconds */
+#define UART_PERIOD_US          20
+
+/*! Records of a burst at most, and spin loops of a pause between bursts */
+#define MAX_BURST               40
+#define MAX_PAUSE               20000
+
+/*! A raw line is written after this many records */
+#define RAW_LINE_INTERVAL       5000
+
+/*! Largest expanded line */
+#define LINE_LEN                128
+
+/*! Offset of the first argument, the sequence number, in a record */
+#define SEQ_OFFSET              DEBUG_LOG_HEADER_LEN
+
+/******************************************************************************
+ Local Variables
+ *****************************************************************************/
+
+/*! Strings of the %s records, the last one longer than a record takes */
+static const char *states[] =
+{
+    "idle", "joining", "", "a state name longer than sixteen"
+};
+
+/*! UART write in flight, completed by the signal handler */
+static const uint8_t *volatile pendingBuf;
+static volatile size_t pendingLen;
+static UART_Callback writeCallback;
+
+/*! Stream sent by the UART */
+static uint8_t capture[CAPTURE_SIZE];
+static volatile size_t captureLen;
+
+/*! Thread type seen by uart_debug.c */
+static BIOS_ThreadType threadType = BIOS_ThreadType_Task;
+
+/*! Interrupts disabled by uart_debug.c */
+static uint32_t hwiDisables;
+
+/*! Simulated clock */
+static uint32_t ticks;
+
+/*! Expected decoder output, NULL when not written */
+static FILE *expectFile;
+
+/*! Noise of the bursts */
+static uint32_t randState = 1;
+
+/******************************************************************************
+ Simulated TI-RTOS and UART driver
+ *****************************************************************************/
+
+void System_abort(const char *str)
+{
+    printf("FAIL: %s\n", str);
+    exit(1);
+}
+
+BIOS_ThreadType BIOS_getThreadType(void)
+{
+    return (threadType);
+}
+
+UInt Task_disable(void)
+{
+    return (0);
+}
+
+void Task_restore(UInt key)
+{
+    (void)key;
+}
+
+uint32_t Clock_getTicks(void)
+{
+    return (++ticks);
+}
+
+UInt Hwi_disable(void)
+{
+    sigset_t set;
+
+    hwiDisables++;
+    sigemptyset(&set);
+    sigaddset(&set, SIGALRM);
+    sigprocmask(SIG_BLOCK, &set, NULL);
+
+    return (0);
+}
+
+void Hwi_restore(UInt key)
+{
+    sigset_t set;
+
+    (void)key;
+    sigemptyset(&set);
+    sigaddset(&set, SIGALRM);
+    sigprocmask(SIG_UNBLOCK, &set, NULL);
+}
+
+void UART_Params_init(UART_Params *pParams)
+{
+    memset(pParams, 0, sizeof(UART_Params));
+}
+
+UART_Handle UART_open(unsigned int index, UART_Params *pParams)
+{
+    (void)index;
+    if(pParams->writeMode != UART_MODE_CALLBACK)
+    {
+        return (NULL);
+    }
+    writeCallback = pParams->writeCallback;
+
+    return ((UART_Handle)capture);
+}
+
+int UART_write(UART_Handle handle, const void *buf, size_t size)
+{
+    (void)handle;
+    if(pendingLen != 0)
+    {
+        System_abort("UART write while one is in flight");
+    }
+    pendingBuf = buf;
+    pendingLen = size;
+
+    return (0);
+}
+
+/*!
+ * @brief       UART interrupt: the write in flight completes.
+ *
+ * @param       sig - signal number
+ */
+static void uartInterrupt(int sig)
+{
+    size_t len = pendingLen;
+
+    (void)sig;
+    if(len == 0)
+    {
+        return;
+    }
+    if(captureLen + len <= CAPTURE_SIZE)
+    {
+        memcpy(&capture[captureLen], pendingBuf, len);
+    }
+    captureLen += len;
+    pendingLen = 0;
+    writeCallback((UART_Handle)capture, (void *)pendingBuf, len);
+}
+
+/******************************************************************************
+ Local Functions
+ *****************************************************************************/
+
+/*!
+ * @brief       Pseudo random number, the same on every run.
+ *
+ * @param       range - values from 0 to range - 1
+ *
+ * @return      the number
+ */
+static uint32_t randomRange(uint32_t range)
+{
+    randState = randState * 1103515245 + 12345;
+
+    return ((randState >> 16) % range);
+}
+
+/*!
+ * @brief       Wait for the ring to drain.
+ */
+static void waitIdle(void)
+{
+    size_t len;
+
+    do
+    {
+        len = captureLen;
+        usleep(20 * UART_PERIOD_US);
+    } while((pendingLen != 0) || (len != captureLen));
+}
+
+/*!
+ * @brief       Add a line to the expected decoder output.
+ *
+ * @param       format - printf format of the line
+ */
+static void expectLine(const char *format, ...)
+{
+    va_list args;
+
+    if(expectFile != NULL)
+    {
+        va_start(args, format);
+        vfprintf(expectFile, format, args);
+        va_end(args);
+        fputc('\n', expectFile);
+    }
+}
+
+/*!
+ * @brief       Make one record, of one of the formats.
+ *
+ * @param       seq - sequence number
+ */
+static void makeRecord(uint32_t seq)
+{
+    uint32_t dropped = debugLogDropped();
+    long value = (long)randomRange(200000) - 100000;
+    const char *state = states[seq % 4];
+    char line[LINE_LEN];
+
+    switch(seq % 4)
+    {
+        case 0:
+            debug_print("seq %u temp %d\r\n", (long)seq, value);
+            snprintf(line, LINE_LEN, "seq %u temp %ld", seq, value);
+            break;
+        case 1:
+            debug_print("seq %u addr 0x%04x %X\r\n", (long)seq,
+                        value & 0xFFFF, value);
+            snprintf(line, LINE_LEN, "seq %u addr 0x%04x %X", seq,
+                     (unsigned)(value & 0xFFFF), (unsigned)value);
+            break;
+        case 2:
+            debug_print("seq %u key %c state %s\r\n", (long)seq,
+                        'a' + (int)(seq % 26), state);
+            snprintf(line, LINE_LEN, "seq %u key %c state %.16s", seq,
+                     'a' + (int)(seq % 26), state);
+            break;
+        default:
+            debug_print("seq %u %-6d|%05d|%%\r\n", (long)seq, value % 1000,
+                        value % 100);
+            snprintf(line, LINE_LEN, "seq %u %-6ld|%05ld|%%", seq,
+                     value % 1000, value % 100);
+            break;
+    }
+
+    if(debugLogDropped() == dropped)
+    {
+        expectLine("%s", line);
+    }
+}
+
+/*!
+ * @brief       Walk the captured stream.
+ *
+ * @param       pRecords - records with a format, out
+ * @param       pDropped - records reported lost by the drop records, out
+ *
+ * @return      0 when the stream is whole records in order, 1 on a failure
+ */
+static int walkCapture(uint32_t *pRecords, uint32_t *pDropped)
+{
+    uint32_t lastSeq = 0;
+    size_t pos = 0;
+
+    *pRecords = 0;
+    *pDropped = 0;
+    while(pos < captureLen)
+    {
+        uint32_t format, value;
+        uint8_t len;
+
+        if(capture[pos] != DEBUG_LOG_SYNC)
+        {
+            /* Raw text */
+            pos++;
+            continue;
+        }
+        len = capture[pos + 1] + 2;
+        if((len < DEBUG_LOG_HEADER_LEN) || (len > DEBUG_LOG_MAX_RECORD)
+           || (pos + len > captureLen))
+        {
+            printf("FAIL: bad record length %u at %zu\n", len, pos);
+            return (1);
+        }
+        memcpy(&format, &capture[pos + 2], 4);
+        memcpy(&value, &capture[pos + SEQ_OFFSET], 4);
+        if(format == 0)
+        {
+            *pDropped += value;
+        }
+        else if(len > SEQ_OFFSET + 4)
+        {
+            if((*pRecords > 1) && (value <= lastSeq))
+            {
+                printf("FAIL: record %u after %u\n", value, lastSeq);
+                return (1);
+            }
+            lastSeq = value;
+            (*pRecords)++;
+        }
+        else
+        {
+            /* The echo prompt, no arguments */
+            (*pRecords)++;
+        }
+        pos += len;
+    }
+
+    return (0);
+}
+
+/*!
+ * @brief       Write the captured stream.
+ *
+ * @param       pFileName - file
+ *
+ * @return      0 when written, 1 on an error
+ */
+static int writeCapture(const char *pFileName)
+{
+    FILE *pFile = fopen(pFileName, "wb");
+
+    if((pFile == NULL) || (fwrite(capture, 1, captureLen, pFile) != captureLen))
+    {
+        printf("FAIL: cannot write %s\n", pFileName);
+        return (1);
+    }
+    fclose(pFile);
+
+    return (0);
+}
+
+/******************************************************************************
+ Public Functions
+ *****************************************************************************/
+
+int main(int argc, char *argv[])
+{
+    struct itimerval timer;
+    uint32_t records, dropped, lost, isrDropped;
+    uint32_t seq;
+
+    if(argc > 2)
+    {
+        expectFile = fopen(argv[2], "w");
+        if(expectFile == NULL)
+        {
+            printf("FAIL: cannot write %s\n", argv[2]);
+            return (1);
+        }
+    }
+
+    signal(SIGALRM, uartInterrupt);
+    timer.it_interval.tv_sec = 0;
+    timer.it_interval.tv_usec = UART_PERIOD_US;
+    timer.it_value = timer.it_interval;
+    setitimer(ITIMER_REAL, &timer, NULL);
+
+    initDebugPort();
+    expectLine("\fInit debug port success");
+
+    seq = 0;
+    while(seq < NUM_RECORDS)
+    {
+        uint32_t burst = 1 + randomRange(MAX_BURST);
+        volatile uint32_t spin;
+
+        for(; burst > 0 && seq < NUM_RECORDS; burst--)
+        {
+            makeRecord(++seq);
+            if(seq % RAW_LINE_INTERVAL == 0)
+            {
+                /* Raw bytes between records, sent once the ring is empty */
+                char raw[LINE_LEN];
+                int i;
+
+                waitIdle();
+                snprintf(raw, LINE_LEN, "raw %u\r\n", seq);
+                for(i = 0; raw[i] != 0; i++)
+                {
+                    writechar(raw[i]);
+                }
+                expectLine("raw %u", seq);
+            }
+        }
+        for(spin = randomRange(MAX_PAUSE); spin > 0; spin--)
+        {
+        }
+    }
+    if(hwiDisables != 0)
+    {
+        printf("FAIL: %u interrupt locks for task records\n",
+               (unsigned)hwiDisables);
+        return (1);
+    }
+
+    /* A last record once the ring has room, it reports any drops left */
+    waitIdle();
+    makeRecord(++seq);
+    lost = debugLogDropped();
+
+    /* Records of interrupts are dropped */
+    threadType = BIOS_ThreadType_Hwi;
+    debug_print("seq %u from a Hwi\r\n", (long)++seq);
+    threadType = BIOS_ThreadType_Swi;
+    debug_print("seq %u from a Swi\r\n", (long)++seq);
+    threadType = BIOS_ThreadType_Task;
+    isrDropped = debugLogDropped() - lost;
+    waitIdle();
+
+    timer.it_value.tv_usec = 0;
+    timer.it_interval.tv_usec = 0;
+    setitimer(ITIMER_REAL, &timer, NULL);
+
+    if(captureLen > CAPTURE_SIZE)
+    {
+        printf("FAIL: capture overflow\n");
+        return (1);
+    }
+    if(walkCapture(&records, &dropped))
+    {
+        return (1);
+    }
+    printf("%u records, %u dropped, %zu bytes sent\n", (unsigned)records,
+           (unsigned)dropped, captureLen);
+    if((dropped != lost) || (records + dropped != NUM_RECORDS + 2))
+    {
+        printf("FAIL: %u records and %u dropped for %u, %u counted lost\n",
+               (unsigned)records, (unsigned)dropped, NUM_RECORDS + 2,
+               (unsigned)lost);
+        return (1);
+    }
+    if(isrDropped != 2)
+    {
+        printf("FAIL: %u of 2 interrupt records dropped\n",
+               (unsigned)isrDropped);
+        return (1);
+    }
+
+    if(expectFile != NULL)
+    {
+        fclose(expectFile);
+        if(writeCapture(argv[1]))
+        {
+            return (1);
+        }
+    }
+
+    return (0);
+}
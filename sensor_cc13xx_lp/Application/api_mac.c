@@ -52,9 +52,12 @@
 
 #include "icall.h"
 #include "api_mac.h"
+#include "api_mac_pib.h"
 #include "macstack.h"
 #include "util.h"
 #include "macs.h"
+#include "probe.h"
+#include "mactrace.h"
 
 /*!
  This module is the ICall interface for the application and all ICall
@@ -268,6 +271,12 @@ static bool matchSecAddKeyInitFC(ICall_ServiceEnum src, ICall_EntityID dest,
 static ApiMac_status_t setTypeReq(uint8 eventId, ICall_MsgMatchFn matchFn,
                                   uint8_t pibAttribute,
                                   void *pValue);
+static bool matchSecAddDevices(ICall_ServiceEnum src, ICall_EntityID dest,
+                               const void *msg);
+static bool matchSecDelDevices(ICall_ServiceEnum src, ICall_EntityID dest,
+                               const void *msg);
+static ApiMac_status_t sendSecDevices(void *pMsg, ICall_MsgMatchFn matchFn);
+static bool secDeviceValid(ApiMac_secAddDevice_t *pDevice);
 static ApiMac_status_t sendEvtExpectStatus(uint8_t eventId,
                                            ICall_MsgMatchFn matchFn);
 static ApiMac_status_t sendEvt(uint8_t eventId);
@@ -342,8 +351,37 @@ void *ApiMac_init(bool enableFH)
  */
 void ApiMac_registerCallbacks(ApiMac_callbacks_t *pCallbacks)
 {
-    /* Save the application's callback table */
-    pMacCallbacks = pCallbacks;
+    /* Save the application's callback table, wrapped to trace it */
+    pMacCallbacks = Mactrace_wrapCallbacks(pCallbacks);
+}
+
+/*!
+ Register the pending message check function.
+
+ Public function defined in api_mac.h
+ */
+void ApiMac_registerCheckPending(ApiMac_checkPendingFp_t pCheckPendingFp)
+{
+    /* Allocate message buffer space */
+    macStackInitParams_t *pMsg = (macStackInitParams_t *)ICall_allocMsg(
+                    sizeof(macStackInitParams_t));
+
+    if(pMsg != NULL)
+    {
+        /* The MAC saves the function along with the other init parameters */
+        pMsg->hdr.event = MAC_STACK_INIT_PARAMS;
+        pMsg->hdr.status = 0;
+        pMsg->srctaskid = ApiMac_appEntity;
+        pMsg->retransmit = 0;
+        pMsg->pendingMsg = 0;
+        pMsg->pMacCbackQueryRetransmit = NULL;
+        pMsg->pMacCbackCheckPending = (uint8_t (*)())pCheckPendingFp;
+
+        /* Send the message to ICALL_SERVICE_CLASS_TIMAC */
+        ICall_sendServiceMsg(ApiMac_appEntity, ICALL_SERVICE_CLASS_TIMAC,
+                             (ICALL_MSG_FORMAT_3RD_CHAR_TASK_ID),
+                             pMsg);
+    }
 }
 
 /*!
@@ -360,6 +398,9 @@ void ApiMac_processIncoming(void)
     /* Wait for response message */
     if(ICall_wait(ICALL_TIMEOUT_FOREVER) == ICALL_ERRNO_SUCCESS)
     {
+        /* Time the processing, not the wait */
+        PROBE_BEGIN(probeStart);
+
         /* Retrieve the response message */
         if(ICall_fetchMsg(&src, &dest, (void **)&pMsg) == ICALL_ERRNO_SUCCESS)
         {
@@ -383,6 +424,8 @@ void ApiMac_processIncoming(void)
                 ICall_freeMsg(pMsg);
             }
         }
+
+        PROBE_END(Probe_id_macIncoming, probeStart);
     }
 }
 
@@ -910,6 +953,9 @@ ApiMac_status_t ApiMac_mlmeResetReq(bool setDefaultPib)
     macResetReq_t *pMsg = (macResetReq_t *)ICall_allocMsg(
                     sizeof(macResetReq_t));
 
+    /* The reset may change any attribute */
+    ApiMacPib_cacheClear();
+
     if(pMsg != NULL)
     {
         ICall_Errno errno;
@@ -1660,6 +1706,158 @@ ApiMac_status_t ApiMac_secDeleteDevice(ApiMac_sAddrExt_t *pExtAddr)
     return (status);
 }
 
+/*!
+ Adds a list of MAC device table entries.
+
+ Public function defined in api_mac.h
+ */
+ApiMac_status_t ApiMac_secAddDevices(ApiMac_secAddDevice_t *pDevices,
+                                     uint16_t count, ApiMac_status_t *pStatus)
+{
+    ApiMac_status_t status = ApiMac_status_success;
+    uint16_t first;
+
+    for(first = 0; first < count; first += MAC_SEC_DEVICES_MAX_ENTRIES)
+    {
+        macSecAddDevicesParam_t *pMsg;
+        ApiMac_status_t msgStatus;
+        uint8_t index[MAC_SEC_DEVICES_MAX_ENTRIES];
+        uint8_t num = 0;
+        uint8_t group;
+        uint8_t i;
+
+        group = ((count - first) > MAC_SEC_DEVICES_MAX_ENTRIES) ?
+                        MAC_SEC_DEVICES_MAX_ENTRIES : (count - first);
+
+        /* Allocate message buffer space */
+        pMsg = (macSecAddDevicesParam_t *)ICall_allocMsg(
+                        sizeof(macSecAddDevicesParam_t)
+                        + (group * sizeof(macSecDevicesEntry_t)));
+
+        for(i = 0; i < group; i++)
+        {
+            ApiMac_secAddDevice_t *pDevice = &pDevices[first + i];
+            ApiMac_status_t devStatus = ApiMac_status_noResources;
+
+            if(secDeviceValid(pDevice) == false)
+            {
+                devStatus = ApiMac_status_invalidParameter;
+            }
+            else if(pMsg != NULL)
+            {
+                macSecDevicesEntry_t *pEntry = &pMsg->entries[num];
+
+                pEntry->frameCounter = pDevice->frameCounter;
+                pEntry->panId = pDevice->panID;
+                pEntry->shortAddr = pDevice->shortAddr;
+                memcpy(pEntry->extAddr, pDevice->extAddr, APIMAC_SADDR_EXT_LEN);
+                pEntry->exempt = pDevice->exempt;
+                pEntry->keyIdLookupDataSize = pDevice->keyIdLookupDataSize;
+                memcpy(pEntry->keyIdLookupData, pDevice->keyIdLookupData,
+                       (APIMAC_MAX_KEY_LOOKUP_LEN));
+                pEntry->uniqueDevice = pDevice->uniqueDevice;
+                pEntry->duplicateDevFlag = pDevice->duplicateDevFlag;
+                pEntry->status = ApiMac_status_noResources;
+                index[num++] = i;
+                continue;
+            }
+
+            if(pStatus != NULL)
+            {
+                pStatus[first + i] = devStatus;
+            }
+            if(status == ApiMac_status_success)
+            {
+                status = devStatus;
+            }
+        }
+
+        if(pMsg == NULL)
+        {
+            continue;
+        }
+
+        if(num > 0)
+        {
+            /* Fill in the message content */
+            pMsg->event = MAC_SEC_ADD_DEVICES;
+            pMsg->status = 0;
+            pMsg->count = num;
+
+            msgStatus = sendSecDevices(pMsg, matchSecAddDevices);
+            if((msgStatus != ApiMac_status_success)
+               && (status == ApiMac_status_success))
+            {
+                status = msgStatus;
+            }
+
+            if(pStatus != NULL)
+            {
+                for(i = 0; i < num; i++)
+                {
+                    pStatus[first + index[i]] =
+                                    (ApiMac_status_t)pMsg->entries[i].status;
+                }
+            }
+        }
+
+        /* The reply is the same as msg */
+        ICall_freeMsg(pMsg);
+    }
+
+    return (status);
+}
+
+/*!
+ Removes the MAC device table entries of a list of devices.
+
+ Public function defined in api_mac.h
+ */
+ApiMac_status_t ApiMac_secDeleteDevices(ApiMac_sAddrExt_t *pExtAddrs,
+                                        uint16_t count)
+{
+    ApiMac_status_t status = ApiMac_status_success;
+    uint16_t first;
+
+    for(first = 0; first < count; first += MAC_SEC_DEVICES_MAX_ENTRIES)
+    {
+        macSecDelDevicesParam_t *pMsg;
+        ApiMac_status_t msgStatus = ApiMac_status_noResources;
+        uint8_t group;
+
+        group = ((count - first) > MAC_SEC_DEVICES_MAX_ENTRIES) ?
+                        MAC_SEC_DEVICES_MAX_ENTRIES : (count - first);
+
+        /* Allocate message buffer space */
+        pMsg = (macSecDelDevicesParam_t *)ICall_allocMsg(
+                        sizeof(macSecDelDevicesParam_t)
+                        + (group * APIMAC_SADDR_EXT_LEN));
+
+        if(pMsg != NULL)
+        {
+            /* Fill in the message content */
+            pMsg->event = MAC_SEC_DEL_DEVICES;
+            pMsg->status = 0;
+            pMsg->count = group;
+            memcpy(pMsg->extAddr, &pExtAddrs[first],
+                   (group * APIMAC_SADDR_EXT_LEN));
+
+            msgStatus = sendSecDevices(pMsg, matchSecDelDevices);
+
+            /* The reply is the same as msg */
+            ICall_freeMsg(pMsg);
+        }
+
+        if((msgStatus != ApiMac_status_success)
+           && (status == ApiMac_status_success))
+        {
+            status = msgStatus;
+        }
+    }
+
+    return (status);
+}
+
 /*!
  Removes the key at the specified key Index and removes all MAC device table
  enteries associated with this key.
@@ -2713,6 +2911,42 @@ static bool matchGetReq(ICall_ServiceEnum src, ICall_EntityID dest,
     return ((pMsg->hdr.event == MAC_GET_REQ) ? true : false);
 }
 
+/*!
+ * @brief       Compare a received TIMAC Security Add Devices Status message
+ *              for a match.
+ *
+ * @param       src - originator of the message as a service enumeration
+ * @param       dest - destination entity id of the message
+ * @param       msg - pointer to the message body
+ *
+ * @return      TRUE when the message matches. FALSE, otherwise.
+ */
+static bool matchSecAddDevices(ICall_ServiceEnum src, ICall_EntityID dest,
+                               const void *msg)
+{
+    macSecAddDevicesParam_t *pMsg = (macSecAddDevicesParam_t *)msg;
+
+    return ((pMsg->event == MAC_SEC_ADD_DEVICES) ? true : false);
+}
+
+/*!
+ * @brief       Compare a received TIMAC Security Delete Devices Status
+ *              message for a match.
+ *
+ * @param       src - originator of the message as a service enumeration
+ * @param       dest - destination entity id of the message
+ * @param       msg - pointer to the message body
+ *
+ * @return      TRUE when the message matches. FALSE, otherwise.
+ */
+static bool matchSecDelDevices(ICall_ServiceEnum src, ICall_EntityID dest,
+                               const void *msg)
+{
+    macSecDelDevicesParam_t *pMsg = (macSecDelDevicesParam_t *)msg;
+
+    return ((pMsg->event == MAC_SEC_DEL_DEVICES) ? true : false);
+}
+
 /*!
  * @brief       Compare a received TIMAC Get Frequency Hopping Request Status
  *              message for a match.
@@ -2982,10 +3216,16 @@ static ApiMac_status_t getTypeReq(uint8 eventId, ICall_MsgMatchFn matchFn,
                                   void *pValue, uint16_t *pLen)
 {
     ApiMac_status_t status = ApiMac_status_noResources;
+    macGetParam_t *pMsg;
+
+    if((eventId == MAC_GET_REQ)
+       && ApiMacPib_cacheRead(pibAttribute, pValue, pLen))
+    {
+        return (ApiMac_status_success);
+    }
 
     /* Allocate message buffer space */
-    macGetParam_t *pMsg = (macGetParam_t *)ICall_allocMsg(
-                    sizeof(macGetParam_t));
+    pMsg = (macGetParam_t *)ICall_allocMsg(sizeof(macGetParam_t));
 
     if(pMsg != NULL)
     {
@@ -3022,6 +3262,11 @@ static ApiMac_status_t getTypeReq(uint8 eventId, ICall_MsgMatchFn matchFn,
                         *pLen = pCmdStatus->len;
                     }
                     ICall_free(pMsg->pValue);
+
+                    if(eventId == MAC_GET_REQ)
+                    {
+                        ApiMacPib_cacheUpdate(pibAttribute, pValue);
+                    }
                 }
             }
         }
@@ -3080,6 +3325,11 @@ static ApiMac_status_t setTypeReq(uint8 eventId, ICall_MsgMatchFn matchFn,
             if(errno == ICALL_ERRNO_SUCCESS)
             {
                 status = (ApiMac_status_t)pCmdStatus->hdr.status;
+                if((status == ApiMac_status_success)
+                   && (eventId == MAC_SET_REQ))
+                {
+                    ApiMacPib_cacheUpdate(pibAttribute, pValue);
+                }
             }
         }
 
@@ -3089,6 +3339,69 @@ static ApiMac_status_t setTypeReq(uint8 eventId, ICall_MsgMatchFn matchFn,
     return (status);
 }
 
+/*!
+ * @brief       Send a bulk security device message to the MAC stack and wait
+ *              for the reply, which comes back in the same buffer.
+ *
+ * @param       pMsg - message, freed by the caller
+ * @param       matchFn - function to match the reply
+ *
+ * @return      status of the message
+ */
+static ApiMac_status_t sendSecDevices(void *pMsg, ICall_MsgMatchFn matchFn)
+{
+    ApiMac_status_t status = ApiMac_status_noResources;
+    ICall_Errno errno;
+
+    /* Send the message */
+    errno = ICall_sendServiceMsg(ApiMac_appEntity, (ICALL_SERVICE_CLASS_TIMAC),
+                                 (ICALL_MSG_FORMAT_KEEP),
+                                 pMsg);
+
+    if(errno == ICALL_ERRNO_SUCCESS)
+    {
+        macEventHdr_t *pCmdStatus = NULL;
+
+        errno = ICall_waitMatch(ICALL_TIMEOUT_FOREVER, matchFn, (NULL), (NULL),
+                                (void **)&pCmdStatus);
+
+        if(errno == ICALL_ERRNO_SUCCESS)
+        {
+            status = (ApiMac_status_t)pCmdStatus->status;
+        }
+    }
+
+    return (status);
+}
+
+/*!
+ * @brief       Check a device before it is sent in a bulk add. The MAC marks
+ *              unused device table entries with an all 0xFF extended address.
+ *
+ * @param       pDevice - device to check
+ *
+ * @return      true when the device can be added
+ */
+static bool secDeviceValid(ApiMac_secAddDevice_t *pDevice)
+{
+    uint8_t i;
+
+    if(pDevice->keyIdLookupDataSize > 1)
+    {
+        return (false);
+    }
+
+    for(i = 0; i < APIMAC_SADDR_EXT_LEN; i++)
+    {
+        if(pDevice->extAddr[i] != 0xFF)
+        {
+            return (true);
+        }
+    }
+
+    return (false);
+}
+
 /*!
  * @brief       Generic function to send a macEventHdr_t message and
  *              expect a status returned.
@@ -157,6 +157,31 @@ extern "C"
 /*! Default Reporting Interval - in milliseconds */
 #define CONFIG_REPORTING_INTERVAL  180000
 
+/*!
+ Number of sensor readings sent together in one Sensor Batch message, 1 to
+ SMSGS_SENSOR_BATCH_MAX_SAMPLES. With 1, every reading is sent in its own
+ Sensor Data message. A reading is still taken every reporting interval;
+ readings more than SMSGS_SENSOR_BATCH_MAX_INTERVAL milliseconds apart go in
+ separate messages.
+ */
+#define CONFIG_BATCH_SAMPLES       1
+
+/*!
+ The message statistics and config settings are only sent in one of this
+ many Sensor Batch messages
+ */
+#define CONFIG_BATCH_STATS_INTERVAL  4
+
+/*!
+ Default report policy, see Smsgs_reportPolicyField_t. The collector can
+ change it with the Config Request message. A heartbeat interval of 0 sends
+ every reading.
+ */
+#define CONFIG_REPORT_TEMP_DEADBAND        0
+#define CONFIG_REPORT_LIGHT_DEADBAND       0
+#define CONFIG_REPORT_HUMIDITY_DEADBAND    0
+#define CONFIG_REPORT_HEARTBEAT_INTERVAL   0
+
 /*! FH Poll/Sensor msg start time randomization window */
 #define CONFIG_FH_START_POLL_DATA_RAND_WINDOW   10000
 
@@ -56,6 +56,7 @@
 #include "sensor.h"
 #include "ssf.h"
 #include "config.h"
+#include "fh_hop_table.h"
 
 /******************************************************************************
  Constants and definitions
@@ -137,8 +138,8 @@ STATIC uint8_t defaultChannelMask[APIMAC_154G_CHANNEL_BITMAP_SIZ] =
 STATIC ApiMac_callbacks_t macCallbacksCopy =  { 0 };
 /* copy of CLLC callbacks */
 STATIC Jdllc_callbacks_t *pJdllcCallbacksCopy = (Jdllc_callbacks_t *)NULL;
-/* current channel in FH sleep node hop sequence */
-STATIC uint8_t sleepNodeChIdx = 0;
+/* FH sleep node hop sequence, built from fhChannelMask */
+STATIC FhHopTable_t sleepNodeHopTable;
 /* flag to control scan backoff */
 STATIC bool continueScan = true;
 /* flag to pick parent from incoming beacons or in FH networks send association
@@ -151,7 +152,7 @@ STATIC uint8_t fhNumPASRcvdInTrickleWindow = 0;
 STATIC uint8_t fhNumPCSRcvdInTrickleWindow = 0;
 STATIC uint8_t fhAssociationAttempts = 0;
 /* FH Channel Mask */
-STATIC uint8_t fhChannelMask[] = CONFIG_FH_CHANNEL_MASK;
+STATIC const uint8_t fhChannelMask[] = CONFIG_FH_CHANNEL_MASK;
 
 /******************************************************************************
  Local security variables
@@ -234,7 +235,6 @@ static void sendPollReq(void);
 static void processCoordRealign(void);
 static void sendScanReq(ApiMac_scantype_t type);
 static void sendAsyncReq(ApiMac_wisunAsyncFrame_t frameType);
-static uint8_t getFHSleepNodeHopChannel(void);
 
 /******************************************************************************
  Public Functions
@@ -299,7 +299,7 @@ void Jdllc_init(ApiMac_callbacks_t *pMacCbs, Jdllc_callbacks_t *pJdllcCbs)
 
     if(CONFIG_FH_ENABLE)
     {
-        uint8_t sizeOfChannelMask, idx;
+        uint8_t sizeOfChannelMask;
         sizeOfChannelMask = sizeof(fhChannelMask)/sizeof(uint8_t);
 
         /* PIB for FH are set when we receive the IEs*/
@@ -328,15 +328,9 @@ void Jdllc_init(ApiMac_callbacks_t *pMacCbs, Jdllc_callbacks_t *pJdllcCbs)
                             ApiMac_FHAttribute_broadcastChannelFunction,
                             JDLLC_FH_CHANNEL_HOPPPING);
             /* set of Exclude Channels */
-            if(sizeOfChannelMask > APIMAC_154G_CHANNEL_BITMAP_SIZ)
-            {
-                sizeOfChannelMask = APIMAC_154G_CHANNEL_BITMAP_SIZ;
-            }
-            memset(excludeChannels, 0, APIMAC_154G_CHANNEL_BITMAP_SIZ);
-            for(idx = 0; idx < sizeOfChannelMask; idx++)
-            {
-                excludeChannels[idx] = ~fhChannelMask[idx];
-            }
+            FhHopTable_excludeChannels(fhChannelMask, sizeOfChannelMask,
+                                       excludeChannels,
+                                       APIMAC_154G_CHANNEL_BITMAP_SIZ);
             ApiMac_mlmeSetFhReqArray(ApiMac_FHAttribute_unicastExcludedChannels,
                                      excludeChannels);
             ApiMac_mlmeSetFhReqArray(ApiMac_FHAttribute_broadcastExcludedChannels,
@@ -344,7 +338,6 @@ void Jdllc_init(ApiMac_callbacks_t *pMacCbs, Jdllc_callbacks_t *pJdllcCbs)
         }
         else
         {
-            uint8_t bitIndex, chIndex;
             /* set PIB to enable fixed channel*/
             ApiMac_mlmeSetFhReqUint8(ApiMac_FHAttribute_unicastChannelFunction,
                                      0);
@@ -352,21 +345,14 @@ void Jdllc_init(ApiMac_callbacks_t *pMacCbs, Jdllc_callbacks_t *pJdllcCbs)
                             ApiMac_FHAttribute_broadcastChannelFunction, 0);
 
             /*Initialize the hop sequence to account for maxChannels*/
-            chIndex = 0;
-            for(idx = 0; idx < sizeOfChannelMask; idx++)
-            {
-                for(bitIndex = 0; bitIndex < 8; bitIndex ++)
-                {
-                    if(chIndex >= APIMAC_154G_MAX_NUM_CHANNEL)
-                    {
-                        fhChannelMask[idx] &= ~(1 << bitIndex);
-                    }
-                    chIndex++;
-                }
-            }
+            FhHopTable_init(&sleepNodeHopTable, fhChannelMask,
+                            sizeOfChannelMask, APIMAC_154G_MAX_NUM_CHANNEL);
             /* set fixed channel in FH PIB */
-            ApiMac_mlmeSetFhReqUint16(ApiMac_FHAttribute_unicastFixedChannel,
-                                      (uint16_t) getFHSleepNodeHopChannel());
+            ApiMac_mlmeSetFhReqUint16(
+                            ApiMac_FHAttribute_unicastFixedChannel,
+                            (uint16_t)FhHopTable_next(
+                                            &sleepNodeHopTable,
+                                            DEFAULT_FH_SLEEP_FIXED_CHANNEL));
         }
 
         /* Start FH */
@@ -453,7 +439,9 @@ void Jdllc_process(void)
                 /* set fixed channel in FH PIB */
                 ApiMac_mlmeSetFhReqUint16(
                         ApiMac_FHAttribute_unicastFixedChannel,
-                        (uint16_t)getFHSleepNodeHopChannel());
+                        (uint16_t)FhHopTable_next(
+                                        &sleepNodeHopTable,
+                                        DEFAULT_FH_SLEEP_FIXED_CHANNEL));
             }
 
             /* send poll request */
@@ -569,20 +557,27 @@ void Jdllc_rejoin(ApiMac_deviceDescriptor_t *pDevInfo,
            (APIMAC_SADDR_EXT_LEN));
     devInfoBlock.coordShortAddr = pParentInfo->devInfo.shortAddress;
 
-    /* update MAC PIBs */
-    ApiMac_mlmeSetReqUint16(ApiMac_attribute_panId, devInfoBlock.panID);
-    ApiMac_mlmeSetReqUint16(ApiMac_attribute_shortAddress,
-                            devInfoBlock.devShortAddr);
-    ApiMac_mlmeSetReqArray(ApiMac_attribute_coordExtendedAddress,
-                           devInfoBlock.coordExtAddr);
+    /* update MAC PIBs in one request, the last two only without
+       frequency hopping */
+    {
+        ApiMac_mlmePibEntry_t pib[] =
+        {
+            { ApiMac_attribute_panId, 0, 0, &devInfoBlock.panID },
+            { ApiMac_attribute_shortAddress, 0, 0,
+              &devInfoBlock.devShortAddr },
+            { ApiMac_attribute_coordExtendedAddress, 0, 0,
+              devInfoBlock.coordExtAddr },
+            { ApiMac_attribute_logicalChannel, 0, 0, &devInfoBlock.channel },
+            { ApiMac_attribute_coordShortAddress, 0, 0,
+              &devInfoBlock.coordShortAddr }
+        };
+
+        ApiMac_mlmeSetReqMulti(pib, (CONFIG_FH_ENABLE) ? 3 :
+                               (sizeof(pib) / sizeof(pib[0])));
+    }
 
     if(!CONFIG_FH_ENABLE)
     {
-        ApiMac_mlmeSetReqUint8(ApiMac_attribute_logicalChannel,
-                               devInfoBlock.channel);
-        ApiMac_mlmeSetReqUint16(ApiMac_attribute_coordShortAddress,
-                                devInfoBlock.coordShortAddr);
-
         if(CONFIG_BEACON_ORDER > 0 && CONFIG_BEACON_ORDER
                         < JDLLC_BEACON_ORDER_NON_BEACON)
         {
@@ -885,73 +880,6 @@ static bool checkBeaconOrder(uint16_t superframeSpec)
     return (false);
 }
 
-/*!
- * @brief       Get the next channel for sleep node hopping based on
- *              chanel mask and sleepNodeChIdx
- *
- * @param       none
- *
- * @return      Channel to be used by sleep node
- */
-static uint8_t getFHSleepNodeHopChannel(void)
-{
-    uint8_t curChBitMap = 0;
-    uint8_t curChListPos = 0, bitIdx;
-    uint8_t i, chanBitMapSize, startChListPos, retCh;
-
-    chanBitMapSize = sizeof(fhChannelMask)/sizeof(uint8_t);
-
-    curChListPos = sleepNodeChIdx >> 3;
-    startChListPos = curChListPos;
-    bitIdx = sleepNodeChIdx & 7;
-
-    if((!chanBitMapSize) || (curChListPos >= chanBitMapSize))
-    {
-        return(DEFAULT_FH_SLEEP_FIXED_CHANNEL);
-    }
-
-    curChBitMap = fhChannelMask[curChListPos] >> bitIdx;
-    curChListPos++;
-
-    while((!curChBitMap) && (curChListPos != startChListPos))
-    {
-        curChBitMap = fhChannelMask[curChListPos];
-        sleepNodeChIdx = curChListPos * 8;
-
-        curChListPos++;
-        if(curChListPos > (chanBitMapSize - 1))
-        {
-            curChListPos = 0;
-            curChBitMap = fhChannelMask[curChListPos];
-            sleepNodeChIdx = curChListPos * 8;
-        }
-    }
-
-    if(curChBitMap != 0)
-    {
-        i = sleepNodeChIdx;
-        while(i < (8*(curChListPos + 1)))
-        {
-            if(curChBitMap & 1)
-            {
-                retCh = sleepNodeChIdx;
-                /* Increment chIndex for next Call */
-                sleepNodeChIdx += 1;
-                return(retCh);
-            }
-            else
-            {
-                sleepNodeChIdx += 1;
-                curChBitMap >>= 1;
-            }
-            i++;
-        }
-    }
-
-    /* An array of all Zeros */
-    return(DEFAULT_FH_SLEEP_FIXED_CHANNEL);
-}
-
 /*!
  * @brief       Process  Beacon Notification callback.
  *
@@ -88,6 +88,8 @@
 #include <string.h>
 
 #include "api_mac.h"
+#include "probe.h"
+#include "pwracct.h"
 #include "ssf.h"
 
 #include "sensor.h"
@@ -328,12 +330,19 @@ Void main()
      */
     PIN_init(BoardGpioInitTable);
 
+    /* Start the cycle counter of the hot path probes */
+    Probe_init();
+
+    /* Start the task and sleep time accounting */
+    Pwracct_init();
+
     /* Configure task. */
     Task_Params_init(&taskParams);
     taskParams.stack = myTaskStack;
     taskParams.stackSize = APP_TASK_STACK_SIZE;
     taskParams.priority = 1;
     Task_construct(&myTask, taskFxn, &taskParams, NULL);
+    Pwracct_setTask(Task_handle(&myTask), Pwracct_task_app);
 
 #ifdef DEBUG_SW_TRACE
     IOCPortConfigureSet(IOID_8, IOC_PORT_RFC_TRC, IOC_STD_OUTPUT
@@ -0,0 +1,198 @@
+/******************************************************************************
+
+ @file rpol.c
+
+ @brief Sensor report policy: which readings are sent to the collector
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+#include <string.h>
+
+#include "rpol.h"
+
+/******************************************************************************
+ Global variables
+ *****************************************************************************/
+
+/*! Report policy statistics */
+Rpol_statistics_t Rpol_statistics;
+
+/******************************************************************************
+ Local variables
+ *****************************************************************************/
+
+/*! Current policy */
+static Smsgs_reportPolicyField_t rpolPolicy;
+
+/*! Last reported reading */
+static Smsgs_sensorMsg_t rpolLast;
+
+/*! Time of the last report, in milliseconds */
+static uint32_t rpolLastTime;
+
+/*! Readings since the last report */
+static uint16_t rpolSkipped;
+
+/*! Failures counted at the last report */
+static uint32_t rpolLastFailures;
+
+/*! No reading reported yet with this policy */
+static bool rpolFirst = true;
+
+/******************************************************************************
+ Local function prototypes
+ *****************************************************************************/
+static bool outsideDeadband(int32_t value, int32_t last, uint16_t deadband);
+static bool readingChanged(Smsgs_sensorMsg_t *pMsg);
+
+/******************************************************************************
+ Public Functions
+ *****************************************************************************/
+
+/*!
+ Set the report policy.
+
+ Public function defined in rpol.h
+ */
+void Rpol_setPolicy(Smsgs_reportPolicyField_t *pPolicy)
+{
+    memcpy(&rpolPolicy, pPolicy, sizeof(Smsgs_reportPolicyField_t));
+    rpolFirst = true;
+}
+
+/*!
+ Check whether a reading is to be sent.
+
+ Public function defined in rpol.h
+ */
+bool Rpol_checkReport(Smsgs_sensorMsg_t *pMsg, uint32_t now,
+                      uint32_t txFailures)
+{
+    bool report = false;
+
+    Rpol_statistics.readings++;
+
+    if(rpolPolicy.heartbeatInterval == 0)
+    {
+        /* No policy, every reading is sent */
+        return (true);
+    }
+
+    rpolSkipped++;
+
+    if((rpolFirst == true)
+       || ((now - rpolLastTime) >= rpolPolicy.heartbeatInterval))
+    {
+        Rpol_statistics.heartbeatReports++;
+        report = true;
+    }
+    else if(readingChanged(pMsg) == true)
+    {
+        if(rpolSkipped >= (1 << Rpol_statistics.backoff))
+        {
+            Rpol_statistics.deltaReports++;
+            report = true;
+        }
+        else
+        {
+            Rpol_statistics.backoffHolds++;
+        }
+    }
+
+    if(report == true)
+    {
+        /* Back off while the sends since the last report are failing */
+        if((txFailures != rpolLastFailures) && (rpolFirst == false))
+        {
+            if(Rpol_statistics.backoff < RPOL_MAX_BACKOFF)
+            {
+                Rpol_statistics.backoff++;
+            }
+        }
+        else if(Rpol_statistics.backoff > 0)
+        {
+            Rpol_statistics.backoff--;
+        }
+
+        memcpy(&rpolLast, pMsg, sizeof(Smsgs_sensorMsg_t));
+        rpolLastTime = now;
+        rpolLastFailures = txFailures;
+        rpolSkipped = 0;
+        rpolFirst = false;
+    }
+
+    return (report);
+}
+
+/******************************************************************************
+ Local Functions
+ *****************************************************************************/
+
+/*!
+ * @brief       Check a value against the last reported one.
+ *
+ * @param       value - new value
+ * @param       last - last reported value
+ * @param       deadband - change that is reported
+ *
+ * @return      true if the value moved by more than the deadband
+ */
+static bool outsideDeadband(int32_t value, int32_t last, uint16_t deadband)
+{
+    int32_t diff = value - last;
+
+    if(diff < 0)
+    {
+        diff = -diff;
+    }
+
+    return ((diff > (int32_t)deadband) ? true : false);
+}
+
+/*!
+ * @brief       Check the fields of a reading against the last reported one.
+ *
+ * @param       pMsg - sensor data of the reading
+ *
+ * @return      true if a field in frameControl moved past its deadband
+ */
+static bool readingChanged(Smsgs_sensorMsg_t *pMsg)
+{
+    if((pMsg->frameControl & Smsgs_dataFields_tempSensor)
+       && ((outsideDeadband(pMsg->tempSensor.ambienceTemp,
+                            rpolLast.tempSensor.ambienceTemp,
+                            rpolPolicy.tempDeadband) == true)
+           || (outsideDeadband(pMsg->tempSensor.objectTemp,
+                               rpolLast.tempSensor.objectTemp,
+                               rpolPolicy.tempDeadband) == true)))
+    {
+        return (true);
+    }
+
+    if((pMsg->frameControl & Smsgs_dataFields_lightSensor)
+       && (outsideDeadband(pMsg->lightSensor.rawData,
+                           rpolLast.lightSensor.rawData,
+                           rpolPolicy.lightDeadband) == true))
+    {
+        return (true);
+    }
+
+    if((pMsg->frameControl & Smsgs_dataFields_humiditySensor)
+       && ((outsideDeadband(pMsg->humiditySensor.temp,
+                            rpolLast.humiditySensor.temp,
+                            rpolPolicy.humidityDeadband) == true)
+           || (outsideDeadband(pMsg->humiditySensor.humidity,
+                               rpolLast.humiditySensor.humidity,
+                               rpolPolicy.humidityDeadband) == true)))
+    {
+        return (true);
+    }
+
+    return (false);
+}
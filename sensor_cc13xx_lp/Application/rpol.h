@@ -0,0 +1,110 @@
+/******************************************************************************
+
+ @file rpol.h
+
+ @brief Sensor report policy: which readings are sent to the collector
+
+ Group: WCS LPC
+ Target Device: CC13xx
+
+ *****************************************************************************/
+#ifndef RPOL_H
+#define RPOL_H
+
+/******************************************************************************
+ Includes
+ *****************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "smsgs.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*!
+ \defgroup Rpol Report Policy
+ <BR>
+ A reading is taken every reporting interval, but with a report policy
+ (Smsgs_reportPolicyField_t) only the readings that moved by more than a
+ field's deadband since the last reported reading are sent, plus one
+ heartbeat reading when nothing was sent for the heartbeat interval.
+ <BR>
+ When the channel gets busy, seen as new channel access or MAC ACK failures
+ since the last report, the policy backs off: a changed reading is only sent
+ once 2, 4, then 8 readings have passed since the last report. Each report
+ without new failures steps the back off down again. Heartbeats are not
+ held back.
+ <BR>
+ */
+
+/*!
+ * \ingroup Rpol
+ * @{
+ */
+
+/******************************************************************************
+ Constants and definitions
+ *****************************************************************************/
+
+/*! Largest back off, changed readings wait for 1 << RPOL_MAX_BACKOFF readings */
+#if !defined(RPOL_MAX_BACKOFF)
+#define RPOL_MAX_BACKOFF        3
+#endif
+
+/*! Report policy statistics */
+typedef struct _rpol_statistics_t
+{
+    /*! Readings checked */
+    uint32_t readings;
+    /*! Readings sent because a field moved past its deadband */
+    uint32_t deltaReports;
+    /*! Readings sent because of the heartbeat interval */
+    uint32_t heartbeatReports;
+    /*! Changed readings held back by the channel back off */
+    uint32_t backoffHolds;
+    /*! Current back off, 0 to RPOL_MAX_BACKOFF */
+    uint8_t backoff;
+} Rpol_statistics_t;
+
+/******************************************************************************
+ Global Variables
+ *****************************************************************************/
+
+/*! Report policy statistics */
+extern Rpol_statistics_t Rpol_statistics;
+
+/******************************************************************************
+ Function Prototypes
+ *****************************************************************************/
+
+/*!
+ * @brief       Set the report policy. The next reading is always sent.
+ *
+ * @param       pPolicy - report policy, copied
+ */
+extern void Rpol_setPolicy(Smsgs_reportPolicyField_t *pPolicy);
+
+/*!
+ * @brief       Check whether a reading is to be sent. When it is, it becomes
+ *              the reference for the deadbands.
+ *
+ * @param       pMsg - sensor data of the reading, the fields in
+ *                     frameControl are compared
+ * @param       now - time of the reading, in milliseconds
+ * @param       txFailures - channel access plus MAC ACK failures so far
+ *
+ * @return      true to send the reading, false to drop it
+ */
+extern bool Rpol_checkReport(Smsgs_sensorMsg_t *pMsg, uint32_t now,
+                             uint32_t txFailures);
+
+/*! @} end group Rpol */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RPOL_H */
@@ -56,6 +56,8 @@
 #include "smsgs.h"
 #include "sensor.h"
 #include "config.h"
+#include "rpol.h"
+#include "pwracct.h"
 
 /******************************************************************************
  Constants and definitions
@@ -87,6 +89,11 @@
 #define MIN_POLLING_INTERVAL 1000
 #define MAX_POLLING_INTERVAL 10000
 
+#if (CONFIG_BATCH_SAMPLES < 1) \
+    || (CONFIG_BATCH_SAMPLES > SMSGS_SENSOR_BATCH_MAX_SAMPLES)
+#error "CONFIG_BATCH_SAMPLES must be 1 to SMSGS_SENSOR_BATCH_MAX_SAMPLES"
+#endif
+
 /******************************************************************************
  Global variables
  *****************************************************************************/
@@ -115,6 +122,9 @@ STATIC uint8_t deviceTxMsduHandle = 0;
 
 STATIC Smsgs_configReqMsg_t configSettings;
 
+/*! Epoch of the last Config Epoch message applied, 0 if none */
+STATIC uint8_t configEpoch = 0;
+
 /*!
  Temp Sensor field - valid only if Smsgs_dataFields_tempSensor
  is set in frameControl.
@@ -138,6 +148,13 @@ STATIC Smsgs_humiditySensorField_t humiditySensor =
 
 STATIC Llc_netInfo_t parentInfo = {0};
 
+/*! Readings waiting to be sent in a Sensor Batch message */
+STATIC Smsgs_sensorBatchMsg_t sensorBatch;
+/*! Time of the last reading added to sensorBatch, in milliseconds */
+STATIC uint32_t batchLastTime = 0;
+/*! Sensor Batch messages sent since the last one with statistics */
+STATIC uint8_t batchStatsCount = 0;
+
 /******************************************************************************
  Local function prototypes
  *****************************************************************************/
@@ -150,7 +167,19 @@ static bool sendMsg(Smsgs_cmdIds_t type, ApiMac_sAddr_t *pDstAddr,
 static void processSensorMsgEvt(void);
 static bool sendSensorMessage(ApiMac_sAddr_t *pDstAddr,
                               Smsgs_sensorMsg_t *pMsg);
+static void addBatchSample(Smsgs_sensorMsg_t *pMsg);
+static bool sendSensorBatch(ApiMac_sAddr_t *pDstAddr, Smsgs_sensorMsg_t *pMsg);
+static uint8_t *bufferMsgStats(uint8_t *pBuf, Smsgs_msgStatsField_t *pStats);
+static uint8_t *bufferPowerStats(uint8_t *pBuf,
+                                 Smsgs_powerStatsField_t *pStats);
+#if PWRACCT_ENABLED
+static void readPowerStats(Smsgs_powerStatsField_t *pStats);
+static uint16_t getPermille(uint32_t part, uint32_t whole);
+#endif
 static void processConfigRequest(ApiMac_mcpsDataInd_t *pDataInd);
+static void processConfigEpoch(ApiMac_mcpsDataInd_t *pDataInd);
+static Smsgs_statusValues_t applyConfig(uint8_t *pBuf, bool reportPolicy,
+                                        Smsgs_configRspMsg_t *pRsp);
 static bool sendConfigRsp(ApiMac_sAddr_t *pDstAddr, Smsgs_configRspMsg_t *pMsg);
 static uint16_t validateFrameControl(uint16_t frameControl);
 
@@ -235,6 +264,7 @@ void Sensor_init(void)
 
     /* Initialize the sensor's structures */
     memset(&configSettings, 0, sizeof(Smsgs_configReqMsg_t));
+    memset(&sensorBatch, 0, sizeof(Smsgs_sensorBatchMsg_t));
 #if defined(TEMP_SENSOR)
     configSettings.frameControl |= Smsgs_dataFields_tempSensor;
 #endif
@@ -246,8 +276,18 @@ void Sensor_init(void)
 #endif
     configSettings.frameControl |= Smsgs_dataFields_msgStats;
     configSettings.frameControl |= Smsgs_dataFields_configSettings;
+#if PWRACCT_ENABLED
+    configSettings.frameControl |= Smsgs_dataFields_powerStats;
+#endif
     configSettings.reportingInterval = CONFIG_REPORTING_INTERVAL;
     configSettings.pollingInterval = CONFIG_POLLING_INTERVAL;
+    configSettings.reportPolicy.tempDeadband = CONFIG_REPORT_TEMP_DEADBAND;
+    configSettings.reportPolicy.lightDeadband = CONFIG_REPORT_LIGHT_DEADBAND;
+    configSettings.reportPolicy.humidityDeadband =
+                    CONFIG_REPORT_HUMIDITY_DEADBAND;
+    configSettings.reportPolicy.heartbeatInterval =
+                    CONFIG_REPORT_HEARTBEAT_INTERVAL;
+    Rpol_setPolicy(&configSettings.reportPolicy);
 
     /* Initialize the MAC */
     sem = ApiMac_init(CONFIG_FH_ENABLE);
@@ -470,6 +510,10 @@ static void dataIndCB(ApiMac_mcpsDataInd_t *pDataInd)
                 Sensor_msgStats.configRequests++;
                 break;
 
+            case Smsgs_cmdIds_configEpoch:
+                processConfigEpoch(pDataInd);
+                break;
+
             case Smsgs_cmdIds_trackingReq:
                 /* Make sure the message is the correct size */
                 if(pDataInd->msdu.len == SMSGS_TRACKING_REQUEST_MSG_LENGTH)
@@ -541,7 +585,8 @@ static uint8_t getMsduHandle(Smsgs_cmdIds_t msgType)
     msduHandle |= APP_MARKER_MSDU_HANDLE;
 
     /* Add the message type bit */
-    if(msgType == Smsgs_cmdIds_sensorData)
+    if((msgType == Smsgs_cmdIds_sensorData)
+       || (msgType == Smsgs_cmdIds_sensorBatch))
     {
         msduHandle |= APP_SENSOR_MSDU_HANDLE;
     }
@@ -603,7 +648,8 @@ static bool sendMsg(Smsgs_cmdIds_t type, ApiMac_sAddr_t *pDstAddr,
 
     Jdllc_securityFill(&dataReq.sec);
 
-    if(type == Smsgs_cmdIds_sensorData)
+    if((type == Smsgs_cmdIds_sensorData)
+       || (type == Smsgs_cmdIds_sensorBatch))
     {
         Sensor_msgStats.msgsAttempted++;
     }
@@ -631,18 +677,24 @@ static bool sendMsg(Smsgs_cmdIds_t type, ApiMac_sAddr_t *pDstAddr,
 static void processSensorMsgEvt(void)
 {
     Smsgs_sensorMsg_t sensor;
-    uint32_t stat;
+    uint32_t rxSecureFail = 0;
+    uint32_t txSecureFail = 0;
+    ApiMac_mlmePibEntry_t pib[] =
+    {
+        { ApiMac_attribute_diagRxSecureFail, 0, sizeof(uint32_t),
+          &rxSecureFail },
+        { ApiMac_attribute_diagTxSecureFail, 0, sizeof(uint32_t),
+          &txSecureFail },
+        { ApiMac_attribute_extendedAddress, 0, APIMAC_SADDR_EXT_LEN,
+          sensor.extAddress }
+    };
 
     memset(&sensor, 0, sizeof(Smsgs_sensorMsg_t));
 
-    ApiMac_mlmeGetReqUint32(ApiMac_attribute_diagRxSecureFail, &stat);
-    Sensor_msgStats.rxDecryptFailures = (uint16_t)stat;
-
-    ApiMac_mlmeGetReqUint32(ApiMac_attribute_diagTxSecureFail, &stat);
-    Sensor_msgStats.txEncryptFailures = (uint16_t)stat;
-
-    ApiMac_mlmeGetReqArray(ApiMac_attribute_extendedAddress,
-    		               sensor.extAddress);
+    /* One request to the MAC for the statistics and the address */
+    ApiMac_mlmeGetReqMulti(pib, sizeof(pib) / sizeof(pib[0]));
+    Sensor_msgStats.rxDecryptFailures = (uint16_t)rxSecureFail;
+    Sensor_msgStats.txEncryptFailures = (uint16_t)txSecureFail;
 
     /* fill in the message */
     sensor.frameControl = configSettings.frameControl;
@@ -672,12 +724,32 @@ static void processSensorMsgEvt(void)
         sensor.configSettings.reportingInterval = configSettings
                         .reportingInterval;
     }
+    if(sensor.frameControl & Smsgs_dataFields_configEpoch)
+    {
+        sensor.configEpoch = configEpoch;
+    }
 
     /* inform the user interface */
     Ssf_sensorReadingUpdate(&sensor);
 
-    /* send the data to the collector */
-    sendSensorMessage(&collectorAddr, &sensor);
+    /* drop the readings the report policy doesn't need */
+    if(Rpol_checkReport(&sensor, Ssf_getTime(),
+                        ((uint32_t)Sensor_msgStats.channelAccessFailures
+                         + Sensor_msgStats.macAckFailures)) == false)
+    {
+        return;
+    }
+
+    if(CONFIG_BATCH_SAMPLES > 1)
+    {
+        /* hold the reading, the batch is sent once it is full */
+        addBatchSample(&sensor);
+    }
+    else
+    {
+        /* send the data to the collector */
+        sendSensorMessage(&collectorAddr, &sensor);
+    }
 }
 
 /*!
@@ -694,6 +766,14 @@ static bool sendSensorMessage(ApiMac_sAddr_t *pDstAddr, Smsgs_sensorMsg_t *pMsg)
     uint8_t *pMsgBuf;
     uint16_t len = SMSGS_BASIC_SENSOR_LEN;
 
+#if PWRACCT_ENABLED
+    /* The power statistics cover the time since they were last sent */
+    if(pMsg->frameControl & Smsgs_dataFields_powerStats)
+    {
+        readPowerStats(&pMsg->powerStats);
+    }
+#endif
+
     /* Figure out the length */
     if(pMsg->frameControl & Smsgs_dataFields_tempSensor)
     {
@@ -715,6 +795,14 @@ static bool sendSensorMessage(ApiMac_sAddr_t *pDstAddr, Smsgs_sensorMsg_t *pMsg)
     {
         len += SMSGS_SENSOR_CONFIG_SETTINGS_LEN;
     }
+    if(pMsg->frameControl & Smsgs_dataFields_configEpoch)
+    {
+        len += SMSGS_SENSOR_CONFIG_EPOCH_LEN;
+    }
+    if(pMsg->frameControl & Smsgs_dataFields_powerStats)
+    {
+        len += SMSGS_SENSOR_POWER_STATS_LEN;
+    }
 
     pMsgBuf = (uint8_t *)Ssf_malloc(len);
     if(pMsgBuf)
@@ -744,30 +832,7 @@ static bool sendSensorMessage(ApiMac_sAddr_t *pDstAddr, Smsgs_sensorMsg_t *pMsg)
         }
         if(pMsg->frameControl & Smsgs_dataFields_msgStats)
         {
-            pBuf = Util_bufferUint16(pBuf, pMsg->msgStats.joinAttempts);
-            pBuf = Util_bufferUint16(pBuf, pMsg->msgStats.joinFails);
-            pBuf = Util_bufferUint16(pBuf, pMsg->msgStats.msgsAttempted);
-            pBuf = Util_bufferUint16(pBuf, pMsg->msgStats.msgsSent);
-            pBuf = Util_bufferUint16(pBuf, pMsg->msgStats.trackingRequests);
-            pBuf = Util_bufferUint16(pBuf,
-                                     pMsg->msgStats.trackingResponseAttempts);
-            pBuf = Util_bufferUint16(pBuf,
-                                     pMsg->msgStats.trackingResponseSent);
-            pBuf = Util_bufferUint16(pBuf, pMsg->msgStats.configRequests);
-            pBuf = Util_bufferUint16(pBuf,
-                                     pMsg->msgStats.configResponseAttempts);
-            pBuf = Util_bufferUint16(pBuf,
-                                     pMsg->msgStats.configResponseSent);
-            pBuf = Util_bufferUint16(pBuf,
-                                     pMsg->msgStats.channelAccessFailures);
-            pBuf = Util_bufferUint16(pBuf, pMsg->msgStats.macAckFailures);
-            pBuf = Util_bufferUint16(pBuf,
-                                     pMsg->msgStats.otherDataRequestFailures);
-            pBuf = Util_bufferUint16(pBuf, pMsg->msgStats.syncLossIndications);
-            pBuf = Util_bufferUint16(pBuf, pMsg->msgStats.rxDecryptFailures);
-            pBuf = Util_bufferUint16(pBuf,  pMsg->msgStats.txEncryptFailures);
-            pBuf = Util_bufferUint16(pBuf, Ssf_resetCount);
-            pBuf = Util_bufferUint16(pBuf,  Ssf_resetReseason);
+            pBuf = bufferMsgStats(pBuf, &pMsg->msgStats);
         }
         if(pMsg->frameControl & Smsgs_dataFields_configSettings)
         {
@@ -777,6 +842,14 @@ static bool sendSensorMessage(ApiMac_sAddr_t *pDstAddr, Smsgs_sensorMsg_t *pMsg)
                                      pMsg->configSettings.pollingInterval);
 
         }
+        if(pMsg->frameControl & Smsgs_dataFields_configEpoch)
+        {
+            *pBuf++ = pMsg->configEpoch;
+        }
+        if(pMsg->frameControl & Smsgs_dataFields_powerStats)
+        {
+            pBuf = bufferPowerStats(pBuf, &pMsg->powerStats);
+        }
 
         ret = sendMsg(Smsgs_cmdIds_sensorData, pDstAddr, true, len, pMsgBuf);
 
@@ -786,6 +859,300 @@ static bool sendSensorMessage(ApiMac_sAddr_t *pDstAddr, Smsgs_sensorMsg_t *pMsg)
     return (ret);
 }
 
+/*!
+ * @brief   Add a reading to the Sensor Batch message, and send the message
+ *          when it has CONFIG_BATCH_SAMPLES readings.
+ *
+ * @param   pMsg - pointer to the sensor data of the reading
+ */
+static void addBatchSample(Smsgs_sensorMsg_t *pMsg)
+{
+    uint32_t now = Ssf_getTime();
+    uint32_t elapsed = now - batchLastTime;
+    uint8_t idx;
+
+    /* The interval to the previous reading has to fit in the message */
+    if((sensorBatch.numSamples > 0)
+       && (elapsed > SMSGS_SENSOR_BATCH_MAX_INTERVAL))
+    {
+        sendSensorBatch(&collectorAddr, pMsg);
+    }
+
+    for(idx = 0; idx < sensorBatch.numSamples; idx++)
+    {
+        sensorBatch.sampleAge[idx] += elapsed;
+    }
+
+    idx = sensorBatch.numSamples++;
+    sensorBatch.sampleAge[idx] = 0;
+    memcpy(&sensorBatch.tempSensor[idx], &pMsg->tempSensor,
+           sizeof(Smsgs_tempSensorField_t));
+    memcpy(&sensorBatch.lightSensor[idx], &pMsg->lightSensor,
+           sizeof(Smsgs_lightSensorField_t));
+    memcpy(&sensorBatch.humiditySensor[idx], &pMsg->humiditySensor,
+           sizeof(Smsgs_humiditySensorField_t));
+    batchLastTime = now;
+
+    if(sensorBatch.numSamples >= CONFIG_BATCH_SAMPLES)
+    {
+        sendSensorBatch(&collectorAddr, pMsg);
+    }
+}
+
+/*!
+ * @brief   Build and send the Sensor Batch message, then start a new one.
+ *          The message statistics and config settings are only included in
+ *          one message out of CONFIG_BATCH_STATS_INTERVAL.
+ *
+ * @param   pDstAddr - Where to send the message
+ * @param   pMsg - pointer to the sensor data of the last reading, for the
+ *                 frame control, message statistics and config settings
+ *
+ * @return  true if message was sent, false if not
+ */
+static bool sendSensorBatch(ApiMac_sAddr_t *pDstAddr, Smsgs_sensorMsg_t *pMsg)
+{
+    bool ret = false;
+    uint8_t *pMsgBuf;
+    uint8_t numSamples = sensorBatch.numSamples;
+    uint16_t frameControl = pMsg->frameControl;
+    uint16_t len;
+    uint8_t idx;
+
+    if(numSamples == 0)
+    {
+        return (false);
+    }
+
+    if(batchStatsCount != 0)
+    {
+        frameControl &= ~(Smsgs_dataFields_msgStats
+                        | Smsgs_dataFields_configSettings
+                        | Smsgs_dataFields_powerStats);
+    }
+    if(++batchStatsCount >= CONFIG_BATCH_STATS_INTERVAL)
+    {
+        batchStatsCount = 0;
+    }
+
+#if PWRACCT_ENABLED
+    /* The power statistics cover the time since they were last sent */
+    if(frameControl & Smsgs_dataFields_powerStats)
+    {
+        readPowerStats(&pMsg->powerStats);
+    }
+#endif
+
+    /* Figure out the length */
+    len = SMSGS_BASIC_SENSOR_BATCH_LEN
+          + ((numSamples - 1) * SMSGS_SENSOR_BATCH_INTERVAL_LEN);
+    if(frameControl & Smsgs_dataFields_tempSensor)
+    {
+        len += numSamples * SMSGS_SENSOR_TEMP_LEN;
+    }
+    if(frameControl & Smsgs_dataFields_lightSensor)
+    {
+        len += numSamples * SMSGS_SENSOR_LIGHT_LEN;
+    }
+    if(frameControl & Smsgs_dataFields_humiditySensor)
+    {
+        len += numSamples * SMSGS_SENSOR_HUMIDITY_LEN;
+    }
+    if(frameControl & Smsgs_dataFields_msgStats)
+    {
+        len += SMSGS_SENSOR_MSG_STATS_LEN;
+    }
+    if(frameControl & Smsgs_dataFields_configSettings)
+    {
+        len += SMSGS_SENSOR_CONFIG_SETTINGS_LEN;
+    }
+    if(frameControl & Smsgs_dataFields_configEpoch)
+    {
+        len += SMSGS_SENSOR_CONFIG_EPOCH_LEN;
+    }
+    if(frameControl & Smsgs_dataFields_powerStats)
+    {
+        len += SMSGS_SENSOR_POWER_STATS_LEN;
+    }
+
+    pMsgBuf = (uint8_t *)Ssf_malloc(len);
+    if(pMsgBuf)
+    {
+        uint8_t *pBuf = pMsgBuf;
+
+        *pBuf++ = (uint8_t)Smsgs_cmdIds_sensorBatch;
+        pBuf = Util_bufferUint16(pBuf, frameControl);
+        *pBuf++ = numSamples;
+
+        for(idx = 1; idx < numSamples; idx++)
+        {
+            pBuf = Util_bufferUint16(pBuf,
+                                     (uint16_t)(sensorBatch.sampleAge[idx - 1]
+                                           - sensorBatch.sampleAge[idx]));
+        }
+
+        if(frameControl & Smsgs_dataFields_tempSensor)
+        {
+            for(idx = 0; idx < numSamples; idx++)
+            {
+                pBuf = Util_bufferUint16(
+                                pBuf, sensorBatch.tempSensor[idx].ambienceTemp);
+                pBuf = Util_bufferUint16(
+                                pBuf, sensorBatch.tempSensor[idx].objectTemp);
+            }
+        }
+        if(frameControl & Smsgs_dataFields_lightSensor)
+        {
+            for(idx = 0; idx < numSamples; idx++)
+            {
+                pBuf = Util_bufferUint16(
+                                pBuf, sensorBatch.lightSensor[idx].rawData);
+            }
+        }
+        if(frameControl & Smsgs_dataFields_humiditySensor)
+        {
+            for(idx = 0; idx < numSamples; idx++)
+            {
+                pBuf = Util_bufferUint16(
+                                pBuf, sensorBatch.humiditySensor[idx].temp);
+                pBuf = Util_bufferUint16(
+                                pBuf, sensorBatch.humiditySensor[idx].humidity);
+            }
+        }
+        if(frameControl & Smsgs_dataFields_msgStats)
+        {
+            pBuf = bufferMsgStats(pBuf, &pMsg->msgStats);
+        }
+        if(frameControl & Smsgs_dataFields_configSettings)
+        {
+            pBuf = Util_bufferUint32(pBuf,
+                                     pMsg->configSettings.reportingInterval);
+            pBuf = Util_bufferUint32(pBuf,
+                                     pMsg->configSettings.pollingInterval);
+        }
+        if(frameControl & Smsgs_dataFields_configEpoch)
+        {
+            *pBuf++ = pMsg->configEpoch;
+        }
+        if(frameControl & Smsgs_dataFields_powerStats)
+        {
+            pBuf = bufferPowerStats(pBuf, &pMsg->powerStats);
+        }
+
+        ret = sendMsg(Smsgs_cmdIds_sensorBatch, pDstAddr, true, len, pMsgBuf);
+
+        Ssf_free(pMsgBuf);
+    }
+
+    /* The readings are dropped if the message can't be built */
+    sensorBatch.numSamples = 0;
+
+    return (ret);
+}
+
+/*!
+ * @brief   Copy the message statistics field into a message buffer
+ *
+ * @param   pBuf - where to put the field
+ * @param   pStats - message statistics
+ *
+ * @return  pointer to the byte after the field
+ */
+static uint8_t *bufferMsgStats(uint8_t *pBuf, Smsgs_msgStatsField_t *pStats)
+{
+    pBuf = Util_bufferUint16(pBuf, pStats->joinAttempts);
+    pBuf = Util_bufferUint16(pBuf, pStats->joinFails);
+    pBuf = Util_bufferUint16(pBuf, pStats->msgsAttempted);
+    pBuf = Util_bufferUint16(pBuf, pStats->msgsSent);
+    pBuf = Util_bufferUint16(pBuf, pStats->trackingRequests);
+    pBuf = Util_bufferUint16(pBuf, pStats->trackingResponseAttempts);
+    pBuf = Util_bufferUint16(pBuf, pStats->trackingResponseSent);
+    pBuf = Util_bufferUint16(pBuf, pStats->configRequests);
+    pBuf = Util_bufferUint16(pBuf, pStats->configResponseAttempts);
+    pBuf = Util_bufferUint16(pBuf, pStats->configResponseSent);
+    pBuf = Util_bufferUint16(pBuf, pStats->channelAccessFailures);
+    pBuf = Util_bufferUint16(pBuf, pStats->macAckFailures);
+    pBuf = Util_bufferUint16(pBuf, pStats->otherDataRequestFailures);
+    pBuf = Util_bufferUint16(pBuf, pStats->syncLossIndications);
+    pBuf = Util_bufferUint16(pBuf, pStats->rxDecryptFailures);
+    pBuf = Util_bufferUint16(pBuf, pStats->txEncryptFailures);
+    pBuf = Util_bufferUint16(pBuf, Ssf_resetCount);
+    pBuf = Util_bufferUint16(pBuf, Ssf_resetReseason);
+
+    return (pBuf);
+}
+
+/*!
+ * @brief   Build the Power Statistics field of a sensor message
+ *
+ * @param   pBuf - where to put the field
+ * @param   pStats - power statistics
+ *
+ * @return  pointer to the byte after the field
+ */
+static uint8_t *bufferPowerStats(uint8_t *pBuf,
+                                 Smsgs_powerStatsField_t *pStats)
+{
+    pBuf = Util_bufferUint16(pBuf, pStats->stackActive);
+    pBuf = Util_bufferUint16(pBuf, pStats->appActive);
+    pBuf = Util_bufferUint16(pBuf, pStats->otherActive);
+    pBuf = Util_bufferUint16(pBuf, pStats->idleSleep);
+    pBuf = Util_bufferUint16(pBuf, pStats->standbySleep);
+    pBuf = Util_bufferUint16(pBuf, pStats->timerWakeups);
+    pBuf = Util_bufferUint16(pBuf, pStats->radioWakeups);
+    pBuf = Util_bufferUint16(pBuf, pStats->otherWakeups);
+
+    return (pBuf);
+}
+
+#if PWRACCT_ENABLED
+/*!
+ * @brief   Fill in the power statistics with the time and wakeups since
+ *          they were last read, and start a new period
+ *
+ * @param   pStats - power statistics
+ */
+static void readPowerStats(Smsgs_powerStatsField_t *pStats)
+{
+    Pwracct_stats_t pwr;
+
+    Pwracct_read(&pwr, true);
+
+    pStats->stackActive = getPermille(pwr.taskTime[Pwracct_task_stack],
+                                      pwr.elapsed);
+    pStats->appActive = getPermille(pwr.taskTime[Pwracct_task_app],
+                                    pwr.elapsed);
+    pStats->otherActive = getPermille(pwr.taskTime[Pwracct_task_npi]
+                                      + pwr.taskTime[Pwracct_task_other],
+                                      pwr.elapsed);
+    pStats->idleSleep = getPermille(pwr.idleTime, pwr.elapsed);
+    pStats->standbySleep = getPermille(pwr.standbyTime, pwr.elapsed);
+    pStats->timerWakeups = pwr.wakeups[Pwracct_wake_timer];
+    pStats->radioWakeups = pwr.wakeups[Pwracct_wake_radio];
+    pStats->otherWakeups = pwr.wakeups[Pwracct_wake_uart]
+                    + pwr.wakeups[Pwracct_wake_pin]
+                    + pwr.wakeups[Pwracct_wake_other];
+}
+
+/*!
+ * @brief   Find a share in 1/1000
+ *
+ * @param   part - part of the whole
+ * @param   whole - whole
+ *
+ * @return  part / whole in 1/1000, 0 if whole is 0
+ */
+static uint16_t getPermille(uint32_t part, uint32_t whole)
+{
+    if(whole == 0)
+    {
+        return (0);
+    }
+
+    return ((uint16_t)(((uint64_t)part * 1000) / whole));
+}
+#endif /* PWRACCT_ENABLED */
+
 /*!
  * @brief      Process the Config Request message.
  *
@@ -799,22 +1166,14 @@ static void processConfigRequest(ApiMac_mcpsDataInd_t *pDataInd)
     memset(&configRsp, 0, sizeof(Smsgs_configRspMsg_t));
 
     /* Make sure the message is the correct size */
-    if(pDataInd->msdu.len == SMSGS_CONFIG_REQUEST_MSG_LENGTH)
+    if((pDataInd->msdu.len == SMSGS_CONFIG_REQUEST_MSG_LENGTH)
+       || (pDataInd->msdu.len == SMSGS_CONFIG_REQUEST_POLICY_MSG_LENGTH))
     {
         uint8_t *pBuf = pDataInd->msdu.p;
-        uint16_t frameControl;
-        uint32_t reportingInterval;
-        uint32_t pollingInterval;
 
         /* Parse the message */
         configSettings.cmdId = (Smsgs_cmdIds_t)*pBuf++;
-        frameControl = Util_parseUint16(pBuf);
-        pBuf += 2;
-        reportingInterval = Util_parseUint32(pBuf);
-        pBuf += 4;
-        pollingInterval = Util_parseUint32(pBuf);
 
-        stat = Smsgs_statusValues_success;
         collectorAddr.addrMode = pDataInd->srcAddr.addrMode;
         if(collectorAddr.addrMode == ApiMac_addrType_short)
         {
@@ -826,36 +1185,8 @@ static void processConfigRequest(ApiMac_mcpsDataInd_t *pDataInd)
                    (APIMAC_SADDR_EXT_LEN));
         }
 
-        configSettings.frameControl = validateFrameControl(frameControl);
-        if(configSettings.frameControl != frameControl)
-        {
-            stat = Smsgs_statusValues_partialSuccess;
-        }
-        configRsp.frameControl = configSettings.frameControl;
-
-        if((reportingInterval < MIN_REPORTING_INTERVAL)
-           || (reportingInterval > MAX_REPORTING_INTERVAL))
-        {
-            stat = Smsgs_statusValues_partialSuccess;
-        }
-        else
-        {
-            configSettings.reportingInterval = reportingInterval;
-            Ssf_setReadingClock(reportingInterval);
-        }
-        configRsp.reportingInterval = configSettings.reportingInterval;
-
-        if((pollingInterval < MIN_POLLING_INTERVAL)
-           || (pollingInterval > MAX_POLLING_INTERVAL))
-        {
-            stat = Smsgs_statusValues_partialSuccess;
-        }
-        else
-        {
-            configSettings.pollingInterval = pollingInterval;
-            Jdllc_setPollRate(configSettings.pollingInterval);
-        }
-        configRsp.pollingInterval = configSettings.pollingInterval;
+        stat = applyConfig(pBuf, (pDataInd->msdu.len
+                        == SMSGS_CONFIG_REQUEST_POLICY_MSG_LENGTH), &configRsp);
     }
 
     /* Send the response message */
@@ -869,6 +1200,120 @@ static void processConfigRequest(ApiMac_mcpsDataInd_t *pDataInd)
     sendConfigRsp(&pDataInd->srcAddr, &configRsp);
 }
 
+/*!
+ * @brief      Process the Config Epoch message. The configuration is only
+ *             applied if the epoch changed, and isn't responded to.
+ *
+ * @param      pDataInd - pointer to the data indication information
+ */
+static void processConfigEpoch(ApiMac_mcpsDataInd_t *pDataInd)
+{
+    Smsgs_configRspMsg_t configRsp;
+    uint8_t *pBuf = pDataInd->msdu.p;
+    uint8_t epoch;
+
+    /* Make sure the message is the correct size */
+    if((pDataInd->msdu.len != SMSGS_CONFIG_EPOCH_MSG_LENGTH)
+       && (pDataInd->msdu.len != SMSGS_CONFIG_EPOCH_POLICY_MSG_LENGTH))
+    {
+        return;
+    }
+
+    /* Skip past the command ID */
+    pBuf++;
+
+    epoch = *pBuf++;
+    if((epoch == 0) || (epoch == configEpoch))
+    {
+        /* Already applied */
+        return;
+    }
+
+    memset(&configRsp, 0, sizeof(Smsgs_configRspMsg_t));
+    configRsp.cmdId = Smsgs_cmdIds_configRsp;
+    configRsp.status = applyConfig(pBuf, (pDataInd->msdu.len
+                    == SMSGS_CONFIG_EPOCH_POLICY_MSG_LENGTH), &configRsp);
+    configEpoch = epoch;
+
+    /* Update the user */
+    Ssf_configurationUpdate(&configRsp);
+}
+
+/*!
+ * @brief      Apply the configuration fields shared by the Config Request
+ *             and Config Epoch messages.
+ *
+ * @param      pBuf - pointer to the Frame Control field
+ * @param      reportPolicy - true if the Report Policy field follows
+ * @param      pRsp - filled in with the settings in use
+ *
+ * @return     Smsgs_statusValues_success, or
+ *             Smsgs_statusValues_partialSuccess if a field was out of range
+ */
+static Smsgs_statusValues_t applyConfig(uint8_t *pBuf, bool reportPolicy,
+                                        Smsgs_configRspMsg_t *pRsp)
+{
+    Smsgs_statusValues_t stat = Smsgs_statusValues_success;
+    uint16_t frameControl;
+    uint32_t reportingInterval;
+    uint32_t pollingInterval;
+
+    frameControl = Util_parseUint16(pBuf);
+    pBuf += 2;
+    reportingInterval = Util_parseUint32(pBuf);
+    pBuf += 4;
+    pollingInterval = Util_parseUint32(pBuf);
+    pBuf += 4;
+
+    if(reportPolicy == true)
+    {
+        Smsgs_reportPolicyField_t *pPolicy = &configSettings.reportPolicy;
+
+        pPolicy->tempDeadband = Util_parseUint16(pBuf);
+        pBuf += 2;
+        pPolicy->lightDeadband = Util_parseUint16(pBuf);
+        pBuf += 2;
+        pPolicy->humidityDeadband = Util_parseUint16(pBuf);
+        pBuf += 2;
+        pPolicy->heartbeatInterval = Util_parseUint32(pBuf);
+
+        Rpol_setPolicy(pPolicy);
+    }
+
+    configSettings.frameControl = validateFrameControl(frameControl);
+    if(configSettings.frameControl != frameControl)
+    {
+        stat = Smsgs_statusValues_partialSuccess;
+    }
+    pRsp->frameControl = configSettings.frameControl;
+
+    if((reportingInterval < MIN_REPORTING_INTERVAL)
+       || (reportingInterval > MAX_REPORTING_INTERVAL))
+    {
+        stat = Smsgs_statusValues_partialSuccess;
+    }
+    else
+    {
+        configSettings.reportingInterval = reportingInterval;
+        Ssf_setReadingClock(reportingInterval);
+    }
+    pRsp->reportingInterval = configSettings.reportingInterval;
+
+    if((pollingInterval < MIN_POLLING_INTERVAL)
+       || (pollingInterval > MAX_POLLING_INTERVAL))
+    {
+        stat = Smsgs_statusValues_partialSuccess;
+    }
+    else
+    {
+        configSettings.pollingInterval = pollingInterval;
+        Jdllc_setPollRate(configSettings.pollingInterval);
+    }
+    pRsp->pollingInterval = configSettings.pollingInterval;
+
+    return (stat);
+}
+
 /*!
  * @brief   Build and send Config Response message
  *
@@ -929,6 +1374,16 @@ static uint16_t validateFrameControl(uint16_t frameControl)
     {
         newFrameControl |= Smsgs_dataFields_configSettings;
     }
+    if(frameControl & Smsgs_dataFields_configEpoch)
+    {
+        newFrameControl |= Smsgs_dataFields_configEpoch;
+    }
+#if PWRACCT_ENABLED
+    if(frameControl & Smsgs_dataFields_powerStats)
+    {
+        newFrameControl |= Smsgs_dataFields_powerStats;
+    }
+#endif
 
     return (newFrameControl);
 }
@@ -80,6 +80,30 @@ extern "C"
      - Polling Interval - in millseconds (32 bits) - If the sensor device is
      a sleep device, this tells the device how often to poll its parent for
      data.
+     - Report Policy - optional, see below. A request without it leaves the
+     sensor's report policy unchanged.
+ <BR>
+ The <b>Report Policy Field</b> tells the sensor which readings to send, a
+ reading is still taken every reporting interval:
+     - Temp Deadband - (16 bits) - a change of either temperature by more
+     than this, in the units of the Temp Sensor Field, since the last
+     reported reading is sent.
+     - Light Deadband - (16 bits) - same for the Light Sensor Field.
+     - Humidity Deadband - (16 bits) - same for either value of the
+     Humidity Sensor Field.
+     - Heartbeat Interval - in milliseconds (32 bits) - longest time without
+     a report, a reading is sent after this long even if nothing changed. 0
+     turns the policy off, every reading is sent.
+ <BR>
+ The <b>Config Epoch Message</b> pushes a configuration to every sensor, it
+ is broadcast when the collector's configuration changes and sent to each
+ sensor that later reports an older epoch. A sensor applies it if the epoch
+ differs from its own and doesn't respond, its next Config Epoch field shows
+ the change:
+     - Command ID - [Smsgs_cmdIds_configEpoch](@ref Smsgs_cmdIds) (1 byte)
+     - Epoch - (8 bits) - configuration version, 0 is never used.
+     - Frame Control, Reporting Interval, Polling Interval and the optional
+     Report Policy - as in the Configuration Request Message.
  <BR>
  The <b>Configuration Response Message</b> is defined as:
      - Command ID - [Smsgs_cmdIds_configRsp](@ref Smsgs_cmdIds) (1 byte)
@@ -105,6 +129,25 @@ extern "C"
      Smsgs_dataFields_lightSensor set, then the Temp Sensor field is first,
      followed by the light sensor field.
  <BR>
+ The <b>Sensor Batch Message</b> carries several readings of a sensor in one
+ frame, the extended address is left out (the collector knows it from the MAC
+ source address):
+     - Command ID - [Smsgs_cmdIds_sensorBatch](@ref Smsgs_cmdIds) (1 byte)
+     - Frame Control field - Smsgs_dataFields (16 bits) - tells the collector
+     what fields are included in this message. The Message Statistics and
+     Config Settings fields are usually only included in some of the
+     messages, and so is the Power Statistics field.
+     - Number of Samples - (8 bits) - 1 to SMSGS_SENSOR_BATCH_MAX_SAMPLES.
+     - Sample Intervals - Number of Samples - 1 times (16 bits each) - time
+     in milliseconds from each sample to the next one, oldest first. The
+     last sample was read when the message was sent.
+     - Sample Fields - for each included sensor field, in the order of the
+     Sensor Data Message, the field of every sample, oldest first. For
+     example, with the Temp Sensor and Light Sensor fields and 3 samples:
+     Temp Sensor 1, 2, 3 then Light Sensor 1, 2, 3.
+     - Message Statistics, Config Settings, Config Epoch and Power
+     Statistics fields, if included, as in the Sensor Data Message.
+ <BR>
  The <b>Temp Sensor Field</b> is defined as:
     - Ambience Chip Temperature - (int16_t) - each value represents signed
       integer part of temperature in Deg C (-256 .. +255)
@@ -159,6 +202,24 @@ extern "C"
      - Polling Interval - in millseconds (32 bits) - If the sensor device is
      a sleep device, this states how often the device polls its parent for
      data. This field is 0 if the device doesn't sleep.
+ <BR>
+ The <b>Config Epoch Field</b> is defined as:
+     - Epoch - (8 bits) - epoch of the last Config Epoch Message applied, 0
+     if none.
+ <BR>
+ The <b>Power Statistics Field</b> is defined as, since the field was last
+ sent:
+     - stackActive - uint16_t - share of the time the MAC stack task ran, in
+     1/1000.
+     - appActive - uint16_t - share of the time the sensor task ran, in
+     1/1000.
+     - otherActive - uint16_t - share of the time any other task ran, in
+     1/1000.
+     - idleSleep - uint16_t - share of the time the CPU idled, in 1/1000.
+     - standbySleep - uint16_t - share of the time in standby, in 1/1000.
+     - timerWakeups - uint16_t - wakeups from standby by the RTC.
+     - radioWakeups - uint16_t - wakeups from standby by the radio.
+     - otherWakeups - uint16_t - other wakeups from standby.
  */
 
 /******************************************************************************
@@ -169,6 +230,16 @@ extern "C"
 
 /*! Config Request message length (over-the-air length) */
 #define SMSGS_CONFIG_REQUEST_MSG_LENGTH 11
+/*! Length of the report policy portion of the config request message */
+#define SMSGS_CONFIG_REPORT_POLICY_LEN 10
+/*! Config Request message length with the report policy */
+#define SMSGS_CONFIG_REQUEST_POLICY_MSG_LENGTH \
+    (SMSGS_CONFIG_REQUEST_MSG_LENGTH + SMSGS_CONFIG_REPORT_POLICY_LEN)
+/*! Length of a config epoch message */
+#define SMSGS_CONFIG_EPOCH_MSG_LENGTH (SMSGS_CONFIG_REQUEST_MSG_LENGTH + 1)
+/*! Length of a config epoch message with the report policy */
+#define SMSGS_CONFIG_EPOCH_POLICY_MSG_LENGTH \
+    (SMSGS_CONFIG_EPOCH_MSG_LENGTH + SMSGS_CONFIG_REPORT_POLICY_LEN)
 /*! Config Response message length (over-the-air length) */
 #define SMSGS_CONFIG_RESPONSE_MSG_LENGTH 13
 /*! Tracking Request message length (over-the-air length) */
@@ -188,11 +259,24 @@ extern "C"
 #define SMSGS_SENSOR_MSG_STATS_LEN 36
 /*! Length of the configSettings portion of the sensor data message */
 #define SMSGS_SENSOR_CONFIG_SETTINGS_LEN 8
+/*! Length of the config epoch portion of the sensor data message */
+#define SMSGS_SENSOR_CONFIG_EPOCH_LEN 1
+/*! Length of the powerStats portion of the sensor data message */
+#define SMSGS_SENSOR_POWER_STATS_LEN 16
 /*! Toggle Led Request message length (over-the-air length) */
 #define SMSGS_TOGGLE_LED_REQUEST_MSG_LEN 1
 /*! Toggle Led Request message length (over-the-air length) */
 #define SMSGS_TOGGLE_LED_RESPONSE_MSG_LEN 2
 
+/*! Most samples in a sensor batch message */
+#define SMSGS_SENSOR_BATCH_MAX_SAMPLES 8
+/*! Length of a sensor batch message with no data fields and one sample */
+#define SMSGS_BASIC_SENSOR_BATCH_LEN 4
+/*! Length of each sample interval of the sensor batch message */
+#define SMSGS_SENSOR_BATCH_INTERVAL_LEN 2
+/*! Longest sample interval of the sensor batch message, in milliseconds */
+#define SMSGS_SENSOR_BATCH_MAX_INTERVAL 0xFFFF
+
 /*!
  Message IDs for Sensor data messages.  When sent over-the-air in a message,
  this field is one byte.
@@ -212,7 +296,11 @@ extern "C"
     /* Toggle LED message, sent from the collector to the sensor */
     Smsgs_cmdIds_toggleLedReq = 6,
     /* Toggle LED response msg, sent from the sensor to the collector */
-    Smsgs_cmdIds_toggleLedRsp = 7
+    Smsgs_cmdIds_toggleLedRsp = 7,
+    /*! Sensor batch message, sent from the sensor to the collector */
+    Smsgs_cmdIds_sensorBatch = 8,
+    /*! Config epoch message, sent from the collector to the sensors */
+    Smsgs_cmdIds_configEpoch = 9
  } Smsgs_cmdIds_t;
 
 /*!
@@ -233,6 +321,10 @@ typedef enum
     Smsgs_dataFields_msgStats = 0x0008,
     /*! Config Settings */
     Smsgs_dataFields_configSettings = 0x0010,
+    /*! Config Epoch */
+    Smsgs_dataFields_configEpoch = 0x0020,
+    /*! Power Statistics */
+    Smsgs_dataFields_powerStats = 0x0040,
 } Smsgs_dataFields_t;
 
 /*!
@@ -256,6 +348,24 @@ typedef enum
  Structures - Building blocks for the over-the-air sensor messages
  *****************************************************************************/
 
+/*!
+ Report Policy Field
+ */
+typedef struct _Smsgs_reportpolicyfield_t
+{
+    /*! Temperature change that is reported */
+    uint16_t tempDeadband;
+    /*! Light change that is reported */
+    uint16_t lightDeadband;
+    /*! Humidity change that is reported */
+    uint16_t humidityDeadband;
+    /*!
+     Heartbeat Interval - in milliseconds, longest time without a report,
+     0 to report every reading.
+     */
+    uint32_t heartbeatInterval;
+} Smsgs_reportPolicyField_t;
+
 /*!
  Configuration Request message: sent from controller to the sensor.
  */
@@ -269,8 +379,29 @@ typedef struct _Smsgs_configreqmsg_t
     uint32_t reportingInterval;
     /*! Polling Interval */
     uint32_t pollingInterval;
+    /*! Report Policy - optional over-the-air */
+    Smsgs_reportPolicyField_t reportPolicy;
 } Smsgs_configReqMsg_t;
 
+/*!
+ Config Epoch message: broadcast or sent from the collector to the sensor.
+ */
+typedef struct _Smsgs_configepochmsg_t
+{
+    /*! Command ID - 1 byte */
+    Smsgs_cmdIds_t cmdId;
+    /*! Epoch - 1 byte */
+    uint8_t epoch;
+    /*! Frame Control field - bit mask of Smsgs_dataFields */
+    uint16_t frameControl;
+    /*! Reporting Interval */
+    uint32_t reportingInterval;
+    /*! Polling Interval */
+    uint32_t pollingInterval;
+    /*! Report Policy - optional over-the-air */
+    Smsgs_reportPolicyField_t reportPolicy;
+} Smsgs_configEpochMsg_t;
+
 /*!
  Configuration Response message: sent from the sensor to the collector
  in response to the Configuration Request message.
@@ -421,6 +552,30 @@ typedef struct _Smsgs_msgstatsfield_t
     uint16_t lastResetReason;
 } Smsgs_msgStatsField_t;
 
+/*!
+ Power Statistics Field, the time and wakeups since the last time the field
+ was sent. Only sensors built with PWRACCT_ENABLED send it, see pwracct.h.
+ */
+typedef struct _Smsgs_powerstatsfield_t
+{
+    /*! Share of the time that the MAC stack task ran, in 1/1000 */
+    uint16_t stackActive;
+    /*! Share of the time the sensor task ran, in 1/1000 */
+    uint16_t appActive;
+    /*! Share of the time any other task ran, in 1/1000 */
+    uint16_t otherActive;
+    /*! Share of the time the CPU idled between interrupts, in 1/1000 */
+    uint16_t idleSleep;
+    /*! Share of the time the device was in standby, in 1/1000 */
+    uint16_t standbySleep;
+    /*! Wakeups from standby by the RTC */
+    uint16_t timerWakeups;
+    /*! Wakeups from standby by the radio */
+    uint16_t radioWakeups;
+    /*! Other wakeups from standby, pins or UART */
+    uint16_t otherWakeups;
+} Smsgs_powerStatsField_t;
+
 /*!
  Message Statistics Field
  */
@@ -475,8 +630,71 @@ typedef struct _Smsgs_sensormsg_t
      Smsgs_dataFields_configSettings is set in frameControl.
      */
     Smsgs_configSettingsField_t configSettings;
+    /*!
+     Config Epoch field - valid only if Smsgs_dataFields_configEpoch is set
+     in frameControl.
+     */
+    uint8_t configEpoch;
+    /*!
+     Power Statistics field - valid only if Smsgs_dataFields_powerStats is
+     set in frameControl.
+     */
+    Smsgs_powerStatsField_t powerStats;
 } Smsgs_sensorMsg_t;
 
+/*!
+ Sensor Batch message: sent from the sensor to the collector
+ */
+typedef struct _Smsgs_sensorbatchmsg_t
+{
+    /*! Command ID */
+    Smsgs_cmdIds_t cmdId;
+    /*! Frame Control field - bit mask of Smsgs_dataFields */
+    uint16_t frameControl;
+    /*! Number of samples */
+    uint8_t numSamples;
+    /*!
+     Time in milliseconds from each sample to the last one, so the last
+     sample has an age of 0.
+     */
+    uint32_t sampleAge[SMSGS_SENSOR_BATCH_MAX_SAMPLES];
+    /*!
+     Temp Sensor fields - valid only if Smsgs_dataFields_tempSensor
+     is set in frameControl.
+     */
+    Smsgs_tempSensorField_t tempSensor[SMSGS_SENSOR_BATCH_MAX_SAMPLES];
+    /*!
+     Light Sensor fields - valid only if Smsgs_dataFields_lightSensor
+     is set in frameControl.
+     */
+    Smsgs_lightSensorField_t lightSensor[SMSGS_SENSOR_BATCH_MAX_SAMPLES];
+    /*!
+     Humidity Sensor fields - valid only if Smsgs_dataFields_humiditySensor
+     is set in frameControl.
+     */
+    Smsgs_humiditySensorField_t humiditySensor[SMSGS_SENSOR_BATCH_MAX_SAMPLES];
+    /*!
+     Message Statistics field - valid only if Smsgs_dataFields_msgStats
+     is set in frameControl.
+     */
+    Smsgs_msgStatsField_t msgStats;
+    /*!
+     Configuration Settings field - valid only if
+     Smsgs_dataFields_configSettings is set in frameControl.
+     */
+    Smsgs_configSettingsField_t configSettings;
+    /*!
+     Config Epoch field - valid only if Smsgs_dataFields_configEpoch is set
+     in frameControl.
+     */
+    uint8_t configEpoch;
+    /*!
+     Power Statistics field - valid only if Smsgs_dataFields_powerStats is
+     set in frameControl.
+     */
+    Smsgs_powerStatsField_t powerStats;
+} Smsgs_sensorBatchMsg_t;
+
 
 #ifdef __cplusplus
 }
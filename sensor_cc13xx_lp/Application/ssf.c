@@ -69,6 +69,7 @@
 #include "board_key.h"
 #include "board_lcd.h"
 #include "board_led.h"
+#include "blist.h"
 
 #include "macconfig.h"
 
@@ -199,6 +200,10 @@ STATIC Clock_Handle fhAssocClkHandle;
 /* Key press parameters */
 static uint8_t keys;
 
+/* Ssf_getTime() clock ticks already counted, and the time they add up to */
+static uint32_t timeTicks = 0;
+static uint32_t timeMsecs = 0;
+
 /* pending events */
 static uint16_t events = 0;
 
@@ -215,6 +220,17 @@ static bool started = false;
 
 static bool led1State = false;
 
+/* RAM copy of the black list, the beacon filter reads only this */
+static Blist_entry_t blackListEntries[SSF_MAX_BLACKLIST_ENTRIES];
+static Blist_t blackList;
+
+/* NV items of the black list, the NV functions are set at init */
+static Blist_nv_t blackListNv =
+{
+    NULL, SSF_NV_BLACKLIST_ID, SSF_NV_BLACKLIST_ENTRIES_ID,
+    SSF_MAX_BLACKLIST_IDS
+};
+
 /******************************************************************************
  Local function prototypes
  *****************************************************************************/
@@ -226,9 +242,6 @@ static void processPASTrickleTimeoutCallback(UArg a0);
 static void processPollTimeoutCallback(UArg a0);
 static void processScanBackoffTimeoutCallback(UArg a0);
 static void processFHAssocTimeoutCallback(UArg a0);
-static int findUnuedBlackListIndex(void);
-static uint16_t getNumBlackListEntries(void);
-static void saveNumBlackListEntries(uint16_t numEntries);
 
 /******************************************************************************
  Public Functions
@@ -249,6 +262,9 @@ void Ssf_init(void *sem)
     /* Save off the semaphore */
     sensorSem = sem;
 
+    Blist_init(&blackList, blackListEntries, SSF_MAX_BLACKLIST_ENTRIES);
+    blackListNv.pNV = pNV;
+
     /* Initialize keys */
     if(Board_Key_initialize(processKeyChangeCallback) == KEY_RIGHT)
     {
@@ -256,6 +272,9 @@ void Ssf_init(void *sem)
         Ssf_clearAllNVItems();
     }
 
+    /* Read the black list from NV once, lookups use the RAM copy */
+    Blist_load(&blackList, &blackListNv);
+
     /* Initialize the LCD */
     Board_LCD_open();
 
@@ -571,6 +590,23 @@ void Ssf_setReadingClock(uint32_t readingTime)
     }
 }
 
+/*!
+ Get the time since the device started.
+
+ Public function defined in ssf.h
+ */
+uint32_t Ssf_getTime(void)
+{
+    uint32_t ticksPerMsec = 1000 / Clock_tickPeriod;
+    uint32_t msecs = (Clock_getTicks() - timeTicks) / ticksPerMsec;
+
+    /* Keep the ticks of a partial millisecond for the next call */
+    timeTicks += msecs * ticksPerMsec;
+    timeMsecs += msecs;
+
+    return (timeMsecs);
+}
+
 /*!
  Ssf implementation for memory allocation
 
@@ -788,56 +824,7 @@ void Ssf_setFHAssocClock(uint32_t fhAssocTime)
  */
 int Ssf_findBlackListIndex(ApiMac_sAddr_t *pAddr)
 {
-    if((pNV != NULL) && (pAddr != NULL)
-       && (pAddr->addrMode != ApiMac_addrType_none))
-    {
-        uint16_t numEntries;
-
-        numEntries = getNumBlackListEntries();
-
-        if(numEntries > 0)
-        {
-            NVINTF_itemID_t id;
-            uint8_t stat;
-            int subId = 0;
-            int readItems = 0;
-
-            /* Setup NV ID for the black list records */
-            id.systemID = NVINTF_SYSID_APP;
-            id.itemID = SSF_NV_BLACKLIST_ID;
-
-            while((readItems < numEntries) && (subId < SSF_MAX_BLACKLIST_IDS))
-            {
-                ApiMac_sAddr_t item;
-
-                id.subID = subId;
-
-                /* Read Network Information from NV */
-                stat = pNV->readItem(id, 0, sizeof(ApiMac_sAddr_t), &item);
-                if(stat == NVINTF_SUCCESS)
-                {
-                    if(pAddr->addrMode == item.addrMode)
-                    {
-                        /* Is the address the same */
-                        if(((pAddr->addrMode == ApiMac_addrType_short)
-                            && (pAddr->addr.shortAddr == item.addr.shortAddr))
-                           || ((pAddr->addrMode == ApiMac_addrType_extended)
-                               && (memcmp(&pAddr->addr.extAddr,
-                                          &item.addr.extAddr,
-                                          APIMAC_SADDR_EXT_LEN)
-                                   == 0)))
-                        {
-                            return (subId);
-                        }
-                    }
-                    readItems++;
-                }
-                subId++;
-            }
-        }
-    }
-
-    return (-1);
+    return (Blist_find(&blackList, pAddr));
 }
 
 /*!
@@ -984,29 +971,12 @@ void Ssf_clearAllNVItems(void)
     /* Clear Network Information */
     Ssf_clearNetworkInfo();
 
+    /* Clear the black list, its count and every possible record */
+    Blist_eraseAll(&blackList, &blackListNv);
+
     if((pNV != NULL) && (pNV->deleteItem != NULL))
     {
         NVINTF_itemID_t id;
-        uint16_t entries;
-
-        /* Clear the black list entries number */
-        id.systemID = NVINTF_SYSID_APP;
-        id.itemID = SSF_NV_BLACKLIST_ENTRIES_ID;
-        id.subID = 0;
-        pNV->deleteItem(id);
-
-        /*
-         Clear the black list entries.  Brute force through
-         every possible subID, if it doesn't exist that's fine,
-         it will fail in deleteItem.
-         */
-        id.systemID = NVINTF_SYSID_APP;
-        id.itemID = SSF_NV_BLACKLIST_ID;
-        for(entries = 0; entries < SSF_MAX_BLACKLIST_IDS; entries++)
-        {
-            id.subID = entries;
-            pNV->deleteItem(id);
-        }
 
         /* Clear the device tx frame counter */
         id.systemID = NVINTF_SYSID_APP;
@@ -1035,43 +1005,8 @@ void Ssf_clearAllNVItems(void)
  */
 bool Ssf_addBlackListItem(ApiMac_sAddr_t *pAddr)
 {
-    bool retVal = false;
-
-    if((pNV != NULL) && (pNV->writeItem != NULL)
-    		&& (pAddr != NULL) && (pAddr->addrMode != ApiMac_addrType_none))
-    {
-        if(Ssf_findBlackListIndex(pAddr))
-        {
-            retVal = true;
-        }
-        else
-        {
-            uint8_t stat;
-            NVINTF_itemID_t id;
-            uint16_t numEntries = getNumBlackListEntries();
-
-            /* Check the maximum size */
-            if(numEntries < SSF_MAX_BLACKLIST_ENTRIES)
-            {
-                /* Setup NV ID for the black list record */
-                id.systemID = NVINTF_SYSID_APP;
-                id.itemID = SSF_NV_BLACKLIST_ID;
-                id.subID = findUnuedBlackListIndex();
-
-                /* write the black list record */
-                stat = pNV->writeItem(id, sizeof(ApiMac_sAddr_t), pAddr);
-                if(stat == NVINTF_SUCCESS)
-                {
-                    /* Update the number of entries */
-                    numEntries++;
-                    saveNumBlackListEntries(numEntries);
-                    retVal = true;
-                }
-            }
-        }
-    }
-
-    return(retVal);
+    /* Write the black list record, then the RAM copy */
+    return (Blist_store(&blackList, &blackListNv, pAddr));
 }
 
 /*!
@@ -1081,36 +1016,8 @@ bool Ssf_addBlackListItem(ApiMac_sAddr_t *pAddr)
  */
 void Ssf_removeBlackListItem(ApiMac_sAddr_t *pAddr)
 {
-    if((pNV != NULL) && (pNV->deleteItem != NULL))
-    {
-        int index;
-
-        /* Does the item exist? */
-        index = Ssf_findBlackListIndex(pAddr);
-        if(index > 0)
-        {
-            uint8_t stat;
-            NVINTF_itemID_t id;
-
-            /* Setup NV ID for the black list record */
-            id.systemID = NVINTF_SYSID_APP;
-            id.itemID = SSF_NV_BLACKLIST_ID;
-            id.subID = (uint16_t)index;
-
-            stat = pNV->deleteItem(id);
-            if(stat == NVINTF_SUCCESS)
-            {
-                /* Update the number of entries */
-                uint16_t numEntries = getNumBlackListEntries();
-
-                if(numEntries > 0)
-                {
-                    numEntries--;
-                    saveNumBlackListEntries(numEntries);
-                }
-            }
-        }
-    }
+    /* Delete the black list record, then the RAM copy */
+    Blist_erase(&blackList, &blackListNv, pAddr);
 }
 
 /*!
@@ -1252,103 +1159,3 @@ static void processFHAssocTimeoutCallback(UArg a0)
     /* Wake up the application thread when it waits for clock event */
     Semaphore_post(sensorSem);
 }
-
-/*!
- * @brief       Find an unused blacklist index
- *
- * @return      sub index not used
- */
-static int findUnuedBlackListIndex(void)
-{
-    int subId = 0;
-
-    if(pNV != NULL)
-    {
-        uint16_t numEntries;
-
-        numEntries = getNumBlackListEntries();
-
-        if(numEntries > 0)
-        {
-            NVINTF_itemID_t id;
-
-            int readItems = 0;
-            /* Setup NV ID for the black list records */
-            id.systemID = NVINTF_SYSID_APP;
-            id.itemID = SSF_NV_BLACKLIST_ID;
-
-            while((readItems < numEntries) && (subId < SSF_MAX_BLACKLIST_IDS))
-            {
-                ApiMac_sAddr_t item;
-                uint8_t stat;
-
-                id.subID = subId;
-
-                /* Read Network Information from NV */
-                stat = pNV->readItem(id, 0, sizeof(ApiMac_sAddr_t), &item);
-                if(stat == NVINTF_NOTFOUND)
-                {
-                    /* Use this sub id */
-                    break;
-                }
-                else if(stat == NVINTF_SUCCESS)
-                {
-                    readItems++;
-                }
-                subId++;
-            }
-        }
-    }
-
-    return (subId);
-}
-
-/*!
- * @brief       Read the number of black list items stored
- *
- * @return      number of entries in the black list
- */
-static uint16_t getNumBlackListEntries(void)
-{
-    uint16_t numEntries = 0;
-
-    if(pNV != NULL)
-    {
-        NVINTF_itemID_t id;
-        uint8_t stat;
-
-        /* Setup NV ID for the number of entries in the black list */
-        id.systemID = NVINTF_SYSID_APP;
-        id.itemID = SSF_NV_BLACKLIST_ENTRIES_ID;
-        id.subID = 0;
-
-        /* Read the number of black list items from NV */
-        stat = pNV->readItem(id, 0, sizeof(uint16_t), &numEntries);
-        if(stat != NVINTF_SUCCESS)
-        {
-            numEntries = 0;
-        }
-    }
-    return (numEntries);
-}
-
-/*!
- * @brief       Read the number of black list items stored
- *
- * @return      number of entries in the black list
- */
-static void saveNumBlackListEntries(uint16_t numEntries)
-{
-    if(pNV != NULL)
-    {
-        NVINTF_itemID_t id;
-
-        /* Setup NV ID for the number of entries in the black list */
-        id.systemID = NVINTF_SYSID_APP;
-        id.itemID = SSF_NV_BLACKLIST_ENTRIES_ID;
-        id.subID = 0;
-
-        /* Read the number of black list items from NV */
-        pNV->writeItem(id, sizeof(uint16_t), &numEntries);
-    }
-}
@@ -150,6 +150,13 @@ extern void Ssf_initializeReadingClock(void);
  */
 extern void Ssf_setReadingClock(uint32_t readingTime);
 
+/*!
+ * @brief       Get the time since the device started.
+ *
+ * @return      time in milliseconds, rolls over after about 49 days
+ */
+extern uint32_t Ssf_getTime(void);
+
 /*!
  * @brief       The application calls this function to indicate that this
  *              device has been removed from the network.
@@ -246,7 +253,8 @@ extern void Ssf_setPollClock(uint32_t pollTime);
 extern bool Ssf_addBlackListItem(ApiMac_sAddr_t *pAddr);
 
 /*!
- * @brief       Find entry in black list
+ * @brief       Find entry in black list. Only the RAM copy of the list is
+ *              read, so this is cheap enough for every received beacon.
  *
  * @param       pAddr - address to find in the black list
  *
@@ -60,6 +60,8 @@
 
 #include "icall.h"
 #include "icall_platform.h"
+#include "probe.h"
+#include "pwracct.h"
 
 #ifndef ICALL_FEATURE_SEPARATE_IMGINFO
 #include <icall_addrs.h>
@@ -245,8 +247,12 @@ static const void *ICall_initParams[] = ICALL_CUSTOM_INIT_PARAMS;
 
 #endif /* ICALL_FEATURE_SEPARATE_IMGINFO */
 
-/** @internal message queue */
-typedef void *ICall_MsgQueue;
+/** @internal message queue, with a tail pointer for constant time append */
+typedef struct _icall_msg_queue_t
+{
+  void *head;
+  void *tail;
+} ICall_MsgQueue;
 
 /** @internal data structure about a task using ICall module */
 typedef struct _icall_task_entry_t
@@ -378,7 +384,8 @@ static ICall_TaskEntry *ICall_newTask(Task_Handle taskhandle)
       /* Empty slot */
       ICall_TaskEntry *taskentry = &ICall_tasks[i];
       taskentry->task = taskhandle;
-      taskentry->queue = NULL;
+      taskentry->queue.head = NULL;
+      taskentry->queue.tail = NULL;
       taskentry->syncHandle = ICALL_SYNC_HANDLE_CREATE();
       if (taskentry->syncHandle == NULL)
       {
@@ -495,7 +502,8 @@ void ICall_init(void)
   for (i = 0; i < ICALL_MAX_NUM_TASKS; i++)
   {
     ICall_tasks[i].task = NULL;
-    ICall_tasks[i].queue = NULL;
+    ICall_tasks[i].queue.head = NULL;
+    ICall_tasks[i].queue.tail = NULL;
   }
   for (i = 0; i < ICALL_MAX_NUM_ENTITIES; i++)
   {
@@ -536,6 +544,7 @@ void ICall_createRemoteTasks(void)
       /* abort */
       ICALL_HOOK_ABORT_FUNC();
     }
+    Pwracct_setTask(task, Pwracct_task_stack);
     key = ICall_enterCSImpl();
     if (ICall_newTask(task) == NULL)
     {
@@ -723,6 +732,9 @@ static ICall_Errno ICall_primFree(ICall_FreeArgs *args)
   return ICALL_ERRNO_SUCCESS;
 }
 
+static ICall_Errno ICall_primEntityId2ServiceId(ICall_EntityID entityId,
+                                                ICall_ServiceEnum *servId);
+
 /**
  * @internal Queues a message to a message queue.
  * @param q_ptr    message queue
@@ -730,7 +742,6 @@ static ICall_Errno ICall_primFree(ICall_FreeArgs *args)
  */
 static void ICall_msgEnqueue( ICall_MsgQueue *q_ptr, void *msg_ptr )
 {
-  void *list;
   ICall_CSState key;
 
   // Hold off interrupts
@@ -738,19 +749,16 @@ static void ICall_msgEnqueue( ICall_MsgQueue *q_ptr, void *msg_ptr )
 
   ICALL_MSG_NEXT( msg_ptr ) = NULL;
   // If first message in queue
-  if ( *q_ptr == NULL )
+  if ( q_ptr->tail == NULL )
   {
-    *q_ptr = msg_ptr;
+    q_ptr->head = msg_ptr;
   }
   else
   {
-    // Find end of queue
-    for ( list = *q_ptr; ICALL_MSG_NEXT( list ) != NULL;
-          list = ICALL_MSG_NEXT( list ) );
-
     // Add message to end of queue
-    ICALL_MSG_NEXT( list ) = msg_ptr;
+    ICALL_MSG_NEXT( q_ptr->tail ) = msg_ptr;
   }
+  q_ptr->tail = msg_ptr;
 
   // Re-enable interrupts
   ICall_leaveCSImpl(key);
@@ -769,11 +777,15 @@ static void *ICall_msgDequeue( ICall_MsgQueue *q_ptr )
   // Hold off interrupts
   key = ICall_enterCSImpl();
 
-  if ( *q_ptr != NULL )
+  if ( q_ptr->head != NULL )
   {
     // Dequeue message
-    msg_ptr = *q_ptr;
-    *q_ptr = ICALL_MSG_NEXT( msg_ptr );
+    msg_ptr = q_ptr->head;
+    q_ptr->head = ICALL_MSG_NEXT( msg_ptr );
+    if ( q_ptr->head == NULL )
+    {
+      q_ptr->tail = NULL;
+    }
     ICALL_MSG_NEXT( msg_ptr ) = NULL;
     ICALL_MSG_DEST_ID( msg_ptr ) = ICALL_UNDEF_DEST_ID;
   }
@@ -785,34 +797,83 @@ static void *ICall_msgDequeue( ICall_MsgQueue *q_ptr )
 }
 
 /**
- * @internal Prepends a list of messages to a message queue
- * @param q_ptr  message queue pointer
- * @param head   message list to prepend
+ * @internal Removes a message from the middle of a message queue
+ * @param q_ptr    message queue pointer
+ * @param prev     message before msg_ptr, or NULL if msg_ptr is the head
+ * @param msg_ptr  message to remove
  */
-static void ICall_msgPrepend( ICall_MsgQueue *q_ptr, ICall_MsgQueue head )
+static void ICall_msgUnlink( ICall_MsgQueue *q_ptr, void *prev,
+                             void *msg_ptr )
 {
-  void *msg_ptr = NULL;
   ICall_CSState key;
 
   // Hold off interrupts
   key = ICall_enterCSImpl();
 
-  if ( head != NULL )
+  if ( prev == NULL )
   {
-    /* Find the end of the queue */
-    msg_ptr = head;
-    while (ICALL_MSG_NEXT( msg_ptr ) != NULL)
-    {
-      msg_ptr = ICALL_MSG_NEXT( msg_ptr );
-    }
-    ICALL_MSG_NEXT(msg_ptr) = *q_ptr;
-    *q_ptr = head;
+    q_ptr->head = ICALL_MSG_NEXT( msg_ptr );
+  }
+  else
+  {
+    ICALL_MSG_NEXT( prev ) = ICALL_MSG_NEXT( msg_ptr );
+  }
+  if ( q_ptr->tail == msg_ptr )
+  {
+    q_ptr->tail = prev;
   }
+  ICALL_MSG_NEXT( msg_ptr ) = NULL;
+  ICALL_MSG_DEST_ID( msg_ptr ) = ICALL_UNDEF_DEST_ID;
 
   // Re-enable interrupts
   ICall_leaveCSImpl(key);
 }
 
+/**
+ * @internal Applies a wait match function to a message
+ * @param matchFn  match function
+ * @param msg_ptr  message pointer
+ * @return TRUE when the message is the one waited for
+ */
+static bool ICall_msgMatch( ICall_MsgMatchFn matchFn, void *msg_ptr )
+{
+  ICall_MsgHdr *hdr = (ICall_MsgHdr *) msg_ptr - 1;
+  ICall_ServiceEnum servId;
+
+  return (ICall_primEntityId2ServiceId(hdr->srcentity, &servId) ==
+            ICALL_ERRNO_SUCCESS &&
+          matchFn(servId, hdr->dstentity, msg_ptr));
+}
+
+/**
+ * @internal Looks for the message waited for among the messages queued
+ *           after the last one looked at. The match function runs in the
+ *           waiting task with interrupts enabled: only the owning task
+ *           removes messages from its queue, and a message is linked in
+ *           with its next pointer already cleared.
+ * @param q_ptr    message queue pointer
+ * @param prev     last message looked at, NULL to start at the head.
+ *                 Updated to the message before the one returned, or to the
+ *                 last message of the queue.
+ * @param matchFn  match function
+ * @return the matching message, still queued, or NULL
+ */
+static void *ICall_msgFindMatch( ICall_MsgQueue *q_ptr, void **prev,
+                                 ICall_MsgMatchFn matchFn )
+{
+  void *msg_ptr;
+
+  for (;;)
+  {
+    msg_ptr = (*prev == NULL) ? q_ptr->head : ICALL_MSG_NEXT( *prev );
+    if ( msg_ptr == NULL || ICall_msgMatch(matchFn, msg_ptr) )
+    {
+      return msg_ptr;
+    }
+    *prev = msg_ptr;
+  }
+}
+
 /**
  * @internal Sends a message to an entity.
  * @param args    arguments
@@ -849,7 +910,8 @@ static ICall_Errno ICall_primSend(ICall_SendArgs *args)
   hdr->srcentity = args->src;
   hdr->dstentity = args->dest.entityId;
   hdr->format = args->format;
-  ICall_msgEnqueue(&ICall_entities[args->dest.entityId].task->queue, args->msg);
+  ICall_msgEnqueue(&ICall_entities[args->dest.entityId].task->queue,
+                   args->msg);
   ICALL_SYNC_HANDLE_POST(ICall_entities[args->dest.entityId].task->syncHandle);
   
   return ICALL_ERRNO_SUCCESS;
@@ -919,7 +981,7 @@ static ICall_Errno ICall_primRepostSync(void)
   }
   
   /* Check if this entity's queue is not empty */
-  if (taskentry->queue == NULL)
+  if (taskentry->queue.head == NULL)
   {
     /* Queue is empty */
     return ICALL_ERRNO_NOMSG;
@@ -1433,13 +1495,16 @@ static ICall_Errno ICall_primWaitMatch(ICall_WaitMatchArgs *args)
 {
   Task_Handle taskhandle = Task_self();
   ICall_TaskEntry *taskentry = ICall_searchTask(taskhandle);
-  ICall_MsgQueue prependQueue = NULL;
+  void *prev;
+  void *msg;
 #ifndef ICALL_EVENTS
   uint_fast16_t consumedCount = 0;
 #endif  
   UInt timeout;
   uint_fast32_t timeoutStamp;
   ICall_Errno errno;
+  /* Error returns aren't counted */
+  PROBE_BEGIN(probeStart);
 
   {
     BIOS_ThreadType threadtype = BIOS_getThreadType();
@@ -1479,48 +1544,26 @@ static ICall_Errno ICall_primWaitMatch(ICall_WaitMatchArgs *args)
     }
   }
 
+  /* The reply may already be queued. After that only the messages that
+   * arrived since the last look are matched, each of them once, and
+   * unrelated messages stay queued untouched. */
+  prev = NULL;
+  msg = ICall_msgFindMatch(&taskentry->queue, &prev, args->matchFn);
+
   errno = ICALL_ERRNO_TIMEOUT;
   timeoutStamp = Clock_getTicks() + timeout;
-  while (ICALL_SYNC_HANDLE_PEND(taskentry->syncHandle, timeout))
+  while (msg == NULL && ICALL_SYNC_HANDLE_PEND(taskentry->syncHandle, timeout))
   {
-    ICall_FetchMsgArgs fetchArgs;
-    ICall_ServiceEnum servId;
-    errno = ICall_primFetchMsg(&fetchArgs);
-    if (errno == ICALL_ERRNO_SUCCESS)
-    {
-      if (ICall_primEntityId2ServiceId(fetchArgs.src.entityId, &servId) ==
-            ICALL_ERRNO_SUCCESS)
-      {
-        if (args->matchFn(servId, fetchArgs.dest, fetchArgs.msg))
-        {
-          /* Matching message found*/
-          args->servId = servId;
-          args->dest = fetchArgs.dest;
-          args->msg = fetchArgs.msg;
-          errno = ICALL_ERRNO_SUCCESS;
-          break;
-        }
-      }
-      /* Message was received but it wasn't expected one.
-       * Add to the prepend queue */
-      ICall_msgEnqueue(&prependQueue, fetchArgs.msg);
-#ifdef ICALL_EVENTS  
-    /* Event are binary semaphore, so if several messsages are posted while
-     * we are processing one, it's possible that some of them are 'missed' and 
-     * not processed. Sending a event to ourself force this loop to run until 
-     * all the messages in the queue are processed. 
-     */
-    ICALL_SYNC_HANDLE_POST(taskentry->syncHandle);
-#endif    
-    }
-    
-    /* Prepare for timeout exit */
-    errno = ICALL_ERRNO_TIMEOUT;
-
 #ifndef ICALL_EVENTS  
     /* Keep the decremented semaphore count */
     consumedCount++;
 #endif  /* ICALL_EVENTS */  
+    msg = ICall_msgFindMatch(&taskentry->queue, &prev, args->matchFn);
+    if (msg != NULL)
+    {
+      break;
+    }
+
     if (timeout != BIOS_WAIT_FOREVER &&
         timeout != BIOS_NO_WAIT)
     {
@@ -1534,6 +1577,28 @@ static ICall_Errno ICall_primWaitMatch(ICall_WaitMatchArgs *args)
     }
   }
 
+  if (msg != NULL)
+  {
+    /* Matching message found*/
+    ICall_MsgHdr *hdr = (ICall_MsgHdr *) msg - 1;
+    ICall_msgUnlink(&taskentry->queue, prev, msg);
+#ifndef ICALL_EVENTS
+    /* Take the semaphore count posted for the message */
+    if (consumedCount > 0)
+    {
+      consumedCount--;
+    }
+    else
+    {
+      Semaphore_pend(taskentry->syncHandle, BIOS_NO_WAIT);
+    }
+#endif /* ICALL_EVENTS */
+    ICall_primEntityId2ServiceId(hdr->srcentity, &args->servId);
+    args->dest = hdr->dstentity;
+    args->msg = msg;
+    errno = ICALL_ERRNO_SUCCESS;
+  }
+
 #ifdef ICALL_EVENTS
   /*
    * Because Events are binary semaphores, the task's queue must be checked for
@@ -1541,17 +1606,14 @@ static ICall_Errno ICall_primWaitMatch(ICall_WaitMatchArgs *args)
    * re-posted due to it being cleared on the last pend.
    */
   ICall_primRepostSync();
-#endif //ICALL_EVENTS 
-  
-  /* Prepend retrieved irrelevant messages */
-  ICall_msgPrepend(&taskentry->queue, prependQueue);
-#ifndef ICALL_EVENTS  
+#else
   /* Re-increment the consumed semaphores */
   for (; consumedCount > 0; consumedCount--)
   {
     Semaphore_post(taskentry->syncHandle);
   }
 #endif /* ICALL_EVENTS */  
+  PROBE_END(Probe_id_icallWaitMatch, probeStart);
   return errno;
 }
 
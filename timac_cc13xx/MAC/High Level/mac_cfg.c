@@ -77,7 +77,11 @@
 #define MAC_CFG_DATA_IND_OFFSET     0
 #endif
 
-/* determine whether MAC_MLME_POLL_IND will be sent to the application */
+/* determine whether MAC_MLME_POLL_IND will be sent to the application.  The Stack-FFD
+ * configuration sets it for the collector, which holds messages for its sleepy devices.
+ * MacStack.c only passes the indication on to an application that registered a pending
+ * message check, so the coprocessor, which shares the FFD image, is unchanged.
+ */
 #ifndef MAC_CFG_APP_PENDING_QUEUE
 #define MAC_CFG_APP_PENDING_QUEUE   FALSE
 #endif
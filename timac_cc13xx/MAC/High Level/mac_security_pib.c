@@ -57,6 +57,7 @@
 #include "mac_low_level.h"
 #include "mac_main.h"
 #include "mac_security_pib.h"
+#include "mac_sec_index.h"
 #include "mac_pib.h"
 #include "osal.h"
 #include <stddef.h>
@@ -73,6 +74,41 @@
 #define MAC_ATTR_SECURITY_SET2_START       0xD0
 #define MAC_ATTR_SECURITY_SET2_END         0xD5
 
+/* Device index hash size, a power of two at least twice the device table */
+#if MAX_DEVICE_TABLE_ENTRIES <= 8
+#define MAC_SEC_DEVICE_HASH_SIZE           16
+#elif MAX_DEVICE_TABLE_ENTRIES <= 32
+#define MAC_SEC_DEVICE_HASH_SIZE           64
+#elif MAX_DEVICE_TABLE_ENTRIES <= 64
+#define MAC_SEC_DEVICE_HASH_SIZE           128
+#elif MAX_DEVICE_TABLE_ENTRIES <= 128
+#define MAC_SEC_DEVICE_HASH_SIZE           256
+#elif MAX_DEVICE_TABLE_ENTRIES < MAC_SEC_INDEX_NONE
+#define MAC_SEC_DEVICE_HASH_SIZE           512
+#else
+#error "MAX_DEVICE_TABLE_ENTRIES does not fit a device descriptor handle"
+#endif
+
+/* Key id lookup index hash size, sized the same way */
+#define MAC_SEC_KEY_LOOKUPS                (MAX_KEY_TABLE_ENTRIES * MAX_KEY_ID_LOOKUP_ENTRIES)
+#if MAC_SEC_KEY_LOOKUPS <= 4
+#define MAC_SEC_KEY_HASH_SIZE              8
+#elif MAC_SEC_KEY_LOOKUPS <= 16
+#define MAC_SEC_KEY_HASH_SIZE              32
+#elif MAC_SEC_KEY_LOOKUPS <= 64
+#define MAC_SEC_KEY_HASH_SIZE              128
+#elif MAC_SEC_KEY_LOOKUPS < MAC_SEC_INDEX_NONE
+#define MAC_SEC_KEY_HASH_SIZE              512
+#else
+#error "Too many key id lookup entries for the key index"
+#endif
+
+/* Occupancy bitmaps */
+#define MAC_SEC_MAP_WORDS(n)               (((n) + 31) / 32)
+#define MAC_SEC_MAP_TEST(pMap, i)          ((pMap)[(i) >> 5] & ((uint32) 1 << ((i) & 31)))
+#define MAC_SEC_MAP_SET(pMap, i)           ((pMap)[(i) >> 5] |= ((uint32) 1 << ((i) & 31)))
+#define MAC_SEC_MAP_CLEAR(pMap, i)         ((pMap)[(i) >> 5] &= ~((uint32) 1 << ((i) & 31)))
+
 
 /* ------------------------------------------------------------------------------------------------
  *                                           Typedefs
@@ -158,6 +194,42 @@ static CODE const macSecurityPibTbl_t macSecurityPibTbl[] =
 /* Invalid security PIB table index used for error code */
 #define MAC_SECURITY_PIB_INVALID     ((uint8) (sizeof(macSecurityPibTbl) / sizeof(macSecurityPibTbl[0])))
 
+/* Security table indexes. They are kept in step with the tables by
+ * MAC_MlmeSetSecurityReq(), so that macwrapper can find a device or a key
+ * without walking the tables.
+ */
+
+/* Extended address hash of the device table, open addressing with linear
+ * probing. Each slot holds a device_index or MAC_SEC_INDEX_NONE.
+ */
+static uint8 macSecDeviceHash[MAC_SEC_DEVICE_HASH_SIZE];
+
+/* Device table entries present in macSecDeviceHash */
+static uint32 macSecDeviceMap[MAC_SEC_MAP_WORDS(MAX_DEVICE_TABLE_ENTRIES)];
+
+/* Key id lookup data hash. Each slot holds
+ * key_index * MAX_KEY_ID_LOOKUP_ENTRIES + key_id_lookup_index.
+ */
+static uint8 macSecKeyHash[MAC_SEC_KEY_HASH_SIZE];
+
+/* Keys with at least one lookup entry and no entry marking the key unused */
+static uint8 macSecKeyUsed[MAX_KEY_TABLE_ENTRIES];
+
+/* Key device entry referencing each device, per key */
+static uint8 macSecKeyDevice[MAX_KEY_TABLE_ENTRIES][MAX_DEVICE_TABLE_ENTRIES];
+
+/* Key device entries referencing a device, per key */
+static uint32 macSecKeyDeviceMap[MAX_KEY_TABLE_ENTRIES][MAC_SEC_MAP_WORDS(MAX_KEY_DEVICE_TABLE_ENTRIES)];
+
+/* ------------------------------------------------------------------------------------------------
+ *                                           Local Functions
+ * ------------------------------------------------------------------------------------------------
+ */
+
+static void macSecDeviceBuild(void);
+static void macSecKeyDeviceBuild(void);
+static void macSecKeyLookupBuild(void);
+
 /* ------------------------------------------------------------------------------------------------
  *                                           Global Variables
  * ------------------------------------------------------------------------------------------------
@@ -191,9 +263,571 @@ macSecurityPib_t* pMacSecurityPib = &macSecurityPib;
 void MAC_MlmeSetActiveSecurityPib( void* pSecPib)
 {
   pMacSecurityPib = (macSecurityPib_t *)pSecPib;
+
+  /* The indexes describe the tables of the active PIB */
+  macSecDeviceBuild();
+  macSecKeyDeviceBuild();
+  macSecKeyLookupBuild();
 }
 #endif /* FEATURE_MAC_PIB_PTR */
 
+/**************************************************************************************************
+ * @fn          macSecHash
+ *
+ * @brief       Hash a byte string for the security table indexes.
+ *
+ * input parameters
+ *
+ * @param       p - bytes to hash.
+ * @param       len - number of bytes.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      Hash value, to be masked with the index size.
+ **************************************************************************************************
+ */
+static uint16 macSecHash(const uint8 *p, uint8 len)
+{
+  uint16 h = 0;
+
+  while (len--)
+  {
+    h = (h << 5) - h + *p++;
+  }
+  return (h ^ (h >> 9));
+}
+
+/**************************************************************************************************
+ * @fn          macSecFirstClear
+ *
+ * @brief       Find the first clear bit of an occupancy bitmap.
+ *
+ * input parameters
+ *
+ * @param       pMap - bitmap.
+ * @param       size - number of bits in use.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      First clear bit, or MAC_SEC_INDEX_NONE if all bits are set.
+ **************************************************************************************************
+ */
+static uint8 macSecFirstClear(const uint32 *pMap, uint16 size)
+{
+  uint16 i = 0;
+
+  while (i < size)
+  {
+    if (pMap[i >> 5] == 0xFFFFFFFFu)
+    {
+      i = (i | 31) + 1;
+    }
+    else if (!MAC_SEC_MAP_TEST(pMap, i))
+    {
+      return (uint8) i;
+    }
+    else
+    {
+      i++;
+    }
+  }
+  return MAC_SEC_INDEX_NONE;
+}
+
+/**************************************************************************************************
+ * @fn          macSecDeviceHome
+ *
+ * @brief       Home slot of a device table entry in macSecDeviceHash.
+ *
+ * input parameters
+ *
+ * @param       device - device_index.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      Slot index.
+ **************************************************************************************************
+ */
+static uint16 macSecDeviceHome(uint8 device)
+{
+  return macSecHash(pMacSecurityPib->macDeviceTable[device].extAddress, SADDR_EXT_LEN) &
+         (MAC_SEC_DEVICE_HASH_SIZE - 1);
+}
+
+/**************************************************************************************************
+ * @fn          macSecDeviceIndex
+ *
+ * @brief       Add a device table entry to the device index, unless its extended address
+ *              marks it unused.
+ *
+ * input parameters
+ *
+ * @param       device - device_index.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+static void macSecDeviceIndex(uint8 device)
+{
+  const uint8 *pExtAddr = pMacSecurityPib->macDeviceTable[device].extAddress;
+  uint16 pos;
+  uint8 k;
+
+  for (k = 0; k < SADDR_EXT_LEN; k++)
+  {
+    if (pExtAddr[k] != 0xFF)
+    {
+      break;
+    }
+  }
+  if (k == SADDR_EXT_LEN)
+  {
+    return;
+  }
+
+  pos = macSecDeviceHome(device);
+  while (macSecDeviceHash[pos] != MAC_SEC_INDEX_NONE)
+  {
+    pos = (pos + 1) & (MAC_SEC_DEVICE_HASH_SIZE - 1);
+  }
+  macSecDeviceHash[pos] = device;
+  MAC_SEC_MAP_SET(macSecDeviceMap, device);
+}
+
+/**************************************************************************************************
+ * @fn          macSecDeviceUnindex
+ *
+ * @brief       Remove a device table entry from the device index. Must be called before the
+ *              extended address of the entry changes.
+ *
+ * input parameters
+ *
+ * @param       device - device_index.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+static void macSecDeviceUnindex(uint8 device)
+{
+  uint16 pos, next, home;
+
+  if (!MAC_SEC_MAP_TEST(macSecDeviceMap, device))
+  {
+    return;
+  }
+  MAC_SEC_MAP_CLEAR(macSecDeviceMap, device);
+
+  pos = macSecDeviceHome(device);
+  while (macSecDeviceHash[pos] != device)
+  {
+    pos = (pos + 1) & (MAC_SEC_DEVICE_HASH_SIZE - 1);
+  }
+
+  /* Shift back the entries that follow, so that no probe sequence is broken */
+  next = pos;
+  for (;;)
+  {
+    next = (next + 1) & (MAC_SEC_DEVICE_HASH_SIZE - 1);
+    if (macSecDeviceHash[next] == MAC_SEC_INDEX_NONE)
+    {
+      break;
+    }
+    home = macSecDeviceHome(macSecDeviceHash[next]);
+    if (((next - home) & (MAC_SEC_DEVICE_HASH_SIZE - 1)) >=
+        ((next - pos) & (MAC_SEC_DEVICE_HASH_SIZE - 1)))
+    {
+      macSecDeviceHash[pos] = macSecDeviceHash[next];
+      pos = next;
+    }
+  }
+  macSecDeviceHash[pos] = MAC_SEC_INDEX_NONE;
+}
+
+/**************************************************************************************************
+ * @fn          macSecDeviceBuild
+ *
+ * @brief       Rebuild the device index from the device table.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+static void macSecDeviceBuild(void)
+{
+  uint8 i;
+
+  osal_memset(macSecDeviceHash, MAC_SEC_INDEX_NONE, sizeof(macSecDeviceHash));
+  osal_memset(macSecDeviceMap, 0, sizeof(macSecDeviceMap));
+  for (i = 0; i < MAX_DEVICE_TABLE_ENTRIES; i++)
+  {
+    macSecDeviceIndex(i);
+  }
+}
+
+/**************************************************************************************************
+ * @fn          macSecKeyDeviceIndex
+ *
+ * @brief       Add a key device entry to the key device index.
+ *
+ * input parameters
+ *
+ * @param       key - key_index.
+ * @param       entry - key_device_index.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+static void macSecKeyDeviceIndex(uint8 key, uint8 entry)
+{
+  uint8 device = pMacSecurityPib->macKeyDeviceList[key][entry].deviceDescriptorHandle;
+
+  if (device < MAX_DEVICE_TABLE_ENTRIES)
+  {
+    MAC_SEC_MAP_SET(macSecKeyDeviceMap[key], entry);
+    macSecKeyDevice[key][device] = entry;
+  }
+}
+
+/**************************************************************************************************
+ * @fn          macSecKeyDeviceUnindex
+ *
+ * @brief       Remove a key device entry from the key device index.
+ *
+ * input parameters
+ *
+ * @param       key - key_index.
+ * @param       entry - key_device_index.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+static void macSecKeyDeviceUnindex(uint8 key, uint8 entry)
+{
+  uint8 device = pMacSecurityPib->macKeyDeviceList[key][entry].deviceDescriptorHandle;
+
+  if (MAC_SEC_MAP_TEST(macSecKeyDeviceMap[key], entry))
+  {
+    MAC_SEC_MAP_CLEAR(macSecKeyDeviceMap[key], entry);
+    if (macSecKeyDevice[key][device] == entry)
+    {
+      macSecKeyDevice[key][device] = MAC_SEC_INDEX_NONE;
+    }
+  }
+}
+
+/**************************************************************************************************
+ * @fn          macSecKeyDeviceBuild
+ *
+ * @brief       Rebuild the key device index from the key device lists.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+static void macSecKeyDeviceBuild(void)
+{
+  uint8 i, j;
+
+  osal_memset(macSecKeyDevice, MAC_SEC_INDEX_NONE, sizeof(macSecKeyDevice));
+  osal_memset(macSecKeyDeviceMap, 0, sizeof(macSecKeyDeviceMap));
+  for (i = 0; i < MAX_KEY_TABLE_ENTRIES; i++)
+  {
+    for (j = 0; j < pMacSecurityPib->macKeyTable[i].keyDeviceListEntries; j++)
+    {
+      macSecKeyDeviceIndex(i, j);
+    }
+  }
+}
+
+/**************************************************************************************************
+ * @fn          macSecKeyHome
+ *
+ * @brief       Home slot of key id lookup data in macSecKeyHash.
+ *
+ * input parameters
+ *
+ * @param       lookupDataSize - 0 for 5 octets, 1 for 9 octets.
+ * @param       pLookupData - key id lookup data.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      Slot index.
+ **************************************************************************************************
+ */
+static uint16 macSecKeyHome(uint8 lookupDataSize, const uint8 *pLookupData)
+{
+  uint8 len = lookupDataSize ? MAC_KEY_LOOKUP_LONG_LEN : MAC_KEY_LOOKUP_SHORT_LEN;
+
+  return (macSecHash(pLookupData, len) ^ lookupDataSize) & (MAC_SEC_KEY_HASH_SIZE - 1);
+}
+
+/**************************************************************************************************
+ * @fn          macSecKeyLookupBuild
+ *
+ * @brief       Rebuild the key id lookup index and the key usage flags. The lookup lists hold
+ *              a few entries, so they are rebuilt whenever one of them changes.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+static void macSecKeyLookupBuild(void)
+{
+  uint8 i, j, k, count;
+
+  osal_memset(macSecKeyHash, MAC_SEC_INDEX_NONE, sizeof(macSecKeyHash));
+  for (i = 0; i < MAX_KEY_TABLE_ENTRIES; i++)
+  {
+    keyIdLookupDescriptor_t *pLookup = pMacSecurityPib->macKeyIdLookupList[i];
+
+    count = pMacSecurityPib->macKeyTable[i].keyIdLookupEntries;
+    if (count > MAX_KEY_ID_LOOKUP_ENTRIES)
+    {
+      count = MAX_KEY_ID_LOOKUP_ENTRIES;
+    }
+
+    /* A key is unused when it has no lookup entry, or when one of its lookup entries
+     * is the unused key mark: 8 octets of 0xFF followed by an invalid key index. */
+    macSecKeyUsed[i] = (count != 0);
+    for (j = 0; j < count; j++)
+    {
+      if (pLookup[j].lookupDataSize == 1 && pLookup[j].lookupData[MAC_KEY_LOOKUP_LONG_LEN - 1] == 0)
+      {
+        for (k = 0; k < 8 && pLookup[j].lookupData[k] == 0xFF; k++);
+        if (k == 8)
+        {
+          macSecKeyUsed[i] = FALSE;
+          break;
+        }
+      }
+    }
+    if (!macSecKeyUsed[i])
+    {
+      continue;
+    }
+
+    for (j = 0; j < count; j++)
+    {
+      uint16 pos = macSecKeyHome(pLookup[j].lookupDataSize, pLookup[j].lookupData);
+
+      while (macSecKeyHash[pos] != MAC_SEC_INDEX_NONE)
+      {
+        pos = (pos + 1) & (MAC_SEC_KEY_HASH_SIZE - 1);
+      }
+      macSecKeyHash[pos] = i * MAX_KEY_ID_LOOKUP_ENTRIES + j;
+    }
+  }
+}
+
+/**************************************************************************************************
+ * @fn          macSecurityPibFindDevice
+ *
+ * @brief       Find the device table entry of an extended address.
+ *
+ * input parameters
+ *
+ * @param       pExtAddr - extended address.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      device_index, or MAC_SEC_INDEX_NONE.
+ **************************************************************************************************
+ */
+MAC_INTERNAL_API uint8 macSecurityPibFindDevice(const uint8 *pExtAddr)
+{
+  uint16 pos = macSecHash(pExtAddr, SADDR_EXT_LEN) & (MAC_SEC_DEVICE_HASH_SIZE - 1);
+  uint8 device;
+
+  while ((device = macSecDeviceHash[pos]) != MAC_SEC_INDEX_NONE)
+  {
+    if (osal_memcmp(pMacSecurityPib->macDeviceTable[device].extAddress, pExtAddr, SADDR_EXT_LEN))
+    {
+      return device;
+    }
+    pos = (pos + 1) & (MAC_SEC_DEVICE_HASH_SIZE - 1);
+  }
+  return MAC_SEC_INDEX_NONE;
+}
+
+/**************************************************************************************************
+ * @fn          macSecurityPibFreeDevice
+ *
+ * @brief       Find the first device table entry that is not in use.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      device_index, or MAC_SEC_INDEX_NONE if the table is full.
+ **************************************************************************************************
+ */
+MAC_INTERNAL_API uint8 macSecurityPibFreeDevice(void)
+{
+  return macSecFirstClear(macSecDeviceMap, MAX_DEVICE_TABLE_ENTRIES);
+}
+
+/**************************************************************************************************
+ * @fn          macSecurityPibFindKey
+ *
+ * @brief       Find the used key that has a matching key id lookup entry.
+ *
+ * input parameters
+ *
+ * @param       lookupDataSize - 0 for 5 octets, 1 for 9 octets.
+ * @param       pLookupData - key id lookup data.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      key_index, or MAC_SEC_INDEX_NONE.
+ **************************************************************************************************
+ */
+MAC_INTERNAL_API uint8 macSecurityPibFindKey(uint8 lookupDataSize, const uint8 *pLookupData)
+{
+  uint8 len = lookupDataSize ? MAC_KEY_LOOKUP_LONG_LEN : MAC_KEY_LOOKUP_SHORT_LEN;
+  uint16 pos = macSecKeyHome(lookupDataSize, pLookupData);
+  uint8 slot;
+
+  while ((slot = macSecKeyHash[pos]) != MAC_SEC_INDEX_NONE)
+  {
+    uint8 key = slot / MAX_KEY_ID_LOOKUP_ENTRIES;
+    keyIdLookupDescriptor_t *pLookup =
+      &pMacSecurityPib->macKeyIdLookupList[key][slot % MAX_KEY_ID_LOOKUP_ENTRIES];
+
+    if (pLookup->lookupDataSize == lookupDataSize &&
+        osal_memcmp(pLookup->lookupData, pLookupData, len))
+    {
+      return key;
+    }
+    pos = (pos + 1) & (MAC_SEC_KEY_HASH_SIZE - 1);
+  }
+  return MAC_SEC_INDEX_NONE;
+}
+
+/**************************************************************************************************
+ * @fn          macSecurityPibKeyUsed
+ *
+ * @brief       Check whether a key is in use.
+ *
+ * input parameters
+ *
+ * @param       keyIndex - key_index.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      TRUE if the key has lookup entries and none of them marks it unused.
+ **************************************************************************************************
+ */
+MAC_INTERNAL_API uint8 macSecurityPibKeyUsed(uint8 keyIndex)
+{
+  return (keyIndex < MAX_KEY_TABLE_ENTRIES) && macSecKeyUsed[keyIndex];
+}
+
+/**************************************************************************************************
+ * @fn          macSecurityPibFindKeyDevice
+ *
+ * @brief       Find the key device entry of a key that references a device.
+ *
+ * input parameters
+ *
+ * @param       keyIndex - key_index.
+ * @param       device - device_index.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      key_device_index, or MAC_SEC_INDEX_NONE.
+ **************************************************************************************************
+ */
+MAC_INTERNAL_API uint8 macSecurityPibFindKeyDevice(uint8 keyIndex, uint8 device)
+{
+  if (keyIndex >= MAX_KEY_TABLE_ENTRIES || device >= MAX_DEVICE_TABLE_ENTRIES)
+  {
+    return MAC_SEC_INDEX_NONE;
+  }
+  return macSecKeyDevice[keyIndex][device];
+}
+
+/**************************************************************************************************
+ * @fn          macSecurityPibFreeKeyDevice
+ *
+ * @brief       Find the first key device entry of a key that does not reference a device.
+ *
+ * input parameters
+ *
+ * @param       keyIndex - key_index.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      key_device_index, or MAC_SEC_INDEX_NONE if the list is full.
+ **************************************************************************************************
+ */
+MAC_INTERNAL_API uint8 macSecurityPibFreeKeyDevice(uint8 keyIndex)
+{
+  if (keyIndex >= MAX_KEY_TABLE_ENTRIES)
+  {
+    return MAC_SEC_INDEX_NONE;
+  }
+  return macSecFirstClear(macSecKeyDeviceMap[keyIndex], MAX_KEY_DEVICE_TABLE_ENTRIES);
+}
+
 /**************************************************************************************************
  * @fn          macSecurityPibReset
  *
@@ -244,6 +878,12 @@ MAC_INTERNAL_API void macSecurityPibReset(void)
 #endif /* FEATURE_MAC_PIB_PTR */
 
   pMacSecurityPib->securityLevelTableEntries = MAX_SECURITY_LEVEL_TABLE_ENTRIES;
+
+  /* The default device table does not describe any device, leave the device index empty */
+  osal_memset(macSecDeviceHash, MAC_SEC_INDEX_NONE, sizeof(macSecDeviceHash));
+  osal_memset(macSecDeviceMap, 0, sizeof(macSecDeviceMap));
+  macSecKeyDeviceBuild();
+  macSecKeyLookupBuild();
 }
 
 /**************************************************************************************************
@@ -537,6 +1177,8 @@ uint8 MAC_MlmeSetSecurityReq(uint8 pibAttribute, void *pValue)
       {
         osal_memcpy(&pMacSecurityPib->macKeyTable, pValue, sizeof(pMacSecurityPib->macKeyTable));
       }
+      macSecKeyDeviceBuild();
+      macSecKeyLookupBuild();
 
       return MAC_SUCCESS;
 
@@ -549,6 +1191,7 @@ uint8 MAC_MlmeSetSecurityReq(uint8 pibAttribute, void *pValue)
       }
       pMacSecurityPib->macKeyTable[keyIndex].keyIdLookupEntries = entry+1;
       osal_memcpy(&pMacSecurityPib->macKeyIdLookupList[keyIndex][entry], &((macSecurityPibKeyIdLookupEntry_t *)pValue)->macKeyIdLookupEntry, sizeof(keyIdLookupDescriptor_t));
+      macSecKeyLookupBuild();
       return MAC_SUCCESS;
 
     case MAC_KEY_DEVICE_ENTRY:
@@ -564,9 +1207,16 @@ uint8 MAC_MlmeSetSecurityReq(uint8 pibAttribute, void *pValue)
        * are accessed. */
       if (pMacSecurityPib->macKeyTable[keyIndex].keyDeviceListEntries <= entry)
       {
+        /* Entries skipped over become accessible as they are */
+        for (i = pMacSecurityPib->macKeyTable[keyIndex].keyDeviceListEntries; i < entry; i++)
+        {
+          macSecKeyDeviceIndex(keyIndex, i);
+        }
         pMacSecurityPib->macKeyTable[keyIndex].keyDeviceListEntries = entry+1;
       }
+      macSecKeyDeviceUnindex(keyIndex, entry);
       osal_memcpy(&pMacSecurityPib->macKeyDeviceList[keyIndex][entry], &((macSecurityPibKeyDeviceEntry_t *)pValue)->macKeyDeviceEntry, sizeof(keyDeviceDescriptor_t));
+      macSecKeyDeviceIndex(keyIndex, entry);
       return MAC_SUCCESS;
 
     case MAC_KEY_USAGE_ENTRY:
@@ -597,6 +1247,7 @@ uint8 MAC_MlmeSetSecurityReq(uint8 pibAttribute, void *pValue)
          * proprietary security PIB set requests. This call simply builds the table.
          */
         osal_memcpy(&pMacSecurityPib->macDeviceTable, pValue, sizeof(pMacSecurityPib->macDeviceTable));
+        macSecDeviceBuild();
       }
       return MAC_SUCCESS;
 
@@ -616,7 +1267,22 @@ uint8 MAC_MlmeSetSecurityReq(uint8 pibAttribute, void *pValue)
       {
         return MAC_INVALID_PARAMETER;
       }
-      osal_memcpy(&pMacSecurityPib->macDeviceTable[entry], &((macSecurityPibDeviceEntry_t *)pValue)->macDeviceEntry, sizeof(deviceDescriptor_t));
+      {
+        /* Frame counter updates leave the device index alone */
+        uint8 moved = !MAC_SEC_MAP_TEST(macSecDeviceMap, entry) ||
+                      !osal_memcmp(pMacSecurityPib->macDeviceTable[entry].extAddress,
+                                   ((macSecurityPibDeviceEntry_t *)pValue)->macDeviceEntry.extAddress,
+                                   SADDR_EXT_LEN);
+        if (moved)
+        {
+          macSecDeviceUnindex(entry);
+        }
+        osal_memcpy(&pMacSecurityPib->macDeviceTable[entry], &((macSecurityPibDeviceEntry_t *)pValue)->macDeviceEntry, sizeof(deviceDescriptor_t));
+        if (moved)
+        {
+          macSecDeviceIndex(entry);
+        }
+      }
       return MAC_SUCCESS;
 
     case MAC_SECURITY_LEVEL_ENTRY:
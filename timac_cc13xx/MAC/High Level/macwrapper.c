@@ -55,6 +55,7 @@
 #include "hal_mcu.h"
 #include "mac_api.h"
 #include "mac_security_pib.h"
+#include "mac_sec_index.h"
 #include "mac_spec.h"
 
 #include "OSAL.h"
@@ -65,21 +66,12 @@
  */
 #define MACWRAPPER_INVALID_KEY_INDEX        0
 
-#ifdef FEATURE_MAC_SECURITY
-
-static int8 macWrapper8ByteUnused(const unsigned char *extaddr)
-{
-  int8 k;
+/**
+ * Entry not found in a security table index.
+ */
+#define MACWRAPPER_NO_ENTRY                 MAC_SEC_INDEX_NONE
 
-  for (k = 0; k < 8; k++)
-  {
-    if (extaddr[k] != 0xff)
-    {
-      return 0;
-    }
-  }
-  return 1;
-}
+#ifdef FEATURE_MAC_SECURITY
 
 /* See macwrapper.h for documentation */
 unsigned char macWrapperAddDevice(unsigned short panId, unsigned short shortAddr,
@@ -90,7 +82,7 @@ unsigned char macWrapperAddDevice(unsigned short panId, unsigned short shortAddr
                                   unsigned char uniqueDevice,
                                   unsigned char duplicateDevFlag)
 {
-  uint8 i;
+  uint8 i, device, matchKey;
   halIntState_t is;
 
   HAL_ENTER_CRITICAL_SECTION(is);
@@ -113,54 +105,17 @@ unsigned char macWrapperAddDevice(unsigned short panId, unsigned short shortAddr
     MAC_MlmeSetSecurityReq(MAC_DEVICE_TABLE_ENTRIES, &i);
   }
 
-  /* Search for the matching extended address */
+  /* Look up the device and the key it is added for */
+  device = macSecurityPibFindDevice(extAddr);
+  matchKey = macSecurityPibFindKey(keyIdLookupDataSize, keyIdLookupData);
+
   for (i = 0; i < MAX_KEY_TABLE_ENTRIES; i++)
   {
-    uint8 j, matchingKey = FALSE, unusedKey = TRUE;
-
-    for (j = 0; j < MAX_KEY_ID_LOOKUP_ENTRIES; j++)
-    {
-      macSecurityPibKeyIdLookupEntry_t lookupEntry;
-      uint8 lookupLen;
-
-      lookupEntry.key_index = i;
-      lookupEntry.key_id_lookup_index = j;
-      if (MAC_MlmeGetSecurityReq(MAC_KEY_ID_LOOKUP_ENTRY, &lookupEntry) != MAC_SUCCESS)
-      {
-        continue;
-      }
-      if (lookupEntry.macKeyIdLookupEntry.lookupDataSize == 1 &&
-          lookupEntry.macKeyIdLookupEntry.lookupData[8] == 0)
-      {
-        if (macWrapper8ByteUnused(lookupEntry.macKeyIdLookupEntry.lookupData))
-        {
-          /* This key lookup entry is invalid */
-          unusedKey = TRUE;
-          break;
-        }
-      }
-      /* This key has at least one valid lookup entry */
-      unusedKey = FALSE;
+    macSecurityPibKeyDeviceEntry_t keyDeviceEntry;
+    macSecurityPibDeviceEntry_t deviceEntry;
+    uint8 matchingKey = (i == matchKey);
 
-      if (keyIdLookupDataSize == 0)
-      {
-        /* Key Id Lookup Data length in bytes */
-        lookupLen = 5;
-      }
-      else
-      {
-        lookupLen = 9;
-      }
-      if (lookupEntry.macKeyIdLookupEntry.lookupDataSize == keyIdLookupDataSize &&
-          osal_memcmp(lookupEntry.macKeyIdLookupEntry.lookupData, keyIdLookupData,
-                      lookupLen))
-      {
-        /* Key matches */
-        matchingKey = TRUE;
-        break;
-      }
-    }
-    if (unusedKey)
+    if (!macSecurityPibKeyUsed(i))
     {
       continue;
     }
@@ -171,120 +126,79 @@ unsigned char macWrapperAddDevice(unsigned short panId, unsigned short shortAddr
       continue;
     }
 
-    /* Now search for the key device table entries for the matching device */
-    for (j = 0; j < MAX_KEY_DEVICE_TABLE_ENTRIES; j++)
+    keyDeviceEntry.key_index = i;
+    keyDeviceEntry.key_device_index = macSecurityPibFindKeyDevice(i, device);
+    if (keyDeviceEntry.key_device_index != MACWRAPPER_NO_ENTRY)
     {
-      macSecurityPibKeyDeviceEntry_t keyDeviceEntry;
-      macSecurityPibDeviceEntry_t deviceEntry;
-
-      keyDeviceEntry.key_index = i;
-      keyDeviceEntry.key_device_index = j;
-      if (MAC_MlmeGetSecurityReq(MAC_KEY_DEVICE_ENTRY, &keyDeviceEntry) != MAC_SUCCESS ||
-          keyDeviceEntry.macKeyDeviceEntry.deviceDescriptorHandle == 0xff)
-      {
-        continue;
-      }
-      deviceEntry.device_index = keyDeviceEntry.macKeyDeviceEntry.deviceDescriptorHandle;
-      if (MAC_MlmeGetSecurityReq(MAC_DEVICE_ENTRY, &deviceEntry) != MAC_SUCCESS)
+      /* Matching device */
+      deviceEntry.device_index = device;
+      if (MAC_MlmeGetSecurityReq(MAC_DEVICE_ENTRY, &deviceEntry) != MAC_SUCCESS ||
+          MAC_MlmeGetSecurityReq(MAC_KEY_DEVICE_ENTRY, &keyDeviceEntry) != MAC_SUCCESS)
       {
         /* Security PIB is corrupt */
         HAL_EXIT_CRITICAL_SECTION(is);
         return MAC_BAD_STATE;
       }
-      if (osal_memcmp(deviceEntry.macDeviceEntry.extAddress, extAddr, 8))
-      {
-        /* Matching device */
 
-        /* Update the device descriptor */
-        deviceEntry.macDeviceEntry.panID = panId;
-        deviceEntry.macDeviceEntry.shortAddress = shortAddr;
-        if (matchingKey)
-        {
-          deviceEntry.macDeviceEntry.exempt = exempt;
-          deviceEntry.macDeviceEntry.frameCounter[i] = frameCounter;  
-        }
-        MAC_MlmeSetSecurityReq(MAC_DEVICE_ENTRY, &deviceEntry);
+      /* Update the device descriptor */
+      deviceEntry.macDeviceEntry.panID = panId;
+      deviceEntry.macDeviceEntry.shortAddress = shortAddr;
+      if (matchingKey)
+      {
+        deviceEntry.macDeviceEntry.exempt = exempt;
+        deviceEntry.macDeviceEntry.frameCounter[i] = frameCounter;
+      }
+      MAC_MlmeSetSecurityReq(MAC_DEVICE_ENTRY, &deviceEntry);
 
-        /* Update the key device descriptor */
-        if (matchingKey && (keyDeviceEntry.macKeyDeviceEntry.uniqueDevice != (bool)uniqueDevice))
-        {
-          keyDeviceEntry.macKeyDeviceEntry.uniqueDevice = uniqueDevice;
-          MAC_MlmeSetSecurityReq(MAC_KEY_DEVICE_ENTRY, &keyDeviceEntry);
-        }
-        break;
+      /* Update the key device descriptor */
+      if (matchingKey && (keyDeviceEntry.macKeyDeviceEntry.uniqueDevice != (bool)uniqueDevice))
+      {
+        keyDeviceEntry.macKeyDeviceEntry.uniqueDevice = uniqueDevice;
+        MAC_MlmeSetSecurityReq(MAC_KEY_DEVICE_ENTRY, &keyDeviceEntry);
       }
+      continue;
     }
 
-    if (j == MAX_KEY_DEVICE_TABLE_ENTRIES)
+    /* Matching device is not found for this key. Add a key device descriptor,
+     * and a device descriptor unless another key already has one. */
+    if (device == MACWRAPPER_NO_ENTRY)
     {
-      /* Matching device is not found. Add a new device descriptor
-       * and key device descriptor */
-      for (j = 0; j < MAX_DEVICE_TABLE_ENTRIES; j++)
-      {
-        macSecurityPibDeviceEntry_t deviceEntry;
-        uint8 k;
-
-        deviceEntry.device_index = j;
-        if (MAC_MlmeGetSecurityReq(MAC_DEVICE_ENTRY, &deviceEntry) != MAC_SUCCESS)
-        {
-          /* PIB is corrupt */
-          HAL_EXIT_CRITICAL_SECTION(is);
-          return MAC_BAD_STATE;
-        }
-        
-        if (macWrapper8ByteUnused(deviceEntry.macDeviceEntry.extAddress) ||
-            osal_memcmp(deviceEntry.macDeviceEntry.extAddress, extAddr, 8))
-        {
-          /* Empty slot found */
-          deviceEntry.macDeviceEntry.panID = panId;
-          deviceEntry.macDeviceEntry.shortAddress = shortAddr;
-          deviceEntry.macDeviceEntry.exempt = exempt;
-          if (matchingKey)
-          {
-            deviceEntry.macDeviceEntry.frameCounter[i] = frameCounter;                          
-          }
-          else
-          {
-            deviceEntry.macDeviceEntry.frameCounter[i] = 0;                  
-          }
-          osal_memcpy(deviceEntry.macDeviceEntry.extAddress, extAddr, 8);
+      device = macSecurityPibFreeDevice();
+    }
+    keyDeviceEntry.key_device_index = macSecurityPibFreeKeyDevice(i);
+    if (device == MACWRAPPER_NO_ENTRY || keyDeviceEntry.key_device_index == MACWRAPPER_NO_ENTRY)
+    {
+      /* Empty slot was not found */
+      HAL_EXIT_CRITICAL_SECTION(is);
+      return MAC_NO_RESOURCES;
+    }
 
-          /* Look for an empty slot in key device descriptor table */
-          for (k = 0; k < MAX_KEY_DEVICE_TABLE_ENTRIES; k++)
-          {
-            macSecurityPibKeyDeviceEntry_t keyDeviceEntry;
-
-            keyDeviceEntry.key_index = i;
-            keyDeviceEntry.key_device_index = k;
-
-            if (MAC_MlmeGetSecurityReq(MAC_KEY_DEVICE_ENTRY, &keyDeviceEntry) ==
-                MAC_INVALID_PARAMETER ||
-                keyDeviceEntry.macKeyDeviceEntry.deviceDescriptorHandle == 0xff)
-            {
-              /* Empty slot found */
-              keyDeviceEntry.macKeyDeviceEntry.deviceDescriptorHandle = deviceEntry.device_index;
-              keyDeviceEntry.macKeyDeviceEntry.uniqueDevice = uniqueDevice;
-              keyDeviceEntry.macKeyDeviceEntry.blackListed = FALSE;
-
-              MAC_MlmeSetSecurityReq(MAC_DEVICE_ENTRY, &deviceEntry);
-              MAC_MlmeSetSecurityReq(MAC_KEY_DEVICE_ENTRY, &keyDeviceEntry);
-              break;
-            }
-          }
-          if (k < MAX_KEY_DEVICE_TABLE_ENTRIES)
-          {
-            /* Empty slot was found */
-            break;
-          }
-        }
-      }
-      if (j == MAX_DEVICE_TABLE_ENTRIES)
-      {
-        /* Empty slot was not found */
-        HAL_EXIT_CRITICAL_SECTION(is);
-        return MAC_NO_RESOURCES;
-      }
+    deviceEntry.device_index = device;
+    if (MAC_MlmeGetSecurityReq(MAC_DEVICE_ENTRY, &deviceEntry) != MAC_SUCCESS)
+    {
+      /* PIB is corrupt */
+      HAL_EXIT_CRITICAL_SECTION(is);
+      return MAC_BAD_STATE;
+    }
+    deviceEntry.macDeviceEntry.panID = panId;
+    deviceEntry.macDeviceEntry.shortAddress = shortAddr;
+    deviceEntry.macDeviceEntry.exempt = exempt;
+    if (matchingKey)
+    {
+      deviceEntry.macDeviceEntry.frameCounter[i] = frameCounter;
     }
+    else
+    {
+      deviceEntry.macDeviceEntry.frameCounter[i] = 0;
+    }
+    osal_memcpy(deviceEntry.macDeviceEntry.extAddress, extAddr, 8);
+
+    keyDeviceEntry.macKeyDeviceEntry.deviceDescriptorHandle = device;
+    keyDeviceEntry.macKeyDeviceEntry.uniqueDevice = uniqueDevice;
+    keyDeviceEntry.macKeyDeviceEntry.blackListed = FALSE;
+
+    MAC_MlmeSetSecurityReq(MAC_DEVICE_ENTRY, &deviceEntry);
+    MAC_MlmeSetSecurityReq(MAC_KEY_DEVICE_ENTRY, &keyDeviceEntry);
   }
   HAL_EXIT_CRITICAL_SECTION(is);
   return MAC_SUCCESS;
@@ -293,110 +207,53 @@ unsigned char macWrapperAddDevice(unsigned short panId, unsigned short shortAddr
 /* See macwrapper.h for documentation */
 unsigned char macWrapperDeleteDevice(const unsigned char *extAddr)
 {
-  uint8 i;
+  uint8 i, device;
   halIntState_t is;
+  macSecurityPibDeviceEntry_t deviceEntry;
 
   HAL_ENTER_CRITICAL_SECTION(is);
 
-  /* Search for the matching extended address */
-  for (i = 0; i < MAX_KEY_TABLE_ENTRIES; i++)
+  device = macSecurityPibFindDevice(extAddr);
+  if (device == MACWRAPPER_NO_ENTRY)
   {
-    uint8 j, unusedKey = TRUE;
-
-    /* Check if the key is used */
-    for (j = 0; j < MAX_KEY_ID_LOOKUP_ENTRIES; j++)
-    {
-      macSecurityPibKeyIdLookupEntry_t lookupEntry;
+    HAL_EXIT_CRITICAL_SECTION(is);
+    return MAC_SUCCESS;
+  }
 
-      lookupEntry.key_index = i;
-      lookupEntry.key_id_lookup_index = j;
-      if (MAC_MlmeGetSecurityReq(MAC_KEY_ID_LOOKUP_ENTRY, &lookupEntry) != MAC_SUCCESS)
-      {
-        /* If none of the key ID look up entries associated with a key are initialized,
-         * the entry is considered as unused.
-         * Hence the default value of unusedKey was set to TRUE above.
-         */
-        continue;
-      }
-      if (lookupEntry.macKeyIdLookupEntry.lookupDataSize == 1 &&
-          lookupEntry.macKeyIdLookupEntry.lookupData[8] == 0)
-      {
-        uint8 k;
+  /* Release the key device descriptors of every key */
+  for (i = 0; i < MAX_KEY_TABLE_ENTRIES; i++)
+  {
+    macSecurityPibKeyDeviceEntry_t keyDeviceEntry;
 
-        for (k = 0; k < 8; k++)
-        {
-          if (lookupEntry.macKeyIdLookupEntry.lookupData[k] != 0xff)
-          {
-            break;
-          }
-        }
-        if (k == 8)
-        {
-          /* This key lookup entry is marked to indicate unused key.
-           * If any single lookup entry per key has this mark,
-           * the key is considered as unused regardless of the state of
-           * other key lookup entries associated with the same key.
-           */
-          unusedKey = TRUE;
-          break;
-        }
-      }
-      /* This key has at least one valid lookup entry,
-       * which tentatively indicates that the key may be in use,
-       * unless there is another lookup entry associated with the key
-       * which has the mark of unused key.
-       */
-      unusedKey = FALSE;
-    }
-    if (unusedKey)
+    keyDeviceEntry.key_index = i;
+    keyDeviceEntry.key_device_index = macSecurityPibFindKeyDevice(i, device);
+    if (keyDeviceEntry.key_device_index == MACWRAPPER_NO_ENTRY)
     {
       continue;
     }
-
-    /* Now search for the key device table entries for the matching device */
-    for (j = 0; j < MAX_KEY_DEVICE_TABLE_ENTRIES; j++)
+    if (MAC_MlmeGetSecurityReq(MAC_KEY_DEVICE_ENTRY, &keyDeviceEntry) != MAC_SUCCESS)
     {
-      macSecurityPibKeyDeviceEntry_t keyDeviceEntry;
-      macSecurityPibDeviceEntry_t deviceEntry;
-
-      keyDeviceEntry.key_index = i;
-      keyDeviceEntry.key_device_index = j;
-      if (MAC_MlmeGetSecurityReq(MAC_KEY_DEVICE_ENTRY, &keyDeviceEntry) != MAC_SUCCESS ||
-          keyDeviceEntry.macKeyDeviceEntry.deviceDescriptorHandle == 0xff)
-      {
-        continue;
-      }
-      deviceEntry.device_index = keyDeviceEntry.macKeyDeviceEntry.deviceDescriptorHandle;
-      if (MAC_MlmeGetSecurityReq(MAC_DEVICE_ENTRY, &deviceEntry) != MAC_SUCCESS)
-      {
-        /* Security PIB is corrupt */
-        HAL_EXIT_CRITICAL_SECTION(is);
-        return MAC_BAD_STATE;
-      }
-      if (osal_memcmp(deviceEntry.macDeviceEntry.extAddress, extAddr, 8))
-      {
-        /* Matching device */
-
-        /* Update the device descriptor */
-        deviceEntry.macDeviceEntry.panID = 0xffffu;
-        deviceEntry.macDeviceEntry.shortAddress = 0xffffu;
-        osal_memset(deviceEntry.macDeviceEntry.extAddress, 0xff, 8);
-        MAC_MlmeSetSecurityReq(MAC_DEVICE_ENTRY, &deviceEntry);
-
-        /* Update the key device descriptor */
-        keyDeviceEntry.macKeyDeviceEntry.deviceDescriptorHandle = 0xff;
-        MAC_MlmeSetSecurityReq(MAC_KEY_DEVICE_ENTRY, &keyDeviceEntry);
-        break;
-      }
-      if (macWrapper8ByteUnused(deviceEntry.macDeviceEntry.extAddress))
-      {
-        /* Device entry is already cleared. It would happen for i > 0,
-         * since the entry must have been cleared at i = 0, iteration. */
-        keyDeviceEntry.macKeyDeviceEntry.deviceDescriptorHandle = 0xff;
-        MAC_MlmeSetSecurityReq(MAC_KEY_DEVICE_ENTRY, &keyDeviceEntry);
-      }
+      /* Security PIB is corrupt */
+      HAL_EXIT_CRITICAL_SECTION(is);
+      return MAC_BAD_STATE;
     }
+    keyDeviceEntry.macKeyDeviceEntry.deviceDescriptorHandle = 0xff;
+    MAC_MlmeSetSecurityReq(MAC_KEY_DEVICE_ENTRY, &keyDeviceEntry);
   }
+
+  /* Update the device descriptor */
+  deviceEntry.device_index = device;
+  if (MAC_MlmeGetSecurityReq(MAC_DEVICE_ENTRY, &deviceEntry) != MAC_SUCCESS)
+  {
+    /* Security PIB is corrupt */
+    HAL_EXIT_CRITICAL_SECTION(is);
+    return MAC_BAD_STATE;
+  }
+  deviceEntry.macDeviceEntry.panID = 0xffffu;
+  deviceEntry.macDeviceEntry.shortAddress = 0xffffu;
+  osal_memset(deviceEntry.macDeviceEntry.extAddress, 0xff, 8);
+  MAC_MlmeSetSecurityReq(MAC_DEVICE_ENTRY, &deviceEntry);
+
   HAL_EXIT_CRITICAL_SECTION(is);
   return MAC_SUCCESS;
 }
@@ -468,28 +325,14 @@ unsigned char macWrapperDeleteKeyAndAssociatedDevices( uint8 keyIndex )
     /* Valid device */
     /* Update the device descriptor only when the other key
      * is not using the device. */
+    if (macSecurityPibFindKeyDevice(keyIndex ^ 1, deviceEntry.device_index) ==
+        MACWRAPPER_NO_ENTRY)
     {
-      uint8 k;
-      for (k = 0; k < MAX_KEY_DEVICE_TABLE_ENTRIES; k++)
-      {
-        keyDeviceEntry.key_index ^= 1;
-        keyDeviceEntry.key_device_index = k;
-        if (MAC_MlmeGetSecurityReq(MAC_KEY_DEVICE_ENTRY, &keyDeviceEntry)
-            == MAC_SUCCESS &&
-            keyDeviceEntry.macKeyDeviceEntry.deviceDescriptorHandle
-            == deviceEntry.device_index)
-        {
-          break;
-        }
-      }
-      if (k == MAX_KEY_DEVICE_TABLE_ENTRIES)
-      {
-        deviceEntry.macDeviceEntry.panID = 0xffffu;
-        deviceEntry.macDeviceEntry.shortAddress = 0xffffu;
-        osal_memset(deviceEntry.macDeviceEntry.extAddress, 0xff, 8);
-        deviceEntry.macDeviceEntry.frameCounter[keyIndex] = 0;    
-        MAC_MlmeSetSecurityReq(MAC_DEVICE_ENTRY, &deviceEntry);
-      }
+      deviceEntry.macDeviceEntry.panID = 0xffffu;
+      deviceEntry.macDeviceEntry.shortAddress = 0xffffu;
+      osal_memset(deviceEntry.macDeviceEntry.extAddress, 0xff, 8);
+      deviceEntry.macDeviceEntry.frameCounter[keyIndex] = 0;
+      MAC_MlmeSetSecurityReq(MAC_DEVICE_ENTRY, &deviceEntry);
     }
 
     /* No need to update Key Device Descriptor..it will be updated later */
@@ -605,7 +448,7 @@ unsigned char macWrapperGetDefaultSourceKey(unsigned char keyid,
                                             unsigned long *pFrameCounter)
 {
   halIntState_t is;
-  uint8 numKeys, lookupData[9], i, j;
+  uint8 numKeys, lookupData[9], i;
 
   HAL_ENTER_CRITICAL_SECTION(is);
 
@@ -614,28 +457,17 @@ unsigned char macWrapperGetDefaultSourceKey(unsigned char keyid,
   lookupData[8] = keyid;
 
   MAC_MlmeGetSecurityReq(MAC_KEY_TABLE_ENTRIES, &numKeys);
-  for (i = 0; i < numKeys; i++)
+  i = macSecurityPibFindKey(1, lookupData);
+  if (i < numKeys)
   {
-    for (j = 0; j < MAX_KEY_ID_LOOKUP_ENTRIES; j++)
-    {
-      macSecurityPibKeyIdLookupEntry_t buf;
+    macSecurityPibKeyEntry_t keyentry;
+    uint8 result;
 
-      buf.key_index = i;
-      buf.key_id_lookup_index = j;
-      if (MAC_MlmeGetSecurityReq(MAC_KEY_ID_LOOKUP_ENTRY, &buf) == MAC_SUCCESS &&
-          buf.macKeyIdLookupEntry.lookupDataSize == 1 &&
-          osal_memcmp(buf.macKeyIdLookupEntry.lookupData, lookupData, 9) == TRUE)
-      {
-        macSecurityPibKeyEntry_t keyentry;
-        uint8 result;
-
-        keyentry.key_index = i;
-        result = MAC_MlmeGetSecurityReq(MAC_KEY_ENTRY, &keyentry);
-        HAL_EXIT_CRITICAL_SECTION(is);
-        *pFrameCounter = keyentry.frameCounter;
-        return result;
-      }
-    }
+    keyentry.key_index = i;
+    result = MAC_MlmeGetSecurityReq(MAC_KEY_ENTRY, &keyentry);
+    HAL_EXIT_CRITICAL_SECTION(is);
+    *pFrameCounter = keyentry.frameCounter;
+    return result;
   }
 
   HAL_EXIT_CRITICAL_SECTION(is);
@@ -69,10 +69,50 @@
 #define PURGE_TIMER_PERIOD              ONE_HOUR_IN_MS
 #define PURGE_INTERVAL                  (10 * ONE_HOUR_IN_MS)
 
+/* no node, end of a list or empty hash slot */
+#define FHNT_INDEX_NONE                 (0xFFFF)
+
+/*
+ The neighbor index is an open addressed hash of the EUI-64, at most half
+ full, so its size follows FHNT_MAX_NUMBER_OF_NODE.
+ */
+#if FHNT_MAX_NUMBER_OF_NODE <= 32
+#define FHNT_HASH_BITS                  (6)
+#elif FHNT_MAX_NUMBER_OF_NODE <= 64
+#define FHNT_HASH_BITS                  (7)
+#elif FHNT_MAX_NUMBER_OF_NODE <= 128
+#define FHNT_HASH_BITS                  (8)
+#elif FHNT_MAX_NUMBER_OF_NODE <= 256
+#define FHNT_HASH_BITS                  (9)
+#elif FHNT_MAX_NUMBER_OF_NODE <= 512
+#define FHNT_HASH_BITS                  (10)
+#elif FHNT_MAX_NUMBER_OF_NODE <= 1024
+#define FHNT_HASH_BITS                  (11)
+#elif FHNT_MAX_NUMBER_OF_NODE <= 2048
+#define FHNT_HASH_BITS                  (12)
+#else
+#error "FHNT_MAX_NUMBER_OF_NODE is too large for the neighbor index"
+#endif
+#define FHNT_HASH_SIZE                  (1 << FHNT_HASH_BITS)
+#define FHNT_HASH_MASK                  (FHNT_HASH_SIZE - 1)
+
 /******************************************************************************
  Local variables
  *****************************************************************************/
 
+/* node index of each hash slot */
+static uint16_t FHNT_hash[FHNT_HASH_SIZE];
+
+/*
+ LRU list of the valid nodes, most recently used first, linked through node
+ indices. The free nodes are linked through FHNT_lruNext.
+ */
+static uint16_t FHNT_lruPrev[FHNT_MAX_NUMBER_OF_NODE];
+static uint16_t FHNT_lruNext[FHNT_MAX_NUMBER_OF_NODE];
+static uint16_t FHNT_lruHead;
+static uint16_t FHNT_lruTail;
+static uint16_t FHNT_freeHead;
+
 /******************************************************************************
  Glocal variables
  *****************************************************************************/
@@ -100,6 +140,167 @@ inline static uint8_t FHNT_assessTime(uint32_t curTime,
     }
 }
 
+/* home hash slot of an EUI-64 */
+static uint16_t FHNT_hashAddr(const uint8_t *pAddr)
+{
+    uint32_t lo;
+    uint32_t hi;
+
+    lo = pAddr[0] | ((uint32_t)pAddr[1] << 8)
+         | ((uint32_t)pAddr[2] << 16) | ((uint32_t)pAddr[3] << 24);
+    hi = pAddr[4] | ((uint32_t)pAddr[5] << 8)
+         | ((uint32_t)pAddr[6] << 16) | ((uint32_t)pAddr[7] << 24);
+
+    /* multiplicative hash, the top bits are the best mixed */
+    hi *= 0x9E3779B1UL;
+    lo = (lo ^ hi) * 0x9E3779B1UL;
+
+    return((uint16_t)(lo >> (32 - FHNT_HASH_BITS)));
+}
+
+/* hash slot of an EUI-64, or FHNT_INDEX_NONE */
+static uint16_t FHNT_findSlot(const uint8_t *pAddr)
+{
+    uint16_t pos = FHNT_hashAddr(pAddr);
+    uint16_t idx;
+
+    while((idx = FHNT_hash[pos]) != FHNT_INDEX_NONE)
+    {
+        if(!memcmp(FHNT_table.node[idx].dstAddr, pAddr, sizeof(sAddrExt_t)))
+        {
+            return(pos);
+        }
+        pos = (pos + 1) & FHNT_HASH_MASK;
+    }
+
+    return(FHNT_INDEX_NONE);
+}
+
+/* add a node to the hash */
+static void FHNT_hashInsert(uint16_t idx)
+{
+    uint16_t pos = FHNT_hashAddr(FHNT_table.node[idx].dstAddr);
+
+    while(FHNT_hash[pos] != FHNT_INDEX_NONE)
+    {
+        pos = (pos + 1) & FHNT_HASH_MASK;
+    }
+    FHNT_hash[pos] = idx;
+}
+
+/*
+ remove a hash slot, moving back the following entries of the probe run so
+ that no tombstone is needed
+ */
+static void FHNT_hashRemove(uint16_t pos)
+{
+    uint16_t next = pos;
+    uint16_t home;
+
+    for(;;)
+    {
+        FHNT_hash[pos] = FHNT_INDEX_NONE;
+        for(;;)
+        {
+            next = (next + 1) & FHNT_HASH_MASK;
+            if(FHNT_hash[next] == FHNT_INDEX_NONE)
+            {
+                return;
+            }
+            home = FHNT_hashAddr(FHNT_table.node[FHNT_hash[next]].dstAddr);
+            /* move the entry to the gap unless its home lies in (pos, next] */
+            if(((next - home) & FHNT_HASH_MASK)
+               >= ((next - pos) & FHNT_HASH_MASK))
+            {
+                break;
+            }
+        }
+        FHNT_hash[pos] = FHNT_hash[next];
+        pos = next;
+    }
+}
+
+static void FHNT_lruUnlink(uint16_t idx)
+{
+    uint16_t prev = FHNT_lruPrev[idx];
+    uint16_t next = FHNT_lruNext[idx];
+
+    if(prev == FHNT_INDEX_NONE)
+    {
+        FHNT_lruHead = next;
+    }
+    else
+    {
+        FHNT_lruNext[prev] = next;
+    }
+
+    if(next == FHNT_INDEX_NONE)
+    {
+        FHNT_lruTail = prev;
+    }
+    else
+    {
+        FHNT_lruPrev[next] = prev;
+    }
+}
+
+static void FHNT_lruPushHead(uint16_t idx)
+{
+    FHNT_lruPrev[idx] = FHNT_INDEX_NONE;
+    FHNT_lruNext[idx] = FHNT_lruHead;
+
+    if(FHNT_lruHead == FHNT_INDEX_NONE)
+    {
+        FHNT_lruTail = idx;
+    }
+    else
+    {
+        FHNT_lruPrev[FHNT_lruHead] = idx;
+    }
+    FHNT_lruHead = idx;
+}
+
+/* remove a valid node from the index and put it on the free list */
+static void FHNT_freeNode(uint16_t idx)
+{
+    uint16_t pos = FHNT_findSlot(FHNT_table.node[idx].dstAddr);
+
+    if(pos != FHNT_INDEX_NONE)
+    {
+        FHNT_hashRemove(pos);
+    }
+    FHNT_lruUnlink(idx);
+
+    FHNT_table.node[idx].valid = FHNT_NODE_INVALID;
+    FHNT_lruNext[idx] = FHNT_freeHead;
+    FHNT_freeHead = idx;
+
+    if(FHNT_table.num_node)
+    {
+        FHNT_table.num_node--;
+    }
+}
+
+static void FHNT_indexReset(void)
+{
+    uint16_t i;
+
+    for(i = 0; i < FHNT_HASH_SIZE; i++)
+    {
+        FHNT_hash[i] = FHNT_INDEX_NONE;
+    }
+
+    for(i = 0; i < FHNT_MAX_NUMBER_OF_NODE; i++)
+    {
+        FHNT_lruNext[i] = ((i + 1) < FHNT_MAX_NUMBER_OF_NODE) ?
+                          (i + 1) : FHNT_INDEX_NONE;
+    }
+
+    FHNT_freeHead = 0;
+    FHNT_lruHead = FHNT_INDEX_NONE;
+    FHNT_lruTail = FHNT_INDEX_NONE;
+}
+
 static void FHNT_purgeTimerIsrCb(uint8_t parameter)
 {
     uint32_t curTime;
@@ -111,38 +312,39 @@ static void FHNT_purgeTimerIsrCb(uint8_t parameter)
     FHMGR_macStartFHTimer(&FHNT_hnd.purgeTimer, TRUE);
 }
 
-static NODE_ENTRY_s *FHNT_getRemoveEntry(void)
+/*
+ least recently used node other than the parent, taken out of the index.
+ The node stays counted in num_node as the caller reuses it.
+ */
+static uint16_t FHNT_getRemoveEntry(void)
 {
-    uint16_t i;
-    NODE_ENTRY_s *pNodeEntry;
-    uint32_t maxElapsedTime;
-    uint32_t elapsedTime;
-    uint32_t curTime;
-    uint16_t maxIdx;
+    uint16_t idx;
     sAddrExt_t parentEUI;
 
-    pNodeEntry = FHNT_table.node;
     FHPIB_get(FHPIB_TRACK_PARENT_EUI, &parentEUI);
 
-    curTime = ICall_getTicks();
-    maxElapsedTime = 0;
-    maxIdx = 0;
+    idx = FHNT_lruTail;
+    while((idx != FHNT_INDEX_NONE)
+          && !memcmp(&parentEUI, FHNT_table.node[idx].dstAddr,
+                     sizeof(sAddrExt_t)))
+    {
+        idx = FHNT_lruPrev[idx];
+    }
 
-    for(i = 0; i < FHNT_MAX_NUMBER_OF_NODE; i++, pNodeEntry++)
+    if(idx == FHNT_INDEX_NONE)
     {
-            if(memcmp(&parentEUI, pNodeEntry->dstAddr, sizeof(sAddrExt_t)))
-            {
-                elapsedTime = FHUTIL_elapsedTime(curTime,
-                                                 pNodeEntry->ref_timeStamp);
-                if(elapsedTime > maxElapsedTime)
-                {
-                    maxElapsedTime = elapsedTime;
-                    maxIdx = i;
-                }
-            }
+        idx = FHNT_lruTail;
+        if(idx == FHNT_INDEX_NONE)
+        {
+            /* num_node out of step with the LRU list */
+            return(0);
         }
+    }
+
+    FHNT_hashRemove(FHNT_findSlot(FHNT_table.node[idx].dstAddr));
+    FHNT_lruUnlink(idx);
 
-    return(&FHNT_table.node[maxIdx]);
+    return(idx);
 }
 
 /******************************************************************************
@@ -158,6 +360,7 @@ MAC_INTERNAL_API void FHNT_reset(void)
 {
     memset(&FHNT_table, 0, sizeof(NWM_NEIGHBOR_TABLE_s));
     memset(&FHNT_hnd, 0, sizeof(FHNT_HND_s));
+    FHNT_indexReset();
 }
 
 /*!
@@ -202,17 +405,16 @@ MAC_INTERNAL_API void FHNT_purgeEntry(uint32_t ts)
     {
         if(pNodeEntry->valid & FHNT_NODE_W_UTIE)
         {
-            if(memcmp(&parentEUI, pNodeEntry->dstAddr, sizeof(sAddrExt_t)))
+            if(FHNT_assessTime(ts, pNodeEntry->ref_timeStamp,
+                             ((uint32_t)PURGE_INTERVAL * TICKPERIOD_MS_US))
+                              == NODE_TO_PURGE)
             {
-                if(FHNT_assessTime(ts, pNodeEntry->ref_timeStamp,
-                                 ((uint32_t)PURGE_INTERVAL * TICKPERIOD_MS_US))
-                                  == NODE_TO_PURGE)
+                if(memcmp(&parentEUI, pNodeEntry->dstAddr, sizeof(sAddrExt_t)))
                 {
-                    pNodeEntry->valid = FHNT_NODE_INVALID;
                     HAL_ENTER_CRITICAL_SECTION(intState);
-                    if(FHNT_table.num_node)
+                    if(pNodeEntry->valid)
                     {
-                        FHNT_table.num_node--;
+                        FHNT_freeNode(i);
                     }
                     HAL_EXIT_CRITICAL_SECTION(intState);
                 }
@@ -230,19 +432,15 @@ MAC_INTERNAL_API void FHNT_purgeEntry(uint32_t ts)
 MAC_INTERNAL_API void FHNT_removeEntry(sAddrExt_t *pAddr)
 {
     halIntState_t intState;
-    NODE_ENTRY_s *pNodeEntry;
-    FHAPI_status status = FHNT_getEntry(pAddr, &pNodeEntry);
+    uint16_t pos;
 
-    if(pNodeEntry)
+    HAL_ENTER_CRITICAL_SECTION(intState);
+    pos = FHNT_findSlot((uint8_t *)pAddr);
+    if(pos != FHNT_INDEX_NONE)
     {
-        pNodeEntry->valid = FHNT_NODE_INVALID;
-        HAL_ENTER_CRITICAL_SECTION(intState);
-        if(FHNT_table.num_node)
-        {
-          FHNT_table.num_node--;
-        }
-        HAL_EXIT_CRITICAL_SECTION(intState);
+        FHNT_freeNode(FHNT_hash[pos]);
     }
+    HAL_EXIT_CRITICAL_SECTION(intState);
 }
 
 /*!
@@ -253,41 +451,54 @@ MAC_INTERNAL_API void FHNT_removeEntry(sAddrExt_t *pAddr)
 MAC_INTERNAL_API NODE_ENTRY_s *FHNT_createEntry(sAddrExt_t *pAddr)
 {
     uint16_t i;
-    uint16_t noOfNode;
+    uint16_t idx;
     halIntState_t intState;
     NODE_ENTRY_s *pNodeEntry = NULL;
 
-    noOfNode = FHNT_table.num_node;
+    HAL_ENTER_CRITICAL_SECTION(intState);
 
-    if(noOfNode == FHNT_MAX_NUMBER_OF_NODE)
+    if(FHNT_table.num_node >= FHNT_MAX_NUMBER_OF_NODE)
     {
-        pNodeEntry = FHNT_getRemoveEntry();
+        idx = FHNT_getRemoveEntry();
     }
     else
     {
-        pNodeEntry = FHNT_table.node;
-        for(i = 0; i < FHNT_MAX_NUMBER_OF_NODE; i++, pNodeEntry++)
+        idx = FHNT_freeHead;
+        if(idx != FHNT_INDEX_NONE)
+        {
+            FHNT_freeHead = FHNT_lruNext[idx];
+        }
+        else
         {
-            if(!pNodeEntry->valid)
+            /* free list out of step with num_node, look for a free node */
+            for(i = 0; i < FHNT_MAX_NUMBER_OF_NODE; i++)
+            {
+                if(!FHNT_table.node[i].valid)
+                {
+                    idx = i;
+                    break;
+                }
+            }
+            if(idx == FHNT_INDEX_NONE)	//this means problem happens
             {
-                HAL_ENTER_CRITICAL_SECTION(intState);
-                FHNT_table.num_node++;
                 HAL_EXIT_CRITICAL_SECTION(intState);
-                break;
+                return(NULL);
             }
         }
-        if(i == FHNT_MAX_NUMBER_OF_NODE)	//this means problem happens
-        {
-            return(NULL);
-        }
+        FHNT_table.num_node++;
     }
 
+    pNodeEntry = &FHNT_table.node[idx];
     memset(pNodeEntry, 0, sizeof(NODE_ENTRY_s));
     memcpy(&(pNodeEntry->dstAddr), pAddr, sizeof(sAddrExt_t));
     pNodeEntry->UsieParams_s.clockDrift = CLOCK_DRIFT_UNKNOWN;
     pNodeEntry->UsieParams_s.channelFunc = CHANNEL_FUNCTION_UNKNOWN;
     pNodeEntry->valid = FHNT_NODE_CREATED;
 
+    FHNT_hashInsert(idx);
+    FHNT_lruPushHead(idx);
+
+    HAL_EXIT_CRITICAL_SECTION(intState);
 
     return(pNodeEntry);
 }
@@ -300,47 +511,65 @@ MAC_INTERNAL_API NODE_ENTRY_s *FHNT_createEntry(sAddrExt_t *pAddr)
 MAC_INTERNAL_API FHAPI_status FHNT_getEntry(sAddrExt_t *pAddr,
                                             NODE_ENTRY_s **pEntry)
 {
-    uint16_t i;
+    halIntState_t intState;
+    uint16_t pos;
+    uint16_t idx = FHNT_INDEX_NONE;
     NODE_ENTRY_s *pNodeEntry;
     uint16_t neighborValidTime;
     uint32_t curTime;
 
     *pEntry = NULL;
-    pNodeEntry = FHNT_table.node;
-    FHPIB_get(FHPIB_NEIGHBOR_VALID_TIME, &neighborValidTime);
-    curTime = ICall_getTicks();
 
-    for(i = 0; i < FHNT_MAX_NUMBER_OF_NODE; i++, pNodeEntry++)
+    HAL_ENTER_CRITICAL_SECTION(intState);
+    pos = FHNT_findSlot((uint8_t *)pAddr);
+    if(pos != FHNT_INDEX_NONE)
     {
-        if((pNodeEntry->valid)
-        && !memcmp(&(pNodeEntry->dstAddr), pAddr, sizeof(sAddrExt_t)))
+        idx = FHNT_hash[pos];
+        if(FHNT_table.node[idx].valid)
         {
-            *pEntry = pNodeEntry;
-            if(pNodeEntry->UsieParams_s.channelFunc == FHIE_CF_DH1CF)
-            {
-                if(FHNT_assessTime(curTime, pNodeEntry->ref_timeStamp,
-                  (neighborValidTime * 60 * 1000 * TICKPERIOD_MS_US))
-                   == NODE_TO_PURGE)
-                {
-                    pNodeEntry->valid |= FHNT_NODE_EXPIRED;
-                    return(FHAPI_STATUS_ERR_EXPIRED_NODE);
-                }
-                else
-                {
-                    return(FHAPI_STATUS_SUCCESS);
-                }
-            }
-            else if(pNodeEntry->UsieParams_s.channelFunc
-                    == FHIE_CF_SINGLE_CHANNEL)
-            {
-                return(FHAPI_STATUS_SUCCESS);
-            }
-            else
-            {
-                return(FHAPI_STATUS_ERR);
-            }
+            /* most recently used */
+            FHNT_lruUnlink(idx);
+            FHNT_lruPushHead(idx);
         }
+        else
+        {
+            idx = FHNT_INDEX_NONE;
+        }
+    }
+    HAL_EXIT_CRITICAL_SECTION(intState);
+
+    if(idx == FHNT_INDEX_NONE)
+    {
+        return(FHAPI_STATUS_ERR_NO_ENTRY_IN_THE_NEIGHBOR);
     }
 
-    return(FHAPI_STATUS_ERR_NO_ENTRY_IN_THE_NEIGHBOR);
+    pNodeEntry = &FHNT_table.node[idx];
+    *pEntry = pNodeEntry;
+
+    if(pNodeEntry->UsieParams_s.channelFunc == FHIE_CF_DH1CF)
+    {
+        FHPIB_get(FHPIB_NEIGHBOR_VALID_TIME, &neighborValidTime);
+        curTime = ICall_getTicks();
+
+        if(FHNT_assessTime(curTime, pNodeEntry->ref_timeStamp,
+          (neighborValidTime * 60 * 1000 * TICKPERIOD_MS_US))
+           == NODE_TO_PURGE)
+        {
+            pNodeEntry->valid |= FHNT_NODE_EXPIRED;
+            return(FHAPI_STATUS_ERR_EXPIRED_NODE);
+        }
+        else
+        {
+            return(FHAPI_STATUS_SUCCESS);
+        }
+    }
+    else if(pNodeEntry->UsieParams_s.channelFunc
+            == FHIE_CF_SINGLE_CHANNEL)
+    {
+        return(FHAPI_STATUS_SUCCESS);
+    }
+    else
+    {
+        return(FHAPI_STATUS_ERR);
+    }
 }
@@ -53,6 +53,7 @@
 #include "onboard.h"
 #include "osal.h"
 #include "osal_clock.h"
+#include "probe.h"
 
 /*********************************************************************
  * MACROS
@@ -239,7 +240,11 @@ void osalTimeUpdate( void )
 
       // Update OSAL Clock and Timers
       osalClockUpdate( elapsedMSec );
-      osalTimerUpdate( elapsedMSec );
+      {
+        PROBE_BEGIN(probeStart);
+        osalTimerUpdate( elapsedMSec );
+        PROBE_END(Probe_id_osalTimerUpdate, probeStart);
+      }
     }
   }
 #endif /* USE_ICALL */
@@ -288,7 +293,11 @@ void osalAdjustTimer(uint32 Msec )
   SysTickIntDisable();
 
   osalClockUpdate(Msec);
-  osalTimerUpdate(Msec);
+  {
+    PROBE_BEGIN(probeStart);
+    osalTimerUpdate(Msec);
+    PROBE_END(Probe_id_osalTimerUpdate, probeStart);
+  }
 
   /* Enable SysTick interrupts */
   SysTickIntEnable();
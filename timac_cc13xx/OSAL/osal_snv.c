@@ -112,6 +112,9 @@
 #define OSAL_NV_XFER_PAGE_STATE         (OSAL_NV_ACTIVE_PAGE_STATE ^           \
                                          OSAL_NV_ACTIVE_XFER_DIFF)
 
+// Size in bytes of a bitmap with one bit per item ID
+#define OSAL_NV_ID_BITMAP_SIZE          ((1 << (sizeof(osalSnvId_t) * 8)) / 8)
+
 #define OSAL_NV_MIN_COMPACT_THRESHOLD   70 // Minimum compaction threshold
 #define OSAL_NV_MAX_COMPACT_THRESHOLD   95 // Maximum compaction threshold
 
@@ -603,7 +606,10 @@ static void compactPage( uint8 srcPg )
 {
   uint16 srcOff, dstOff;
   uint8 dstPg;
-  osalSnvId_t lastId = (osalSnvId_t) 0xFFFF;
+  // IDs of the items already copied to the destination page
+  uint8 copied[OSAL_NV_ID_BITMAP_SIZE];
+
+  osal_memset(copied, 0, OSAL_NV_ID_BITMAP_SIZE);
 
   dstPg = (srcPg == nvPageBeg)? nvPageEnd : nvPageBeg;
 
@@ -662,18 +668,19 @@ static void compactPage( uint8 srcPg )
     }
 
     // Consider only valid item
-    if (!(hdr.id & OSAL_NV_INVALID_ID_MARK) && hdr.id != lastId)
+    if (!(hdr.id & OSAL_NV_INVALID_ID_MARK))
     {
-      // lastId is used to speed up compacting in case the same item ID
-      // items were neighboring each other contiguously.
-      lastId = (osalSnvId_t) hdr.id;
+      osalSnvId_t id = (osalSnvId_t) hdr.id;
 
-      // Check if the latest value of the item was already written
-      if (findItem(dstPg, dstOff, lastId) == 0)
+      // Check if the latest value of the item was already written.
+      // The page is read from the latest value, so only the first item
+      // found with an ID is copied, without searching the destination page.
+      if (!(copied[id >> 3] & (1 << (id & 7))))
       {
         // This item was not copied over yet.
         // This must be the latest value.
         // Write the latest value to the destination page
+        copied[id >> 3] |= 1 << (id & 7);
 
         xferItem(dstPg, dstOff, hdr.len, srcOff - hdr.len);
 
@@ -837,20 +844,8 @@ uint8 osal_snv_write( osalSnvId_t id, osalSnvLen_t len, void *pBuf )
 
     if (offset > 0)
     {
-      uint8 tmp;
-      osalSnvLen_t i;
-
-      for (i = 0; i < len; i++)
-      {
-        HalFlashRead(activePg, offset, &tmp, 1);
-        if (tmp != ((uint8 *)pBuf)[i])
-        {
-          break;
-        }
-        offset++;
-      }
-
-      if (i == len)
+      // Compare in place, the NV pages are memory mapped.
+      if (osal_memcmp(HalFlashGetAddress(activePg, offset), pBuf, len))
       {
         // Changed value is the same value as before.
         // Return here instead of re-writing the same value to NV.
@@ -57,6 +57,8 @@
 #include "mac_security_pib.h"
 #include "hal_mcu.h"
 #include "macwrapper.h"
+#include "mac_pib_multi.h"
+#include "mac_sec_devices.h"
 
 /* ------------------------------------------------------------------------------------------------
  *                                           Constants
@@ -128,6 +130,9 @@ uint8 macBeaconPayload[MAC_PIB_MAX_BEACON_PAYLOAD_LEN] = {0};
  * ------------------------------------------------------------------------------------------------
  */
 static void macApp(macCmd_t *pMsg);
+static void macAppPibMulti(macPibMultiParam_t *pReq, uint8 set);
+static void macAppAddDevices(macSecAddDevicesParam_t *pReq);
+static void macAppDelDevices(macSecDelDevicesParam_t *pReq);
 extern uint8 MAC_MlmeGetReqSize( uint8 pibAttribute );
 extern uint8 MAC_MlmeGetSecurityReqSize( uint8 pibAttribute );
 extern uint8 MAC_MlmeFHGetReqSize( uint16 pibAttribute );
@@ -351,6 +356,146 @@ uint16 macStackEventLoop(uint8 taskId, uint16 events)
   return 0;
 }
 
+/**************************************************************************************************
+ * @fn          macAppPibMulti
+ *
+ * @brief       Get or set every attribute of a batched PIB request in one pass.  The
+ *              application thread is blocked until the reply, so values are read into
+ *              and written from the caller's buffers directly.
+ *
+ * input parameters
+ *
+ * @param       pReq - pointer to the batched request
+ * @param       set - TRUE to set the attributes, FALSE to get them
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+static void macAppPibMulti(macPibMultiParam_t *pReq, uint8 set)
+{
+  uint8 i;
+
+  pReq->status = MAC_SUCCESS;
+  if (pReq->count > MAC_PIB_MULTI_MAX_ENTRIES)
+  {
+    pReq->status = MAC_INVALID_PARAMETER;
+    return;
+  }
+
+  for (i = 0; i < pReq->count; i++)
+  {
+    macPibMultiEntry_t *pEntry = &pReq->pEntries[i];
+
+    if (pEntry->attribute == MAC_BEACON_PAYLOAD)
+    {
+      /* The beacon payload is kept by this module, use MAC_SET_REQ/MAC_GET_REQ */
+      pEntry->status = MAC_INVALID_PARAMETER;
+    }
+    else if (set)
+    {
+      pEntry->status = MAC_MlmeSetReq(pEntry->attribute, pEntry->pValue);
+    }
+    else
+    {
+      uint8 size = MAC_MlmeGetReqSize(pEntry->attribute);
+
+      if (size > pEntry->len)
+      {
+        pEntry->status = MAC_INVALID_PARAMETER;
+      }
+      else
+      {
+        pEntry->status = MAC_MlmeGetReq(pEntry->attribute, pEntry->pValue);
+        pEntry->len = size;
+      }
+    }
+
+    if ((pEntry->status != MAC_SUCCESS) && (pReq->status == MAC_SUCCESS))
+    {
+      pReq->status = pEntry->status;
+    }
+  }
+}
+
+/**************************************************************************************************
+ * @fn          macAppAddDevices
+ *
+ * @brief       Add every device of a bulk request to the security device table.  A device
+ *              that can't be added does not stop the others.
+ *
+ * input parameters
+ *
+ * @param       pReq - pointer to the bulk request
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+static void macAppAddDevices(macSecAddDevicesParam_t *pReq)
+{
+  uint8 i;
+
+  pReq->status = MAC_SUCCESS;
+  for (i = 0; i < pReq->count; i++)
+  {
+    macSecDevicesEntry_t *pEntry = &pReq->entries[i];
+
+    pEntry->status = macWrapperAddDevice(pEntry->panId,
+                                         pEntry->shortAddr,
+                                         pEntry->extAddr,
+                                         pEntry->exempt,
+                                         pEntry->keyIdLookupDataSize,
+                                         pEntry->keyIdLookupData,
+                                         pEntry->frameCounter,
+                                         pEntry->uniqueDevice,
+                                         pEntry->duplicateDevFlag);
+
+    if ((pEntry->status != MAC_SUCCESS) && (pReq->status == MAC_SUCCESS))
+    {
+      pReq->status = pEntry->status;
+    }
+  }
+}
+
+/**************************************************************************************************
+ * @fn          macAppDelDevices
+ *
+ * @brief       Delete every device of a bulk request from the security device table.
+ *
+ * input parameters
+ *
+ * @param       pReq - pointer to the bulk request
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+static void macAppDelDevices(macSecDelDevicesParam_t *pReq)
+{
+  uint8 i, status;
+
+  pReq->status = MAC_SUCCESS;
+  for (i = 0; i < pReq->count; i++)
+  {
+    status = macWrapperDeleteDevice(pReq->extAddr[i]);
+
+    if ((status != MAC_SUCCESS) && (pReq->status == MAC_SUCCESS))
+    {
+      pReq->status = status;
+    }
+  }
+}
+
 /**************************************************************************************************
  * @fn          macApp
  *
@@ -479,6 +624,14 @@ void macApp(macCmd_t *pMsg)
     dealloc = FALSE;
     break;
 
+  case MAC_GET_REQ_MULTI:
+  case MAC_SET_REQ_MULTI:
+    macAppPibMulti((macPibMultiParam_t *)pMsg, (pMsg->hdr.event == MAC_SET_REQ_MULTI));
+    /* send message to App */
+    sendMsg = TRUE;
+    dealloc = FALSE;
+    break;
+
   case MAC_SET_SECURITY_REQ:
 #ifdef FEATURE_MAC_SECURITY
     pMsg->setParam.hdr.status = MAC_MlmeSetSecurityReq(pMsg->setParam.paramID,
@@ -727,6 +880,18 @@ void macApp(macCmd_t *pMsg)
     dealloc = FALSE;
     break;
 
+  case MAC_SEC_ADD_DEVICES:
+    macAppAddDevices((macSecAddDevicesParam_t *)pMsg);
+    sendMsg = TRUE;
+    dealloc = FALSE;
+    break;
+
+  case MAC_SEC_DEL_DEVICES:
+    macAppDelDevices((macSecDelDevicesParam_t *)pMsg);
+    sendMsg = TRUE;
+    dealloc = FALSE;
+    break;
+
   case MAC_SEC_DEL_KEY_AND_DEVICES:
     pMsg->hdr.status = macWrapperDeleteKeyAndAssociatedDevices(pMsg->secDelKeyAndDevices.keyIndex);
     sendMsg = TRUE;
@@ -837,6 +1002,18 @@ void MAC_CbackEvent(macCbackEvent_t *pData)
       pMsg = pData;
       break;
 
+    case MAC_MLME_POLL_IND:
+      /* Only an application with its own pending queue asked for the indication */
+      if ( pMacCbackCheckPending != NULL )
+      {
+        pMsg = (macCbackEvent_t *)osal_msg_allocate(len);
+        if (pMsg != NULL)
+        {
+          osal_memcpy(pMsg, pData, len);
+        }
+      }
+      break;
+
 
     default:
       pMsg = (macCbackEvent_t *)osal_msg_allocate(len);
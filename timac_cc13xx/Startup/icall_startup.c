@@ -57,6 +57,7 @@
 #include "hal_types.h"
 #include <icall.h>
 #include <icall_addrs.h>
+#include "crc16.h"
 
 #if defined( FLASH_ROM_BUILD )
 #include "ROM_Init.h"
@@ -79,8 +80,6 @@
  * CONSTANTS
  */
 
-#define CRC16_POLYNOMIAL  0x1021
-
 /*******************************************************************************
  * TYPEDEFS
  */
@@ -101,7 +100,9 @@ ICall_LeaveCS    ICall_leaveCriticalSection;
  * @fn          checkCRC16
  *
  * @brief       A simple implementation of the crc-16 checksum algorithm,
- *              courtesy of IAR (circa 2007).
+ *              courtesy of IAR (circa 2007). The work is done by the
+ *              shared CRC16 engine, which is table driven unless
+ *              CRC16_ENGINE is set to CRC16_ENGINE_BITWISE.
  *
  *              Note:  If you use this function, you need to call it with an
  *                     extra number of zero bytes equal to the size of the
@@ -121,32 +122,7 @@ ICall_LeaveCS    ICall_leaveCriticalSection;
  */
 uint16 slow_crc16( uint16 crc, uint8 *pAddr, uint32 len )
 {
-  while (len--)
-  {
-    uint8 i;
-    uint8 byte = *(pAddr++);
-
-    for (i=0; i<8; ++i)
-    {
-      uint32 temp = crc;
-
-      crc <<= 1;
-
-      if ( byte & 0x80 )
-      {
-        crc |= 1;
-      }
-
-      if ( temp & 0x8000 )
-      {
-        crc ^= CRC16_POLYNOMIAL;
-      }
-
-      byte <<= 1;
-    }
-  }
-
-  return crc;
+  return( CRC16_update( crc, pAddr, len ) );
 }
 
 
@@ -172,15 +148,14 @@ uint8 validChecksum( const uint32 *beginAddr, const uint32 *endAddr )
 {
   uint16 crc      = 0;
   uint16 romCRC   = *((uint16 *)(((uint8 *)endAddr)+1));
-  uint8  zeros[2] = {0, 0};
 
   // calculate the ROM checksum
-  crc = slow_crc16( crc,
-                    (uint8 *)beginAddr,
-                    (uint32)endAddr - (uint32)beginAddr + 1 );
+  crc = CRC16_update( crc,
+                      (uint8 *)beginAddr,
+                      (uint32)endAddr - (uint32)beginAddr + 1 );
 
   // needed to rotate out the answer
-  crc = slow_crc16( crc, zeros, 2 );
+  crc = CRC16_finalize( crc );
 
   // Compare the calculated checksum with the stored
   return( (crc==romCRC)? TRUE : FALSE );